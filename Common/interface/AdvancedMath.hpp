@@ -28,6 +28,7 @@
 #pragma once
 
 #include <float.h>
+#include <algorithm>
 
 #include "../../Platforms/interface/PlatformDefinitions.h"
 #include "../../Primitives/interface/FlagEnum.h"
@@ -410,6 +411,132 @@ inline BoxVisibility GetBoxVisibility(const ViewFrustumExt& ViewFrustumExt,
     return BoxVisibility::Intersecting;
 }
 
+/// Structure-of-arrays view of bounding boxes tested by GetBoxVisibilityBatch().
+
+/// Every array contains NumBoxes elements. The structure does not own the memory.
+struct BoundBoxBatch
+{
+    const float* MinX = nullptr;
+    const float* MinY = nullptr;
+    const float* MinZ = nullptr;
+    const float* MaxX = nullptr;
+    const float* MaxY = nullptr;
+    const float* MaxZ = nullptr;
+
+    Uint32 NumBoxes = 0;
+};
+
+/// Tests NumBoxes bounding boxes starting with FirstBox against the frustum planes selected by PlaneFlags.
+
+/// Bit (i % 32) of pVisibilityMask[i / 32] is set if box i is not invisible, i.e. if
+/// GetBoxVisibility(Frustum, Box_i, PlaneFlags) != BoxVisibility::Invisible. The boxes are
+/// processed 8 (AVX2) or 4 (SSE2, NEON) at a time.
+///
+/// Only the mask words that cover the range [FirstBox, FirstBox + NumBoxes) are written, and bits
+/// past the last box in the last word are cleared. FirstBox must be a multiple of 32, so that
+/// disjoint ranges may be processed by different threads without synchronization.
+inline void GetBoxVisibilityBatch(const ViewFrustum&   Frustum,
+                                  const BoundBoxBatch& Boxes,
+                                  Uint32               FirstBox,
+                                  Uint32               NumBoxes,
+                                  Uint32*              pVisibilityMask,
+                                  FRUSTUM_PLANE_FLAGS  PlaneFlags = FRUSTUM_PLANE_FLAG_FULL_FRUSTUM)
+{
+    VERIFY((FirstBox % 32) == 0, "First box index (", FirstBox, ") must be a multiple of 32");
+    VERIFY(FirstBox + NumBoxes <= Boxes.NumBoxes, "Box range [", FirstBox, ", ", FirstBox + NumBoxes, ") is out of bounds");
+
+    // For every plane, select the arrays that contain the coordinates of the box corner
+    // farthest along the plane normal
+    struct PlaneInfo
+    {
+        const float* X;
+        const float* Y;
+        const float* Z;
+        float3       Normal;
+        float        Distance;
+    };
+    PlaneInfo Planes[ViewFrustum::NUM_PLANES];
+    Uint32    NumPlanes = 0;
+    for (Uint32 plane_idx = 0; plane_idx < ViewFrustum::NUM_PLANES; ++plane_idx)
+    {
+        if ((PlaneFlags & (1 << plane_idx)) == 0)
+            continue;
+
+        const Plane3D& CurrPlane = Frustum.GetPlane(static_cast<ViewFrustum::PLANE_IDX>(plane_idx));
+
+        auto& Plane    = Planes[NumPlanes++];
+        Plane.X        = CurrPlane.Normal.x > 0 ? Boxes.MaxX : Boxes.MinX;
+        Plane.Y        = CurrPlane.Normal.y > 0 ? Boxes.MaxY : Boxes.MinY;
+        Plane.Z        = CurrPlane.Normal.z > 0 ? Boxes.MaxZ : Boxes.MinZ;
+        Plane.Normal   = CurrPlane.Normal;
+        Plane.Distance = CurrPlane.Distance;
+    }
+
+    // The distances are computed in the same order as in GetBoxVisibilityAgainstPlane(), so that
+    // results are identical to the scalar version.
+    Uint32* pMask  = pVisibilityMask + FirstBox / 32;
+    Uint32  box    = FirstBox;
+    Uint32  EndBox = FirstBox + NumBoxes;
+    while (box < EndBox)
+    {
+        const Uint32 WordEnd = std::min(box + 32, EndBox);
+
+        Uint32 Word = 0;
+        Uint32 Bit  = 0;
+#if DILIGENT_MATH_SIMD == DILIGENT_MATH_SIMD_AVX2
+        for (; box + 8 <= WordEnd; box += 8, Bit += 8)
+        {
+            __m256 Outside = _mm256_setzero_ps();
+            for (Uint32 p = 0; p < NumPlanes; ++p)
+            {
+                const auto& Plane = Planes[p];
+
+                auto Dist = _mm256_mul_ps(_mm256_loadu_ps(Plane.X + box), _mm256_set1_ps(Plane.Normal.x));
+                Dist      = _mm256_add_ps(Dist, _mm256_mul_ps(_mm256_loadu_ps(Plane.Y + box), _mm256_set1_ps(Plane.Normal.y)));
+                Dist      = _mm256_add_ps(Dist, _mm256_mul_ps(_mm256_loadu_ps(Plane.Z + box), _mm256_set1_ps(Plane.Normal.z)));
+                Dist      = _mm256_add_ps(Dist, _mm256_set1_ps(Plane.Distance));
+                Outside   = _mm256_or_ps(Outside, _mm256_cmp_ps(Dist, _mm256_setzero_ps(), _CMP_LT_OQ));
+            }
+            Word |= (~static_cast<Uint32>(_mm256_movemask_ps(Outside)) & 0xFFu) << Bit;
+        }
+#endif
+
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+        for (; box + 4 <= WordEnd; box += 4, Bit += 4)
+        {
+            auto Outside = SIMD::Splat(0.f);
+            for (Uint32 p = 0; p < NumPlanes; ++p)
+            {
+                const auto& Plane = Planes[p];
+
+                auto Dist = SIMD::Mul(SIMD::Load(Plane.X + box), SIMD::Splat(Plane.Normal.x));
+                Dist      = SIMD::Add(Dist, SIMD::Mul(SIMD::Load(Plane.Y + box), SIMD::Splat(Plane.Normal.y)));
+                Dist      = SIMD::Add(Dist, SIMD::Mul(SIMD::Load(Plane.Z + box), SIMD::Splat(Plane.Normal.z)));
+                Dist      = SIMD::Add(Dist, SIMD::Splat(Plane.Distance));
+                Outside   = SIMD::Or(Outside, SIMD::CmpLT(Dist, SIMD::Splat(0.f)));
+            }
+            Word |= (~static_cast<Uint32>(SIMD::MoveMask(Outside)) & 0xFu) << Bit;
+        }
+#endif
+
+        for (; box < WordEnd; ++box, ++Bit)
+        {
+            bool Outside = false;
+            for (Uint32 p = 0; p < NumPlanes && !Outside; ++p)
+            {
+                const auto& Plane = Planes[p];
+
+                float3 MaxPoint{Plane.X[box], Plane.Y[box], Plane.Z[box]};
+                Outside = dot(MaxPoint, Plane.Normal) + Plane.Distance < 0;
+            }
+            if (!Outside)
+                Word |= 1u << Bit;
+        }
+
+        *(pMask++) = Word;
+    }
+}
+
 inline float GetPointToBoxDistance(const BoundBox& BndBox, const float3& Pos)
 {
     VERIFY_EXPR(BndBox.Max.x >= BndBox.Min.x &&
@@ -620,6 +747,93 @@ inline float IntersectRayTriangle(const float3& V0,
 }
 
 
+/// Parameters of the line traversal through the 2D grid, see InitGridLineTrace().
+struct GridLineTrace2D
+{
+    /// Direction of the line.
+    float2 Direction;
+
+    /// The first and the last cells of the traversal. These may lie on the grid
+    /// boundary outside of the grid, in which case they are not enumerated.
+    int2 StartCell;
+    int2 EndCell;
+
+    /// Horizontal and vertical step directions, +1 or -1.
+    int2 Step;
+
+    /// Terms that select horizontal or vertical step, see TraceLineThroughGrid().
+    float tx = 0;
+    float ty = 0;
+};
+
+/// Clips a 2D line against the grid and computes the parameters of its traversal.
+
+/// \return false if the line does not touch the grid, and true otherwise.
+///
+/// \remarks This function is used by TraceLineThroughGrid() and TraceLinesThroughGrid(),
+///          so that both enumerate exactly the same cells.
+inline bool InitGridLineTrace(float2           f2Start,
+                              float2           f2End,
+                              int2             i2GridSize,
+                              GridLineTrace2D& Trace)
+{
+    VERIFY_EXPR(i2GridSize.x > 0 && i2GridSize.y > 0);
+    const auto f2GridSize = i2GridSize.Recast<float>();
+
+    Trace = GridLineTrace2D{};
+    if (f2Start == f2End)
+    {
+        if (f2Start.x >= 0 && f2Start.x < f2GridSize.x &&
+            f2Start.y >= 0 && f2Start.y < f2GridSize.y)
+        {
+            // The traversal only visits the start cell
+            Trace.StartCell = f2Start.Recast<int>();
+            Trace.EndCell   = Trace.StartCell;
+            Trace.Step      = int2{1, 1};
+            return true;
+        }
+        return false;
+    }
+
+    float2 f2Direction = f2End - f2Start;
+
+    float EnterDist, ExitDist;
+    if (!IntersectRayBox2D(f2Start, f2Direction, float2{0, 0}, f2GridSize, EnterDist, ExitDist))
+        return false;
+
+    // IntersectRayBox2D() does not reject lines that are parallel to the grid side and lie outside of it
+    static constexpr float Epsilon = 1e-20f;
+    for (size_t i = 0; i < 2; ++i)
+    {
+        if (std::abs(f2Direction[i]) <= Epsilon && (f2Start[i] < 0 || f2Start[i] >= f2GridSize[i]))
+            return false;
+    }
+
+    f2End   = f2Start + f2Direction * std::min(ExitDist, 1.f);
+    f2Start = f2Start + f2Direction * std::max(EnterDist, 0.f);
+    // Clamp start and end points to avoid FP precision issues
+    f2Start = clamp(f2Start, float2{0, 0}, f2GridSize);
+    f2End   = clamp(f2End, float2{0, 0}, f2GridSize);
+
+    const int   dh = f2Direction.x > 0 ? 1 : -1;
+    const int   dv = f2Direction.y > 0 ? 1 : -1;
+    const float p  = f2Direction.y * f2Start.x - f2Direction.x * f2Start.y;
+
+    Trace.Direction = f2Direction;
+    Trace.Step      = int2{dh, dv};
+    Trace.tx        = p - f2Direction.y * static_cast<float>(dh);
+    Trace.ty        = p + f2Direction.x * static_cast<float>(dv);
+
+    Trace.EndCell = f2End.Recast<int>();
+    VERIFY_EXPR(Trace.EndCell.x >= 0 && Trace.EndCell.y >= 0 && Trace.EndCell.x <= i2GridSize.x && Trace.EndCell.y <= i2GridSize.y);
+
+    Trace.StartCell = f2Start.Recast<int>();
+    VERIFY_EXPR(Trace.StartCell.x >= 0 && Trace.StartCell.y >= 0 && Trace.StartCell.x <= i2GridSize.x && Trace.StartCell.y <= i2GridSize.y);
+
+    return true;
+}
+
+
 /// Traces a 2D line through the square cell grid and enumerates all cells the line touches.
 
 /// \tparam TCallback - Type of the callback function.
@@ -656,70 +870,503 @@ void TraceLineThroughGrid(float2    f2Start,
                           int2      i2GridSize,
                           TCallback Callback)
 {
-    VERIFY_EXPR(i2GridSize.x > 0 && i2GridSize.y > 0);
-    const auto f2GridSize = i2GridSize.Recast<float>();
+    GridLineTrace2D Trace;
+    if (!InitGridLineTrace(f2Start, f2End, i2GridSize, Trace))
+        return;
 
-    if (f2Start == f2End)
+    const int dh = Trace.Step.x;
+    const int dv = Trace.Step.y;
+
+    const int2 i2End = Trace.EndCell;
+    int2       i2Pos = Trace.StartCell;
+
+    // Loop condition checks if we missed the end point of the line due to
+    // floating point precision issues.
+    // Normally we exit the loop when i2Pos == i2End.
+    while ((i2End.x - i2Pos.x) * dh >= 0 &&
+           (i2End.y - i2Pos.y) * dv >= 0)
     {
-        if (f2Start.x >= 0 && f2Start.x < f2GridSize.x &&
-            f2Start.y >= 0 && f2Start.y < f2GridSize.y)
+        if (i2Pos.x < i2GridSize.x && i2Pos.y < i2GridSize.y)
         {
-            Callback(f2Start.Recast<int>());
+            if (!Callback(i2Pos))
+                break;
+        }
+
+        if (i2Pos == i2End)
+        {
+            // End of the line
+            break;
+        }
+        else
+        {
+            // step to the next cell
+            float t = Trace.Direction.x * (static_cast<float>(i2Pos.y) + 0.5f) - Trace.Direction.y * (static_cast<float>(i2Pos.x) + 0.5f);
+            if (std::abs(t + Trace.tx) < std::abs(t + Trace.ty))
+                i2Pos.x += dh;
+            else
+                i2Pos.y += dv;
         }
-        return;
     }
+}
 
-    float2 f2Direction = f2End - f2Start;
+/// Structure-of-arrays view of 2D lines traced by TraceLinesThroughGrid().
+
+/// Every array contains NumLines elements. The structure does not own the memory.
+struct LineBatch2D
+{
+    const float* StartX = nullptr;
+    const float* StartY = nullptr;
+    const float* EndX   = nullptr;
+    const float* EndY   = nullptr;
+
+    Uint32 NumLines = 0;
+};
+
+/// Traces NumLines 2D lines starting with FirstLine through the square cell grid.
+
+/// \tparam TCallback - Type of the callback function.
+/// \param Lines      - Lines to trace.
+/// \param FirstLine  - Index of the first line to trace.
+/// \param NumLines   - Number of lines to trace.
+/// \param i2GridSize - Grid dimensions.
+/// \param Callback   - Callback function that will be called with the line index (Uint32) and
+///                     the cell (int2) for every cell visited. The function should return true to
+///                     continue tracing the line and false to stop it. Other lines are not affected.
+///
+/// \remarks Every line enumerates the same cells in the same order as TraceLineThroughGrid().
+///          With SIMD enabled, 4 lines are traced in lockstep, so the calls for different lines are interleaved.
+///          A line that reached its end or was stopped by the callback is masked out, and the next line
+///          of the range takes its place.
+///
+///          Disjoint line ranges may be traced by different threads.
+template <typename TCallback>
+void TraceLinesThroughGrid(const LineBatch2D& Lines,
+                           Uint32             FirstLine,
+                           Uint32             NumLines,
+                           int2               i2GridSize,
+                           TCallback          Callback)
+{
+    VERIFY(FirstLine + NumLines <= Lines.NumLines, "Line range [", FirstLine, ", ", FirstLine + NumLines, ") is out of bounds");
+
+    const Uint32 EndLine = FirstLine + NumLines;
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+    // Every lane traces one line. When a line is finished, the next one is assigned to its lane,
+    // so that the lanes are kept busy regardless of the line lengths.
+    // Cell coordinates are stored as floats that represent integers exactly.
+    enum LANE_ATTRIB : Uint32
+    {
+        POS_X,
+        POS_Y,
+        END_X,
+        END_Y,
+        STEP_X,
+        STEP_Y,
+        DIR_X,
+        DIR_Y,
+        TX,
+        TY,
+        NUM_ATTRIBS
+    };
+    float        Attribs[NUM_ATTRIBS][4] = {};
+    SIMD::Float4 v[NUM_ATTRIBS];
+    for (auto& a : v)
+        a = SIMD::Splat(0.f);
+
+    const auto Zero  = SIMD::Splat(0.f);
+    const auto Half  = SIMD::Splat(0.5f);
+    const auto GridX = SIMD::Splat(static_cast<float>(i2GridSize.x));
+    const auto GridY = SIMD::Splat(static_cast<float>(i2GridSize.y));
+
+    Uint32 LaneLine[4] = {};
+    int    ActiveLanes = 0;
+    Uint32 NextLine    = FirstLine;
+    while (ActiveLanes != 0 || NextLine < EndLine)
+    {
+        if (ActiveLanes != 0xF && NextLine < EndLine)
+        {
+            // Assign the next lines to the idle lanes
+            SIMD::Store(Attribs[POS_X], v[POS_X]);
+            SIMD::Store(Attribs[POS_Y], v[POS_Y]);
+            for (Uint32 lane = 0; lane < 4; ++lane)
+            {
+                while ((ActiveLanes & (1 << lane)) == 0 && NextLine < EndLine)
+                {
+                    const auto idx = NextLine++;
+
+                    GridLineTrace2D Trace;
+                    if (!InitGridLineTrace(float2{Lines.StartX[idx], Lines.StartY[idx]}, float2{Lines.EndX[idx], Lines.EndY[idx]}, i2GridSize, Trace))
+                        continue;
+
+                    Attribs[POS_X][lane]  = static_cast<float>(Trace.StartCell.x);
+                    Attribs[POS_Y][lane]  = static_cast<float>(Trace.StartCell.y);
+                    Attribs[END_X][lane]  = static_cast<float>(Trace.EndCell.x);
+                    Attribs[END_Y][lane]  = static_cast<float>(Trace.EndCell.y);
+                    Attribs[STEP_X][lane] = static_cast<float>(Trace.Step.x);
+                    Attribs[STEP_Y][lane] = static_cast<float>(Trace.Step.y);
+                    Attribs[DIR_X][lane]  = Trace.Direction.x;
+                    Attribs[DIR_Y][lane]  = Trace.Direction.y;
+                    Attribs[TX][lane]     = Trace.tx;
+                    Attribs[TY][lane]     = Trace.ty;
+
+                    LaneLine[lane] = idx;
+                    ActiveLanes |= 1 << lane;
+                }
+            }
+            for (Uint32 a = 0; a < NUM_ATTRIBS; ++a)
+                v[a] = SIMD::Load(Attribs[a]);
+        }
+
+        // Mask out the lines that missed the end point due to floating point precision issues
+        const auto InRange = SIMD::And(SIMD::CmpLE(Zero, SIMD::Mul(SIMD::Sub(v[END_X], v[POS_X]), v[STEP_X])),
+                                       SIMD::CmpLE(Zero, SIMD::Mul(SIMD::Sub(v[END_Y], v[POS_Y]), v[STEP_Y])));
+        ActiveLanes &= SIMD::MoveMask(InRange);
+
+        // Cells on the far grid boundary are not enumerated
+        const auto InGrid     = SIMD::And(SIMD::CmpLT(v[POS_X], GridX), SIMD::CmpLT(v[POS_Y], GridY));
+        const int  VisitLanes = ActiveLanes & SIMD::MoveMask(InGrid);
+
+        Int32 PosX[4], PosY[4];
+        SIMD::StoreInt32(PosX, v[POS_X]);
+        SIMD::StoreInt32(PosY, v[POS_Y]);
+        for (Uint32 lane = 0; lane < 4; ++lane)
+        {
+            if ((VisitLanes & (1 << lane)) != 0 && !Callback(LaneLine[lane], int2{PosX[lane], PosY[lane]}))
+                ActiveLanes &= ~(1 << lane);
+        }
+
+        // Mask out the lines that reached the end cell
+        const auto AtEnd = SIMD::And(SIMD::CmpEQ(v[POS_X], v[END_X]), SIMD::CmpEQ(v[POS_Y], v[END_Y]));
+        ActiveLanes &= ~SIMD::MoveMask(AtEnd);
+
+        // Step to the next cell. The expressions are the same as in TraceLineThroughGrid().
+        const auto t     = SIMD::Sub(SIMD::Mul(v[DIR_X], SIMD::Add(v[POS_Y], Half)), SIMD::Mul(v[DIR_Y], SIMD::Add(v[POS_X], Half)));
+        const auto StepH = SIMD::CmpLT(SIMD::Abs(SIMD::Add(t, v[TX])), SIMD::Abs(SIMD::Add(t, v[TY])));
+
+        v[POS_X] = SIMD::Add(v[POS_X], SIMD::And(StepH, v[STEP_X]));
+        v[POS_Y] = SIMD::Add(v[POS_Y], SIMD::Select(StepH, Zero, v[STEP_Y]));
+    }
+#else
+    for (Uint32 line = FirstLine; line < EndLine; ++line)
+    {
+        TraceLineThroughGrid(float2{Lines.StartX[line], Lines.StartY[line]}, float2{Lines.EndX[line], Lines.EndY[line]}, i2GridSize,
+                             [&](int2 Cell) { return Callback(line, Cell); });
+    }
+#endif
+}
+
+
+/// Parameters of the line traversal through the 3D grid, see InitGridLineTrace().
+struct GridLineTrace3D
+{
+    /// The first and the last cells of the traversal. These may lie on the grid
+    /// boundary outside of the grid, in which case they are not enumerated.
+    int3 StartCell;
+    int3 EndCell;
+
+    /// Step directions along every axis, +1 or -1.
+    int3 Step;
+
+    /// Distances along the line to the next cell boundary along every axis.
+    float3 tMax;
+
+    /// Distances along the line between two consecutive cell boundaries along every axis.
+    float3 tDelta;
+};
+
+/// Clips a 3D line against the grid and computes the parameters of its traversal.
+
+/// \return false if the line does not touch the grid, and true otherwise.
+///
+/// \remarks This function is used by TraceLineThroughGrid() and TraceLinesThroughGrid(),
+///          so that both enumerate exactly the same cells.
+inline bool InitGridLineTrace(float3           f3Start,
+                              float3           f3End,
+                              int3             i3GridSize,
+                              GridLineTrace3D& Trace)
+{
+    VERIFY_EXPR(i3GridSize.x > 0 && i3GridSize.y > 0 && i3GridSize.z > 0);
+    const auto f3GridSize = i3GridSize.Recast<float>();
+
+    Trace = GridLineTrace3D{};
+    if (f3Start == f3End)
+    {
+        if (f3Start.x >= 0 && f3Start.x < f3GridSize.x &&
+            f3Start.y >= 0 && f3Start.y < f3GridSize.y &&
+            f3Start.z >= 0 && f3Start.z < f3GridSize.z)
+        {
+            // The traversal only visits the start cell
+            Trace.StartCell = f3Start.Recast<int>();
+            Trace.EndCell   = Trace.StartCell;
+            Trace.Step      = int3{1, 1, 1};
+            Trace.tMax      = float3{FLT_MAX, FLT_MAX, FLT_MAX};
+            Trace.tDelta    = float3{FLT_MAX, FLT_MAX, FLT_MAX};
+            return true;
+        }
+        return false;
+    }
+
+    float3 f3Direction = f3End - f3Start;
 
     float EnterDist, ExitDist;
-    if (IntersectRayBox2D(f2Start, f2Direction, float2{0, 0}, f2GridSize, EnterDist, ExitDist))
+    if (!IntersectRayBox3D(f3Start, f3Direction, float3{0, 0, 0}, f3GridSize, EnterDist, ExitDist))
+        return false;
+
+    // IntersectRayBox3D() does not reject lines that are parallel to the grid side and lie outside of it
+    static constexpr float Epsilon = 1e-20f;
+    for (size_t i = 0; i < 3; ++i)
     {
-        f2End   = f2Start + f2Direction * std::min(ExitDist, 1.f);
-        f2Start = f2Start + f2Direction * std::max(EnterDist, 0.f);
-        // Clamp start and end points to avoid FP precision issues
-        f2Start = clamp(f2Start, float2{0, 0}, f2GridSize);
-        f2End   = clamp(f2End, float2{0, 0}, f2GridSize);
+        if (std::abs(f3Direction[i]) <= Epsilon && (f3Start[i] < 0 || f3Start[i] >= f3GridSize[i]))
+            return false;
+    }
 
-        const int   dh = f2Direction.x > 0 ? 1 : -1;
-        const int   dv = f2Direction.y > 0 ? 1 : -1;
-        const float p  = f2Direction.y * f2Start.x - f2Direction.x * f2Start.y;
-        const float tx = p - f2Direction.y * static_cast<float>(dh);
-        const float ty = p + f2Direction.x * static_cast<float>(dv);
+    f3End   = f3Start + f3Direction * std::min(ExitDist, 1.f);
+    f3Start = f3Start + f3Direction * std::max(EnterDist, 0.f);
+    // Clamp start and end points to avoid FP precision issues
+    f3Start = clamp(f3Start, float3{0, 0, 0}, f3GridSize);
+    f3End   = clamp(f3End, float3{0, 0, 0}, f3GridSize);
 
-        const int2 i2End = f2End.Recast<int>();
-        VERIFY_EXPR(i2End.x >= 0 && i2End.y >= 0 && i2End.x <= i2GridSize.x && i2End.y <= i2GridSize.y);
+    Trace.StartCell = f3Start.Recast<int>();
+    Trace.EndCell   = f3End.Recast<int>();
+    VERIFY_EXPR(Trace.StartCell.x >= 0 && Trace.StartCell.y >= 0 && Trace.StartCell.z >= 0 &&
+                Trace.StartCell.x <= i3GridSize.x && Trace.StartCell.y <= i3GridSize.y && Trace.StartCell.z <= i3GridSize.z);
+    VERIFY_EXPR(Trace.EndCell.x >= 0 && Trace.EndCell.y >= 0 && Trace.EndCell.z >= 0 &&
+                Trace.EndCell.x <= i3GridSize.x && Trace.EndCell.y <= i3GridSize.y && Trace.EndCell.z <= i3GridSize.z);
 
-        int2 i2Pos = f2Start.Recast<int>();
-        VERIFY_EXPR(i2Pos.x >= 0 && i2Pos.y >= 0 && i2Pos.x <= i2GridSize.x && i2Pos.y <= i2GridSize.y);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        Trace.Step[i] = f3Direction[i] > 0 ? 1 : -1;
+        if (std::abs(f3Direction[i]) > Epsilon)
+        {
+            // When the start point lies exactly on the cell boundary and the line goes in the
+            // negative direction, tMax is zero and the first step is made along this axis.
+            const auto NextBoundary = static_cast<float>(Trace.StartCell[i] + (Trace.Step[i] > 0 ? 1 : 0));
 
-        // Loop condition checks if we missed the end point of the line due to
-        // floating point precision issues.
-        // Normally we exit the loop when i2Pos == i2End.
-        while ((i2End.x - i2Pos.x) * dh >= 0 &&
-               (i2End.y - i2Pos.y) * dv >= 0)
+            Trace.tMax[i]   = (NextBoundary - f3Start[i]) / f3Direction[i];
+            Trace.tDelta[i] = static_cast<float>(Trace.Step[i]) / f3Direction[i];
+        }
+        else
         {
-            if (i2Pos.x < i2GridSize.x && i2Pos.y < i2GridSize.y)
-            {
-                if (!Callback(i2Pos))
-                    break;
-            }
+            Trace.tMax[i]   = FLT_MAX;
+            Trace.tDelta[i] = FLT_MAX;
+        }
+    }
 
-            if (i2Pos == i2End)
-            {
-                // End of the line
+    return true;
+}
+
+/// Traces a 3D line through the cubic cell grid and enumerates all cells the line passes through.
+
+/// \tparam TCallback - Type of the callback function.
+/// \param f3Start    - Line start point.
+/// \param f3End      - Line end point.
+/// \param i3GridSize - Grid dimensions.
+/// \param Callback   - Callback function that will be caled with the argument of type int3
+///                     for every cell visited. The function should return true to continue
+///                     tracing and false to stop it.
+///
+/// \remarks The algorithm clips the line against the grid boundaries [0 .. i3GridSize.x] x [0 .. i3GridSize.y] x [0 .. i3GridSize.z]
+///          and steps through the cells using the DDA algorithm by Amanatides and Woo: at every step, the line
+///          crosses the closest cell boundary. When boundaries along several axes are crossed at the same distance,
+///          x is stepped before y and y is stepped before z.
+///
+///          Similar to the 2D version, when one of the end points falls exactly on a cell boundary,
+///          the cell in the positive direction is enumerated.
+template <typename TCallback>
+void TraceLineThroughGrid(float3    f3Start,
+                          float3    f3End,
+                          int3      i3GridSize,
+                          TCallback Callback)
+{
+    GridLineTrace3D Trace;
+    if (!InitGridLineTrace(f3Start, f3End, i3GridSize, Trace))
+        return;
+
+    const int3 i3End = Trace.EndCell;
+    int3       i3Pos = Trace.StartCell;
+    float3     tMax  = Trace.tMax;
+
+    // Similar to the 2D version, the loop condition checks if we missed the end point due to
+    // floating point precision issues.
+    while ((i3End.x - i3Pos.x) * Trace.Step.x >= 0 &&
+           (i3End.y - i3Pos.y) * Trace.Step.y >= 0 &&
+           (i3End.z - i3Pos.z) * Trace.Step.z >= 0)
+    {
+        if (i3Pos.x < i3GridSize.x && i3Pos.y < i3GridSize.y && i3Pos.z < i3GridSize.z)
+        {
+            if (!Callback(i3Pos))
                 break;
+        }
+
+        if (i3Pos == i3End)
+        {
+            // End of the line
+            break;
+        }
+
+        // Cross the closest cell boundary
+        if (tMax.x <= tMax.y && tMax.x <= tMax.z)
+        {
+            i3Pos.x += Trace.Step.x;
+            tMax.x += Trace.tDelta.x;
+        }
+        else if (tMax.y <= tMax.z)
+        {
+            i3Pos.y += Trace.Step.y;
+            tMax.y += Trace.tDelta.y;
+        }
+        else
+        {
+            i3Pos.z += Trace.Step.z;
+            tMax.z += Trace.tDelta.z;
+        }
+    }
+}
+
+/// Structure-of-arrays view of 3D lines traced by TraceLinesThroughGrid().
+
+/// Every array contains NumLines elements. The structure does not own the memory.
+struct LineBatch3D
+{
+    const float* StartX = nullptr;
+    const float* StartY = nullptr;
+    const float* StartZ = nullptr;
+    const float* EndX   = nullptr;
+    const float* EndY   = nullptr;
+    const float* EndZ   = nullptr;
+
+    Uint32 NumLines = 0;
+};
+
+/// Traces NumLines 3D lines starting with FirstLine through the cubic cell grid.
+
+/// The callback is called with the line index (Uint32) and the cell (int3) for every cell visited.
+/// Every line enumerates the same cells in the same order as the 3D version of TraceLineThroughGrid().
+/// See the 2D version of TraceLinesThroughGrid() for details.
+template <typename TCallback>
+void TraceLinesThroughGrid(const LineBatch3D& Lines,
+                           Uint32             FirstLine,
+                           Uint32             NumLines,
+                           int3               i3GridSize,
+                           TCallback          Callback)
+{
+    VERIFY(FirstLine + NumLines <= Lines.NumLines, "Line range [", FirstLine, ", ", FirstLine + NumLines, ") is out of bounds");
+
+    const Uint32 EndLine = FirstLine + NumLines;
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+    // See the 2D version for the description of the lane management
+    enum LANE_ATTRIB : Uint32
+    {
+        POS         = 0,
+        END         = 3,
+        STEP        = 6,
+        T_MAX       = 9,
+        T_DELTA     = 12,
+        NUM_ATTRIBS = 15
+    };
+    float        Attribs[NUM_ATTRIBS][4] = {};
+    SIMD::Float4 v[NUM_ATTRIBS];
+    for (auto& a : v)
+        a = SIMD::Splat(0.f);
+
+    const auto Zero = SIMD::Splat(0.f);
+
+    const SIMD::Float4 GridSize[] = {
+        SIMD::Splat(static_cast<float>(i3GridSize.x)),
+        SIMD::Splat(static_cast<float>(i3GridSize.y)),
+        SIMD::Splat(static_cast<float>(i3GridSize.z)) //
+    };
+
+    Uint32 LaneLine[4] = {};
+    int    ActiveLanes = 0;
+    Uint32 NextLine    = FirstLine;
+    while (ActiveLanes != 0 || NextLine < EndLine)
+    {
+        if (ActiveLanes != 0xF && NextLine < EndLine)
+        {
+            // Assign the next lines to the idle lanes
+            for (Uint32 i = 0; i < 3; ++i)
+            {
+                SIMD::Store(Attribs[POS + i], v[POS + i]);
+                SIMD::Store(Attribs[T_MAX + i], v[T_MAX + i]);
             }
-            else
+            for (Uint32 lane = 0; lane < 4; ++lane)
             {
-                // step to the next cell
-                float t = f2Direction.x * (static_cast<float>(i2Pos.y) + 0.5f) - f2Direction.y * (static_cast<float>(i2Pos.x) + 0.5f);
-                if (std::abs(t + tx) < std::abs(t + ty))
-                    i2Pos.x += dh;
-                else
-                    i2Pos.y += dv;
+                while ((ActiveLanes & (1 << lane)) == 0 && NextLine < EndLine)
+                {
+                    const auto idx = NextLine++;
+
+                    GridLineTrace3D Trace;
+                    if (!InitGridLineTrace(float3{Lines.StartX[idx], Lines.StartY[idx], Lines.StartZ[idx]},
+                                           float3{Lines.EndX[idx], Lines.EndY[idx], Lines.EndZ[idx]},
+                                           i3GridSize, Trace))
+                        continue;
+
+                    for (Uint32 i = 0; i < 3; ++i)
+                    {
+                        Attribs[POS + i][lane]     = static_cast<float>(Trace.StartCell[i]);
+                        Attribs[END + i][lane]     = static_cast<float>(Trace.EndCell[i]);
+                        Attribs[STEP + i][lane]    = static_cast<float>(Trace.Step[i]);
+                        Attribs[T_MAX + i][lane]   = Trace.tMax[i];
+                        Attribs[T_DELTA + i][lane] = Trace.tDelta[i];
+                    }
+
+                    LaneLine[lane] = idx;
+                    ActiveLanes |= 1 << lane;
+                }
             }
+            for (Uint32 a = 0; a < NUM_ATTRIBS; ++a)
+                v[a] = SIMD::Load(Attribs[a]);
+        }
+
+        // Mask out the lines that missed the end point due to floating point precision issues
+        auto InRange = SIMD::CmpLE(Zero, SIMD::Mul(SIMD::Sub(v[END + 0], v[POS + 0]), v[STEP + 0]));
+        InRange      = SIMD::And(InRange, SIMD::CmpLE(Zero, SIMD::Mul(SIMD::Sub(v[END + 1], v[POS + 1]), v[STEP + 1])));
+        InRange      = SIMD::And(InRange, SIMD::CmpLE(Zero, SIMD::Mul(SIMD::Sub(v[END + 2], v[POS + 2]), v[STEP + 2])));
+        ActiveLanes &= SIMD::MoveMask(InRange);
+
+        // Cells on the far grid boundary are not enumerated
+        auto InGrid = SIMD::CmpLT(v[POS + 0], GridSize[0]);
+        InGrid      = SIMD::And(InGrid, SIMD::CmpLT(v[POS + 1], GridSize[1]));
+        InGrid      = SIMD::And(InGrid, SIMD::CmpLT(v[POS + 2], GridSize[2]));
+
+        const int VisitLanes = ActiveLanes & SIMD::MoveMask(InGrid);
+
+        Int32 Pos[3][4];
+        for (Uint32 i = 0; i < 3; ++i)
+            SIMD::StoreInt32(Pos[i], v[POS + i]);
+        for (Uint32 lane = 0; lane < 4; ++lane)
+        {
+            if ((VisitLanes & (1 << lane)) != 0 && !Callback(LaneLine[lane], int3{Pos[0][lane], Pos[1][lane], Pos[2][lane]}))
+                ActiveLanes &= ~(1 << lane);
         }
+
+        // Mask out the lines that reached the end cell
+        auto AtEnd = SIMD::CmpEQ(v[POS + 0], v[END + 0]);
+        AtEnd      = SIMD::And(AtEnd, SIMD::CmpEQ(v[POS + 1], v[END + 1]));
+        AtEnd      = SIMD::And(AtEnd, SIMD::CmpEQ(v[POS + 2], v[END + 2]));
+        ActiveLanes &= ~SIMD::MoveMask(AtEnd);
+
+        // Cross the closest cell boundary using the same comparisons as TraceLineThroughGrid()
+        const auto StepX  = SIMD::And(SIMD::CmpLE(v[T_MAX + 0], v[T_MAX + 1]), SIMD::CmpLE(v[T_MAX + 0], v[T_MAX + 2]));
+        const auto StepY  = SIMD::Select(StepX, Zero, SIMD::CmpLE(v[T_MAX + 1], v[T_MAX + 2]));
+        const auto StepXY = SIMD::Or(StepX, StepY);
+
+        v[POS + 0]   = SIMD::Add(v[POS + 0], SIMD::And(StepX, v[STEP + 0]));
+        v[T_MAX + 0] = SIMD::Add(v[T_MAX + 0], SIMD::And(StepX, v[T_DELTA + 0]));
+        v[POS + 1]   = SIMD::Add(v[POS + 1], SIMD::And(StepY, v[STEP + 1]));
+        v[T_MAX + 1] = SIMD::Add(v[T_MAX + 1], SIMD::And(StepY, v[T_DELTA + 1]));
+        v[POS + 2]   = SIMD::Add(v[POS + 2], SIMD::Select(StepXY, Zero, v[STEP + 2]));
+        v[T_MAX + 2] = SIMD::Add(v[T_MAX + 2], SIMD::Select(StepXY, Zero, v[T_DELTA + 2]));
+    }
+#else
+    for (Uint32 line = FirstLine; line < EndLine; ++line)
+    {
+        TraceLineThroughGrid(float3{Lines.StartX[line], Lines.StartY[line], Lines.StartZ[line]},
+                             float3{Lines.EndX[line], Lines.EndY[line], Lines.EndZ[line]},
+                             i3GridSize,
+                             [&](int3 Cell) { return Callback(line, Cell); });
     }
+#endif
 }
 
 
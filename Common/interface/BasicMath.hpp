@@ -52,6 +52,7 @@
 #include <algorithm>
 
 #include "HashUtils.hpp"
+#include "BasicMathSIMD.hpp"
 
 #ifdef _MSC_VER
 #    pragma warning(push)
@@ -458,7 +459,7 @@ Vector3<T> operator*(T s, const Vector3<T>& a)
 }
 
 
-template <class T> struct Vector4
+template <class T> struct DILIGENT_MATH_ALIGNAS Vector4
 {
     union
     {
@@ -1000,7 +1001,7 @@ template <class T> struct Matrix3x3
     }
 };
 
-template <class T> struct Matrix4x4
+template <class T> struct DILIGENT_MATH_ALIGNAS Matrix4x4
 {
     union
     {
@@ -1561,6 +1562,74 @@ template <class T> struct Matrix4x4
     }
 };
 
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+
+// SIMD implementations of the most expensive float operations (see BasicMathSIMD.hpp).
+// Members are explicitly specialized, so the interface of the types is the same as with the scalar code.
+
+template <>
+inline Vector4<float> Vector4<float>::operator*(const Matrix4x4<float>& m) const
+{
+    const SIMD::Float4 Rows[] = {SIMD::Load(m[0]), SIMD::Load(m[1]), SIMD::Load(m[2]), SIMD::Load(m[3])};
+
+    Vector4<float> out;
+    // Set() lets the compiler build the vector from registers and avoids store forwarding stalls
+    // when the vector components have just been written
+    SIMD::Store(&out.x, SIMD::MulVectorMatrix(SIMD::Set(x, y, z, w), Rows));
+    return out;
+}
+
+template <>
+inline Matrix4x4<float> Matrix4x4<float>::Mul(const Matrix4x4<float>& m1, const Matrix4x4<float>& m2)
+{
+    Matrix4x4<float> mOut;
+#    if DILIGENT_MATH_SIMD == DILIGENT_MATH_SIMD_AVX2
+    // Every 256-bit register holds two rows of m1. Rows of m2 are replicated to both halves.
+    const __m256 B0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2[0]));
+    const __m256 B1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2[1]));
+    const __m256 B2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2[2]));
+    const __m256 B3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2[3]));
+    for (int i = 0; i < 4; i += 2)
+    {
+        const __m256 A = _mm256_loadu_ps(m1[i]);
+
+        __m256 r = _mm256_mul_ps(_mm256_shuffle_ps(A, A, _MM_SHUFFLE(0, 0, 0, 0)), B0);
+        r        = _mm256_fmadd_ps(_mm256_shuffle_ps(A, A, _MM_SHUFFLE(1, 1, 1, 1)), B1, r);
+        r        = _mm256_fmadd_ps(_mm256_shuffle_ps(A, A, _MM_SHUFFLE(2, 2, 2, 2)), B2, r);
+        r        = _mm256_fmadd_ps(_mm256_shuffle_ps(A, A, _MM_SHUFFLE(3, 3, 3, 3)), B3, r);
+        _mm256_storeu_ps(mOut[i], r);
+    }
+#    else
+    const SIMD::Float4 Rows[] = {SIMD::Load(m2[0]), SIMD::Load(m2[1]), SIMD::Load(m2[2]), SIMD::Load(m2[3])};
+    for (int i = 0; i < 4; ++i)
+        SIMD::Store(mOut[i], SIMD::MulVectorMatrix(SIMD::Load(m1[i]), Rows));
+#    endif
+    return mOut;
+}
+
+template <>
+inline float Matrix4x4<float>::Determinant() const
+{
+    const SIMD::Float4 Rows[] = {SIMD::Load(m[0]), SIMD::Load(m[1]), SIMD::Load(m[2]), SIMD::Load(m[3])};
+    return SIMD::GetX(SIMD::InverseMatrix(Rows, nullptr));
+}
+
+template <>
+inline Matrix4x4<float> Matrix4x4<float>::Inverse() const
+{
+    const SIMD::Float4 Rows[] = {SIMD::Load(m[0]), SIMD::Load(m[1]), SIMD::Load(m[2]), SIMD::Load(m[3])};
+
+    SIMD::Float4 InvRows[4];
+    SIMD::InverseMatrix(Rows, InvRows);
+
+    Matrix4x4<float> inv;
+    for (int i = 0; i < 4; ++i)
+        SIMD::Store(inv[i], InvRows[i]);
+    return inv;
+}
+
+#endif
+
 // Template Vector Operations
 
 
@@ -1747,6 +1816,19 @@ Vector4<T> operator*(const Matrix4x4<T>& m, const Vector4<T>& v)
     return out;
 }
 
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+inline Vector4<float> operator*(const Matrix4x4<float>& m, const Vector4<float>& v)
+{
+    // out[i] = dot(m[i], v) is computed as a sum of the matrix columns scaled by the vector components
+    SIMD::Float4 Cols[] = {SIMD::Load(m[0]), SIMD::Load(m[1]), SIMD::Load(m[2]), SIMD::Load(m[3])};
+    SIMD::Transpose(Cols[0], Cols[1], Cols[2], Cols[3]);
+
+    Vector4<float> out;
+    SIMD::Store(&out.x, SIMD::MulVectorMatrix(SIMD::Set(v.x, v.y, v.z, v.w), Cols));
+    return out;
+}
+#endif
+
 template <class T>
 Vector3<T> operator*(const Matrix3x3<T>& m, Vector3<T>& v)
 {
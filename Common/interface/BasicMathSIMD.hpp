@@ -0,0 +1,440 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// SIMD primitives used by the float specializations of BasicMath types.
+///
+/// The instruction set is selected at compile time by the DILIGENT_MATH_SIMD macro, which may be
+/// set to one of the DILIGENT_MATH_SIMD_* values below. If the macro is not defined, the best
+/// instruction set enabled for the target by the compiler options is used:
+///   - DILIGENT_MATH_SIMD_AVX2 if both AVX2 and FMA instructions are enabled (-mavx2 -mfma, or /arch:AVX2
+///     with MSVC, which does not define __FMA__ but implies FMA support)
+///   - DILIGENT_MATH_SIMD_SSE2 on all other x86-64 targets and 32-bit x86 targets compiled with SSE2
+///   - DILIGENT_MATH_SIMD_NEON on AArch64 targets
+///   - DILIGENT_MATH_SIMD_NONE otherwise
+/// Define DILIGENT_MATH_SIMD to DILIGENT_MATH_SIMD_NONE to always use the scalar code.
+///
+/// SIMD code performs matrix-matrix and vector-matrix multiplication in the same order as the scalar
+/// code, so the results are identical as long as no fused multiply-add (FMA) is involved. FMA rounds
+/// once instead of twice, and the results may differ in the last bits when it is used either explicitly
+/// (DILIGENT_MATH_SIMD_AVX2) or implicitly by the compiler, which is allowed to contract a * b + c in
+/// scalar or NEON code (GCC and Clang do this by default when FMA instructions are available, e.g. with
+/// -mfma or on AArch64; use -ffp-contract=off to disable). Determinant and inverse use a different
+/// factorization and match the scalar results within the rounding error.
+///
+/// If DILIGENT_MATH_ALIGNED_STORAGE is defined to 1, Vector4 and Matrix4x4 are aligned by 16 bytes.
+/// This changes the layout of structures that contain these types and is disabled by default.
+
+#define DILIGENT_MATH_SIMD_NONE 0
+#define DILIGENT_MATH_SIMD_SSE2 1
+#define DILIGENT_MATH_SIMD_AVX2 2
+#define DILIGENT_MATH_SIMD_NEON 3
+
+#ifndef DILIGENT_MATH_SIMD
+#    if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#        define DILIGENT_MATH_SIMD DILIGENT_MATH_SIMD_AVX2
+#    elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#        define DILIGENT_MATH_SIMD DILIGENT_MATH_SIMD_SSE2
+#    elif defined(__aarch64__) || defined(_M_ARM64)
+#        define DILIGENT_MATH_SIMD DILIGENT_MATH_SIMD_NEON
+#    else
+#        define DILIGENT_MATH_SIMD DILIGENT_MATH_SIMD_NONE
+#    endif
+#endif
+
+#ifndef DILIGENT_MATH_ALIGNED_STORAGE
+#    define DILIGENT_MATH_ALIGNED_STORAGE 0
+#endif
+
+#if DILIGENT_MATH_ALIGNED_STORAGE
+#    define DILIGENT_MATH_ALIGNAS alignas(16)
+#else
+#    define DILIGENT_MATH_ALIGNAS
+#endif
+
+#include "../../Primitives/interface/BasicTypes.h"
+
+#if DILIGENT_MATH_SIMD == DILIGENT_MATH_SIMD_AVX2
+#    if !defined(__FMA__) && !defined(_MSC_VER)
+#        error DILIGENT_MATH_SIMD_AVX2 requires FMA instructions to be enabled (e.g. -mfma)
+#    endif
+#    include <immintrin.h>
+#elif DILIGENT_MATH_SIMD == DILIGENT_MATH_SIMD_SSE2
+#    include <emmintrin.h>
+#elif DILIGENT_MATH_SIMD == DILIGENT_MATH_SIMD_NEON
+#    include <arm_neon.h>
+#elif DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+#    error Unknown value of DILIGENT_MATH_SIMD
+#endif
+
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+
+namespace Diligent
+{
+
+namespace SIMD
+{
+
+#    if DILIGENT_MATH_SIMD == DILIGENT_MATH_SIMD_NEON
+
+using Float4 = float32x4_t;
+
+// clang-format off
+inline Float4 Load (const float* p)         { return vld1q_f32(p); }
+inline void   Store(float* p, Float4 v)     { vst1q_f32(p, v); }
+inline Float4 Splat(float f)                { return vdupq_n_f32(f); }
+inline Float4 Add  (Float4 a, Float4 b)     { return vaddq_f32(a, b); }
+inline Float4 Sub  (Float4 a, Float4 b)     { return vsubq_f32(a, b); }
+inline Float4 Mul  (Float4 a, Float4 b)     { return vmulq_f32(a, b); }
+inline Float4 Div  (Float4 a, Float4 b)     { return vdivq_f32(a, b); }
+// clang-format on
+
+inline Float4 Set(float x, float y, float z, float w)
+{
+    const float f[] = {x, y, z, w};
+    return vld1q_f32(f);
+}
+
+inline float GetX(Float4 v)
+{
+    return vgetq_lane_f32(v, 0);
+}
+
+// Returns {a[X], a[Y], b[Z], b[W]}
+template <int X, int Y, int Z, int W>
+Float4 Shuffle(Float4 a, Float4 b)
+{
+    Float4 r = vdupq_n_f32(vgetq_lane_f32(a, X));
+    r        = vsetq_lane_f32(vgetq_lane_f32(a, Y), r, 1);
+    r        = vsetq_lane_f32(vgetq_lane_f32(b, Z), r, 2);
+    r        = vsetq_lane_f32(vgetq_lane_f32(b, W), r, 3);
+    return r;
+}
+
+template <int Lane>
+Float4 SplatLane(Float4 v)
+{
+    return vdupq_laneq_f32(v, Lane);
+}
+
+// Comparison returns all bits set in the lanes where the condition is true
+inline Float4 CmpLT(Float4 a, Float4 b)
+{
+    return vreinterpretq_f32_u32(vcltq_f32(a, b));
+}
+
+inline Float4 CmpLE(Float4 a, Float4 b)
+{
+    return vreinterpretq_f32_u32(vcleq_f32(a, b));
+}
+
+inline Float4 CmpEQ(Float4 a, Float4 b)
+{
+    return vreinterpretq_f32_u32(vceqq_f32(a, b));
+}
+
+inline Float4 Or(Float4 a, Float4 b)
+{
+    return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+}
+
+inline Float4 And(Float4 a, Float4 b)
+{
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+}
+
+// Returns a in the lanes where Mask is set and b elsewhere
+inline Float4 Select(Float4 Mask, Float4 a, Float4 b)
+{
+    return vbslq_f32(vreinterpretq_u32_f32(Mask), a, b);
+}
+
+// clang-format off
+inline Float4 Min(Float4 a, Float4 b) { return vminq_f32(a, b); }
+inline Float4 Max(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+inline Float4 Abs(Float4 v)           { return vabsq_f32(v); }
+// clang-format on
+
+// Rounds towards negative infinity
+inline Float4 Floor(Float4 v)
+{
+    return vrndmq_f32(v);
+}
+
+// Converts the lanes to integers rounding towards zero and stores them
+inline void StoreInt32(Int32* p, Float4 v)
+{
+    vst1q_s32(p, vcvtq_s32_f32(v));
+}
+
+// Packs the sign bits of the four lanes into the four low bits of the result
+inline int MoveMask(Float4 v)
+{
+    static const int32_t Shifts[] = {0, 1, 2, 3};
+
+    const auto SignBits = vshrq_n_u32(vreinterpretq_u32_f32(v), 31);
+    return static_cast<int>(vaddvq_u32(vshlq_u32(SignBits, vld1q_s32(Shifts))));
+}
+
+#    else
+
+using Float4 = __m128;
+
+// clang-format off
+inline Float4 Load (const float* p)         { return _mm_loadu_ps(p); }
+inline void   Store(float* p, Float4 v)     { _mm_storeu_ps(p, v); }
+inline Float4 Splat(float f)                { return _mm_set1_ps(f); }
+inline Float4 Add  (Float4 a, Float4 b)     { return _mm_add_ps(a, b); }
+inline Float4 Sub  (Float4 a, Float4 b)     { return _mm_sub_ps(a, b); }
+inline Float4 Mul  (Float4 a, Float4 b)     { return _mm_mul_ps(a, b); }
+inline Float4 Div  (Float4 a, Float4 b)     { return _mm_div_ps(a, b); }
+// clang-format on
+
+inline Float4 Set(float x, float y, float z, float w)
+{
+    return _mm_setr_ps(x, y, z, w);
+}
+
+inline float GetX(Float4 v)
+{
+    return _mm_cvtss_f32(v);
+}
+
+// Returns {a[X], a[Y], b[Z], b[W]}
+template <int X, int Y, int Z, int W>
+Float4 Shuffle(Float4 a, Float4 b)
+{
+    return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+}
+
+template <int Lane>
+Float4 SplatLane(Float4 v)
+{
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+}
+
+// Comparison returns all bits set in the lanes where the condition is true
+inline Float4 CmpLT(Float4 a, Float4 b)
+{
+    return _mm_cmplt_ps(a, b);
+}
+
+inline Float4 CmpLE(Float4 a, Float4 b)
+{
+    return _mm_cmple_ps(a, b);
+}
+
+inline Float4 CmpEQ(Float4 a, Float4 b)
+{
+    return _mm_cmpeq_ps(a, b);
+}
+
+inline Float4 Or(Float4 a, Float4 b)
+{
+    return _mm_or_ps(a, b);
+}
+
+inline Float4 And(Float4 a, Float4 b)
+{
+    return _mm_and_ps(a, b);
+}
+
+// Returns a in the lanes where Mask is set and b elsewhere
+inline Float4 Select(Float4 Mask, Float4 a, Float4 b)
+{
+    return _mm_or_ps(_mm_and_ps(Mask, a), _mm_andnot_ps(Mask, b));
+}
+
+// clang-format off
+inline Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+inline Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+inline Float4 Abs(Float4 v)           { return _mm_andnot_ps(_mm_set1_ps(-0.f), v); }
+// clang-format on
+
+// Rounds towards negative infinity. Only valid for values that fit into 32-bit integer range,
+// the same as FastFloor().
+inline Float4 Floor(Float4 v)
+{
+    const auto t = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+    // Subtract 1 from the lanes where truncation rounded up
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmplt_ps(v, t), _mm_set1_ps(1.f)));
+}
+
+// Converts the lanes to integers rounding towards zero and stores them
+inline void StoreInt32(Int32* p, Float4 v)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_cvttps_epi32(v));
+}
+
+// Packs the sign bits of the four lanes into the four low bits of the result
+inline int MoveMask(Float4 v)
+{
+    return _mm_movemask_ps(v);
+}
+
+#    endif
+
+// Returns {a[X], a[Y], a[Z], a[W]}
+template <int X, int Y, int Z, int W>
+Float4 Swizzle(Float4 a)
+{
+    return Shuffle<X, Y, Z, W>(a, a);
+}
+
+// Returns {p[Idx[0]], p[Idx[1]], p[Idx[2]], p[Idx[3]]}. Only AVX2 has gather instructions,
+// other instruction sets load the lanes one by one.
+inline Float4 Gather(const float* p, const Int32 Idx[4])
+{
+#    if DILIGENT_MATH_SIMD == DILIGENT_MATH_SIMD_AVX2
+    return _mm_i32gather_ps(p, _mm_loadu_si128(reinterpret_cast<const __m128i*>(Idx)), 4);
+#    else
+    return Set(p[Idx[0]], p[Idx[1]], p[Idx[2]], p[Idx[3]]);
+#    endif
+}
+
+// Returns a * b + c. Fused multiply-add is only used by AVX2 path.
+inline Float4 MulAdd(Float4 a, Float4 b, Float4 c)
+{
+#    if DILIGENT_MATH_SIMD == DILIGENT_MATH_SIMD_AVX2
+    return _mm_fmadd_ps(a, b, c);
+#    else
+    return Add(Mul(a, b), c);
+#    endif
+}
+
+// Multiplies the row-vector by the row-major 4x4 matrix stored in Rows.
+inline Float4 MulVectorMatrix(Float4 v, const Float4 Rows[4])
+{
+    auto r = Mul(SplatLane<0>(v), Rows[0]);
+    r      = MulAdd(SplatLane<1>(v), Rows[1], r);
+    r      = MulAdd(SplatLane<2>(v), Rows[2], r);
+    r      = MulAdd(SplatLane<3>(v), Rows[3], r);
+    return r;
+}
+
+inline void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+{
+    // {r0[0], r0[1], r1[0], r1[1]}, {r0[2], r0[3], r1[2], r1[3]}, ...
+    const auto t0 = Shuffle<0, 1, 0, 1>(r0, r1);
+    const auto t1 = Shuffle<2, 3, 2, 3>(r0, r1);
+    const auto t2 = Shuffle<0, 1, 0, 1>(r2, r3);
+    const auto t3 = Shuffle<2, 3, 2, 3>(r2, r3);
+
+    r0 = Shuffle<0, 2, 0, 2>(t0, t2);
+    r1 = Shuffle<1, 3, 1, 3>(t0, t2);
+    r2 = Shuffle<0, 2, 0, 2>(t1, t3);
+    r3 = Shuffle<1, 3, 1, 3>(t1, t3);
+}
+
+// The following functions operate on 2x2 row-major matrices packed into a single vector {m00, m01, m10, m11}.
+// A# denotes the adjugate matrix.
+
+// A * B
+inline Float4 Mat2Mul(Float4 A, Float4 B)
+{
+    return Add(Mul(A, Swizzle<0, 3, 0, 3>(B)), Mul(Swizzle<1, 0, 3, 2>(A), Swizzle<2, 1, 2, 1>(B)));
+}
+
+// A# * B
+inline Float4 Mat2AdjMul(Float4 A, Float4 B)
+{
+    return Sub(Mul(Swizzle<3, 3, 0, 0>(A), B), Mul(Swizzle<1, 1, 2, 2>(A), Swizzle<2, 3, 0, 1>(B)));
+}
+
+// A * B#
+inline Float4 Mat2MulAdj(Float4 A, Float4 B)
+{
+    return Sub(Mul(A, Swizzle<3, 0, 3, 0>(B)), Mul(Swizzle<1, 0, 3, 2>(A), Swizzle<2, 1, 2, 1>(B)));
+}
+
+// Sum of all components, replicated to every lane
+inline Float4 HorizontalSum(Float4 v)
+{
+    v = Add(v, Swizzle<2, 3, 0, 1>(v));
+    return Add(v, Swizzle<1, 0, 3, 2>(v));
+}
+
+// Inverts the row-major 4x4 matrix using block-wise inversion of 2x2 sub-matrices:
+//
+//       | A  B |                        | (|D|A - B(D#C))#  (|B|C - D(A#B)#)# |
+//   M = |      |,   M^-1 = 1 / |M| *    |                                     |
+//       | C  D |                        | (|C|B - A(D#C)#)# (|A|D - C(A#B))#  |
+//
+// where |M| = |A||D| + |B||C| - tr((A#B)(D#C)).
+// If pInv is null, only the determinant is computed. Returns the determinant replicated to every lane.
+inline Float4 InverseMatrix(const Float4 Rows[4], Float4 pInv[4])
+{
+    const auto A = Shuffle<0, 1, 0, 1>(Rows[0], Rows[1]);
+    const auto B = Shuffle<2, 3, 2, 3>(Rows[0], Rows[1]);
+    const auto C = Shuffle<0, 1, 0, 1>(Rows[2], Rows[3]);
+    const auto D = Shuffle<2, 3, 2, 3>(Rows[2], Rows[3]);
+
+    // {|A|, |B|, |C|, |D|}
+    const auto DetSub = Sub(Mul(Shuffle<0, 2, 0, 2>(Rows[0], Rows[2]), Shuffle<1, 3, 1, 3>(Rows[1], Rows[3])),
+                            Mul(Shuffle<1, 3, 1, 3>(Rows[0], Rows[2]), Shuffle<0, 2, 0, 2>(Rows[1], Rows[3])));
+
+    const auto DetA = SplatLane<0>(DetSub);
+    const auto DetB = SplatLane<1>(DetSub);
+    const auto DetC = SplatLane<2>(DetSub);
+    const auto DetD = SplatLane<3>(DetSub);
+
+    const auto D_C = Mat2AdjMul(D, C);
+    const auto A_B = Mat2AdjMul(A, B);
+
+    auto DetM = Add(Mul(DetA, DetD), Mul(DetB, DetC));
+    DetM      = Sub(DetM, HorizontalSum(Mul(A_B, Swizzle<0, 2, 1, 3>(D_C))));
+    if (pInv == nullptr)
+        return DetM;
+
+    auto X = Sub(Mul(DetD, A), Mat2Mul(B, D_C));
+    auto W = Sub(Mul(DetA, D), Mat2Mul(C, A_B));
+    auto Y = Sub(Mul(DetB, C), Mat2MulAdj(D, A_B));
+    auto Z = Sub(Mul(DetC, B), Mat2MulAdj(A, D_C));
+
+    const auto RcpDetM = Div(Set(1.f, -1.f, -1.f, 1.f), DetM);
+
+    X = Mul(X, RcpDetM);
+    Y = Mul(Y, RcpDetM);
+    Z = Mul(Z, RcpDetM);
+    W = Mul(W, RcpDetM);
+
+    // Apply adjugate and transpose the blocks
+    pInv[0] = Shuffle<3, 1, 3, 1>(X, Y);
+    pInv[1] = Shuffle<2, 0, 2, 0>(X, Y);
+    pInv[2] = Shuffle<3, 1, 3, 1>(Z, W);
+    pInv[3] = Shuffle<2, 0, 2, 0>(Z, W);
+
+    return DetM;
+}
+
+} // namespace SIMD
+
+} // namespace Diligent
+
+#endif
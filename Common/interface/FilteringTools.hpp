@@ -27,6 +27,9 @@
 
 #pragma once
 
+#include <vector>
+#include <limits>
+
 #include "../../Platforms/interface/PlatformDefinitions.h"
 
 #include "BasicMath.hpp"
@@ -245,4 +248,354 @@ DstType FilterTexture2DBilinearClampUC(Uint32         Width,
     return FilterTexture2DBilinear<SrcType, DstType, TEXTURE_ADDRESS_CLAMP, TEXTURE_ADDRESS_CLAMP, false>(Width, Height, pData, Stride, u, v);
 }
 
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+
+/// Computes linear texture filter sample info for four coordinates at once.
+///
+/// The same operations are performed as in GetLinearTexFilterSampleInfo(), so the results are identical
+/// as long as the unnormalized coordinates are less than 2^24 by absolute value and the compiler does not
+/// contract the scalar code into fused multiply-adds (see BasicMathSIMD.hpp). Otherwise, the weights
+/// match within the rounding error, and a sample index may differ by one when the coordinate is within
+/// the rounding error of a texel center, where the corresponding weight is close to 0 or 1.
+///
+/// \param [in]  Width - Texture width.
+/// \param [in]  u     - Texture sample coordinates.
+/// \param [out] i0    - First sample indices.
+/// \param [out] i1    - Second sample indices.
+/// \param [out] w     - Blend weights.
+template <TEXTURE_ADDRESS_MODE AddressMode, bool IsNormalizedCoord>
+void GetLinearTexFilterSampleInfo4(Uint32 Width, SIMD::Float4 u, Int32 i0[4], Int32 i1[4], SIMD::Float4& w)
+{
+    const auto fWidth = SIMD::Splat(static_cast<float>(Width));
+
+    const auto x  = IsNormalizedCoord ? SIMD::Mul(u, fWidth) : u;
+    const auto xc = SIMD::Sub(x, SIMD::Splat(0.5f));
+
+    auto x0 = SIMD::Floor(xc);
+    auto x1 = SIMD::Add(x0, SIMD::Splat(1.f));
+    w       = SIMD::Sub(xc, x0);
+
+    // Indices are integers that are exactly representable as floats, so address modes
+    // are applied in floating-point arithmetic.
+    auto WrapCoord = [](SIMD::Float4 i, SIMD::Float4 Width) {
+        auto r = SIMD::Sub(i, SIMD::Mul(SIMD::Floor(SIMD::Div(i, Width)), Width));
+        // Correct the rounding of the division
+        r = SIMD::Select(SIMD::CmpLT(r, SIMD::Splat(0.f)), SIMD::Add(r, Width), r);
+        r = SIMD::Select(SIMD::CmpLE(Width, r), SIMD::Sub(r, Width), r);
+        return r;
+    };
+
+    auto MirrorCoord = [WrapCoord](SIMD::Float4 i, SIMD::Float4 Width) {
+        i = WrapCoord(i, SIMD::Add(Width, Width));
+        return SIMD::Select(SIMD::CmpLE(Width, i), SIMD::Sub(SIMD::Sub(SIMD::Add(Width, Width), SIMD::Splat(1.f)), i), i);
+    };
+
+    switch (AddressMode)
+    {
+        case TEXTURE_ADDRESS_UNKNOWN:
+            // do nothing
+            break;
+
+        case TEXTURE_ADDRESS_WRAP:
+            x0 = WrapCoord(x0, fWidth);
+            x1 = WrapCoord(x1, fWidth);
+            break;
+
+        case TEXTURE_ADDRESS_MIRROR:
+            x0 = MirrorCoord(x0, fWidth);
+            x1 = MirrorCoord(x1, fWidth);
+            break;
+
+        case TEXTURE_ADDRESS_CLAMP:
+        {
+            const auto MaxCoord = SIMD::Splat(static_cast<float>(Width - 1));
+            x0                  = SIMD::Min(SIMD::Max(x0, SIMD::Splat(0.f)), MaxCoord);
+            x1                  = SIMD::Min(SIMD::Max(x1, SIMD::Splat(0.f)), MaxCoord);
+            break;
+        }
+
+        default:
+            UNEXPECTED("Unexpected texture address mode");
+    }
+
+    SIMD::StoreInt32(i0, x0);
+    SIMD::StoreInt32(i1, x1);
+}
+
+// Blends four bilinear samples given the sample indices and weights
+template <typename SrcType, typename DstType>
+void _FilterTexture2DBilinear4(const SrcType* pData,
+                               size_t         Stride,
+                               const Int32    u0[4],
+                               const Int32    u1[4],
+                               SIMD::Float4   wu,
+                               const Int32    v0[4],
+                               const Int32    v1[4],
+                               SIMD::Float4   wv,
+                               DstType*       pDst)
+{
+    float fwu[4], fwv[4];
+    SIMD::Store(fwu, wu);
+    SIMD::Store(fwv, wv);
+    for (Uint32 i = 0; i < 4; ++i)
+    {
+        auto S00 = static_cast<DstType>(pData[u0[i] + v0[i] * Stride]);
+        auto S10 = static_cast<DstType>(pData[u1[i] + v0[i] * Stride]);
+        auto S01 = static_cast<DstType>(pData[u0[i] + v1[i] * Stride]);
+        auto S11 = static_cast<DstType>(pData[u1[i] + v1[i] * Stride]);
+        pDst[i]  = lerp(lerp(S00, S10, fwu[i]), lerp(S01, S11, fwu[i]), fwv[i]);
+    }
+}
+
+// Fetches four texels at the given offsets and converts them to float
+template <typename SrcType>
+SIMD::Float4 _FetchTexels4(const SrcType* pData, const Int32 Offsets[4])
+{
+    return SIMD::Set(static_cast<float>(pData[Offsets[0]]),
+                     static_cast<float>(pData[Offsets[1]]),
+                     static_cast<float>(pData[Offsets[2]]),
+                     static_cast<float>(pData[Offsets[3]]));
+}
+
+// Float texels are fetched with gather instructions when they are available
+inline SIMD::Float4 _FetchTexels4(const float* pData, const Int32 Offsets[4])
+{
+    return SIMD::Gather(pData, Offsets);
+}
+
+// Blends four bilinear samples in the same order as lerp() does
+inline SIMD::Float4 _LerpBilinear4(SIMD::Float4 S00, SIMD::Float4 S10, SIMD::Float4 S01, SIMD::Float4 S11, SIMD::Float4 wu, SIMD::Float4 wv)
+{
+    auto Lerp = [](SIMD::Float4 Left, SIMD::Float4 Right, SIMD::Float4 w) {
+        return SIMD::Add(SIMD::Mul(Left, SIMD::Sub(SIMD::Splat(1.f), w)), SIMD::Mul(Right, w));
+    };
+    return Lerp(Lerp(S00, S10, wu), Lerp(S01, S11, wu), wv);
+}
+
+// Float destination: the samples are fetched and blended with SIMD instructions.
+// All texel offsets must fit into Int32.
+template <typename SrcType>
+void _FilterTexture2DBilinear4(const SrcType* pData,
+                               size_t         Stride,
+                               const Int32    u0[4],
+                               const Int32    u1[4],
+                               SIMD::Float4   wu,
+                               const Int32    v0[4],
+                               const Int32    v1[4],
+                               SIMD::Float4   wv,
+                               float*         pDst)
+{
+    Int32 Offsets00[4], Offsets10[4], Offsets01[4], Offsets11[4];
+    for (Uint32 i = 0; i < 4; ++i)
+    {
+        const auto Row0 = v0[i] * static_cast<Int32>(Stride);
+        const auto Row1 = v1[i] * static_cast<Int32>(Stride);
+
+        Offsets00[i] = u0[i] + Row0;
+        Offsets10[i] = u1[i] + Row0;
+        Offsets01[i] = u0[i] + Row1;
+        Offsets11[i] = u1[i] + Row1;
+    }
+
+    const auto S00 = _FetchTexels4(pData, Offsets00);
+    const auto S10 = _FetchTexels4(pData, Offsets10);
+    const auto S01 = _FetchTexels4(pData, Offsets01);
+    const auto S11 = _FetchTexels4(pData, Offsets11);
+    SIMD::Store(pDst, _LerpBilinear4(S00, S10, S01, S11, wu, wv));
+}
+
+#endif
+
+/// Samples 2D texture using bilinear filter at NumSamples locations.
+///
+/// The results match calling FilterTexture2DBilinear() for every sample within the rounding error.
+/// They are identical when no fused multiply-add contraction takes place (see GetLinearTexFilterSampleInfo4()).
+/// When SIMD is available, sample indices and weights are computed for four samples at a time. If DstType
+/// is float, the texels are also fetched (with gather instructions on AVX2) and blended four at a time.
+/// Textures with more than 2^31 texels are sampled one texel at a time.
+///
+/// \param [in]  Width   - Texture width.
+/// \param [in]  Height  - Texture height.
+/// \param [in]  pData   - Pointer to the texture data.
+/// \param [in]  Stride  - Data stride, in pixels.
+/// \param [in]  pU      - Sample u coordinates.
+/// \param [in]  pV      - Sample v coordinates.
+/// \param [in]  NumSamples - Number of samples.
+/// \param [out] pDst    - Filtered texture samples.
+template <typename SrcType,
+          typename DstType,
+          TEXTURE_ADDRESS_MODE AddressModeU,
+          TEXTURE_ADDRESS_MODE AddressModeV,
+          bool                 IsNormalizedCoord>
+void FilterTexture2DBilinearBatch(Uint32         Width,
+                                  Uint32         Height,
+                                  const SrcType* pData,
+                                  size_t         Stride,
+                                  const float*   pU,
+                                  const float*   pV,
+                                  size_t         NumSamples,
+                                  DstType*       pDst)
+{
+    size_t s = 0;
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+    // SIMD fetches use 32-bit texel offsets
+    const auto NumSIMDSamples = Height * Stride <= static_cast<size_t>(std::numeric_limits<Int32>::max()) ? NumSamples : 0;
+    for (; s + 4 <= NumSIMDSamples; s += 4)
+    {
+        Int32        u0[4], u1[4], v0[4], v1[4];
+        SIMD::Float4 wu, wv;
+        GetLinearTexFilterSampleInfo4<AddressModeU, IsNormalizedCoord>(Width, SIMD::Load(pU + s), u0, u1, wu);
+        GetLinearTexFilterSampleInfo4<AddressModeV, IsNormalizedCoord>(Height, SIMD::Load(pV + s), v0, v1, wv);
+#    ifdef DILIGENT_DEBUG
+        for (Uint32 i = 0; i < 4; ++i)
+        {
+            _DbgVerifyFilterInfo<AddressModeU>(LinearTexFilterSampleInfo{u0[i], u1[i], 0}, Width, "horizontal", pU[s + i]);
+            _DbgVerifyFilterInfo<AddressModeV>(LinearTexFilterSampleInfo{v0[i], v1[i], 0}, Height, "vertical", pV[s + i]);
+        }
+#    endif
+        _FilterTexture2DBilinear4(pData, Stride, u0, u1, wu, v0, v1, wv, pDst + s);
+    }
+#endif
+
+    for (; s < NumSamples; ++s)
+    {
+        pDst[s] = FilterTexture2DBilinear<SrcType, DstType, AddressModeU, AddressModeV, IsNormalizedCoord>(Width, Height, pData, Stride, pU[s], pV[s]);
+    }
+}
+
+// Blends a row of bilinear samples given the column sample indices and weights
+template <typename SrcType, typename DstType>
+void _ResampleRow2DBilinear(const SrcType* pRow0,
+                            const SrcType* pRow1,
+                            const Int32*   pColI0,
+                            const Int32*   pColI1,
+                            const float*   pColW,
+                            float          RowW,
+                            Uint32         Width,
+                            DstType*       pDst)
+{
+    for (Uint32 x = 0; x < Width; ++x)
+    {
+        auto S00 = static_cast<DstType>(pRow0[pColI0[x]]);
+        auto S10 = static_cast<DstType>(pRow0[pColI1[x]]);
+        auto S01 = static_cast<DstType>(pRow1[pColI0[x]]);
+        auto S11 = static_cast<DstType>(pRow1[pColI1[x]]);
+        pDst[x]  = lerp(lerp(S00, S10, pColW[x]), lerp(S01, S11, pColW[x]), RowW);
+    }
+}
+
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+// Float destination: four columns are fetched and blended at a time
+template <typename SrcType>
+void _ResampleRow2DBilinear(const SrcType* pRow0,
+                            const SrcType* pRow1,
+                            const Int32*   pColI0,
+                            const Int32*   pColI1,
+                            const float*   pColW,
+                            float          RowW,
+                            Uint32         Width,
+                            float*         pDst)
+{
+    const auto wv = SIMD::Splat(RowW);
+
+    Uint32 x = 0;
+    for (; x + 4 <= Width; x += 4)
+    {
+        const auto wu  = SIMD::Load(pColW + x);
+        const auto S00 = _FetchTexels4(pRow0, pColI0 + x);
+        const auto S10 = _FetchTexels4(pRow0, pColI1 + x);
+        const auto S01 = _FetchTexels4(pRow1, pColI0 + x);
+        const auto S11 = _FetchTexels4(pRow1, pColI1 + x);
+        SIMD::Store(pDst + x, _LerpBilinear4(S00, S10, S01, S11, wu, wv));
+    }
+    _ResampleRow2DBilinear<SrcType, float>(pRow0, pRow1, pColI0 + x, pColI1 + x, pColW + x, RowW, Width - x, pDst + x);
+}
+#endif
+
+/// Resamples a 2D texture region using bilinear filter.
+///
+/// Destination pixel (x, y) receives the texture sample at (UStart + x * UStep, VStart + y * VStep),
+/// which matches the value returned by FilterTexture2DBilinear() for these coordinates within the
+/// rounding error, see FilterTexture2DBilinearBatch().
+/// Since the sample grid is separable, horizontal sample indices and weights are computed once
+/// per column and vertical ones once per row. When SIMD is available, column sample indices
+/// are computed for four columns at a time, and if DstType is float, the texels of four columns
+/// are fetched (with gather instructions on AVX2) and blended at a time.
+///
+/// \param [in]  SrcWidth   - Source texture width.
+/// \param [in]  SrcHeight  - Source texture height.
+/// \param [in]  pSrc       - Pointer to the source texture data.
+/// \param [in]  SrcStride  - Source data stride, in pixels.
+/// \param [in]  DstWidth   - Destination region width.
+/// \param [in]  DstHeight  - Destination region height.
+/// \param [out] pDst       - Pointer to the destination data.
+/// \param [in]  DstStride  - Destination data stride, in pixels.
+/// \param [in]  UStart     - Sample u coordinate of the first column.
+/// \param [in]  VStart     - Sample v coordinate of the first row.
+/// \param [in]  UStep      - Sample u coordinate increment between columns.
+/// \param [in]  VStep      - Sample v coordinate increment between rows.
+template <typename SrcType,
+          typename DstType,
+          TEXTURE_ADDRESS_MODE AddressModeU,
+          TEXTURE_ADDRESS_MODE AddressModeV,
+          bool                 IsNormalizedCoord>
+void ResampleTexture2DBilinear(Uint32         SrcWidth,
+                               Uint32         SrcHeight,
+                               const SrcType* pSrc,
+                               size_t         SrcStride,
+                               Uint32         DstWidth,
+                               Uint32         DstHeight,
+                               DstType*       pDst,
+                               size_t         DstStride,
+                               float          UStart,
+                               float          VStart,
+                               float          UStep,
+                               float          VStep)
+{
+    // Column sample indices and weights in structure-of-arrays layout
+    std::vector<Int32> ColI0(DstWidth), ColI1(DstWidth);
+    std::vector<float> ColW(DstWidth);
+
+    Uint32 x = 0;
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+    for (; x + 4 <= DstWidth; x += 4)
+    {
+        const auto u = SIMD::Add(SIMD::Splat(UStart),
+                                 SIMD::Mul(SIMD::Set(static_cast<float>(x), static_cast<float>(x + 1), static_cast<float>(x + 2), static_cast<float>(x + 3)),
+                                           SIMD::Splat(UStep)));
+
+        SIMD::Float4 w;
+        GetLinearTexFilterSampleInfo4<AddressModeU, IsNormalizedCoord>(SrcWidth, u, &ColI0[x], &ColI1[x], w);
+        SIMD::Store(&ColW[x], w);
+    }
+#endif
+    for (; x < DstWidth; ++x)
+    {
+        const auto Info = GetLinearTexFilterSampleInfo<AddressModeU, IsNormalizedCoord>(SrcWidth, UStart + static_cast<float>(x) * UStep);
+
+        ColI0[x] = Info.i0;
+        ColI1[x] = Info.i1;
+        ColW[x]  = Info.w;
+    }
+
+#ifdef DILIGENT_DEBUG
+    for (x = 0; x < DstWidth; ++x)
+        _DbgVerifyFilterInfo<AddressModeU>(LinearTexFilterSampleInfo{ColI0[x], ColI1[x], ColW[x]}, SrcWidth, "horizontal", UStart + static_cast<float>(x) * UStep);
+#endif
+
+    for (Uint32 y = 0; y < DstHeight; ++y)
+    {
+        const auto  v       = VStart + static_cast<float>(y) * VStep;
+        const auto  RowInfo = GetLinearTexFilterSampleInfo<AddressModeV, IsNormalizedCoord>(SrcHeight, v);
+        const auto* pRow0   = pSrc + RowInfo.i0 * SrcStride;
+        const auto* pRow1   = pSrc + RowInfo.i1 * SrcStride;
+        auto*       pDstRow = pDst + y * DstStride;
+#ifdef DILIGENT_DEBUG
+        _DbgVerifyFilterInfo<AddressModeV>(RowInfo, SrcHeight, "vertical", v);
+#endif
+
+        _ResampleRow2DBilinear(pRow0, pRow1, ColI0.data(), ColI1.data(), ColW.data(), RowInfo.w, DstWidth, pDstRow);
+    }
+}
+
 } // namespace Diligent
@@ -31,6 +31,7 @@
 #include <memory>
 #include <cstring>
 
+#include "../../Primitives/interface/BasicTypes.h"
 #include "../../Primitives/interface/Errors.hpp"
 #include "../../Platforms/Basic/interface/DebugUtilities.hpp"
 
@@ -61,6 +62,28 @@ std::size_t ComputeHash(const ArgsType&... Args)
     return Seed;
 }
 
+/// Offset basis of the 64-bit FNV-1a hash, see ComputeFNVHash()
+static constexpr Uint64 FNVHashSeed = 0xcbf29ce484222325ull;
+
+/// Computes the 64-bit FNV-1a hash of the data.
+
+/// Unlike std::hash, the value is the same on all platforms and runs, so it
+/// can be used as a key of the data that is stored on disk.
+/// \param [in] pData - Data to hash.
+/// \param [in] Size  - Data size, in bytes.
+/// \param [in] Seed  - Initial hash value. Pass the result of the previous call to hash several pieces of data.
+inline Uint64 ComputeFNVHash(const void* pData, size_t Size, Uint64 Seed = FNVHashSeed)
+{
+    Uint64      Hash  = Seed;
+    const auto* pByte = static_cast<const Uint8*>(pData);
+    for (size_t i = 0; i < Size; ++i)
+    {
+        Hash ^= pByte[i];
+        Hash *= 0x100000001b3ull;
+    }
+    return Hash;
+}
+
 template <typename CharType>
 struct CStringHash
 {
@@ -0,0 +1,190 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Depth-only software rasterizer for CPU occlusion culling
+
+#include <vector>
+
+#include "../../Primitives/interface/BasicTypes.h"
+#include "AdvancedMath.hpp"
+
+namespace Diligent
+{
+
+/// Tiled depth-only rasterizer that renders occluders into a low-resolution depth buffer and tests
+/// bounding boxes of occludees against its hierarchical-Z (HiZ) pyramid.
+
+/// Usage:
+///   1. Clear() the depth buffer at the beginning of the frame.
+///   2. AddOccluder() for every occluder mesh. Triangles are transformed, set up and binned into
+///      TileSize x TileSize screen tiles.
+///   3. Rasterize() the binned triangles, 4 samples at a time when SIMD is available, and build the
+///      HiZ pyramid. Tiles are independent, so the application may instead distribute disjoint tile
+///      ranges between its worker threads with RasterizeTiles() and call BuildHiZ() when all of them
+///      have finished.
+///   4. Test occludees with IsVisible().
+///
+/// Samples are located at integer coordinates and the sample (0, 0) is the bottom left corner of the screen.
+/// Samples on triangle edges are covered, the same as in RasterizeTriangle(). Depth is z/w in [0, 1] range
+/// with smaller values being closer to the camera.
+///
+/// Occluder triangles that have a vertex in front of the near plane are not rendered, which is
+/// conservative as it can only make more occludees visible.
+class OcclusionRasterizer
+{
+public:
+    struct CreateInfo
+    {
+        /// Depth buffer width
+        Uint32 Width = 256;
+
+        /// Depth buffer height
+        Uint32 Height = 128;
+
+        /// Whether the matrices use OpenGL depth range [-1, 1]
+        bool IsGL = false;
+    };
+
+    explicit OcclusionRasterizer(const CreateInfo& CI);
+
+    static constexpr Uint32 TileSize = 32;
+
+    /// Clears the depth buffer and removes all binned triangles
+    void Clear();
+
+    /// Transforms the triangles by the WorldViewProj matrix and bins them into tiles.
+    /// If pIndices is null, every three consecutive vertices form a triangle.
+    /// If CullBackFaces is true, triangles with counter-clockwise winding are skipped, which
+    /// halves the work for closed meshes.
+    void AddOccluder(const float3*   pVertices,
+                     Uint32          NumVertices,
+                     const Uint32*   pIndices,
+                     Uint32          NumTriangles,
+                     const float4x4& WorldViewProj,
+                     bool            CullBackFaces = false);
+
+    /// Bins the triangle with vertices given in screen space: x and y are sample coordinates,
+    /// and z is the depth.
+    void AddScreenSpaceTriangle(const float3& V0, const float3& V1, const float3& V2);
+
+    /// Rasterizes all binned triangles into the depth buffer and builds the HiZ pyramid.
+    void Rasterize();
+
+    /// Returns the number of screen tiles. Tile i covers the samples of column (i % NumTilesX) and
+    /// row (i / NumTilesX), where NumTilesX is the number of tiles in a row.
+    Uint32 GetNumTiles() const { return m_NumTilesX * m_NumTilesY; }
+
+    /// Rasterizes the triangles binned into NumTiles tiles starting with FirstTile and updates
+    /// the level 0 HiZ texels that cover these tiles.
+    ///
+    /// \remarks Disjoint tile ranges may be rasterized by different threads. No triangles must be
+    ///          added while the tiles are rasterized.
+    void RasterizeTiles(Uint32 FirstTile, Uint32 NumTiles);
+
+    /// Builds the HiZ levels starting with level 1. Must be called after all tiles have been rasterized.
+    void BuildHiZ();
+
+    /// Tests if the bounding box transformed by ViewProj matrix may be visible.
+    /// The test is conservative: the box may be reported visible when it is occluded, but never otherwise.
+    bool IsVisible(const BoundBox& Box, const float4x4& ViewProj) const;
+
+    /// Returns the depth of the sample
+    float GetDepth(Uint32 x, Uint32 y) const
+    {
+        VERIFY_EXPR(x < m_Width && y < m_Height);
+        return m_Depth[size_t{y} * m_Stride + x];
+    }
+
+    Uint32 GetWidth() const { return m_Width; }
+    Uint32 GetHeight() const { return m_Height; }
+
+    Uint32 GetNumHiZLevels() const { return static_cast<Uint32>(m_HiZ.size()); }
+
+    /// Returns the maximum depth of the samples covered by HiZ texel (x, y) of the given level.
+    /// Level 0 texel covers HiZBlockSize x HiZBlockSize samples; every next level halves the resolution.
+    float GetHiZ(Uint32 Level, Uint32 x, Uint32 y) const
+    {
+        const auto& HiZ = m_HiZ[Level];
+        VERIFY_EXPR(x < HiZ.Width && y < HiZ.Height);
+        return HiZ.Depth[size_t{y} * HiZ.Width + x];
+    }
+
+    static constexpr Uint32 HiZBlockSize = 8;
+
+private:
+    struct ScreenTriangle
+    {
+        // Edge functions E_i(x, y) = EdgeA[i] * x + EdgeB[i] * y + EdgeC[i] are non-negative inside the triangle
+        float EdgeA[3];
+        float EdgeB[3];
+        float EdgeC[3];
+
+        // Depth plane Z(x, y) = ZA * x + ZB * y + ZC
+        float ZA;
+        float ZB;
+        float ZC;
+        float MinZ;
+
+        // Bounding box of the covered samples, clamped to the screen
+        int MinX;
+        int MinY;
+        int MaxX;
+        int MaxY;
+    };
+
+    struct HiZLevel
+    {
+        Uint32             Width  = 0;
+        Uint32             Height = 0;
+        std::vector<float> Depth;
+    };
+
+    void RasterizeTile(Uint32 TileX, Uint32 TileY);
+    void UpdateTileHiZ(Uint32 TileX, Uint32 TileY);
+
+    const Uint32 m_Width;
+    const Uint32 m_Height;
+    const bool   m_IsGL;
+
+    // Depth buffer dimensions are padded to the multiple of the tile size
+    const Uint32 m_Stride;
+    const Uint32 m_NumTilesX;
+    const Uint32 m_NumTilesY;
+
+    std::vector<float> m_Depth;
+
+    std::vector<ScreenTriangle>      m_Triangles;
+    std::vector<std::vector<Uint32>> m_TileBins;
+    std::vector<float4>              m_ScreenVerts; // Scratch space used by AddOccluder()
+
+    std::vector<HiZLevel> m_HiZ;
+};
+
+} // namespace Diligent
@@ -0,0 +1,388 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of Diligent::PersistentFileStore class, Diligent::ContentHashKey struct and
+/// Diligent::PersistentCache class template
+
+#include <list>
+#include <cstring>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <unordered_map>
+#include <type_traits>
+
+#include "../../Primitives/interface/BasicTypes.h"
+#include "../../Platforms/Basic/interface/DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+/// Directory of files that each store one cache entry.
+
+/// The name of the file is derived from the hash of the entry key. The file starts with a header
+/// that contains the magic number and the version of the store and the size of the payload,
+/// followed by the key itself, so that files written by a different version of the store, files
+/// of a different key that maps to the same name and truncated files are all rejected.
+/// Files are written to a temporary file that is then renamed, so that other threads and
+/// processes that share the directory never observe a partially written file.
+/// All methods are thread-safe.
+class PersistentFileStore
+{
+public:
+    /// \param [in] Magic     - Magic number that identifies the files of the store.
+    /// \param [in] Version   - Version of the file layout. Files of other versions are ignored.
+    /// \param [in] Extension - File name extension without the dot.
+    /// \param [in] Name      - Name of the store that is used in log messages.
+    PersistentFileStore(Uint32 Magic, Uint32 Version, const Char* Extension, const Char* Name);
+
+    // clang-format off
+    PersistentFileStore             (const PersistentFileStore&)  = delete;
+    PersistentFileStore             (      PersistentFileStore&&) = delete;
+    PersistentFileStore& operator = (const PersistentFileStore&)  = delete;
+    PersistentFileStore& operator = (      PersistentFileStore&&) = delete;
+    // clang-format on
+
+    /// Sets the directory where the files are stored. The directory is created if it does not exist.
+    /// Null or empty string disables the store. Returns false if the directory could not be created.
+    bool SetDirectory(const Char* Directory);
+
+    bool IsEnabled() const;
+
+    /// Returns the path of the file that stores the entry with the given key.
+    String GetFilePath(const void* pKey, size_t KeySize) const;
+
+    /// Reads the payload of the entry with the given key. Returns false if the file does
+    /// not exist or was not written by this version of the store for this key.
+    bool Load(const void* pKey, size_t KeySize, std::vector<Uint8>& Data) const;
+
+    /// Writes the entry with the given key.
+    bool Store(const void* pKey, size_t KeySize, const void* pData, size_t DataSize) const;
+
+private:
+    const Uint32 m_Magic;
+    const Uint32 m_Version;
+    const String m_Extension;
+    const String m_Name;
+
+    mutable std::mutex m_DirectoryMtx;
+    String             m_Directory;
+};
+
+
+/// Value traits of the persistent cache for contiguous containers of trivially copyable
+/// elements, such as String or std::vector<Uint32>.
+template <typename ContainerType>
+struct PersistentCacheContainerTraits
+{
+    using ElementType = typename ContainerType::value_type;
+    static_assert(std::is_trivially_copyable<ElementType>::value, "Container elements are written to files as is");
+
+    /// Returns the number of bytes the value occupies in memory
+    static size_t GetSize(const ContainerType& Value)
+    {
+        return Value.size() * sizeof(ElementType);
+    }
+
+    /// Writes the value to the array of bytes that is stored on disk
+    static bool Serialize(const ContainerType& Value, std::vector<Uint8>& Data)
+    {
+        const auto* pBytes = reinterpret_cast<const Uint8*>(Value.data());
+        Data.assign(pBytes, pBytes + GetSize(Value));
+        return true;
+    }
+
+    /// Reads the value from the array of bytes loaded from disk
+    static bool Deserialize(const std::vector<Uint8>& Data, ContainerType& Value)
+    {
+        if (Data.size() % sizeof(ElementType) != 0)
+            return false;
+
+        ContainerType NewValue;
+        NewValue.resize(Data.size() / sizeof(ElementType));
+        if (!Data.empty())
+            memcpy(&NewValue[0], Data.data(), Data.size());
+        Value = std::move(NewValue);
+        return true;
+    }
+};
+
+
+/// Key of a content-addressed cache entry that is produced from a source, such as
+/// shader source code, and a set of attributes the source is processed with.
+
+/// The key combines the hash and the length of the source with the hash of the attributes.
+/// It can be used as the KeyType of PersistentCache.
+struct ContentHashKey
+{
+    Uint64 SourceHash   = 0;
+    Uint64 SourceLength = 0;
+    Uint64 AttribsHash  = 0;
+
+    bool operator==(const ContentHashKey& rhs) const
+    {
+        return SourceHash == rhs.SourceHash &&
+            SourceLength == rhs.SourceLength &&
+            AttribsHash == rhs.AttribsHash;
+    }
+
+    struct Hasher
+    {
+        size_t operator()(const ContentHashKey& K) const
+        {
+            return static_cast<size_t>(K.SourceHash ^ (K.AttribsHash * 0x9e3779b97f4a7c15ull));
+        }
+    };
+};
+
+
+/// Content-addressed cache that keeps the most recently used values in memory and,
+/// if a directory is set, stores every value on disk so that it survives application restarts.
+
+/// \tparam KeyType     - Key type. The key is written to files as is, so it must be trivially
+///                       copyable and must not contain padding. The type must define
+///                       operator== and the nested Hasher type.
+/// \tparam ValueType   - Value type.
+/// \tparam ValueTraits - Value traits, see PersistentCacheContainerTraits.
+///
+/// All methods are thread-safe.
+template <typename KeyType, typename ValueType, typename ValueTraits = PersistentCacheContainerTraits<ValueType>>
+class PersistentCache
+{
+public:
+    static_assert(std::is_trivially_copyable<KeyType>::value, "Keys are written to files as is");
+
+    struct Statistics
+    {
+        /// Number of lookups served from memory
+        Uint64 NumMemoryHits = 0;
+
+        /// Number of lookups served from the cache directory
+        Uint64 NumDiskHits = 0;
+
+        /// Number of lookups that found no value
+        Uint64 NumMisses = 0;
+
+        Uint64 GetNumLookups() const
+        {
+            return NumMemoryHits + NumDiskHits + NumMisses;
+        }
+
+        /// Returns the fraction of lookups that found the value
+        double GetHitRate() const
+        {
+            const auto NumLookups = GetNumLookups();
+            return NumLookups != 0 ? static_cast<double>(NumMemoryHits + NumDiskHits) / static_cast<double>(NumLookups) : 0.0;
+        }
+    };
+
+    /// \param [in] Magic         - Magic number of the cache files, see PersistentFileStore.
+    /// \param [in] Version       - Version of the cache files. Must be incremented whenever the file
+    ///                             layout changes or the same key starts to identify a different value.
+    /// \param [in] Extension     - Extension of the cache files.
+    /// \param [in] Name          - Name of the cache that is used in log messages.
+    /// \param [in] MaxMemorySize - Maximum total size, in bytes, of the values kept in memory.
+    PersistentCache(Uint32 Magic, Uint32 Version, const Char* Extension, const Char* Name, size_t MaxMemorySize) :
+        m_FileStore{Magic, Version, Extension, Name},
+        m_MaxMemorySize{MaxMemorySize}
+    {}
+
+    // clang-format off
+    PersistentCache             (const PersistentCache&)  = delete;
+    PersistentCache             (      PersistentCache&&) = delete;
+    PersistentCache& operator = (const PersistentCache&)  = delete;
+    PersistentCache& operator = (      PersistentCache&&) = delete;
+    // clang-format on
+
+    /// Looks up the value in memory and then on disk.
+    /// Returns true and writes the value to Value if it was found.
+    bool Find(const KeyType& K, ValueType& Value)
+    {
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+
+            auto it = m_EntriesHash.find(K);
+            if (it != m_EntriesHash.end())
+            {
+                // Move the entry to the front of the list
+                m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+                Value = it->second->second;
+                ++m_NumMemoryHits;
+                return true;
+            }
+        }
+
+        // Other threads are served from memory while the file is being read
+        std::vector<Uint8> Data;
+        ValueType          LoadedValue;
+        if (!m_FileStore.IsEnabled() ||
+            !m_FileStore.Load(&K, sizeof(K), Data) ||
+            !ValueTraits::Deserialize(Data, LoadedValue))
+        {
+            ++m_NumMisses;
+            return false;
+        }
+
+        ++m_NumDiskHits;
+        Value = LoadedValue;
+
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        AddToMemory(K, std::move(LoadedValue));
+        return true;
+    }
+
+    /// Adds the value to the cache and writes it to the cache directory, if one is set.
+    void Add(const KeyType& K, const ValueType& Value)
+    {
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+            AddToMemory(K, Value);
+        }
+
+        if (!m_FileStore.IsEnabled())
+            return;
+
+        std::vector<Uint8> Data;
+        if (ValueTraits::Serialize(Value, Data))
+            m_FileStore.Store(&K, sizeof(K), Data.data(), Data.size());
+    }
+
+    /// Sets the directory where the values are stored. The directory is created
+    /// if it does not exist. Null or empty string disables the on-disk store.
+    bool SetDirectory(const Char* Directory)
+    {
+        return m_FileStore.SetDirectory(Directory);
+    }
+
+    /// Returns the path of the file in the cache directory that stores the value.
+    String GetFilePath(const KeyType& K) const
+    {
+        return m_FileStore.GetFilePath(&K, sizeof(K));
+    }
+
+    /// Sets the maximum total size, in bytes, of the values kept in memory.
+    /// Least recently used values are evicted when the size is exceeded.
+    void SetMaxMemorySize(size_t MaxMemorySize)
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_MaxMemorySize = MaxMemorySize;
+        EvictEntries();
+    }
+
+    /// Removes all values from memory. Values stored on disk are not affected.
+    void Clear()
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_EntriesHash.clear();
+        m_Entries.clear();
+        m_MemorySize = 0;
+    }
+
+    size_t GetNumEntries() const
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        return m_Entries.size();
+    }
+
+    size_t GetMemorySize() const
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        return m_MemorySize;
+    }
+
+    Statistics GetStatistics() const
+    {
+        Statistics Stats;
+        Stats.NumMemoryHits = m_NumMemoryHits.load();
+        Stats.NumDiskHits   = m_NumDiskHits.load();
+        Stats.NumMisses     = m_NumMisses.load();
+        return Stats;
+    }
+
+    void ResetStatistics()
+    {
+        m_NumMemoryHits.store(0);
+        m_NumDiskHits.store(0);
+        m_NumMisses.store(0);
+    }
+
+private:
+    void AddToMemory(const KeyType& K, ValueType Value)
+    {
+        auto it = m_EntriesHash.find(K);
+        if (it != m_EntriesHash.end())
+        {
+            // The same value may have been added by another thread
+            m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+            return;
+        }
+
+        const auto Size = ValueTraits::GetSize(Value);
+        if (Size > m_MaxMemorySize)
+            return;
+
+        m_MemorySize += Size;
+        m_Entries.emplace_front(K, std::move(Value));
+        m_EntriesHash.emplace(K, m_Entries.begin());
+        EvictEntries();
+    }
+
+    void EvictEntries()
+    {
+        while (m_MemorySize > m_MaxMemorySize && !m_Entries.empty())
+        {
+            const auto& LastEntry = m_Entries.back();
+            const auto  Size      = ValueTraits::GetSize(LastEntry.second);
+            VERIFY_EXPR(m_MemorySize >= Size);
+            m_MemorySize -= Size;
+            m_EntriesHash.erase(LastEntry.first);
+            m_Entries.pop_back();
+        }
+    }
+
+    using EntryListType = std::list<std::pair<KeyType, ValueType>>;
+
+    PersistentFileStore m_FileStore;
+
+    mutable std::mutex m_Mtx;
+
+    // Most recently used entries are at the front of the list
+    EntryListType                                                                           m_Entries;
+    std::unordered_map<KeyType, typename EntryListType::iterator, typename KeyType::Hasher> m_EntriesHash;
+
+    size_t m_MemorySize    = 0;
+    size_t m_MaxMemorySize = 0;
+
+    std::atomic<Uint64> m_NumMemoryHits{0};
+    std::atomic<Uint64> m_NumDiskHits{0};
+    std::atomic<Uint64> m_NumMisses{0};
+};
+
+} // namespace Diligent
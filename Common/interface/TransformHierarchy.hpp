@@ -0,0 +1,232 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Batched transform operations and transform hierarchy
+
+#include <vector>
+
+#include "../../Primitives/interface/BasicTypes.h"
+#include "BasicMath.hpp"
+
+namespace Diligent
+{
+
+/// Structure-of-arrays view of translation-rotation-scale transforms.
+
+/// Every array contains NumTransforms elements. Rotations are unit quaternions.
+/// The structure does not own the memory.
+struct TransformBatch
+{
+    const float* TranslationX = nullptr;
+    const float* TranslationY = nullptr;
+    const float* TranslationZ = nullptr;
+
+    const float* RotationX = nullptr;
+    const float* RotationY = nullptr;
+    const float* RotationZ = nullptr;
+    const float* RotationW = nullptr;
+
+    const float* ScaleX = nullptr;
+    const float* ScaleY = nullptr;
+    const float* ScaleZ = nullptr;
+
+    Uint32 NumTransforms = 0;
+};
+
+/// Computes the matrices of NumTransforms transforms starting with FirstTransform.
+
+/// The matrix of transform i is written to pMatrices[i - FirstTransform] and is equal to
+///
+///     float4x4::Scale(S) * Quaternion{R}.ToMatrix() * float4x4::Translation(T)
+///
+/// i.e. a vector is scaled, then rotated, then translated. The transforms are processed 4 at a time
+/// when SIMD is available.
+void ComposeTransforms(const TransformBatch& Transforms,
+                       Uint32                FirstTransform,
+                       Uint32                NumTransforms,
+                       float4x4*             pMatrices);
+
+/// Computes pOut[i] = pA[i] * pB[i] for Count matrices. pOut may be equal to pA or pB.
+void MultiplyTransforms(const float4x4* pA,
+                        const float4x4* pB,
+                        float4x4*       pOut,
+                        Uint32          Count);
+
+/// Computes pOut[i] = pA[i] * B for Count matrices. pOut may be equal to pA.
+void MultiplyTransforms(const float4x4* pA,
+                        const float4x4& B,
+                        float4x4*       pOut,
+                        Uint32          Count);
+
+/// Inverts Count affine matrices. pInverse may be equal to pMatrices.
+
+/// The last column of every matrix must be (0, 0, 0, 1). The inverse of the upper 3x3 part is
+/// computed from its cofactors, which is considerably cheaper than the general float4x4::Inverse().
+/// The matrices are processed 4 at a time when SIMD is available.
+void InvertAffineTransforms(const float4x4* pMatrices,
+                            float4x4*       pInverse,
+                            Uint32          Count);
+
+
+/// Hierarchy of translation-rotation-scale transforms.
+
+/// Local transforms of the nodes are stored as a structure of arrays, see GetLocalTransforms().
+/// Update() computes the local matrices with ComposeTransforms() and then the world matrices:
+///
+///     World[i] = Local[i] * World[Parent[i]]
+///
+/// A parent is always added before its children, so node indices are in parent-before-child order.
+/// Update() processes the nodes in index order. To update the hierarchy with multiple threads, the application
+/// distributes the work between its own threads:
+///
+///   1. BeginUpdate()
+///   2. ComposeLocalMatrices() for disjoint node ranges
+///   3. UpdateWorldMatrices() for disjoint ranges of every level, in level order
+///
+/// Every level contains the nodes of the same depth. The nodes of one level are independent of each other,
+/// but a level may only be started when all local matrices and the previous level are complete.
+class TransformHierarchy
+{
+public:
+    static constexpr Uint32 InvalidNode = ~Uint32{0};
+
+    /// Adds a node and returns its index. Parent must be either InvalidNode or the index of an existing node.
+    Uint32 AddNode(Uint32            Parent,
+                   const float3&     Translation = float3{0, 0, 0},
+                   const Quaternion& Rotation    = Quaternion{0, 0, 0, 1},
+                   const float3&     Scale       = float3{1, 1, 1});
+
+    /// Removes all nodes
+    void Clear();
+
+    /// Preallocates the memory for NumNodes nodes
+    void Reserve(Uint32 NumNodes);
+
+    Uint32 GetNumNodes() const { return static_cast<Uint32>(m_Parents.size()); }
+
+    Uint32 GetParent(Uint32 Node) const
+    {
+        VERIFY_EXPR(Node < GetNumNodes());
+        return m_Parents[Node];
+    }
+
+    void SetTranslation(Uint32 Node, const float3& Translation);
+    void SetRotation(Uint32 Node, const Quaternion& Rotation);
+    void SetScale(Uint32 Node, const float3& Scale);
+
+    float3     GetTranslation(Uint32 Node) const;
+    Quaternion GetRotation(Uint32 Node) const;
+    float3     GetScale(Uint32 Node) const;
+
+    /// Returns the structure-of-arrays view of the local transforms.
+    /// The view is invalidated when a node is added.
+    TransformBatch GetLocalTransforms() const;
+
+    /// Computes local and world matrices of all nodes.
+    void Update();
+
+    /// Prepares the hierarchy for the update with ComposeLocalMatrices() and UpdateWorldMatrices().
+    /// Must be called by one thread before the update and after any node has been added.
+    void BeginUpdate();
+
+    /// Computes the local matrices of NumNodes nodes starting with FirstNode.
+    ///
+    /// \remarks Disjoint node ranges may be processed by different threads.
+    void ComposeLocalMatrices(Uint32 FirstNode, Uint32 NumNodes);
+
+    /// Returns the number of nodes in the level, i.e. the number of nodes with the depth equal to Level.
+    /// Only valid after BeginUpdate().
+    Uint32 GetLevelSize(Uint32 Level) const
+    {
+        VERIFY_EXPR(!m_LevelsDirty && Level < m_NumLevels);
+        return m_LevelStart[Level + 1] - m_LevelStart[Level];
+    }
+
+    /// Computes the world matrices of NumNodes nodes of the level, starting with the level node FirstNode.
+    ///
+    /// \remarks Disjoint ranges of one level may be processed by different threads. The local matrices
+    ///          of all nodes and the world matrices of the previous level must be complete.
+    void UpdateWorldMatrices(Uint32 Level, Uint32 FirstNode, Uint32 NumNodes);
+
+    /// Returns the local matrix of the node computed by the last Update()
+    const float4x4& GetLocalMatrix(Uint32 Node) const
+    {
+        VERIFY_EXPR(Node < m_LocalMatrices.size());
+        return m_LocalMatrices[Node];
+    }
+
+    /// Returns the world matrix of the node computed by the last Update()
+    const float4x4& GetWorldMatrix(Uint32 Node) const
+    {
+        VERIFY_EXPR(Node < m_WorldMatrices.size());
+        return m_WorldMatrices[Node];
+    }
+
+    /// Returns the world matrices of all nodes computed by the last Update()
+    const float4x4* GetWorldMatrices() const { return m_WorldMatrices.data(); }
+
+    /// Returns the number of levels, i.e. the maximum node depth plus one
+    Uint32 GetNumLevels() const { return m_NumLevels; }
+
+private:
+    void UpdateLevels();
+
+    enum LOCAL_ATTRIB : Uint32
+    {
+        TRANSLATION_X,
+        TRANSLATION_Y,
+        TRANSLATION_Z,
+        ROTATION_X,
+        ROTATION_Y,
+        ROTATION_Z,
+        ROTATION_W,
+        SCALE_X,
+        SCALE_Y,
+        SCALE_Z,
+        LOCAL_ATTRIB_COUNT
+    };
+    std::vector<float> m_Local[LOCAL_ATTRIB_COUNT];
+
+    std::vector<Uint32> m_Parents;
+    std::vector<Uint32> m_Depths;
+    Uint32              m_NumLevels = 0;
+
+    std::vector<float4x4> m_LocalMatrices;
+    std::vector<float4x4> m_WorldMatrices;
+
+    // Node indices sorted by depth, and the index of the first node of every level in this array.
+    // Only used by UpdateWorldMatrices().
+    std::vector<Uint32> m_LevelNodes;
+    std::vector<Uint32> m_LevelStart;
+
+    bool m_LevelsDirty = true;
+};
+
+} // namespace Diligent
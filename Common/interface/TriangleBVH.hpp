@@ -0,0 +1,180 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Bounding volume hierarchy for ray queries against triangle meshes
+
+#include <vector>
+
+#include "../../Primitives/interface/BasicTypes.h"
+#include "AdvancedMath.hpp"
+
+namespace Diligent
+{
+
+/// Bounding volume hierarchy of triangles built with the surface area heuristic (SAH).
+
+/// Nodes are stored in a flat array in depth-first order: the left child of an interior
+/// node immediately follows the node, so that traversal mostly moves forward in memory.
+/// Triangle vertices are copied into the hierarchy in leaf order, and the source mesh
+/// does not need to be kept alive after the hierarchy is built.
+/// Ray-box and ray-triangle tests use IntersectRayAABB() and IntersectRayTriangle().
+/// All queries are const and may be executed by multiple threads concurrently.
+class TriangleBVH
+{
+public:
+    struct CreateInfo
+    {
+        /// Vertex positions
+        const float3* pVertices = nullptr;
+
+        /// Number of vertices in pVertices
+        Uint32 NumVertices = 0;
+
+        /// Triangle list indices, three per triangle. If null, every three consecutive
+        /// vertices form a triangle.
+        const Uint32* pIndices = nullptr;
+
+        /// Number of triangles
+        Uint32 NumTriangles = 0;
+
+        /// Maximum number of triangles in a leaf. Nodes with more triangles are always split.
+        Uint32 MaxTrianglesPerLeaf = 4;
+
+        /// Number of bins used to evaluate the surface area heuristic.
+        Uint32 NumSAHBins = 16;
+
+        /// Number of threads used to build the hierarchy. Subtrees are built in parallel
+        /// when the value is greater than 1.
+        Uint32 NumThreads = 1;
+    };
+
+    explicit TriangleBVH(const CreateInfo& CI);
+
+    static constexpr Uint32 InvalidTriangleIndex = ~Uint32{0};
+
+    /// Hierarchy node (32 bytes)
+    struct Node
+    {
+        float3 Min;
+        /// Index of the right child for interior nodes; index of the first triangle for leaves.
+        /// The left child of an interior node is the next node in the array.
+        Uint32 RightChildOrFirstTriangle = 0;
+
+        float3 Max;
+        /// Number of triangles in the leaf, or 0 for interior nodes
+        Uint32 NumTriangles = 0;
+
+        bool IsLeaf() const { return NumTriangles != 0; }
+
+        BoundBox GetBoundBox() const { return BoundBox{Min, Max}; }
+    };
+
+    struct HitInfo
+    {
+        /// Distance along the ray to the hit point, in units of the ray direction length
+        float Distance = FLT_MAX;
+
+        /// Index of the hit triangle in the source mesh
+        Uint32 TriangleIndex = InvalidTriangleIndex;
+
+        bool IsHit() const { return TriangleIndex != InvalidTriangleIndex; }
+    };
+
+    /// Finds the closest intersection with distance in the range [0, MaxDistance].
+    /// Returns true if an intersection has been found. If several triangles are hit at the
+    /// same distance, the one with the smallest index is reported.
+    bool ClosestHit(const float3& RayOrigin,
+                    const float3& RayDirection,
+                    HitInfo&      Hit,
+                    float         MaxDistance  = FLT_MAX,
+                    bool          CullBackFace = false) const;
+
+    /// Returns true if the ray intersects any triangle at a distance in the range [0, MaxDistance].
+    /// The traversal stops at the first intersection found, which makes the query suitable for
+    /// visibility tests.
+    bool AnyHit(const float3& RayOrigin,
+                const float3& RayDirection,
+                float         MaxDistance  = FLT_MAX,
+                bool          CullBackFace = false) const;
+
+    /// Maximum number of rays traversed together by ClosestHitPacket()
+    static constexpr Uint32 MaxPacketSize = 64;
+
+    /// Finds the closest intersections for NumRays rays. The rays are traversed in packets of up to
+    /// MaxPacketSize rays that visit a node if any active ray intersects its bounding box, which
+    /// amortizes node fetches for coherent rays (e.g. primary or lightmap texel rays).
+    /// The results are identical to calling ClosestHit() for every ray.
+    void ClosestHitPacket(const float3* pRayOrigins,
+                          const float3* pRayDirections,
+                          Uint32        NumRays,
+                          HitInfo*      pHits,
+                          float         MaxDistance  = FLT_MAX,
+                          bool          CullBackFace = false) const;
+
+    const std::vector<Node>& GetNodes() const { return m_Nodes; }
+
+    Uint32 GetNumTriangles() const { return static_cast<Uint32>(m_TriangleIds.size()); }
+
+    /// Returns the bounding box of the whole mesh
+    BoundBox GetBoundBox() const
+    {
+        return !m_Nodes.empty() ? m_Nodes[0].GetBoundBox() : BoundBox{};
+    }
+
+    /// Returns the maximum depth of the hierarchy
+    Uint32 GetDepth() const { return m_Depth; }
+
+private:
+    struct Triangle
+    {
+        float3 V0, V1, V2;
+    };
+
+    // Maximum depth of the hierarchy that also defines the size of the traversal stack.
+    // Nodes at this depth are made leaves regardless of the number of triangles.
+    static constexpr Uint32 MaxDepth = 64;
+
+    struct BuildPrimitive;
+    class Builder;
+
+    bool IntersectLeaf(const Node&   Leaf,
+                       const float3& RayOrigin,
+                       const float3& RayDirection,
+                       bool          CullBackFace,
+                       bool          AnyHit,
+                       HitInfo&      Hit) const;
+
+    std::vector<Node>     m_Nodes;
+    std::vector<Triangle> m_Triangles;   // Triangles in leaf order
+    std::vector<Uint32>   m_TriangleIds; // Source mesh index of every triangle in m_Triangles
+    Uint32                m_Depth = 0;
+};
+
+} // namespace Diligent
@@ -0,0 +1,432 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+
+#include <algorithm>
+
+#include "OcclusionRasterizer.hpp"
+#include "Align.hpp"
+
+namespace Diligent
+{
+
+constexpr Uint32 OcclusionRasterizer::TileSize;
+constexpr Uint32 OcclusionRasterizer::HiZBlockSize;
+
+OcclusionRasterizer::OcclusionRasterizer(const CreateInfo& CI) :
+    // clang-format off
+    m_Width     {std::max(CI.Width,  1u)},
+    m_Height    {std::max(CI.Height, 1u)},
+    m_IsGL      {CI.IsGL},
+    m_Stride    {Align(m_Width, TileSize)},
+    m_NumTilesX {m_Stride / TileSize},
+    m_NumTilesY {Align(m_Height, TileSize) / TileSize},
+    m_Depth     (size_t{m_Stride} * m_NumTilesY * TileSize, 1.f),
+    m_TileBins  (size_t{m_NumTilesX} * m_NumTilesY)
+// clang-format on
+{
+    static_assert(TileSize % HiZBlockSize == 0, "Tile size must be a multiple of the HiZ block size");
+
+    auto Width  = m_Stride / HiZBlockSize;
+    auto Height = m_NumTilesY * TileSize / HiZBlockSize;
+    while (true)
+    {
+        HiZLevel Level;
+        Level.Width  = Width;
+        Level.Height = Height;
+        Level.Depth.resize(size_t{Width} * Height, 1.f);
+        m_HiZ.emplace_back(std::move(Level));
+        if (Width == 1 && Height == 1)
+            break;
+        Width  = (Width + 1) / 2;
+        Height = (Height + 1) / 2;
+    }
+}
+
+void OcclusionRasterizer::Clear()
+{
+    std::fill(m_Depth.begin(), m_Depth.end(), 1.f);
+    for (auto& Level : m_HiZ)
+        std::fill(Level.Depth.begin(), Level.Depth.end(), 1.f);
+
+    m_Triangles.clear();
+    for (auto& Bin : m_TileBins)
+        Bin.clear();
+}
+
+void OcclusionRasterizer::AddOccluder(const float3*   pVertices,
+                                      Uint32          NumVertices,
+                                      const Uint32*   pIndices,
+                                      Uint32          NumTriangles,
+                                      const float4x4& WorldViewProj,
+                                      bool            CullBackFaces)
+{
+    DEV_CHECK_ERR(pVertices != nullptr || NumVertices == 0, "Vertices must not be null");
+
+    // Transform all vertices to screen space. w is set to -1 for vertices in front of the near plane.
+    m_ScreenVerts.resize(NumVertices);
+    for (Uint32 v = 0; v < NumVertices; ++v)
+    {
+        const auto ClipPos = float4{pVertices[v], 1} * WorldViewProj;
+
+        auto& ScreenPos = m_ScreenVerts[v];
+        if (ClipPos.w <= 0)
+        {
+            ScreenPos.w = -1;
+            continue;
+        }
+
+        const auto NDC = float3{ClipPos.x, ClipPos.y, ClipPos.z} / ClipPos.w;
+
+        ScreenPos.x = (NDC.x * 0.5f + 0.5f) * static_cast<float>(m_Width) - 0.5f;
+        ScreenPos.y = (NDC.y * 0.5f + 0.5f) * static_cast<float>(m_Height) - 0.5f;
+        ScreenPos.z = m_IsGL ? NDC.z * 0.5f + 0.5f : NDC.z;
+        ScreenPos.w = ScreenPos.z < 0 ? -1.f : 1.f;
+    }
+
+    for (Uint32 tri = 0; tri < NumTriangles; ++tri)
+    {
+        Uint32 Idx[3];
+        for (Uint32 v = 0; v < 3; ++v)
+        {
+            Idx[v] = pIndices != nullptr ? pIndices[tri * 3 + v] : tri * 3 + v;
+            DEV_CHECK_ERR(Idx[v] < NumVertices, "Vertex index ", Idx[v], " is out of range");
+        }
+
+        const auto& V0 = m_ScreenVerts[Idx[0]];
+        const auto& V1 = m_ScreenVerts[Idx[1]];
+        const auto& V2 = m_ScreenVerts[Idx[2]];
+        if (V0.w < 0 || V1.w < 0 || V2.w < 0)
+            continue;
+
+        // Screen-space y axis points up, the same as in normalized device coordinates
+        if (CullBackFaces && (V1.x - V0.x) * (V2.y - V0.y) - (V2.x - V0.x) * (V1.y - V0.y) > 0)
+            continue;
+
+        AddScreenSpaceTriangle(float3{V0.x, V0.y, V0.z}, float3{V1.x, V1.y, V1.z}, float3{V2.x, V2.y, V2.z});
+    }
+}
+
+void OcclusionRasterizer::AddScreenSpaceTriangle(const float3& _V0, const float3& _V1, const float3& _V2)
+{
+    const float3* V[] = {&_V0, &_V1, &_V2};
+
+    auto Area = (V[1]->x - V[0]->x) * (V[2]->y - V[0]->y) - (V[2]->x - V[0]->x) * (V[1]->y - V[0]->y);
+    // Degenerate triangles do not occlude anything
+    if (!(std::abs(Area) > 0))
+        return;
+
+    // Make the triangle counter-clockwise so that edge functions are non-negative inside
+    if (Area < 0)
+    {
+        std::swap(V[1], V[2]);
+        Area = -Area;
+    }
+
+    ScreenTriangle Tri;
+
+    const auto MinXf = min3(V[0]->x, V[1]->x, V[2]->x);
+    const auto MinYf = min3(V[0]->y, V[1]->y, V[2]->y);
+    const auto MaxXf = max3(V[0]->x, V[1]->x, V[2]->x);
+    const auto MaxYf = max3(V[0]->y, V[1]->y, V[2]->y);
+    if (MaxXf < 0 || MaxYf < 0 || MinXf > static_cast<float>(m_Width - 1) || MinYf > static_cast<float>(m_Height - 1))
+        return;
+
+    // Clamp the coordinates before converting them to integers
+    Tri.MinX = static_cast<int>(FastCeil(std::max(MinXf, 0.f)));
+    Tri.MinY = static_cast<int>(FastCeil(std::max(MinYf, 0.f)));
+    Tri.MaxX = static_cast<int>(FastFloor(std::min(MaxXf, static_cast<float>(m_Width - 1))));
+    Tri.MaxY = static_cast<int>(FastFloor(std::min(MaxYf, static_cast<float>(m_Height - 1))));
+    if (Tri.MinX > Tri.MaxX || Tri.MinY > Tri.MaxY)
+        return;
+
+    for (int e = 0; e < 3; ++e)
+    {
+        const auto& a = *V[e];
+        const auto& b = *V[(e + 1) % 3];
+        // E(p) = (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x)
+        Tri.EdgeA[e] = a.y - b.y;
+        Tri.EdgeB[e] = b.x - a.x;
+        Tri.EdgeC[e] = a.x * b.y - a.y * b.x;
+    }
+
+    const auto& V0 = *V[0];
+    const auto& V1 = *V[1];
+    const auto& V2 = *V[2];
+
+    Tri.ZA   = ((V1.z - V0.z) * (V2.y - V0.y) - (V2.z - V0.z) * (V1.y - V0.y)) / Area;
+    Tri.ZB   = ((V2.z - V0.z) * (V1.x - V0.x) - (V1.z - V0.z) * (V2.x - V0.x)) / Area;
+    Tri.ZC   = V0.z - Tri.ZA * V0.x - Tri.ZB * V0.y;
+    Tri.MinZ = min3(V0.z, V1.z, V2.z);
+
+    const auto TriIdx = static_cast<Uint32>(m_Triangles.size());
+    m_Triangles.push_back(Tri);
+
+    for (Uint32 ty = static_cast<Uint32>(Tri.MinY) / TileSize; ty <= static_cast<Uint32>(Tri.MaxY) / TileSize; ++ty)
+    {
+        for (Uint32 tx = static_cast<Uint32>(Tri.MinX) / TileSize; tx <= static_cast<Uint32>(Tri.MaxX) / TileSize; ++tx)
+            m_TileBins[ty * m_NumTilesX + tx].push_back(TriIdx);
+    }
+}
+
+void OcclusionRasterizer::Rasterize()
+{
+    RasterizeTiles(0, GetNumTiles());
+    BuildHiZ();
+}
+
+void OcclusionRasterizer::RasterizeTiles(Uint32 FirstTile, Uint32 NumTiles)
+{
+    VERIFY(FirstTile + NumTiles <= GetNumTiles(), "Tile range [", FirstTile, ", ", FirstTile + NumTiles, ") is out of bounds");
+
+    for (Uint32 Tile = FirstTile; Tile < FirstTile + NumTiles; ++Tile)
+    {
+        const auto TileX = Tile % m_NumTilesX;
+        const auto TileY = Tile / m_NumTilesX;
+        RasterizeTile(TileX, TileY);
+        UpdateTileHiZ(TileX, TileY);
+    }
+}
+
+void OcclusionRasterizer::RasterizeTile(Uint32 TileX, Uint32 TileY)
+{
+    const auto& Bin = m_TileBins[TileY * m_NumTilesX + TileX];
+    if (Bin.empty())
+        return;
+
+    const int TileMinX = static_cast<int>(TileX * TileSize);
+    const int TileMinY = static_cast<int>(TileY * TileSize);
+    const int TileMaxX = TileMinX + static_cast<int>(TileSize) - 1;
+    const int TileMaxY = TileMinY + static_cast<int>(TileSize) - 1;
+
+    // Maximum depth in the tile is used to skip the triangles that are behind all samples in it.
+    // It is updated every TileMaxZUpdateInterval triangles.
+    static constexpr Uint32 TileMaxZUpdateInterval = 8;
+
+    float  TileMaxZ           = 1;
+    Uint32 NumTrisSinceUpdate = 0;
+
+    auto UpdateTileMaxZ = [&]() {
+        TileMaxZ = 0;
+        for (int y = TileMinY; y <= TileMaxY; ++y)
+        {
+            const auto* pRow = &m_Depth[size_t{static_cast<Uint32>(y)} * m_Stride + TileMinX];
+            for (Uint32 x = 0; x < TileSize; ++x)
+                TileMaxZ = std::max(TileMaxZ, pRow[x]);
+        }
+    };
+
+    for (auto TriIdx : Bin)
+    {
+        const auto& Tri = m_Triangles[TriIdx];
+        if (Tri.MinZ >= TileMaxZ)
+            continue;
+
+        const int MinX = std::max(Tri.MinX, TileMinX);
+        const int MinY = std::max(Tri.MinY, TileMinY);
+        const int MaxX = std::min(Tri.MaxX, TileMaxX);
+        const int MaxY = std::min(Tri.MaxY, TileMaxY);
+
+        for (int y = MinY; y <= MaxY; ++y)
+        {
+            float*      pRow = &m_Depth[size_t{static_cast<Uint32>(y)} * m_Stride];
+            const float fy   = static_cast<float>(y);
+
+            int x = MinX;
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+            // Process 4 samples at a time starting from the 4-aligned column. Tile size is a multiple
+            // of 4, so the groups never cross the tile boundary.
+            const auto Zero  = SIMD::Splat(0.f);
+            const auto MinXv = SIMD::Splat(static_cast<float>(MinX));
+            const auto MaxXv = SIMD::Splat(static_cast<float>(MaxX));
+
+            const float* EdgeA = Tri.EdgeA;
+            const float* EdgeB = Tri.EdgeB;
+            const float* EdgeC = Tri.EdgeC;
+
+            SIMD::Float4 RowEdge[3];
+            SIMD::Float4 StepEdge[3];
+            for (int e = 0; e < 3; ++e)
+            {
+                RowEdge[e]  = SIMD::Add(SIMD::Mul(SIMD::Splat(EdgeB[e]), SIMD::Splat(fy)), SIMD::Splat(EdgeC[e]));
+                StepEdge[e] = SIMD::Splat(EdgeA[e]);
+            }
+            const auto RowZ  = SIMD::Add(SIMD::Mul(SIMD::Splat(Tri.ZB), SIMD::Splat(fy)), SIMD::Splat(Tri.ZC));
+            const auto StepZ = SIMD::Splat(Tri.ZA);
+
+            for (x = MinX & ~3; x <= MaxX; x += 4)
+            {
+                const auto fx = SIMD::Set(static_cast<float>(x), static_cast<float>(x + 1), static_cast<float>(x + 2), static_cast<float>(x + 3));
+
+                // Edge values are computed the same way as in the scalar path: A * x + (B * y + C)
+                auto Covered = SIMD::And(SIMD::CmpLE(MinXv, fx), SIMD::CmpLE(fx, MaxXv));
+                for (int e = 0; e < 3; ++e)
+                    Covered = SIMD::And(Covered, SIMD::CmpLE(Zero, SIMD::Add(SIMD::Mul(StepEdge[e], fx), RowEdge[e])));
+                if (SIMD::MoveMask(Covered) == 0)
+                    continue;
+
+                const auto Z     = SIMD::Add(SIMD::Mul(StepZ, fx), RowZ);
+                const auto Depth = SIMD::Load(pRow + x);
+                SIMD::Store(pRow + x, SIMD::Select(Covered, SIMD::Min(Depth, Z), Depth));
+            }
+#else
+            for (; x <= MaxX; ++x)
+            {
+                const float fx = static_cast<float>(x);
+
+                bool Covered = true;
+                for (int e = 0; e < 3 && Covered; ++e)
+                    Covered = Tri.EdgeA[e] * fx + (Tri.EdgeB[e] * fy + Tri.EdgeC[e]) >= 0;
+                if (Covered)
+                    pRow[x] = std::min(pRow[x], Tri.ZA * fx + (Tri.ZB * fy + Tri.ZC));
+            }
+#endif
+        }
+
+        if (++NumTrisSinceUpdate == TileMaxZUpdateInterval)
+        {
+            UpdateTileMaxZ();
+            NumTrisSinceUpdate = 0;
+        }
+    }
+}
+
+void OcclusionRasterizer::UpdateTileHiZ(Uint32 TileX, Uint32 TileY)
+{
+    // Level 0: maximum depth of every HiZBlockSize x HiZBlockSize block of samples.
+    // The tile size is a multiple of the block size, so every block belongs to one tile.
+    // Padding samples outside of the screen are never written and keep the far depth,
+    // which is conservative.
+    static constexpr Uint32 BlocksPerTile = TileSize / HiZBlockSize;
+
+    auto& Level0 = m_HiZ[0];
+    for (Uint32 by = TileY * BlocksPerTile; by < (TileY + 1) * BlocksPerTile; ++by)
+    {
+        for (Uint32 bx = TileX * BlocksPerTile; bx < (TileX + 1) * BlocksPerTile; ++bx)
+        {
+            float MaxZ = 0;
+            for (Uint32 y = by * HiZBlockSize; y < (by + 1) * HiZBlockSize; ++y)
+            {
+                const auto* pRow = &m_Depth[size_t{y} * m_Stride + bx * HiZBlockSize];
+                for (Uint32 x = 0; x < HiZBlockSize; ++x)
+                    MaxZ = std::max(MaxZ, pRow[x]);
+            }
+            Level0.Depth[size_t{by} * Level0.Width + bx] = MaxZ;
+        }
+    }
+}
+
+void OcclusionRasterizer::BuildHiZ()
+{
+    for (size_t l = 1; l < m_HiZ.size(); ++l)
+    {
+        const auto& Src = m_HiZ[l - 1];
+        auto&       Dst = m_HiZ[l];
+        for (Uint32 y = 0; y < Dst.Height; ++y)
+        {
+            for (Uint32 x = 0; x < Dst.Width; ++x)
+            {
+                float MaxZ = 0;
+                for (Uint32 sy = y * 2; sy < std::min(y * 2 + 2, Src.Height); ++sy)
+                {
+                    for (Uint32 sx = x * 2; sx < std::min(x * 2 + 2, Src.Width); ++sx)
+                        MaxZ = std::max(MaxZ, Src.Depth[size_t{sy} * Src.Width + sx]);
+                }
+                Dst.Depth[size_t{y} * Dst.Width + x] = MaxZ;
+            }
+        }
+    }
+}
+
+bool OcclusionRasterizer::IsVisible(const BoundBox& Box, const float4x4& ViewProj) const
+{
+    float MinX = +FLT_MAX, MinY = +FLT_MAX, MinZ = +FLT_MAX;
+    float MaxX = -FLT_MAX, MaxY = -FLT_MAX;
+    for (Uint32 i = 0; i < 8; ++i)
+    {
+        const float3 Corner //
+            {
+                (i & 0x01) ? Box.Max.x : Box.Min.x,
+                (i & 0x02) ? Box.Max.y : Box.Min.y,
+                (i & 0x04) ? Box.Max.z : Box.Min.z //
+            };
+
+        const auto ClipPos = float4{Corner, 1} * ViewProj;
+        // The box crosses the near plane
+        if (ClipPos.w <= 0)
+            return true;
+
+        const auto NDC = float3{ClipPos.x, ClipPos.y, ClipPos.z} / ClipPos.w;
+
+        const auto x = (NDC.x * 0.5f + 0.5f) * static_cast<float>(m_Width) - 0.5f;
+        const auto y = (NDC.y * 0.5f + 0.5f) * static_cast<float>(m_Height) - 0.5f;
+        const auto z = m_IsGL ? NDC.z * 0.5f + 0.5f : NDC.z;
+
+        MinX = std::min(MinX, x);
+        MinY = std::min(MinY, y);
+        MaxX = std::max(MaxX, x);
+        MaxY = std::max(MaxY, y);
+        MinZ = std::min(MinZ, z);
+    }
+
+    if (MinZ <= 0)
+        return true;
+
+    // The box is outside of the screen or behind the far plane
+    if (MaxX < -1 || MaxY < -1 || MinX > static_cast<float>(m_Width) || MinY > static_cast<float>(m_Height) || MinZ > 1)
+        return false;
+
+    // Range of the samples that surround the box projection
+    const auto FirstX = static_cast<Uint32>(FastFloor(std::max(MinX, 0.f)));
+    const auto FirstY = static_cast<Uint32>(FastFloor(std::max(MinY, 0.f)));
+    const auto LastX  = static_cast<Uint32>(FastCeil(std::min(MaxX, static_cast<float>(m_Width - 1))));
+    const auto LastY  = static_cast<Uint32>(FastCeil(std::min(MaxY, static_cast<float>(m_Height - 1))));
+
+    // Select the HiZ level where the range covers at most 4x4 texels
+    Uint32 Level     = 0;
+    Uint32 TexelSize = HiZBlockSize;
+    while (Level + 1 < m_HiZ.size() && (LastX / TexelSize - FirstX / TexelSize >= 4 || LastY / TexelSize - FirstY / TexelSize >= 4))
+    {
+        ++Level;
+        TexelSize *= 2;
+    }
+
+    const auto& HiZ = m_HiZ[Level];
+    for (Uint32 y = FirstY / TexelSize; y <= LastY / TexelSize; ++y)
+    {
+        for (Uint32 x = FirstX / TexelSize; x <= LastX / TexelSize; ++x)
+        {
+            if (MinZ <= HiZ.Depth[size_t{y} * HiZ.Width + x])
+                return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace Diligent
@@ -0,0 +1,197 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+
+#include <cstdio>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include "PersistentCache.hpp"
+#include "HashUtils.hpp"
+#include "FileWrapper.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Header of the file that stores one entry. The header is followed by the key and the payload.
+struct PersistentFileHeader
+{
+    Uint32 Magic    = 0;
+    Uint32 Version  = 0;
+    Uint64 KeySize  = 0;
+    Uint64 DataSize = 0;
+};
+
+} // namespace
+
+PersistentFileStore::PersistentFileStore(Uint32 Magic, Uint32 Version, const Char* Extension, const Char* Name) :
+    // clang-format off
+    m_Magic    {Magic    },
+    m_Version  {Version  },
+    m_Extension{Extension},
+    m_Name     {Name     }
+// clang-format on
+{
+}
+
+bool PersistentFileStore::SetDirectory(const Char* Directory)
+{
+    String Dir{Directory != nullptr ? Directory : ""};
+    bool   Success = true;
+    if (!Dir.empty())
+    {
+        if (!FileSystem::PathExists(Dir.c_str()) && !FileSystem::CreateDirectory(Dir.c_str()))
+        {
+            LOG_ERROR_MESSAGE("Failed to create ", m_Name, " directory '", Dir, "'. On-disk cache will be disabled.");
+            Dir.clear();
+            Success = false;
+        }
+        else if (Dir.back() != '/' && Dir.back() != '\\')
+        {
+            Dir.push_back(FileSystem::GetSlashSymbol());
+        }
+    }
+
+    std::lock_guard<std::mutex> Lock{m_DirectoryMtx};
+    m_Directory = std::move(Dir);
+    return Success;
+}
+
+bool PersistentFileStore::IsEnabled() const
+{
+    std::lock_guard<std::mutex> Lock{m_DirectoryMtx};
+    return !m_Directory.empty();
+}
+
+String PersistentFileStore::GetFilePath(const void* pKey, size_t KeySize) const
+{
+    // Two differently seeded hashes make name collisions of different keys practically impossible.
+    // Collisions are nevertheless detected by comparing the key stored in the file.
+    Char FileName[64];
+    snprintf(FileName, sizeof(FileName), "%016llx%016llx.%s",
+             static_cast<unsigned long long>(ComputeFNVHash(pKey, KeySize)),
+             static_cast<unsigned long long>(ComputeFNVHash(pKey, KeySize, 0x9ae16a3b2f90404full)),
+             m_Extension.c_str());
+
+    std::lock_guard<std::mutex> Lock{m_DirectoryMtx};
+    return m_Directory + FileName;
+}
+
+bool PersistentFileStore::Load(const void* pKey, size_t KeySize, std::vector<Uint8>& Data) const
+{
+    const auto FilePath = GetFilePath(pKey, KeySize);
+    if (!FileSystem::FileExists(FilePath.c_str()))
+        return false;
+
+    FileWrapper File{FilePath.c_str(), EFileAccessMode::Read};
+    if (!File)
+        return false;
+
+    const auto FileSize = File->GetSize();
+
+    PersistentFileHeader Header;
+    if (FileSize < sizeof(Header) || !File->Read(&Header, sizeof(Header)))
+        return false;
+
+    // clang-format off
+    if (Header.Magic    != m_Magic   ||
+        Header.Version  != m_Version ||
+        Header.KeySize  != KeySize   ||
+        Header.DataSize != FileSize - sizeof(Header) - KeySize)
+    {
+        // The file was written by a different version of the store or has been truncated
+        return false;
+    }
+    // clang-format on
+
+    std::vector<Uint8> FileKey(KeySize);
+    if (!File->Read(FileKey.data(), KeySize) || memcmp(FileKey.data(), pKey, KeySize) != 0)
+        return false;
+
+    std::vector<Uint8> FileData(static_cast<size_t>(Header.DataSize));
+    if (!FileData.empty() && !File->Read(FileData.data(), FileData.size()))
+        return false;
+
+    Data = std::move(FileData);
+    return true;
+}
+
+bool PersistentFileStore::Store(const void* pKey, size_t KeySize, const void* pData, size_t DataSize) const
+{
+    const auto FilePath = GetFilePath(pKey, KeySize);
+
+    // The entry is written to a temporary file that is then renamed. The name of the temporary
+    // file must be unique among all threads and processes that share the directory.
+    const auto ThreadHash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    const auto Time       = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+
+    Char Suffix[64];
+    snprintf(Suffix, sizeof(Suffix), ".%llx%llx.tmp",
+             static_cast<unsigned long long>(ThreadHash),
+             static_cast<unsigned long long>(Time));
+    const auto TmpFilePath = FilePath + Suffix;
+
+    {
+        FileWrapper File{TmpFilePath.c_str(), EFileAccessMode::Overwrite};
+        if (!File)
+        {
+            LOG_WARNING_MESSAGE("Failed to open file '", TmpFilePath, "' to store ", m_Name, " entry");
+            return false;
+        }
+
+        PersistentFileHeader Header;
+        Header.Magic    = m_Magic;
+        Header.Version  = m_Version;
+        Header.KeySize  = KeySize;
+        Header.DataSize = DataSize;
+        if (!File->Write(&Header, sizeof(Header)) ||
+            !File->Write(pKey, KeySize) ||
+            (DataSize != 0 && !File->Write(pData, DataSize)))
+        {
+            LOG_WARNING_MESSAGE("Failed to write ", m_Name, " entry to file '", TmpFilePath, "'");
+            File.Close();
+            FileSystem::DeleteFile(TmpFilePath.c_str());
+            return false;
+        }
+    }
+
+    if (std::rename(TmpFilePath.c_str(), FilePath.c_str()) != 0)
+    {
+        // On Windows, rename fails if the file exists, which means that the same
+        // entry has already been stored by another thread or process.
+        FileSystem::DeleteFile(TmpFilePath.c_str());
+    }
+
+    return true;
+}
+
+} // namespace Diligent
@@ -0,0 +1,438 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+
+#include <algorithm>
+
+#include "TransformHierarchy.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+float4x4 ComposeTransform(const TransformBatch& Transforms, Uint32 i)
+{
+    const Quaternion Rotation{Transforms.RotationX[i], Transforms.RotationY[i], Transforms.RotationZ[i], Transforms.RotationW[i]};
+    const float      Scale[] = {Transforms.ScaleX[i], Transforms.ScaleY[i], Transforms.ScaleZ[i]};
+
+    // Scale(S) * R * Translation(T) scales the rows of R and sets the translation row
+    auto Matrix = Rotation.ToMatrix();
+    for (int r = 0; r < 3; ++r)
+    {
+        for (int c = 0; c < 3; ++c)
+            Matrix[r][c] *= Scale[r];
+    }
+    Matrix[3][0] = Transforms.TranslationX[i];
+    Matrix[3][1] = Transforms.TranslationY[i];
+    Matrix[3][2] = Transforms.TranslationZ[i];
+    return Matrix;
+}
+
+float4x4 InvertAffineTransform(const float4x4& M)
+{
+    // Cofactors of the first row
+    const float c00 = M[1][1] * M[2][2] - M[1][2] * M[2][1];
+    const float c01 = M[1][2] * M[2][0] - M[1][0] * M[2][2];
+    const float c02 = M[1][0] * M[2][1] - M[1][1] * M[2][0];
+
+    const float InvDet = 1.f / (M[0][0] * c00 + M[0][1] * c01 + M[0][2] * c02);
+
+    float4x4 Inv;
+    Inv[0][0] = c00 * InvDet;
+    Inv[0][1] = (M[0][2] * M[2][1] - M[0][1] * M[2][2]) * InvDet;
+    Inv[0][2] = (M[0][1] * M[1][2] - M[0][2] * M[1][1]) * InvDet;
+    Inv[1][0] = c01 * InvDet;
+    Inv[1][1] = (M[0][0] * M[2][2] - M[0][2] * M[2][0]) * InvDet;
+    Inv[1][2] = (M[0][2] * M[1][0] - M[0][0] * M[1][2]) * InvDet;
+    Inv[2][0] = c02 * InvDet;
+    Inv[2][1] = (M[0][1] * M[2][0] - M[0][0] * M[2][1]) * InvDet;
+    Inv[2][2] = (M[0][0] * M[1][1] - M[0][1] * M[1][0]) * InvDet;
+    for (int c = 0; c < 3; ++c)
+    {
+        Inv[3][c] = -(M[3][0] * Inv[0][c] + M[3][1] * Inv[1][c] + M[3][2] * Inv[2][c]);
+        Inv[c][3] = 0;
+    }
+    Inv[3][3] = 1;
+    return Inv;
+}
+
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+
+// Every vector holds one component of 4 transforms. The expressions are the same as in
+// ComposeTransform(), so that both functions produce the same results.
+void ComposeTransforms4(const SIMD::Float4 T[3], const SIMD::Float4 R[4], const SIMD::Float4 S[3], float4x4* pMatrices)
+{
+    const auto Zero = SIMD::Splat(0.f);
+    const auto One  = SIMD::Splat(1.f);
+    const auto Two  = SIMD::Splat(2.f);
+
+    // See Quaternion::ToMatrix()
+    const auto yy2 = SIMD::Mul(SIMD::Mul(Two, R[1]), R[1]);
+    const auto xy2 = SIMD::Mul(SIMD::Mul(Two, R[0]), R[1]);
+    const auto xz2 = SIMD::Mul(SIMD::Mul(Two, R[0]), R[2]);
+    const auto yz2 = SIMD::Mul(SIMD::Mul(Two, R[1]), R[2]);
+    const auto zz2 = SIMD::Mul(SIMD::Mul(Two, R[2]), R[2]);
+    const auto wz2 = SIMD::Mul(SIMD::Mul(Two, R[3]), R[2]);
+    const auto wy2 = SIMD::Mul(SIMD::Mul(Two, R[3]), R[1]);
+    const auto wx2 = SIMD::Mul(SIMD::Mul(Two, R[3]), R[0]);
+    const auto xx2 = SIMD::Mul(SIMD::Mul(Two, R[0]), R[0]);
+
+    // clang-format off
+    SIMD::Float4 Rows[4][4] =
+    {
+        {SIMD::Add(SIMD::Sub(SIMD::Sub(Zero, yy2), zz2), One), SIMD::Add(xy2, wz2), SIMD::Sub(xz2, wy2), Zero},
+        {SIMD::Sub(xy2, wz2), SIMD::Add(SIMD::Sub(SIMD::Sub(Zero, xx2), zz2), One), SIMD::Add(yz2, wx2), Zero},
+        {SIMD::Add(xz2, wy2), SIMD::Sub(yz2, wx2), SIMD::Add(SIMD::Sub(SIMD::Sub(Zero, xx2), yy2), One), Zero},
+        {T[0], T[1], T[2], One}
+    };
+    // clang-format on
+
+    for (int r = 0; r < 3; ++r)
+    {
+        for (int c = 0; c < 3; ++c)
+            Rows[r][c] = SIMD::Mul(Rows[r][c], S[r]);
+    }
+
+    for (int r = 0; r < 4; ++r)
+    {
+        // After the transpose, Rows[r][i] is the row r of the matrix i
+        SIMD::Transpose(Rows[r][0], Rows[r][1], Rows[r][2], Rows[r][3]);
+        for (int i = 0; i < 4; ++i)
+            SIMD::Store(pMatrices[i][r], Rows[r][i]);
+    }
+}
+
+// Inverts 4 affine matrices. The expressions are the same as in InvertAffineTransform().
+void InvertAffineTransforms4(const float4x4* pMatrices, float4x4* pInverse)
+{
+    // M[r][c] holds the element (r, c) of the 4 matrices
+    SIMD::Float4 M[4][4];
+    for (int r = 0; r < 4; ++r)
+    {
+        for (int i = 0; i < 4; ++i)
+            M[r][i] = SIMD::Load(pMatrices[i][r]);
+        SIMD::Transpose(M[r][0], M[r][1], M[r][2], M[r][3]);
+    }
+
+    auto MulSub = [](SIMD::Float4 a, SIMD::Float4 b, SIMD::Float4 c, SIMD::Float4 d) {
+        return SIMD::Sub(SIMD::Mul(a, b), SIMD::Mul(c, d));
+    };
+
+    const auto c00 = MulSub(M[1][1], M[2][2], M[1][2], M[2][1]);
+    const auto c01 = MulSub(M[1][2], M[2][0], M[1][0], M[2][2]);
+    const auto c02 = MulSub(M[1][0], M[2][1], M[1][1], M[2][0]);
+
+    auto Det = SIMD::Mul(M[0][0], c00);
+    Det      = SIMD::Add(Det, SIMD::Mul(M[0][1], c01));
+    Det      = SIMD::Add(Det, SIMD::Mul(M[0][2], c02));
+
+    const auto InvDet = SIMD::Div(SIMD::Splat(1.f), Det);
+    const auto Zero   = SIMD::Splat(0.f);
+
+    SIMD::Float4 Inv[4][4];
+    Inv[0][0] = SIMD::Mul(c00, InvDet);
+    Inv[0][1] = SIMD::Mul(MulSub(M[0][2], M[2][1], M[0][1], M[2][2]), InvDet);
+    Inv[0][2] = SIMD::Mul(MulSub(M[0][1], M[1][2], M[0][2], M[1][1]), InvDet);
+    Inv[1][0] = SIMD::Mul(c01, InvDet);
+    Inv[1][1] = SIMD::Mul(MulSub(M[0][0], M[2][2], M[0][2], M[2][0]), InvDet);
+    Inv[1][2] = SIMD::Mul(MulSub(M[0][2], M[1][0], M[0][0], M[1][2]), InvDet);
+    Inv[2][0] = SIMD::Mul(c02, InvDet);
+    Inv[2][1] = SIMD::Mul(MulSub(M[0][1], M[2][0], M[0][0], M[2][1]), InvDet);
+    Inv[2][2] = SIMD::Mul(MulSub(M[0][0], M[1][1], M[0][1], M[1][0]), InvDet);
+    for (int c = 0; c < 3; ++c)
+    {
+        auto t    = SIMD::Mul(M[3][0], Inv[0][c]);
+        t         = SIMD::Add(t, SIMD::Mul(M[3][1], Inv[1][c]));
+        t         = SIMD::Add(t, SIMD::Mul(M[3][2], Inv[2][c]));
+        Inv[3][c] = SIMD::Sub(Zero, t);
+        Inv[c][3] = Zero;
+    }
+    Inv[3][3] = SIMD::Splat(1.f);
+
+    for (int r = 0; r < 4; ++r)
+    {
+        SIMD::Transpose(Inv[r][0], Inv[r][1], Inv[r][2], Inv[r][3]);
+        for (int i = 0; i < 4; ++i)
+            SIMD::Store(pInverse[i][r], Inv[r][i]);
+    }
+}
+
+#endif
+
+} // namespace
+
+void ComposeTransforms(const TransformBatch& Transforms,
+                       Uint32                FirstTransform,
+                       Uint32                NumTransforms,
+                       float4x4*             pMatrices)
+{
+    VERIFY(FirstTransform + NumTransforms <= Transforms.NumTransforms, "Transform range [", FirstTransform, ", ",
+           FirstTransform + NumTransforms, ") is out of bounds");
+
+    Uint32 i = 0;
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+    for (; i + 4 <= NumTransforms; i += 4)
+    {
+        const auto idx = FirstTransform + i;
+
+        // clang-format off
+        const SIMD::Float4 T[] = {SIMD::Load(Transforms.TranslationX + idx), SIMD::Load(Transforms.TranslationY + idx), SIMD::Load(Transforms.TranslationZ + idx)};
+        const SIMD::Float4 R[] = {SIMD::Load(Transforms.RotationX    + idx), SIMD::Load(Transforms.RotationY    + idx), SIMD::Load(Transforms.RotationZ    + idx), SIMD::Load(Transforms.RotationW + idx)};
+        const SIMD::Float4 S[] = {SIMD::Load(Transforms.ScaleX       + idx), SIMD::Load(Transforms.ScaleY       + idx), SIMD::Load(Transforms.ScaleZ       + idx)};
+        // clang-format on
+        ComposeTransforms4(T, R, S, pMatrices + i);
+    }
+#endif
+    for (; i < NumTransforms; ++i)
+        pMatrices[i] = ComposeTransform(Transforms, FirstTransform + i);
+}
+
+void MultiplyTransforms(const float4x4* pA,
+                        const float4x4* pB,
+                        float4x4*       pOut,
+                        Uint32          Count)
+{
+    for (Uint32 i = 0; i < Count; ++i)
+        pOut[i] = pA[i] * pB[i];
+}
+
+void MultiplyTransforms(const float4x4* pA,
+                        const float4x4& B,
+                        float4x4*       pOut,
+                        Uint32          Count)
+{
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+    // Rows of B are only loaded once
+    const SIMD::Float4 Rows[] = {SIMD::Load(B[0]), SIMD::Load(B[1]), SIMD::Load(B[2]), SIMD::Load(B[3])};
+    for (Uint32 i = 0; i < Count; ++i)
+    {
+        for (int r = 0; r < 4; ++r)
+            SIMD::Store(pOut[i][r], SIMD::MulVectorMatrix(SIMD::Load(pA[i][r]), Rows));
+    }
+#else
+    // B may reference one of the output matrices
+    const float4x4 MatB = B;
+    for (Uint32 i = 0; i < Count; ++i)
+        pOut[i] = pA[i] * MatB;
+#endif
+}
+
+void InvertAffineTransforms(const float4x4* pMatrices,
+                            float4x4*       pInverse,
+                            Uint32          Count)
+{
+    Uint32 i = 0;
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+    for (; i + 4 <= Count; i += 4)
+        InvertAffineTransforms4(pMatrices + i, pInverse + i);
+#endif
+    for (; i < Count; ++i)
+        pInverse[i] = InvertAffineTransform(pMatrices[i]);
+}
+
+
+constexpr Uint32 TransformHierarchy::InvalidNode;
+
+Uint32 TransformHierarchy::AddNode(Uint32            Parent,
+                                   const float3&     Translation,
+                                   const Quaternion& Rotation,
+                                   const float3&     Scale)
+{
+    const auto Node = GetNumNodes();
+    VERIFY(Parent == InvalidNode || Parent < Node, "Parent node ", Parent, " does not exist");
+
+    for (auto& Attrib : m_Local)
+        Attrib.emplace_back();
+    m_Parents.emplace_back(Parent);
+    m_Depths.emplace_back(Parent != InvalidNode ? m_Depths[Parent] + 1 : 0);
+    m_NumLevels   = std::max(m_NumLevels, m_Depths.back() + 1);
+    m_LevelsDirty = true;
+
+    SetTranslation(Node, Translation);
+    SetRotation(Node, Rotation);
+    SetScale(Node, Scale);
+
+    return Node;
+}
+
+void TransformHierarchy::Clear()
+{
+    for (auto& Attrib : m_Local)
+        Attrib.clear();
+    m_Parents.clear();
+    m_Depths.clear();
+    m_NumLevels = 0;
+    m_LocalMatrices.clear();
+    m_WorldMatrices.clear();
+    m_LevelsDirty = true;
+}
+
+void TransformHierarchy::Reserve(Uint32 NumNodes)
+{
+    for (auto& Attrib : m_Local)
+        Attrib.reserve(NumNodes);
+    m_Parents.reserve(NumNodes);
+    m_Depths.reserve(NumNodes);
+    m_LocalMatrices.reserve(NumNodes);
+    m_WorldMatrices.reserve(NumNodes);
+}
+
+void TransformHierarchy::SetTranslation(Uint32 Node, const float3& Translation)
+{
+    VERIFY_EXPR(Node < GetNumNodes());
+    m_Local[TRANSLATION_X][Node] = Translation.x;
+    m_Local[TRANSLATION_Y][Node] = Translation.y;
+    m_Local[TRANSLATION_Z][Node] = Translation.z;
+}
+
+void TransformHierarchy::SetRotation(Uint32 Node, const Quaternion& Rotation)
+{
+    VERIFY_EXPR(Node < GetNumNodes());
+    m_Local[ROTATION_X][Node] = Rotation.q.x;
+    m_Local[ROTATION_Y][Node] = Rotation.q.y;
+    m_Local[ROTATION_Z][Node] = Rotation.q.z;
+    m_Local[ROTATION_W][Node] = Rotation.q.w;
+}
+
+void TransformHierarchy::SetScale(Uint32 Node, const float3& Scale)
+{
+    VERIFY_EXPR(Node < GetNumNodes());
+    m_Local[SCALE_X][Node] = Scale.x;
+    m_Local[SCALE_Y][Node] = Scale.y;
+    m_Local[SCALE_Z][Node] = Scale.z;
+}
+
+float3 TransformHierarchy::GetTranslation(Uint32 Node) const
+{
+    VERIFY_EXPR(Node < GetNumNodes());
+    return float3{m_Local[TRANSLATION_X][Node], m_Local[TRANSLATION_Y][Node], m_Local[TRANSLATION_Z][Node]};
+}
+
+Quaternion TransformHierarchy::GetRotation(Uint32 Node) const
+{
+    VERIFY_EXPR(Node < GetNumNodes());
+    return Quaternion{m_Local[ROTATION_X][Node], m_Local[ROTATION_Y][Node], m_Local[ROTATION_Z][Node], m_Local[ROTATION_W][Node]};
+}
+
+float3 TransformHierarchy::GetScale(Uint32 Node) const
+{
+    VERIFY_EXPR(Node < GetNumNodes());
+    return float3{m_Local[SCALE_X][Node], m_Local[SCALE_Y][Node], m_Local[SCALE_Z][Node]};
+}
+
+TransformBatch TransformHierarchy::GetLocalTransforms() const
+{
+    TransformBatch Batch;
+    Batch.TranslationX  = m_Local[TRANSLATION_X].data();
+    Batch.TranslationY  = m_Local[TRANSLATION_Y].data();
+    Batch.TranslationZ  = m_Local[TRANSLATION_Z].data();
+    Batch.RotationX     = m_Local[ROTATION_X].data();
+    Batch.RotationY     = m_Local[ROTATION_Y].data();
+    Batch.RotationZ     = m_Local[ROTATION_Z].data();
+    Batch.RotationW     = m_Local[ROTATION_W].data();
+    Batch.ScaleX        = m_Local[SCALE_X].data();
+    Batch.ScaleY        = m_Local[SCALE_Y].data();
+    Batch.ScaleZ        = m_Local[SCALE_Z].data();
+    Batch.NumTransforms = GetNumNodes();
+    return Batch;
+}
+
+void TransformHierarchy::UpdateLevels()
+{
+    if (!m_LevelsDirty)
+        return;
+
+    const auto NumNodes = GetNumNodes();
+
+    // Counting sort keeps the nodes of every level in index order
+    m_LevelStart.assign(m_NumLevels + 1, 0);
+    for (auto Depth : m_Depths)
+        ++m_LevelStart[Depth + 1];
+    for (Uint32 Level = 0; Level < m_NumLevels; ++Level)
+        m_LevelStart[Level + 1] += m_LevelStart[Level];
+
+    m_LevelNodes.resize(NumNodes);
+    std::vector<Uint32> Offsets{m_LevelStart.begin(), m_LevelStart.end() - 1};
+    for (Uint32 Node = 0; Node < NumNodes; ++Node)
+        m_LevelNodes[Offsets[m_Depths[Node]]++] = Node;
+
+    m_LevelsDirty = false;
+}
+
+void TransformHierarchy::Update()
+{
+    const auto NumNodes = GetNumNodes();
+    m_LocalMatrices.resize(NumNodes);
+    m_WorldMatrices.resize(NumNodes);
+    if (NumNodes == 0)
+        return;
+
+    ComposeTransforms(GetLocalTransforms(), 0, NumNodes, m_LocalMatrices.data());
+    // Parents are always processed before their children
+    for (Uint32 Node = 0; Node < NumNodes; ++Node)
+    {
+        const auto Parent     = m_Parents[Node];
+        m_WorldMatrices[Node] = Parent != InvalidNode ? m_LocalMatrices[Node] * m_WorldMatrices[Parent] : m_LocalMatrices[Node];
+    }
+}
+
+void TransformHierarchy::BeginUpdate()
+{
+    const auto NumNodes = GetNumNodes();
+    m_LocalMatrices.resize(NumNodes);
+    m_WorldMatrices.resize(NumNodes);
+    UpdateLevels();
+}
+
+void TransformHierarchy::ComposeLocalMatrices(Uint32 FirstNode, Uint32 NumNodes)
+{
+    VERIFY(m_LocalMatrices.size() == GetNumNodes(), "BeginUpdate() must be called after the nodes have been added");
+    VERIFY(FirstNode + NumNodes <= GetNumNodes(), "Node range [", FirstNode, ", ", FirstNode + NumNodes, ") is out of bounds");
+    if (NumNodes == 0)
+        return;
+
+    ComposeTransforms(GetLocalTransforms(), FirstNode, NumNodes, &m_LocalMatrices[FirstNode]);
+}
+
+void TransformHierarchy::UpdateWorldMatrices(Uint32 Level, Uint32 FirstNode, Uint32 NumNodes)
+{
+    VERIFY(!m_LevelsDirty && m_WorldMatrices.size() == GetNumNodes(), "BeginUpdate() must be called after the nodes have been added");
+    VERIFY(FirstNode + NumNodes <= GetLevelSize(Level), "Node range [", FirstNode, ", ", FirstNode + NumNodes, ") is out of bounds of level ", Level);
+
+    const auto Start = m_LevelStart[Level] + FirstNode;
+    for (auto i = Start; i < Start + NumNodes; ++i)
+    {
+        const auto Node       = m_LevelNodes[i];
+        const auto Parent     = m_Parents[Node];
+        m_WorldMatrices[Node] = Parent != InvalidNode ? m_LocalMatrices[Node] * m_WorldMatrices[Parent] : m_LocalMatrices[Node];
+    }
+}
+
+} // namespace Diligent
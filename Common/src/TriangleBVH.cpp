@@ -0,0 +1,564 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+
+#include <algorithm>
+#include <future>
+
+#include "TriangleBVH.hpp"
+#include "PlatformMisc.hpp"
+
+namespace Diligent
+{
+
+constexpr Uint32 TriangleBVH::InvalidTriangleIndex;
+constexpr Uint32 TriangleBVH::MaxPacketSize;
+constexpr Uint32 TriangleBVH::MaxDepth;
+
+struct TriangleBVH::BuildPrimitive
+{
+    BoundBox BB;
+    float3   Centroid;
+};
+
+namespace
+{
+
+BoundBox GetEmptyBoundBox()
+{
+    return BoundBox{float3{+FLT_MAX, +FLT_MAX, +FLT_MAX}, float3{-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+}
+
+void GrowBoundBox(BoundBox& BB, const BoundBox& Other)
+{
+    BB.Min = std::min(BB.Min, Other.Min);
+    BB.Max = std::max(BB.Max, Other.Max);
+}
+
+// Half of the box surface area
+float GetHalfArea(const BoundBox& BB)
+{
+    const auto d = BB.Max - BB.Min;
+    return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+} // namespace
+
+class TriangleBVH::Builder
+{
+public:
+    Builder(const CreateInfo&                  CI,
+            const std::vector<BuildPrimitive>& Prims,
+            std::vector<Uint32>&               PrimIds) :
+        m_MaxTrianglesPerLeaf{std::max(CI.MaxTrianglesPerLeaf, 1u)},
+        m_NumBins{std::max(CI.NumSAHBins, 2u)},
+        m_Prims{Prims},
+        m_PrimIds{PrimIds}
+    {}
+
+    // Builds the subtree for primitives [Begin, End) and appends its nodes to Nodes.
+    // Right child indices are relative to the start of Nodes. Returns the depth of the subtree.
+    Uint32 Build(Uint32 Begin, Uint32 End, std::vector<Node>& Nodes, Uint32 Depth, Uint32 NumThreads) const
+    {
+        VERIFY_EXPR(Begin < End);
+
+        const auto NodeIdx = static_cast<Uint32>(Nodes.size());
+        Nodes.emplace_back();
+
+        auto NodeBB     = GetEmptyBoundBox();
+        auto CentroidBB = GetEmptyBoundBox();
+        for (Uint32 i = Begin; i < End; ++i)
+        {
+            const auto& Prim = m_Prims[m_PrimIds[i]];
+            GrowBoundBox(NodeBB, Prim.BB);
+            GrowBoundBox(CentroidBB, BoundBox{Prim.Centroid, Prim.Centroid});
+        }
+        Nodes[NodeIdx].Min = NodeBB.Min;
+        Nodes[NodeIdx].Max = NodeBB.Max;
+
+        const auto NumPrims = End - Begin;
+
+        auto MakeLeaf = [&]() {
+            Nodes[NodeIdx].RightChildOrFirstTriangle = Begin;
+            Nodes[NodeIdx].NumTriangles              = NumPrims;
+            return Depth;
+        };
+
+        if (NumPrims == 1 || Depth + 1 >= MaxDepth)
+            return MakeLeaf();
+
+        int    SplitAxis = -1;
+        Uint32 SplitBin  = 0;
+        float  SplitCost = FLT_MAX;
+        FindSAHSplit(Begin, End, CentroidBB, SplitAxis, SplitBin, SplitCost);
+
+        // Costs are measured in ray-triangle tests scaled by the node half area; the cost of the
+        // ray-box test of the children is taken to be equal to one ray-triangle test.
+        const auto LeafCost = static_cast<float>(NumPrims) * GetHalfArea(NodeBB);
+        if (NumPrims <= m_MaxTrianglesPerLeaf && (SplitAxis < 0 || SplitCost + GetHalfArea(NodeBB) >= LeafCost))
+            return MakeLeaf();
+
+        Uint32 Mid = Begin + NumPrims / 2;
+        if (SplitAxis >= 0)
+        {
+            const auto Scale = static_cast<float>(m_NumBins) / (CentroidBB.Max[SplitAxis] - CentroidBB.Min[SplitAxis]);
+
+            const auto IsLeft = [&](Uint32 PrimId) {
+                return GetBin(m_Prims[PrimId].Centroid[SplitAxis], CentroidBB.Min[SplitAxis], Scale) <= SplitBin;
+            };
+            const auto MidIt = std::partition(m_PrimIds.begin() + Begin, m_PrimIds.begin() + End, IsLeft);
+
+            Mid = static_cast<Uint32>(MidIt - m_PrimIds.begin());
+        }
+        // All centroids coincide or the split degenerated because of rounding: split in the middle
+        if (Mid == Begin || Mid == End)
+            Mid = Begin + NumPrims / 2;
+
+        Uint32 LeftDepth  = 0;
+        Uint32 RightDepth = 0;
+        if (NumThreads > 1 && NumPrims >= MinParallelBuildPrims)
+        {
+            std::vector<Node> RightNodes;
+
+            auto RightTask = std::async(std::launch::async, [&]() {
+                return Build(Mid, End, RightNodes, Depth + 1, NumThreads / 2);
+            });
+
+            LeftDepth  = Build(Begin, Mid, Nodes, Depth + 1, NumThreads - NumThreads / 2);
+            RightDepth = RightTask.get();
+
+            const auto RightOffset = static_cast<Uint32>(Nodes.size());
+            for (auto& RightNode : RightNodes)
+            {
+                if (!RightNode.IsLeaf())
+                    RightNode.RightChildOrFirstTriangle += RightOffset;
+            }
+            Nodes.insert(Nodes.end(), RightNodes.begin(), RightNodes.end());
+            Nodes[NodeIdx].RightChildOrFirstTriangle = RightOffset;
+        }
+        else
+        {
+            LeftDepth = Build(Begin, Mid, Nodes, Depth + 1, 1);
+
+            Nodes[NodeIdx].RightChildOrFirstTriangle = static_cast<Uint32>(Nodes.size());
+
+            RightDepth = Build(Mid, End, Nodes, Depth + 1, 1);
+        }
+
+        return std::max(LeftDepth, RightDepth);
+    }
+
+private:
+    Uint32 GetBin(float Coord, float Min, float Scale) const
+    {
+        const auto Bin = static_cast<Uint32>(std::max((Coord - Min) * Scale, 0.f));
+        return std::min(Bin, m_NumBins - 1);
+    }
+
+    // Finds the bin boundary with the lowest SAH cost. The primitives whose centroid falls into
+    // bins [0, SplitBin] go to the left child. SplitAxis is -1 if no split has been found.
+    void FindSAHSplit(Uint32 Begin, Uint32 End, const BoundBox& CentroidBB, int& SplitAxis, Uint32& SplitBin, float& SplitCost) const
+    {
+        struct Bin
+        {
+            BoundBox BB    = GetEmptyBoundBox();
+            Uint32   Count = 0;
+        };
+        std::vector<Bin>   Bins(m_NumBins);
+        std::vector<float> RightCost(m_NumBins);
+
+        for (int Axis = 0; Axis < 3; ++Axis)
+        {
+            const auto Extent = CentroidBB.Max[Axis] - CentroidBB.Min[Axis];
+            if (!(Extent > 0))
+                continue;
+
+            const auto Scale = static_cast<float>(m_NumBins) / Extent;
+
+            std::fill(Bins.begin(), Bins.end(), Bin{});
+            for (Uint32 i = Begin; i < End; ++i)
+            {
+                const auto& Prim = m_Prims[m_PrimIds[i]];
+
+                auto& CurrBin = Bins[GetBin(Prim.Centroid[Axis], CentroidBB.Min[Axis], Scale)];
+                GrowBoundBox(CurrBin.BB, Prim.BB);
+                ++CurrBin.Count;
+            }
+
+            // RightCost[b] is the cost of bins [b + 1, NumBins)
+            auto   RightBB    = GetEmptyBoundBox();
+            Uint32 RightCount = 0;
+            for (Uint32 b = m_NumBins - 1; b > 0; --b)
+            {
+                GrowBoundBox(RightBB, Bins[b].BB);
+                RightCount += Bins[b].Count;
+                RightCost[b - 1] = RightCount > 0 ? GetHalfArea(RightBB) * static_cast<float>(RightCount) : 0;
+            }
+
+            auto   LeftBB    = GetEmptyBoundBox();
+            Uint32 LeftCount = 0;
+            for (Uint32 b = 0; b + 1 < m_NumBins; ++b)
+            {
+                GrowBoundBox(LeftBB, Bins[b].BB);
+                LeftCount += Bins[b].Count;
+                if (LeftCount == 0 || LeftCount == End - Begin)
+                    continue;
+
+                const auto Cost = GetHalfArea(LeftBB) * static_cast<float>(LeftCount) + RightCost[b];
+                if (Cost < SplitCost)
+                {
+                    SplitCost = Cost;
+                    SplitAxis = Axis;
+                    SplitBin  = b;
+                }
+            }
+        }
+    }
+
+    // Minimum number of primitives in a node to build its children in parallel
+    static constexpr Uint32 MinParallelBuildPrims = 4096;
+
+    const Uint32 m_MaxTrianglesPerLeaf;
+    const Uint32 m_NumBins;
+
+    const std::vector<BuildPrimitive>& m_Prims;
+    std::vector<Uint32>&               m_PrimIds;
+};
+
+TriangleBVH::TriangleBVH(const CreateInfo& CI)
+{
+    if (CI.NumTriangles == 0)
+        return;
+
+    DEV_CHECK_ERR(CI.pVertices != nullptr, "Vertices must not be null");
+    DEV_CHECK_ERR(CI.pIndices != nullptr || CI.NumTriangles * 3 <= CI.NumVertices,
+                  "The number of vertices (", CI.NumVertices, ") is not enough for ", CI.NumTriangles, " non-indexed triangles");
+
+    auto GetTriangle = [&CI](Uint32 TriIdx) {
+        Triangle Tri;
+        float3*  Verts[] = {&Tri.V0, &Tri.V1, &Tri.V2};
+        for (Uint32 v = 0; v < 3; ++v)
+        {
+            const auto VertIdx = CI.pIndices != nullptr ? CI.pIndices[TriIdx * 3 + v] : TriIdx * 3 + v;
+            DEV_CHECK_ERR(VertIdx < CI.NumVertices, "Vertex index ", VertIdx, " is out of range");
+            *Verts[v] = CI.pVertices[VertIdx];
+        }
+        return Tri;
+    };
+
+    std::vector<BuildPrimitive> Prims(CI.NumTriangles);
+    m_TriangleIds.resize(CI.NumTriangles);
+    for (Uint32 i = 0; i < CI.NumTriangles; ++i)
+    {
+        const auto Tri = GetTriangle(i);
+
+        auto& Prim    = Prims[i];
+        Prim.BB.Min   = std::min(std::min(Tri.V0, Tri.V1), Tri.V2);
+        Prim.BB.Max   = std::max(std::max(Tri.V0, Tri.V1), Tri.V2);
+        Prim.Centroid = (Prim.BB.Min + Prim.BB.Max) * 0.5f;
+
+        m_TriangleIds[i] = i;
+    }
+
+    // A binary tree with N leaves has at most 2N - 1 nodes
+    m_Nodes.reserve(size_t{CI.NumTriangles} * 2 - 1);
+
+    Builder BVHBuilder{CI, Prims, m_TriangleIds};
+    m_Depth = BVHBuilder.Build(0, CI.NumTriangles, m_Nodes, 0, std::max(CI.NumThreads, 1u));
+    m_Nodes.shrink_to_fit();
+
+    m_Triangles.resize(CI.NumTriangles);
+    for (Uint32 i = 0; i < CI.NumTriangles; ++i)
+        m_Triangles[i] = GetTriangle(m_TriangleIds[i]);
+}
+
+bool TriangleBVH::IntersectLeaf(const Node&   Leaf,
+                                const float3& RayOrigin,
+                                const float3& RayDirection,
+                                bool          CullBackFace,
+                                bool          AnyHit,
+                                HitInfo&      Hit) const
+{
+    VERIFY_EXPR(Leaf.IsLeaf());
+
+    bool Found = false;
+    for (Uint32 i = Leaf.RightChildOrFirstTriangle; i < Leaf.RightChildOrFirstTriangle + Leaf.NumTriangles; ++i)
+    {
+        const auto& Tri = m_Triangles[i];
+
+        const auto t = IntersectRayTriangle(Tri.V0, Tri.V1, Tri.V2, RayOrigin, RayDirection, CullBackFace);
+        // IntersectRayTriangle() returns +FLT_MAX if there is no intersection
+        if (t < 0 || t == FLT_MAX || t > Hit.Distance)
+            continue;
+
+        // Ties are resolved by the triangle index to make the result independent of the traversal order
+        const auto TriId = m_TriangleIds[i];
+        if (t < Hit.Distance || TriId < Hit.TriangleIndex)
+        {
+            Hit.Distance      = t;
+            Hit.TriangleIndex = TriId;
+            Found             = true;
+            if (AnyHit)
+                break;
+        }
+    }
+
+    return Found;
+}
+
+bool TriangleBVH::ClosestHit(const float3& RayOrigin,
+                             const float3& RayDirection,
+                             HitInfo&      Hit,
+                             float         MaxDistance,
+                             bool          CullBackFace) const
+{
+    Hit = HitInfo{};
+    if (m_Nodes.empty())
+        return false;
+
+    HitInfo Closest;
+    Closest.Distance = MaxDistance;
+
+    struct StackEntry
+    {
+        Uint32 NodeIdx;
+        float  EnterDist;
+    };
+    StackEntry Stack[MaxDepth];
+    Uint32     StackSize = 0;
+
+    float EnterDist = 0, ExitDist = 0;
+    if (!IntersectRayAABB(RayOrigin, RayDirection, m_Nodes[0].GetBoundBox(), EnterDist, ExitDist) || EnterDist > Closest.Distance)
+        return false;
+
+    Uint32 NodeIdx = 0;
+    while (true)
+    {
+        const auto& CurrNode = m_Nodes[NodeIdx];
+        if (CurrNode.IsLeaf())
+        {
+            IntersectLeaf(CurrNode, RayOrigin, RayDirection, CullBackFace, false, Closest);
+        }
+        else
+        {
+            Uint32 Children[]   = {NodeIdx + 1, CurrNode.RightChildOrFirstTriangle};
+            float  EnterDists[] = {0, 0};
+            bool   IsHit[2];
+            for (Uint32 c = 0; c < 2; ++c)
+            {
+                IsHit[c] = IntersectRayAABB(RayOrigin, RayDirection, m_Nodes[Children[c]].GetBoundBox(), EnterDists[c], ExitDist) &&
+                    EnterDists[c] <= Closest.Distance;
+            }
+
+            if (IsHit[0] && IsHit[1])
+            {
+                // Visit the nearest child first
+                const Uint32 Near = EnterDists[1] < EnterDists[0] ? 1 : 0;
+                VERIFY_EXPR(StackSize < MaxDepth);
+                Stack[StackSize++] = {Children[1 - Near], EnterDists[1 - Near]};
+                NodeIdx            = Children[Near];
+                continue;
+            }
+            else if (IsHit[0] || IsHit[1])
+            {
+                NodeIdx = Children[IsHit[0] ? 0 : 1];
+                continue;
+            }
+        }
+
+        // Pop the next node skipping the ones that are farther than the closest hit
+        while (StackSize > 0 && Stack[StackSize - 1].EnterDist > Closest.Distance)
+            --StackSize;
+        if (StackSize == 0)
+            break;
+        NodeIdx = Stack[--StackSize].NodeIdx;
+    }
+
+    if (!Closest.IsHit())
+        return false;
+
+    Hit = Closest;
+    return true;
+}
+
+bool TriangleBVH::AnyHit(const float3& RayOrigin,
+                         const float3& RayDirection,
+                         float         MaxDistance,
+                         bool          CullBackFace) const
+{
+    if (m_Nodes.empty())
+        return false;
+
+    HitInfo Hit;
+    Hit.Distance = MaxDistance;
+
+    Uint32 Stack[MaxDepth];
+    Uint32 StackSize = 0;
+
+    Stack[StackSize++] = 0;
+    while (StackSize > 0)
+    {
+        const auto  NodeIdx  = Stack[--StackSize];
+        const auto& CurrNode = m_Nodes[NodeIdx];
+
+        float EnterDist = 0, ExitDist = 0;
+        if (!IntersectRayAABB(RayOrigin, RayDirection, CurrNode.GetBoundBox(), EnterDist, ExitDist) || EnterDist > MaxDistance)
+            continue;
+
+        if (CurrNode.IsLeaf())
+        {
+            if (IntersectLeaf(CurrNode, RayOrigin, RayDirection, CullBackFace, true, Hit))
+                return true;
+        }
+        else
+        {
+            VERIFY_EXPR(StackSize + 2 <= MaxDepth);
+            Stack[StackSize++] = CurrNode.RightChildOrFirstTriangle;
+            Stack[StackSize++] = NodeIdx + 1;
+        }
+    }
+
+    return false;
+}
+
+void TriangleBVH::ClosestHitPacket(const float3* pRayOrigins,
+                                   const float3* pRayDirections,
+                                   Uint32        NumRays,
+                                   HitInfo*      pHits,
+                                   float         MaxDistance,
+                                   bool          CullBackFace) const
+{
+    for (Uint32 FirstRay = 0; FirstRay < NumRays; FirstRay += MaxPacketSize)
+    {
+        const Uint32  PacketSize = std::min(NumRays - FirstRay, MaxPacketSize);
+        const float3* Origins    = pRayOrigins + FirstRay;
+        const float3* Directions = pRayDirections + FirstRay;
+
+        HitInfo Closest[MaxPacketSize];
+        for (Uint32 r = 0; r < PacketSize; ++r)
+            Closest[r].Distance = MaxDistance;
+
+        if (m_Nodes.empty())
+        {
+            for (Uint32 r = 0; r < PacketSize; ++r)
+                pHits[FirstRay + r] = HitInfo{};
+            continue;
+        }
+
+        // Returns the mask of the active rays that intersect the node closer than their closest hit
+        // and the minimum entry distance of these rays
+        auto GetNodeRayMask = [&](Uint32 NodeIdx, Uint64 ActiveRays, float& MinEnterDist) {
+            const auto BB   = m_Nodes[NodeIdx].GetBoundBox();
+            Uint64     Mask = 0;
+            MinEnterDist    = FLT_MAX;
+            for (auto Rays = ActiveRays; Rays != 0; Rays &= Rays - 1)
+            {
+                const auto r = PlatformMisc::GetLSB(Rays);
+
+                float EnterDist = 0, ExitDist = 0;
+                if (IntersectRayAABB(Origins[r], Directions[r], BB, EnterDist, ExitDist) && EnterDist <= Closest[r].Distance)
+                {
+                    Mask |= Uint64{1} << r;
+                    MinEnterDist = std::min(MinEnterDist, EnterDist);
+                }
+            }
+            return Mask;
+        };
+
+        struct StackEntry
+        {
+            Uint32 NodeIdx;
+            float  MinEnterDist;
+            Uint64 RayMask;
+        };
+        StackEntry Stack[MaxDepth];
+        Uint32     StackSize = 0;
+
+        const Uint64 AllRays = PacketSize < 64 ? (Uint64{1} << PacketSize) - 1 : ~Uint64{0};
+
+        float  MinEnterDist = 0;
+        Uint32 NodeIdx      = 0;
+        Uint64 RayMask      = GetNodeRayMask(0, AllRays, MinEnterDist);
+        while (true)
+        {
+            if (RayMask != 0)
+            {
+                const auto& CurrNode = m_Nodes[NodeIdx];
+                if (CurrNode.IsLeaf())
+                {
+                    for (auto Rays = RayMask; Rays != 0; Rays &= Rays - 1)
+                    {
+                        const auto r = PlatformMisc::GetLSB(Rays);
+                        IntersectLeaf(CurrNode, Origins[r], Directions[r], CullBackFace, false, Closest[r]);
+                    }
+                }
+                else
+                {
+                    Uint32 Children[]      = {NodeIdx + 1, CurrNode.RightChildOrFirstTriangle};
+                    float  MinEnterDists[] = {0, 0};
+                    Uint64 ChildMasks[]    = {
+                        GetNodeRayMask(Children[0], RayMask, MinEnterDists[0]),
+                        GetNodeRayMask(Children[1], RayMask, MinEnterDists[1]),
+                    };
+
+                    // Visit the child that is nearest to the packet first
+                    const Uint32 Near = MinEnterDists[1] < MinEnterDists[0] ? 1 : 0;
+                    if (ChildMasks[1 - Near] != 0)
+                    {
+                        VERIFY_EXPR(StackSize < MaxDepth);
+                        Stack[StackSize++] = {Children[1 - Near], MinEnterDists[1 - Near], ChildMasks[1 - Near]};
+                    }
+                    NodeIdx = Children[Near];
+                    RayMask = ChildMasks[Near];
+                    continue;
+                }
+            }
+
+            if (StackSize == 0)
+                break;
+
+            // Rays may have found closer hits since the node was pushed. Remove the rays whose closest
+            // hit is nearer than the node entry distance of all rays in the packet; the remaining rays
+            // are filtered when the children of the node are tested.
+            const auto& Entry = Stack[--StackSize];
+            NodeIdx           = Entry.NodeIdx;
+            RayMask           = Entry.RayMask;
+            for (auto Rays = RayMask; Rays != 0; Rays &= Rays - 1)
+            {
+                const auto r = PlatformMisc::GetLSB(Rays);
+                if (Closest[r].Distance < Entry.MinEnterDist)
+                    RayMask &= ~(Uint64{1} << r);
+            }
+        }
+
+        for (Uint32 r = 0; r < PacketSize; ++r)
+            pHits[FirstRay + r] = Closest[r].IsHit() ? Closest[r] : HitInfo{};
+    }
+}
+
+} // namespace Diligent
@@ -40,9 +40,14 @@ enum TargetGLSLCompiler
     driver
 };
 
+/// Builds the full GLSL source of the shader, converting it from HLSL if necessary.
+
+/// If FilterHLSL2GLSLDefinitions is true, the shader converted from HLSL only includes the
+/// GLSL definitions it references. Otherwise all definitions are included.
 String BuildGLSLSourceString(const ShaderCreateInfo& CreationAttribs,
                              const DeviceCaps&       deviceCaps,
                              TargetGLSLCompiler      TargetCompiler,
-                             const char*             ExtraDefinitions = nullptr);
+                             const char*             ExtraDefinitions           = nullptr,
+                             bool                    FilterHLSL2GLSLDefinitions = false);
 
 } // namespace Diligent
\ No newline at end of file
@@ -0,0 +1,76 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "BasicTypes.h"
+#include "Shader.h"
+#include "PersistentCache.hpp"
+
+namespace Diligent
+{
+
+/// Key of the compiled SPIR-V byte code, see SPIRVCache::MakeKey().
+using SPIRVCacheKey = ContentHashKey;
+
+/// Content-addressed cache of SPIR-V byte code compiled from GLSL or HLSL sources.
+
+/// Compiled byte code is identified by the hash of the preprocessed source, the macro definitions,
+/// the entry point, the shader stage, the source language and the compiler version.
+/// The cache directory may be populated by offline tools and read at run time.
+/// See PersistentCache for the details of the memory and on-disk stores.
+/// All methods are thread-safe.
+class SPIRVCache : public PersistentCache<SPIRVCacheKey, std::vector<Uint32>>
+{
+public:
+    using TBase = PersistentCache<SPIRVCacheKey, std::vector<Uint32>>;
+    using Key   = SPIRVCacheKey;
+
+    /// Creates the key of the compiled byte code.
+
+    /// \param [in] SourceHash      - Hash of the preprocessed source, see ComputeFNVHash().
+    /// \param [in] SourceLength    - Length of the preprocessed source.
+    /// \param [in] ShaderType      - Shader stage.
+    /// \param [in] SourceLanguage  - Source language.
+    /// \param [in] EntryPoint      - Shader entry point.
+    /// \param [in] Definitions     - Macro definitions the source was compiled with, or null.
+    /// \param [in] CompilerVersion - String that identifies the compiler version and options.
+    static Key MakeKey(Uint64                 SourceHash,
+                       size_t                 SourceLength,
+                       SHADER_TYPE            ShaderType,
+                       SHADER_SOURCE_LANGUAGE SourceLanguage,
+                       const Char*            EntryPoint,
+                       const Char*            Definitions,
+                       const Char*            CompilerVersion);
+
+    /// \param [in] MaxMemorySize - Maximum total size, in bytes, of the byte code kept in memory.
+    explicit SPIRVCache(size_t MaxMemorySize = 32 << 20);
+};
+
+} // namespace Diligent
@@ -0,0 +1,198 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of Diligent::SPIRVReflection class
+
+#include <vector>
+#include <deque>
+#include <string>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Lightweight reflection of SPIR-V byte code.
+
+/// The parser walks the module once, up to the first function definition, and records names,
+/// decorations, types and global variables in flat per-id tables. Resources are then enumerated
+/// the same way spirv_cross::Compiler::get_shader_resources() enumerates them (in ascending
+/// variable id order, using the same naming rules), so the results may be used as a drop-in
+/// replacement without constructing the full SPIRV-Cross IR.
+/// Names returned by the class point into the byte code, which must outlive the object.
+class SPIRVReflection
+{
+public:
+    /// Throws an exception if the byte code is malformed.
+    explicit SPIRVReflection(const std::vector<uint32_t>& SPIRV);
+
+    // clang-format off
+    SPIRVReflection             (const SPIRVReflection&)  = delete;
+    SPIRVReflection             (      SPIRVReflection&&) = delete;
+    SPIRVReflection& operator = (const SPIRVReflection&)  = delete;
+    SPIRVReflection& operator = (      SPIRVReflection&&) = delete;
+    // clang-format on
+
+    struct EntryPoint
+    {
+        /// spv::ExecutionModel
+        Uint32      ExecutionModel = 0;
+        Uint32      Id             = 0;
+        const char* Name           = nullptr;
+
+        /// Offset and number of interface variable ids in the byte code
+        Uint32 InterfaceOffset = 0;
+        Uint32 NumInterfaceIds = 0;
+    };
+
+    struct Resource
+    {
+        /// Variable id
+        Uint32 Id = 0;
+
+        /// Name of the resource as reported by SPIRV-Cross (block name for uniform and
+        /// storage buffers, variable name for all other resources)
+        const char* Name = "";
+
+        /// Name of the variable, or empty string if the variable has no name
+        const char* VariableName = "";
+
+        /// Size of the innermost array dimension, 0 for runtime arrays, 1 if the resource is not an array
+        Uint32 ArraySize = 1;
+
+        /// Number of array dimensions
+        Uint32 NumArrayDims = 0;
+
+        /// Offsets in SPIRV words of the decoration literals, or 0 if the decoration is not declared
+        Uint32 BindingDecorationOffset       = 0;
+        Uint32 DescriptorSetDecorationOffset = 0;
+        Uint32 LocationDecorationOffset      = 0;
+
+        /// HLSL semantic (SPV_GOOGLE_hlsl_functionality1), or null
+        const char* HLSLSemantic = nullptr;
+
+        /// Storage buffer that is declared non-writable or whose members are all non-writable
+        bool IsReadOnly = false;
+
+        /// Image whose dimension is spv::DimBuffer
+        bool IsTexelBuffer = false;
+    };
+
+    struct ShaderResources
+    {
+        std::vector<Resource> UniformBuffers;
+        std::vector<Resource> StorageBuffers;
+        std::vector<Resource> StorageImages;
+        std::vector<Resource> SampledImages;
+        std::vector<Resource> AtomicCounters;
+        std::vector<Resource> SeparateImages;
+        std::vector<Resource> SeparateSamplers;
+        std::vector<Resource> StageInputs;
+    };
+
+    const std::vector<EntryPoint>& GetEntryPoints() const { return m_EntryPoints; }
+
+    /// Enumerates the resources. Stage inputs are only reported if they are
+    /// listed in the interface of the given entry point.
+    void GetShaderResources(const EntryPoint& EP, ShaderResources& Resources) const;
+
+    /// Returns true if the module was compiled from HLSL source (OpSource HLSL)
+    bool IsHLSLSource() const { return m_IsHLSLSource; }
+
+    bool HasExtension(const char* Extension) const;
+
+private:
+    void Parse();
+
+    const char* ReadString(size_t& Offset, size_t End) const;
+
+    const char* GetName(Uint32 Id) const;
+    const char* GetBlockName(Uint32 VarId, Uint32 BlockTypeId) const;
+    const char* GetInstanceName(Uint32 VarId) const;
+    bool        IsSSBOInstanceNameSignificant() const;
+
+    struct TypeInfo
+    {
+        Uint16 Opcode        = 0;
+        Uint8  Dim           = 0;
+        Uint8  Sampled       = 0;
+        Uint32 StorageClass  = 0;
+        Uint32 ElementTypeId = 0;
+        Uint32 ArrayLengthId = 0;
+        Uint32 NumMembers    = 0;
+    };
+
+    struct IdInfo
+    {
+        TypeInfo Type;
+
+        // Value of 32-bit integer constant
+        Uint32 ConstantValue = 0;
+
+        // Offset of the OpName string in the byte code
+        Uint32 NameOffset = 0;
+
+        Uint32 BindingOffset       = 0;
+        Uint32 DescriptorSetOffset = 0;
+        Uint32 LocationOffset      = 0;
+
+        const char* HLSLSemantic = nullptr;
+
+        Uint32 NumNonWritableMembers = 0;
+
+        bool IsBlock          = false;
+        bool IsBufferBlock    = false;
+        bool IsBuiltIn        = false;
+        bool HasBuiltInMember = false;
+        bool IsNonWritable    = false;
+    };
+
+    struct Variable
+    {
+        Uint32 Id           = 0;
+        Uint32 PointerType  = 0;
+        Uint32 StorageClass = 0;
+    };
+
+    const std::vector<uint32_t>& m_SPIRV;
+
+    std::vector<IdInfo>      m_Ids;
+    std::vector<Variable>    m_Variables;
+    std::vector<EntryPoint>  m_EntryPoints;
+    std::vector<const char*> m_Extensions;
+
+    // Fallback names generated for unnamed blocks
+    mutable std::deque<std::string> m_GeneratedNames;
+
+    bool m_IsHLSLSource  = false;
+    bool m_IsSourceKnown = false;
+};
+
+} // namespace Diligent
@@ -45,12 +45,7 @@
 #include "STDAllocator.hpp"
 #include "RefCntAutoPtr.hpp"
 #include "StringPool.hpp"
-
-namespace diligent_spirv_cross
-{
-class Compiler;
-struct Resource;
-} // namespace diligent_spirv_cross
+#include "SPIRVReflection.hpp"
 
 namespace Diligent
 {
@@ -93,11 +88,10 @@ public:
 
     // clang-format on
 
-    SPIRVShaderResourceAttribs(const diligent_spirv_cross::Compiler& Compiler,
-                               const diligent_spirv_cross::Resource& Res,
-                               const char*                           _Name,
-                               ResourceType                          _Type,
-                               Uint32                                _SamplerOrSepImgInd = InvalidSepSmplrOrImgInd) noexcept;
+    SPIRVShaderResourceAttribs(const SPIRVReflection::Resource& Res,
+                               const char*                      _Name,
+                               ResourceType                     _Type,
+                               Uint32                           _SamplerOrSepImgInd = InvalidSepSmplrOrImgInd) noexcept;
 
     bool IsValidSepSamplerAssigned() const
     {
@@ -180,13 +174,13 @@ static_assert(sizeof(SPIRVShaderStageInputAttribs) % sizeof(void*) == 0, "Size o
 class SPIRVShaderResources
 {
 public:
-    SPIRVShaderResources(IMemoryAllocator&     Allocator,
-                         IRenderDevice*        pRenderDevice,
-                         std::vector<uint32_t> spirv_binary,
-                         const ShaderDesc&     shaderDesc,
-                         const char*           CombinedSamplerSuffix,
-                         bool                  LoadShaderStageInputs,
-                         std::string&          EntryPoint);
+    SPIRVShaderResources(IMemoryAllocator&            Allocator,
+                         IRenderDevice*               pRenderDevice,
+                         const std::vector<uint32_t>& spirv_binary,
+                         const ShaderDesc&            shaderDesc,
+                         const char*                  CombinedSamplerSuffix,
+                         bool                         LoadShaderStageInputs,
+                         std::string&                 EntryPoint);
 
     // clang-format off
     SPIRVShaderResources             (const SPIRVShaderResources&)  = delete;
@@ -220,6 +214,14 @@ public:
 
     // clang-format on
 
+    /// Returns the index of the resource in the range [0, GetTotalResources()), such that GetResource(index) references Res.
+    Uint32 GetResourceIndex(const SPIRVShaderResourceAttribs& Res) const noexcept
+    {
+        const auto* pFirstRes = reinterpret_cast<const SPIRVShaderResourceAttribs*>(m_MemoryBuffer.get());
+        VERIFY(&Res >= pFirstRes && &Res < pFirstRes + m_TotalResources, "The resource does not belong to this object");
+        return static_cast<Uint32>(&Res - pFirstRes);
+    }
+
     const SPIRVShaderStageInputAttribs& GetShaderStageInputAttribs(Uint32 n) const noexcept
     {
         VERIFY(n < m_NumShaderStageInputs, "Shader stage input index (", n, ") is out of range. Total input count: ", m_NumShaderStageInputs);
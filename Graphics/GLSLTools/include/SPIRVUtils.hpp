@@ -30,6 +30,7 @@
 #include <vector>
 #include "Shader.h"
 #include "DataBlob.h"
+#include "SPIRVCache.hpp"
 
 namespace Diligent
 {
@@ -37,13 +38,23 @@ namespace Diligent
 void InitializeGlslang();
 void FinalizeGlslang();
 
+/// Compiles GLSL source to SPIR-V. If pCache is not null, the byte code is looked up
+/// in the cache before compiling, and the compiled byte code is added to the cache.
 std::vector<unsigned int> GLSLtoSPIRV(SHADER_TYPE ShaderType,
                                       const char* ShaderSource,
                                       int         SourceCodeLen,
-                                      IDataBlob** ppCompilerOutput);
+                                      IDataBlob** ppCompilerOutput,
+                                      SPIRVCache* pCache = nullptr);
 
+/// Compiles HLSL source to SPIR-V. If pCache is not null, the source is preprocessed
+/// and the byte code is looked up in the cache by the hash of the preprocessed source.
 std::vector<unsigned int> HLSLtoSPIRV(const ShaderCreateInfo& Attribs,
                                       const char*             ExtraDefinitions,
-                                      IDataBlob**             ppCompilerOutput);
+                                      IDataBlob**             ppCompilerOutput,
+                                      SPIRVCache*             pCache = nullptr);
+
+/// Returns the string that identifies the versions of glslang and SPIRV-Tools
+/// as well as the compilation options. The string is a part of SPIRVCache keys.
+const char* GetSPIRVCompilerVersion();
 
 } // namespace Diligent
\ No newline at end of file
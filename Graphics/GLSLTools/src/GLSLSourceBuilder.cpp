@@ -74,7 +74,8 @@ const char* GetShaderTypeDefines(SHADER_TYPE Type)
 String BuildGLSLSourceString(const ShaderCreateInfo& CreationAttribs,
                              const DeviceCaps&       deviceCaps,
                              TargetGLSLCompiler      TargetCompiler,
-                             const char*             ExtraDefinitions)
+                             const char*             ExtraDefinitions,
+                             bool                    FilterHLSL2GLSLDefinitions)
 {
     String GLSLSource;
 
@@ -349,7 +350,7 @@ String BuildGLSLSourceString(const ShaderCreateInfo& CreationAttribs,
         Attribs.NumSymbols           = SourceLen;
         Attribs.EntryPoint           = CreationAttribs.EntryPoint;
         Attribs.ShaderType           = CreationAttribs.Desc.ShaderType;
-        Attribs.IncludeDefinitions   = true;
+        Attribs.IncludeDefinitions   = !FilterHLSL2GLSLDefinitions;
         Attribs.InputFileName        = CreationAttribs.FilePath;
         Attribs.SamplerSuffix        = CreationAttribs.CombinedSamplerSuffix;
         // Separate shader objects extension also allows input/output layout qualifiers for
@@ -359,6 +360,12 @@ String BuildGLSLSourceString(const ShaderCreateInfo& CreationAttribs,
         Attribs.UseInOutLocationQualifiers = deviceCaps.Features.SeparablePrograms;
         auto ConvertedSource               = Converter.Convert(Attribs);
 
+        if (FilterHLSL2GLSLDefinitions && !ConvertedSource.empty())
+        {
+            // Only include the definitions that are referenced by the shader or by the macros
+            // defined above, which substantially reduces the amount of code the driver compiles.
+            GLSLSource.append(Converter.GetGLSLDefinitions({&GLSLSource, &ConvertedSource}));
+        }
         GLSLSource.append(ConvertedSource);
 #endif
     }
@@ -0,0 +1,73 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <cstring>
+
+#include "SPIRVCache.hpp"
+#include "HashUtils.hpp"
+
+namespace Diligent
+{
+
+SPIRVCache::Key SPIRVCache::MakeKey(Uint64                 SourceHash,
+                                    size_t                 SourceLength,
+                                    SHADER_TYPE            ShaderType,
+                                    SHADER_SOURCE_LANGUAGE SourceLanguage,
+                                    const Char*            EntryPoint,
+                                    const Char*            Definitions,
+                                    const Char*            CompilerVersion)
+{
+    Key K;
+    K.SourceHash   = SourceHash;
+    K.SourceLength = SourceLength;
+
+    // Null symbols separate the strings so that, for instance, "ab" + "c" and "a" + "bc" produce different hashes
+    const Char Separator = '\0';
+
+    auto& Hash = K.AttribsHash;
+    Hash       = ComputeFNVHash(&Separator, 1);
+    for (const auto* Str : {EntryPoint, Definitions, CompilerVersion})
+    {
+        if (Str != nullptr)
+            Hash = ComputeFNVHash(Str, strlen(Str), Hash);
+        Hash = ComputeFNVHash(&Separator, 1, Hash);
+    }
+
+    const Uint32 Flags[] = {static_cast<Uint32>(ShaderType), static_cast<Uint32>(SourceLanguage)};
+    Hash                 = ComputeFNVHash(Flags, sizeof(Flags), Hash);
+
+    return K;
+}
+
+SPIRVCache::SPIRVCache(size_t MaxMemorySize) :
+    // The file version must be incremented whenever the file layout changes.
+    // Compiler changes are tracked by the compiler version that is part of the key.
+    TBase{0x56525053 /*'SPRV'*/, 2, "spv", "SPIRV cache", MaxMemorySize}
+{
+}
+
+} // namespace Diligent
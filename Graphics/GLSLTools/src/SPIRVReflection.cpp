@@ -0,0 +1,457 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "SPIRVReflection.hpp"
+#include "spirv/unified1/spirv.hpp"
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+SPIRVReflection::SPIRVReflection(const std::vector<uint32_t>& SPIRV) :
+    m_SPIRV{SPIRV}
+{
+    Parse();
+}
+
+const char* SPIRVReflection::ReadString(size_t& Offset, size_t End) const
+{
+    // Literal strings are nul-terminated and padded with zeroes to the word boundary
+    const auto* Str    = reinterpret_cast<const char*>(m_SPIRV.data() + Offset);
+    const auto  MaxLen = (End - Offset) * sizeof(uint32_t);
+    const auto* Nul    = static_cast<const char*>(memchr(Str, 0, MaxLen));
+    if (Nul == nullptr)
+        LOG_ERROR_AND_THROW("Literal string at word ", Offset, " is not nul-terminated");
+
+    Offset += (Nul - Str) / sizeof(uint32_t) + 1;
+    return Str;
+}
+
+void SPIRVReflection::Parse()
+{
+    const auto* const Words    = m_SPIRV.data();
+    const auto        NumWords = m_SPIRV.size();
+
+    if (NumWords < 5)
+        LOG_ERROR_AND_THROW("SPIRV byte code is too short");
+    if (Words[0] != spv::MagicNumber)
+        LOG_ERROR_AND_THROW("Invalid SPIRV magic number");
+
+    const auto Bound = Words[3];
+    m_Ids.resize(Bound);
+
+    auto GetIdInfo = [&](Uint32 Id) -> IdInfo& {
+        if (Id >= Bound)
+            LOG_ERROR_AND_THROW("Id ", Id, " exceeds the bound (", Bound, ") declared by the module");
+        return m_Ids[Id];
+    };
+
+    size_t Offset = 5;
+    while (Offset < NumWords)
+    {
+        const auto WordCount = Words[Offset] >> spv::WordCountShift;
+        const auto OpCode    = static_cast<spv::Op>(Words[Offset] & spv::OpCodeMask);
+        if (WordCount == 0 || Offset + WordCount > NumWords)
+            LOG_ERROR_AND_THROW("Invalid word count (", WordCount, ") of instruction at word ", Offset);
+
+        const auto  End = Offset + WordCount;
+        const auto* Ops = Words + Offset + 1;
+
+        auto RequireOperands = [&](Uint32 NumOperands) {
+            if (WordCount < NumOperands + 1)
+                LOG_ERROR_AND_THROW("Instruction at word ", Offset, " has too few operands");
+        };
+
+        switch (OpCode)
+        {
+            case spv::OpSource:
+                RequireOperands(2);
+                m_IsSourceKnown = true;
+                m_IsHLSLSource  = Ops[0] == spv::SourceLanguageHLSL;
+                break;
+
+            case spv::OpName:
+            {
+                RequireOperands(2);
+                auto StrOffset = Offset + 2;
+                ReadString(StrOffset, End);
+                GetIdInfo(Ops[0]).NameOffset = static_cast<Uint32>(Offset + 2);
+                break;
+            }
+
+            case spv::OpExtension:
+            {
+                RequireOperands(1);
+                auto StrOffset = Offset + 1;
+                m_Extensions.push_back(ReadString(StrOffset, End));
+                break;
+            }
+
+            case spv::OpEntryPoint:
+            {
+                RequireOperands(3);
+                EntryPoint EP;
+                EP.ExecutionModel  = Ops[0];
+                EP.Id              = Ops[1];
+                auto StrOffset     = Offset + 3;
+                EP.Name            = ReadString(StrOffset, End);
+                EP.InterfaceOffset = static_cast<Uint32>(StrOffset);
+                EP.NumInterfaceIds = static_cast<Uint32>(End - StrOffset);
+                m_EntryPoints.push_back(EP);
+                break;
+            }
+
+            case spv::OpDecorate:
+            {
+                RequireOperands(2);
+                auto& Info = GetIdInfo(Ops[0]);
+                switch (static_cast<spv::Decoration>(Ops[1]))
+                {
+                    // clang-format off
+                    case spv::DecorationBlock:       Info.IsBlock       = true; break;
+                    case spv::DecorationBufferBlock: Info.IsBufferBlock = true; break;
+                    case spv::DecorationBuiltIn:     Info.IsBuiltIn     = true; break;
+                    case spv::DecorationNonWritable: Info.IsNonWritable = true; break;
+                    // clang-format on
+
+                    // Offsets of the decoration literals
+                    case spv::DecorationBinding:
+                        RequireOperands(3);
+                        Info.BindingOffset = static_cast<Uint32>(Offset + 3);
+                        break;
+
+                    case spv::DecorationDescriptorSet:
+                        RequireOperands(3);
+                        Info.DescriptorSetOffset = static_cast<Uint32>(Offset + 3);
+                        break;
+
+                    case spv::DecorationLocation:
+                        RequireOperands(3);
+                        Info.LocationOffset = static_cast<Uint32>(Offset + 3);
+                        break;
+
+                    default:
+                        break;
+                }
+                break;
+            }
+
+            case spv::OpMemberDecorate:
+            {
+                RequireOperands(3);
+                auto& Info = GetIdInfo(Ops[0]);
+                if (Ops[2] == spv::DecorationBuiltIn)
+                    Info.HasBuiltInMember = true;
+                else if (Ops[2] == spv::DecorationNonWritable)
+                    ++Info.NumNonWritableMembers;
+                break;
+            }
+
+            case spv::OpDecorateString:
+            {
+                // OpDecorateStringGOOGLE has the same opcode
+                RequireOperands(3);
+                if (Ops[1] == spv::DecorationHlslSemanticGOOGLE)
+                {
+                    auto StrOffset                 = Offset + 3;
+                    GetIdInfo(Ops[0]).HLSLSemantic = ReadString(StrOffset, End);
+                }
+                break;
+            }
+
+            case spv::OpTypeImage:
+            {
+                RequireOperands(8);
+                auto& Type   = GetIdInfo(Ops[0]).Type;
+                Type.Opcode  = static_cast<Uint16>(OpCode);
+                Type.Dim     = static_cast<Uint8>(Ops[2]);
+                Type.Sampled = static_cast<Uint8>(Ops[6]);
+                break;
+            }
+
+            case spv::OpTypeSampledImage:
+            {
+                RequireOperands(2);
+                // Image type must be declared before it is referenced
+                const auto ImageType = GetIdInfo(Ops[1]).Type;
+                auto&      Type      = GetIdInfo(Ops[0]).Type;
+                Type.Opcode          = static_cast<Uint16>(OpCode);
+                Type.Dim             = ImageType.Dim;
+                Type.Sampled         = ImageType.Sampled;
+                break;
+            }
+
+            case spv::OpTypeSampler:
+            case spv::OpTypeStruct:
+            {
+                RequireOperands(1);
+                auto& Type      = GetIdInfo(Ops[0]).Type;
+                Type.Opcode     = static_cast<Uint16>(OpCode);
+                Type.NumMembers = OpCode == spv::OpTypeStruct ? WordCount - 2 : 0;
+                break;
+            }
+
+            case spv::OpTypeArray:
+            case spv::OpTypeRuntimeArray:
+            {
+                RequireOperands(OpCode == spv::OpTypeArray ? 3 : 2);
+                auto& Type         = GetIdInfo(Ops[0]).Type;
+                Type.Opcode        = static_cast<Uint16>(OpCode);
+                Type.ElementTypeId = Ops[1];
+                Type.ArrayLengthId = OpCode == spv::OpTypeArray ? Ops[2] : 0;
+                break;
+            }
+
+            case spv::OpTypePointer:
+            {
+                RequireOperands(3);
+                auto& Type         = GetIdInfo(Ops[0]).Type;
+                Type.Opcode        = static_cast<Uint16>(OpCode);
+                Type.StorageClass  = Ops[1];
+                Type.ElementTypeId = Ops[2];
+                break;
+            }
+
+            case spv::OpConstant:
+            case spv::OpSpecConstant:
+                // Only the low-order word is needed for array sizes
+                RequireOperands(3);
+                GetIdInfo(Ops[1]).ConstantValue = Ops[2];
+                break;
+
+            case spv::OpVariable:
+            {
+                RequireOperands(3);
+                GetIdInfo(Ops[1]);
+                if (Ops[2] != spv::StorageClassFunction)
+                {
+                    Variable Var;
+                    Var.PointerType  = Ops[0];
+                    Var.Id           = Ops[1];
+                    Var.StorageClass = Ops[2];
+                    m_Variables.push_back(Var);
+                }
+                break;
+            }
+
+            case spv::OpFunction:
+                // Debug info, annotations, types and global variables must all precede
+                // function definitions, so there is nothing else to look at.
+                Offset = NumWords;
+                continue;
+
+            default:
+                break;
+        }
+
+        Offset += WordCount;
+    }
+
+    // SPIRV-Cross enumerates variables in the order of their ids
+    std::sort(m_Variables.begin(), m_Variables.end(),
+              [](const Variable& V1, const Variable& V2) { return V1.Id < V2.Id; });
+
+    // Validate type references once, so that resource enumeration does not have to
+    for (const auto& Var : m_Variables)
+    {
+        const auto* pType = &GetIdInfo(Var.PointerType).Type;
+        // Nested arrays cannot reference themselves, but guard against malformed byte code
+        for (Uint32 Depth = 0; pType->Opcode == spv::OpTypePointer || pType->Opcode == spv::OpTypeArray || pType->Opcode == spv::OpTypeRuntimeArray; ++Depth)
+        {
+            if (Depth > 64)
+                LOG_ERROR_AND_THROW("Type of variable ", Var.Id, " is too deeply nested");
+            GetIdInfo(pType->ArrayLengthId);
+            pType = &GetIdInfo(pType->ElementTypeId).Type;
+        }
+    }
+}
+
+bool SPIRVReflection::HasExtension(const char* Extension) const
+{
+    for (const auto* Ext : m_Extensions)
+    {
+        if (strcmp(Ext, Extension) == 0)
+            return true;
+    }
+    return false;
+}
+
+const char* SPIRVReflection::GetName(Uint32 Id) const
+{
+    const auto NameOffset = m_Ids[Id].NameOffset;
+    return NameOffset != 0 ? reinterpret_cast<const char*>(m_SPIRV.data() + NameOffset) : "";
+}
+
+const char* SPIRVReflection::GetBlockName(Uint32 VarId, Uint32 BlockTypeId) const
+{
+    // Matches Compiler::get_remapped_declared_block_name(id, false)
+    const auto* BlockName = GetName(BlockTypeId);
+    if (*BlockName != 0)
+        return BlockName;
+
+    const auto* VarName = GetName(VarId);
+    if (*VarName != 0)
+        return VarName;
+
+    m_GeneratedNames.emplace_back("_" + std::to_string(BlockTypeId) + "_" + std::to_string(VarId));
+    return m_GeneratedNames.back().c_str();
+}
+
+const char* SPIRVReflection::GetInstanceName(Uint32 VarId) const
+{
+    const auto* VarName = GetName(VarId);
+    if (*VarName != 0)
+        return VarName;
+
+    m_GeneratedNames.emplace_back("_" + std::to_string(VarId));
+    return m_GeneratedNames.back().c_str();
+}
+
+bool SPIRVReflection::IsSSBOInstanceNameSignificant() const
+{
+    // Matches Compiler::reflection_ssbo_instance_name_is_significant():
+    // UAVs from HLSL source tend to reuse the block type, so the instance name is
+    // significant. If the source language is unknown, check if block types are aliased.
+    if (m_IsSourceKnown)
+        return m_IsHLSLSource;
+
+    std::vector<Uint32> SSBOTypes;
+    for (const auto& Var : m_Variables)
+    {
+        Uint32 TypeId = m_Ids[Var.PointerType].Type.ElementTypeId;
+        while (m_Ids[TypeId].Type.Opcode == spv::OpTypeArray || m_Ids[TypeId].Type.Opcode == spv::OpTypeRuntimeArray)
+            TypeId = m_Ids[TypeId].Type.ElementTypeId;
+
+        const bool IsSSBO =
+            Var.StorageClass == spv::StorageClassStorageBuffer ||
+            (Var.StorageClass == spv::StorageClassUniform && m_Ids[TypeId].IsBufferBlock);
+        if (IsSSBO)
+        {
+            if (std::find(SSBOTypes.begin(), SSBOTypes.end(), TypeId) != SSBOTypes.end())
+                return true;
+            SSBOTypes.push_back(TypeId);
+        }
+    }
+    return false;
+}
+
+void SPIRVReflection::GetShaderResources(const EntryPoint& EP, ShaderResources& Resources) const
+{
+    Resources = ShaderResources{};
+
+    const bool SSBOInstanceName = IsSSBOInstanceNameSignificant();
+
+    const auto* InterfaceIdsBegin = m_SPIRV.data() + EP.InterfaceOffset;
+    const auto* InterfaceIdsEnd   = InterfaceIdsBegin + EP.NumInterfaceIds;
+
+    for (const auto& Var : m_Variables)
+    {
+        const auto& PtrType = m_Ids[Var.PointerType].Type;
+        if (PtrType.Opcode != spv::OpTypePointer)
+            continue;
+
+        const auto& VarInfo = m_Ids[Var.Id];
+
+        Resource Res;
+        Res.Id                            = Var.Id;
+        Res.VariableName                  = GetName(Var.Id);
+        Res.BindingDecorationOffset       = VarInfo.BindingOffset;
+        Res.DescriptorSetDecorationOffset = VarInfo.DescriptorSetOffset;
+        Res.LocationDecorationOffset      = VarInfo.LocationOffset;
+        Res.HLSLSemantic                  = VarInfo.HLSLSemantic;
+
+        // Strip array types. Like SPIRV-Cross, report the size of the innermost dimension.
+        Uint32 TypeId = PtrType.ElementTypeId;
+        while (m_Ids[TypeId].Type.Opcode == spv::OpTypeArray || m_Ids[TypeId].Type.Opcode == spv::OpTypeRuntimeArray)
+        {
+            const auto& ArrType = m_Ids[TypeId].Type;
+            Res.ArraySize       = ArrType.Opcode == spv::OpTypeArray ? m_Ids[ArrType.ArrayLengthId].ConstantValue : 0;
+            ++Res.NumArrayDims;
+            TypeId = ArrType.ElementTypeId;
+        }
+
+        const auto& BaseInfo = m_Ids[TypeId];
+        const auto& BaseType = BaseInfo.Type;
+
+        // Built-in variables and blocks (gl_PerVertex) are not resources
+        if (VarInfo.IsBuiltIn || BaseInfo.HasBuiltInMember)
+            continue;
+
+        const bool IsImage = BaseType.Opcode == spv::OpTypeImage;
+        Res.IsTexelBuffer  = IsImage && BaseType.Dim == spv::DimBuffer;
+
+        // The order of the checks below matches Compiler::get_shader_resources()
+        if (Var.StorageClass == spv::StorageClassInput)
+        {
+            if (std::find(InterfaceIdsBegin, InterfaceIdsEnd, Var.Id) != InterfaceIdsEnd)
+            {
+                Res.Name = BaseInfo.IsBlock ? GetBlockName(Var.Id, TypeId) : Res.VariableName;
+                Resources.StageInputs.push_back(Res);
+            }
+        }
+        else if (Var.StorageClass == spv::StorageClassUniformConstant && IsImage && BaseType.Dim == spv::DimSubpassData)
+        {
+            // Subpass inputs are not reported
+        }
+        else if (Var.StorageClass == spv::StorageClassUniform && BaseInfo.IsBlock)
+        {
+            Res.Name = GetBlockName(Var.Id, TypeId);
+            Resources.UniformBuffers.push_back(Res);
+        }
+        else if ((Var.StorageClass == spv::StorageClassUniform && BaseInfo.IsBufferBlock) ||
+                 Var.StorageClass == spv::StorageClassStorageBuffer)
+        {
+            Res.Name = SSBOInstanceName ? GetInstanceName(Var.Id) : GetBlockName(Var.Id, TypeId);
+            // Non-writable flag of the variable is combined with the flags shared by all block members
+            Res.IsReadOnly = VarInfo.IsNonWritable ||
+                (BaseType.NumMembers > 0 && BaseInfo.NumNonWritableMembers >= BaseType.NumMembers);
+            Resources.StorageBuffers.push_back(Res);
+        }
+        else if (Var.StorageClass == spv::StorageClassUniformConstant)
+        {
+            Res.Name = Res.VariableName;
+            if (IsImage && BaseType.Sampled == 2)
+                Resources.StorageImages.push_back(Res);
+            else if (IsImage && BaseType.Sampled == 1)
+                Resources.SeparateImages.push_back(Res);
+            else if (BaseType.Opcode == spv::OpTypeSampler)
+                Resources.SeparateSamplers.push_back(Res);
+            else if (BaseType.Opcode == spv::OpTypeSampledImage)
+                Resources.SampledImages.push_back(Res);
+        }
+        else if (Var.StorageClass == spv::StorageClassAtomicCounter)
+        {
+            Res.Name = Res.VariableName;
+            Resources.AtomicCounters.push_back(Res);
+        }
+    }
+}
+
+} // namespace Diligent
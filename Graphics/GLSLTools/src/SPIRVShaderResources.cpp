@@ -27,8 +27,8 @@
 
 #include <iomanip>
 #include "SPIRVShaderResources.hpp"
-#include "spirv_parser.hpp"
-#include "spirv_cross.hpp"
+#include "SPIRVReflection.hpp"
+#include "spirv/unified1/spirv.hpp"
 #include "ShaderBase.hpp"
 #include "GraphicsAccessories.hpp"
 #include "StringTools.hpp"
@@ -38,45 +38,31 @@ namespace Diligent
 {
 
 template <typename Type>
-Type GetResourceArraySize(const diligent_spirv_cross::Compiler& Compiler,
-                          const diligent_spirv_cross::Resource& Res)
+Type GetResourceArraySize(const SPIRVReflection::Resource& Res)
 {
-    const auto& type    = Compiler.get_type(Res.type_id);
-    uint32_t    arrSize = 1;
-    if (!type.array.empty())
-    {
-        // https://github.com/KhronosGroup/SPIRV-Cross/wiki/Reflection-API-user-guide#querying-array-types
-        VERIFY(type.array.size() == 1, "Only one-dimensional arrays are currently supported");
-        arrSize = type.array[0];
-    }
-    VERIFY(arrSize <= std::numeric_limits<Type>::max(), "Array size exceeds maximum representable value ", std::numeric_limits<Type>::max());
-    return static_cast<Type>(arrSize);
+    VERIFY(Res.NumArrayDims <= 1, "Only one-dimensional arrays are currently supported");
+    VERIFY(Res.ArraySize <= std::numeric_limits<Type>::max(), "Array size exceeds maximum representable value ", std::numeric_limits<Type>::max());
+    return static_cast<Type>(Res.ArraySize);
 }
 
-static uint32_t GetDecorationOffset(const diligent_spirv_cross::Compiler& Compiler,
-                                    const diligent_spirv_cross::Resource& Res,
-                                    spv::Decoration                       Decoration)
+static uint32_t GetDecorationOffset(const SPIRVReflection::Resource& Res, uint32_t Offset)
 {
-    VERIFY(Compiler.has_decoration(Res.id, Decoration), "Resource \'", Res.name, "\' has no requested decoration");
-    uint32_t offset   = 0;
-    auto     declared = Compiler.get_binary_offset_for_decoration(Res.id, Decoration, offset);
-    VERIFY(declared, "Requested decoration is not declared");
-    (void)declared;
-    return offset;
+    VERIFY(Offset != 0, "Resource \'", Res.Name, "\' has no requested decoration");
+    (void)Res;
+    return Offset;
 }
 
-SPIRVShaderResourceAttribs::SPIRVShaderResourceAttribs(const diligent_spirv_cross::Compiler& Compiler,
-                                                       const diligent_spirv_cross::Resource& Res,
-                                                       const char*                           _Name,
-                                                       ResourceType                          _Type,
-                                                       Uint32                                _SepSmplrOrImgInd) noexcept :
+SPIRVShaderResourceAttribs::SPIRVShaderResourceAttribs(const SPIRVReflection::Resource& Res,
+                                                       const char*                      _Name,
+                                                       ResourceType                     _Type,
+                                                       Uint32                           _SepSmplrOrImgInd) noexcept :
     // clang-format off
     Name                          {_Name},
-    ArraySize                     {GetResourceArraySize<decltype(ArraySize)>(Compiler, Res)},
+    ArraySize                     {GetResourceArraySize<decltype(ArraySize)>(Res)},
     Type                          {_Type},
     SepSmplrOrImgInd              {_SepSmplrOrImgInd},
-    BindingDecorationOffset       {GetDecorationOffset(Compiler, Res, spv::Decoration::DecorationBinding)},
-    DescriptorSetDecorationOffset {GetDecorationOffset(Compiler, Res, spv::Decoration::DecorationDescriptorSet)}
+    BindingDecorationOffset       {GetDecorationOffset(Res, Res.BindingDecorationOffset)},
+    DescriptorSetDecorationOffset {GetDecorationOffset(Res, Res.DescriptorSetDecorationOffset)}
 // clang-format on
 {
     VERIFY(_SepSmplrOrImgInd == SPIRVShaderResourceAttribs::InvalidSepSmplrOrImgInd ||
@@ -163,9 +149,7 @@ static spv::ExecutionModel ShaderTypeToExecutionModel(SHADER_TYPE ShaderType)
     }
 }
 
-const std::string& GetUBName(diligent_spirv_cross::Compiler&               Compiler,
-                             const diligent_spirv_cross::Resource&         UB,
-                             const diligent_spirv_cross::ParsedIR::Source& IRSource)
+static const char* GetUBName(const SPIRVReflection::Resource& UB, bool IsHLSLSource)
 {
     // Consider the following HLSL constant buffer:
     //
@@ -191,74 +175,70 @@ const std::string& GetUBName(diligent_spirv_cross::Compiler&               Compi
     //
     //                            |     glslang      |         DXC
     //  -------------------------------------------------------------------
-    //  UB.name                   |   "Constants"    |   "type_Constants"
-    //  Compiler.get_name(UB.id)  |   ""             |   "Constants"
+    //  UB.Name                   |   "Constants"    |   "type_Constants"
+    //  UB.VariableName           |   ""             |   "Constants"
     //
     // Note that for the byte code produced from GLSL, we must always
-    // use UB.name even if the instance name is present
+    // use UB.Name even if the instance name is present
 
-    const auto& instance_name = Compiler.get_name(UB.id);
-    return (IRSource.hlsl && !instance_name.empty()) ? instance_name : UB.name;
+    return (IsHLSLSource && *UB.VariableName != 0) ? UB.VariableName : UB.Name;
 }
 
-SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
-                                           IRenderDevice*        pRenderDevice,
-                                           std::vector<uint32_t> spirv_binary,
-                                           const ShaderDesc&     shaderDesc,
-                                           const char*           CombinedSamplerSuffix,
-                                           bool                  LoadShaderStageInputs,
-                                           std::string&          EntryPoint) :
+SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&            Allocator,
+                                           IRenderDevice*               pRenderDevice,
+                                           const std::vector<uint32_t>& spirv_binary,
+                                           const ShaderDesc&            shaderDesc,
+                                           const char*                  CombinedSamplerSuffix,
+                                           bool                         LoadShaderStageInputs,
+                                           std::string&                 EntryPoint) :
     m_ShaderType{shaderDesc.ShaderType}
 {
-    // https://github.com/KhronosGroup/SPIRV-Cross/wiki/Reflection-API-user-guide
-    diligent_spirv_cross::Parser parser(move(spirv_binary));
-    parser.parse();
-    const auto ParsedIRSource = parser.get_parsed_ir().source;
-    m_IsHLSLSource            = ParsedIRSource.hlsl;
-    diligent_spirv_cross::Compiler Compiler(std::move(parser.get_parsed_ir()));
-
-    spv::ExecutionModel ExecutionModel = ShaderTypeToExecutionModel(shaderDesc.ShaderType);
-    auto                EntryPoints    = Compiler.get_entry_points_and_stages();
-    for (const auto& CurrEntryPoint : EntryPoints)
+    // Resource names returned by the reflection point into spirv_binary
+    SPIRVReflection Reflection{spirv_binary};
+    m_IsHLSLSource = Reflection.IsHLSLSource();
+
+    const auto                         ExecutionModel = static_cast<Uint32>(ShaderTypeToExecutionModel(shaderDesc.ShaderType));
+    const SPIRVReflection::EntryPoint* pEntryPoint    = nullptr;
+    for (const auto& CurrEntryPoint : Reflection.GetEntryPoints())
     {
-        if (CurrEntryPoint.execution_model == ExecutionModel)
+        if (CurrEntryPoint.ExecutionModel == ExecutionModel)
         {
-            if (!EntryPoint.empty())
+            if (pEntryPoint != nullptr)
             {
-                LOG_WARNING_MESSAGE("More than one entry point of type ", GetShaderTypeLiteralName(shaderDesc.ShaderType), " found in SPIRV binary for shader '", shaderDesc.Name, "'. The first one ('", EntryPoint, "') will be used.");
+                LOG_WARNING_MESSAGE("More than one entry point of type ", GetShaderTypeLiteralName(shaderDesc.ShaderType), " found in SPIRV binary for shader '", shaderDesc.Name, "'. The first one ('", pEntryPoint->Name, "') will be used.");
             }
             else
             {
-                EntryPoint = CurrEntryPoint.name;
+                pEntryPoint = &CurrEntryPoint;
             }
         }
     }
-    if (EntryPoint.empty())
+    if (pEntryPoint == nullptr)
     {
         LOG_ERROR_AND_THROW("Unable to find entry point of type ", GetShaderTypeLiteralName(shaderDesc.ShaderType), " in SPIRV binary for shader '", shaderDesc.Name, "'");
     }
-    Compiler.set_entry_point(EntryPoint, ExecutionModel);
+    EntryPoint = pEntryPoint->Name;
 
-    // The SPIR-V is now parsed, and we can perform reflection on it.
-    diligent_spirv_cross::ShaderResources resources = Compiler.get_shader_resources();
+    SPIRVReflection::ShaderResources resources;
+    Reflection.GetShaderResources(*pEntryPoint, resources);
 
     size_t ResourceNamesPoolSize = 0;
-    for (const auto& ub : resources.uniform_buffers)
-        ResourceNamesPoolSize += GetUBName(Compiler, ub, ParsedIRSource).length() + 1;
+    for (const auto& ub : resources.UniformBuffers)
+        ResourceNamesPoolSize += strlen(GetUBName(ub, m_IsHLSLSource)) + 1;
     for (auto* pResType :
          {
-             &resources.storage_buffers,
-             &resources.storage_images,
-             &resources.sampled_images,
-             &resources.atomic_counters,
-             &resources.separate_images,
-             &resources.separate_samplers
+             &resources.StorageBuffers,
+             &resources.StorageImages,
+             &resources.SampledImages,
+             &resources.AtomicCounters,
+             &resources.SeparateImages,
+             &resources.SeparateSamplers
              //clang-format off
          })
     //clang-format on
     {
         for (const auto& res : *pResType)
-            ResourceNamesPoolSize += res.name.length() + 1;
+            ResourceNamesPoolSize += strlen(res.Name) + 1;
     }
 
     if (CombinedSamplerSuffix != nullptr)
@@ -271,32 +251,22 @@ SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
 
     Uint32 NumShaderStageInputs = 0;
 
-    if (!m_IsHLSLSource || resources.stage_inputs.empty())
+    if (!m_IsHLSLSource || resources.StageInputs.empty())
         LoadShaderStageInputs = false;
     if (LoadShaderStageInputs)
     {
-        const auto& Extensions         = Compiler.get_declared_extensions();
-        bool        HlslFunctionality1 = false;
-        for (const auto& ext : Extensions)
-        {
-            HlslFunctionality1 = (ext == "SPV_GOOGLE_hlsl_functionality1");
-            if (HlslFunctionality1)
-                break;
-        }
-
-        if (HlslFunctionality1)
+        if (Reflection.HasExtension("SPV_GOOGLE_hlsl_functionality1"))
         {
-            for (const auto& Input : resources.stage_inputs)
+            for (const auto& Input : resources.StageInputs)
             {
-                if (Compiler.has_decoration(Input.id, spv::Decoration::DecorationHlslSemanticGOOGLE))
+                if (Input.HLSLSemantic != nullptr)
                 {
-                    const auto& Semantic = Compiler.get_decoration_string(Input.id, spv::Decoration::DecorationHlslSemanticGOOGLE);
-                    ResourceNamesPoolSize += Semantic.length() + 1;
+                    ResourceNamesPoolSize += strlen(Input.HLSLSemantic) + 1;
                     ++NumShaderStageInputs;
                 }
                 else
                 {
-                    LOG_ERROR_MESSAGE("Shader input '", Input.name, "' does not have DecorationHlslSemanticGOOGLE decoration, which is unexpected as the shader declares SPV_GOOGLE_hlsl_functionality1 extension");
+                    LOG_ERROR_MESSAGE("Shader input '", Input.Name, "' does not have DecorationHlslSemanticGOOGLE decoration, which is unexpected as the shader declares SPV_GOOGLE_hlsl_functionality1 extension");
                 }
             }
         }
@@ -315,24 +285,22 @@ SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
     }
 
     ResourceCounters ResCounters;
-    ResCounters.NumUBs       = static_cast<Uint32>(resources.uniform_buffers.size());
-    ResCounters.NumSBs       = static_cast<Uint32>(resources.storage_buffers.size());
-    ResCounters.NumImgs      = static_cast<Uint32>(resources.storage_images.size());
-    ResCounters.NumSmpldImgs = static_cast<Uint32>(resources.sampled_images.size());
-    ResCounters.NumACs       = static_cast<Uint32>(resources.atomic_counters.size());
-    ResCounters.NumSepSmplrs = static_cast<Uint32>(resources.separate_samplers.size());
-    ResCounters.NumSepImgs   = static_cast<Uint32>(resources.separate_images.size());
+    ResCounters.NumUBs       = static_cast<Uint32>(resources.UniformBuffers.size());
+    ResCounters.NumSBs       = static_cast<Uint32>(resources.StorageBuffers.size());
+    ResCounters.NumImgs      = static_cast<Uint32>(resources.StorageImages.size());
+    ResCounters.NumSmpldImgs = static_cast<Uint32>(resources.SampledImages.size());
+    ResCounters.NumACs       = static_cast<Uint32>(resources.AtomicCounters.size());
+    ResCounters.NumSepSmplrs = static_cast<Uint32>(resources.SeparateSamplers.size());
+    ResCounters.NumSepImgs   = static_cast<Uint32>(resources.SeparateImages.size());
     Initialize(Allocator, ResCounters, NumShaderStageInputs, ResourceNamesPoolSize);
 
     {
         Uint32 CurrUB = 0;
-        for (const auto& UB : resources.uniform_buffers)
+        for (const auto& UB : resources.UniformBuffers)
         {
-            const auto& name = GetUBName(Compiler, UB, ParsedIRSource);
             new (&GetUB(CurrUB++))
-                SPIRVShaderResourceAttribs(Compiler,
-                                           UB,
-                                           m_ResourceNames.CopyString(name),
+                SPIRVShaderResourceAttribs(UB,
+                                           m_ResourceNames.CopyString(GetUBName(UB, m_IsHLSLSource)),
                                            SPIRVShaderResourceAttribs::ResourceType::UniformBuffer);
         }
         VERIFY_EXPR(CurrUB == GetNumUBs());
@@ -340,17 +308,14 @@ SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
 
     {
         Uint32 CurrSB = 0;
-        for (const auto& SB : resources.storage_buffers)
+        for (const auto& SB : resources.StorageBuffers)
         {
-            auto BufferFlags = Compiler.get_buffer_block_flags(SB.id);
-            auto IsReadOnly  = BufferFlags.get(spv::DecorationNonWritable);
-            auto ResType     = IsReadOnly ?
+            auto ResType = SB.IsReadOnly ?
                 SPIRVShaderResourceAttribs::ResourceType::ROStorageBuffer :
                 SPIRVShaderResourceAttribs::ResourceType::RWStorageBuffer;
             new (&GetSB(CurrSB++))
-                SPIRVShaderResourceAttribs(Compiler,
-                                           SB,
-                                           m_ResourceNames.CopyString(SB.name),
+                SPIRVShaderResourceAttribs(SB,
+                                           m_ResourceNames.CopyString(SB.Name),
                                            ResType);
         }
         VERIFY_EXPR(CurrSB == GetNumSBs());
@@ -358,16 +323,14 @@ SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
 
     {
         Uint32 CurrSmplImg = 0;
-        for (const auto& SmplImg : resources.sampled_images)
+        for (const auto& SmplImg : resources.SampledImages)
         {
-            const auto& type    = Compiler.get_type(SmplImg.type_id);
-            auto        ResType = type.image.dim == spv::DimBuffer ?
+            auto ResType = SmplImg.IsTexelBuffer ?
                 SPIRVShaderResourceAttribs::ResourceType::UniformTexelBuffer :
                 SPIRVShaderResourceAttribs::ResourceType::SampledImage;
             new (&GetSmpldImg(CurrSmplImg++))
-                SPIRVShaderResourceAttribs(Compiler,
-                                           SmplImg,
-                                           m_ResourceNames.CopyString(SmplImg.name),
+                SPIRVShaderResourceAttribs(SmplImg,
+                                           m_ResourceNames.CopyString(SmplImg.Name),
                                            ResType);
         }
         VERIFY_EXPR(CurrSmplImg == GetNumSmpldImgs());
@@ -375,16 +338,14 @@ SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
 
     {
         Uint32 CurrImg = 0;
-        for (const auto& Img : resources.storage_images)
+        for (const auto& Img : resources.StorageImages)
         {
-            const auto& type    = Compiler.get_type(Img.type_id);
-            auto        ResType = type.image.dim == spv::DimBuffer ?
+            auto ResType = Img.IsTexelBuffer ?
                 SPIRVShaderResourceAttribs::ResourceType::StorageTexelBuffer :
                 SPIRVShaderResourceAttribs::ResourceType::StorageImage;
             new (&GetImg(CurrImg++))
-                SPIRVShaderResourceAttribs(Compiler,
-                                           Img,
-                                           m_ResourceNames.CopyString(Img.name),
+                SPIRVShaderResourceAttribs(Img,
+                                           m_ResourceNames.CopyString(Img.Name),
                                            ResType);
         }
         VERIFY_EXPR(CurrImg == GetNumImgs());
@@ -392,12 +353,11 @@ SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
 
     {
         Uint32 CurrAC = 0;
-        for (const auto& AC : resources.atomic_counters)
+        for (const auto& AC : resources.AtomicCounters)
         {
             new (&GetAC(CurrAC++))
-                SPIRVShaderResourceAttribs(Compiler,
-                                           AC,
-                                           m_ResourceNames.CopyString(AC.name),
+                SPIRVShaderResourceAttribs(AC,
+                                           m_ResourceNames.CopyString(AC.Name),
                                            SPIRVShaderResourceAttribs::ResourceType::AtomicCounter);
         }
         VERIFY_EXPR(CurrAC == GetNumACs());
@@ -405,12 +365,11 @@ SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
 
     {
         Uint32 CurrSepSmpl = 0;
-        for (const auto& SepSam : resources.separate_samplers)
+        for (const auto& SepSam : resources.SeparateSamplers)
         {
             new (&GetSepSmplr(CurrSepSmpl++))
-                SPIRVShaderResourceAttribs(Compiler,
-                                           SepSam,
-                                           m_ResourceNames.CopyString(SepSam.name),
+                SPIRVShaderResourceAttribs(SepSam,
+                                           m_ResourceNames.CopyString(SepSam.Name),
                                            SPIRVShaderResourceAttribs::ResourceType::SeparateSampler);
         }
         VERIFY_EXPR(CurrSepSmpl == GetNumSepSmplrs());
@@ -418,10 +377,9 @@ SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
 
     {
         Uint32 CurrSepImg = 0;
-        for (const auto& SepImg : resources.separate_images)
+        for (const auto& SepImg : resources.SeparateImages)
         {
-            const auto& type    = Compiler.get_type(SepImg.type_id);
-            auto        ResType = type.image.dim == spv::DimBuffer ?
+            auto ResType = SepImg.IsTexelBuffer ?
                 SPIRVShaderResourceAttribs::ResourceType::UniformTexelBuffer :
                 SPIRVShaderResourceAttribs::ResourceType::SeparateImage;
 
@@ -432,7 +390,7 @@ SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
                 for (SamplerInd = 0; SamplerInd < NumSepSmpls; ++SamplerInd)
                 {
                     auto& SepSmplr = GetSepSmplr(SamplerInd);
-                    if (StreqSuff(SepSmplr.Name, SepImg.name.c_str(), CombinedSamplerSuffix))
+                    if (StreqSuff(SepSmplr.Name, SepImg.Name, CombinedSamplerSuffix))
                     {
                         SepSmplr.AssignSeparateImage(CurrSepImg);
                         break;
@@ -444,15 +402,14 @@ SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
                 {
                     if (ResType == SPIRVShaderResourceAttribs::ResourceType::UniformTexelBuffer)
                     {
-                        LOG_WARNING_MESSAGE("Combined image sampler assigned to uniform texel buffer '", SepImg.name, "' will be ignored");
+                        LOG_WARNING_MESSAGE("Combined image sampler assigned to uniform texel buffer '", SepImg.Name, "' will be ignored");
                         SamplerInd = SPIRVShaderResourceAttribs::InvalidSepSmplrOrImgInd;
                     }
                 }
             }
             auto* pNewSepImg = new (&GetSepImg(CurrSepImg++))
-                SPIRVShaderResourceAttribs(Compiler,
-                                           SepImg,
-                                           m_ResourceNames.CopyString(SepImg.name),
+                SPIRVShaderResourceAttribs(SepImg,
+                                           m_ResourceNames.CopyString(SepImg.Name),
                                            ResType,
                                            SamplerInd);
             if (ResType == SPIRVShaderResourceAttribs::ResourceType::SeparateImage && pNewSepImg->IsValidSepSamplerAssigned())
@@ -479,13 +436,12 @@ SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
     if (LoadShaderStageInputs)
     {
         Uint32 CurrStageInput = 0;
-        for (const auto& Input : resources.stage_inputs)
+        for (const auto& Input : resources.StageInputs)
         {
-            if (Compiler.has_decoration(Input.id, spv::Decoration::DecorationHlslSemanticGOOGLE))
+            if (Input.HLSLSemantic != nullptr)
             {
-                const auto& Semantic = Compiler.get_decoration_string(Input.id, spv::Decoration::DecorationHlslSemanticGOOGLE);
                 new (&GetShaderStageInputAttribs(CurrStageInput++))
-                    SPIRVShaderStageInputAttribs(m_ResourceNames.CopyString(Semantic), GetDecorationOffset(Compiler, Input, spv::Decoration::DecorationLocation));
+                    SPIRVShaderStageInputAttribs(m_ResourceNames.CopyString(Input.HLSLSemantic), GetDecorationOffset(Input, Input.LocationDecorationOffset));
             }
         }
         VERIFY_EXPR(CurrStageInput == GetNumShaderStageInputs());
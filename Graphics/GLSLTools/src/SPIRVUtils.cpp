@@ -41,6 +41,7 @@
 #include "DebugUtilities.hpp"
 #include "DataBlobImpl.hpp"
 #include "RefCntAutoPtr.hpp"
+#include "HashUtils.hpp"
 
 #include "spirv-tools/optimizer.hpp"
 
@@ -437,21 +438,14 @@ private:
 
 std::vector<unsigned int> HLSLtoSPIRV(const ShaderCreateInfo& Attribs,
                                       const char*             ExtraDefinitions,
-                                      IDataBlob**             ppCompilerOutput)
+                                      IDataBlob**             ppCompilerOutput,
+                                      SPIRVCache*             pCache)
 {
-    EShLanguage      ShLang = ShaderTypeToShLanguage(Attribs.Desc.ShaderType);
-    glslang::TShader Shader{ShLang};
-    EShMessages      messages = (EShMessages)(EShMsgSpvRules | EShMsgVulkanRules | EShMsgReadHlsl | EShMsgHlslLegalization);
+    EShLanguage ShLang   = ShaderTypeToShLanguage(Attribs.Desc.ShaderType);
+    EShMessages messages = (EShMessages)(EShMsgSpvRules | EShMsgVulkanRules | EShMsgReadHlsl | EShMsgHlslLegalization);
 
     VERIFY_EXPR(Attribs.SourceLanguage == SHADER_SOURCE_LANGUAGE_HLSL);
 
-    Shader.setEnvInput(glslang::EShSourceHlsl, ShLang, glslang::EShClientVulkan, 100);
-    Shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_0);
-    Shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_0);
-    Shader.setHlslIoMapping(true);
-    Shader.setEntryPoint(Attribs.EntryPoint);
-    Shader.setEnvTargetHlslFunctionality1();
-
     RefCntAutoPtr<IDataBlob> pFileData(MakeNewRCObj<DataBlobImpl>()(0));
 
     const char* SourceCode    = 0;
@@ -495,15 +489,64 @@ std::vector<unsigned int> HLSLtoSPIRV(const ShaderCreateInfo& Attribs,
             ++pMacro;
         }
     }
-    Shader.setPreamble(Defines.c_str());
 
     const char* ShaderStrings[]       = {SourceCode};
-    const int   ShaderStringLenghts[] = {SourceCodeLen};
+    int         ShaderStringLenghts[] = {SourceCodeLen};
     const char* Names[]               = {Attribs.FilePath != nullptr ? Attribs.FilePath : ""};
-    Shader.setStringsWithLengthsAndNames(ShaderStrings, ShaderStringLenghts, Names, 1);
+    const char* Preamble              = Defines.c_str();
+
+    auto InitShader = [&](glslang::TShader& Shader) {
+        Shader.setEnvInput(glslang::EShSourceHlsl, ShLang, glslang::EShClientVulkan, 100);
+        Shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_0);
+        Shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_0);
+        Shader.setHlslIoMapping(true);
+        Shader.setEntryPoint(Attribs.EntryPoint);
+        Shader.setEnvTargetHlslFunctionality1();
+        Shader.setPreamble(Preamble);
+        Shader.setStringsWithLengthsAndNames(ShaderStrings, ShaderStringLenghts, Names, 1);
+    };
 
     IncluderImpl Includer(Attribs.pShaderSourceStreamFactory);
 
+    SPIRVCache::Key CacheKey;
+    std::string     PreprocessedSource;
+    if (pCache != nullptr)
+    {
+        // Preprocessing resolves includes and macros, so that the key identifies the code that is
+        // actually compiled. Preprocessing is much cheaper than compilation and legalization.
+        // The shader object can't be reused for parsing, so a separate one is used.
+        glslang::TShader PreprocessShader{ShLang};
+        InitShader(PreprocessShader);
+
+        TBuiltInResource Resources = InitResources();
+        if (PreprocessShader.preprocess(&Resources, 100, ENoProfile, false, false, messages, &PreprocessedSource, Includer))
+        {
+            CacheKey = SPIRVCache::MakeKey(ComputeFNVHash(PreprocessedSource.data(), PreprocessedSource.size()),
+                                           PreprocessedSource.size(), Attribs.Desc.ShaderType, SHADER_SOURCE_LANGUAGE_HLSL,
+                                           Attribs.EntryPoint, Defines.c_str(), GetSPIRVCompilerVersion());
+
+            std::vector<unsigned int> SPIRV;
+            if (pCache->Find(CacheKey, SPIRV))
+                return SPIRV;
+
+            // On a miss, the preprocessed source is compiled so that the includes are not
+            // loaded and the macros are not expanded again.
+            SourceCode             = PreprocessedSource.c_str();
+            SourceCodeLen          = static_cast<int>(PreprocessedSource.length());
+            ShaderStrings[0]       = SourceCode;
+            ShaderStringLenghts[0] = SourceCodeLen;
+            Preamble               = "";
+        }
+        else
+        {
+            // Errors are reported by the compilation below
+            pCache = nullptr;
+        }
+    }
+
+    glslang::TShader Shader{ShLang};
+    InitShader(Shader);
+
     auto SPIRV = CompileShaderInternal(Shader, messages, &Includer, SourceCode, SourceCodeLen, ppCompilerOutput);
     if (SPIRV.empty())
         return SPIRV;
@@ -516,6 +559,8 @@ std::vector<unsigned int> HLSLtoSPIRV(const ShaderCreateInfo& Attribs,
     std::vector<uint32_t> LegalizedSPIRV;
     if (SpirvOptimizer.Run(SPIRV.data(), SPIRV.size(), &LegalizedSPIRV))
     {
+        if (pCache != nullptr)
+            pCache->Add(CacheKey, LegalizedSPIRV);
         return std::move(LegalizedSPIRV);
     }
     else
@@ -525,8 +570,22 @@ std::vector<unsigned int> HLSLtoSPIRV(const ShaderCreateInfo& Attribs,
     }
 }
 
-std::vector<unsigned int> GLSLtoSPIRV(const SHADER_TYPE ShaderType, const char* ShaderSource, int SourceCodeLen, IDataBlob** ppCompilerOutput)
+std::vector<unsigned int> GLSLtoSPIRV(const SHADER_TYPE ShaderType, const char* ShaderSource, int SourceCodeLen, IDataBlob** ppCompilerOutput, SPIRVCache* pCache)
 {
+    // GLSL source is compiled without an includer and macros are defined in the source itself,
+    // so the source fully identifies the byte code and does not need to be preprocessed
+    SPIRVCache::Key CacheKey;
+    if (pCache != nullptr)
+    {
+        CacheKey = SPIRVCache::MakeKey(ComputeFNVHash(ShaderSource, static_cast<size_t>(SourceCodeLen)),
+                                       static_cast<size_t>(SourceCodeLen), ShaderType, SHADER_SOURCE_LANGUAGE_GLSL,
+                                       nullptr, nullptr, GetSPIRVCompilerVersion());
+
+        std::vector<unsigned int> SPIRV;
+        if (pCache->Find(CacheKey, SPIRV))
+            return SPIRV;
+    }
+
     EShLanguage      ShLang = ShaderTypeToShLanguage(ShaderType);
     glslang::TShader Shader(ShLang);
 
@@ -543,6 +602,8 @@ std::vector<unsigned int> GLSLtoSPIRV(const SHADER_TYPE ShaderType, const char*
     std::vector<uint32_t> OptimizedSPIRV;
     if (SpirvOptimizer.Run(SPIRV.data(), SPIRV.size(), &OptimizedSPIRV))
     {
+        if (pCache != nullptr && !OptimizedSPIRV.empty())
+            pCache->Add(CacheKey, OptimizedSPIRV);
         return std::move(OptimizedSPIRV);
     }
     else
@@ -552,4 +613,16 @@ std::vector<unsigned int> GLSLtoSPIRV(const SHADER_TYPE ShaderType, const char*
     }
 }
 
+const char* GetSPIRVCompilerVersion()
+{
+    // Must be incremented whenever compilation options or optimization passes change
+    static constexpr int CompilationRevision = 1;
+
+    static const std::string Version =
+        std::string{glslang::GetGlslVersionString()} + ';' +
+        spvSoftwareVersionDetailsString() + ';' +
+        std::to_string(CompilationRevision);
+    return Version.c_str();
+}
+
 } // namespace Diligent
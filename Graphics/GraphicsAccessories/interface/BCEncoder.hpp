@@ -0,0 +1,98 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines block-compression (BC) texture encoder
+
+#include "../../GraphicsEngine/interface/GraphicsTypes.h"
+
+namespace Diligent
+{
+
+/// Block compression quality preset
+enum BC_COMPRESSION_QUALITY : Uint8
+{
+    /// Endpoints are fit to the principal axis of every block without refinement.
+    BC_COMPRESSION_QUALITY_FAST = 0,
+
+    /// Endpoints are refined with least squares. BC7 encoder additionally
+    /// tries the most promising two-subset partitions for opaque blocks.
+    BC_COMPRESSION_QUALITY_NORMAL,
+
+    /// More refinement iterations and encoding modes are tried.
+    BC_COMPRESSION_QUALITY_HIGH
+};
+
+/// Attributes of the CompressTextureBC function
+struct BCCompressAttribs
+{
+    /// Source data format. Must be an 8-bit per component UNORM, UNORM_SRGB or SNORM format
+    /// with 1 to 4 components. SNORM source formats can only be used with SNORM destination
+    /// formats and vice versa.
+    TEXTURE_FORMAT SrcFormat = TEX_FORMAT_RGBA8_UNORM;
+
+    /// Destination block-compressed format: BC1, BC3, BC4, BC5 or BC7.
+    TEXTURE_FORMAT DstFormat = TEX_FORMAT_UNKNOWN;
+
+    /// Texture width, in texels. Does not need to be a multiple of the block width:
+    /// edge texels are replicated to fill partial blocks.
+    Uint32 Width = 0;
+
+    /// Texture height, in texels.
+    Uint32 Height = 0;
+
+    /// Pointer to the source data
+    const void* pSrcData = nullptr;
+
+    /// Source row stride, in bytes
+    size_t SrcStride = 0;
+
+    /// Pointer to the destination data
+    void* pDstData = nullptr;
+
+    /// Stride between the rows of compressed blocks, in bytes
+    size_t DstStride = 0;
+
+    /// Compression quality
+    BC_COMPRESSION_QUALITY Quality = BC_COMPRESSION_QUALITY_NORMAL;
+
+    /// The number of threads to use
+    Uint32 NumThreads = 1;
+};
+
+/// Compresses 2D texture data into one of the block-compressed formats.
+
+/// \return true if the data was compressed successfully, and false otherwise.
+///
+/// \remarks BC1 blocks use the three-color mode with transparent black for blocks
+///          that have texels with alpha less than 128. BC7 encoder uses mode 6 for all
+///          blocks and mode 1 for opaque blocks when quality is not BC_COMPRESSION_QUALITY_FAST.
+bool CompressTextureBC(const BCCompressAttribs& Attribs);
+
+} // namespace Diligent
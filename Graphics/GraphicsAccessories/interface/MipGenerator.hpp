@@ -0,0 +1,127 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines CPU mip level generation utilities
+
+#include <vector>
+
+#include "../../GraphicsEngine/interface/GraphicsTypes.h"
+#include "../../GraphicsEngine/interface/Texture.h"
+
+namespace Diligent
+{
+
+/// Attributes of the ComputeMipLevel function
+struct ComputeMipLevelAttribs
+{
+    /// Texture format
+    TEXTURE_FORMAT Format = TEX_FORMAT_UNKNOWN;
+
+    /// Fine mip level width
+    Uint32 FineMipWidth = 0;
+
+    /// Fine mip level height
+    Uint32 FineMipHeight = 0;
+
+    /// Fine mip level depth. For 3D textures, depth slices are
+    /// downsampled as well. For other textures, this must be 1.
+    Uint32 FineMipDepth = 1;
+
+    /// Pointer to the fine mip level data
+    const void* pFineMipData = nullptr;
+
+    /// Fine mip level row stride, in bytes
+    size_t FineMipStride = 0;
+
+    /// Fine mip level depth slice stride, in bytes
+    size_t FineMipDepthStride = 0;
+
+    /// Pointer to the coarse mip level data
+    void* pCoarseMipData = nullptr;
+
+    /// Coarse mip level row stride, in bytes
+    size_t CoarseMipStride = 0;
+
+    /// Coarse mip level depth slice stride, in bytes
+    size_t CoarseMipDepthStride = 0;
+
+    /// The number of threads to use
+    Uint32 NumThreads = 1;
+};
+
+/// Returns true if ComputeMipLevel() supports the texture format.
+
+/// All uncompressed formats are supported except for the typeless, depth-stencil,
+/// TEX_FORMAT_R1_UNORM and packed 4:2:2 (TEX_FORMAT_RG8_B8G8_UNORM, TEX_FORMAT_G8R8_G8B8_UNORM) formats.
+bool IsCPUMipGenerationSupported(TEXTURE_FORMAT Format);
+
+/// Computes the coarse mip level from the fine one on the CPU.
+
+/// Every coarse texel is the average of the 2x2 (2x2x2 for 3D textures) block of fine texels.
+/// When the fine level dimension is odd, the last fine texel is not used; when it is 1, the
+/// texels are duplicated.
+///
+/// Color components of sRGB formats are averaged in linear space. Integer formats are averaged
+/// in integer arithmetic and the result is rounded to the nearest integer. All other formats are
+/// averaged in 32-bit floating point.
+///
+/// Rows of the coarse level are processed in bands that are distributed between Attribs.NumThreads threads.
+///
+/// \return true if the mip level was computed successfully, and false otherwise.
+bool ComputeMipLevel(const ComputeMipLevelAttribs& Attribs);
+
+/// Generates the mip chain of the texture on the CPU.
+
+/// \param [in]  TexDesc      - Texture description. If TexDesc.MipLevels is 0, the full mip chain is generated.
+/// \param [in]  pTopMipData  - Data of the most detailed mip level of every array slice (TexDesc.ArraySize elements
+///                             for 1D and 2D textures, texture arrays and cube maps; one element for 3D textures).
+///                             The data must reside in CPU memory.
+/// \param [out] MipData      - Storage for the generated mip levels. It must be kept alive until the texture is created.
+/// \param [out] SubResources - Data of every subresource of the texture (array slice-major order) that can
+///                             be directly passed to IRenderDevice::CreateTexture(). Most detailed mip
+///                             levels reference the data in pTopMipData.
+/// \param [in]  NumThreads   - The number of threads to use.
+///
+/// \return true if the mip chain was generated successfully, and false otherwise.
+///
+/// Usage example:
+///
+///     std::vector<Uint8>             MipData;
+///     std::vector<TextureSubResData> SubResources;
+///     GenerateMipChain(TexDesc, &TopMipData, MipData, SubResources);
+///     TextureData InitData{SubResources.data(), static_cast<Uint32>(SubResources.size())};
+///     pDevice->CreateTexture(TexDesc, &InitData, &pTexture);
+bool GenerateMipChain(const TextureDesc&              TexDesc,
+                      const TextureSubResData*        pTopMipData,
+                      std::vector<Uint8>&             MipData,
+                      std::vector<TextureSubResData>& SubResources,
+                      Uint32                          NumThreads = 1);
+
+} // namespace Diligent
@@ -0,0 +1,96 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines CPU pixel format conversion functions
+
+#include "../../GraphicsEngine/interface/GraphicsTypes.h"
+#include "../../../Common/interface/BasicMath.hpp"
+
+namespace Diligent
+{
+
+/// Returns true if pixels of the given format can be decoded and encoded by DecodePixels,
+/// EncodePixels and ConvertPixels.
+
+/// \remarks Block-compressed, depth-stencil and integer formats (except for RGB10A2_UINT) as well as
+///          R1_UNORM, RG8_B8G8_UNORM and G8R8_G8B8_UNORM formats are not supported.
+bool IsPixelFormatConversionSupported(TEXTURE_FORMAT Format);
+
+/// Decodes pixels of the given format into RGBA float values.
+
+/// \param [in]  Format    - Pixel format.
+/// \param [in]  pSrc      - Pointer to the pixel data.
+/// \param [in]  NumPixels - The number of pixels to decode.
+/// \param [out] pDst      - Pointer to the destination RGBA values.
+///
+/// \remarks UNORM and SNORM values are normalized, and sRGB color values are converted to linear space.
+///          Missing color components are set to 0, and missing alpha is set to 1.
+void DecodePixels(TEXTURE_FORMAT Format, const void* pSrc, Uint32 NumPixels, float4* pDst);
+
+/// Encodes RGBA float values into pixels of the given format.
+
+/// \param [in]  Format    - Pixel format.
+/// \param [in]  pSrc      - Pointer to the source RGBA values.
+/// \param [in]  NumPixels - The number of pixels to encode.
+/// \param [out] pDst      - Pointer to the destination pixel data.
+///
+/// \remarks Values are clamped to the range of the format and rounded to the nearest
+///          representable value (ties to even for floating-point formats). Linear color
+///          values are converted to sRGB for sRGB formats.
+void EncodePixels(TEXTURE_FORMAT Format, const float4* pSrc, Uint32 NumPixels, void* pDst);
+
+/// Converts 2D pixel data from one format to another.
+
+/// \param [in]  SrcFormat - Source pixel format.
+/// \param [in]  DstFormat - Destination pixel format.
+/// \param [in]  Width     - Width of the region to convert, in pixels.
+/// \param [in]  Height    - Height of the region to convert, in pixels.
+/// \param [in]  pSrcData  - Pointer to the source data.
+/// \param [in]  SrcStride - Source row stride, in bytes.
+/// \param [out] pDstData  - Pointer to the destination data.
+/// \param [in]  DstStride - Destination row stride, in bytes.
+///
+/// \return true if the conversion is supported, and false otherwise.
+///
+/// \remarks Any two formats for which IsPixelFormatConversionSupported returns true can be converted.
+///          Data of identical formats is copied, which works for any non-compressed format.
+///          Pixels are converted through RGBA float values as described in DecodePixels and
+///          EncodePixels; conversions between 8-bit RGBA and BGRA formats of the same color
+///          space are performed directly.
+bool ConvertPixels(TEXTURE_FORMAT SrcFormat,
+                   TEXTURE_FORMAT DstFormat,
+                   Uint32         Width,
+                   Uint32         Height,
+                   const void*    pSrcData,
+                   size_t         SrcStride,
+                   void*          pDstData,
+                   size_t         DstStride);
+
+} // namespace Diligent
@@ -0,0 +1,1030 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "BCEncoder.hpp"
+#include "GraphicsAccessories.hpp"
+#include "BasicMath.hpp"
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Pixels of a 4x4 block in structure-of-arrays layout: Ch[c][i] is the component c of pixel i.
+// Pixels are numbered in row-major order. Values are in [0, 255] for UNORM formats and [-127, 127]
+// for SNORM formats.
+struct PixelBlock
+{
+    float Ch[4][16];
+};
+
+// Pixel masks have bit i set if pixel i belongs to the mask
+static constexpr Uint32 AllPixelsMask = 0xFFFFu;
+
+// Palette entries are RGBA values; only the channels that are being encoded are used
+using Palette = float[16][4];
+
+class BitWriter
+{
+public:
+    BitWriter(Uint8* pData, size_t Size) :
+        m_pData{pData}
+    {
+        memset(pData, 0, Size);
+    }
+
+    void Write(Uint32 Value, Uint32 NumBits)
+    {
+        for (Uint32 i = 0; i < NumBits; ++i, ++m_Pos)
+            m_pData[m_Pos >> 3u] |= static_cast<Uint8>(((Value >> i) & 1u) << (m_Pos & 7u));
+    }
+
+private:
+    Uint8* const m_pData;
+    Uint32       m_Pos = 0;
+};
+
+// Finds the closest palette entry for every pixel using channels [FirstCh, FirstCh + NumCh).
+// Returns the total squared error of the pixels in the mask.
+float FindClosestEntries(const PixelBlock& Block,
+                         Uint32            FirstCh,
+                         Uint32            NumCh,
+                         const Palette&    Entries,
+                         Uint32            NumEntries,
+                         Uint32            Mask,
+                         Uint8*            Indices)
+{
+    float Errors[16];
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+    // Four pixels are processed at a time
+    for (Uint32 i = 0; i < 16; i += 4)
+    {
+        SIMD::Float4 Pixels[4];
+        for (Uint32 c = 0; c < NumCh; ++c)
+            Pixels[c] = SIMD::Load(&Block.Ch[FirstCh + c][i]);
+
+        auto BestErr = SIMD::Splat(FLT_MAX);
+        auto BestIdx = SIMD::Splat(0.f);
+        for (Uint32 e = 0; e < NumEntries; ++e)
+        {
+            auto Diff = SIMD::Sub(Pixels[0], SIMD::Splat(Entries[e][FirstCh]));
+            auto Err  = SIMD::Mul(Diff, Diff);
+            for (Uint32 c = 1; c < NumCh; ++c)
+            {
+                Diff = SIMD::Sub(Pixels[c], SIMD::Splat(Entries[e][FirstCh + c]));
+                Err  = SIMD::Add(Err, SIMD::Mul(Diff, Diff));
+            }
+
+            const auto IsCloser = SIMD::CmpLT(Err, BestErr);
+
+            BestErr = SIMD::Select(IsCloser, Err, BestErr);
+            BestIdx = SIMD::Select(IsCloser, SIMD::Splat(static_cast<float>(e)), BestIdx);
+        }
+
+        SIMD::Store(&Errors[i], BestErr);
+
+        Int32 Idx[4];
+        SIMD::StoreInt32(Idx, BestIdx);
+        for (Uint32 k = 0; k < 4; ++k)
+            Indices[i + k] = static_cast<Uint8>(Idx[k]);
+    }
+#else
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        Errors[i] = FLT_MAX;
+        for (Uint32 e = 0; e < NumEntries; ++e)
+        {
+            float Err = 0;
+            for (Uint32 c = FirstCh; c < FirstCh + NumCh; ++c)
+            {
+                const auto Diff = Block.Ch[c][i] - Entries[e][c];
+                Err += Diff * Diff;
+            }
+            if (Err < Errors[i])
+            {
+                Errors[i]  = Err;
+                Indices[i] = static_cast<Uint8>(e);
+            }
+        }
+    }
+#endif
+
+    float TotalErr = 0;
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        if (Mask & (1u << i))
+            TotalErr += Errors[i];
+    }
+    return TotalErr;
+}
+
+// Fits the line to the pixels of the mask in the first NumCh channels.
+// The endpoints are the extreme projections of the pixels onto the principal axis.
+// Returns the sum of squared distances from the pixels to the line.
+float FitLine(const PixelBlock& Block, Uint32 NumCh, Uint32 Mask, float E0[4], float E1[4])
+{
+    float  Mean[4]   = {};
+    float  MinVal[4] = {FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX};
+    float  MaxVal[4] = {-FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
+    Uint32 NumPixels = 0;
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        if ((Mask & (1u << i)) == 0)
+            continue;
+        for (Uint32 c = 0; c < NumCh; ++c)
+        {
+            Mean[c] += Block.Ch[c][i];
+            MinVal[c] = std::min(MinVal[c], Block.Ch[c][i]);
+            MaxVal[c] = std::max(MaxVal[c], Block.Ch[c][i]);
+        }
+        ++NumPixels;
+    }
+    VERIFY_EXPR(NumPixels > 0);
+    for (Uint32 c = 0; c < NumCh; ++c)
+        Mean[c] /= static_cast<float>(NumPixels);
+
+    float Cov[4][4] = {};
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        if ((Mask & (1u << i)) == 0)
+            continue;
+        for (Uint32 c0 = 0; c0 < NumCh; ++c0)
+        {
+            for (Uint32 c1 = c0; c1 < NumCh; ++c1)
+                Cov[c0][c1] += (Block.Ch[c0][i] - Mean[c0]) * (Block.Ch[c1][i] - Mean[c1]);
+        }
+    }
+    for (Uint32 c0 = 0; c0 < NumCh; ++c0)
+    {
+        for (Uint32 c1 = 0; c1 < c0; ++c1)
+            Cov[c0][c1] = Cov[c1][c0];
+    }
+
+    // Find the principal axis by power iteration starting from the bounding box diagonal
+    float Axis[4] = {};
+    for (Uint32 c = 0; c < NumCh; ++c)
+        Axis[c] = MaxVal[c] - MinVal[c];
+    for (Uint32 Iter = 0; Iter < 8; ++Iter)
+    {
+        float NewAxis[4] = {};
+        float LenSq      = 0;
+        for (Uint32 c0 = 0; c0 < NumCh; ++c0)
+        {
+            for (Uint32 c1 = 0; c1 < NumCh; ++c1)
+                NewAxis[c0] += Cov[c0][c1] * Axis[c1];
+            LenSq += NewAxis[c0] * NewAxis[c0];
+        }
+        if (LenSq < 1e-12f)
+            break;
+
+        const auto InvLen = 1.f / std::sqrt(LenSq);
+        for (Uint32 c = 0; c < NumCh; ++c)
+            Axis[c] = NewAxis[c] * InvLen;
+    }
+    {
+        float LenSq = 0;
+        for (Uint32 c = 0; c < NumCh; ++c)
+            LenSq += Axis[c] * Axis[c];
+        const auto InvLen = LenSq > 0 ? 1.f / std::sqrt(LenSq) : 0.f;
+        for (Uint32 c = 0; c < NumCh; ++c)
+            Axis[c] *= InvLen;
+    }
+
+    float MinT = FLT_MAX, MaxT = -FLT_MAX;
+    float Residual = 0;
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        if ((Mask & (1u << i)) == 0)
+            continue;
+        float T = 0, DistSq = 0;
+        for (Uint32 c = 0; c < NumCh; ++c)
+        {
+            const auto d = Block.Ch[c][i] - Mean[c];
+            T += d * Axis[c];
+            DistSq += d * d;
+        }
+        MinT = std::min(MinT, T);
+        MaxT = std::max(MaxT, T);
+        Residual += std::max(DistSq - T * T, 0.f);
+    }
+
+    for (Uint32 c = 0; c < 4; ++c)
+    {
+        E0[c] = c < NumCh ? Mean[c] + Axis[c] * MinT : 0;
+        E1[c] = c < NumCh ? Mean[c] + Axis[c] * MaxT : 0;
+    }
+
+    return Residual;
+}
+
+// Finds the endpoints that minimize the squared error of the pixels in the mask given
+// the interpolation weights of their indices. Returns false if the system is degenerate.
+bool RefitEndpoints(const PixelBlock& Block,
+                    Uint32            FirstCh,
+                    Uint32            NumCh,
+                    Uint32            Mask,
+                    const Uint8*      Indices,
+                    const float*      Weights,
+                    float             E0[4],
+                    float             E1[4])
+{
+    float A = 0, B = 0, C = 0;
+    float Rhs0[4] = {}, Rhs1[4] = {};
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        if ((Mask & (1u << i)) == 0)
+            continue;
+
+        const auto w1 = Weights[Indices[i]];
+        const auto w0 = 1.f - w1;
+        A += w0 * w0;
+        B += w0 * w1;
+        C += w1 * w1;
+        for (Uint32 c = FirstCh; c < FirstCh + NumCh; ++c)
+        {
+            Rhs0[c] += w0 * Block.Ch[c][i];
+            Rhs1[c] += w1 * Block.Ch[c][i];
+        }
+    }
+
+    const auto Det = A * C - B * B;
+    if (std::abs(Det) < 1e-6f)
+        return false;
+
+    const auto InvDet = 1.f / Det;
+    for (Uint32 c = FirstCh; c < FirstCh + NumCh; ++c)
+    {
+        E0[c] = (C * Rhs0[c] - B * Rhs1[c]) * InvDet;
+        E1[c] = (A * Rhs1[c] - B * Rhs0[c]) * InvDet;
+    }
+    return true;
+}
+
+inline Uint32 GetNumRefinements(BC_COMPRESSION_QUALITY Quality)
+{
+    switch (Quality)
+    {
+        // clang-format off
+        case BC_COMPRESSION_QUALITY_FAST:   return 0;
+        case BC_COMPRESSION_QUALITY_NORMAL: return 1;
+        case BC_COMPRESSION_QUALITY_HIGH:   return 3;
+        // clang-format on
+        default:
+            UNEXPECTED("Unexpected quality");
+            return 0;
+    }
+}
+
+inline Uint32 QuantizeUNorm(float Value, Uint32 MaxValue)
+{
+    return static_cast<Uint32>(clamp(Value * static_cast<float>(MaxValue) / 255.f + 0.5f, 0.f, static_cast<float>(MaxValue)));
+}
+
+
+// BC1 color block: two RGB 5:6:5 endpoints followed by sixteen 2-bit indices.
+// Four-color mode is used when Color0 > Color1; otherwise the third color is the
+// average of the endpoints, and the fourth is transparent black.
+class BC1ColorEncoder
+{
+public:
+    // For BC3 color blocks (IsBC1 == false), four-color mode is always used.
+    BC1ColorEncoder(const PixelBlock& Block, bool IsBC1, BC_COMPRESSION_QUALITY Quality) :
+        m_Block{Block},
+        m_Quality{Quality}
+    {
+        if (IsBC1)
+        {
+            for (Uint32 i = 0; i < 16; ++i)
+            {
+                if (Block.Ch[3][i] < 128.f)
+                    m_OpaqueMask &= ~(1u << i);
+            }
+        }
+        m_AllowThreeColor = IsBC1;
+    }
+
+    void Encode(Uint8* pDst)
+    {
+        if (m_OpaqueMask == 0)
+        {
+            // All pixels are transparent
+            Write(pDst, 0, 0, nullptr);
+            return;
+        }
+
+        float E0[4], E1[4];
+        FitLine(m_Block, 3, m_OpaqueMask, E0, E1);
+        // The extreme colors are rarely hit exactly, so inset the endpoints
+        for (Uint32 c = 0; c < 3; ++c)
+        {
+            const auto Inset = (E1[c] - E0[c]) / 16.f;
+            E0[c] += Inset;
+            E1[c] -= Inset;
+        }
+
+        if (m_OpaqueMask == AllPixelsMask)
+            EncodeMode(E0, E1, false);
+        if (m_OpaqueMask != AllPixelsMask || (m_AllowThreeColor && m_Quality == BC_COMPRESSION_QUALITY_HIGH))
+            EncodeMode(E0, E1, true);
+
+        Write(pDst, m_Best.Color0, m_Best.Color1, m_Best.Indices);
+    }
+
+private:
+    struct Candidate
+    {
+        float  Error       = FLT_MAX;
+        Uint32 Color0      = 0;
+        Uint32 Color1      = 0;
+        Uint8  Indices[16] = {};
+    };
+
+    static Uint32 QuantizeColor(const float c[4])
+    {
+        return (QuantizeUNorm(c[0], 31) << 11u) | (QuantizeUNorm(c[1], 63) << 5u) | QuantizeUNorm(c[2], 31);
+    }
+
+    static void UnpackColor(Uint32 Color, float c[4])
+    {
+        const auto r = (Color >> 11u) & 0x1Fu;
+        const auto g = (Color >> 5u) & 0x3Fu;
+        const auto b = Color & 0x1Fu;
+
+        c[0] = static_cast<float>((r << 3u) | (r >> 2u));
+        c[1] = static_cast<float>((g << 2u) | (g >> 4u));
+        c[2] = static_cast<float>((b << 3u) | (b >> 2u));
+        c[3] = 255;
+    }
+
+    void EncodeMode(const float InitE0[4], const float InitE1[4], bool ThreeColor)
+    {
+        static constexpr float FourColorWeights[]  = {0, 1, 1.f / 3.f, 2.f / 3.f};
+        static constexpr float ThreeColorWeights[] = {0, 1, 0.5f, 0};
+
+        float E0[4], E1[4];
+        std::copy_n(InitE0, 4, E0);
+        std::copy_n(InitE1, 4, E1);
+
+        const auto NumRefinements = GetNumRefinements(m_Quality);
+        for (Uint32 Iter = 0;; ++Iter)
+        {
+            Candidate Cand;
+            Cand.Color0 = QuantizeColor(E0);
+            Cand.Color1 = QuantizeColor(E1);
+            if (ThreeColor ? Cand.Color0 > Cand.Color1 : Cand.Color0 < Cand.Color1)
+            {
+                std::swap(Cand.Color0, Cand.Color1);
+                std::swap(E0, E1);
+            }
+
+            Palette Entries;
+            UnpackColor(Cand.Color0, Entries[0]);
+            UnpackColor(Cand.Color1, Entries[1]);
+            for (Uint32 c = 0; c < 3; ++c)
+            {
+                if (ThreeColor)
+                {
+                    Entries[2][c] = (Entries[0][c] + Entries[1][c]) * 0.5f;
+                }
+                else
+                {
+                    Entries[2][c] = (Entries[0][c] * 2.f + Entries[1][c]) / 3.f;
+                    Entries[3][c] = (Entries[0][c] + Entries[1][c] * 2.f) / 3.f;
+                }
+            }
+
+            Cand.Error = FindClosestEntries(m_Block, 0, 3, Entries, ThreeColor ? 3 : 4, m_OpaqueMask, Cand.Indices);
+            for (Uint32 i = 0; i < 16; ++i)
+            {
+                if ((m_OpaqueMask & (1u << i)) == 0)
+                    Cand.Indices[i] = 3;
+            }
+
+            if (Cand.Error < m_Best.Error)
+                m_Best = Cand;
+
+            if (Iter == NumRefinements || Cand.Error == 0)
+                break;
+            if (!RefitEndpoints(m_Block, 0, 3, m_OpaqueMask, Cand.Indices, ThreeColor ? ThreeColorWeights : FourColorWeights, E0, E1))
+                break;
+        }
+    }
+
+    static void Write(Uint8* pDst, Uint32 Color0, Uint32 Color1, const Uint8* Indices)
+    {
+        BitWriter Writer{pDst, 8};
+        Writer.Write(Color0, 16);
+        Writer.Write(Color1, 16);
+        for (Uint32 i = 0; i < 16; ++i)
+            Writer.Write(Indices != nullptr ? Indices[i] : 3u, 2);
+    }
+
+    const PixelBlock&            m_Block;
+    const BC_COMPRESSION_QUALITY m_Quality;
+
+    Uint32 m_OpaqueMask      = AllPixelsMask;
+    bool   m_AllowThreeColor = false;
+
+    Candidate m_Best;
+};
+
+
+// BC4 block: two 8-bit endpoints followed by sixteen 3-bit indices.
+// Eight-value mode is used when Value0 > Value1; otherwise six values are interpolated,
+// and the last two values are the minimum and maximum of the range.
+void EncodeBC4Block(const PixelBlock& Block, Uint32 Ch, bool IsSigned, BC_COMPRESSION_QUALITY Quality, Uint8* pDst)
+{
+    const int MinValue = IsSigned ? -127 : 0;
+    const int MaxValue = IsSigned ? 127 : 255;
+
+    int BlockMin = MaxValue, BlockMax = MinValue;
+    // Minimum and maximum of the values that are not at the range limits
+    int InnerMin = MaxValue, InnerMax = MinValue;
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        const auto v = static_cast<int>(std::floor(Block.Ch[Ch][i] + 0.5f));
+        BlockMin     = std::min(BlockMin, v);
+        BlockMax     = std::max(BlockMax, v);
+        if (v != MinValue && v != MaxValue)
+        {
+            InnerMin = std::min(InnerMin, v);
+            InnerMax = std::max(InnerMax, v);
+        }
+    }
+
+    float Best0 = 0, Best1 = 0, BestError = FLT_MAX;
+    Uint8 BestIndices[16];
+
+    auto Evaluate = [&](int v0, int v1) {
+        Palette Entries;
+        Entries[0][Ch] = static_cast<float>(v0);
+        Entries[1][Ch] = static_cast<float>(v1);
+        if (v0 > v1)
+        {
+            for (int k = 2; k < 8; ++k)
+                Entries[k][Ch] = static_cast<float>((8 - k) * v0 + (k - 1) * v1) / 7.f;
+        }
+        else
+        {
+            for (int k = 2; k < 6; ++k)
+                Entries[k][Ch] = static_cast<float>((6 - k) * v0 + (k - 1) * v1) / 5.f;
+            Entries[6][Ch] = static_cast<float>(MinValue);
+            Entries[7][Ch] = static_cast<float>(MaxValue);
+        }
+
+        Uint8      Indices[16];
+        const auto Error = FindClosestEntries(Block, Ch, 1, Entries, 8, AllPixelsMask, Indices);
+        if (Error < BestError)
+        {
+            BestError = Error;
+            Best0     = static_cast<float>(v0);
+            Best1     = static_cast<float>(v1);
+            std::copy_n(Indices, 16, BestIndices);
+        }
+    };
+
+    // Eight-value mode (six-value mode with equal endpoints if all values are the same)
+    Evaluate(BlockMax, BlockMin);
+
+    if (Quality != BC_COMPRESSION_QUALITY_FAST && BestError > 0)
+    {
+        // Six-value mode represents the range limits exactly
+        if (InnerMin <= InnerMax)
+            Evaluate(InnerMin, InnerMax);
+
+        // Try inset endpoints in eight-value mode
+        const int MaxInset = Quality == BC_COMPRESSION_QUALITY_HIGH ? 4 : 1;
+        for (int Inset0 = 0; Inset0 <= MaxInset; ++Inset0)
+        {
+            for (int Inset1 = 0; Inset1 <= MaxInset; ++Inset1)
+            {
+                if ((Inset0 != 0 || Inset1 != 0) && BlockMax - Inset0 > BlockMin + Inset1)
+                    Evaluate(BlockMax - Inset0, BlockMin + Inset1);
+            }
+        }
+    }
+
+    BitWriter Writer{pDst, 8};
+    Writer.Write(static_cast<Uint8>(static_cast<int>(Best0)), 8);
+    Writer.Write(static_cast<Uint8>(static_cast<int>(Best1)), 8);
+    for (Uint32 i = 0; i < 16; ++i)
+        Writer.Write(BestIndices[i], 3);
+}
+
+
+// BC7 two-subset partitions. Bit i is set if pixel i belongs to the second subset.
+// clang-format off
+static constexpr Uint16 BC7Partitions2[64] =
+{
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+    0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+    0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+    0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+    0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+};
+
+// Anchor pixels of the second subset of two-subset partitions
+static constexpr Uint8 BC7AnchorIndices2[64] =
+{
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15,  2,  8,  2,  2,  8,  8, 15,
+     2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15,  6,  8,  2,  8, 15, 15,
+     2,  8,  2,  2,  2, 15, 15,  6,
+     6,  2,  6,  8, 15, 15,  2,  2,
+    15, 15, 15, 15, 15,  2,  2, 15
+};
+
+static constexpr Uint32 BC7Weights3[8]  = {0, 9, 18, 27, 37, 46, 55, 64};
+static constexpr Uint32 BC7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+// clang-format on
+
+inline Uint32 BC7Interpolate(Uint32 e0, Uint32 e1, Uint32 w)
+{
+    return ((64u - w) * e0 + w * e1 + 32u) >> 6u;
+}
+
+class BC7Encoder
+{
+public:
+    BC7Encoder(const PixelBlock& Block, BC_COMPRESSION_QUALITY Quality) :
+        m_Block{Block},
+        m_Quality{Quality}
+    {}
+
+    void Encode(Uint8* pDst)
+    {
+        Mode6Candidate Mode6;
+        EncodeMode6(Mode6);
+
+        bool IsOpaque = true;
+        for (Uint32 i = 0; i < 16 && IsOpaque; ++i)
+            IsOpaque = m_Block.Ch[3][i] >= 255.f;
+
+        if (IsOpaque && m_Quality != BC_COMPRESSION_QUALITY_FAST && Mode6.Error > 0)
+        {
+            Mode1Candidate Mode1;
+            EncodeMode1(Mode1);
+            if (Mode1.Error < Mode6.Error)
+            {
+                WriteMode1(Mode1, pDst);
+                return;
+            }
+        }
+
+        WriteMode6(Mode6, pDst);
+    }
+
+private:
+    // Mode 6: one subset, RGBA 7-bit endpoints with unique p-bits, 4-bit indices
+    struct Mode6Candidate
+    {
+        float  Error       = FLT_MAX;
+        Uint32 Q[2][4]     = {}; // Quantized endpoints
+        Uint32 P[2]        = {}; // P-bits
+        Uint8  Indices[16] = {};
+    };
+
+    // Mode 1: two subsets, RGB 6-bit endpoints with shared p-bits, 3-bit indices
+    struct Mode1Candidate
+    {
+        float  Error       = FLT_MAX;
+        Uint32 Partition   = 0;
+        Uint32 Q[2][2][3]  = {}; // Quantized endpoints of every subset
+        Uint32 P[2]        = {}; // Shared p-bit of every subset
+        Uint8  Indices[16] = {};
+    };
+
+    void EncodeMode6(Mode6Candidate& Best) const
+    {
+        static const auto Weights = []() {
+            std::array<float, 16> w{};
+            for (Uint32 i = 0; i < 16; ++i)
+                w[i] = static_cast<float>(BC7Weights4[i]) / 64.f;
+            return w;
+        }();
+
+        float E[2][4];
+        FitLine(m_Block, 4, AllPixelsMask, E[0], E[1]);
+
+        const auto NumRefinements = GetNumRefinements(m_Quality);
+        for (Uint32 Iter = 0;; ++Iter)
+        {
+            Mode6Candidate IterBest;
+            for (Uint32 PBits = 0; PBits < 4; ++PBits)
+            {
+                Mode6Candidate Cand;
+                Palette        Entries;
+                Uint32         Endpoints[2][4];
+                for (Uint32 e = 0; e < 2; ++e)
+                {
+                    Cand.P[e] = (PBits >> e) & 1u;
+                    for (Uint32 c = 0; c < 4; ++c)
+                    {
+                        const auto q = clamp(static_cast<int>(std::floor((E[e][c] - static_cast<float>(Cand.P[e])) * 0.5f + 0.5f)), 0, 127);
+
+                        Cand.Q[e][c]    = static_cast<Uint32>(q);
+                        Endpoints[e][c] = (Cand.Q[e][c] << 1u) | Cand.P[e];
+                    }
+                }
+                for (Uint32 i = 0; i < 16; ++i)
+                {
+                    for (Uint32 c = 0; c < 4; ++c)
+                        Entries[i][c] = static_cast<float>(BC7Interpolate(Endpoints[0][c], Endpoints[1][c], BC7Weights4[i]));
+                }
+
+                Cand.Error = FindClosestEntries(m_Block, 0, 4, Entries, 16, AllPixelsMask, Cand.Indices);
+                if (Cand.Error < IterBest.Error)
+                    IterBest = Cand;
+            }
+
+            if (IterBest.Error < Best.Error)
+                Best = IterBest;
+
+            if (Iter == NumRefinements || IterBest.Error == 0)
+                break;
+            if (!RefitEndpoints(m_Block, 0, 4, AllPixelsMask, IterBest.Indices, Weights.data(), E[0], E[1]))
+                break;
+        }
+    }
+
+    // Encodes one subset of a mode 1 partition and returns its error
+    float EncodeMode1Subset(Uint32 SubsetMask, Uint32 Q[2][3], Uint32& P, Uint8* Indices) const
+    {
+        static const auto Weights = []() {
+            std::array<float, 8> w{};
+            for (Uint32 i = 0; i < 8; ++i)
+                w[i] = static_cast<float>(BC7Weights3[i]) / 64.f;
+            return w;
+        }();
+
+        float E[2][4];
+        FitLine(m_Block, 3, SubsetMask, E[0], E[1]);
+
+        float BestError = FLT_MAX;
+
+        const auto NumRefinements = GetNumRefinements(m_Quality);
+        for (Uint32 Iter = 0;; ++Iter)
+        {
+            float IterBestError = FLT_MAX;
+            Uint8 IterBestIndices[16];
+            for (Uint32 PBit = 0; PBit < 2; ++PBit)
+            {
+                Palette Entries;
+                Uint32  CandQ[2][3];
+                Uint32  Endpoints[2][3];
+                for (Uint32 e = 0; e < 2; ++e)
+                {
+                    for (Uint32 c = 0; c < 3; ++c)
+                    {
+                        // 6-bit value and the p-bit form a 7-bit value that is expanded to 8 bits
+                        const auto q = clamp(static_cast<int>(std::floor((E[e][c] * 127.f / 255.f - static_cast<float>(PBit)) * 0.5f + 0.5f)), 0, 63);
+
+                        CandQ[e][c]     = static_cast<Uint32>(q);
+                        const auto v7   = (CandQ[e][c] << 1u) | PBit;
+                        Endpoints[e][c] = (v7 << 1u) | (v7 >> 6u);
+                    }
+                }
+                for (Uint32 i = 0; i < 8; ++i)
+                {
+                    for (Uint32 c = 0; c < 3; ++c)
+                        Entries[i][c] = static_cast<float>(BC7Interpolate(Endpoints[0][c], Endpoints[1][c], BC7Weights3[i]));
+                }
+
+                Uint8      CandIndices[16];
+                const auto Error = FindClosestEntries(m_Block, 0, 3, Entries, 8, SubsetMask, CandIndices);
+                if (Error < IterBestError)
+                {
+                    IterBestError = Error;
+                    std::copy_n(CandIndices, 16, IterBestIndices);
+                }
+                if (Error < BestError)
+                {
+                    BestError = Error;
+                    P         = PBit;
+                    memcpy(Q, CandQ, sizeof(CandQ));
+                    for (Uint32 i = 0; i < 16; ++i)
+                    {
+                        if (SubsetMask & (1u << i))
+                            Indices[i] = CandIndices[i];
+                    }
+                }
+            }
+
+            if (Iter == NumRefinements || IterBestError == 0)
+                break;
+            if (!RefitEndpoints(m_Block, 0, 3, SubsetMask, IterBestIndices, Weights.data(), E[0], E[1]))
+                break;
+        }
+
+        return BestError;
+    }
+
+    void EncodeMode1(Mode1Candidate& Best) const
+    {
+        // Estimate the error of every partition by the distances from the pixels to the principal lines
+        // of the subsets, and fully encode the most promising ones.
+        std::pair<float, Uint32> Estimates[64];
+        for (Uint32 p = 0; p < 64; ++p)
+        {
+            const auto Mask1 = Uint32{BC7Partitions2[p]};
+
+            float E0[4], E1[4];
+            Estimates[p] = {FitLine(m_Block, 3, AllPixelsMask & ~Mask1, E0, E1) + FitLine(m_Block, 3, Mask1, E0, E1), p};
+        }
+
+        const Uint32 NumPartitionsToTry = m_Quality == BC_COMPRESSION_QUALITY_HIGH ? 8 : 2;
+        std::partial_sort(Estimates, Estimates + NumPartitionsToTry, Estimates + 64);
+
+        for (Uint32 i = 0; i < NumPartitionsToTry; ++i)
+        {
+            Mode1Candidate Cand;
+            Cand.Partition   = Estimates[i].second;
+            const auto Mask1 = Uint32{BC7Partitions2[Cand.Partition]};
+            Cand.Error       = EncodeMode1Subset(AllPixelsMask & ~Mask1, Cand.Q[0], Cand.P[0], Cand.Indices);
+            if (Cand.Error >= Best.Error)
+                continue;
+            Cand.Error += EncodeMode1Subset(Mask1, Cand.Q[1], Cand.P[1], Cand.Indices);
+            if (Cand.Error < Best.Error)
+                Best = Cand;
+        }
+    }
+
+    static void WriteMode6(Mode6Candidate& Cand, Uint8* pDst)
+    {
+        // The most significant bit of the anchor pixel index must be zero
+        if (Cand.Indices[0] >= 8)
+        {
+            std::swap(Cand.Q[0], Cand.Q[1]);
+            std::swap(Cand.P[0], Cand.P[1]);
+            for (Uint32 i = 0; i < 16; ++i)
+                Cand.Indices[i] = static_cast<Uint8>(15 - Cand.Indices[i]);
+        }
+
+        BitWriter Writer{pDst, 16};
+        Writer.Write(1u << 6u, 7);
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            Writer.Write(Cand.Q[0][c], 7);
+            Writer.Write(Cand.Q[1][c], 7);
+        }
+        Writer.Write(Cand.P[0], 1);
+        Writer.Write(Cand.P[1], 1);
+        for (Uint32 i = 0; i < 16; ++i)
+            Writer.Write(Cand.Indices[i], i == 0 ? 3 : 4);
+    }
+
+    static void WriteMode1(Mode1Candidate& Cand, Uint8* pDst)
+    {
+        const auto   Mask1      = Uint32{BC7Partitions2[Cand.Partition]};
+        const Uint32 Anchors[2] = {0, BC7AnchorIndices2[Cand.Partition]};
+        for (Uint32 s = 0; s < 2; ++s)
+        {
+            // The most significant bit of the anchor pixel index of every subset must be zero
+            if (Cand.Indices[Anchors[s]] < 4)
+                continue;
+
+            std::swap(Cand.Q[s][0], Cand.Q[s][1]);
+            for (Uint32 i = 0; i < 16; ++i)
+            {
+                if (((Mask1 >> i) & 1u) == s)
+                    Cand.Indices[i] = static_cast<Uint8>(7 - Cand.Indices[i]);
+            }
+        }
+
+        BitWriter Writer{pDst, 16};
+        Writer.Write(1u << 1u, 2);
+        Writer.Write(Cand.Partition, 6);
+        for (Uint32 c = 0; c < 3; ++c)
+        {
+            for (Uint32 s = 0; s < 2; ++s)
+            {
+                Writer.Write(Cand.Q[s][0][c], 6);
+                Writer.Write(Cand.Q[s][1][c], 6);
+            }
+        }
+        Writer.Write(Cand.P[0], 1);
+        Writer.Write(Cand.P[1], 1);
+        for (Uint32 i = 0; i < 16; ++i)
+            Writer.Write(Cand.Indices[i], (i == Anchors[0] || i == Anchors[1]) ? 2 : 3);
+    }
+
+    const PixelBlock&            m_Block;
+    const BC_COMPRESSION_QUALITY m_Quality;
+};
+
+
+class TextureCompressor
+{
+public:
+    TextureCompressor(const BCCompressAttribs& Attribs) :
+        m_Attribs{Attribs},
+        m_SrcFmtAttribs{GetTextureFormatAttribs(Attribs.SrcFormat)},
+        m_DstFmtAttribs{GetTextureFormatAttribs(Attribs.DstFormat)},
+        m_NumBlocksX{(Attribs.Width + m_DstFmtAttribs.BlockWidth - 1) / m_DstFmtAttribs.BlockWidth},
+        m_NumBlocksY{(Attribs.Height + m_DstFmtAttribs.BlockHeight - 1) / m_DstFmtAttribs.BlockHeight},
+        m_IsSigned{m_SrcFmtAttribs.ComponentType == COMPONENT_TYPE_SNORM},
+        m_SwapRB{Attribs.SrcFormat == TEX_FORMAT_BGRA8_UNORM || Attribs.SrcFormat == TEX_FORMAT_BGRA8_UNORM_SRGB ||
+                 Attribs.SrcFormat == TEX_FORMAT_BGRX8_UNORM || Attribs.SrcFormat == TEX_FORMAT_BGRX8_UNORM_SRGB},
+        m_IgnoreAlpha{Attribs.SrcFormat == TEX_FORMAT_BGRX8_UNORM || Attribs.SrcFormat == TEX_FORMAT_BGRX8_UNORM_SRGB}
+    {
+        VERIFY(m_DstFmtAttribs.BlockWidth == 4 && m_DstFmtAttribs.BlockHeight == 4, "4x4 blocks are expected");
+    }
+
+    void Execute()
+    {
+        const Uint32 NumThreads = std::min(m_Attribs.NumThreads, m_NumBlocksY);
+
+        std::atomic_uint32_t NextRow{0};
+
+        auto CompressRows = [&]() {
+            for (auto Row = NextRow.fetch_add(1); Row < m_NumBlocksY; Row = NextRow.fetch_add(1))
+                CompressRow(Row);
+        };
+
+        std::vector<std::thread> Threads;
+        for (Uint32 t = 1; t < NumThreads; ++t)
+            Threads.emplace_back(CompressRows);
+        CompressRows();
+        for (auto& Thread : Threads)
+            Thread.join();
+    }
+
+private:
+    void LoadBlock(Uint32 BlockX, Uint32 BlockY, PixelBlock& Block) const
+    {
+        const Uint32 NumComps     = m_SrcFmtAttribs.NumComponents;
+        const float  DefaultAlpha = m_IsSigned ? 127.f : 255.f;
+        for (Uint32 y = 0; y < 4; ++y)
+        {
+            // Edge texels are replicated to fill partial blocks
+            const auto  SrcY = std::min(BlockY * 4 + y, m_Attribs.Height - 1);
+            const auto* pRow = static_cast<const Uint8*>(m_Attribs.pSrcData) + SrcY * m_Attribs.SrcStride;
+            for (Uint32 x = 0; x < 4; ++x)
+            {
+                const auto  SrcX   = std::min(BlockX * 4 + x, m_Attribs.Width - 1);
+                const auto* pTexel = pRow + SrcX * NumComps;
+                const auto  i      = y * 4 + x;
+                for (Uint32 c = 0; c < 4; ++c)
+                {
+                    float Value = c < 3 ? 0.f : DefaultAlpha;
+                    if (c < NumComps && !(c == 3 && m_IgnoreAlpha))
+                        Value = m_IsSigned ? std::max(static_cast<float>(static_cast<Int8>(pTexel[c])), -127.f) : static_cast<float>(pTexel[c]);
+                    Block.Ch[c][i] = Value;
+                }
+                if (m_SwapRB)
+                    std::swap(Block.Ch[0][i], Block.Ch[2][i]);
+            }
+        }
+    }
+
+    void CompressRow(Uint32 BlockY) const
+    {
+        const auto Quality   = m_Attribs.Quality;
+        const auto BlockSize = Uint32{m_DstFmtAttribs.ComponentSize};
+
+        auto* pDstRow = static_cast<Uint8*>(m_Attribs.pDstData) + BlockY * m_Attribs.DstStride;
+        for (Uint32 BlockX = 0; BlockX < m_NumBlocksX; ++BlockX)
+        {
+            PixelBlock Block;
+            LoadBlock(BlockX, BlockY, Block);
+
+            auto* pDst = pDstRow + BlockX * BlockSize;
+            switch (m_Attribs.DstFormat)
+            {
+                case TEX_FORMAT_BC1_UNORM:
+                case TEX_FORMAT_BC1_UNORM_SRGB:
+                    BC1ColorEncoder{Block, true, Quality}.Encode(pDst);
+                    break;
+
+                case TEX_FORMAT_BC3_UNORM:
+                case TEX_FORMAT_BC3_UNORM_SRGB:
+                    EncodeBC4Block(Block, 3, false, Quality, pDst);
+                    BC1ColorEncoder{Block, false, Quality}.Encode(pDst + 8);
+                    break;
+
+                case TEX_FORMAT_BC4_UNORM:
+                case TEX_FORMAT_BC4_SNORM:
+                    EncodeBC4Block(Block, 0, m_IsSigned, Quality, pDst);
+                    break;
+
+                case TEX_FORMAT_BC5_UNORM:
+                case TEX_FORMAT_BC5_SNORM:
+                    EncodeBC4Block(Block, 0, m_IsSigned, Quality, pDst);
+                    EncodeBC4Block(Block, 1, m_IsSigned, Quality, pDst + 8);
+                    break;
+
+                case TEX_FORMAT_BC7_UNORM:
+                case TEX_FORMAT_BC7_UNORM_SRGB:
+                    BC7Encoder{Block, Quality}.Encode(pDst);
+                    break;
+
+                default:
+                    UNEXPECTED("Unexpected format");
+            }
+        }
+    }
+
+    const BCCompressAttribs&    m_Attribs;
+    const TextureFormatAttribs& m_SrcFmtAttribs;
+    const TextureFormatAttribs& m_DstFmtAttribs;
+
+    const Uint32 m_NumBlocksX;
+    const Uint32 m_NumBlocksY;
+
+    const bool m_IsSigned;
+    const bool m_SwapRB;
+    const bool m_IgnoreAlpha;
+};
+
+} // namespace
+
+bool CompressTextureBC(const BCCompressAttribs& Attribs)
+{
+    bool IsDstSigned = false;
+    switch (Attribs.DstFormat)
+    {
+        case TEX_FORMAT_BC1_UNORM:
+        case TEX_FORMAT_BC1_UNORM_SRGB:
+        case TEX_FORMAT_BC3_UNORM:
+        case TEX_FORMAT_BC3_UNORM_SRGB:
+        case TEX_FORMAT_BC4_UNORM:
+        case TEX_FORMAT_BC5_UNORM:
+        case TEX_FORMAT_BC7_UNORM:
+        case TEX_FORMAT_BC7_UNORM_SRGB:
+            break;
+
+        case TEX_FORMAT_BC4_SNORM:
+        case TEX_FORMAT_BC5_SNORM:
+            IsDstSigned = true;
+            break;
+
+        default:
+            LOG_ERROR_MESSAGE("Format ", GetTextureFormatAttribs(Attribs.DstFormat).Name, " is not supported by the BC encoder");
+            return false;
+    }
+
+    const auto& SrcFmtAttribs = GetTextureFormatAttribs(Attribs.SrcFormat);
+    const bool  IsSrcSigned   = SrcFmtAttribs.ComponentType == COMPONENT_TYPE_SNORM;
+    if (SrcFmtAttribs.ComponentSize != 1 ||
+        (SrcFmtAttribs.ComponentType != COMPONENT_TYPE_UNORM && SrcFmtAttribs.ComponentType != COMPONENT_TYPE_UNORM_SRGB && !IsSrcSigned) ||
+        Attribs.SrcFormat == TEX_FORMAT_R1_UNORM || Attribs.SrcFormat == TEX_FORMAT_RG8_B8G8_UNORM || Attribs.SrcFormat == TEX_FORMAT_G8R8_G8B8_UNORM)
+    {
+        LOG_ERROR_MESSAGE("Source format ", SrcFmtAttribs.Name, " is not supported by the BC encoder. 8-bit UNORM, UNORM_SRGB or SNORM format is expected.");
+        return false;
+    }
+    if (IsSrcSigned != IsDstSigned)
+    {
+        LOG_ERROR_MESSAGE("Source format ", SrcFmtAttribs.Name, " and destination format ", GetTextureFormatAttribs(Attribs.DstFormat).Name,
+                          " must both be either SNORM or UNORM");
+        return false;
+    }
+
+    DEV_CHECK_ERR(Attribs.Width > 0 && Attribs.Height > 0, "Texture dimensions must not be zero");
+    DEV_CHECK_ERR(Attribs.pSrcData != nullptr, "Source data must not be null");
+    DEV_CHECK_ERR(Attribs.pDstData != nullptr, "Destination data must not be null");
+
+    TextureCompressor{Attribs}.Execute();
+    return true;
+}
+
+} // namespace Diligent
@@ -0,0 +1,353 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "MipGenerator.hpp"
+#include "PixelFormatConversion.hpp"
+#include "GraphicsAccessories.hpp"
+#include "BasicMath.hpp"
+#include "Align.hpp"
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Integer formats are averaged directly, other formats are averaged in float
+bool IsIntegerFormat(TEXTURE_FORMAT Format)
+{
+    const auto ComponentType = GetTextureFormatAttribs(Format).ComponentType;
+    return ComponentType == COMPONENT_TYPE_SINT || ComponentType == COMPONENT_TYPE_UINT;
+}
+
+// Averages texel pairs of NumRows float rows
+void DownsampleFloatRows(const float4* const* ppRows, Uint32 NumRows, Uint32 FineWidth, float4* pDst, Uint32 CoarseWidth)
+{
+    const float Scale = 1.f / static_cast<float>(NumRows * 2);
+    for (Uint32 x = 0; x < CoarseWidth; ++x)
+    {
+        const auto x0 = std::min(x * 2, FineWidth - 1);
+        const auto x1 = std::min(x * 2 + 1, FineWidth - 1);
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+        auto Sum = SIMD::Add(SIMD::Load(&ppRows[0][x0].x), SIMD::Load(&ppRows[0][x1].x));
+        for (Uint32 r = 1; r < NumRows; ++r)
+            Sum = SIMD::Add(Sum, SIMD::Add(SIMD::Load(&ppRows[r][x0].x), SIMD::Load(&ppRows[r][x1].x)));
+        SIMD::Store(&pDst[x].x, SIMD::Mul(Sum, SIMD::Splat(Scale)));
+#else
+        auto Sum = ppRows[0][x0] + ppRows[0][x1];
+        for (Uint32 r = 1; r < NumRows; ++r)
+            Sum += ppRows[r][x0] + ppRows[r][x1];
+        pDst[x] = Sum * Scale;
+#endif
+    }
+}
+
+// Averages texel pairs of NumRows integer rows and rounds the result to the nearest integer
+template <typename CompType>
+void DownsampleIntRows(const void* const* ppRows, Uint32 NumRows, Uint32 FineWidth, Uint32 NumComponents, void* pDst, Uint32 CoarseWidth)
+{
+    const Int64 NumSamples = NumRows * 2;
+
+    auto* pDstComps = static_cast<CompType*>(pDst);
+    for (Uint32 x = 0; x < CoarseWidth; ++x)
+    {
+        const auto x0 = std::min(x * 2, FineWidth - 1) * NumComponents;
+        const auto x1 = std::min(x * 2 + 1, FineWidth - 1) * NumComponents;
+        for (Uint32 c = 0; c < NumComponents; ++c)
+        {
+            Int64 Sum = NumSamples / 2;
+            for (Uint32 r = 0; r < NumRows; ++r)
+            {
+                const auto* pRow = static_cast<const CompType*>(ppRows[r]);
+                Sum += Int64{pRow[x0 + c]} + Int64{pRow[x1 + c]};
+            }
+            // Round towards negative infinity
+            const auto Avg = Sum >= 0 ? Sum / NumSamples : -((-Sum + NumSamples - 1) / NumSamples);
+
+            pDstComps[x * NumComponents + c] = static_cast<CompType>(Avg);
+        }
+    }
+}
+
+class MipLevelComputer
+{
+public:
+    explicit MipLevelComputer(const ComputeMipLevelAttribs& Attribs) :
+        m_Attribs{Attribs},
+        m_IsInteger{IsIntegerFormat(Attribs.Format)},
+        m_FmtAttribs{GetTextureFormatAttribs(Attribs.Format)},
+        m_CoarseWidth{std::max(Attribs.FineMipWidth >> 1u, 1u)},
+        m_CoarseHeight{std::max(Attribs.FineMipHeight >> 1u, 1u)},
+        m_CoarseDepth{std::max(Attribs.FineMipDepth >> 1u, 1u)},
+        m_NumBandsY{(m_CoarseHeight + RowsPerBand - 1) / RowsPerBand}
+    {}
+
+    void Execute()
+    {
+        const Uint32 NumBands = m_NumBandsY * m_CoarseDepth;
+
+        // Small levels are not worth starting the threads
+        static constexpr Uint32 MinTexelsPerThread = 16384;
+
+        const Uint32 NumThreads = std::min(std::min(m_Attribs.NumThreads, NumBands),
+                                           std::max(m_CoarseWidth * m_CoarseHeight * m_CoarseDepth / MinTexelsPerThread, 1u));
+
+        std::atomic_uint32_t NextBand{0};
+
+        auto ProcessBands = [&]() {
+            ThreadScratch Scratch;
+            for (auto Band = NextBand.fetch_add(1); Band < NumBands; Band = NextBand.fetch_add(1))
+                ProcessBand(Band % m_NumBandsY, Band / m_NumBandsY, Scratch);
+        };
+
+        std::vector<std::thread> Threads;
+        for (Uint32 t = 1; t < NumThreads; ++t)
+            Threads.emplace_back(ProcessBands);
+        ProcessBands();
+        for (auto& Thread : Threads)
+            Thread.join();
+    }
+
+private:
+    static constexpr Uint32 RowsPerBand = 16;
+
+    struct ThreadScratch
+    {
+        std::vector<float4> FineRows[4];
+        std::vector<float4> CoarseRow;
+    };
+
+    const Uint8* GetFineRow(Uint32 y, Uint32 z) const
+    {
+        return static_cast<const Uint8*>(m_Attribs.pFineMipData) + y * m_Attribs.FineMipStride + z * m_Attribs.FineMipDepthStride;
+    }
+
+    void ProcessBand(Uint32 BandY, Uint32 z, ThreadScratch& Scratch) const
+    {
+        const auto NumRows = m_Attribs.FineMipDepth > 1 ? 4u : 2u;
+
+        const auto FineZ0 = std::min(z * 2, m_Attribs.FineMipDepth - 1);
+        const auto FineZ1 = std::min(z * 2 + 1, m_Attribs.FineMipDepth - 1);
+
+        if (!m_IsInteger)
+        {
+            for (Uint32 r = 0; r < NumRows; ++r)
+                Scratch.FineRows[r].resize(m_Attribs.FineMipWidth);
+            Scratch.CoarseRow.resize(m_CoarseWidth);
+        }
+
+        const auto EndY = std::min((BandY + 1) * RowsPerBand, m_CoarseHeight);
+        for (Uint32 y = BandY * RowsPerBand; y < EndY; ++y)
+        {
+            const auto FineY0 = std::min(y * 2, m_Attribs.FineMipHeight - 1);
+            const auto FineY1 = std::min(y * 2 + 1, m_Attribs.FineMipHeight - 1);
+
+            const void* pFineRows[] = {
+                GetFineRow(FineY0, FineZ0),
+                GetFineRow(FineY1, FineZ0),
+                GetFineRow(FineY0, FineZ1),
+                GetFineRow(FineY1, FineZ1) //
+            };
+
+            void* pCoarseRow = static_cast<Uint8*>(m_Attribs.pCoarseMipData) + y * m_Attribs.CoarseMipStride + z * m_Attribs.CoarseMipDepthStride;
+
+            if (m_IsInteger)
+            {
+                const Uint32 NumComps = m_FmtAttribs.NumComponents;
+                const bool   IsSigned = m_FmtAttribs.ComponentType == COMPONENT_TYPE_SINT;
+                switch (m_FmtAttribs.ComponentSize)
+                {
+                    case 1:
+                        if (IsSigned)
+                            DownsampleIntRows<Int8>(pFineRows, NumRows, m_Attribs.FineMipWidth, NumComps, pCoarseRow, m_CoarseWidth);
+                        else
+                            DownsampleIntRows<Uint8>(pFineRows, NumRows, m_Attribs.FineMipWidth, NumComps, pCoarseRow, m_CoarseWidth);
+                        break;
+
+                    case 2:
+                        if (IsSigned)
+                            DownsampleIntRows<Int16>(pFineRows, NumRows, m_Attribs.FineMipWidth, NumComps, pCoarseRow, m_CoarseWidth);
+                        else
+                            DownsampleIntRows<Uint16>(pFineRows, NumRows, m_Attribs.FineMipWidth, NumComps, pCoarseRow, m_CoarseWidth);
+                        break;
+
+                    case 4:
+                        if (IsSigned)
+                            DownsampleIntRows<Int32>(pFineRows, NumRows, m_Attribs.FineMipWidth, NumComps, pCoarseRow, m_CoarseWidth);
+                        else
+                            DownsampleIntRows<Uint32>(pFineRows, NumRows, m_Attribs.FineMipWidth, NumComps, pCoarseRow, m_CoarseWidth);
+                        break;
+
+                    default:
+                        UNEXPECTED("Unexpected component size");
+                }
+            }
+            else
+            {
+                const float4* ppDecodedRows[4];
+                for (Uint32 r = 0; r < NumRows; ++r)
+                {
+                    // Rows are duplicated when the fine level dimension is 1
+                    if (r > 0 && pFineRows[r] == pFineRows[r - 1])
+                    {
+                        ppDecodedRows[r] = ppDecodedRows[r - 1];
+                        continue;
+                    }
+                    DecodePixels(m_Attribs.Format, pFineRows[r], m_Attribs.FineMipWidth, Scratch.FineRows[r].data());
+                    ppDecodedRows[r] = Scratch.FineRows[r].data();
+                }
+
+                DownsampleFloatRows(ppDecodedRows, NumRows, m_Attribs.FineMipWidth, Scratch.CoarseRow.data(), m_CoarseWidth);
+                EncodePixels(m_Attribs.Format, Scratch.CoarseRow.data(), m_CoarseWidth, pCoarseRow);
+            }
+        }
+    }
+
+    const ComputeMipLevelAttribs& m_Attribs;
+    const bool                    m_IsInteger;
+    const TextureFormatAttribs&   m_FmtAttribs;
+
+    const Uint32 m_CoarseWidth;
+    const Uint32 m_CoarseHeight;
+    const Uint32 m_CoarseDepth;
+    const Uint32 m_NumBandsY;
+};
+
+} // namespace
+
+bool IsCPUMipGenerationSupported(TEXTURE_FORMAT Format)
+{
+    return IsIntegerFormat(Format) || IsPixelFormatConversionSupported(Format);
+}
+
+bool ComputeMipLevel(const ComputeMipLevelAttribs& Attribs)
+{
+    if (!IsCPUMipGenerationSupported(Attribs.Format))
+    {
+        LOG_ERROR_MESSAGE("Format ", GetTextureFormatAttribs(Attribs.Format).Name, " is not supported by the CPU mip generator");
+        return false;
+    }
+
+    DEV_CHECK_ERR(Attribs.FineMipWidth > 0 && Attribs.FineMipHeight > 0 && Attribs.FineMipDepth > 0, "Fine mip level dimensions must not be zero");
+    DEV_CHECK_ERR(Attribs.pFineMipData != nullptr, "Fine mip level data must not be null");
+    DEV_CHECK_ERR(Attribs.pCoarseMipData != nullptr, "Coarse mip level data must not be null");
+
+    MipLevelComputer{Attribs}.Execute();
+    return true;
+}
+
+bool GenerateMipChain(const TextureDesc&              TexDesc,
+                      const TextureSubResData*        pTopMipData,
+                      std::vector<Uint8>&             MipData,
+                      std::vector<TextureSubResData>& SubResources,
+                      Uint32                          NumThreads)
+{
+    if (!IsCPUMipGenerationSupported(TexDesc.Format))
+    {
+        LOG_ERROR_MESSAGE("Format ", GetTextureFormatAttribs(TexDesc.Format).Name, " is not supported by the CPU mip generator");
+        return false;
+    }
+    if (TexDesc.Type == RESOURCE_DIM_UNDEFINED || TexDesc.Type == RESOURCE_DIM_BUFFER)
+    {
+        LOG_ERROR_MESSAGE("Resource '", (TexDesc.Name != nullptr ? TexDesc.Name : ""), "' is not a texture");
+        return false;
+    }
+
+    const bool   Is3D      = TexDesc.Type == RESOURCE_DIM_TEX_3D;
+    const Uint32 NumSlices = Is3D ? 1 : TexDesc.ArraySize;
+    const Uint32 MipLevels = TexDesc.MipLevels != 0 ?
+        TexDesc.MipLevels :
+        (Is3D ? ComputeMipLevelsCount(TexDesc.Width, TexDesc.Height, TexDesc.Depth) : ComputeMipLevelsCount(TexDesc.Width, TexDesc.Height));
+
+    DEV_CHECK_ERR(pTopMipData != nullptr, "Top mip level data must not be null");
+    for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+    {
+        DEV_CHECK_ERR(pTopMipData[Slice].pData != nullptr, "Top mip level data of slice ", Slice, " must reside in CPU memory");
+    }
+
+    // Every subresource is aligned by 16 bytes
+    static constexpr size_t SubResAlignment = 16;
+
+    SubResources.resize(size_t{NumSlices} * size_t{MipLevels});
+
+    std::vector<size_t> Offsets(SubResources.size());
+    size_t              DataSize = 0;
+    for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+    {
+        for (Uint32 Mip = 1; Mip < MipLevels; ++Mip)
+        {
+            Offsets[Slice * MipLevels + Mip] = DataSize;
+            DataSize += Align(size_t{GetMipLevelProperties(TexDesc, Mip).MipSize}, SubResAlignment);
+        }
+    }
+    MipData.resize(DataSize);
+
+    for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+    {
+        SubResources[Slice * MipLevels] = pTopMipData[Slice];
+        for (Uint32 Mip = 1; Mip < MipLevels; ++Mip)
+        {
+            const auto MipProps = GetMipLevelProperties(TexDesc, Mip);
+            SubResources[Slice * MipLevels + Mip] =
+                TextureSubResData{&MipData[Offsets[Slice * MipLevels + Mip]], MipProps.RowSize, Is3D ? MipProps.DepthSliceSize : 0};
+        }
+    }
+
+    for (Uint32 Mip = 1; Mip < MipLevels; ++Mip)
+    {
+        const auto FineMipProps = GetMipLevelProperties(TexDesc, Mip - 1);
+        for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+        {
+            const auto& FineSubRes   = SubResources[Slice * MipLevels + Mip - 1];
+            const auto& CoarseSubRes = SubResources[Slice * MipLevels + Mip];
+
+            ComputeMipLevelAttribs Attribs;
+            Attribs.Format               = TexDesc.Format;
+            Attribs.FineMipWidth         = FineMipProps.LogicalWidth;
+            Attribs.FineMipHeight        = FineMipProps.LogicalHeight;
+            Attribs.FineMipDepth         = FineMipProps.Depth;
+            Attribs.pFineMipData         = FineSubRes.pData;
+            Attribs.FineMipStride        = FineSubRes.Stride;
+            Attribs.FineMipDepthStride   = FineSubRes.DepthStride;
+            Attribs.pCoarseMipData       = const_cast<void*>(CoarseSubRes.pData);
+            Attribs.CoarseMipStride      = CoarseSubRes.Stride;
+            Attribs.CoarseMipDepthStride = CoarseSubRes.DepthStride;
+            Attribs.NumThreads           = NumThreads;
+            if (!ComputeMipLevel(Attribs))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace Diligent
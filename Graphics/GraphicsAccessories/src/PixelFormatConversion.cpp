@@ -0,0 +1,848 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "PixelFormatConversion.hpp"
+#include "GraphicsAccessories.hpp"
+#include "ColorConversion.h"
+#include "BasicMathSIMD.hpp"
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+enum PIXEL_CODEC : Uint8
+{
+    PIXEL_CODEC_UNSUPPORTED = 0,
+    PIXEL_CODEC_FLOAT32,
+    PIXEL_CODEC_FLOAT16,
+    PIXEL_CODEC_UNORM8,
+    PIXEL_CODEC_UNORM8_SRGB,
+    PIXEL_CODEC_SNORM8,
+    PIXEL_CODEC_UNORM16,
+    PIXEL_CODEC_SNORM16,
+    PIXEL_CODEC_BGRA8_UNORM,
+    PIXEL_CODEC_BGRA8_UNORM_SRGB,
+    PIXEL_CODEC_RGB10A2_UNORM,
+    PIXEL_CODEC_RGB10A2_UINT,
+    PIXEL_CODEC_R11G11B10_FLOAT,
+    PIXEL_CODEC_RGB9E5_SHAREDEXP,
+    PIXEL_CODEC_B5G6R5_UNORM,
+    PIXEL_CODEC_B5G5R5A1_UNORM,
+    PIXEL_CODEC_R10G10B10_XR_BIAS_A2_UNORM
+};
+
+struct PixelFormatInfo
+{
+    PIXEL_CODEC Codec         = PIXEL_CODEC_UNSUPPORTED;
+    Uint8       NumComponents = 0;
+
+    // Alpha component of BGRX formats is ignored when decoding and set to 1 when encoding
+    bool IgnoreAlpha = false;
+
+    constexpr PixelFormatInfo() noexcept {}
+
+    constexpr PixelFormatInfo(PIXEL_CODEC _Codec, Uint8 _NumComponents, bool _IgnoreAlpha) noexcept :
+        // clang-format off
+        Codec        {_Codec        },
+        NumComponents{_NumComponents},
+        IgnoreAlpha  {_IgnoreAlpha  }
+    // clang-format on
+    {}
+};
+
+PixelFormatInfo GetPixelFormatInfo(TEXTURE_FORMAT Format)
+{
+    switch (Format)
+    {
+        // clang-format off
+        case TEX_FORMAT_BGRA8_UNORM:                return {PIXEL_CODEC_BGRA8_UNORM,                1, false};
+        case TEX_FORMAT_BGRA8_UNORM_SRGB:           return {PIXEL_CODEC_BGRA8_UNORM_SRGB,           1, false};
+        case TEX_FORMAT_BGRX8_UNORM:                return {PIXEL_CODEC_BGRA8_UNORM,                1, true};
+        case TEX_FORMAT_BGRX8_UNORM_SRGB:           return {PIXEL_CODEC_BGRA8_UNORM_SRGB,           1, true};
+        case TEX_FORMAT_RGB10A2_UNORM:              return {PIXEL_CODEC_RGB10A2_UNORM,              1, false};
+        case TEX_FORMAT_RGB10A2_UINT:               return {PIXEL_CODEC_RGB10A2_UINT,               1, false};
+        case TEX_FORMAT_R11G11B10_FLOAT:            return {PIXEL_CODEC_R11G11B10_FLOAT,            1, false};
+        case TEX_FORMAT_RGB9E5_SHAREDEXP:           return {PIXEL_CODEC_RGB9E5_SHAREDEXP,           1, false};
+        case TEX_FORMAT_B5G6R5_UNORM:               return {PIXEL_CODEC_B5G6R5_UNORM,               1, false};
+        case TEX_FORMAT_B5G5R5A1_UNORM:             return {PIXEL_CODEC_B5G5R5A1_UNORM,             1, false};
+        case TEX_FORMAT_R10G10B10_XR_BIAS_A2_UNORM: return {PIXEL_CODEC_R10G10B10_XR_BIAS_A2_UNORM, 1, false};
+            // clang-format on
+
+        // R1 is a bit-packed format; RG8_B8G8 and G8R8_G8B8 store two texels in four components
+        case TEX_FORMAT_R1_UNORM:
+        case TEX_FORMAT_RG8_B8G8_UNORM:
+        case TEX_FORMAT_G8R8_G8B8_UNORM:
+            return {};
+
+        default:
+            break;
+    }
+
+    const auto& FmtAttribs = GetTextureFormatAttribs(Format);
+
+    PixelFormatInfo Info;
+    Info.NumComponents = FmtAttribs.NumComponents;
+    switch (FmtAttribs.ComponentType)
+    {
+        case COMPONENT_TYPE_FLOAT:
+        case COMPONENT_TYPE_DEPTH:
+            if (FmtAttribs.ComponentSize == 4)
+                Info.Codec = PIXEL_CODEC_FLOAT32;
+            else if (FmtAttribs.ComponentSize == 2)
+                Info.Codec = FmtAttribs.ComponentType == COMPONENT_TYPE_DEPTH ? PIXEL_CODEC_UNORM16 : PIXEL_CODEC_FLOAT16;
+            break;
+
+        case COMPONENT_TYPE_UNORM:
+            if (FmtAttribs.ComponentSize == 1)
+                Info.Codec = PIXEL_CODEC_UNORM8;
+            else if (FmtAttribs.ComponentSize == 2)
+                Info.Codec = PIXEL_CODEC_UNORM16;
+            break;
+
+        case COMPONENT_TYPE_UNORM_SRGB:
+            if (FmtAttribs.ComponentSize == 1)
+                Info.Codec = PIXEL_CODEC_UNORM8_SRGB;
+            break;
+
+        case COMPONENT_TYPE_SNORM:
+            if (FmtAttribs.ComponentSize == 1)
+                Info.Codec = PIXEL_CODEC_SNORM8;
+            else if (FmtAttribs.ComponentSize == 2)
+                Info.Codec = PIXEL_CODEC_SNORM16;
+            break;
+
+        default:
+            break;
+    }
+
+    return Info;
+}
+
+// Pixel format information for every format is computed once
+class PixelFormatInfoTable
+{
+public:
+    PixelFormatInfoTable() noexcept
+    {
+        for (Uint32 Fmt = TEX_FORMAT_UNKNOWN; Fmt < TEX_FORMAT_NUM_FORMATS; ++Fmt)
+            m_Infos[Fmt] = GetPixelFormatInfo(static_cast<TEXTURE_FORMAT>(Fmt));
+    }
+
+    const PixelFormatInfo& operator[](TEXTURE_FORMAT Format) const
+    {
+        VERIFY_EXPR(Format < TEX_FORMAT_NUM_FORMATS);
+        return m_Infos[Format];
+    }
+
+private:
+    std::array<PixelFormatInfo, TEX_FORMAT_NUM_FORMATS> m_Infos;
+};
+
+const PixelFormatInfo& GetCachedPixelFormatInfo(TEXTURE_FORMAT Format)
+{
+    static const PixelFormatInfoTable Table;
+    return Table[Format];
+}
+
+
+// Converts 32-bit float to the float with 5-bit exponent and MantissaBits-bit mantissa:
+// 16-bit half float when HasSign is true, or unsigned 11-bit and 10-bit floats of R11G11B10_FLOAT format.
+// The result is rounded to the nearest value, ties to even.
+inline Uint32 FloatToSmallFloat(float f, Uint32 MantissaBits, bool HasSign)
+{
+    Uint32 Bits;
+    memcpy(&Bits, &f, sizeof(Bits));
+
+    const Uint32 Sign    = HasSign ? (Bits >> 31u) << (MantissaBits + 5u) : 0;
+    const Uint32 ExpMask = 0x1Fu << MantissaBits;
+
+    Uint32 Abs = Bits & 0x7FFFFFFFu;
+    if (Abs > 0x7F800000u)
+        return ExpMask | (1u << (MantissaBits - 1u)); // NaN
+
+    if (!HasSign && (Bits >> 31u) != 0)
+        return 0; // Negative values are clamped to zero
+
+    if (Abs >= (127u + 16u) << 23u)
+        return Sign | ExpMask; // Inf
+
+    if (Abs < (127u - 14u) << 23u)
+    {
+        // Denormal. Adding the value whose ULP is the smallest denormal aligns the mantissa
+        // bits at the bottom of the float, and the addition rounds to nearest even.
+        const Uint32 MagicBits = (127u - 15u + 23u - MantissaBits + 1u) << 23u;
+
+        float Magic, Val;
+        memcpy(&Magic, &MagicBits, sizeof(Magic));
+        memcpy(&Val, &Abs, sizeof(Val));
+        Val += Magic;
+        memcpy(&Abs, &Val, sizeof(Abs));
+        return Sign | (Abs - MagicBits);
+    }
+
+    // Rebias the exponent and round to nearest even. Mantissa overflow after rounding
+    // correctly increments the exponent.
+    const Uint32 Shift       = 23u - MantissaBits;
+    const Uint32 MantissaOdd = (Abs >> Shift) & 1u;
+    Abs -= (127u - 15u) << 23u;
+    Abs += (1u << (Shift - 1u)) - 1u + MantissaOdd;
+    return Sign | (Abs >> Shift);
+}
+
+inline float SmallFloatToFloat(Uint32 Value, Uint32 MantissaBits, bool HasSign)
+{
+    // Place the exponent and mantissa bits into the float and rescale it: multiplication by 2^(127 - 15)
+    // rebiases the exponent and also normalizes denormals.
+    Uint32 Bits = (Value & ((1u << (MantissaBits + 5u)) - 1u)) << (23u - MantissaBits);
+
+    float f;
+    memcpy(&f, &Bits, sizeof(f));
+    f *= 5.192296858534828e+33f; // 2^112
+    memcpy(&Bits, &f, sizeof(Bits));
+
+    // Inf and NaN
+    if (f >= 65536.f)
+        Bits |= 0x7F800000u;
+
+    if (HasSign)
+        Bits |= ((Value >> (MantissaBits + 5u)) & 1u) << 31u;
+
+    memcpy(&f, &Bits, sizeof(f));
+    return f;
+}
+
+inline float UNormToFloat(Uint32 Value, Uint32 MaxValue)
+{
+    return static_cast<float>(Value) / static_cast<float>(MaxValue);
+}
+
+inline Uint32 FloatToUNorm(float f, Uint32 MaxValue)
+{
+    return static_cast<Uint32>(clamp(f, 0.f, 1.f) * static_cast<float>(MaxValue) + 0.5f);
+}
+
+inline float SNormToFloat(Int32 Value, Int32 MaxValue)
+{
+    return std::max(static_cast<float>(Value) / static_cast<float>(MaxValue), -1.f);
+}
+
+inline Int32 FloatToSNorm(float f, Int32 MaxValue)
+{
+    const auto Scaled = clamp(f, -1.f, 1.f) * static_cast<float>(MaxValue);
+    return static_cast<Int32>(Scaled >= 0 ? Scaled + 0.5f : Scaled - 0.5f);
+}
+
+inline Uint32 FloatToUInt(float f, Uint32 MaxValue)
+{
+    return static_cast<Uint32>(clamp(f, 0.f, static_cast<float>(MaxValue)) + 0.5f);
+}
+
+
+// Maps 8-bit UNORM values to float values
+class UNorm8ToFloatMap
+{
+public:
+    UNorm8ToFloatMap() noexcept
+    {
+        for (Uint32 i = 0; i < m_ToFloat.size(); ++i)
+            m_ToFloat[i] = UNormToFloat(i, 255);
+    }
+
+    float operator()(Uint8 x) const
+    {
+        return m_ToFloat[x];
+    }
+
+private:
+    std::array<float, 256> m_ToFloat;
+};
+
+// Maps 8-bit sRGB values to linear values
+class SRGB8ToLinearMap
+{
+public:
+    SRGB8ToLinearMap() noexcept
+    {
+        for (Uint32 i = 0; i < m_ToLinear.size(); ++i)
+            m_ToLinear[i] = SRGBToLinear(static_cast<Uint8>(i));
+    }
+
+    float operator()(Uint8 x) const
+    {
+        return m_ToLinear[x];
+    }
+
+private:
+    std::array<float, 256> m_ToLinear;
+};
+
+// Converts linear value to 8-bit sRGB value by comparing it with the linear values that
+// correspond to the midpoints between adjacent sRGB values. The search starts from the
+// sRGB value looked up by the exponent and the upper mantissa bits of the linear value,
+// and takes at most two comparisons.
+class LinearToSRGB8Map
+{
+public:
+    LinearToSRGB8Map() noexcept
+    {
+        for (Uint32 i = 0; i < m_Thresholds.size(); ++i)
+            m_Thresholds[i] = SRGBToLinear((static_cast<float>(i) + 0.5f) / 255.f);
+
+        for (Uint32 Bucket = 0; Bucket < m_BucketStart.size(); ++Bucket)
+        {
+            const Uint32 Bits = (Bucket + MinBucket) << BucketShift;
+
+            float x;
+            memcpy(&x, &Bits, sizeof(x));
+
+            Uint32 i = 0;
+            for (Uint32 Step = 128; Step > 0; Step >>= 1)
+                i += x >= m_Thresholds[i + Step - 1] ? Step : 0;
+            m_BucketStart[Bucket] = static_cast<Uint8>(i);
+        }
+    }
+
+    Uint8 operator()(float x) const
+    {
+        // Linear values below 2^-13 map to 0. This also handles negative values and NaNs.
+        if (!(x >= MinValue))
+            return 0;
+        if (x >= 1.f)
+            return 255;
+
+        Uint32 Bits;
+        memcpy(&Bits, &x, sizeof(Bits));
+
+        Uint32 i = m_BucketStart[(Bits >> BucketShift) - MinBucket];
+        while (i < 255 && x >= m_Thresholds[i])
+            ++i;
+        return static_cast<Uint8>(i);
+    }
+
+private:
+    // Buckets are indexed by the exponent and the upper 7 bits of the mantissa
+    static constexpr Uint32 BucketShift = 16;
+    static constexpr Uint32 MinBucket   = (127u - 13u) << (23u - BucketShift);
+    static constexpr Uint32 MaxBucket   = 127u << (23u - BucketShift);
+    static constexpr float  MinValue    = 1.f / 8192.f;
+
+    std::array<float, 255>                   m_Thresholds;
+    std::array<Uint8, MaxBucket - MinBucket> m_BucketStart;
+};
+
+
+template <typename CompType, Uint32 NumComponents, typename DecodeFuncType>
+void DecodeComponents(const void* pSrc, Uint32 Width, float4* pDst, DecodeFuncType Decode)
+{
+    const auto* pComps = static_cast<const CompType*>(pSrc);
+    for (Uint32 x = 0; x < Width; ++x, pComps += NumComponents)
+    {
+        float4 Texel{0, 0, 0, 1};
+        for (Uint32 c = 0; c < NumComponents; ++c)
+            Texel[c] = Decode(pComps[c], c);
+        pDst[x] = Texel;
+    }
+}
+
+template <typename CompType, typename DecodeFuncType>
+void DecodeComponents(const void* pSrc, Uint32 Width, Uint32 NumComponents, float4* pDst, DecodeFuncType Decode)
+{
+    switch (NumComponents)
+    {
+        // clang-format off
+        case 1: DecodeComponents<CompType, 1>(pSrc, Width, pDst, Decode); break;
+        case 2: DecodeComponents<CompType, 2>(pSrc, Width, pDst, Decode); break;
+        case 3: DecodeComponents<CompType, 3>(pSrc, Width, pDst, Decode); break;
+        case 4: DecodeComponents<CompType, 4>(pSrc, Width, pDst, Decode); break;
+        // clang-format on
+        default:
+            UNEXPECTED("Unexpected number of components");
+    }
+}
+
+template <typename CompType, Uint32 NumComponents, typename EncodeFuncType>
+void EncodeComponents(const float4* pSrc, Uint32 Width, void* pDst, EncodeFuncType Encode)
+{
+    auto* pComps = static_cast<CompType*>(pDst);
+    for (Uint32 x = 0; x < Width; ++x, pComps += NumComponents)
+    {
+        for (Uint32 c = 0; c < NumComponents; ++c)
+            pComps[c] = static_cast<CompType>(Encode(pSrc[x][c], c));
+    }
+}
+
+template <typename CompType, typename EncodeFuncType>
+void EncodeComponents(const float4* pSrc, Uint32 Width, Uint32 NumComponents, void* pDst, EncodeFuncType Encode)
+{
+    switch (NumComponents)
+    {
+        // clang-format off
+        case 1: EncodeComponents<CompType, 1>(pSrc, Width, pDst, Encode); break;
+        case 2: EncodeComponents<CompType, 2>(pSrc, Width, pDst, Encode); break;
+        case 3: EncodeComponents<CompType, 3>(pSrc, Width, pDst, Encode); break;
+        case 4: EncodeComponents<CompType, 4>(pSrc, Width, pDst, Encode); break;
+        // clang-format on
+        default:
+            UNEXPECTED("Unexpected number of components");
+    }
+}
+
+template <typename TexelType, typename DecodeFuncType>
+void DecodeTexels(const void* pSrc, Uint32 Width, float4* pDst, DecodeFuncType Decode)
+{
+    const auto* pTexels = static_cast<const TexelType*>(pSrc);
+    for (Uint32 x = 0; x < Width; ++x)
+        pDst[x] = Decode(pTexels[x]);
+}
+
+template <typename TexelType, typename EncodeFuncType>
+void EncodeTexels(const float4* pSrc, Uint32 Width, void* pDst, EncodeFuncType Encode)
+{
+    auto* pTexels = static_cast<TexelType*>(pDst);
+    for (Uint32 x = 0; x < Width; ++x)
+        pTexels[x] = static_cast<TexelType>(Encode(pSrc[x]));
+}
+
+// Encodes RGBA float texels as 8-bit UNORM values. When SwapRB is true, the texels are stored in BGRA order.
+void EncodeUNorm8x4(const float4* pSrc, Uint32 Width, bool SwapRB, bool IgnoreAlpha, void* pDst)
+{
+    auto*        pComps = static_cast<Uint8*>(pDst);
+    const Uint32 R      = SwapRB ? 2 : 0;
+    const Uint32 B      = SwapRB ? 0 : 2;
+#if DILIGENT_MATH_SIMD != DILIGENT_MATH_SIMD_NONE
+    const auto Zero  = SIMD::Splat(0.f);
+    const auto One   = SIMD::Splat(1.f);
+    const auto Scale = SIMD::Splat(255.f);
+    const auto Half  = SIMD::Splat(0.5f);
+    for (Uint32 x = 0; x < Width; ++x, pComps += 4)
+    {
+        const auto Texel = SIMD::Min(SIMD::Max(SIMD::Load(&pSrc[x].x), Zero), One);
+
+        Int32 Values[4];
+        SIMD::StoreInt32(Values, SIMD::Add(SIMD::Mul(Texel, Scale), Half));
+        pComps[R] = static_cast<Uint8>(Values[0]);
+        pComps[1] = static_cast<Uint8>(Values[1]);
+        pComps[B] = static_cast<Uint8>(Values[2]);
+        pComps[3] = IgnoreAlpha ? Uint8{255} : static_cast<Uint8>(Values[3]);
+    }
+#else
+    for (Uint32 x = 0; x < Width; ++x, pComps += 4)
+    {
+        pComps[R] = static_cast<Uint8>(FloatToUNorm(pSrc[x].x, 255));
+        pComps[1] = static_cast<Uint8>(FloatToUNorm(pSrc[x].y, 255));
+        pComps[B] = static_cast<Uint8>(FloatToUNorm(pSrc[x].z, 255));
+        pComps[3] = IgnoreAlpha ? Uint8{255} : static_cast<Uint8>(FloatToUNorm(pSrc[x].w, 255));
+    }
+#endif
+}
+
+// Encodes linear RGBA float texels as 8-bit sRGB values; alpha is always linear.
+void EncodeSRGB8x4(const float4* pSrc, Uint32 Width, bool SwapRB, bool IgnoreAlpha, void* pDst)
+{
+    static const LinearToSRGB8Map ToSRGB8;
+
+    auto*        pComps = static_cast<Uint8*>(pDst);
+    const Uint32 R      = SwapRB ? 2 : 0;
+    const Uint32 B      = SwapRB ? 0 : 2;
+    for (Uint32 x = 0; x < Width; ++x, pComps += 4)
+    {
+        pComps[R] = ToSRGB8(pSrc[x].x);
+        pComps[1] = ToSRGB8(pSrc[x].y);
+        pComps[B] = ToSRGB8(pSrc[x].z);
+        pComps[3] = IgnoreAlpha ? Uint8{255} : static_cast<Uint8>(FloatToUNorm(pSrc[x].w, 255));
+    }
+}
+
+void DecodeRow(const PixelFormatInfo& Info, const void* pSrc, Uint32 Width, float4* pDst)
+{
+    switch (Info.Codec)
+    {
+        case PIXEL_CODEC_FLOAT32:
+            DecodeComponents<float>(pSrc, Width, Info.NumComponents, pDst, [](float v, Uint32) { return v; });
+            break;
+
+        case PIXEL_CODEC_FLOAT16:
+            DecodeComponents<Uint16>(pSrc, Width, Info.NumComponents, pDst, [](Uint16 v, Uint32) { return SmallFloatToFloat(v, 10, true); });
+            break;
+
+        case PIXEL_CODEC_UNORM8:
+        {
+            static const UNorm8ToFloatMap ToFloat;
+            DecodeComponents<Uint8>(pSrc, Width, Info.NumComponents, pDst, [](Uint8 v, Uint32) { return ToFloat(v); });
+            break;
+        }
+
+        case PIXEL_CODEC_UNORM8_SRGB:
+        {
+            static const SRGB8ToLinearMap ToLinear;
+            static const UNorm8ToFloatMap ToFloat;
+            // Alpha is always linear
+            DecodeComponents<Uint8>(pSrc, Width, Info.NumComponents, pDst, [](Uint8 v, Uint32 c) { return c < 3 ? ToLinear(v) : ToFloat(v); });
+            break;
+        }
+
+        case PIXEL_CODEC_SNORM8:
+            DecodeComponents<Int8>(pSrc, Width, Info.NumComponents, pDst, [](Int8 v, Uint32) { return SNormToFloat(v, 127); });
+            break;
+
+        case PIXEL_CODEC_UNORM16:
+            DecodeComponents<Uint16>(pSrc, Width, Info.NumComponents, pDst, [](Uint16 v, Uint32) { return UNormToFloat(v, 65535); });
+            break;
+
+        case PIXEL_CODEC_SNORM16:
+            DecodeComponents<Int16>(pSrc, Width, Info.NumComponents, pDst, [](Int16 v, Uint32) { return SNormToFloat(v, 32767); });
+            break;
+
+        case PIXEL_CODEC_BGRA8_UNORM:
+        {
+            static const UNorm8ToFloatMap ToFloat;
+            const auto                    IgnoreAlpha = Info.IgnoreAlpha;
+            DecodeTexels<Uint32>(pSrc, Width, pDst, [IgnoreAlpha](Uint32 v) {
+                return float4{ToFloat((v >> 16u) & 0xFFu), ToFloat((v >> 8u) & 0xFFu), ToFloat(v & 0xFFu), IgnoreAlpha ? 1.f : ToFloat(v >> 24u)};
+            });
+            break;
+        }
+
+        case PIXEL_CODEC_BGRA8_UNORM_SRGB:
+        {
+            static const SRGB8ToLinearMap ToLinear;
+            static const UNorm8ToFloatMap ToFloat;
+            const auto                    IgnoreAlpha = Info.IgnoreAlpha;
+            DecodeTexels<Uint32>(pSrc, Width, pDst, [IgnoreAlpha](Uint32 v) {
+                return float4{ToLinear((v >> 16u) & 0xFFu), ToLinear((v >> 8u) & 0xFFu), ToLinear(v & 0xFFu), IgnoreAlpha ? 1.f : ToFloat(v >> 24u)};
+            });
+            break;
+        }
+
+        case PIXEL_CODEC_RGB10A2_UNORM:
+            DecodeTexels<Uint32>(pSrc, Width, pDst, [](Uint32 v) {
+                return float4{UNormToFloat(v & 0x3FFu, 1023), UNormToFloat((v >> 10u) & 0x3FFu, 1023), UNormToFloat((v >> 20u) & 0x3FFu, 1023), UNormToFloat(v >> 30u, 3)};
+            });
+            break;
+
+        case PIXEL_CODEC_RGB10A2_UINT:
+            DecodeTexels<Uint32>(pSrc, Width, pDst, [](Uint32 v) {
+                return float4{static_cast<float>(v & 0x3FFu), static_cast<float>((v >> 10u) & 0x3FFu), static_cast<float>((v >> 20u) & 0x3FFu), static_cast<float>(v >> 30u)};
+            });
+            break;
+
+        case PIXEL_CODEC_R11G11B10_FLOAT:
+            DecodeTexels<Uint32>(pSrc, Width, pDst, [](Uint32 v) {
+                return float4{SmallFloatToFloat(v & 0x7FFu, 6, false), SmallFloatToFloat((v >> 11u) & 0x7FFu, 6, false), SmallFloatToFloat(v >> 22u, 5, false), 1};
+            });
+            break;
+
+        case PIXEL_CODEC_RGB9E5_SHAREDEXP:
+            DecodeTexels<Uint32>(pSrc, Width, pDst, [](Uint32 v) {
+                const auto Scale = std::ldexp(1.f, static_cast<int>(v >> 27u) - 15 - 9);
+                return float4{static_cast<float>(v & 0x1FFu) * Scale, static_cast<float>((v >> 9u) & 0x1FFu) * Scale, static_cast<float>((v >> 18u) & 0x1FFu) * Scale, 1};
+            });
+            break;
+
+        case PIXEL_CODEC_B5G6R5_UNORM:
+            DecodeTexels<Uint16>(pSrc, Width, pDst, [](Uint16 v) {
+                return float4{UNormToFloat(v >> 11u, 31), UNormToFloat((v >> 5u) & 0x3Fu, 63), UNormToFloat(v & 0x1Fu, 31), 1};
+            });
+            break;
+
+        case PIXEL_CODEC_B5G5R5A1_UNORM:
+            DecodeTexels<Uint16>(pSrc, Width, pDst, [](Uint16 v) {
+                return float4{UNormToFloat((v >> 10u) & 0x1Fu, 31), UNormToFloat((v >> 5u) & 0x1Fu, 31), UNormToFloat(v & 0x1Fu, 31), UNormToFloat(v >> 15u, 1)};
+            });
+            break;
+
+        case PIXEL_CODEC_R10G10B10_XR_BIAS_A2_UNORM:
+            // Color components use the fixed point extended range encoding: (value - 384) / 510
+            DecodeTexels<Uint32>(pSrc, Width, pDst, [](Uint32 v) {
+                auto XRBiasToFloat = [](Uint32 c) {
+                    return (static_cast<float>(c) - 384.f) / 510.f;
+                };
+                return float4{XRBiasToFloat(v & 0x3FFu), XRBiasToFloat((v >> 10u) & 0x3FFu), XRBiasToFloat((v >> 20u) & 0x3FFu), UNormToFloat(v >> 30u, 3)};
+            });
+            break;
+
+        default:
+            UNEXPECTED("Unexpected codec");
+    }
+}
+
+void EncodeRow(const PixelFormatInfo& Info, const float4* pSrc, Uint32 Width, void* pDst)
+{
+    switch (Info.Codec)
+    {
+        case PIXEL_CODEC_FLOAT32:
+            EncodeComponents<float>(pSrc, Width, Info.NumComponents, pDst, [](float f, Uint32) { return f; });
+            break;
+
+        case PIXEL_CODEC_FLOAT16:
+            EncodeComponents<Uint16>(pSrc, Width, Info.NumComponents, pDst, [](float f, Uint32) { return FloatToSmallFloat(f, 10, true); });
+            break;
+
+        case PIXEL_CODEC_UNORM8:
+            if (Info.NumComponents == 4)
+                EncodeUNorm8x4(pSrc, Width, false, false, pDst);
+            else
+                EncodeComponents<Uint8>(pSrc, Width, Info.NumComponents, pDst, [](float f, Uint32) { return FloatToUNorm(f, 255); });
+            break;
+
+        case PIXEL_CODEC_UNORM8_SRGB:
+            if (Info.NumComponents == 4)
+            {
+                EncodeSRGB8x4(pSrc, Width, false, false, pDst);
+            }
+            else
+            {
+                static const LinearToSRGB8Map ToSRGB8;
+                EncodeComponents<Uint8>(pSrc, Width, Info.NumComponents, pDst, [](float f, Uint32 c) { return c < 3 ? ToSRGB8(f) : FloatToUNorm(f, 255); });
+            }
+            break;
+
+        case PIXEL_CODEC_SNORM8:
+            EncodeComponents<Int8>(pSrc, Width, Info.NumComponents, pDst, [](float f, Uint32) { return FloatToSNorm(f, 127); });
+            break;
+
+        case PIXEL_CODEC_UNORM16:
+            EncodeComponents<Uint16>(pSrc, Width, Info.NumComponents, pDst, [](float f, Uint32) { return FloatToUNorm(f, 65535); });
+            break;
+
+        case PIXEL_CODEC_SNORM16:
+            EncodeComponents<Int16>(pSrc, Width, Info.NumComponents, pDst, [](float f, Uint32) { return FloatToSNorm(f, 32767); });
+            break;
+
+        case PIXEL_CODEC_BGRA8_UNORM:
+            EncodeUNorm8x4(pSrc, Width, true, Info.IgnoreAlpha, pDst);
+            break;
+
+        case PIXEL_CODEC_BGRA8_UNORM_SRGB:
+            EncodeSRGB8x4(pSrc, Width, true, Info.IgnoreAlpha, pDst);
+            break;
+
+        case PIXEL_CODEC_RGB10A2_UNORM:
+            EncodeTexels<Uint32>(pSrc, Width, pDst, [](const float4& f) {
+                return FloatToUNorm(f.x, 1023) | (FloatToUNorm(f.y, 1023) << 10u) | (FloatToUNorm(f.z, 1023) << 20u) | (FloatToUNorm(f.w, 3) << 30u);
+            });
+            break;
+
+        case PIXEL_CODEC_RGB10A2_UINT:
+            EncodeTexels<Uint32>(pSrc, Width, pDst, [](const float4& f) {
+                return FloatToUInt(f.x, 1023) | (FloatToUInt(f.y, 1023) << 10u) | (FloatToUInt(f.z, 1023) << 20u) | (FloatToUInt(f.w, 3) << 30u);
+            });
+            break;
+
+        case PIXEL_CODEC_R11G11B10_FLOAT:
+            EncodeTexels<Uint32>(pSrc, Width, pDst, [](const float4& f) {
+                return FloatToSmallFloat(f.x, 6, false) | (FloatToSmallFloat(f.y, 6, false) << 11u) | (FloatToSmallFloat(f.z, 5, false) << 22u);
+            });
+            break;
+
+        case PIXEL_CODEC_RGB9E5_SHAREDEXP:
+            EncodeTexels<Uint32>(pSrc, Width, pDst, [](const float4& f) {
+                // https://www.khronos.org/registry/OpenGL/extensions/EXT/EXT_texture_shared_exponent.txt
+                constexpr float MaxValue = 65408.f; // (2^9 - 1) / 2^9 * 2^16
+                // clang-format off
+                const float r = clamp(f.x, 0.f, MaxValue);
+                const float g = clamp(f.y, 0.f, MaxValue);
+                const float b = clamp(f.z, 0.f, MaxValue);
+                // clang-format on
+                const float MaxComp = std::max(std::max(r, g), b);
+
+                int Exp = MaxComp > 0 ? std::max(-16, static_cast<int>(std::floor(std::log2(MaxComp)))) + 1 + 15 : 0;
+                if (static_cast<Uint32>(std::floor(MaxComp / std::ldexp(1.f, Exp - 15 - 9) + 0.5f)) == 512)
+                    ++Exp;
+
+                const float Scale    = std::ldexp(1.f, Exp - 15 - 9);
+                auto        Quantize = [Scale](float c) {
+                    return static_cast<Uint32>(std::floor(c / Scale + 0.5f));
+                };
+                return Quantize(r) | (Quantize(g) << 9u) | (Quantize(b) << 18u) | (static_cast<Uint32>(Exp) << 27u);
+            });
+            break;
+
+        case PIXEL_CODEC_B5G6R5_UNORM:
+            EncodeTexels<Uint16>(pSrc, Width, pDst, [](const float4& f) {
+                return (FloatToUNorm(f.x, 31) << 11u) | (FloatToUNorm(f.y, 63) << 5u) | FloatToUNorm(f.z, 31);
+            });
+            break;
+
+        case PIXEL_CODEC_B5G5R5A1_UNORM:
+            EncodeTexels<Uint16>(pSrc, Width, pDst, [](const float4& f) {
+                return (FloatToUNorm(f.x, 31) << 10u) | (FloatToUNorm(f.y, 31) << 5u) | FloatToUNorm(f.z, 31) | (FloatToUNorm(f.w, 1) << 15u);
+            });
+            break;
+
+        case PIXEL_CODEC_R10G10B10_XR_BIAS_A2_UNORM:
+            EncodeTexels<Uint32>(pSrc, Width, pDst, [](const float4& f) {
+                auto FloatToXRBias = [](float c) {
+                    return static_cast<Uint32>(clamp(c * 510.f + 384.f, 0.f, 1023.f) + 0.5f);
+                };
+                return FloatToXRBias(f.x) | (FloatToXRBias(f.y) << 10u) | (FloatToXRBias(f.z) << 20u) | (FloatToUNorm(f.w, 3) << 30u);
+            });
+            break;
+
+        default:
+            UNEXPECTED("Unexpected codec");
+    }
+}
+
+// Swaps red and blue components of 8-bit four-component texels, and optionally sets alpha to 255
+void SwizzleRGBA8Row(const void* pSrc, Uint32 Width, bool SwapRB, bool SetOpaque, void* pDst)
+{
+    const Uint32 AlphaMask = SetOpaque ? 0xFF000000u : 0u;
+    for (Uint32 x = 0; x < Width; ++x)
+    {
+        Uint32 Texel;
+        memcpy(&Texel, static_cast<const Uint8*>(pSrc) + x * 4, sizeof(Texel));
+        if (SwapRB)
+            Texel = (Texel & 0xFF00FF00u) | ((Texel >> 16u) & 0xFFu) | ((Texel & 0xFFu) << 16u);
+        Texel |= AlphaMask;
+        memcpy(static_cast<Uint8*>(pDst) + x * 4, &Texel, sizeof(Texel));
+    }
+}
+
+} // namespace
+
+bool IsPixelFormatConversionSupported(TEXTURE_FORMAT Format)
+{
+    return Format < TEX_FORMAT_NUM_FORMATS && GetCachedPixelFormatInfo(Format).Codec != PIXEL_CODEC_UNSUPPORTED;
+}
+
+void DecodePixels(TEXTURE_FORMAT Format, const void* pSrc, Uint32 NumPixels, float4* pDst)
+{
+    const auto& Info = GetCachedPixelFormatInfo(Format);
+    DEV_CHECK_ERR(Info.Codec != PIXEL_CODEC_UNSUPPORTED, "Format ", GetTextureFormatAttribs(Format).Name, " is not supported");
+    DecodeRow(Info, pSrc, NumPixels, pDst);
+}
+
+void EncodePixels(TEXTURE_FORMAT Format, const float4* pSrc, Uint32 NumPixels, void* pDst)
+{
+    const auto& Info = GetCachedPixelFormatInfo(Format);
+    DEV_CHECK_ERR(Info.Codec != PIXEL_CODEC_UNSUPPORTED, "Format ", GetTextureFormatAttribs(Format).Name, " is not supported");
+    EncodeRow(Info, pSrc, NumPixels, pDst);
+}
+
+bool ConvertPixels(TEXTURE_FORMAT SrcFormat,
+                   TEXTURE_FORMAT DstFormat,
+                   Uint32         Width,
+                   Uint32         Height,
+                   const void*    pSrcData,
+                   size_t         SrcStride,
+                   void*          pDstData,
+                   size_t         DstStride)
+{
+    DEV_CHECK_ERR(pSrcData != nullptr || Width == 0 || Height == 0, "Source data must not be null");
+    DEV_CHECK_ERR(pDstData != nullptr || Width == 0 || Height == 0, "Destination data must not be null");
+
+    const auto* pSrc = static_cast<const Uint8*>(pSrcData);
+    auto*       pDst = static_cast<Uint8*>(pDstData);
+
+    if (SrcFormat == DstFormat)
+    {
+        const auto& FmtAttribs = GetTextureFormatAttribs(SrcFormat);
+        if (FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED || FmtAttribs.ComponentType == COMPONENT_TYPE_UNDEFINED)
+        {
+            LOG_ERROR_MESSAGE("Pixels of format ", FmtAttribs.Name, " can't be copied");
+            return false;
+        }
+
+        const size_t RowSize = size_t{Width} * FmtAttribs.GetElementSize();
+        for (Uint32 y = 0; y < Height; ++y)
+            memcpy(pDst + y * DstStride, pSrc + y * SrcStride, RowSize);
+        return true;
+    }
+
+    if (!IsPixelFormatConversionSupported(SrcFormat) || !IsPixelFormatConversionSupported(DstFormat))
+    {
+        LOG_ERROR_MESSAGE("Conversion from ", GetTextureFormatAttribs(SrcFormat).Name, " to ", GetTextureFormatAttribs(DstFormat).Name, " is not supported");
+        return false;
+    }
+
+    const auto& SrcInfo = GetCachedPixelFormatInfo(SrcFormat);
+    const auto& DstInfo = GetCachedPixelFormatInfo(DstFormat);
+
+    // 8-bit RGBA and BGRA formats of the same color space are swizzled directly
+    {
+        auto GetRGBA8Type = [](const PixelFormatInfo& Info, bool& IsBGRA) {
+            IsBGRA = Info.Codec == PIXEL_CODEC_BGRA8_UNORM || Info.Codec == PIXEL_CODEC_BGRA8_UNORM_SRGB;
+            if ((Info.Codec == PIXEL_CODEC_UNORM8 && Info.NumComponents == 4) || Info.Codec == PIXEL_CODEC_BGRA8_UNORM)
+                return COMPONENT_TYPE_UNORM;
+            if ((Info.Codec == PIXEL_CODEC_UNORM8_SRGB && Info.NumComponents == 4) || Info.Codec == PIXEL_CODEC_BGRA8_UNORM_SRGB)
+                return COMPONENT_TYPE_UNORM_SRGB;
+            return COMPONENT_TYPE_UNDEFINED;
+        };
+
+        bool       IsSrcBGRA = false, IsDstBGRA = false;
+        const auto SrcType = GetRGBA8Type(SrcInfo, IsSrcBGRA);
+        const auto DstType = GetRGBA8Type(DstInfo, IsDstBGRA);
+        if (SrcType != COMPONENT_TYPE_UNDEFINED && SrcType == DstType)
+        {
+            const bool SetOpaque = SrcInfo.IgnoreAlpha || DstInfo.IgnoreAlpha;
+            for (Uint32 y = 0; y < Height; ++y)
+                SwizzleRGBA8Row(pSrc + y * SrcStride, Width, IsSrcBGRA != IsDstBGRA, SetOpaque, pDst + y * DstStride);
+            return true;
+        }
+    }
+
+    // RGBA32_FLOAT rows are decoded into and encoded from directly
+    const bool IsSrcRGBA32F = SrcInfo.Codec == PIXEL_CODEC_FLOAT32 && SrcInfo.NumComponents == 4;
+    const bool IsDstRGBA32F = DstInfo.Codec == PIXEL_CODEC_FLOAT32 && DstInfo.NumComponents == 4;
+
+    std::vector<float4> Row;
+    if (!IsSrcRGBA32F && !IsDstRGBA32F)
+        Row.resize(Width);
+
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        const auto* pSrcRow = pSrc + y * SrcStride;
+        auto*       pDstRow = pDst + y * DstStride;
+        if (IsSrcRGBA32F)
+        {
+            EncodeRow(DstInfo, reinterpret_cast<const float4*>(pSrcRow), Width, pDstRow);
+        }
+        else if (IsDstRGBA32F)
+        {
+            DecodeRow(SrcInfo, pSrcRow, Width, reinterpret_cast<float4*>(pDstRow));
+        }
+        else
+        {
+            DecodeRow(SrcInfo, pSrcRow, Width, Row.data());
+            EncodeRow(DstInfo, Row.data(), Width, pDstRow);
+        }
+    }
+
+    return true;
+}
+
+} // namespace Diligent
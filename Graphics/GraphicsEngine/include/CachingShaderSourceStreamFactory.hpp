@@ -0,0 +1,134 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of Diligent::CachingShaderSourceStreamFactory class
+
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+#include "CachingShaderSourceStreamFactory.h"
+#include "DataBlob.h"
+#include "ObjectBase.hpp"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+/// Implementation of the Diligent::ICachingShaderSourceStreamFactory interface.
+
+/// Besides the interface methods, the class provides C++ methods that return the file names
+/// in vectors.
+class CachingShaderSourceStreamFactory final : public ObjectBase<ICachingShaderSourceStreamFactory>
+{
+public:
+    using TBase = ObjectBase<ICachingShaderSourceStreamFactory>;
+
+    /// \param [in] pRefCounters      - Reference counters object.
+    /// \param [in] SearchDirectories - Semicolon-separated list of search directories.
+    CachingShaderSourceStreamFactory(IReferenceCounters* pRefCounters, const Char* SearchDirectories);
+
+    virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) override final;
+
+    virtual void DILIGENT_CALL_TYPE CreateInputStream(const Char* Name, IFileStream** ppStream) override final;
+
+    virtual void DILIGENT_CALL_TYPE CreateInputStream2(const Char*                             Name,
+                                                       CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags,
+                                                       IFileStream**                           ppStream) override final;
+
+    virtual void DILIGENT_CALL_TYPE EnumerateDependencies(const Char*                  Name,
+                                                          ShaderSourceFileCallbackType Callback,
+                                                          void*                        pUserData) const override final;
+
+    virtual void DILIGENT_CALL_TYPE EnumerateDependents(const Char*                  Name,
+                                                        ShaderSourceFileCallbackType Callback,
+                                                        void*                        pUserData) const override final;
+
+    virtual void DILIGENT_CALL_TYPE CheckForChanges(ShaderSourceFileCallbackType Callback, void* pUserData) override final;
+
+    virtual void DILIGENT_CALL_TYPE Invalidate(const Char* Name, ShaderSourceFileCallbackType Callback, void* pUserData) override final;
+
+    virtual void DILIGENT_CALL_TYPE Clear() override final;
+
+    virtual Uint32 DILIGENT_CALL_TYPE GetNumCachedFiles() const override final;
+
+    /// Returns the names of all files that are directly or indirectly included by the file.
+    /// Only the files that have been loaded through this factory are known.
+    std::vector<String> GetDependencies(const Char* Name) const;
+
+    /// Returns the names of all loaded files that directly or indirectly include the file.
+    std::vector<String> GetDependents(const Char* Name) const;
+
+    /// Compares modification timestamps of all cached files with the file system and evicts
+    /// the files that have been modified or deleted. Returns the names of the evicted files
+    /// followed by the names of all files that directly or indirectly include them.
+    std::vector<String> CheckForChanges();
+
+    /// Evicts the file from the cache. Returns the name of the file followed by
+    /// the names of all files that directly or indirectly include it.
+    std::vector<String> Invalidate(const Char* Name);
+
+private:
+    struct FileInfo
+    {
+        String FullPath;
+
+        // Null if the file has been evicted. Include list of an evicted file is kept
+        // until the file is reloaded so that the dependency graph stays complete.
+        RefCntAutoPtr<IDataBlob> pData;
+
+        Uint64 Timestamp    = 0;
+        bool   HasTimestamp = false;
+
+        std::vector<String> Includes;
+    };
+
+    bool LoadFile(const String& Name, FileInfo& Info) const;
+
+    std::vector<String> CollectDependents(std::vector<String>&& Files) const;
+
+    std::vector<String> m_SearchDirectories;
+
+    mutable std::mutex                   m_FilesMtx;
+    std::unordered_map<String, FileInfo> m_Files;
+};
+
+/// Creates caching shader source stream factory
+
+/// \param [in]  SearchDirectories           - Semicolon-separated list of search directories.
+/// \param [out] ppShaderSourceStreamFactory - Memory address where pointer to the shader source stream factory will be written.
+///
+/// \remarks The factory is returned through its concrete type so that the engine can use
+///          the C++ methods. Applications create the factory with
+///          IEngineFactory::CreateCachingShaderSourceStreamFactory().
+void CreateCachingShaderSourceStreamFactory(const Char*                        SearchDirectories,
+                                            CachingShaderSourceStreamFactory** ppShaderSourceStreamFactory);
+
+} // namespace Diligent
@@ -33,6 +33,7 @@
 #include "Object.h"
 #include "EngineFactory.h"
 #include "DefaultShaderSourceStreamFactory.h"
+#include "CachingShaderSourceStreamFactory.hpp"
 
 namespace Diligent
 {
@@ -95,6 +96,14 @@ public:
         Diligent::CreateDefaultShaderSourceStreamFactory(SearchDirectories, ppShaderSourceFactory);
     }
 
+    virtual void DILIGENT_CALL_TYPE CreateCachingShaderSourceStreamFactory(const Char*                         SearchDirectories,
+                                                                           ICachingShaderSourceStreamFactory** ppShaderSourceFactory) const override final
+    {
+        CachingShaderSourceStreamFactory* pFactory = nullptr;
+        Diligent::CreateCachingShaderSourceStreamFactory(SearchDirectories, &pFactory);
+        *ppShaderSourceFactory = pFactory;
+    }
+
 private:
     class DummyReferenceCounters final : public IReferenceCounters
     {
@@ -0,0 +1,271 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of Diligent::ShaderArchiveWriter and Diligent::ShaderArchiveReader classes
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+#include "Shader.h"
+#include "DeviceCaps.h"
+
+namespace Diligent
+{
+
+// Shader archive is a binary container of precompiled shader permutations produced by the
+// ShaderArchiver tool. Every permutation is identified by the shader file path, shader type,
+// entry point, source language, combined texture sampler options and macros, and references
+// SPIRV byte code (Vulkan) and GLSL source (OpenGL). Byte-identical blobs are stored once.
+//
+// GLSL source depends on the platform, the API version and the device features it was built for
+// (see BuildGLSLSourceString()), so the archive records this target and the OpenGL backend
+// rejects archives that were built for an incompatible device.
+//
+//  | Header | Hash table | Entries | Blob table | Key strings | Blobs (16-byte aligned) |
+//
+// The archive is designed to be used in place (e.g. memory-mapped, see MappedFileDataBlob):
+// opening the archive only validates the header, and permutations are found through the
+// open-addressing hash table in constant time, so only the pages that are actually used
+// are ever touched.
+
+enum SHADER_ARCHIVE_PLATFORM : Uint32
+{
+    SHADER_ARCHIVE_PLATFORM_UNKNOWN = 0,
+    SHADER_ARCHIVE_PLATFORM_WIN32,
+    SHADER_ARCHIVE_PLATFORM_UNIVERSAL_WINDOWS,
+    SHADER_ARCHIVE_PLATFORM_LINUX,
+    SHADER_ARCHIVE_PLATFORM_MACOS,
+    SHADER_ARCHIVE_PLATFORM_ANDROID,
+    SHADER_ARCHIVE_PLATFORM_IOS
+};
+
+/// Device features that affect the GLSL source
+enum SHADER_ARCHIVE_GLSL_FEATURES : Uint32
+{
+    SHADER_ARCHIVE_GLSL_FEATURE_NONE               = 0x00,
+    SHADER_ARCHIVE_GLSL_FEATURE_SEPARABLE_PROGRAMS = 0x01,
+    SHADER_ARCHIVE_GLSL_FEATURE_COMPUTE_SHADERS    = 0x02,
+    SHADER_ARCHIVE_GLSL_FEATURE_CUBEMAP_ARRAYS     = 0x04,
+    SHADER_ARCHIVE_GLSL_FEATURE_TEXTURE_2D_MS      = 0x08
+};
+
+/// Describes the device the GLSL source in the archive was built for
+struct ShaderArchiveGLSLTarget
+{
+    /// Platform the archiver was built for, see SHADER_ARCHIVE_PLATFORM
+    Uint32 Platform = SHADER_ARCHIVE_PLATFORM_UNKNOWN;
+
+    /// RENDER_DEVICE_TYPE_GL or RENDER_DEVICE_TYPE_GLES, or RENDER_DEVICE_TYPE_UNDEFINED
+    /// if the archive contains no GLSL source
+    Uint32 DeviceType = RENDER_DEVICE_TYPE_UNDEFINED;
+
+    Uint32 MajorVersion = 0;
+    Uint32 MinorVersion = 0;
+
+    /// Combination of SHADER_ARCHIVE_GLSL_FEATURES flags
+    Uint32 Features = SHADER_ARCHIVE_GLSL_FEATURE_NONE;
+    Uint32 Padding  = 0;
+};
+
+struct ShaderArchiveHeader
+{
+    static constexpr Uint32 ExpectedMagic = 0x52415344; // 'DSAR'
+
+    // Must be incremented whenever the archive layout changes
+    static constexpr Uint32 ExpectedVersion = 4;
+
+    Uint32 Magic   = ExpectedMagic;
+    Uint32 Version = ExpectedVersion;
+
+    Uint32 NumShaders = 0;
+    Uint32 NumBlobs   = 0;
+
+    // Number of slots in the hash table, always a power of two
+    Uint32 HashTableSize = 0;
+    Uint32 Padding       = 0;
+
+    ShaderArchiveGLSLTarget GLSLTarget;
+
+    Uint64 HashTableOffset  = 0;
+    Uint64 EntriesOffset    = 0;
+    Uint64 BlobTableOffset  = 0;
+    Uint64 KeyStringsOffset = 0;
+    Uint64 KeyStringsSize   = 0;
+};
+
+struct ShaderArchiveEntry
+{
+    static constexpr Uint32 InvalidIndex = ~Uint32{0};
+
+    // Hash of the key string. The hash table slot of the entry is found
+    // by linear probing starting from (Key & (HashTableSize - 1)).
+    Uint64 Key = 0;
+
+    // Key string identifies the permutation and is used to resolve hash collisions
+    Uint32 KeyStringOffset = 0;
+    Uint32 KeyStringLength = 0;
+
+    Uint32 SPIRVBlob = InvalidIndex;
+    Uint32 GLSLBlob  = InvalidIndex;
+};
+
+struct ShaderArchiveBlob
+{
+    Uint64 Offset = 0;
+    Uint64 Size   = 0;
+};
+
+/// Returns the string that identifies the shader permutation in the archive.
+/// The string is composed of the file path (with forward slashes), the shader type,
+/// the entry point, the source language, the combined texture sampler options and
+/// the macros sorted by name.
+std::string GetShaderArchiveKeyString(const ShaderCreateInfo& ShaderCI);
+
+/// Returns the hash of the key string that is stable across platforms and builds
+Uint64 ComputeShaderArchiveKey(const std::string& KeyString);
+
+/// Returns the GLSL target that BuildGLSLSourceString() produces the source for when
+/// it is given the device caps on the current platform
+ShaderArchiveGLSLTarget GetShaderArchiveGLSLTarget(const DeviceCaps& Caps);
+
+/// Returns true if the GLSL source that was built for the target can be used on the device.
+/// Platform, device type and separable programs support must match exactly. Desktop GLSL may be
+/// used on a later GL version, while GLES version must match exactly. All features the
+/// source was built with must be supported by the device.
+bool IsShaderArchiveGLSLTargetCompatible(const ShaderArchiveGLSLTarget& Target, const DeviceCaps& Caps);
+
+/// Returns the human-readable description of the GLSL target, e.g. "GL 4.3 (Linux)"
+std::string GetShaderArchiveGLSLTargetString(const ShaderArchiveGLSLTarget& Target);
+
+
+/// Builds the shader archive in memory
+class ShaderArchiveWriter
+{
+public:
+    struct Statistics
+    {
+        Uint32 NumShaders = 0;
+
+        /// Number of unique blobs stored in the archive
+        Uint32 NumBlobs = 0;
+
+        /// Number of blobs that were found to be identical to already stored ones
+        Uint32 NumDuplicateBlobs = 0;
+
+        /// Total size of all added blobs, and size of unique blobs
+        size_t TotalBlobSize  = 0;
+        size_t UniqueBlobSize = 0;
+    };
+
+    /// Sets the device the GLSL source is built for. Must be called before
+    /// GLSL source is added, see GetShaderArchiveGLSLTarget().
+    void SetGLSLTarget(const ShaderArchiveGLSLTarget& Target) { m_GLSLTarget = Target; }
+
+    /// Adds the shader permutation identified by ShaderCI to the archive.
+    /// SPIRV or GLSL may be empty. Returns false if the permutation is already in the archive.
+    bool AddShader(const ShaderCreateInfo&    ShaderCI,
+                   const std::vector<Uint32>& SPIRV,
+                   const std::string&         GLSL);
+
+    /// Writes the archive to the vector
+    void Serialize(std::vector<Uint8>& Data) const;
+
+    const Statistics& GetStatistics() const { return m_Stats; }
+
+private:
+    Uint32 AddBlob(const void* pData, size_t Size);
+
+    struct Shader
+    {
+        std::string KeyString;
+        Uint64      Key       = 0;
+        Uint32      SPIRVBlob = ShaderArchiveEntry::InvalidIndex;
+        Uint32      GLSLBlob  = ShaderArchiveEntry::InvalidIndex;
+    };
+    std::vector<Shader> m_Shaders;
+
+    // Key -> indices of shaders with this key
+    std::unordered_multimap<Uint64, Uint32> m_ShaderKeys;
+
+    std::vector<std::vector<Uint8>> m_Blobs;
+
+    // Content hash -> indices of blobs with this hash
+    std::unordered_multimap<Uint64, Uint32> m_BlobHashes;
+
+    ShaderArchiveGLSLTarget m_GLSLTarget;
+
+    Statistics m_Stats;
+};
+
+
+/// Provides access to the shader archive data. The reader does not copy
+/// the data, which must remain valid while the reader is in use.
+class ShaderArchiveReader
+{
+public:
+    /// Validates the header and the tables, but not the blobs, which are validated when
+    /// the shader is looked up. Throws an exception if the data is not a valid shader archive.
+    ShaderArchiveReader(const void* pData, size_t Size);
+
+    struct ShaderData
+    {
+        const void* pSPIRV    = nullptr;
+        size_t      SPIRVSize = 0;
+
+        const char* GLSL       = nullptr;
+        size_t      GLSLLength = 0;
+    };
+
+    /// Looks up the permutation identified by ShaderCI. Returns false if it is not found.
+    bool FindShader(const ShaderCreateInfo& ShaderCI, ShaderData& Data) const;
+
+    /// Looks up the permutation by the key string (see GetShaderArchiveKeyString()).
+    bool FindShader(const std::string& KeyString, ShaderData& Data) const;
+
+    Uint32 GetNumShaders() const { return m_pHeader->NumShaders; }
+
+    /// Returns the device the GLSL source was built for
+    const ShaderArchiveGLSLTarget& GetGLSLTarget() const { return m_pHeader->GLSLTarget; }
+
+private:
+    bool GetBlob(Uint32 BlobIndex, const Uint8*& pBlobData, size_t& BlobSize) const;
+
+    const Uint8* const m_pData;
+    const size_t       m_Size;
+
+    const ShaderArchiveHeader* m_pHeader    = nullptr;
+    const Uint32*              m_pHashTable = nullptr;
+    const ShaderArchiveEntry*  m_pEntries   = nullptr;
+    const ShaderArchiveBlob*   m_pBlobs     = nullptr;
+    const char*                m_KeyStrings = nullptr;
+};
+
+} // namespace Diligent
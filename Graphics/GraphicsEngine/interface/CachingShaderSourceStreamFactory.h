@@ -0,0 +1,120 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Definition of the Diligent::ICachingShaderSourceStreamFactory interface
+
+#include "Shader.h"
+
+DILIGENT_BEGIN_NAMESPACE(Diligent)
+
+/// Callback that receives the name of a shader source file, see ICachingShaderSourceStreamFactory.
+typedef void (*ShaderSourceFileCallbackType)(const Char* Name, void* pUserData);
+
+// {6C1F7A4E-5B0D-4E8F-9A2D-3E5C0B7D1F92}
+static const INTERFACE_ID IID_CachingShaderSourceStreamFactory =
+    {0x6c1f7a4e, 0x5b0d, 0x4e8f, {0x9a, 0x2d, 0x3e, 0x5c, 0xb, 0x7d, 0x1f, 0x92}};
+
+#define DILIGENT_INTERFACE_NAME ICachingShaderSourceStreamFactory
+#include "../../../Primitives/interface/DefineInterfaceHelperMacros.h"
+
+#define ICachingShaderSourceStreamFactoryInclusiveMethods \
+    IShaderSourceInputStreamFactoryInclusiveMethods;      \
+    ICachingShaderSourceStreamFactoryMethods CachingShaderSourceStreamFactory
+
+// clang-format off
+
+/// Shader source stream factory that keeps the contents of the source files in memory.
+
+/// Every file is read from disk only once; subsequent requests are served from the cached copy,
+/// so creating many shaders or shader permutations that include the same headers does not
+/// touch the file system. When a file is loaded, the factory records the files it includes
+/// and builds the include dependency graph that the application can query on hot reload
+/// to find the shaders that must be recreated. The cached copies are only refreshed by
+/// CheckForChanges() or Invalidate().
+///
+/// The factory is created by IEngineFactory::CreateCachingShaderSourceStreamFactory().
+/// All methods are thread-safe. The callbacks are called before the methods return,
+/// and must not call the methods of the factory.
+DILIGENT_BEGIN_INTERFACE(ICachingShaderSourceStreamFactory, IShaderSourceInputStreamFactory)
+{
+    /// Calls the callback for every file that is directly or indirectly included by the file.
+    /// Only the files that have been loaded through this factory are known.
+    VIRTUAL void METHOD(EnumerateDependencies)(THIS_
+                                               const Char*                  Name,
+                                               ShaderSourceFileCallbackType Callback,
+                                               void*                        pUserData) CONST PURE;
+
+    /// Calls the callback for every loaded file that directly or indirectly includes the file.
+    VIRTUAL void METHOD(EnumerateDependents)(THIS_
+                                             const Char*                  Name,
+                                             ShaderSourceFileCallbackType Callback,
+                                             void*                        pUserData) CONST PURE;
+
+    /// Compares modification timestamps of all cached files with the file system and evicts
+    /// the files that have been modified or deleted. Calls the callback for every evicted file
+    /// and then for every file that directly or indirectly includes them.
+    /// The callback may be null.
+    VIRTUAL void METHOD(CheckForChanges)(THIS_
+                                         ShaderSourceFileCallbackType Callback,
+                                         void*                        pUserData) PURE;
+
+    /// Evicts the file from the cache. Calls the callback for the file and then for every
+    /// file that directly or indirectly includes it. The callback may be null.
+    VIRTUAL void METHOD(Invalidate)(THIS_
+                                    const Char*                  Name,
+                                    ShaderSourceFileCallbackType Callback,
+                                    void*                        pUserData) PURE;
+
+    /// Evicts all files and clears the dependency graph.
+    VIRTUAL void METHOD(Clear)(THIS) PURE;
+
+    /// Returns the number of files whose contents are currently cached.
+    VIRTUAL Uint32 METHOD(GetNumCachedFiles)(THIS) CONST PURE;
+};
+DILIGENT_END_INTERFACE
+
+#include "../../../Primitives/interface/UndefInterfaceHelperMacros.h"
+
+#if DILIGENT_C_INTERFACE
+
+// clang-format off
+
+#    define ICachingShaderSourceStreamFactory_EnumerateDependencies(This, ...) CALL_IFACE_METHOD(CachingShaderSourceStreamFactory, EnumerateDependencies, This, __VA_ARGS__)
+#    define ICachingShaderSourceStreamFactory_EnumerateDependents(This, ...)   CALL_IFACE_METHOD(CachingShaderSourceStreamFactory, EnumerateDependents,   This, __VA_ARGS__)
+#    define ICachingShaderSourceStreamFactory_CheckForChanges(This, ...)       CALL_IFACE_METHOD(CachingShaderSourceStreamFactory, CheckForChanges,       This, __VA_ARGS__)
+#    define ICachingShaderSourceStreamFactory_Invalidate(This, ...)            CALL_IFACE_METHOD(CachingShaderSourceStreamFactory, Invalidate,            This, __VA_ARGS__)
+#    define ICachingShaderSourceStreamFactory_Clear(This)                      CALL_IFACE_METHOD(CachingShaderSourceStreamFactory, Clear,                 This)
+#    define ICachingShaderSourceStreamFactory_GetNumCachedFiles(This)          CALL_IFACE_METHOD(CachingShaderSourceStreamFactory, GetNumCachedFiles,     This)
+
+// clang-format on
+
+#endif
+
+DILIGENT_END_NAMESPACE // namespace Diligent
@@ -42,6 +42,7 @@ struct AAssetManager;
 DILIGENT_BEGIN_NAMESPACE(Diligent)
 
 struct IShaderSourceInputStreamFactory;
+struct ICachingShaderSourceStreamFactory;
 
 // {D932B052-4ED6-4729-A532-F31DEEC100F3}
 static const INTERFACE_ID IID_EngineFactory =
@@ -70,6 +71,15 @@ DILIGENT_BEGIN_INTERFACE(IEngineFactory, IObject)
                         const Char*                              SearchDirectories,
                         struct IShaderSourceInputStreamFactory** ppShaderSourceFactory) CONST PURE;
 
+    /// Creates shader source input stream factory that keeps the contents of the source files
+    /// in memory and tracks the include dependencies, see ICachingShaderSourceStreamFactory.
+    /// \param [in]  SearchDirectories           - Semicolon-seprated list of search directories.
+    /// \param [out] ppShaderSourceStreamFactory - Memory address where pointer to the shader source stream factory will be written.
+    VIRTUAL void METHOD(CreateCachingShaderSourceStreamFactory)(
+                        THIS_
+                        const Char*                                SearchDirectories,
+                        struct ICachingShaderSourceStreamFactory** ppShaderSourceFactory) CONST PURE;
+
 #if PLATFORM_ANDROID
     /// On Android platform, it is necessary to initialize the file system before
     /// CreateDefaultShaderSourceStreamFactory() method can be called.
@@ -94,6 +104,7 @@ DILIGENT_END_INTERFACE
 
 #    define IEngineFactory_GetAPIInfo(This)                                  CALL_IFACE_METHOD(EngineFactory, GetAPIInfo,                             This)
 #    define IEngineFactory_CreateDefaultShaderSourceStreamFactory(This, ...) CALL_IFACE_METHOD(EngineFactory, CreateDefaultShaderSourceStreamFactory, This, __VA_ARGS__)
+#    define IEngineFactory_CreateCachingShaderSourceStreamFactory(This, ...) CALL_IFACE_METHOD(EngineFactory, CreateCachingShaderSourceStreamFactory, This, __VA_ARGS__)
 #    define IEngineFactory_InitAndroidFileSystem(This, ...)                  CALL_IFACE_METHOD(EngineFactory, InitAndroidFileSystem,                  This, __VA_ARGS__)
 
 // clang-format on
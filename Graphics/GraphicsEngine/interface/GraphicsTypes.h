@@ -1381,6 +1381,52 @@ struct EngineGLCreateInfo DILIGENT_DERIVE(EngineCreateInfo)
     /// provide additional runtime checking, validation, and logging
     /// functionality while possibly incurring performance penalties
     bool CreateDebugContext     DEFAULT_INITIALIZER(false);
+
+    /// The number of worker threads that create GL resources on behalf of threads
+    /// that have no current GL context.
+
+    /// Every worker thread owns a GL context that shares objects with the main context.
+    /// When this member is non-zero, resources can be created by any thread, and
+    /// DeviceFeatures::MultithreadedResourceCreation is set if the shared contexts
+    /// were successfully created. Shared contexts are only supported on Windows and Linux.
+    /// On Linux, the application must call XInitThreads() before any other Xlib call.
+    /// Objects may also be released by any thread. Cached VAOs and FBOs that reference them are
+    /// deleted by the immediate context the next time it uses the caches or finishes the frame.
+    Uint32 NumResourceCreationThreads DEFAULT_INITIALIZER(0);
+
+    /// The size, in bytes, of the GL buffers that small uniform buffers are suballocated from.
+
+    /// Uniform buffers that are not accessed by the CPU and are not larger than a quarter
+    /// of the page (and at most 16 KB) share one GL buffer object and are bound with
+    /// glBindBufferRange. Released ranges are reused after the GPU has finished
+    /// using them, see IRenderDevice::ReleaseStaleResources(). 0 (default) disables suballocation;
+    /// a typical page size is 256 KB.
+    Uint32 UniformBufferArenaPageSize DEFAULT_INITIALIZER(0);
+
+    /// Directory where the results of HLSL to GLSL conversion are stored.
+
+    /// Converted shaders are identified by the hash of the HLSL source with all includes
+    /// resolved, the entry point, the shader type and the conversion options, so creating
+    /// a shader from the same source again, or after the application is restarted, does not
+    /// convert it. The directory is created if it does not exist.
+    /// If this member is null, conversion results are only cached in memory.
+    const Char* HLSL2GLSLCacheDirectory DEFAULT_INITIALIZER(nullptr);
+
+    /// Whether to only include the GLSL definitions referenced by a shader converted from HLSL.
+
+    /// By default, every shader converted from HLSL is prefixed with all definitions
+    /// that support the conversion (about 50 KB). When this member is true, only the
+    /// macros and functions referenced by the shader are included, which reduces the
+    /// amount of code the driver has to compile.
+    bool FilterHLSL2GLSLDefinitions DEFAULT_INITIALIZER(false);
+
+    /// Whether to not use direct state access functions even if they are supported.
+
+    /// By default, buffers and textures are created, updated, copied and mapped through
+    /// GL_ARB_direct_state_access functions when OpenGL 4.5 or the extension is available.
+    /// When this member is true, the objects are always bound to edit them, which
+    /// may be used to work around driver issues.
+    bool DisableDirectStateAccess DEFAULT_INITIALIZER(false);
 };
 typedef struct EngineGLCreateInfo EngineGLCreateInfo;
 
@@ -1709,6 +1755,26 @@ struct EngineVkCreateInfo DILIGENT_DERIVE(EngineCreateInfo)
     }
 #endif
     ;
+
+    /// Directory where SPIR-V byte code compiled from shader sources is stored.
+
+    /// Byte code is identified by the hash of the preprocessed source, the macros, the entry point,
+    /// the shader stage and the compiler version, so compiling the same shader again, or after
+    /// the application is restarted, is skipped. The directory may also be populated by offline
+    /// tools that use SPIRVCache. It is created if it does not exist.
+    /// If the resource layout cache is enabled (see ResourceLayoutCacheSize), shader resource layouts
+    /// resolved when pipeline states are created, together with the patched byte code, are stored
+    /// in the same directory.
+    /// If this member is null, compiled byte code is only cached in memory.
+    const Char* SPIRVCacheDirectory DEFAULT_INITIALIZER(nullptr);
+
+    /// Maximum total size, in bytes, of the resource layouts kept in memory by the resource layout cache.
+
+    /// The cache stores shader resource layouts resolved when pipeline states are created, together
+    /// with the patched byte code, so that pipeline states that use the same shaders and resource
+    /// layout are created faster. Least recently used layouts are evicted when the size is exceeded.
+    /// If this member is 0, the cache is disabled.
+    Uint32 ResourceLayoutCacheSize DEFAULT_INITIALIZER(0);
 };
 typedef struct EngineVkCreateInfo EngineVkCreateInfo;
 
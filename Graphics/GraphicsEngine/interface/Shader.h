@@ -280,6 +280,18 @@ struct ShaderCreateInfo
     /// output message. The second one is the full shader source code including definitions added
     /// by the engine. Data blob object must be released by the client.
     IDataBlob** ppCompilerOutput DEFAULT_INITIALIZER(nullptr);
+
+    /// Shader archive produced by the ShaderArchiver tool.
+
+    /// If the archive is provided, the precompiled shader is loaded from the archive.
+    /// The shader permutation is identified by FilePath, Desc.ShaderType, EntryPoint and
+    /// Macros, which must match the values the archive was built with. Source and ByteCode
+    /// members must be null. The archive is used in place, so MappedFileDataBlob may be used
+    /// to avoid loading the entire file.
+    /// \note This option is supported for Vulkan and OpenGL backends. Vulkan backend
+    ///       loads SPIRV bytecode, OpenGL backend loads GLSL source and fails if the archive
+    ///       was built for an incompatible device.
+    IDataBlob* pShaderArchive DEFAULT_INITIALIZER(nullptr);
 };
 typedef struct ShaderCreateInfo ShaderCreateInfo;
 
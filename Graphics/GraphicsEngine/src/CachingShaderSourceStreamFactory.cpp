@@ -0,0 +1,449 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "CachingShaderSourceStreamFactory.hpp"
+#include "BasicFileStream.hpp"
+#include "MemoryFileStream.hpp"
+#include "DataBlobImpl.hpp"
+#include "EngineMemory.h"
+
+namespace Diligent
+{
+
+namespace
+{
+
+String NormalizeName(const Char* Name)
+{
+    while (*Name == '\\' || *Name == '/')
+        ++Name;
+    String NormalizedName{Name};
+    std::replace(NormalizedName.begin(), NormalizedName.end(), '\\', '/');
+    return NormalizedName;
+}
+
+void EnumerateNames(const std::vector<String>& Names, ShaderSourceFileCallbackType Callback, void* pUserData)
+{
+    if (Callback == nullptr)
+        return;
+
+    for (const auto& Name : Names)
+        Callback(Name.c_str(), pUserData);
+}
+
+// Finds all #include directives in the source. Directives inside /* */ and // comments are skipped.
+// Conditional compilation is not evaluated, so the list may contain files that are never included,
+// which only makes invalidation more conservative.
+void FindIncludes(const Char* Src, size_t Len, std::vector<String>& Includes)
+{
+    const auto* const End = Src + Len;
+
+    auto SkipSpaces = [End](const Char* Pos) {
+        while (Pos < End && (*Pos == ' ' || *Pos == '\t'))
+            ++Pos;
+        return Pos;
+    };
+
+    // Parses the directive that starts after '#' and returns the position of the first character after it
+    auto ParseDirective = [&](const Char* Pos) {
+        Pos = SkipSpaces(Pos);
+
+        static constexpr Char   IncludeStr[] = "include";
+        static constexpr size_t IncludeLen   = sizeof(IncludeStr) - 1;
+        if (static_cast<size_t>(End - Pos) <= IncludeLen || strncmp(Pos, IncludeStr, IncludeLen) != 0)
+            return Pos;
+
+        Pos = SkipSpaces(Pos + IncludeLen);
+        if (Pos == End || (*Pos != '"' && *Pos != '<'))
+            return Pos;
+
+        const auto  ClosingQuote = *Pos == '"' ? '"' : '>';
+        const auto* NameStart    = ++Pos;
+        while (Pos < End && *Pos != ClosingQuote && *Pos != '\n')
+            ++Pos;
+        if (Pos == End || *Pos != ClosingQuote)
+            return Pos;
+
+        if (Pos > NameStart)
+        {
+            auto Name = NormalizeName(String{NameStart, Pos}.c_str());
+            if (std::find(Includes.begin(), Includes.end(), Name) == Includes.end())
+                Includes.emplace_back(std::move(Name));
+        }
+        return Pos + 1;
+    };
+
+    bool InBlockComment = false;
+    for (const auto* Pos = Src; Pos < End;)
+    {
+        // Pos is at the start of a line. A directive must be the first token on the line,
+        // though it may be preceded by a block comment.
+        bool IsFirstToken = true;
+        while (Pos < End && *Pos != '\n')
+        {
+            if (InBlockComment)
+            {
+                if (Pos[0] == '*' && Pos + 1 < End && Pos[1] == '/')
+                {
+                    InBlockComment = false;
+                    Pos += 2;
+                }
+                else
+                    ++Pos;
+            }
+            else if (Pos[0] == '/' && Pos + 1 < End && Pos[1] == '*')
+            {
+                InBlockComment = true;
+                Pos += 2;
+            }
+            else if (Pos[0] == '/' && Pos + 1 < End && Pos[1] == '/')
+            {
+                while (Pos < End && *Pos != '\n')
+                    ++Pos;
+            }
+            else if (*Pos == ' ' || *Pos == '\t' || *Pos == '\r')
+            {
+                ++Pos;
+            }
+            else if (*Pos == '#' && IsFirstToken)
+            {
+                IsFirstToken = false;
+                Pos          = ParseDirective(Pos + 1);
+            }
+            else if (*Pos == '"')
+            {
+                // Comment delimiters inside string literals do not start comments
+                ++Pos;
+                while (Pos < End && *Pos != '"' && *Pos != '\n')
+                    ++Pos;
+                if (Pos < End && *Pos == '"')
+                    ++Pos;
+                IsFirstToken = false;
+            }
+            else
+            {
+                IsFirstToken = false;
+                ++Pos;
+            }
+        }
+
+        if (Pos < End)
+            ++Pos;
+    }
+}
+
+} // namespace
+
+CachingShaderSourceStreamFactory::CachingShaderSourceStreamFactory(IReferenceCounters* pRefCounters, const Char* SearchDirectories) :
+    TBase{pRefCounters}
+{
+    while (SearchDirectories)
+    {
+        const char* Semicolon = strchr(SearchDirectories, ';');
+        String      SearchPath;
+        if (Semicolon == nullptr)
+        {
+            SearchPath        = SearchDirectories;
+            SearchDirectories = nullptr;
+        }
+        else
+        {
+            SearchPath        = String(SearchDirectories, Semicolon);
+            SearchDirectories = Semicolon + 1;
+        }
+
+        if (SearchPath.length() > 0)
+        {
+            if (SearchPath.back() != '\\' && SearchPath.back() != '/')
+                SearchPath.push_back(FileSystem::GetSlashSymbol());
+            m_SearchDirectories.push_back(SearchPath);
+        }
+    }
+    m_SearchDirectories.push_back("");
+}
+
+bool CachingShaderSourceStreamFactory::LoadFile(const String& Name, FileInfo& Info) const
+{
+    for (const auto& SearchDir : m_SearchDirectories)
+    {
+        String FullPath = SearchDir + Name;
+        FileSystem::CorrectSlashes(FullPath, FileSystem::GetSlashSymbol());
+        if (!FileSystem::FileExists(FullPath.c_str()))
+            continue;
+
+        // Query the timestamp before reading the file so that modifications made
+        // while the file is being read are detected by the next CheckForChanges() call.
+        Uint64 Timestamp    = 0;
+        bool   HasTimestamp = FileSystem::GetFileTimestamp(FullPath.c_str(), Timestamp);
+
+        RefCntAutoPtr<BasicFileStream> pFileStream{MakeNewRCObj<BasicFileStream>()(FullPath.c_str(), EFileAccessMode::Read)};
+        if (!pFileStream->IsValid())
+            continue;
+
+        RefCntAutoPtr<IDataBlob> pData{MakeNewRCObj<DataBlobImpl>()(0)};
+        pFileStream->ReadBlob(pData);
+
+        Info.FullPath     = std::move(FullPath);
+        Info.pData        = std::move(pData);
+        Info.Timestamp    = Timestamp;
+        Info.HasTimestamp = HasTimestamp;
+        Info.Includes.clear();
+        FindIncludes(reinterpret_cast<const Char*>(Info.pData->GetDataPtr()), Info.pData->GetSize(), Info.Includes);
+        return true;
+    }
+
+    return false;
+}
+
+void CachingShaderSourceStreamFactory::QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface)
+{
+    if (ppInterface == nullptr)
+        return;
+
+    if (IID == IID_CachingShaderSourceStreamFactory || IID == IID_IShaderSourceInputStreamFactory)
+    {
+        *ppInterface = this;
+        (*ppInterface)->AddRef();
+    }
+    else
+    {
+        TBase::QueryInterface(IID, ppInterface);
+    }
+}
+
+void CachingShaderSourceStreamFactory::CreateInputStream(const Char*   Name,
+                                                         IFileStream** ppStream)
+{
+    CreateInputStream2(Name, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_NONE, ppStream);
+}
+
+void CachingShaderSourceStreamFactory::CreateInputStream2(const Char*                             Name,
+                                                          CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags,
+                                                          IFileStream**                           ppStream)
+{
+    VERIFY_EXPR(ppStream != nullptr && *ppStream == nullptr);
+
+    const auto NormalizedName = NormalizeName(Name);
+
+    RefCntAutoPtr<IDataBlob> pData;
+    {
+        std::lock_guard<std::mutex> Lock{m_FilesMtx};
+
+        auto it = m_Files.find(NormalizedName);
+        if (it != m_Files.end())
+            pData = it->second.pData;
+    }
+
+    if (!pData)
+    {
+        // Do not hold the lock while reading the file so that other threads can be served
+        // from the cache. If several threads load the same file, the first copy is kept.
+        FileInfo Info;
+        if (LoadFile(NormalizedName, Info))
+        {
+            std::lock_guard<std::mutex> Lock{m_FilesMtx};
+
+            auto& CachedInfo = m_Files[NormalizedName];
+            if (!CachedInfo.pData)
+                CachedInfo = std::move(Info);
+            pData = CachedInfo.pData;
+        }
+    }
+
+    if (pData)
+    {
+        // Memory streams only read the shared blob, so the cached data is never copied
+        RefCntAutoPtr<MemoryFileStream> pMemStream{MakeNewRCObj<MemoryFileStream>()(pData)};
+        pMemStream->QueryInterface(IID_FileStream, reinterpret_cast<IObject**>(ppStream));
+    }
+    else
+    {
+        *ppStream = nullptr;
+        if ((Flags & CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_SILENT) == 0)
+        {
+            LOG_ERROR("Failed to create input stream for source file ", Name);
+        }
+    }
+}
+
+std::vector<String> CachingShaderSourceStreamFactory::GetDependencies(const Char* Name) const
+{
+    std::lock_guard<std::mutex> Lock{m_FilesMtx};
+
+    std::vector<String>        Dependencies;
+    std::unordered_set<String> Visited;
+    std::vector<String>        Stack{NormalizeName(Name)};
+    Visited.insert(Stack.back());
+    while (!Stack.empty())
+    {
+        auto File = std::move(Stack.back());
+        Stack.pop_back();
+
+        auto it = m_Files.find(File);
+        if (it == m_Files.end())
+            continue;
+
+        for (const auto& Include : it->second.Includes)
+        {
+            if (Visited.insert(Include).second)
+            {
+                Dependencies.push_back(Include);
+                Stack.push_back(Include);
+            }
+        }
+    }
+
+    return Dependencies;
+}
+
+std::vector<String> CachingShaderSourceStreamFactory::CollectDependents(std::vector<String>&& Files) const
+{
+    // The graph only stores the include lists, so build reverse edges first
+    std::unordered_map<String, std::vector<const String*>> IncludedBy;
+    for (const auto& it : m_Files)
+    {
+        for (const auto& Include : it.second.Includes)
+            IncludedBy[Include].push_back(&it.first);
+    }
+
+    std::unordered_set<String> Visited{Files.begin(), Files.end()};
+    for (size_t i = 0; i < Files.size(); ++i)
+    {
+        auto it = IncludedBy.find(Files[i]);
+        if (it == IncludedBy.end())
+            continue;
+
+        for (const auto* pDependent : it->second)
+        {
+            if (Visited.insert(*pDependent).second)
+                Files.push_back(*pDependent);
+        }
+    }
+
+    return std::move(Files);
+}
+
+std::vector<String> CachingShaderSourceStreamFactory::GetDependents(const Char* Name) const
+{
+    std::lock_guard<std::mutex> Lock{m_FilesMtx};
+
+    auto Dependents = CollectDependents({NormalizeName(Name)});
+    Dependents.erase(Dependents.begin());
+    return Dependents;
+}
+
+std::vector<String> CachingShaderSourceStreamFactory::CheckForChanges()
+{
+    std::lock_guard<std::mutex> Lock{m_FilesMtx};
+
+    std::vector<String> ChangedFiles;
+    for (auto& it : m_Files)
+    {
+        auto& Info = it.second;
+        if (!Info.pData || !Info.HasTimestamp)
+            continue;
+
+        Uint64 Timestamp = 0;
+        if (!FileSystem::GetFileTimestamp(Info.FullPath.c_str(), Timestamp) || Timestamp != Info.Timestamp)
+        {
+            Info.pData.Release();
+            ChangedFiles.push_back(it.first);
+        }
+    }
+
+    if (ChangedFiles.empty())
+        return ChangedFiles;
+
+    return CollectDependents(std::move(ChangedFiles));
+}
+
+std::vector<String> CachingShaderSourceStreamFactory::Invalidate(const Char* Name)
+{
+    std::lock_guard<std::mutex> Lock{m_FilesMtx};
+
+    auto NormalizedName = NormalizeName(Name);
+
+    auto it = m_Files.find(NormalizedName);
+    if (it != m_Files.end())
+        it->second.pData.Release();
+
+    return CollectDependents({std::move(NormalizedName)});
+}
+
+void CachingShaderSourceStreamFactory::Clear()
+{
+    std::lock_guard<std::mutex> Lock{m_FilesMtx};
+    m_Files.clear();
+}
+
+Uint32 CachingShaderSourceStreamFactory::GetNumCachedFiles() const
+{
+    std::lock_guard<std::mutex> Lock{m_FilesMtx};
+    return static_cast<Uint32>(std::count_if(m_Files.begin(), m_Files.end(),
+                                             [](const std::pair<const String, FileInfo>& it) { return it.second.pData != nullptr; }));
+}
+
+// The callbacks are called after the mutex has been released
+void CachingShaderSourceStreamFactory::EnumerateDependencies(const Char* Name, ShaderSourceFileCallbackType Callback, void* pUserData) const
+{
+    EnumerateNames(GetDependencies(Name), Callback, pUserData);
+}
+
+void CachingShaderSourceStreamFactory::EnumerateDependents(const Char* Name, ShaderSourceFileCallbackType Callback, void* pUserData) const
+{
+    EnumerateNames(GetDependents(Name), Callback, pUserData);
+}
+
+void CachingShaderSourceStreamFactory::CheckForChanges(ShaderSourceFileCallbackType Callback, void* pUserData)
+{
+    EnumerateNames(CheckForChanges(), Callback, pUserData);
+}
+
+void CachingShaderSourceStreamFactory::Invalidate(const Char* Name, ShaderSourceFileCallbackType Callback, void* pUserData)
+{
+    EnumerateNames(Invalidate(Name), Callback, pUserData);
+}
+
+void CreateCachingShaderSourceStreamFactory(const Char*                        SearchDirectories,
+                                            CachingShaderSourceStreamFactory** ppShaderSourceStreamFactory)
+{
+    DEV_CHECK_ERR(ppShaderSourceStreamFactory != nullptr && *ppShaderSourceStreamFactory == nullptr,
+                  "ppShaderSourceStreamFactory must not be null and must point to a null pointer");
+
+    auto& Allocator = GetRawAllocator();
+
+    *ppShaderSourceStreamFactory =
+        NEW_RC_OBJ(Allocator, "CachingShaderSourceStreamFactory instance", CachingShaderSourceStreamFactory)(SearchDirectories);
+    (*ppShaderSourceStreamFactory)->AddRef();
+}
+
+} // namespace Diligent
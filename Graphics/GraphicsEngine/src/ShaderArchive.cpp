@@ -0,0 +1,425 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "ShaderArchive.hpp"
+#include "GraphicsAccessories.hpp"
+#include "DebugUtilities.hpp"
+#include "Align.hpp"
+#include "HashUtils.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+constexpr size_t BlobAlignment = 16;
+
+const Char* GetSourceLanguageKeyName(SHADER_SOURCE_LANGUAGE SourceLanguage)
+{
+    switch (SourceLanguage)
+    {
+        // clang-format off
+        case SHADER_SOURCE_LANGUAGE_DEFAULT:       return "default";
+        case SHADER_SOURCE_LANGUAGE_HLSL:          return "hlsl";
+        case SHADER_SOURCE_LANGUAGE_GLSL:          return "glsl";
+        case SHADER_SOURCE_LANGUAGE_GLSL_VERBATIM: return "glsl_verbatim";
+        // clang-format on
+        default:
+            UNEXPECTED("Unexpected shader source language");
+            return "unknown";
+    }
+}
+
+} // namespace
+
+constexpr Uint32 ShaderArchiveHeader::ExpectedMagic;
+constexpr Uint32 ShaderArchiveHeader::ExpectedVersion;
+constexpr Uint32 ShaderArchiveEntry::InvalidIndex;
+
+std::string GetShaderArchiveKeyString(const ShaderCreateInfo& ShaderCI)
+{
+    std::string KeyString = ShaderCI.FilePath != nullptr ? ShaderCI.FilePath : (ShaderCI.Desc.Name != nullptr ? ShaderCI.Desc.Name : "");
+    std::replace(KeyString.begin(), KeyString.end(), '\\', '/');
+
+    KeyString += '\n';
+    KeyString += GetShaderTypeLiteralName(ShaderCI.Desc.ShaderType);
+    KeyString += '\n';
+    KeyString += ShaderCI.EntryPoint != nullptr ? ShaderCI.EntryPoint : "";
+    KeyString += '\n';
+    KeyString += GetSourceLanguageKeyName(ShaderCI.SourceLanguage);
+    KeyString += '\n';
+    // Texture and sampler names in the compiled shader depend on these options
+    if (ShaderCI.UseCombinedTextureSamplers)
+    {
+        KeyString += "combined_samplers:";
+        KeyString += ShaderCI.CombinedSamplerSuffix != nullptr ? ShaderCI.CombinedSamplerSuffix : "";
+    }
+    else
+    {
+        KeyString += "separate_samplers";
+    }
+    KeyString += '\n';
+
+    // The same permutation may be requested with macros listed in any order
+    std::vector<const ShaderMacro*> Macros;
+    for (const auto* pMacro = ShaderCI.Macros; pMacro != nullptr && pMacro->Name != nullptr; ++pMacro)
+        Macros.push_back(pMacro);
+    std::stable_sort(Macros.begin(), Macros.end(),
+                     [](const ShaderMacro* M1, const ShaderMacro* M2) { return strcmp(M1->Name, M2->Name) < 0; });
+    for (const auto* pMacro : Macros)
+    {
+        KeyString += pMacro->Name;
+        KeyString += '=';
+        KeyString += pMacro->Definition != nullptr ? pMacro->Definition : "";
+        KeyString += '\n';
+    }
+
+    return KeyString;
+}
+
+Uint64 ComputeShaderArchiveKey(const std::string& KeyString)
+{
+    return ComputeFNVHash(KeyString.data(), KeyString.length());
+}
+
+ShaderArchiveGLSLTarget GetShaderArchiveGLSLTarget(const DeviceCaps& Caps)
+{
+    ShaderArchiveGLSLTarget Target;
+#if PLATFORM_WIN32
+    Target.Platform = SHADER_ARCHIVE_PLATFORM_WIN32;
+#elif PLATFORM_UNIVERSAL_WINDOWS
+    Target.Platform = SHADER_ARCHIVE_PLATFORM_UNIVERSAL_WINDOWS;
+#elif PLATFORM_LINUX
+    Target.Platform = SHADER_ARCHIVE_PLATFORM_LINUX;
+#elif PLATFORM_MACOS
+    Target.Platform = SHADER_ARCHIVE_PLATFORM_MACOS;
+#elif PLATFORM_ANDROID
+    Target.Platform = SHADER_ARCHIVE_PLATFORM_ANDROID;
+#elif PLATFORM_IOS
+    Target.Platform = SHADER_ARCHIVE_PLATFORM_IOS;
+#else
+#    error Unexpected platform
+#endif
+    Target.DeviceType   = Caps.DevType;
+    Target.MajorVersion = static_cast<Uint32>(Caps.MajorVersion);
+    Target.MinorVersion = static_cast<Uint32>(Caps.MinorVersion);
+
+    // clang-format off
+    if (Caps.Features.SeparablePrograms)       Target.Features |= SHADER_ARCHIVE_GLSL_FEATURE_SEPARABLE_PROGRAMS;
+    if (Caps.Features.ComputeShaders)          Target.Features |= SHADER_ARCHIVE_GLSL_FEATURE_COMPUTE_SHADERS;
+    if (Caps.TexCaps.CubemapArraysSupported)   Target.Features |= SHADER_ARCHIVE_GLSL_FEATURE_CUBEMAP_ARRAYS;
+    if (Caps.TexCaps.Texture2DMSSupported)     Target.Features |= SHADER_ARCHIVE_GLSL_FEATURE_TEXTURE_2D_MS;
+    // clang-format on
+
+    return Target;
+}
+
+bool IsShaderArchiveGLSLTargetCompatible(const ShaderArchiveGLSLTarget& Target, const DeviceCaps& Caps)
+{
+    const auto DeviceTarget = GetShaderArchiveGLSLTarget(Caps);
+    if (Target.Platform != DeviceTarget.Platform || Target.DeviceType != DeviceTarget.DeviceType)
+        return false;
+
+    if (Target.DeviceType == RENDER_DEVICE_TYPE_GL)
+    {
+        // Desktop GLSL uses the same version directive for all GL versions
+        if (DeviceTarget.MajorVersion < Target.MajorVersion ||
+            (DeviceTarget.MajorVersion == Target.MajorVersion && DeviceTarget.MinorVersion < Target.MinorVersion))
+            return false;
+    }
+    else if (Target.DeviceType == RENDER_DEVICE_TYPE_GLES)
+    {
+        // GLES version directive and extensions are selected for the exact version
+        if (DeviceTarget.MajorVersion != Target.MajorVersion || DeviceTarget.MinorVersion != Target.MinorVersion)
+            return false;
+    }
+    else
+    {
+        return false;
+    }
+
+    // Separable programs change the shader interface (in/out location qualifiers)
+    if ((Target.Features & SHADER_ARCHIVE_GLSL_FEATURE_SEPARABLE_PROGRAMS) != (DeviceTarget.Features & SHADER_ARCHIVE_GLSL_FEATURE_SEPARABLE_PROGRAMS))
+        return false;
+
+    return (Target.Features & ~DeviceTarget.Features) == 0;
+}
+
+std::string GetShaderArchiveGLSLTargetString(const ShaderArchiveGLSLTarget& Target)
+{
+    static const char* const PlatformNames[] = {"Unknown", "Win32", "UWP", "Linux", "MacOS", "Android", "iOS"};
+
+    std::string Str;
+    switch (Target.DeviceType)
+    {
+        case RENDER_DEVICE_TYPE_GL: Str = "GL "; break;
+        case RENDER_DEVICE_TYPE_GLES: Str = "GLES "; break;
+        default: return "no GLSL target";
+    }
+    Str += std::to_string(Target.MajorVersion) + '.' + std::to_string(Target.MinorVersion);
+    Str += " (";
+    Str += Target.Platform < _countof(PlatformNames) ? PlatformNames[Target.Platform] : PlatformNames[0];
+
+    // clang-format off
+    if (Target.Features & SHADER_ARCHIVE_GLSL_FEATURE_SEPARABLE_PROGRAMS) Str += ", separable programs";
+    if (Target.Features & SHADER_ARCHIVE_GLSL_FEATURE_COMPUTE_SHADERS)    Str += ", compute shaders";
+    if (Target.Features & SHADER_ARCHIVE_GLSL_FEATURE_CUBEMAP_ARRAYS)     Str += ", cubemap arrays";
+    if (Target.Features & SHADER_ARCHIVE_GLSL_FEATURE_TEXTURE_2D_MS)      Str += ", 2D MS textures";
+    // clang-format on
+
+    Str += ')';
+    return Str;
+}
+
+
+Uint32 ShaderArchiveWriter::AddBlob(const void* pData, size_t Size)
+{
+    if (Size == 0)
+        return ShaderArchiveEntry::InvalidIndex;
+
+    m_Stats.TotalBlobSize += Size;
+
+    const auto Hash  = ComputeFNVHash(pData, Size);
+    auto       Range = m_BlobHashes.equal_range(Hash);
+    for (auto it = Range.first; it != Range.second; ++it)
+    {
+        const auto& Blob = m_Blobs[it->second];
+        if (Blob.size() == Size && memcmp(Blob.data(), pData, Size) == 0)
+        {
+            ++m_Stats.NumDuplicateBlobs;
+            return it->second;
+        }
+    }
+
+    const auto  BlobIndex = static_cast<Uint32>(m_Blobs.size());
+    const auto* pBytes    = static_cast<const Uint8*>(pData);
+    m_Blobs.emplace_back(pBytes, pBytes + Size);
+    m_BlobHashes.emplace(Hash, BlobIndex);
+
+    m_Stats.NumBlobs = static_cast<Uint32>(m_Blobs.size());
+    m_Stats.UniqueBlobSize += Size;
+    return BlobIndex;
+}
+
+bool ShaderArchiveWriter::AddShader(const ShaderCreateInfo&    ShaderCI,
+                                    const std::vector<Uint32>& SPIRV,
+                                    const std::string&         GLSL)
+{
+    DEV_CHECK_ERR(GLSL.empty() || m_GLSLTarget.DeviceType != RENDER_DEVICE_TYPE_UNDEFINED,
+                  "GLSL target must be set before GLSL source is added to the archive");
+
+    Shader NewShader;
+    NewShader.KeyString = GetShaderArchiveKeyString(ShaderCI);
+    NewShader.Key       = ComputeShaderArchiveKey(NewShader.KeyString);
+
+    auto Range = m_ShaderKeys.equal_range(NewShader.Key);
+    for (auto it = Range.first; it != Range.second; ++it)
+    {
+        if (m_Shaders[it->second].KeyString == NewShader.KeyString)
+            return false;
+    }
+    m_ShaderKeys.emplace(NewShader.Key, static_cast<Uint32>(m_Shaders.size()));
+
+    NewShader.SPIRVBlob = AddBlob(SPIRV.data(), SPIRV.size() * sizeof(Uint32));
+    NewShader.GLSLBlob  = AddBlob(GLSL.data(), GLSL.length());
+    m_Shaders.emplace_back(std::move(NewShader));
+    m_Stats.NumShaders = static_cast<Uint32>(m_Shaders.size());
+
+    return true;
+}
+
+void ShaderArchiveWriter::Serialize(std::vector<Uint8>& Data) const
+{
+    ShaderArchiveHeader Header;
+    Header.GLSLTarget = m_GLSLTarget;
+    Header.NumShaders = static_cast<Uint32>(m_Shaders.size());
+    Header.NumBlobs   = static_cast<Uint32>(m_Blobs.size());
+
+    // Keep the load factor at or below 0.5 so that probe sequences stay short
+    Header.HashTableSize = 1;
+    while (Header.HashTableSize < Header.NumShaders * 2)
+        Header.HashTableSize *= 2;
+
+    std::vector<Uint32> HashTable(Header.HashTableSize, ShaderArchiveEntry::InvalidIndex);
+
+    std::vector<ShaderArchiveEntry> Entries(m_Shaders.size());
+    std::string                     KeyStrings;
+    for (Uint32 i = 0; i < Header.NumShaders; ++i)
+    {
+        const auto& Src = m_Shaders[i];
+        auto&       Dst = Entries[i];
+
+        Dst.Key             = Src.Key;
+        Dst.KeyStringOffset = static_cast<Uint32>(KeyStrings.length());
+        Dst.KeyStringLength = static_cast<Uint32>(Src.KeyString.length());
+        Dst.SPIRVBlob       = Src.SPIRVBlob;
+        Dst.GLSLBlob        = Src.GLSLBlob;
+        KeyStrings += Src.KeyString;
+
+        auto Slot = static_cast<Uint32>(Src.Key) & (Header.HashTableSize - 1);
+        while (HashTable[Slot] != ShaderArchiveEntry::InvalidIndex)
+            Slot = (Slot + 1) & (Header.HashTableSize - 1);
+        HashTable[Slot] = i;
+    }
+
+    Header.HashTableOffset  = sizeof(ShaderArchiveHeader);
+    Header.EntriesOffset    = Align(Header.HashTableOffset + sizeof(Uint32) * Header.HashTableSize, Uint64{alignof(ShaderArchiveEntry)});
+    Header.BlobTableOffset  = Header.EntriesOffset + sizeof(ShaderArchiveEntry) * Header.NumShaders;
+    Header.KeyStringsOffset = Header.BlobTableOffset + sizeof(ShaderArchiveBlob) * Header.NumBlobs;
+    Header.KeyStringsSize   = KeyStrings.length();
+
+    std::vector<ShaderArchiveBlob> BlobTable(m_Blobs.size());
+    auto                           BlobOffset = Align(Header.KeyStringsOffset + Header.KeyStringsSize, Uint64{BlobAlignment});
+    for (size_t i = 0; i < m_Blobs.size(); ++i)
+    {
+        BlobTable[i].Offset = BlobOffset;
+        BlobTable[i].Size   = m_Blobs[i].size();
+        BlobOffset          = Align(BlobOffset + BlobTable[i].Size, Uint64{BlobAlignment});
+    }
+
+    Data.clear();
+    Data.resize(static_cast<size_t>(BlobOffset));
+
+    auto* pDst = Data.data();
+    memcpy(pDst, &Header, sizeof(Header));
+    memcpy(pDst + Header.HashTableOffset, HashTable.data(), sizeof(Uint32) * HashTable.size());
+    if (!Entries.empty())
+        memcpy(pDst + Header.EntriesOffset, Entries.data(), sizeof(ShaderArchiveEntry) * Entries.size());
+    if (!BlobTable.empty())
+        memcpy(pDst + Header.BlobTableOffset, BlobTable.data(), sizeof(ShaderArchiveBlob) * BlobTable.size());
+    if (!KeyStrings.empty())
+        memcpy(pDst + Header.KeyStringsOffset, KeyStrings.data(), KeyStrings.length());
+    for (size_t i = 0; i < m_Blobs.size(); ++i)
+        memcpy(pDst + BlobTable[i].Offset, m_Blobs[i].data(), m_Blobs[i].size());
+}
+
+
+ShaderArchiveReader::ShaderArchiveReader(const void* pData, size_t Size) :
+    m_pData{static_cast<const Uint8*>(pData)},
+    m_Size{Size}
+{
+    if (m_pData == nullptr || m_Size < sizeof(ShaderArchiveHeader))
+        LOG_ERROR_AND_THROW("Shader archive data is too small");
+
+    m_pHeader = reinterpret_cast<const ShaderArchiveHeader*>(m_pData);
+    if (m_pHeader->Magic != ShaderArchiveHeader::ExpectedMagic)
+        LOG_ERROR_AND_THROW("Invalid shader archive magic number");
+    if (m_pHeader->Version != ShaderArchiveHeader::ExpectedVersion)
+        LOG_ERROR_AND_THROW("Unsupported shader archive version (", m_pHeader->Version, "). Expected version: ", ShaderArchiveHeader::ExpectedVersion);
+
+    const auto HashTableSize = m_pHeader->HashTableSize;
+    if (HashTableSize == 0 || (HashTableSize & (HashTableSize - 1)) != 0 || HashTableSize < m_pHeader->NumShaders)
+        LOG_ERROR_AND_THROW("Invalid shader archive hash table size (", HashTableSize, ")");
+
+    // clang-format off
+    if (m_pHeader->HashTableOffset  + Uint64{sizeof(Uint32)}             * HashTableSize          > m_Size ||
+        m_pHeader->EntriesOffset    + Uint64{sizeof(ShaderArchiveEntry)} * m_pHeader->NumShaders > m_Size ||
+        m_pHeader->BlobTableOffset  + Uint64{sizeof(ShaderArchiveBlob)}  * m_pHeader->NumBlobs   > m_Size ||
+        m_pHeader->KeyStringsOffset + m_pHeader->KeyStringsSize                                  > m_Size)
+        LOG_ERROR_AND_THROW("Shader archive data is truncated");
+
+    if (m_pHeader->HashTableOffset % alignof(Uint32)             != 0 ||
+        m_pHeader->EntriesOffset   % alignof(ShaderArchiveEntry) != 0 ||
+        m_pHeader->BlobTableOffset % alignof(ShaderArchiveBlob)  != 0)
+        LOG_ERROR_AND_THROW("Shader archive tables are misaligned");
+    // clang-format on
+
+    m_pHashTable = reinterpret_cast<const Uint32*>(m_pData + m_pHeader->HashTableOffset);
+    m_pEntries   = reinterpret_cast<const ShaderArchiveEntry*>(m_pData + m_pHeader->EntriesOffset);
+    m_pBlobs     = reinterpret_cast<const ShaderArchiveBlob*>(m_pData + m_pHeader->BlobTableOffset);
+    m_KeyStrings = reinterpret_cast<const char*>(m_pData + m_pHeader->KeyStringsOffset);
+}
+
+bool ShaderArchiveReader::GetBlob(Uint32 BlobIndex, const Uint8*& pBlobData, size_t& BlobSize) const
+{
+    if (BlobIndex >= m_pHeader->NumBlobs)
+        return false;
+
+    const auto& Blob = m_pBlobs[BlobIndex];
+    if (Blob.Offset > m_Size || Blob.Size > m_Size - Blob.Offset)
+    {
+        LOG_ERROR_MESSAGE("Blob ", BlobIndex, " is out of the shader archive bounds");
+        return false;
+    }
+
+    pBlobData = m_pData + Blob.Offset;
+    BlobSize  = static_cast<size_t>(Blob.Size);
+    return true;
+}
+
+bool ShaderArchiveReader::FindShader(const ShaderCreateInfo& ShaderCI, ShaderData& Data) const
+{
+    return FindShader(GetShaderArchiveKeyString(ShaderCI), Data);
+}
+
+bool ShaderArchiveReader::FindShader(const std::string& KeyString, ShaderData& Data) const
+{
+    const auto Key  = ComputeShaderArchiveKey(KeyString);
+    const auto Mask = m_pHeader->HashTableSize - 1;
+
+    // The number of probes is bounded to protect against corrupted tables with no empty slots
+    auto Slot = static_cast<Uint32>(Key) & Mask;
+    for (Uint32 Probe = 0; Probe < m_pHeader->HashTableSize; ++Probe, Slot = (Slot + 1) & Mask)
+    {
+        const auto EntryIdx = m_pHashTable[Slot];
+        if (EntryIdx == ShaderArchiveEntry::InvalidIndex)
+            break;
+        if (EntryIdx >= m_pHeader->NumShaders)
+            continue;
+
+        const auto& Entry = m_pEntries[EntryIdx];
+        if (Entry.Key != Key || Entry.KeyStringLength != KeyString.length())
+            continue;
+        if (Uint64{Entry.KeyStringOffset} + Entry.KeyStringLength > m_pHeader->KeyStringsSize ||
+            memcmp(KeyString.data(), m_KeyStrings + Entry.KeyStringOffset, KeyString.length()) != 0)
+            continue;
+
+        Data = ShaderData{};
+
+        const Uint8* pBlobData = nullptr;
+        size_t       BlobSize  = 0;
+        if (GetBlob(Entry.SPIRVBlob, pBlobData, BlobSize))
+        {
+            Data.pSPIRV    = pBlobData;
+            Data.SPIRVSize = BlobSize;
+        }
+        if (GetBlob(Entry.GLSLBlob, pBlobData, BlobSize))
+        {
+            Data.GLSL       = reinterpret_cast<const char*>(pBlobData);
+            Data.GLSLLength = BlobSize;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace Diligent
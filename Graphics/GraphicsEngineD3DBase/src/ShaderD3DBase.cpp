@@ -128,6 +128,9 @@ static HRESULT CompileShader(const char*                      Source,
 
 ShaderD3DBase::ShaderD3DBase(const ShaderCreateInfo& ShaderCI, const char* ShaderModel)
 {
+    if (ShaderCI.pShaderArchive != nullptr)
+        LOG_ERROR_AND_THROW("Shader archives are not supported in Direct3D backends");
+
     if (ShaderCI.Source || ShaderCI.FilePath)
     {
         DEV_CHECK_ERR(ShaderCI.ByteCode == nullptr, "'ByteCode' must be null when shader is created from the source code or a file");
@@ -81,6 +81,15 @@ public:
     /// Implementation of IBufferGL::GetGLBufferHandle().
     virtual GLuint DILIGENT_CALL_TYPE GetGLBufferHandle() override final { return GetGLHandle(); }
 
+    /// Implementation of IBufferGL::GetGLBufferOffset().
+    virtual Uint32 DILIGENT_CALL_TYPE GetGLBufferOffset() override final { return m_Suballocation.Offset; }
+
+    /// Returns true if the buffer is suballocated from the uniform buffer arena.
+    bool IsSuballocated() const { return m_Suballocation.IsValid(); }
+
+    /// Implementation of IBufferGL::GetPersistentMappedData().
+    virtual void* DILIGENT_CALL_TYPE GetPersistentMappedData() override final { return m_pPersistentMappedData; }
+
     /// Implementation of IBuffer::GetNativeHandle() in OpenGL backend.
     virtual void* DILIGENT_CALL_TYPE GetNativeHandle() override final
     {
@@ -93,9 +102,22 @@ private:
     friend class DeviceContextGLImpl;
     friend class VAOCache;
 
+    // Range of the uniform buffer arena page that holds the buffer data.
+    // Must be declared before m_GlBuffer that is initialized with the page handle.
+    GLUniformBufferArena::Allocation m_Suballocation;
+
     GLObjectWrappers::GLBufferObj m_GlBuffer;
     const Uint32                  m_BindTarget;
     const GLenum                  m_GLUsageHint;
+    // Use direct state access functions instead of binding the buffer to the context
+    const bool m_UseDSA;
+
+#if GL_ARB_buffer_storage
+    static constexpr GLbitfield PersistentMapAccess = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+#endif
+    // Pointer to the persistently mapped data of staging upload buffers,
+    // or null if the buffer is not persistently mapped.
+    PVoid m_pPersistentMappedData = nullptr;
 };
 
 } // namespace Diligent
@@ -45,10 +45,11 @@ public:
 
     BufferViewGLImpl(IReferenceCounters*   pRefCounters,
                      RenderDeviceGLImpl*   pDevice,
-                     IDeviceContext*       pContext,
+                     GLContextState&       GLState,
                      const BufferViewDesc& ViewDesc,
                      BufferGLImpl*         pBuffer,
                      bool                  bIsDefaultView);
+    ~BufferViewGLImpl();
 
     /// Queries the specific interface, see IObject::QueryInterface() for details
     virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) override final;
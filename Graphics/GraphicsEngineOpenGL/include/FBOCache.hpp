@@ -56,7 +56,9 @@ public:
                                                      TextureViewGLImpl*    pDSV,
                                                      class GLContextState& ContextState);
 
-    void OnReleaseTexture(ITexture* pTexture);
+    // The texture is identified by its unique ID, because the cache may be updated
+    // after the texture has been destroyed (see RenderDeviceGLImpl::OnReleaseTexture).
+    void OnReleaseTexture(UniqueIdentifier TexId);
 
 private:
     // This structure is used as the key to find FBO
@@ -50,6 +50,12 @@ public:
 
     NativeGLContextType GetCurrentNativeGLContext();
 
+    // Shared contexts are not used on Android as the main context may be lost and recreated
+    // when the application is suspended and resumed.
+    NativeGLContextType CreateSharedContext() { return EGL_NO_CONTEXT; }
+    bool                MakeSharedContextCurrent(NativeGLContextType) { return false; }
+    void                DestroySharedContext(NativeGLContextType) {}
+
     int32_t GetScreenWidth() const { return screen_width_; }
     int32_t GetScreenHeight() const { return screen_height_; }
 
@@ -37,10 +37,23 @@ public:
 
     NativeGLContextType GetCurrentNativeGLContext();
 
+    /// Creates a context that shares objects with the context that is current on the calling thread.
+    /// Returns null if the context could not be created.
+    NativeGLContextType CreateSharedContext();
+
+    /// Makes the shared context current on the calling thread without binding any drawable.
+    /// If Context is null, releases the current context of the calling thread.
+    bool MakeSharedContextCurrent(NativeGLContextType Context);
+
+    void DestroySharedContext(NativeGLContextType Context);
+
 private:
     Uint32              m_WindowId = 0;
     void*               m_pDisplay = nullptr;
     NativeGLContextType m_Context;
+
+    // Display connection of the context that shared contexts were created from
+    void* m_pSharedContextDisplay = nullptr;
 };
 
 } // namespace Diligent
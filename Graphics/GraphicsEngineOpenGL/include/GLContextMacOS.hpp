@@ -34,6 +34,11 @@ public:
     GLContext(const struct EngineGLCreateInfo& InitAttribs, struct DeviceCaps& DeviceCaps, const struct SwapChainDesc* pSCDesc);
 
     NativeGLContextType GetCurrentNativeGLContext();
+
+    // Shared contexts are not supported on this platform.
+    NativeGLContextType CreateSharedContext() { return nullptr; }
+    bool                MakeSharedContextCurrent(NativeGLContextType) { return false; }
+    void                DestroySharedContext(NativeGLContextType) {}
 };
 
 } // namespace Diligent
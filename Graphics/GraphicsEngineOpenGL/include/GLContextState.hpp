@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <limits>
+
 #include "GraphicsTypes.h"
 #include "GLObjectWrapper.hpp"
 #include "UniqueIdentifier.hpp"
@@ -48,7 +50,7 @@ public:
     void BindFBO           (const GLObjectWrappers::GLFrameBufferObj& FBO);
     void SetActiveTexture  (Int32 Index);
     void BindTexture       (Int32 Index, GLenum BindTarget, const GLObjectWrappers::GLTextureObj& Tex);
-    void BindUniformBuffer (Int32 Index,       const GLObjectWrappers::GLBufferObj& Buff);
+    void BindUniformBuffer (Int32 Index,       const GLObjectWrappers::GLBufferObj& Buff, GLintptr Offset = 0, GLsizeiptr Size = 0);
     void BindBuffer        (GLenum BindTarget, const GLObjectWrappers::GLBufferObj& Buff, bool ResetVAO);
     void BindSampler       (Uint32 Index,      const GLObjectWrappers::GLSamplerObj& GLSampler);
     void BindImage         (Uint32 Index, class TextureViewGLImpl* pTexView, GLint MipLevel, GLboolean IsLayered, GLint Layer, GLenum Access, GLenum Format);
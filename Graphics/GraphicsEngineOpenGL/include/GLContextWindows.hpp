@@ -41,9 +41,22 @@ public:
 
     NativeGLContextType GetCurrentNativeGLContext();
 
+    /// Creates a context that shares objects with the context that is current on the calling thread.
+    /// Returns null if the context could not be created.
+    NativeGLContextType CreateSharedContext();
+
+    /// Makes the shared context current on the calling thread.
+    /// If Context is null, releases the current context of the calling thread.
+    bool MakeSharedContextCurrent(NativeGLContextType Context);
+
+    void DestroySharedContext(NativeGLContextType Context);
+
 private:
     HGLRC m_Context                     = NULL;
     HDC   m_WindowHandleToDeviceContext = NULL;
+
+    // Device context that shared contexts were created with
+    HDC m_SharedContextDC = NULL;
 };
 
 } // namespace Diligent
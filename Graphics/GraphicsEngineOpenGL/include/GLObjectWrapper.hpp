@@ -129,14 +129,20 @@ private:
 class GLBufferObjCreateReleaseHelper
 {
 public:
-    explicit GLBufferObjCreateReleaseHelper(GLuint ExternalGLBufferHandle = 0) :
-        m_ExternalGLBufferHandle{ExternalGLBufferHandle}
+    explicit GLBufferObjCreateReleaseHelper(GLuint ExternalGLBufferHandle = 0, bool UseDSA = false) :
+        m_ExternalGLBufferHandle{ExternalGLBufferHandle},
+        m_UseDSA{UseDSA}
     {}
 
     void Create(GLuint& BuffObj)
     {
         if (m_ExternalGLBufferHandle != 0)
             BuffObj = m_ExternalGLBufferHandle; // Attach to external GL buffer handle
+#if GL_ARB_direct_state_access
+        else if (m_UseDSA)
+            glCreateBuffers(1, &BuffObj); // Unlike glGenBuffers, creates the buffer object, so that
+                                          // it can be used by DSA functions without binding it first
+#endif
         else
             glGenBuffers(1, &BuffObj);
     }
@@ -152,6 +158,7 @@ public:
 
 private:
     GLuint m_ExternalGLBufferHandle;
+    bool   m_UseDSA;
 };
 typedef GLObjWrapper<GLBufferObjCreateReleaseHelper> GLBufferObj;
 
@@ -208,14 +215,20 @@ typedef GLObjWrapper<GLVAOCreateReleaseHelper> GLVertexArrayObj;
 class GLTextureCreateReleaseHelper
 {
 public:
-    explicit GLTextureCreateReleaseHelper(GLuint ExternalGLTextureHandle = 0) :
-        m_ExternalGLTextureHandle(ExternalGLTextureHandle)
+    // If DSATarget is not zero, the texture is created with glCreateTextures() for this target.
+    explicit GLTextureCreateReleaseHelper(GLuint ExternalGLTextureHandle = 0, GLenum DSATarget = 0) :
+        m_ExternalGLTextureHandle(ExternalGLTextureHandle),
+        m_DSATarget(DSATarget)
     {}
 
     void Create(GLuint& Tex)
     {
         if (m_ExternalGLTextureHandle != 0)
             Tex = m_ExternalGLTextureHandle; // Attach to the external texture
+#if GL_ARB_direct_state_access
+        else if (m_DSATarget != 0)
+            glCreateTextures(m_DSATarget, 1, &Tex);
+#endif
         else
             glGenTextures(1, &Tex);
     }
@@ -232,6 +245,7 @@ public:
 
 private:
     GLuint m_ExternalGLTextureHandle;
+    GLenum m_DSATarget;
 };
 typedef GLObjWrapper<GLTextureCreateReleaseHelper> GLTextureObj;
 
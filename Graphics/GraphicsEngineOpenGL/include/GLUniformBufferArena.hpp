@@ -0,0 +1,116 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "MemoryAllocator.h"
+#include "VariableSizeAllocationsManager.hpp"
+#include "GLObjectWrapper.hpp"
+
+namespace Diligent
+{
+
+class GLContextState;
+
+/// Pool of large GL buffers that small uniform buffers are suballocated from.
+
+/// Every uniform buffer that is not accessed by the CPU and is small enough is placed into
+/// a range of one of the shared page buffers instead of having its own GL buffer object.
+/// Ranges are aligned by GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT and are bound with glBindBufferRange.
+/// A released range is returned to the free list only after the GPU has completed all
+/// commands issued before the release (see ReleaseStaleAllocations()).
+class GLUniformBufferArena
+{
+public:
+    struct Allocation
+    {
+        GLuint GLHandle        = 0; // GL handle of the page buffer
+        Uint32 PageIndex       = 0;
+        Uint32 Offset          = 0; // Aligned offset of the range in the page buffer
+        Uint32 UnalignedOffset = 0;
+        Uint32 Size            = 0; // Size reserved in the page, including the alignment
+
+        bool IsValid() const { return GLHandle != 0; }
+    };
+
+    GLUniformBufferArena(IMemoryAllocator& Allocator, Uint32 PageSize, Uint32 OffsetAlignment);
+
+    // clang-format off
+    GLUniformBufferArena             (const GLUniformBufferArena&)  = delete;
+    GLUniformBufferArena             (      GLUniformBufferArena&&) = delete;
+    GLUniformBufferArena& operator = (const GLUniformBufferArena&)  = delete;
+    GLUniformBufferArena& operator = (      GLUniformBufferArena&&) = delete;
+    // clang-format on
+
+    /// Returns the maximum size of the uniform buffer that is suballocated from the arena.
+    Uint32 GetMaxAllocationSize() const { return m_MaxAllocationSize; }
+
+    /// Allocates the range from one of the pages, creating a new page if necessary.
+    /// The state is only used to bind the new page buffer when DSA is not available.
+    Allocation Allocate(Uint32 Size, GLContextState& GLState, bool UseDSA);
+
+    /// Queues the range for release. May be called by any thread.
+    void Free(Allocation&& Alloc);
+
+    /// Returns the ranges whose last use has completed on the GPU to the free list.
+    /// Must be called by the thread that owns the main GL context.
+    void ReleaseStaleAllocations(bool ForceRelease);
+
+private:
+    struct Page
+    {
+        Page(GLObjectWrappers::GLBufferObj&& _Buffer, Uint32 PageSize, IMemoryAllocator& Allocator) :
+            Buffer{std::move(_Buffer)},
+            AllocationsMgr{PageSize, Allocator}
+        {}
+
+        GLObjectWrappers::GLBufferObj  Buffer;
+        VariableSizeAllocationsManager AllocationsMgr;
+    };
+
+    void FreeAllocations(const std::vector<Allocation>& Allocations);
+
+    IMemoryAllocator& m_Allocator;
+    const Uint32      m_PageSize;
+    const Uint32      m_OffsetAlignment;
+    const Uint32      m_MaxAllocationSize;
+
+    std::mutex                         m_Mtx;
+    std::vector<std::unique_ptr<Page>> m_Pages;
+
+    // Ranges released since the last call to ReleaseStaleAllocations()
+    std::vector<Allocation> m_StaleAllocations;
+    // Ranges that will be returned to the free list when the fence is signaled
+    std::deque<std::pair<GLObjectWrappers::GLSyncObj, std::vector<Allocation>>> m_PendingReleases;
+};
+
+} // namespace Diligent
@@ -0,0 +1,119 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <future>
+
+#include "GLContext.hpp"
+#include "GLObjectWrapper.hpp"
+
+namespace Diligent
+{
+
+class RenderDeviceGLImpl;
+class GLContextState;
+
+/// Pool of worker threads that own GL contexts sharing objects with the main GL context.
+
+/// Threads that have no current GL context cannot issue GL commands. Resource creation
+/// requested by such threads is executed by the pool: every worker makes its shared context
+/// current and processes jobs one at a time. When a job is complete, the worker inserts a fence
+/// into its context that the main context waits for (see WaitPendingFences()) before using
+/// objects created by the job.
+class GLWorkerContextPool
+{
+public:
+    /// Creates NumThreads shared contexts and starts the worker threads.
+    /// Must be called by the thread that owns the main GL context.
+    GLWorkerContextPool(RenderDeviceGLImpl* pDeviceGL, GLContext& MainContext, Uint32 NumThreads);
+    ~GLWorkerContextPool();
+
+    // clang-format off
+    GLWorkerContextPool             (const GLWorkerContextPool&)  = delete;
+    GLWorkerContextPool             (      GLWorkerContextPool&&) = delete;
+    GLWorkerContextPool& operator = (const GLWorkerContextPool&)  = delete;
+    GLWorkerContextPool& operator = (      GLWorkerContextPool&&) = delete;
+    // clang-format on
+
+    /// Executes the job on one of the worker threads and waits until it is complete.
+    /// An exception thrown by the job is rethrown on the calling thread.
+    void Execute(std::function<void()> Job);
+
+    /// Makes the current context wait on the GPU for all jobs that have been completed
+    /// by the worker threads. Must be called by the thread that owns the main GL context.
+    void WaitPendingFences();
+
+    Uint32 GetNumThreads() const { return static_cast<Uint32>(m_Threads.size()); }
+
+    /// Returns the context state of the calling worker thread, or null if the
+    /// calling thread is not a worker thread.
+    static GLContextState* GetThreadContextState();
+
+private:
+    void WorkerThreadFunc(GLContext::NativeGLContextType SharedContext, std::promise<bool>& InitResult);
+    void Shutdown();
+
+    struct JobInfo
+    {
+        JobInfo() noexcept {}
+
+        JobInfo(std::function<void()>&& _Job, std::promise<void>* _pCompletion) :
+            // clang-format off
+            Job        {std::move(_Job)},
+            pCompletion{_pCompletion   }
+        // clang-format on
+        {}
+
+        std::function<void()> Job;
+        std::promise<void>*   pCompletion = nullptr;
+    };
+
+    RenderDeviceGLImpl* const m_pDeviceGL;
+    GLContext&                m_MainContext;
+
+    std::vector<GLContext::NativeGLContextType> m_SharedContexts;
+    std::vector<std::thread>                    m_Threads;
+
+    std::mutex              m_JobsMtx;
+    std::condition_variable m_JobsCondVar;
+    std::deque<JobInfo>     m_Jobs;
+    bool                    m_Stop = false;
+
+    std::mutex                               m_FencesMtx;
+    std::vector<GLObjectWrappers::GLSyncObj> m_PendingFences;
+    std::atomic_uint32_t                     m_NumPendingFences{0};
+};
+
+} // namespace Diligent
@@ -28,12 +28,15 @@
 #pragma once
 
 #include <memory>
+#include <atomic>
 #include "RenderDeviceBase.hpp"
 #include "GLContext.hpp"
 #include "VAOCache.hpp"
 #include "BaseInterfacesGL.h"
 #include "FBOCache.hpp"
 #include "TexRegionRender.hpp"
+#include "GLWorkerContextPool.hpp"
+#include "GLUniformBufferArena.hpp"
 
 enum class GPU_VENDOR
 {
@@ -131,14 +134,76 @@ public:
                                                        RESOURCE_STATE     InitialState,
                                                        ITexture**         ppTexture) override final;
 
+    /// Returns the context state that must be used to create resources on the calling thread.
+    GLContextState& GetCreationContextState();
+
+    /// If the calling thread has no current GL context and resource creation worker threads are
+    /// enabled, executes the handler on one of the worker threads and returns true.
+    /// Otherwise returns false, and the caller is expected to execute the handler itself.
+    template <typename HandlerType>
+    bool DispatchToWorkerContext(HandlerType&& Handler)
+    {
+        if (!m_pWorkerContexts || m_GLContext.GetCurrentNativeGLContext() != GLContext::NativeGLContextType{})
+            return false;
+
+        m_pWorkerContexts->Execute(std::forward<HandlerType>(Handler));
+        return true;
+    }
+
+    /// Releases the GL object. Objects released by threads that have no current
+    /// GL context are released by the resource creation worker threads.
+    template <typename GLObjectType>
+    void ReleaseGLObject(GLObjectType& GLObject)
+    {
+        if (!DispatchToWorkerContext([&GLObject]() { GLObject.Release(); }))
+            GLObject.Release();
+    }
+
+    /// Makes the current context wait for the resources created by the worker threads.
+    void WaitWorkerContextFences()
+    {
+        if (m_pWorkerContexts)
+            m_pWorkerContexts->WaitPendingFences();
+    }
+
     /// Implementation of IRenderDevice::ReleaseStaleResources() in OpenGL backend.
-    virtual void DILIGENT_CALL_TYPE ReleaseStaleResources(bool ForceRelease = false) override final {}
+    virtual void DILIGENT_CALL_TYPE ReleaseStaleResources(bool ForceRelease = false) override final;
 
     /// Implementation of IRenderDevice::IdleGPU() in OpenGL backend.
     virtual void DILIGENT_CALL_TYPE IdleGPU() override final;
 
     const GPUInfo& GetGPUInfo() { return m_GPUInfo; }
 
+    /// Returns the arena that small uniform buffers are suballocated from, or null if suballocation is disabled.
+    GLUniformBufferArena* GetUniformBufferArena() { return m_pUniformBufferArena.get(); }
+
+    /// Returns true if shaders converted from HLSL only include the referenced GLSL definitions,
+    /// see EngineGLCreateInfo::FilterHLSL2GLSLDefinitions.
+    bool GetFilterHLSL2GLSLDefinitions() const { return m_FilterHLSL2GLSLDefinitions; }
+
+    /// OpenGL-specific capabilities that are not exposed through DeviceCaps
+    struct GLCaps
+    {
+        /// Indicates if immutable buffer storage (glBufferStorage) is supported
+        bool BufferStorage = false;
+
+        /// Indicates if separate vertex attribute format and buffer binding (glBindVertexBuffer) is supported
+        bool VertexAttribBinding = false;
+
+        /// Maximum relative offset of a vertex attribute within its binding (GL_MAX_VERTEX_ATTRIB_RELATIVE_OFFSET).
+        /// Only valid if VertexAttribBinding is true.
+        Uint32 MaxVertexAttribRelativeOffset = 0;
+
+        /// Indicates if direct state access functions (glCreateBuffers, glNamedBufferSubData,
+        /// glTextureSubImage* etc.) are supported. When this flag is set, buffers and textures are
+        /// created and updated without binding them to the context.
+        bool DirectStateAccess = false;
+    };
+    const GLCaps& GetGLCaps() const { return m_GLCaps; }
+
+    // Objects may be released by any thread, but VAOs and FBOs are not shared between contexts and can only
+    // be deleted by the thread that owns the context. Caches of contexts that are not current on the calling
+    // thread are updated later by PurgeReleasedObjects().
     FBOCache& GetFBOCache(GLContext::NativeGLContextType Context);
     void      OnReleaseTexture(ITexture* pTexture);
 
@@ -146,6 +211,14 @@ public:
     void      OnDestroyPSO(IPipelineState* pPSO);
     void      OnDestroyBuffer(IBuffer* pBuffer);
 
+    /// Removes the objects released by other threads from the VAO and FBO caches of the context.
+    /// Must be called by the thread that owns the context.
+    void PurgeReleasedObjects(GLContext::NativeGLContextType Context)
+    {
+        if (m_NumReleasedObjects.load() != 0)
+            PurgeReleasedObjectsImpl(Context);
+    }
+
     size_t GetCommandQueueCount() const { return 1; }
     Uint64 GetCommandQueueMask() const { return Uint64{1}; }
 
@@ -172,15 +245,36 @@ protected:
     ThreadingTools::LockFlag                                     m_FBOCacheLockFlag;
     std::unordered_map<GLContext::NativeGLContextType, FBOCache> m_FBOCache;
 
+    // Unique IDs of the objects that must be removed from the caches of every context
+    struct ReleasedObjects
+    {
+        std::vector<UniqueIdentifier> Textures;
+        std::vector<UniqueIdentifier> Buffers;
+        std::vector<UniqueIdentifier> PSOs;
+    };
+    ThreadingTools::LockFlag                                            m_ReleasedObjectsLockFlag;
+    std::unordered_map<GLContext::NativeGLContextType, ReleasedObjects> m_ReleasedObjects;
+    std::atomic_uint32_t                                                m_NumReleasedObjects{0};
+
     GPUInfo m_GPUInfo;
+    GLCaps  m_GLCaps;
 
     std::unique_ptr<TexRegionRender> m_pTexRegionRender;
 
+    // Worker threads that create resources requested by threads with no current GL context
+    std::unique_ptr<GLWorkerContextPool> m_pWorkerContexts;
+
+    std::unique_ptr<GLUniformBufferArena> m_pUniformBufferArena;
+
+    const bool m_FilterHLSL2GLSLDefinitions;
+
 private:
     virtual void TestTextureFormat(TEXTURE_FORMAT TexFormat) override final;
     bool         CheckExtension(const Char* ExtensionString);
     void         FlagSupportedTexFormats();
     void         QueryDeviceCaps();
+    void         AddReleasedObject(GLContext::NativeGLContextType Context, std::vector<UniqueIdentifier> ReleasedObjects::*pObjects, UniqueIdentifier UId);
+    void         PurgeReleasedObjectsImpl(GLContext::NativeGLContextType Context);
 };
 
 } // namespace Diligent
@@ -126,12 +126,17 @@ protected:
                                     ITextureView**                ppView,
                                     bool                          bIsDefaultView) override;
 
+    /// Sets default texture parameters. Unless direct state access is used,
+    /// the texture must be bound to the context.
     void SetDefaultGLParameters();
 
     GLObjectWrappers::GLTextureObj m_GlTexture;
     RefCntAutoPtr<IBuffer>         m_pPBO; // For staging textures
     const GLenum                   m_BindTarget;
     const GLenum                   m_GLTexFormat;
+    // Use direct state access functions (glTextureStorage*, glTextureSubImage* etc.)
+    // instead of binding the texture to the context
+    const bool m_UseDSA;
     //Uint32 m_uiMapTarget;
 };
 
@@ -28,6 +28,7 @@
 #pragma once
 
 #include <cstring>
+#include <vector>
 #include "GraphicsTypes.h"
 #include "Buffer.h"
 #include "InputLayout.h"
@@ -59,8 +60,22 @@ public:
                                                      class GLContextState&                GLContextState);
     const GLObjectWrappers::GLVertexArrayObj& GetEmptyVAO();
 
-    void OnDestroyBuffer(IBuffer* pBuffer);
-    void OnDestroyPSO(IPipelineState* pPSO);
+    // Returns the VAO that encapsulates the vertex format of the PSO's input layout and binds the
+    // vertex and index buffers to it using separate attribute format/binding (GL4.3+, GL_ARB_vertex_attrib_binding).
+    // One VAO is created per unique input layout, and buffer bindings are only updated when they change.
+    // Returns null if the layout can't be expressed with separate format/binding (e.g. an attribute's
+    // relative offset exceeds MaxRelativeOffset), in which case GetVAO() must be used.
+    const GLObjectWrappers::GLVertexArrayObj* GetLayoutVAO(IPipelineState*                      pPSO,
+                                                           IBuffer*                             pIndexBuffer,
+                                                           VertexStreamInfo<class BufferGLImpl> VertexStreams[],
+                                                           Uint32                               NumVertexStreams,
+                                                           Uint32                               MaxRelativeOffset,
+                                                           class GLContextState&                GLContextState);
+
+    // The objects are identified by their unique IDs rather than pointers, because the cache may
+    // be updated after the object has been destroyed (see RenderDeviceGLImpl::OnDestroyBuffer).
+    void OnDestroyBuffer(UniqueIdentifier BufferUId);
+    void OnDestroyPSO(UniqueIdentifier PSOUId);
 
 private:
     // This structure is used as the key to find VAO
@@ -125,12 +140,108 @@ private:
     };
 
 
+    // This structure is used as the key to find the VAO that only encapsulates the vertex format
+    struct LayoutVAOKey
+    {
+        struct ElementAttribs
+        {
+            Uint32 InputIndex;
+            Uint32 BufferSlot;
+            Uint32 NumComponents;
+            Uint32 ValueType;
+            Uint32 IsNormalized;
+            Uint32 RelativeOffset;
+            Uint32 Divisor;
+        };
+        std::vector<ElementAttribs> Elements;
+
+        mutable size_t Hash = 0;
+
+        bool operator==(const LayoutVAOKey& Key) const
+        {
+            return Elements.size() == Key.Elements.size() &&
+                (Elements.empty() || std::memcmp(Elements.data(), Key.Elements.data(), sizeof(ElementAttribs) * Elements.size()) == 0);
+        }
+    };
+
+    struct LayoutVAOKeyHashFunc
+    {
+        std::size_t operator()(const LayoutVAOKey& Key) const
+        {
+            if (Key.Hash == 0)
+            {
+                std::size_t Seed = 0;
+                for (const auto& Elem : Key.Elements)
+                {
+                    HashCombine(Seed, Elem.InputIndex, Elem.BufferSlot, Elem.NumComponents, Elem.ValueType);
+                    HashCombine(Seed, Elem.IsNormalized, Elem.RelativeOffset, Elem.Divisor);
+                }
+                Key.Hash = Seed;
+            }
+            return Key.Hash;
+        }
+    };
+
+    // VAO with separate vertex format and the buffers currently bound to it
+    struct LayoutVAO
+    {
+        LayoutVAO() :
+            VAO{true}
+        {}
+
+        GLObjectWrappers::GLVertexArrayObj VAO;
+
+        Uint32 NumUsedSlots  = 0;
+        Uint32 UsedSlotsMask = 0;
+        // Unique IDs are never reused, so comparing them is safe even if the buffer has been released
+        struct BoundBufferAttribs
+        {
+            UniqueIdentifier BufferUId = 0;
+            Uint32           Stride    = 0;
+            Uint32           Offset    = 0;
+        } BoundBuffers[MAX_BUFFER_SLOTS];
+        UniqueIdentifier BoundIndexBufferUId = 0;
+
+        // Unique IDs of the PSOs that use this VAO. The VAO is destroyed when the last PSO is released.
+        std::vector<UniqueIdentifier> PSOUIds;
+
+        // Key of this VAO in the hash map. References to unordered_map elements remain valid after rehashing.
+        const LayoutVAOKey* pKey = nullptr;
+
+        bool IsBufferBound(UniqueIdentifier BufferUId) const
+        {
+            if (BoundIndexBufferUId == BufferUId)
+                return true;
+            for (Uint32 Slot = 0; Slot < NumUsedSlots; ++Slot)
+            {
+                if (BoundBuffers[Slot].BufferUId == BufferUId)
+                    return true;
+            }
+            return false;
+        }
+    };
+    using LayoutVAOHashMap = std::unordered_map<LayoutVAOKey, LayoutVAO, LayoutVAOKeyHashFunc>;
+
+    // Updates m_BuffToLayoutVAO after the buffer bound to a slot of the VAO has changed from OldBufferUId to NewBufferUId
+    void OnLayoutVAOBindingChanged(LayoutVAO& VAO, UniqueIdentifier OldBufferUId, UniqueIdentifier NewBufferUId);
+
+    // Removes the VAO from the cache along with all references to it
+    void EraseLayoutVAO(LayoutVAO& VAO);
+
     friend class RenderDeviceGLImpl;
     ThreadingTools::LockFlag                                                                 m_CacheLockFlag;
     std::unordered_map<VAOCacheKey, GLObjectWrappers::GLVertexArrayObj, VAOCacheKeyHashFunc> m_Cache;
 
-    std::unordered_multimap<const IPipelineState*, VAOCacheKey> m_PSOToKey;
-    std::unordered_multimap<const IBuffer*, VAOCacheKey>        m_BuffToKey;
+    // PSO and buffer unique ID -> keys of the VAOs that use the object
+    std::unordered_multimap<UniqueIdentifier, VAOCacheKey> m_PSOToKey;
+    std::unordered_multimap<UniqueIdentifier, VAOCacheKey> m_BuffToKey;
+
+    LayoutVAOHashMap m_LayoutVAOs;
+    // Buffer unique ID -> layout VAOs the buffer is currently bound to
+    std::unordered_multimap<UniqueIdentifier, LayoutVAO*> m_BuffToLayoutVAO;
+    // PSO unique ID -> layout VAO map to avoid rebuilding the key on every draw call.
+    // Null value indicates that the layout is not compatible with separate vertex format.
+    std::unordered_map<UniqueIdentifier, LayoutVAO*> m_PSOToLayoutVAO;
 
     // Any draw command fails if no VAO is bound. We will use this empty
     // VAO for draw commands with null input layout, such as these that
@@ -49,7 +49,25 @@ static const INTERFACE_ID IID_BufferGL =
 DILIGENT_BEGIN_INTERFACE(IBufferGL, IBuffer)
 {
     /// Returns OpenGL buffer handle
+
+    /// \remarks   Small uniform buffers may be suballocated from a GL buffer that is shared
+    ///            with other buffers. Use GetGLBufferOffset() to get the offset of the buffer
+    ///            data in the GL buffer.
     VIRTUAL GLuint METHOD(GetGLBufferHandle)(THIS) PURE;
+
+    /// Returns the offset, in bytes, of the buffer data in the GL buffer returned by GetGLBufferHandle().
+    /// The offset is zero unless the buffer is suballocated from a shared GL buffer.
+    VIRTUAL Uint32 METHOD(GetGLBufferOffset)(THIS) PURE;
+
+    /// Returns the pointer to the persistently mapped buffer data, or null if the buffer is not persistently mapped.
+
+    /// \remarks   Staging buffers with CPU_ACCESS_WRITE flag are persistently mapped when
+    ///            immutable buffer storage is supported (GL4.4+ or GL_ARB_buffer_storage).
+    ///            The memory is coherent, so CPU writes become visible to the GPU without explicit
+    ///            flushes. The application is responsible for making sure that the data is not
+    ///            overwritten while it is in use by the GPU (e.g. by using a fence).
+    ///            The pointer may be used from any thread.
+    VIRTUAL void* METHOD(GetPersistentMappedData)(THIS) PURE;
 };
 DILIGENT_END_INTERFACE
 
@@ -57,7 +75,13 @@ DILIGENT_END_INTERFACE
 
 #if DILIGENT_C_INTERFACE
 
-#    define IBufferGL_GetGLBufferHandle(This) CALL_IFACE_METHOD(BufferGL, GetGLBufferHandle, This)
+// clang-format off
+
+#    define IBufferGL_GetGLBufferHandle(This)       CALL_IFACE_METHOD(BufferGL, GetGLBufferHandle,       This)
+#    define IBufferGL_GetGLBufferOffset(This)       CALL_IFACE_METHOD(BufferGL, GetGLBufferOffset,       This)
+#    define IBufferGL_GetPersistentMappedData(This) CALL_IFACE_METHOD(BufferGL, GetPersistentMappedData, This)
+
+// clang-format on
 
 #endif
 
@@ -68,6 +68,28 @@ static GLenum GetBufferBindTarget(const BufferDesc& Desc)
 
     return Target;
 }
+
+static GLUniformBufferArena::Allocation SuballocateUniformBuffer(RenderDeviceGLImpl* pDeviceGL, GLContextState& GLState, const BufferDesc& Desc)
+{
+    auto* pArena = pDeviceGL->GetUniformBufferArena();
+    if (pArena == nullptr)
+        return GLUniformBufferArena::Allocation{};
+
+    // Dynamic buffers are not suballocated as map with discard flag relies on buffer orphaning.
+    // Mappable and writable buffers need their own GL objects as well.
+    // clang-format off
+    const bool IsEligible =
+        Desc.BindFlags      == BIND_UNIFORM_BUFFER                               &&
+        (Desc.Usage         == USAGE_DEFAULT || Desc.Usage == USAGE_STATIC)       &&
+        Desc.CPUAccessFlags == CPU_ACCESS_NONE                                   &&
+        Desc.uiSizeInBytes  >  0 && Desc.uiSizeInBytes <= pArena->GetMaxAllocationSize();
+    // clang-format on
+    if (!IsEligible)
+        return GLUniformBufferArena::Allocation{};
+
+    return pArena->Allocate(Desc.uiSizeInBytes, GLState, pDeviceGL->GetGLCaps().DirectStateAccess);
+}
+
 BufferGLImpl::BufferGLImpl(IReferenceCounters*        pRefCounters,
                            FixedBlockMemoryAllocator& BuffViewObjMemAllocator,
                            RenderDeviceGLImpl*        pDeviceGL,
@@ -84,9 +106,12 @@ BufferGLImpl::BufferGLImpl(IReferenceCounters*        pRefCounters,
         BuffDesc,
         bIsDeviceInternal
     },
-    m_GlBuffer    {true                          }, // Create buffer immediately
+    m_Suballocation{SuballocateUniformBuffer(pDeviceGL, GLState, BuffDesc)},
+    // Create buffer immediately, or attach to the arena page buffer
+    m_GlBuffer    {true, GLObjectWrappers::GLBufferObjCreateReleaseHelper{m_Suballocation.GLHandle, pDeviceGL->GetGLCaps().DirectStateAccess}},
     m_BindTarget  {GetBufferBindTarget(BuffDesc) },
-    m_GLUsageHint {UsageToGLUsage(BuffDesc)}
+    m_GLUsageHint {UsageToGLUsage(BuffDesc)},
+    m_UseDSA      {pDeviceGL->GetGLCaps().DirectStateAccess}
 // clang-format on
 {
     if (BuffDesc.Usage == USAGE_STATIC && (pBuffData == nullptr || pBuffData->pData == nullptr))
@@ -95,10 +120,16 @@ BufferGLImpl::BufferGLImpl(IReferenceCounters*        pRefCounters,
     // TODO: find out if it affects performance if the buffer is originally bound to one target
     // and then bound to another (such as first to GL_ARRAY_BUFFER and then to GL_UNIFORM_BUFFER)
 
-    // We must unbind VAO because otherwise we will break the bindings
-    constexpr bool ResetVAO = true;
-    GLState.BindBuffer(m_BindTarget, m_GlBuffer, ResetVAO);
     VERIFY(pBuffData == nullptr || pBuffData->pData == nullptr || pBuffData->DataSize >= BuffDesc.uiSizeInBytes, "Data pointer is null or data size is not consistent with buffer size");
+
+    if (m_Suballocation.IsValid())
+    {
+        // The page buffer storage has already been allocated
+        if (pBuffData != nullptr && pBuffData->pData != nullptr)
+            UpdateData(GLState, 0, BuffDesc.uiSizeInBytes, pBuffData->pData);
+        return;
+    }
+
     GLsizeiptr    DataSize = BuffDesc.uiSizeInBytes;
     const GLvoid* pData    = nullptr;
     if (pBuffData != nullptr && pBuffData->pData != nullptr && pBuffData->DataSize >= BuffDesc.uiSizeInBytes)
@@ -145,8 +176,59 @@ BufferGLImpl::BufferGLImpl(IReferenceCounters*        pRefCounters,
 
     // All buffer bind targets (GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER etc.) relate to the same
     // kind of objects. As a result they are all equivalent from a transfer point of view.
-    glBufferData(m_BindTarget, DataSize, pData, m_GLUsageHint);
-    CHECK_GL_ERROR_AND_THROW("glBufferData() failed");
+
+    // Upload buffers are allocated with immutable storage and are persistently mapped, so that
+    // the CPU can write to the buffer while the GPU reads data from it (e.g. for pixel unpack operations).
+    // Coherent mapping guarantees that the writes become visible to the GPU without explicit flushes.
+#if GL_ARB_buffer_storage
+    const bool UsePersistentMapping = BuffDesc.Usage == USAGE_STAGING && BuffDesc.CPUAccessFlags == CPU_ACCESS_WRITE && pDeviceGL->GetGLCaps().BufferStorage;
+#else
+    constexpr bool UsePersistentMapping = false;
+    (void)UsePersistentMapping;
+#endif
+
+#if GL_ARB_direct_state_access
+    if (m_UseDSA)
+    {
+        // Direct state access functions do not disturb the buffer bindings, so there is no need
+        // to unbind the VAO.
+#    if GL_ARB_buffer_storage
+        if (UsePersistentMapping)
+        {
+            glNamedBufferStorage(m_GlBuffer, DataSize, pData, PersistentMapAccess);
+            CHECK_GL_ERROR_AND_THROW("glNamedBufferStorage() failed");
+
+            m_pPersistentMappedData = glMapNamedBufferRange(m_GlBuffer, 0, DataSize, PersistentMapAccess);
+            CHECK_GL_ERROR_AND_THROW("Failed to persistently map the buffer");
+        }
+        else
+#    endif
+        {
+            glNamedBufferData(m_GlBuffer, DataSize, pData, m_GLUsageHint);
+            CHECK_GL_ERROR_AND_THROW("glNamedBufferData() failed");
+        }
+        return;
+    }
+#endif
+
+    // We must unbind VAO because otherwise we will break the bindings
+    constexpr bool ResetVAO = true;
+    GLState.BindBuffer(m_BindTarget, m_GlBuffer, ResetVAO);
+#if GL_ARB_buffer_storage
+    if (UsePersistentMapping)
+    {
+        glBufferStorage(m_BindTarget, DataSize, pData, PersistentMapAccess);
+        CHECK_GL_ERROR_AND_THROW("glBufferStorage() failed");
+
+        m_pPersistentMappedData = glMapBufferRange(m_BindTarget, 0, DataSize, PersistentMapAccess);
+        CHECK_GL_ERROR_AND_THROW("Failed to persistently map the buffer");
+    }
+    else
+#endif
+    {
+        glBufferData(m_BindTarget, DataSize, pData, m_GLUsageHint);
+        CHECK_GL_ERROR_AND_THROW("glBufferData() failed");
+    }
     GLState.BindBuffer(m_BindTarget, GLObjectWrappers::GLBufferObj::Null(), ResetVAO);
 }
 
@@ -198,14 +280,27 @@ BufferGLImpl::BufferGLImpl(IReferenceCounters*        pRefCounters,
     // Attach to external buffer handle
     m_GlBuffer    {true, GLObjectWrappers::GLBufferObjCreateReleaseHelper(GLHandle)},
     m_BindTarget  {GetBufferBindTarget(m_Desc)   },
-    m_GLUsageHint {UsageToGLUsage(BuffDesc)}
+    m_GLUsageHint {UsageToGLUsage(BuffDesc)},
+    m_UseDSA      {pDeviceGL->GetGLCaps().DirectStateAccess}
 // clang-format on
 {
 }
 
 BufferGLImpl::~BufferGLImpl()
 {
-    static_cast<RenderDeviceGLImpl*>(GetDevice())->OnDestroyBuffer(this);
+    auto* pDeviceGL = static_cast<RenderDeviceGLImpl*>(GetDevice());
+    pDeviceGL->OnDestroyBuffer(this);
+    if (m_Suballocation.IsValid())
+    {
+        // The page buffer is owned by the arena. The range will be reused
+        // when the GPU has finished all commands that may reference it.
+        m_GlBuffer.Release();
+        pDeviceGL->GetUniformBufferArena()->Free(std::move(m_Suballocation));
+    }
+    else
+    {
+        pDeviceGL->ReleaseGLObject(m_GlBuffer);
+    }
 }
 
 IMPLEMENT_QUERY_INTERFACE(BufferGLImpl, IID_BufferGL, TBufferBase)
@@ -219,6 +314,17 @@ void BufferGLImpl::UpdateData(GLContextState& CtxState, Uint32 Offset, Uint32 Si
                                       // the completion of any shader writes to the same memory initiated prior to the barrier.
         CtxState);
 
+    Offset += m_Suballocation.Offset;
+
+#if GL_ARB_direct_state_access
+    if (m_UseDSA)
+    {
+        glNamedBufferSubData(m_GlBuffer, Offset, Size, pData);
+        CHECK_GL_ERROR("glNamedBufferSubData() failed");
+        return;
+    }
+#endif
+
     // We must unbind VAO because otherwise we will break the bindings
     constexpr bool ResetVAO = true;
     CtxState.BindBuffer(GL_ARRAY_BUFFER, m_GlBuffer, ResetVAO);
@@ -242,6 +348,18 @@ void BufferGLImpl::CopyData(GLContextState& CtxState, BufferGLImpl& SrcBufferGL,
         GL_BUFFER_UPDATE_BARRIER_BIT,
         CtxState);
 
+    SrcOffset += SrcBufferGL.m_Suballocation.Offset;
+    DstOffset += m_Suballocation.Offset;
+
+#if GL_ARB_direct_state_access
+    if (m_UseDSA)
+    {
+        glCopyNamedBufferSubData(SrcBufferGL.m_GlBuffer, m_GlBuffer, SrcOffset, DstOffset, Size);
+        CHECK_GL_ERROR("glCopyNamedBufferSubData() failed");
+        return;
+    }
+#endif
+
     // Whilst glCopyBufferSubData() can be used to copy data between buffers bound to any two targets,
     // the targets GL_COPY_READ_BUFFER and GL_COPY_WRITE_BUFFER are provided specifically for this purpose.
     // Neither target is used for anything else by OpenGL, and so you can safely bind buffers to them for
@@ -263,6 +381,8 @@ void BufferGLImpl::Map(GLContextState& CtxState, MAP_TYPE MapType, Uint32 MapFla
 
 void BufferGLImpl::MapRange(GLContextState& CtxState, MAP_TYPE MapType, Uint32 MapFlags, Uint32 Offset, Uint32 Length, PVoid& pMappedData)
 {
+    VERIFY(!m_Suballocation.IsValid(), "Buffers suballocated from the uniform buffer arena can't be mapped");
+
     BufferMemoryBarrier(
         GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT, // Access by the client to persistent mapped regions of buffer
                                              // objects will reflect data written by shaders prior to the barrier.
@@ -271,7 +391,38 @@ void BufferGLImpl::MapRange(GLContextState& CtxState, MAP_TYPE MapType, Uint32 M
 
     // We must unbind VAO because otherwise we will break the bindings
     constexpr bool ResetVAO = true;
-    CtxState.BindBuffer(m_BindTarget, m_GlBuffer, ResetVAO);
+
+#if GL_ARB_buffer_storage
+    if (m_pPersistentMappedData != nullptr)
+    {
+        VERIFY(MapType == MAP_WRITE, "Persistently mapped buffers can only be mapped for writing");
+        if ((MapFlags & MAP_FLAG_DISCARD) != 0 && (MapFlags & MAP_FLAG_NO_OVERWRITE) == 0)
+        {
+            // Immutable storage can't be orphaned, so we remap the buffer with the invalidate bit.
+            // Since GL_MAP_UNSYNCHRONIZED_BIT is not set, the driver will synchronize with all pending
+            // GPU operations that read from the buffer.
+#    if GL_ARB_direct_state_access
+            if (m_UseDSA)
+            {
+                glUnmapNamedBuffer(m_GlBuffer);
+                m_pPersistentMappedData = glMapNamedBufferRange(m_GlBuffer, 0, m_Desc.uiSizeInBytes, PersistentMapAccess | GL_MAP_INVALIDATE_BUFFER_BIT);
+            }
+            else
+#    endif
+            {
+                CtxState.BindBuffer(m_BindTarget, m_GlBuffer, ResetVAO);
+                glUnmapBuffer(m_BindTarget);
+                m_pPersistentMappedData = glMapBufferRange(m_BindTarget, 0, m_Desc.uiSizeInBytes, PersistentMapAccess | GL_MAP_INVALIDATE_BUFFER_BIT);
+            }
+            CHECK_GL_ERROR("Failed to persistently map the buffer");
+            VERIFY(m_pPersistentMappedData, "Map failed");
+        }
+        // With MAP_FLAG_NO_OVERWRITE, it is the responsibility of the application to make sure that
+        // the GPU has finished reading the data (e.g. by using a fence).
+        pMappedData = reinterpret_cast<Uint8*>(m_pPersistentMappedData) + Offset;
+        return;
+    }
+#endif
 
     // !!!WARNING!!! GL_MAP_UNSYNCHRONIZED_BIT is not the same thing as MAP_FLAG_DO_NOT_WAIT.
     // If GL_MAP_UNSYNCHRONIZED_BIT flag is set, OpenGL will not attempt to synchronize operations
@@ -317,16 +468,43 @@ void BufferGLImpl::MapRange(GLContextState& CtxState, MAP_TYPE MapType, Uint32 M
         default: UNEXPECTED("Unknown map type");
     }
 
-    pMappedData = glMapBufferRange(m_BindTarget, Offset, Length, Access);
+#if GL_ARB_direct_state_access
+    if (m_UseDSA)
+    {
+        pMappedData = glMapNamedBufferRange(m_GlBuffer, Offset, Length, Access);
+    }
+    else
+#endif
+    {
+        CtxState.BindBuffer(m_BindTarget, m_GlBuffer, ResetVAO);
+        pMappedData = glMapBufferRange(m_BindTarget, Offset, Length, Access);
+    }
     CHECK_GL_ERROR("glMapBufferRange() failed");
     VERIFY(pMappedData, "Map failed");
 }
 
 void BufferGLImpl::Unmap(GLContextState& CtxState)
 {
-    constexpr bool ResetVAO = true;
-    CtxState.BindBuffer(m_BindTarget, m_GlBuffer, ResetVAO);
-    auto Result = glUnmapBuffer(m_BindTarget);
+    if (m_pPersistentMappedData != nullptr)
+    {
+        // Persistently mapped buffers stay mapped for their entire lifetime.
+        // Coherent mapping makes all CPU writes visible to the GPU.
+        return;
+    }
+
+    GLboolean Result = GL_FALSE;
+#if GL_ARB_direct_state_access
+    if (m_UseDSA)
+    {
+        Result = glUnmapNamedBuffer(m_GlBuffer);
+    }
+    else
+#endif
+    {
+        constexpr bool ResetVAO = true;
+        CtxState.BindBuffer(m_BindTarget, m_GlBuffer, ResetVAO);
+        Result = glUnmapBuffer(m_BindTarget);
+    }
     // glUnmapBuffer() returns TRUE unless data values in the buffer's data store have
     // become corrupted during the period that the buffer was mapped. Such corruption
     // can be the result of a screen resolution change or other window system - dependent
@@ -373,19 +551,19 @@ void BufferGLImpl::CreateViewInternal(const BufferViewDesc& OrigViewDesc, IBuffe
 
     *ppView = nullptr;
 
+    auto* pDeviceGLImpl = ValidatedCast<RenderDeviceGLImpl>(GetDevice());
+    if (pDeviceGLImpl->DispatchToWorkerContext([&]() { CreateViewInternal(OrigViewDesc, ppView, bIsDefaultView); }))
+        return;
+
     try
     {
         auto ViewDesc = OrigViewDesc;
         CorrectBufferViewDesc(ViewDesc);
 
-        auto* pDeviceGLImpl     = ValidatedCast<RenderDeviceGLImpl>(GetDevice());
         auto& BuffViewAllocator = pDeviceGLImpl->GetBuffViewObjAllocator();
         VERIFY(&BuffViewAllocator == &m_dbgBuffViewAllocator, "Buff view allocator does not match allocator provided at buffer initialization");
 
-        auto pContext = pDeviceGLImpl->GetImmediateContext();
-        VERIFY(pContext, "Immediate context has been released");
-
-        *ppView = NEW_RC_OBJ(BuffViewAllocator, "BufferViewGLImpl instance", BufferViewGLImpl, bIsDefaultView ? this : nullptr)(pDeviceGLImpl, pContext, ViewDesc, this, bIsDefaultView);
+        *ppView = NEW_RC_OBJ(BuffViewAllocator, "BufferViewGLImpl instance", BufferViewGLImpl, bIsDefaultView ? this : nullptr)(pDeviceGLImpl, pDeviceGLImpl->GetCreationContextState(), ViewDesc, this, bIsDefaultView);
 
         if (!bIsDefaultView)
             (*ppView)->AddRef();
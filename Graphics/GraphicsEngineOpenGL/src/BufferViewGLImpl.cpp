@@ -37,7 +37,7 @@ namespace Diligent
 {
 BufferViewGLImpl::BufferViewGLImpl(IReferenceCounters*   pRefCounters,
                                    RenderDeviceGLImpl*   pDevice,
-                                   IDeviceContext*       pContext,
+                                   GLContextState&       GLState,
                                    const BufferViewDesc& ViewDesc,
                                    BufferGLImpl*         pBuffer,
                                    bool                  bIsDefaultView) :
@@ -66,11 +66,8 @@ BufferViewGLImpl::BufferViewGLImpl(IReferenceCounters*   pRefCounters,
 #    pragma warning(pop)
 #endif
 
-        auto* pContextGL   = ValidatedCast<DeviceContextGLImpl>(pContext);
-        auto& ContextState = pContextGL->GetContextState();
-
         m_GLTexBuffer.Create();
-        ContextState.BindTexture(-1, GL_TEXTURE_BUFFER, m_GLTexBuffer);
+        GLState.BindTexture(-1, GL_TEXTURE_BUFFER, m_GLTexBuffer);
 
         const auto& BuffFmt  = ViewDesc.Format;
         GLenum      GLFormat = 0;
@@ -97,10 +94,15 @@ BufferViewGLImpl::BufferViewGLImpl(IReferenceCounters*   pRefCounters,
         }
         CHECK_GL_ERROR_AND_THROW("Failed to create texture buffer");
 
-        ContextState.BindTexture(-1, GL_TEXTURE_BUFFER, GLObjectWrappers::GLTextureObj(false));
+        GLState.BindTexture(-1, GL_TEXTURE_BUFFER, GLObjectWrappers::GLTextureObj(false));
     }
 }
 
+BufferViewGLImpl::~BufferViewGLImpl()
+{
+    GetDevice()->ReleaseGLObject(m_GLTexBuffer);
+}
+
 IMPLEMENT_QUERY_INTERFACE(BufferViewGLImpl, IID_BufferViewGL, TBuffViewBase)
 
 } // namespace Diligent
@@ -77,6 +77,7 @@ IMPLEMENT_QUERY_INTERFACE(DeviceContextGLImpl, IID_DeviceContextGL, TDeviceConte
 
 void DeviceContextGLImpl::SetPipelineState(IPipelineState* pPipelineState)
 {
+    m_pDevice->WaitWorkerContextFences();
     auto* pPipelineStateGLImpl = ValidatedCast<PipelineStateGLImpl>(pPipelineState);
     if (PipelineStateGLImpl::IsSameObject(m_pPipelineState, pPipelineStateGLImpl))
         return;
@@ -151,6 +152,7 @@ void DeviceContextGLImpl::TransitionShaderResources(IPipelineState* pPipelineSta
 
 void DeviceContextGLImpl::CommitShaderResources(IShaderResourceBinding* pShaderResourceBinding, RESOURCE_STATE_TRANSITION_MODE StateTransitionMode)
 {
+    m_pDevice->WaitWorkerContextFences();
     if (!DeviceContextBase::CommitShaderResources(pShaderResourceBinding, StateTransitionMode, 0))
         return;
 
@@ -356,9 +358,10 @@ void DeviceContextGLImpl::CommitRenderTargets()
                       "Depth buffer of the default framebuffer can only be bound with the default framebuffer's color buffer "
                       "and cannot be combined with any other render target in OpenGL backend.");
 
-        auto        CurrentNativeGLContext = m_ContextState.GetCurrentGLContext();
-        auto&       FBOCache               = m_pDevice->GetFBOCache(CurrentNativeGLContext);
-        const auto& FBO                    = FBOCache.GetFBO(NumRenderTargets, pBoundRTVs, m_pBoundDepthStencil, m_ContextState);
+        auto CurrentNativeGLContext = m_ContextState.GetCurrentGLContext();
+        m_pDevice->PurgeReleasedObjects(CurrentNativeGLContext);
+        auto&       FBOCache = m_pDevice->GetFBOCache(CurrentNativeGLContext);
+        const auto& FBO      = FBOCache.GetFBO(NumRenderTargets, pBoundRTVs, m_pBoundDepthStencil, m_ContextState);
         // Even though the write mask only applies to writes to a framebuffer, the mask state is NOT
         // Framebuffer state. So it is NOT part of a Framebuffer Object or the Default Framebuffer.
         // Binding a new framebuffer will NOT affect the mask.
@@ -373,6 +376,7 @@ void DeviceContextGLImpl::SetRenderTargets(Uint32                         NumRen
                                            ITextureView*                  pDepthStencil,
                                            RESOURCE_STATE_TRANSITION_MODE StateTransitionMode)
 {
+    m_pDevice->WaitWorkerContextFences();
     if (TDeviceContextBase::SetRenderTargets(NumRenderTargets, ppRenderTargets, pDepthStencil))
     {
         if (m_NumBoundRenderTargets == 1 && m_pBoundRenderTargets[0] && m_pBoundRenderTargets[0]->GetTexture<TextureBaseGL>()->GetGLHandle() == 0)
@@ -436,8 +440,15 @@ void DeviceContextGLImpl::BindProgramResources(Uint32& NewMemoryBarriers, IShade
                                     // will reflect data written by shaders prior to the barrier
             m_ContextState);
 
-        m_ContextState.BindUniformBuffer(ub, pBufferGL->m_GlBuffer);
-        //glBindBufferRange(GL_UNIFORM_BUFFER, it->Index, pBufferGL->m_GlBuffer, 0, pBufferGL->GetDesc().uiSizeInBytes);
+        if (pBufferGL->IsSuballocated())
+        {
+            // The buffer occupies a range of the arena page buffer
+            m_ContextState.BindUniformBuffer(ub, pBufferGL->m_GlBuffer, pBufferGL->GetGLBufferOffset(), pBufferGL->GetDesc().uiSizeInBytes);
+        }
+        else
+        {
+            m_ContextState.BindUniformBuffer(ub, pBufferGL->m_GlBuffer);
+        }
     }
 
     for (Uint32 s = 0; s < ResourceCache.GetSamplerCount(); ++s)
@@ -656,6 +667,7 @@ void DeviceContextGLImpl::BindProgramResources(Uint32& NewMemoryBarriers, IShade
 
 void DeviceContextGLImpl::PrepareForDraw(DRAW_FLAGS Flags, bool IsIndexed, GLenum& GlTopology)
 {
+    m_pDevice->WaitWorkerContextFences();
 #ifdef DILIGENT_DEVELOPMENT
     if ((Flags & DRAW_FLAG_VERIFY_RENDER_TARGETS) != 0)
         DvpVerifyRenderTargets();
@@ -665,14 +677,30 @@ void DeviceContextGLImpl::PrepareForDraw(DRAW_FLAGS Flags, bool IsIndexed, GLenu
 
     auto        CurrNativeGLContext = m_pDevice->m_GLContext.GetCurrentNativeGLContext();
     const auto& PipelineDesc        = m_pPipelineState->GetDesc().GraphicsPipeline;
+    m_pDevice->PurgeReleasedObjects(CurrNativeGLContext);
     if (!m_ContextState.IsValidVAOBound())
     {
         auto&    VAOCache     = m_pDevice->GetVAOCache(CurrNativeGLContext);
         IBuffer* pIndexBuffer = IsIndexed ? m_pIndexBuffer.RawPtr() : nullptr;
         if (PipelineDesc.InputLayout.NumElements > 0 || pIndexBuffer != nullptr)
         {
-            const auto& VAO = VAOCache.GetVAO(m_pPipelineState, pIndexBuffer, m_VertexStreams, m_NumVertexStreams, m_ContextState);
-            m_ContextState.BindVAO(VAO);
+            const GLObjectWrappers::GLVertexArrayObj* pLayoutVAO = nullptr;
+            if (m_pDevice->GetGLCaps().VertexAttribBinding)
+            {
+                // Use one VAO per input layout and only rebind buffers that have changed
+                pLayoutVAO = VAOCache.GetLayoutVAO(m_pPipelineState, pIndexBuffer, m_VertexStreams, m_NumVertexStreams,
+                                                   m_pDevice->GetGLCaps().MaxVertexAttribRelativeOffset, m_ContextState);
+            }
+
+            if (pLayoutVAO != nullptr)
+            {
+                m_ContextState.BindVAO(*pLayoutVAO);
+            }
+            else
+            {
+                const auto& VAO = VAOCache.GetVAO(m_pPipelineState, pIndexBuffer, m_VertexStreams, m_NumVertexStreams, m_ContextState);
+                m_ContextState.BindVAO(VAO);
+            }
         }
         else
         {
@@ -791,6 +819,7 @@ void DeviceContextGLImpl::DrawIndexed(const DrawIndexedAttribs& Attribs)
 
 void DeviceContextGLImpl::PrepareForIndirectDraw(IBuffer* pAttribsBuffer)
 {
+    m_pDevice->WaitWorkerContextFences();
 #if GL_ARB_draw_indirect
     auto* pIndirectDrawAttribsGL = ValidatedCast<BufferGLImpl>(pAttribsBuffer);
     // The indirect rendering functions take their data from the buffer currently bound to the
@@ -877,6 +906,7 @@ void DeviceContextGLImpl::DrawIndexedIndirect(const DrawIndexedIndirectAttribs&
 
 void DeviceContextGLImpl::DispatchCompute(const DispatchComputeAttribs& Attribs)
 {
+    m_pDevice->WaitWorkerContextFences();
     if (!DvpVerifyDispatchArguments(Attribs))
         return;
 
@@ -893,6 +923,7 @@ void DeviceContextGLImpl::DispatchCompute(const DispatchComputeAttribs& Attribs)
 
 void DeviceContextGLImpl::DispatchComputeIndirect(const DispatchComputeIndirectAttribs& Attribs, IBuffer* pAttribsBuffer)
 {
+    m_pDevice->WaitWorkerContextFences();
     if (!DvpVerifyDispatchIndirectArguments(Attribs, pAttribsBuffer))
         return;
 
@@ -929,6 +960,7 @@ void DeviceContextGLImpl::ClearDepthStencil(ITextureView*                  pView
                                             Uint8                          Stencil,
                                             RESOURCE_STATE_TRANSITION_MODE StateTransitionMode)
 {
+    m_pDevice->WaitWorkerContextFences();
     if (!TDeviceContextBase::ClearDepthStencil(pView))
         return;
 
@@ -966,6 +998,7 @@ void DeviceContextGLImpl::ClearDepthStencil(ITextureView*                  pView
 
 void DeviceContextGLImpl::ClearRenderTarget(ITextureView* pView, const float* RGBA, RESOURCE_STATE_TRANSITION_MODE StateTransitionMode)
 {
+    m_pDevice->WaitWorkerContextFences();
     if (!TDeviceContextBase::ClearRenderTarget(pView))
         return;
 
@@ -1025,6 +1058,11 @@ void DeviceContextGLImpl::Flush()
 
 void DeviceContextGLImpl::FinishFrame()
 {
+    // Remove the objects released by other threads during the frame from the VAO and FBO caches
+    m_pDevice->PurgeReleasedObjects(m_ContextState.GetCurrentGLContext());
+
+    // Return uniform buffer arena ranges released during the frame to the free lists
+    m_pDevice->ReleaseStaleResources();
 }
 
 void DeviceContextGLImpl::FinishCommandList(class ICommandList** ppCommandList)
@@ -1160,6 +1198,7 @@ void DeviceContextGLImpl::UpdateBuffer(IBuffer*                       pBuffer,
                                        const void*                    pData,
                                        RESOURCE_STATE_TRANSITION_MODE StateTransitionMode)
 {
+    m_pDevice->WaitWorkerContextFences();
     TDeviceContextBase::UpdateBuffer(pBuffer, Offset, Size, pData, StateTransitionMode);
 
     auto* pBufferGL = ValidatedCast<BufferGLImpl>(pBuffer);
@@ -1174,6 +1213,7 @@ void DeviceContextGLImpl::CopyBuffer(IBuffer*                       pSrcBuffer,
                                      Uint32                         Size,
                                      RESOURCE_STATE_TRANSITION_MODE DstBufferTransitionMode)
 {
+    m_pDevice->WaitWorkerContextFences();
     TDeviceContextBase::CopyBuffer(pSrcBuffer, SrcOffset, SrcBufferTransitionMode, pDstBuffer, DstOffset, Size, DstBufferTransitionMode);
 
     auto* pSrcBufferGL = ValidatedCast<BufferGLImpl>(pSrcBuffer);
@@ -1183,6 +1223,7 @@ void DeviceContextGLImpl::CopyBuffer(IBuffer*                       pSrcBuffer,
 
 void DeviceContextGLImpl::MapBuffer(IBuffer* pBuffer, MAP_TYPE MapType, MAP_FLAGS MapFlags, PVoid& pMappedData)
 {
+    m_pDevice->WaitWorkerContextFences();
     TDeviceContextBase::MapBuffer(pBuffer, MapType, MapFlags, pMappedData);
     auto* pBufferGL = ValidatedCast<BufferGLImpl>(pBuffer);
     pBufferGL->Map(m_ContextState, MapType, MapFlags, pMappedData);
@@ -1203,6 +1244,7 @@ void DeviceContextGLImpl::UpdateTexture(ITexture*                      pTexture,
                                         RESOURCE_STATE_TRANSITION_MODE SrcBufferStateTransitionMode,
                                         RESOURCE_STATE_TRANSITION_MODE TextureStateTransitionMode)
 {
+    m_pDevice->WaitWorkerContextFences();
     TDeviceContextBase::UpdateTexture(pTexture, MipLevel, Slice, DstBox, SubresData, SrcBufferStateTransitionMode, TextureStateTransitionMode);
     auto* pTexGL = ValidatedCast<TextureBaseGL>(pTexture);
     pTexGL->UpdateData(m_ContextState, MipLevel, Slice, DstBox, SubresData);
@@ -1210,6 +1252,7 @@ void DeviceContextGLImpl::UpdateTexture(ITexture*                      pTexture,
 
 void DeviceContextGLImpl::CopyTexture(const CopyTextureAttribs& CopyAttribs)
 {
+    m_pDevice->WaitWorkerContextFences();
     TDeviceContextBase::CopyTexture(CopyAttribs);
     auto* pSrcTexGL = ValidatedCast<TextureBaseGL>(CopyAttribs.pSrcTexture);
     auto* pDstTexGL = ValidatedCast<TextureBaseGL>(CopyAttribs.pDstTexture);
@@ -1278,8 +1321,9 @@ void DeviceContextGLImpl::CopyTexture(const CopyTextureAttribs& CopyAttribs)
                     false  // bIsDefaultView
                 };
 
-            auto  CurrentNativeGLContext = m_ContextState.GetCurrentGLContext();
-            auto& fboCache               = m_pDevice->GetFBOCache(CurrentNativeGLContext);
+            auto CurrentNativeGLContext = m_ContextState.GetCurrentGLContext();
+            m_pDevice->PurgeReleasedObjects(CurrentNativeGLContext);
+            auto& fboCache = m_pDevice->GetFBOCache(CurrentNativeGLContext);
 
             TextureViewGLImpl* pSrcViews[] = {&SrcTexView};
             const auto&        SrcFBO      = fboCache.GetFBO(1, pSrcViews, nullptr, m_ContextState);
@@ -1329,6 +1373,7 @@ void DeviceContextGLImpl::MapTextureSubresource(ITexture*                 pTextu
                                                 const Box*                pMapRegion,
                                                 MappedTextureSubresource& MappedData)
 {
+    m_pDevice->WaitWorkerContextFences();
     TDeviceContextBase::MapTextureSubresource(pTexture, MipLevel, ArraySlice, MapType, MapFlags, pMapRegion, MappedData);
     auto*       pTexGL  = ValidatedCast<TextureBaseGL>(pTexture);
     const auto& TexDesc = pTexGL->GetDesc();
@@ -1368,6 +1413,7 @@ void DeviceContextGLImpl::UnmapTextureSubresource(ITexture* pTexture, Uint32 Mip
 
 void DeviceContextGLImpl::GenerateMips(ITextureView* pTexView)
 {
+    m_pDevice->WaitWorkerContextFences();
     TDeviceContextBase::GenerateMips(pTexView);
     auto* pTexViewGL = ValidatedCast<TextureViewGLImpl>(pTexView);
     auto  BindTarget = pTexViewGL->GetBindTarget();
@@ -1391,8 +1437,9 @@ void DeviceContextGLImpl::ResolveTextureSubresource(ITexture*
     const auto& SrcTexDesc = pSrcTexGl->GetDesc();
     //const auto& DstTexDesc = pDstTexGl->GetDesc();
 
-    auto  CurrentNativeGLContext = m_ContextState.GetCurrentGLContext();
-    auto& FBOCache               = m_pDevice->GetFBOCache(CurrentNativeGLContext);
+    auto CurrentNativeGLContext = m_ContextState.GetCurrentGLContext();
+    m_pDevice->PurgeReleasedObjects(CurrentNativeGLContext);
+    auto& FBOCache = m_pDevice->GetFBOCache(CurrentNativeGLContext);
 
     {
         TextureViewDesc SrcTexViewDesc;
@@ -95,13 +95,12 @@ FBOCache::~FBOCache()
     VERIFY(m_TexIdToKey.empty(), "TexIdToKey cache is not empty.");
 }
 
-void FBOCache::OnReleaseTexture(ITexture* pTexture)
+void FBOCache::OnReleaseTexture(UniqueIdentifier TexId)
 {
     ThreadingTools::LockHelper CacheLock(m_CacheLockFlag);
 
-    auto* pTexGL = ValidatedCast<TextureBaseGL>(pTexture);
     // Find all FBOs that this texture used in
-    auto EqualRange = m_TexIdToKey.equal_range(pTexGL->GetUniqueID());
+    auto EqualRange = m_TexIdToKey.equal_range(TexId);
     for (auto It = EqualRange.first; It != EqualRange.second; ++It)
     {
         m_Cache.erase(It->second);
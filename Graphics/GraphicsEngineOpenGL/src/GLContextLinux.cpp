@@ -185,4 +185,80 @@ GLContext::NativeGLContextType GLContext::GetCurrentNativeGLContext()
     return glXGetCurrentContext();
 }
 
+GLContext::NativeGLContextType GLContext::CreateSharedContext()
+{
+    auto* display    = glXGetCurrentDisplay();
+    auto  CurrentCtx = glXGetCurrentContext();
+    if (display == nullptr || CurrentCtx == 0)
+    {
+        LOG_ERROR_MESSAGE("Shared GL context can only be created by a thread that has a current GL context");
+        return 0;
+    }
+
+    if (glXCreateContextAttribsARB == nullptr || glXQueryContext == nullptr)
+    {
+        LOG_WARNING_MESSAGE("GLX_ARB_create_context is not supported: unable to create shared GL context");
+        return 0;
+    }
+
+    // Shared context must be created with the same frame buffer configuration as the main context
+    int FBConfigId = 0;
+    glXQueryContext(display, CurrentCtx, GLX_FBCONFIG_ID, &FBConfigId);
+
+    int FBConfigAttribs[] =
+        {
+            GLX_FBCONFIG_ID, FBConfigId,
+            0 //
+        };
+    int          NumConfigs = 0;
+    GLXFBConfig* pFBConfigs = glXChooseFBConfig(display, DefaultScreen(display), FBConfigAttribs, &NumConfigs);
+    if (pFBConfigs == nullptr || NumConfigs == 0)
+    {
+        LOG_ERROR_MESSAGE("Failed to find frame buffer configuration of the main GL context");
+        return 0;
+    }
+
+    Int32 MajorVersion = 0, MinorVersion = 0, ProfileMask = 0, ContextFlags = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &MajorVersion);
+    glGetIntegerv(GL_MINOR_VERSION, &MinorVersion);
+    glGetIntegerv(GL_CONTEXT_PROFILE_MASK, &ProfileMask);
+    glGetIntegerv(GL_CONTEXT_FLAGS, &ContextFlags);
+
+    int ContextAttribs[] =
+        {
+            GLX_CONTEXT_MAJOR_VERSION_ARB, MajorVersion,
+            GLX_CONTEXT_MINOR_VERSION_ARB, MinorVersion,
+            GLX_CONTEXT_PROFILE_MASK_ARB, ProfileMask != 0 ? ProfileMask : GLX_CONTEXT_CORE_PROFILE_BIT_ARB,
+            GLX_CONTEXT_FLAGS_ARB, (ContextFlags & GL_CONTEXT_FLAG_DEBUG_BIT) != 0 ? GLX_CONTEXT_DEBUG_BIT_ARB : 0,
+            0 //
+        };
+
+    auto SharedCtx = glXCreateContextAttribsARB(display, pFBConfigs[0], CurrentCtx, 1 /*direct*/, ContextAttribs);
+    XFree(pFBConfigs);
+    if (SharedCtx == 0)
+    {
+        LOG_ERROR_MESSAGE("Failed to create shared GL context");
+        return 0;
+    }
+
+    m_pSharedContextDisplay = display;
+    return SharedCtx;
+}
+
+bool GLContext::MakeSharedContextCurrent(NativeGLContextType Context)
+{
+    auto* display = reinterpret_cast<Display*>(m_pSharedContextDisplay);
+    VERIFY(display != nullptr, "No shared contexts have been created");
+    // Shared contexts are only used to create resources, so no drawable is required (GL 3.0+)
+    return glXMakeContextCurrent(display, 0, 0, Context) != 0;
+}
+
+void GLContext::DestroySharedContext(NativeGLContextType Context)
+{
+    auto* display = reinterpret_cast<Display*>(m_pSharedContextDisplay);
+    VERIFY(display != nullptr, "No shared contexts have been created");
+    if (Context != 0)
+        glXDestroyContext(display, Context);
+}
+
 } // namespace Diligent
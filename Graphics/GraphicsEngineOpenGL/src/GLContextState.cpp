@@ -295,16 +295,21 @@ void GLContextState::BindImage(Uint32 Index, BufferViewGLImpl* pBuffView, GLenum
 #endif
 }
 
-void GLContextState::BindUniformBuffer(Int32 Index, const GLObjectWrappers::GLBufferObj& Buff)
+void GLContextState::BindUniformBuffer(Int32 Index, const GLObjectWrappers::GLBufferObj& Buff, GLintptr Offset, GLsizeiptr Size)
 {
     VERIFY(0 <= Index && Index < m_Caps.m_iMaxUniformBufferBindings, "Uniform buffer index is out of range");
 
+    // Buffers suballocated from the uniform buffer arena share the GL handle, but every
+    // wrapper has its own unique ID and a fixed range, so tracking the ID is sufficient.
     GLuint GLBufferHandle = Buff;
     if (UpdateBoundObjectsArr(m_BoundUniformBuffers, Index, Buff, GLBufferHandle))
     {
-        // In addition to binding buffer to the indexed buffer binding target, glBindBufferBase also binds
-        // buffer to the generic buffer binding point specified by target.
-        glBindBufferBase(GL_UNIFORM_BUFFER, Index, GLBufferHandle);
+        // In addition to binding buffer to the indexed buffer binding target, glBindBufferBase
+        // and glBindBufferRange also bind buffer to the generic buffer binding point specified by target.
+        if (Size == 0 || GLBufferHandle == 0)
+            glBindBufferBase(GL_UNIFORM_BUFFER, Index, GLBufferHandle);
+        else
+            glBindBufferRange(GL_UNIFORM_BUFFER, Index, GLBufferHandle, Offset, Size);
         DEV_CHECK_GL_ERROR("Failed to bind uniform buffer to slot ", Index);
     }
 }
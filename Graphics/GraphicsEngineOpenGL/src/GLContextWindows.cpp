@@ -333,4 +333,64 @@ GLContext::NativeGLContextType GLContext::GetCurrentNativeGLContext()
     return wglGetCurrentContext();
 }
 
+GLContext::NativeGLContextType GLContext::CreateSharedContext()
+{
+    auto CurrentDC  = wglGetCurrentDC();
+    auto CurrentCtx = wglGetCurrentContext();
+    if (CurrentDC == NULL || CurrentCtx == NULL)
+    {
+        LOG_ERROR_MESSAGE("Shared GL context can only be created by a thread that has a current GL context");
+        return NULL;
+    }
+
+    if (wglewIsSupported("WGL_ARB_create_context") != 1)
+    {
+        LOG_WARNING_MESSAGE("WGL_ARB_create_context is not supported: unable to create shared GL context");
+        return NULL;
+    }
+
+    Int32 MajorVersion = 0, MinorVersion = 0, ProfileMask = 0, ContextFlags = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &MajorVersion);
+    glGetIntegerv(GL_MINOR_VERSION, &MinorVersion);
+    glGetIntegerv(GL_CONTEXT_PROFILE_MASK, &ProfileMask);
+    glGetIntegerv(GL_CONTEXT_FLAGS, &ContextFlags);
+
+    int attribs[] =
+        {
+            WGL_CONTEXT_MAJOR_VERSION_ARB, MajorVersion,
+            WGL_CONTEXT_MINOR_VERSION_ARB, MinorVersion,
+            WGL_CONTEXT_FLAGS_ARB, WGL_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB,
+            GL_CONTEXT_PROFILE_MASK, ProfileMask != 0 ? ProfileMask : GL_CONTEXT_CORE_PROFILE_BIT,
+            0, 0 //
+        };
+    if ((ContextFlags & GL_CONTEXT_FLAG_DEBUG_BIT) != 0)
+    {
+        attribs[5] |= WGL_CONTEXT_DEBUG_BIT_ARB;
+    }
+
+    // The shared context is created for the same device context, so that
+    // it uses the same pixel format as the main context
+    auto SharedCtx = wglCreateContextAttribsARB(CurrentDC, CurrentCtx, attribs);
+    if (SharedCtx == NULL)
+    {
+        LOG_ERROR_MESSAGE("Failed to create shared GL context");
+        return NULL;
+    }
+
+    m_SharedContextDC = CurrentDC;
+    return SharedCtx;
+}
+
+bool GLContext::MakeSharedContextCurrent(NativeGLContextType Context)
+{
+    VERIFY(m_SharedContextDC != NULL, "No shared contexts have been created");
+    return wglMakeCurrent(Context != NULL ? m_SharedContextDC : NULL, Context) != FALSE;
+}
+
+void GLContext::DestroySharedContext(NativeGLContextType Context)
+{
+    if (Context != NULL)
+        wglDeleteContext(Context);
+}
+
 } // namespace Diligent
@@ -0,0 +1,149 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+
+#include "GLUniformBufferArena.hpp"
+#include "GLContextState.hpp"
+
+namespace Diligent
+{
+
+GLUniformBufferArena::GLUniformBufferArena(IMemoryAllocator& Allocator, Uint32 PageSize, Uint32 OffsetAlignment) :
+    // clang-format off
+    m_Allocator        {Allocator},
+    m_PageSize         {PageSize},
+    m_OffsetAlignment  {OffsetAlignment},
+    // Larger buffers would waste too much of the page and are better off in their own GL objects
+    m_MaxAllocationSize{std::min(PageSize / 4, Uint32{16384})}
+// clang-format on
+{
+    VERIFY(IsPowerOfTwo(m_OffsetAlignment), "Uniform buffer offset alignment (", m_OffsetAlignment, ") is not a power of two");
+}
+
+GLUniformBufferArena::Allocation GLUniformBufferArena::Allocate(Uint32 Size, GLContextState& GLState, bool UseDSA)
+{
+    VERIFY(Size > 0 && Size <= m_MaxAllocationSize, "Allocation size (", Size, ") is out of range");
+
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+
+    auto MakeAllocation = [&](Uint32 PageIdx, const VariableSizeAllocationsManager::Allocation& PageAlloc) //
+    {
+        Allocation Alloc;
+        Alloc.GLHandle        = m_Pages[PageIdx]->Buffer;
+        Alloc.PageIndex       = PageIdx;
+        Alloc.UnalignedOffset = static_cast<Uint32>(PageAlloc.UnalignedOffset);
+        Alloc.Offset          = Align(Alloc.UnalignedOffset, m_OffsetAlignment);
+        Alloc.Size            = static_cast<Uint32>(PageAlloc.Size);
+        return Alloc;
+    };
+
+    for (Uint32 PageIdx = 0; PageIdx < m_Pages.size(); ++PageIdx)
+    {
+        auto PageAlloc = m_Pages[PageIdx]->AllocationsMgr.Allocate(Size, m_OffsetAlignment);
+        if (PageAlloc.IsValid())
+            return MakeAllocation(PageIdx, PageAlloc);
+    }
+
+    GLObjectWrappers::GLBufferObj PageBuffer{true, GLObjectWrappers::GLBufferObjCreateReleaseHelper{0, UseDSA}};
+#if GL_ARB_direct_state_access
+    if (UseDSA)
+    {
+        glNamedBufferData(PageBuffer, m_PageSize, nullptr, GL_DYNAMIC_DRAW);
+    }
+    else
+#endif
+    {
+        // GL_UNIFORM_BUFFER target does not affect VAO state
+        constexpr bool ResetVAO = false;
+        GLState.BindBuffer(GL_UNIFORM_BUFFER, PageBuffer, ResetVAO);
+        glBufferData(GL_UNIFORM_BUFFER, m_PageSize, nullptr, GL_DYNAMIC_DRAW);
+        GLState.BindBuffer(GL_UNIFORM_BUFFER, GLObjectWrappers::GLBufferObj::Null(), ResetVAO);
+    }
+    CHECK_GL_ERROR_AND_THROW("Failed to initialize uniform buffer page storage");
+
+    m_Pages.emplace_back(new Page{std::move(PageBuffer), m_PageSize, m_Allocator});
+    const auto PageIdx = static_cast<Uint32>(m_Pages.size() - 1);
+
+    auto PageAlloc = m_Pages[PageIdx]->AllocationsMgr.Allocate(Size, m_OffsetAlignment);
+    VERIFY(PageAlloc.IsValid(), "Allocation from an empty page must not fail");
+    return MakeAllocation(PageIdx, PageAlloc);
+}
+
+void GLUniformBufferArena::Free(Allocation&& Alloc)
+{
+    VERIFY_EXPR(Alloc.IsValid());
+
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    m_StaleAllocations.emplace_back(Alloc);
+    Alloc = Allocation{};
+}
+
+void GLUniformBufferArena::FreeAllocations(const std::vector<Allocation>& Allocations)
+{
+    for (const auto& Alloc : Allocations)
+        m_Pages[Alloc.PageIndex]->AllocationsMgr.Free(Alloc.UnalignedOffset, Alloc.Size);
+}
+
+void GLUniformBufferArena::ReleaseStaleAllocations(bool ForceRelease)
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+
+    while (!m_PendingReleases.empty())
+    {
+        auto& PendingRelease = m_PendingReleases.front();
+        if (!ForceRelease)
+        {
+            auto res = glClientWaitSync(PendingRelease.first,
+                                        0, // Can be SYNC_FLUSH_COMMANDS_BIT
+                                        0  // Timeout in nanoseconds
+            );
+            if (res != GL_ALREADY_SIGNALED && res != GL_CONDITION_SATISFIED)
+                break;
+        }
+        FreeAllocations(PendingRelease.second);
+        m_PendingReleases.pop_front();
+    }
+
+    if (m_StaleAllocations.empty())
+        return;
+
+    if (ForceRelease)
+    {
+        FreeAllocations(m_StaleAllocations);
+    }
+    else
+    {
+        // The range may still be read by the commands that have been issued so far, so it
+        // can only be reused after these commands have completed.
+        GLObjectWrappers::GLSyncObj Fence{glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)};
+        m_PendingReleases.emplace_back(std::move(Fence), std::move(m_StaleAllocations));
+    }
+    m_StaleAllocations.clear();
+}
+
+} // namespace Diligent
@@ -0,0 +1,210 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+
+#include "GLWorkerContextPool.hpp"
+#include "GLContextState.hpp"
+#include "RenderDeviceGLImpl.hpp"
+
+namespace Diligent
+{
+
+// Context state of the worker thread. Every worker owns its own state object
+// as GL binding state is not shared between contexts.
+static thread_local GLContextState* t_pWorkerContextState = nullptr;
+
+GLWorkerContextPool::GLWorkerContextPool(RenderDeviceGLImpl* pDeviceGL, GLContext& MainContext, Uint32 NumThreads) :
+    m_pDeviceGL{pDeviceGL},
+    m_MainContext{MainContext}
+{
+    VERIFY_EXPR(NumThreads > 0);
+
+    // All shared contexts must be created by the thread that owns the main context
+    m_SharedContexts.reserve(NumThreads);
+    for (Uint32 i = 0; i < NumThreads; ++i)
+    {
+        auto SharedContext = m_MainContext.CreateSharedContext();
+        if (SharedContext == GLContext::NativeGLContextType{})
+            break;
+        m_SharedContexts.push_back(SharedContext);
+    }
+
+    if (m_SharedContexts.empty())
+        LOG_ERROR_AND_THROW("Failed to create shared GL contexts");
+
+    if (m_SharedContexts.size() < NumThreads)
+    {
+        LOG_WARNING_MESSAGE("Only ", m_SharedContexts.size(), " out of ", NumThreads, " shared GL contexts have been created");
+    }
+
+    std::vector<std::promise<bool>> InitResults(m_SharedContexts.size());
+    m_Threads.reserve(m_SharedContexts.size());
+    for (size_t i = 0; i < m_SharedContexts.size(); ++i)
+    {
+        m_Threads.emplace_back(&GLWorkerContextPool::WorkerThreadFunc, this, m_SharedContexts[i], std::ref(InitResults[i]));
+    }
+
+    bool AllInitialized = true;
+    for (auto& Result : InitResults)
+        AllInitialized = Result.get_future().get() && AllInitialized;
+
+    if (!AllInitialized)
+    {
+        Shutdown();
+        LOG_ERROR_AND_THROW("Failed to initialize GL resource creation worker threads");
+    }
+}
+
+GLWorkerContextPool::~GLWorkerContextPool()
+{
+    Shutdown();
+}
+
+void GLWorkerContextPool::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> Lock{m_JobsMtx};
+        m_Stop = true;
+    }
+    m_JobsCondVar.notify_all();
+
+    for (auto& Thread : m_Threads)
+        Thread.join();
+    m_Threads.clear();
+
+    // Release the fences while the main context is current
+    m_PendingFences.clear();
+    m_NumPendingFences.store(0);
+
+    for (auto SharedContext : m_SharedContexts)
+        m_MainContext.DestroySharedContext(SharedContext);
+    m_SharedContexts.clear();
+}
+
+void GLWorkerContextPool::WorkerThreadFunc(GLContext::NativeGLContextType SharedContext, std::promise<bool>& InitResult)
+{
+    if (!m_MainContext.MakeSharedContextCurrent(SharedContext))
+    {
+        LOG_ERROR_MESSAGE("Failed to make shared GL context current on the worker thread");
+        InitResult.set_value(false);
+        return;
+    }
+
+    {
+        GLContextState ContextState{m_pDeviceGL};
+        t_pWorkerContextState = &ContextState;
+        InitResult.set_value(true);
+
+        for (;;)
+        {
+            JobInfo Job;
+            {
+                std::unique_lock<std::mutex> Lock{m_JobsMtx};
+                m_JobsCondVar.wait(Lock, [this] { return m_Stop || !m_Jobs.empty(); });
+                if (m_Jobs.empty())
+                    break;
+                Job = std::move(m_Jobs.front());
+                m_Jobs.pop_front();
+            }
+
+            std::exception_ptr pException;
+            try
+            {
+                Job.Job();
+            }
+            catch (...)
+            {
+                pException = std::current_exception();
+            }
+
+            // The main context waits for this fence before it uses objects created by the job.
+            // The fence must be flushed as otherwise it may never be signaled.
+            GLObjectWrappers::GLSyncObj Fence{glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)};
+            glFlush();
+            {
+                std::lock_guard<std::mutex> Lock{m_FencesMtx};
+                m_PendingFences.emplace_back(std::move(Fence));
+                m_NumPendingFences.fetch_add(1);
+            }
+
+            // Completion must be signaled after the fence is enqueued, so that the caller
+            // never hands out an object whose fence is not visible to the main context.
+            if (pException)
+                Job.pCompletion->set_exception(pException);
+            else
+                Job.pCompletion->set_value();
+        }
+
+        t_pWorkerContextState = nullptr;
+    }
+
+    m_MainContext.MakeSharedContextCurrent(GLContext::NativeGLContextType{});
+}
+
+void GLWorkerContextPool::Execute(std::function<void()> Job)
+{
+    VERIFY(t_pWorkerContextState == nullptr, "Worker threads must not submit jobs to the pool as this will result in a deadlock");
+
+    std::promise<void> Completion;
+    auto               CompletionFuture = Completion.get_future();
+    {
+        std::lock_guard<std::mutex> Lock{m_JobsMtx};
+        m_Jobs.emplace_back(std::move(Job), &Completion);
+    }
+    m_JobsCondVar.notify_one();
+
+    CompletionFuture.get();
+}
+
+void GLWorkerContextPool::WaitPendingFences()
+{
+    if (m_NumPendingFences.load() == 0)
+        return;
+
+    std::vector<GLObjectWrappers::GLSyncObj> PendingFences;
+    {
+        std::lock_guard<std::mutex> Lock{m_FencesMtx};
+        PendingFences.swap(m_PendingFences);
+        m_NumPendingFences.store(0);
+    }
+
+    for (const auto& Fence : PendingFences)
+    {
+        // glWaitSync does not block the CPU: it makes the server wait until the
+        // fence is signaled before executing subsequent commands of this context.
+        glWaitSync(Fence, 0, GL_TIMEOUT_IGNORED);
+    }
+    CHECK_GL_ERROR("Failed to wait for worker context fences");
+}
+
+GLContextState* GLWorkerContextPool::GetThreadContextState()
+{
+    return t_pWorkerContextState;
+}
+
+} // namespace Diligent
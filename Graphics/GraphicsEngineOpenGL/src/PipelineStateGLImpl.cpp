@@ -69,9 +69,7 @@ PipelineStateGLImpl::PipelineStateGLImpl(IReferenceCounters*            pRefCoun
     auto& DeviceCaps = pDeviceGL->GetDeviceCaps();
     VERIFY(DeviceCaps.DevType != RENDER_DEVICE_TYPE_UNDEFINED, "Device caps are not initialized");
 
-    auto pImmediateCtx = m_pDevice->GetImmediateContext();
-    VERIFY_EXPR(pImmediateCtx);
-    auto& GLState = pImmediateCtx.RawPtr<DeviceContextGLImpl>()->GetContextState();
+    auto& GLState = pDeviceGL->GetCreationContextState();
 
     {
         m_TotalUniformBufferBindings = 0;
@@ -142,6 +140,8 @@ PipelineStateGLImpl::~PipelineStateGLImpl()
 {
     m_StaticResourceCache.Destroy(GetRawAllocator());
     GetDevice()->OnDestroyPSO(this);
+    for (auto& GLProgram : m_GLPrograms)
+        GetDevice()->ReleaseGLObject(GLProgram);
 }
 
 IMPLEMENT_QUERY_INTERFACE(PipelineStateGLImpl, IID_PipelineStateGL, TPipelineStateBase)
@@ -49,6 +49,10 @@
 #include "EngineMemory.h"
 #include "StringTools.hpp"
 
+#if !DILIGENT_NO_HLSL
+#    include "HLSL2GLSLConverterImpl.hpp"
+#endif
+
 namespace Diligent
 {
 
@@ -79,7 +83,8 @@ RenderDeviceGLImpl::RenderDeviceGLImpl(IReferenceCounters*       pRefCounters,
         }
     },
     // Device caps must be filled in before the constructor of Pipeline Cache is called!
-    m_GLContext{InitAttribs, m_DeviceCaps, pSCDesc}
+    m_GLContext{InitAttribs, m_DeviceCaps, pSCDesc},
+    m_FilterHLSL2GLSLDefinitions{InitAttribs.FilterHLSL2GLSLDefinitions}
 // clang-format on
 {
     GLint NumExtensions = 0;
@@ -95,6 +100,8 @@ RenderDeviceGLImpl::RenderDeviceGLImpl(IReferenceCounters*       pRefCounters,
 
     FlagSupportedTexFormats();
     QueryDeviceCaps();
+    if (InitAttribs.DisableDirectStateAccess)
+        m_GLCaps.DirectStateAccess = false;
 
     std::basic_string<GLubyte> glstrVendor = glGetString(GL_VENDOR);
     std::string                Vendor      = StrToLower(std::string(glstrVendor.begin(), glstrVendor.end()));
@@ -140,6 +147,8 @@ RenderDeviceGLImpl::RenderDeviceGLImpl(IReferenceCounters*       pRefCounters,
     if (m_DeviceCaps.DevType == RENDER_DEVICE_TYPE_GL)
     {
         const bool IsGL46OrAbove = (MajorVersion >= 5) || (MajorVersion == 4 && MinorVersion >= 6);
+        const bool IsGL45OrAbove = (MajorVersion >= 5) || (MajorVersion == 4 && MinorVersion >= 5);
+        const bool IsGL44OrAbove = (MajorVersion >= 5) || (MajorVersion == 4 && MinorVersion >= 4);
         const bool IsGL43OrAbove = (MajorVersion >= 5) || (MajorVersion == 4 && MinorVersion >= 3);
         const bool IsGL42OrAbove = (MajorVersion >= 5) || (MajorVersion == 4 && MinorVersion >= 2);
         const bool IsGL41OrAbove = (MajorVersion >= 5) || (MajorVersion == 4 && MinorVersion >= 1);
@@ -179,6 +188,21 @@ RenderDeviceGLImpl::RenderDeviceGLImpl(IReferenceCounters*       pRefCounters,
         SamCaps.BorderSamplingModeSupported   = True;
         SamCaps.AnisotropicFilteringSupported = IsGL46OrAbove || CheckExtension("GL_ARB_texture_filter_anisotropic");
         SamCaps.LODBiasSupported              = True;
+
+        m_GLCaps.BufferStorage       = IsGL44OrAbove || CheckExtension("GL_ARB_buffer_storage");
+        m_GLCaps.VertexAttribBinding = IsGL43OrAbove || CheckExtension("GL_ARB_vertex_attrib_binding");
+#if GL_ARB_vertex_attrib_binding
+        if (m_GLCaps.VertexAttribBinding)
+        {
+            GLint MaxRelativeOffset = 0;
+            glGetIntegerv(GL_MAX_VERTEX_ATTRIB_RELATIVE_OFFSET, &MaxRelativeOffset);
+            CHECK_GL_ERROR("Failed to get max vertex attrib relative offset");
+            m_GLCaps.MaxVertexAttribRelativeOffset = static_cast<Uint32>(std::max(MaxRelativeOffset, 0));
+        }
+#endif
+#if GL_ARB_direct_state_access
+        m_GLCaps.DirectStateAccess = IsGL45OrAbove || CheckExtension("GL_ARB_direct_state_access");
+#endif
     }
     else
     {
@@ -225,6 +249,9 @@ RenderDeviceGLImpl::RenderDeviceGLImpl(IReferenceCounters*       pRefCounters,
         SamCaps.BorderSamplingModeSupported   = GL_TEXTURE_BORDER_COLOR && (IsGLES32OrAbove || strstr(Extensions, "texture_border_clamp"));
         SamCaps.AnisotropicFilteringSupported = GL_TEXTURE_MAX_ANISOTROPY_EXT && strstr(Extensions, "texture_filter_anisotropic");
         SamCaps.LODBiasSupported              = GL_TEXTURE_LOD_BIAS && IsGLES31OrAbove;
+
+        // Buffer storage, separate vertex attribute binding and direct state access functions are not loaded by GLES stubs,
+        // so the corresponding GLCaps members are left false.
     }
 
     const bool bRGTC = CheckExtension("GL_ARB_texture_compression_rgtc");
@@ -232,10 +259,70 @@ RenderDeviceGLImpl::RenderDeviceGLImpl(IReferenceCounters*       pRefCounters,
     const bool bS3TC = CheckExtension("GL_EXT_texture_compression_s3tc");
 
     Features.TextureCompressionBC = bRGTC && bBPTC && bS3TC;
+
+    if (InitAttribs.NumResourceCreationThreads > 0)
+    {
+        try
+        {
+            m_pWorkerContexts.reset(new GLWorkerContextPool{this, m_GLContext, InitAttribs.NumResourceCreationThreads});
+            Features.MultithreadedResourceCreation = True;
+            LOG_INFO_MESSAGE("Started ", m_pWorkerContexts->GetNumThreads(), " GL resource creation worker thread(s)");
+        }
+        catch (const std::runtime_error&)
+        {
+            LOG_WARNING_MESSAGE("Failed to start GL resource creation worker threads. Resources will only be created by the thread that owns the GL context.");
+        }
+    }
+
+    if (InitAttribs.UniformBufferArenaPageSize > 0)
+    {
+        GLint UBOffsetAlignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &UBOffsetAlignment);
+        if (glGetError() == GL_NO_ERROR && UBOffsetAlignment > 0 && IsPowerOfTwo(static_cast<Uint32>(UBOffsetAlignment)))
+        {
+            m_pUniformBufferArena.reset(new GLUniformBufferArena{RawMemAllocator, InitAttribs.UniformBufferArenaPageSize, static_cast<Uint32>(UBOffsetAlignment)});
+        }
+        else
+        {
+            LOG_WARNING_MESSAGE("Failed to query uniform buffer offset alignment. Uniform buffer suballocation will be disabled.");
+        }
+    }
+
+    if (InitAttribs.HLSL2GLSLCacheDirectory != nullptr)
+    {
+#if DILIGENT_NO_HLSL
+        LOG_WARNING_MESSAGE("HLSL support is disabled. HLSL2GLSLCacheDirectory will be ignored.");
+#else
+        HLSL2GLSLConverterImpl::GetInstance().GetConversionCache().SetDirectory(InitAttribs.HLSL2GLSLCacheDirectory);
+#endif
+    }
 }
 
 RenderDeviceGLImpl::~RenderDeviceGLImpl()
 {
+    // Worker threads must be stopped while the main context is still alive
+    m_pWorkerContexts.reset();
+
+    // Remove the objects released by other threads before the caches are destroyed
+    while (!m_ReleasedObjects.empty())
+        PurgeReleasedObjectsImpl(m_ReleasedObjects.begin()->first);
+
+    if (m_pUniformBufferArena)
+    {
+        // All buffers have been released at this point
+        m_pUniformBufferArena->ReleaseStaleAllocations(true);
+        m_pUniformBufferArena.reset();
+    }
+}
+
+GLContextState& RenderDeviceGLImpl::GetCreationContextState()
+{
+    if (auto* pWorkerContextState = GLWorkerContextPool::GetThreadContextState())
+        return *pWorkerContextState;
+
+    auto spDeviceContext = GetImmediateContext();
+    VERIFY(spDeviceContext, "Immediate device context has been destroyed");
+    return spDeviceContext.RawPtr<DeviceContextGLImpl>()->GetContextState();
 }
 
 IMPLEMENT_QUERY_INTERFACE(RenderDeviceGLImpl, IID_RenderDeviceGL, TRenderDeviceBase)
@@ -247,15 +334,14 @@ void RenderDeviceGLImpl::InitTexRegionRender()
 
 void RenderDeviceGLImpl::CreateBuffer(const BufferDesc& BuffDesc, const BufferData* pBuffData, IBuffer** ppBuffer, bool bIsDeviceInternal)
 {
+    if (DispatchToWorkerContext([&]() { CreateBuffer(BuffDesc, pBuffData, ppBuffer, bIsDeviceInternal); }))
+        return;
+
     CreateDeviceObject(
         "buffer", BuffDesc, ppBuffer,
         [&]() //
         {
-            auto spDeviceContext = GetImmediateContext();
-            VERIFY(spDeviceContext, "Immediate device context has been destroyed");
-            auto* pDeviceContextGL = spDeviceContext.RawPtr<DeviceContextGLImpl>();
-
-            BufferGLImpl* pBufferOGL(NEW_RC_OBJ(m_BufObjAllocator, "BufferGLImpl instance", BufferGLImpl)(m_BuffViewObjAllocator, this, pDeviceContextGL->GetContextState(), BuffDesc, pBuffData, bIsDeviceInternal));
+            BufferGLImpl* pBufferOGL(NEW_RC_OBJ(m_BufObjAllocator, "BufferGLImpl instance", BufferGLImpl)(m_BuffViewObjAllocator, this, GetCreationContextState(), BuffDesc, pBuffData, bIsDeviceInternal));
             pBufferOGL->QueryInterface(IID_Buffer, reinterpret_cast<IObject**>(ppBuffer));
             pBufferOGL->CreateDefaultViews();
             OnCreateDeviceObject(pBufferOGL);
@@ -270,16 +356,15 @@ void RenderDeviceGLImpl::CreateBuffer(const BufferDesc& BuffDesc, const BufferDa
 
 void RenderDeviceGLImpl::CreateBufferFromGLHandle(Uint32 GLHandle, const BufferDesc& BuffDesc, RESOURCE_STATE InitialState, IBuffer** ppBuffer)
 {
+    if (DispatchToWorkerContext([&]() { CreateBufferFromGLHandle(GLHandle, BuffDesc, InitialState, ppBuffer); }))
+        return;
+
     VERIFY(GLHandle, "GL buffer handle must not be null");
     CreateDeviceObject(
         "buffer", BuffDesc, ppBuffer,
         [&]() //
         {
-            auto spDeviceContext = GetImmediateContext();
-            VERIFY(spDeviceContext, "Immediate device context has been destroyed");
-            auto* pDeviceContextGL = spDeviceContext.RawPtr<DeviceContextGLImpl>();
-
-            BufferGLImpl* pBufferOGL(NEW_RC_OBJ(m_BufObjAllocator, "BufferGLImpl instance", BufferGLImpl)(m_BuffViewObjAllocator, this, pDeviceContextGL->GetContextState(), BuffDesc, GLHandle, false));
+            BufferGLImpl* pBufferOGL(NEW_RC_OBJ(m_BufObjAllocator, "BufferGLImpl instance", BufferGLImpl)(m_BuffViewObjAllocator, this, GetCreationContextState(), BuffDesc, GLHandle, false));
             pBufferOGL->QueryInterface(IID_Buffer, reinterpret_cast<IObject**>(ppBuffer));
             pBufferOGL->CreateDefaultViews();
             OnCreateDeviceObject(pBufferOGL);
@@ -289,6 +374,9 @@ void RenderDeviceGLImpl::CreateBufferFromGLHandle(Uint32 GLHandle, const BufferD
 
 void RenderDeviceGLImpl::CreateShader(const ShaderCreateInfo& ShaderCreateInfo, IShader** ppShader, bool bIsDeviceInternal)
 {
+    if (DispatchToWorkerContext([&]() { CreateShader(ShaderCreateInfo, ppShader, bIsDeviceInternal); }))
+        return;
+
     CreateDeviceObject(
         "shader", ShaderCreateInfo.Desc, ppShader,
         [&]() //
@@ -308,13 +396,14 @@ void RenderDeviceGLImpl::CreateShader(const ShaderCreateInfo& ShaderCreateInfo,
 
 void RenderDeviceGLImpl::CreateTexture(const TextureDesc& TexDesc, const TextureData* pData, ITexture** ppTexture, bool bIsDeviceInternal)
 {
+    if (DispatchToWorkerContext([&]() { CreateTexture(TexDesc, pData, ppTexture, bIsDeviceInternal); }))
+        return;
+
     CreateDeviceObject(
         "texture", TexDesc, ppTexture,
         [&]() //
         {
-            auto spDeviceContext = GetImmediateContext();
-            VERIFY(spDeviceContext, "Immediate device context has been destroyed");
-            auto& GLState = spDeviceContext.RawPtr<DeviceContextGLImpl>()->GetContextState();
+            auto& GLState = GetCreationContextState();
 
             const auto& FmtInfo = GetTextureFormatInfo(TexDesc.Format);
             if (!FmtInfo.Supported)
@@ -374,14 +463,15 @@ void RenderDeviceGLImpl::CreateTextureFromGLHandle(Uint32             GLHandle,
                                                    RESOURCE_STATE     InitialState,
                                                    ITexture**         ppTexture)
 {
+    if (DispatchToWorkerContext([&]() { CreateTextureFromGLHandle(GLHandle, GLBindTarget, TexDesc, InitialState, ppTexture); }))
+        return;
+
     VERIFY(GLHandle, "GL texture handle must not be null");
     CreateDeviceObject(
         "texture", TexDesc, ppTexture,
         [&]() //
         {
-            auto spDeviceContext = GetImmediateContext();
-            VERIFY(spDeviceContext, "Immediate device context has been destroyed");
-            auto& GLState = spDeviceContext.RawPtr<DeviceContextGLImpl>()->GetContextState();
+            auto& GLState = GetCreationContextState();
 
             TextureBaseGL* pTextureOGL = nullptr;
             switch (TexDesc.Type)
@@ -449,6 +539,9 @@ void RenderDeviceGLImpl::CreateDummyTexture(const TextureDesc& TexDesc, RESOURCE
 
 void RenderDeviceGLImpl::CreateSampler(const SamplerDesc& SamplerDesc, ISampler** ppSampler, bool bIsDeviceInternal)
 {
+    if (DispatchToWorkerContext([&]() { CreateSampler(SamplerDesc, ppSampler, bIsDeviceInternal); }))
+        return;
+
     CreateDeviceObject(
         "sampler", SamplerDesc, ppSampler,
         [&]() //
@@ -478,6 +571,9 @@ void RenderDeviceGLImpl::CreatePipelineState(const PipelineStateCreateInfo& PSOC
 
 void RenderDeviceGLImpl::CreatePipelineState(const PipelineStateCreateInfo& PSOCreateInfo, IPipelineState** ppPipelineState, bool bIsDeviceInternal)
 {
+    if (DispatchToWorkerContext([&]() { CreatePipelineState(PSOCreateInfo, ppPipelineState, bIsDeviceInternal); }))
+        return;
+
     CreateDeviceObject(
         "Pipeline state", PSOCreateInfo.PSODesc, ppPipelineState,
         [&]() //
@@ -740,16 +836,16 @@ bool CreateTestGLTexture(GLContextState& GlCtxState, GLenum BindTarget, const GL
 
 void RenderDeviceGLImpl::TestTextureFormat(TEXTURE_FORMAT TexFormat)
 {
+    if (DispatchToWorkerContext([&]() { TestTextureFormat(TexFormat); }))
+        return;
+
     auto& TexFormatInfo = m_TextureFormatsInfo[TexFormat];
     VERIFY(TexFormatInfo.Supported, "Texture format is not supported");
 
     auto GLFmt = TexFormatToGLInternalTexFormat(TexFormat);
     VERIFY(GLFmt != 0, "Incorrect internal GL format");
 
-    auto spDeviceContext = GetImmediateContext();
-    VERIFY(spDeviceContext, "Immediate device context has been destroyed");
-    auto* pContextGL   = spDeviceContext.RawPtr<DeviceContextGLImpl>();
-    auto& ContextState = pContextGL->GetContextState();
+    auto& ContextState = GetCreationContextState();
 
     const int TestTextureDim   = 32;
     const int TestTextureDepth = 8;
@@ -936,9 +1032,17 @@ FBOCache& RenderDeviceGLImpl::GetFBOCache(GLContext::NativeGLContextType Context
 
 void RenderDeviceGLImpl::OnReleaseTexture(ITexture* pTexture)
 {
+    const auto TexId          = ValidatedCast<TextureBaseGL>(pTexture)->GetUniqueID();
+    const auto CurrentContext = m_GLContext.GetCurrentNativeGLContext();
+
     ThreadingTools::LockHelper FBOCacheLock(m_FBOCacheLockFlag);
     for (auto& FBOCacheIt : m_FBOCache)
-        FBOCacheIt.second.OnReleaseTexture(pTexture);
+    {
+        if (FBOCacheIt.first == CurrentContext)
+            FBOCacheIt.second.OnReleaseTexture(TexId);
+        else
+            AddReleasedObject(FBOCacheIt.first, &ReleasedObjects::Textures, TexId);
+    }
 }
 
 VAOCache& RenderDeviceGLImpl::GetVAOCache(GLContext::NativeGLContextType Context)
@@ -949,16 +1053,73 @@ VAOCache& RenderDeviceGLImpl::GetVAOCache(GLContext::NativeGLContextType Context
 
 void RenderDeviceGLImpl::OnDestroyPSO(IPipelineState* pPSO)
 {
+    const auto PSOUId         = ValidatedCast<PipelineStateGLImpl>(pPSO)->GetUniqueID();
+    const auto CurrentContext = m_GLContext.GetCurrentNativeGLContext();
+
     ThreadingTools::LockHelper VAOCacheLock(m_VAOCacheLockFlag);
     for (auto& VAOCacheIt : m_VAOCache)
-        VAOCacheIt.second.OnDestroyPSO(pPSO);
+    {
+        if (VAOCacheIt.first == CurrentContext)
+            VAOCacheIt.second.OnDestroyPSO(PSOUId);
+        else
+            AddReleasedObject(VAOCacheIt.first, &ReleasedObjects::PSOs, PSOUId);
+    }
 }
 
 void RenderDeviceGLImpl::OnDestroyBuffer(IBuffer* pBuffer)
 {
+    const auto BufferUId      = ValidatedCast<BufferGLImpl>(pBuffer)->GetUniqueID();
+    const auto CurrentContext = m_GLContext.GetCurrentNativeGLContext();
+
     ThreadingTools::LockHelper VAOCacheLock(m_VAOCacheLockFlag);
     for (auto& VAOCacheIt : m_VAOCache)
-        VAOCacheIt.second.OnDestroyBuffer(pBuffer);
+    {
+        if (VAOCacheIt.first == CurrentContext)
+            VAOCacheIt.second.OnDestroyBuffer(BufferUId);
+        else
+            AddReleasedObject(VAOCacheIt.first, &ReleasedObjects::Buffers, BufferUId);
+    }
+}
+
+void RenderDeviceGLImpl::AddReleasedObject(GLContext::NativeGLContextType Context, std::vector<UniqueIdentifier> ReleasedObjects::*pObjects, UniqueIdentifier UId)
+{
+    ThreadingTools::LockHelper ReleasedObjectsLock(m_ReleasedObjectsLockFlag);
+    (m_ReleasedObjects[Context].*pObjects).push_back(UId);
+    m_NumReleasedObjects.fetch_add(1);
+}
+
+void RenderDeviceGLImpl::PurgeReleasedObjectsImpl(GLContext::NativeGLContextType Context)
+{
+    ReleasedObjects Objects;
+    {
+        ThreadingTools::LockHelper ReleasedObjectsLock(m_ReleasedObjectsLockFlag);
+
+        auto It = m_ReleasedObjects.find(Context);
+        if (It == m_ReleasedObjects.end())
+            return;
+
+        Objects = std::move(It->second);
+        m_ReleasedObjects.erase(It);
+        m_NumReleasedObjects.fetch_sub(static_cast<Uint32>(Objects.Textures.size() + Objects.Buffers.size() + Objects.PSOs.size()));
+    }
+
+    // OnReleaseTexture() and other methods lock the released objects while holding the cache locks,
+    // so the caches are only updated after the released objects lock has been released.
+    if (!Objects.Textures.empty())
+    {
+        auto& FBOCache = GetFBOCache(Context);
+        for (auto TexId : Objects.Textures)
+            FBOCache.OnReleaseTexture(TexId);
+    }
+
+    if (!Objects.Buffers.empty() || !Objects.PSOs.empty())
+    {
+        auto& VAOCache = GetVAOCache(Context);
+        for (auto BufferUId : Objects.Buffers)
+            VAOCache.OnDestroyBuffer(BufferUId);
+        for (auto PSOUId : Objects.PSOs)
+            VAOCache.OnDestroyPSO(PSOUId);
+    }
 }
 
 void RenderDeviceGLImpl::IdleGPU()
@@ -966,4 +1127,10 @@ void RenderDeviceGLImpl::IdleGPU()
     glFinish();
 }
 
+void RenderDeviceGLImpl::ReleaseStaleResources(bool ForceRelease)
+{
+    if (m_pUniformBufferArena)
+        m_pUniformBufferArena->ReleaseStaleAllocations(ForceRelease);
+}
+
 } // namespace Diligent
@@ -129,6 +129,7 @@ SamplerGLImpl::SamplerGLImpl(IReferenceCounters* pRefCounters, class RenderDevic
 
 SamplerGLImpl::~SamplerGLImpl()
 {
+    GetDevice()->ReleaseGLObject(m_GlSampler);
 }
 
 IMPLEMENT_QUERY_INTERFACE(SamplerGLImpl, IID_SamplerGL, TSamplerBase)
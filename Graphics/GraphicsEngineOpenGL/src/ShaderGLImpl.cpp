@@ -32,6 +32,7 @@
 #include "DeviceContextGLImpl.hpp"
 #include "DataBlobImpl.hpp"
 #include "GLSLSourceBuilder.hpp"
+#include "ShaderArchive.hpp"
 
 using namespace Diligent;
 
@@ -55,7 +56,31 @@ ShaderGLImpl::ShaderGLImpl(IReferenceCounters*     pRefCounters,
 {
     const auto& deviceCaps = pDeviceGL->GetDeviceCaps();
 
-    auto GLSLSource = BuildGLSLSourceString(CreationAttribs, deviceCaps, TargetGLSLCompiler::driver);
+    String GLSLSource;
+    if (CreationAttribs.pShaderArchive != nullptr)
+    {
+        DEV_CHECK_ERR(CreationAttribs.Source == nullptr, "'Source' must be null when shader is loaded from an archive");
+        DEV_CHECK_ERR(CreationAttribs.ByteCode == nullptr, "'ByteCode' must be null when shader is loaded from an archive");
+
+        // The archive contains full GLSL source that was built by the ShaderArchiver tool
+        ShaderArchiveReader Archive{CreationAttribs.pShaderArchive->GetDataPtr(), CreationAttribs.pShaderArchive->GetSize()};
+        if (!IsShaderArchiveGLSLTargetCompatible(Archive.GetGLSLTarget(), deviceCaps))
+        {
+            LOG_ERROR_AND_THROW("GLSL source in the shader archive was built for ", GetShaderArchiveGLSLTargetString(Archive.GetGLSLTarget()),
+                                " and can't be used on this device: ", GetShaderArchiveGLSLTargetString(GetShaderArchiveGLSLTarget(deviceCaps)));
+        }
+
+        ShaderArchiveReader::ShaderData ShaderData;
+        if (!Archive.FindShader(CreationAttribs, ShaderData) || ShaderData.GLSL == nullptr)
+        {
+            LOG_ERROR_AND_THROW("Shader archive does not contain GLSL source for shader '", (m_Desc.Name != nullptr ? m_Desc.Name : ""), "'");
+        }
+        GLSLSource.assign(ShaderData.GLSL, ShaderData.GLSLLength);
+    }
+    else
+    {
+        GLSLSource = BuildGLSLSourceString(CreationAttribs, deviceCaps, TargetGLSLCompiler::driver, nullptr, pDeviceGL->GetFilterHLSL2GLSLDefinitions());
+    }
 
     // Note: there is a simpler way to create the program:
     //m_uiShaderSeparateProg = glCreateShaderProgramv(GL_VERTEX_SHADER, _countof(ShaderStrings), ShaderStrings);
@@ -135,15 +160,14 @@ ShaderGLImpl::ShaderGLImpl(IReferenceCounters*     pRefCounters,
         Uint32                         SamplerBinding       = 0;
         Uint32                         ImageBinding         = 0;
         Uint32                         StorageBufferBinding = 0;
-        auto                           pImmediateCtx        = m_pDevice->GetImmediateContext();
-        VERIFY_EXPR(pImmediateCtx);
-        auto& GLState = pImmediateCtx.RawPtr<DeviceContextGLImpl>()->GetContextState();
+        auto&                          GLState              = m_pDevice->GetCreationContextState();
         m_Resources.LoadUniforms(m_Desc.ShaderType, Program, GLState, UniformBufferBinding, SamplerBinding, ImageBinding, StorageBufferBinding);
     }
 }
 
 ShaderGLImpl::~ShaderGLImpl()
 {
+    m_pDevice->ReleaseGLObject(m_GLShaderObj);
 }
 
 IMPLEMENT_QUERY_INTERFACE(ShaderGLImpl, IID_ShaderGL, TShaderBase)
@@ -62,10 +62,16 @@ Texture1DArray_OGL::Texture1DArray_OGL(IReferenceCounters*        pRefCounters,
         return;
     }
 
-    GLState.BindTexture(-1, m_BindTarget, m_GlTexture);
+    if (!m_UseDSA)
+        GLState.BindTexture(-1, m_BindTarget, m_GlTexture);
 
-    //                             levels             format          width             height
-    glTexStorage2D(m_BindTarget, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.ArraySize);
+#if GL_ARB_direct_state_access
+    if (m_UseDSA)
+        glTextureStorage2D(m_GlTexture, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.ArraySize);
+    else
+#endif
+        //                             levels             format          width             height
+        glTexStorage2D(m_BindTarget, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.ArraySize);
     CHECK_GL_ERROR_AND_THROW("Failed to allocate storage for the 1D texture array");
     // When target is GL_TEXTURE_1D_ARRAY, calling glTexStorage2D() is equivalent to the following code:
     //for (i = 0; i < levels; i++)
@@ -100,7 +106,8 @@ Texture1DArray_OGL::Texture1DArray_OGL(IReferenceCounters*        pRefCounters,
         }
     }
 
-    GLState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
+    if (!m_UseDSA)
+        GLState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
 }
 
 Texture1DArray_OGL::Texture1DArray_OGL(IReferenceCounters*        pRefCounters,
@@ -139,7 +146,8 @@ void Texture1DArray_OGL::UpdateData(GLContextState&          ContextState,
 {
     TextureBaseGL::UpdateData(ContextState, MipLevel, Slice, DstBox, SubresData);
 
-    ContextState.BindTexture(-1, m_BindTarget, m_GlTexture);
+    if (!m_UseDSA)
+        ContextState.BindTexture(-1, m_BindTarget, m_GlTexture);
 
     // Bind buffer if it is provided; copy from CPU memory otherwise
     GLuint UnpackBuffer = 0;
@@ -161,23 +169,39 @@ void Texture1DArray_OGL::UpdateData(GLContextState&          ContextState,
     glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
     glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
 
-    glTexSubImage2D(m_BindTarget, MipLevel,
-                    DstBox.MinX,
-                    Slice,
-                    DstBox.MaxX - DstBox.MinX,
-                    1,
-                    TransferAttribs.PixelFormat, TransferAttribs.DataType,
-                    // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
-                    // as a byte offset into the buffer object's data store.
-                    // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexSubImage2D.xhtml
-                    SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+#if GL_ARB_direct_state_access
+    if (m_UseDSA)
+    {
+        glTextureSubImage2D(m_GlTexture, MipLevel,
+                            DstBox.MinX,
+                            Slice,
+                            DstBox.MaxX - DstBox.MinX,
+                            1,
+                            TransferAttribs.PixelFormat, TransferAttribs.DataType,
+                            SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+    }
+    else
+#endif
+    {
+        glTexSubImage2D(m_BindTarget, MipLevel,
+                        DstBox.MinX,
+                        Slice,
+                        DstBox.MaxX - DstBox.MinX,
+                        1,
+                        TransferAttribs.PixelFormat, TransferAttribs.DataType,
+                        // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
+                        // as a byte offset into the buffer object's data store.
+                        // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexSubImage2D.xhtml
+                        SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+    }
 
     CHECK_GL_ERROR("Failed to update subimage data");
 
     if (UnpackBuffer != 0)
         glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
-    ContextState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
+    if (!m_UseDSA)
+        ContextState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
 }
 
 void Texture1DArray_OGL::AttachToFramebuffer(const TextureViewDesc& ViewDesc, GLenum AttachmentPoint)
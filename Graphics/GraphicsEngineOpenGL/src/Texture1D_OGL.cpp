@@ -62,10 +62,16 @@ Texture1D_OGL::Texture1D_OGL(IReferenceCounters*        pRefCounters,
         return;
     }
 
-    GLState.BindTexture(-1, m_BindTarget, m_GlTexture);
-
-    //                             levels             format          width
-    glTexStorage1D(m_BindTarget, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width);
+    if (!m_UseDSA)
+        GLState.BindTexture(-1, m_BindTarget, m_GlTexture);
+
+#if GL_ARB_direct_state_access
+    if (m_UseDSA)
+        glTextureStorage1D(m_GlTexture, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width);
+    else
+#endif
+        //                             levels             format          width
+        glTexStorage1D(m_BindTarget, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width);
     CHECK_GL_ERROR_AND_THROW("Failed to allocate storage for the 1D texture");
     // When target is GL_TEXTURE_1D, calling glTexStorage1D is equivalent to the following pseudo-code:
     //for (i = 0; i < levels; i++)
@@ -97,7 +103,8 @@ Texture1D_OGL::Texture1D_OGL(IReferenceCounters*        pRefCounters,
         }
     }
 
-    GLState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
+    if (!m_UseDSA)
+        GLState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
 }
 
 Texture1D_OGL::Texture1D_OGL(IReferenceCounters*        pRefCounters,
@@ -136,7 +143,8 @@ void Texture1D_OGL::UpdateData(GLContextState&          ContextState,
 {
     TextureBaseGL::UpdateData(ContextState, MipLevel, Slice, DstBox, SubresData);
 
-    ContextState.BindTexture(-1, m_BindTarget, m_GlTexture);
+    if (!m_UseDSA)
+        ContextState.BindTexture(-1, m_BindTarget, m_GlTexture);
 
     // Bind buffer if it is provided; copy from CPU memory otherwise
     GLuint UnpackBuffer = 0;
@@ -158,20 +166,34 @@ void Texture1D_OGL::UpdateData(GLContextState&          ContextState,
     glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
     glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
 
-    glTexSubImage1D(m_BindTarget, MipLevel,
-                    DstBox.MinX,
-                    DstBox.MaxX - DstBox.MinX,
-                    TransferAttribs.PixelFormat, TransferAttribs.DataType,
-                    // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
-                    // as a byte offset into the buffer object's data store.
-                    // https://www.khronos.org/registry/OpenGL-Refpages/gl2.1/xhtml/glTexSubImage1D.xml
-                    SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+#if GL_ARB_direct_state_access
+    if (m_UseDSA)
+    {
+        glTextureSubImage1D(m_GlTexture, MipLevel,
+                            DstBox.MinX,
+                            DstBox.MaxX - DstBox.MinX,
+                            TransferAttribs.PixelFormat, TransferAttribs.DataType,
+                            SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+    }
+    else
+#endif
+    {
+        glTexSubImage1D(m_BindTarget, MipLevel,
+                        DstBox.MinX,
+                        DstBox.MaxX - DstBox.MinX,
+                        TransferAttribs.PixelFormat, TransferAttribs.DataType,
+                        // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
+                        // as a byte offset into the buffer object's data store.
+                        // https://www.khronos.org/registry/OpenGL-Refpages/gl2.1/xhtml/glTexSubImage1D.xml
+                        SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+    }
     CHECK_GL_ERROR("Failed to update subimage data");
 
     if (UnpackBuffer != 0)
         glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
-    ContextState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
+    if (!m_UseDSA)
+        ContextState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
 }
 
 void Texture1D_OGL::AttachToFramebuffer(const TextureViewDesc& ViewDesc, GLenum AttachmentPoint)
@@ -63,12 +63,18 @@ Texture2DArray_OGL::Texture2DArray_OGL(IReferenceCounters*        pRefCounters,
         return;
     }
 
-    GLState.BindTexture(-1, m_BindTarget, m_GlTexture);
+    if (!m_UseDSA)
+        GLState.BindTexture(-1, m_BindTarget, m_GlTexture);
 
     if (m_Desc.SampleCount > 1)
     {
-        //                                                              format          width         height          depth
-        glTexStorage3DMultisample(m_BindTarget, m_Desc.SampleCount, m_GLTexFormat, m_Desc.Width, m_Desc.Height, m_Desc.ArraySize, GL_TRUE);
+#if GL_ARB_direct_state_access
+        if (m_UseDSA)
+            glTextureStorage3DMultisample(m_GlTexture, m_Desc.SampleCount, m_GLTexFormat, m_Desc.Width, m_Desc.Height, m_Desc.ArraySize, GL_TRUE);
+        else
+#endif
+            //                                                              format          width         height          depth
+            glTexStorage3DMultisample(m_BindTarget, m_Desc.SampleCount, m_GLTexFormat, m_Desc.Width, m_Desc.Height, m_Desc.ArraySize, GL_TRUE);
         // The last parameter specifies whether the image will use identical sample locations and the same number of
         // samples for all texels in the image, and the sample locations will not depend on the internal format or size
         // of the image.
@@ -83,8 +89,13 @@ Texture2DArray_OGL::Texture2DArray_OGL(IReferenceCounters*        pRefCounters,
     }
     else
     {
-        //                             levels             format          width         height          depth
-        glTexStorage3D(m_BindTarget, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.Height, m_Desc.ArraySize);
+#if GL_ARB_direct_state_access
+        if (m_UseDSA)
+            glTextureStorage3D(m_GlTexture, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.Height, m_Desc.ArraySize);
+        else
+#endif
+            //                             levels             format          width         height          depth
+            glTexStorage3D(m_BindTarget, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.Height, m_Desc.ArraySize);
         CHECK_GL_ERROR_AND_THROW("Failed to allocate storage for the 2D texture array");
         // When target is GL_TEXTURE_2D_ARRAY, calling glTexStorage3D is equivalent to the following pseudo-code:
         //for (i = 0; i < levels; i++)
@@ -121,7 +132,8 @@ Texture2DArray_OGL::Texture2DArray_OGL(IReferenceCounters*        pRefCounters,
         }
     }
 
-    GLState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
+    if (!m_UseDSA)
+        GLState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
 }
 
 Texture2DArray_OGL::Texture2DArray_OGL(IReferenceCounters*        pRefCounters,
@@ -162,7 +174,8 @@ void Texture2DArray_OGL::UpdateData(GLContextState&          ContextState,
 {
     TextureBaseGL::UpdateData(ContextState, MipLevel, Slice, DstBox, SubresData);
 
-    ContextState.BindTexture(-1, m_BindTarget, m_GlTexture);
+    if (!m_UseDSA)
+        ContextState.BindTexture(-1, m_BindTarget, m_GlTexture);
 
     // Bind buffer if it is provided; copy from CPU memory otherwise
     GLuint UnpackBuffer = 0;
@@ -203,26 +216,44 @@ void Texture2DArray_OGL::UpdateData(GLContextState&          ContextState,
         auto UpdateRegionHeight = DstBox.MaxY - DstBox.MinY;
         UpdateRegionWidth       = std::min(UpdateRegionWidth, MipWidth - DstBox.MinX);
         UpdateRegionHeight      = std::min(UpdateRegionHeight, MipHeight - DstBox.MinY);
-        glCompressedTexSubImage3D(m_BindTarget, MipLevel,
-                                  DstBox.MinX,
-                                  DstBox.MinY,
-                                  Slice,
-                                  UpdateRegionWidth,
-                                  UpdateRegionHeight,
-                                  1,
-                                  // The format must be the same compressed-texture format previously
-                                  // specified by glTexStorage2D() (thank you OpenGL for another useless
-                                  // parameter that is nothing but the source of confusion), otherwise
-                                  // INVALID_OPERATION error is generated.
-                                  m_GLTexFormat,
-                                  // An INVALID_VALUE error is generated if imageSize is not consistent with
-                                  // the format, dimensions, and contents of the compressed image( too little or
-                                  // too much data ),
-                                  ((DstBox.MaxY - DstBox.MinY + 3) / 4) * SubresData.Stride,
-                                  // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
-                                  // as a byte offset into the buffer object's data store.
-                                  // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glCompressedTexSubImage3D.xhtml
-                                  SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+#if GL_ARB_direct_state_access
+        if (m_UseDSA)
+        {
+            glCompressedTextureSubImage3D(m_GlTexture, MipLevel,
+                                          DstBox.MinX,
+                                          DstBox.MinY,
+                                          Slice,
+                                          UpdateRegionWidth,
+                                          UpdateRegionHeight,
+                                          1,
+                                          m_GLTexFormat,
+                                          ((DstBox.MaxY - DstBox.MinY + 3) / 4) * SubresData.Stride,
+                                          SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
+        else
+#endif
+        {
+            glCompressedTexSubImage3D(m_BindTarget, MipLevel,
+                                      DstBox.MinX,
+                                      DstBox.MinY,
+                                      Slice,
+                                      UpdateRegionWidth,
+                                      UpdateRegionHeight,
+                                      1,
+                                      // The format must be the same compressed-texture format previously
+                                      // specified by glTexStorage2D() (thank you OpenGL for another useless
+                                      // parameter that is nothing but the source of confusion), otherwise
+                                      // INVALID_OPERATION error is generated.
+                                      m_GLTexFormat,
+                                      // An INVALID_VALUE error is generated if imageSize is not consistent with
+                                      // the format, dimensions, and contents of the compressed image( too little or
+                                      // too much data ),
+                                      ((DstBox.MaxY - DstBox.MinY + 3) / 4) * SubresData.Stride,
+                                      // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
+                                      // as a byte offset into the buffer object's data store.
+                                      // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glCompressedTexSubImage3D.xhtml
+                                      SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
     }
     else
     {
@@ -233,25 +264,43 @@ void Texture2DArray_OGL::UpdateData(GLContextState&          ContextState,
         glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
         glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
 
-        glTexSubImage3D(m_BindTarget, MipLevel,
-                        DstBox.MinX,
-                        DstBox.MinY,
-                        Slice,
-                        DstBox.MaxX - DstBox.MinX,
-                        DstBox.MaxY - DstBox.MinY,
-                        1,
-                        TransferAttribs.PixelFormat, TransferAttribs.DataType,
-                        // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
-                        // as a byte offset into the buffer object's data store.
-                        // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexSubImage3D.xhtml
-                        SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+#if GL_ARB_direct_state_access
+        if (m_UseDSA)
+        {
+            glTextureSubImage3D(m_GlTexture, MipLevel,
+                                DstBox.MinX,
+                                DstBox.MinY,
+                                Slice,
+                                DstBox.MaxX - DstBox.MinX,
+                                DstBox.MaxY - DstBox.MinY,
+                                1,
+                                TransferAttribs.PixelFormat, TransferAttribs.DataType,
+                                SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
+        else
+#endif
+        {
+            glTexSubImage3D(m_BindTarget, MipLevel,
+                            DstBox.MinX,
+                            DstBox.MinY,
+                            Slice,
+                            DstBox.MaxX - DstBox.MinX,
+                            DstBox.MaxY - DstBox.MinY,
+                            1,
+                            TransferAttribs.PixelFormat, TransferAttribs.DataType,
+                            // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
+                            // as a byte offset into the buffer object's data store.
+                            // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexSubImage3D.xhtml
+                            SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
     }
     CHECK_GL_ERROR("Failed to update subimage data");
 
     if (UnpackBuffer != 0)
         glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
-    ContextState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
+    if (!m_UseDSA)
+        ContextState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
 }
 
 void Texture2DArray_OGL::AttachToFramebuffer(const TextureViewDesc& ViewDesc, GLenum AttachmentPoint)
@@ -63,13 +63,19 @@ Texture2D_OGL::Texture2D_OGL(IReferenceCounters*        pRefCounters,
         return;
     }
 
-    GLState.BindTexture(-1, m_BindTarget, m_GlTexture);
+    if (!m_UseDSA)
+        GLState.BindTexture(-1, m_BindTarget, m_GlTexture);
 
     if (m_Desc.SampleCount > 1)
     {
 #if GL_ARB_texture_storage_multisample
-        //                                               format          width          height         depth
-        glTexStorage2DMultisample(m_BindTarget, m_Desc.SampleCount, m_GLTexFormat, m_Desc.Width, m_Desc.Height, GL_TRUE);
+#    if GL_ARB_direct_state_access
+        if (m_UseDSA)
+            glTextureStorage2DMultisample(m_GlTexture, m_Desc.SampleCount, m_GLTexFormat, m_Desc.Width, m_Desc.Height, GL_TRUE);
+        else
+#    endif
+            //                                               format          width          height         depth
+            glTexStorage2DMultisample(m_BindTarget, m_Desc.SampleCount, m_GLTexFormat, m_Desc.Width, m_Desc.Height, GL_TRUE);
         // The last parameter specifies whether the image will use identical sample locations and the same number of
         // samples for all texels in the image, and the sample locations will not depend on the internal format or size
         // of the image.
@@ -89,8 +95,13 @@ Texture2D_OGL::Texture2D_OGL(IReferenceCounters*        pRefCounters,
     }
     else
     {
-        //                             levels             format          width         height
-        glTexStorage2D(m_BindTarget, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.Height);
+#if GL_ARB_direct_state_access
+        if (m_UseDSA)
+            glTextureStorage2D(m_GlTexture, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.Height);
+        else
+#endif
+            //                             levels             format          width         height
+            glTexStorage2D(m_BindTarget, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.Height);
         CHECK_GL_ERROR_AND_THROW("Failed to allocate storage for the 2D texture");
         // When target is GL_TEXTURE_2D, calling glTexStorage2D is equivalent to the following pseudo-code:
         //for (i = 0; i < levels; i++)
@@ -124,7 +135,8 @@ Texture2D_OGL::Texture2D_OGL(IReferenceCounters*        pRefCounters,
         }
     }
 
-    GLState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
+    if (!m_UseDSA)
+        GLState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
 }
 
 Texture2D_OGL::Texture2D_OGL(IReferenceCounters*        pRefCounters,
@@ -184,7 +196,8 @@ void Texture2D_OGL::UpdateData(GLContextState&          ContextState,
 {
     TextureBaseGL::UpdateData(ContextState, MipLevel, Slice, DstBox, SubresData);
 
-    ContextState.BindTexture(-1, m_BindTarget, m_GlTexture);
+    if (!m_UseDSA)
+        ContextState.BindTexture(-1, m_BindTarget, m_GlTexture);
 
     // Bind buffer if it is provided; copy from CPU memory otherwise
     GLuint UnpackBuffer = 0;
@@ -226,24 +239,40 @@ void Texture2D_OGL::UpdateData(GLContextState&          ContextState,
         auto UpdateRegionHeight = DstBox.MaxY - DstBox.MinY;
         UpdateRegionWidth       = std::min(UpdateRegionWidth, MipWidth - DstBox.MinX);
         UpdateRegionHeight      = std::min(UpdateRegionHeight, MipHeight - DstBox.MinY);
-        glCompressedTexSubImage2D(m_BindTarget, MipLevel,
-                                  DstBox.MinX,
-                                  DstBox.MinY,
-                                  UpdateRegionWidth,
-                                  UpdateRegionHeight,
-                                  // The format must be the same compressed-texture format previously
-                                  // specified by glTexStorage2D() (thank you OpenGL for another useless
-                                  // parameter that is nothing but the source of confusion), otherwise
-                                  // INVALID_OPERATION error is generated.
-                                  m_GLTexFormat,
-                                  // An INVALID_VALUE error is generated if imageSize is not consistent with
-                                  // the format, dimensions, and contents of the compressed image( too little or
-                                  // too much data ),
-                                  ((DstBox.MaxY - DstBox.MinY + 3) / 4) * SubresData.Stride,
-                                  // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
-                                  // as a byte offset into the buffer object's data store.
-                                  // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glCompressedTexSubImage2D.xhtml
-                                  SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+#if GL_ARB_direct_state_access
+        if (m_UseDSA)
+        {
+            glCompressedTextureSubImage2D(m_GlTexture, MipLevel,
+                                          DstBox.MinX,
+                                          DstBox.MinY,
+                                          UpdateRegionWidth,
+                                          UpdateRegionHeight,
+                                          m_GLTexFormat,
+                                          ((DstBox.MaxY - DstBox.MinY + 3) / 4) * SubresData.Stride,
+                                          SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
+        else
+#endif
+        {
+            glCompressedTexSubImage2D(m_BindTarget, MipLevel,
+                                      DstBox.MinX,
+                                      DstBox.MinY,
+                                      UpdateRegionWidth,
+                                      UpdateRegionHeight,
+                                      // The format must be the same compressed-texture format previously
+                                      // specified by glTexStorage2D() (thank you OpenGL for another useless
+                                      // parameter that is nothing but the source of confusion), otherwise
+                                      // INVALID_OPERATION error is generated.
+                                      m_GLTexFormat,
+                                      // An INVALID_VALUE error is generated if imageSize is not consistent with
+                                      // the format, dimensions, and contents of the compressed image( too little or
+                                      // too much data ),
+                                      ((DstBox.MaxY - DstBox.MinY + 3) / 4) * SubresData.Stride,
+                                      // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
+                                      // as a byte offset into the buffer object's data store.
+                                      // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glCompressedTexSubImage2D.xhtml
+                                      SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
     }
     else
     {
@@ -254,23 +283,39 @@ void Texture2D_OGL::UpdateData(GLContextState&          ContextState,
         glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
         glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
 
-        glTexSubImage2D(m_BindTarget, MipLevel,
-                        DstBox.MinX,
-                        DstBox.MinY,
-                        DstBox.MaxX - DstBox.MinX,
-                        DstBox.MaxY - DstBox.MinY,
-                        TransferAttribs.PixelFormat, TransferAttribs.DataType,
-                        // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
-                        // as a byte offset into the buffer object's data store.
-                        // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexSubImage2D.xhtml
-                        SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+#if GL_ARB_direct_state_access
+        if (m_UseDSA)
+        {
+            glTextureSubImage2D(m_GlTexture, MipLevel,
+                                DstBox.MinX,
+                                DstBox.MinY,
+                                DstBox.MaxX - DstBox.MinX,
+                                DstBox.MaxY - DstBox.MinY,
+                                TransferAttribs.PixelFormat, TransferAttribs.DataType,
+                                SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
+        else
+#endif
+        {
+            glTexSubImage2D(m_BindTarget, MipLevel,
+                            DstBox.MinX,
+                            DstBox.MinY,
+                            DstBox.MaxX - DstBox.MinX,
+                            DstBox.MaxY - DstBox.MinY,
+                            TransferAttribs.PixelFormat, TransferAttribs.DataType,
+                            // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
+                            // as a byte offset into the buffer object's data store.
+                            // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexSubImage2D.xhtml
+                            SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
     }
     CHECK_GL_ERROR("Failed to update subimage data");
 
     if (UnpackBuffer != 0)
         glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
-    ContextState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
+    if (!m_UseDSA)
+        ContextState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
 }
 
 void Texture2D_OGL::AttachToFramebuffer(const TextureViewDesc& ViewDesc, GLenum AttachmentPoint)
@@ -63,10 +63,16 @@ Texture3D_OGL::Texture3D_OGL(IReferenceCounters*        pRefCounters,
         return;
     }
 
-    GLState.BindTexture(-1, m_BindTarget, m_GlTexture);
+    if (!m_UseDSA)
+        GLState.BindTexture(-1, m_BindTarget, m_GlTexture);
 
-    //                             levels             format          width        height          depth
-    glTexStorage3D(m_BindTarget, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.Height, m_Desc.Depth);
+#if GL_ARB_direct_state_access
+    if (m_UseDSA)
+        glTextureStorage3D(m_GlTexture, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.Height, m_Desc.Depth);
+    else
+#endif
+        //                             levels             format          width        height          depth
+        glTexStorage3D(m_BindTarget, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.Height, m_Desc.Depth);
     CHECK_GL_ERROR_AND_THROW("Failed to allocate storage for the 3D texture");
     // When target is GL_TEXTURE_3D, calling glTexStorage3D is equivalent to the following pseudo-code:
     //for (i = 0; i < levels; i++)
@@ -101,7 +107,8 @@ Texture3D_OGL::Texture3D_OGL(IReferenceCounters*        pRefCounters,
         }
     }
 
-    GLState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
+    if (!m_UseDSA)
+        GLState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
 }
 
 Texture3D_OGL::Texture3D_OGL(IReferenceCounters*        pRefCounters,
@@ -141,7 +148,8 @@ void Texture3D_OGL::UpdateData(GLContextState&          ContextState,
 {
     TextureBaseGL::UpdateData(ContextState, MipLevel, Slice, DstBox, SubresData);
 
-    ContextState.BindTexture(-1, m_BindTarget, m_GlTexture);
+    if (!m_UseDSA)
+        ContextState.BindTexture(-1, m_BindTarget, m_GlTexture);
 
     // Bind buffer if it is provided; copy from CPU memory otherwise
     GLuint UnpackBuffer = 0;
@@ -171,25 +179,43 @@ void Texture3D_OGL::UpdateData(GLContextState&          ContextState,
     VERIFY((SubresData.DepthStride % SubresData.Stride) == 0, "Depth stride is not multiple of stride");
     glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, SubresData.DepthStride / SubresData.Stride);
 
-    glTexSubImage3D(m_BindTarget, MipLevel,
-                    DstBox.MinX,
-                    DstBox.MinY,
-                    DstBox.MinZ,
-                    DstBox.MaxX - DstBox.MinX,
-                    DstBox.MaxY - DstBox.MinY,
-                    DstBox.MaxZ - DstBox.MinZ,
-                    TransferAttribs.PixelFormat, TransferAttribs.DataType,
-                    // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
-                    // as a byte offset into the buffer object's data store.
-                    // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexSubImage3D.xhtml
-                    SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+#if GL_ARB_direct_state_access
+    if (m_UseDSA)
+    {
+        glTextureSubImage3D(m_GlTexture, MipLevel,
+                            DstBox.MinX,
+                            DstBox.MinY,
+                            DstBox.MinZ,
+                            DstBox.MaxX - DstBox.MinX,
+                            DstBox.MaxY - DstBox.MinY,
+                            DstBox.MaxZ - DstBox.MinZ,
+                            TransferAttribs.PixelFormat, TransferAttribs.DataType,
+                            SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+    }
+    else
+#endif
+    {
+        glTexSubImage3D(m_BindTarget, MipLevel,
+                        DstBox.MinX,
+                        DstBox.MinY,
+                        DstBox.MinZ,
+                        DstBox.MaxX - DstBox.MinX,
+                        DstBox.MaxY - DstBox.MinY,
+                        DstBox.MaxZ - DstBox.MinZ,
+                        TransferAttribs.PixelFormat, TransferAttribs.DataType,
+                        // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
+                        // as a byte offset into the buffer object's data store.
+                        // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexSubImage3D.xhtml
+                        SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+    }
 
     CHECK_GL_ERROR("Failed to update subimage data");
 
     if (UnpackBuffer != 0)
         glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
-    ContextState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
+    if (!m_UseDSA)
+        ContextState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
 }
 
 void Texture3D_OGL::AttachToFramebuffer(const TextureViewDesc& ViewDesc, GLenum AttachmentPoint)
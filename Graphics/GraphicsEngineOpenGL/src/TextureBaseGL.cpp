@@ -88,9 +88,16 @@ TextureBaseGL::TextureBaseGL(IReferenceCounters*        pRefCounters,
         TexDesc,
         bIsDeviceInternal
     },
-    m_GlTexture     {TexDesc.Usage != USAGE_STAGING},
+    // With direct state access, the texture is created for its bind target right away,
+    // so that it can be initialized without binding it to the context.
+    m_GlTexture
+    {
+        TexDesc.Usage != USAGE_STAGING,
+        GLObjectWrappers::GLTextureCreateReleaseHelper{0, pDeviceGL->GetGLCaps().DirectStateAccess ? BindTarget : GLenum{0}}
+    },
     m_BindTarget    {BindTarget },
-    m_GLTexFormat   {TexFormatToGLInternalTexFormat(m_Desc.Format, m_Desc.BindFlags)}
+    m_GLTexFormat   {TexFormatToGLInternalTexFormat(m_Desc.Format, m_Desc.BindFlags)},
+    m_UseDSA        {pDeviceGL->GetGLCaps().DirectStateAccess}
     //m_uiMapTarget(0)
 // clang-format on
 {
@@ -341,7 +348,8 @@ TextureBaseGL::TextureBaseGL(IReferenceCounters*        pRefCounters,
     // Create texture object wrapper, but use external texture handle
     m_GlTexture     {true, GLObjectWrappers::GLTextureCreateReleaseHelper(GLTextureHandle)},
     m_BindTarget    {BindTarget},
-    m_GLTexFormat   {GetTextureInternalFormat(GLState, BindTarget, m_GlTexture, TexDesc.Format)}
+    m_GLTexFormat   {GetTextureInternalFormat(GLState, BindTarget, m_GlTexture, TexDesc.Format)},
+    m_UseDSA        {pDeviceGL->GetGLCaps().DirectStateAccess}
 // clang-format on
 {
 }
@@ -362,7 +370,8 @@ TextureBaseGL::TextureBaseGL(IReferenceCounters*        pRefCounters,
     },
     m_GlTexture  {false},
     m_BindTarget {0    },
-    m_GLTexFormat{0    }
+    m_GLTexFormat{0    },
+    m_UseDSA     {false}
 // clang-format on
 {
 }
@@ -374,7 +383,9 @@ TextureBaseGL::~TextureBaseGL()
     // flag is set, because CopyData() can bind
     // texture as render target even when no flag
     // is set
-    static_cast<RenderDeviceGLImpl*>(GetDevice())->OnReleaseTexture(this);
+    auto* pDeviceGL = static_cast<RenderDeviceGLImpl*>(GetDevice());
+    pDeviceGL->OnReleaseTexture(this);
+    pDeviceGL->ReleaseGLObject(m_GlTexture);
 }
 
 IMPLEMENT_QUERY_INTERFACE(TextureBaseGL, IID_TextureGL, TTextureBase)
@@ -388,12 +399,15 @@ void TextureBaseGL::CreateViewInternal(const struct TextureViewDesc& OrigViewDes
 
     *ppView = nullptr;
 
+    auto* pDeviceGLImpl = ValidatedCast<RenderDeviceGLImpl>(GetDevice());
+    if (pDeviceGLImpl->DispatchToWorkerContext([&]() { CreateViewInternal(OrigViewDesc, ppView, bIsDefaultView); }))
+        return;
+
     try
     {
         auto ViewDesc = OrigViewDesc;
         CorrectTextureViewDesc(ViewDesc);
 
-        auto* pDeviceGLImpl    = ValidatedCast<RenderDeviceGLImpl>(GetDevice());
         auto& TexViewAllocator = pDeviceGLImpl->GetTexViewObjAllocator();
         VERIFY(&TexViewAllocator == &m_dbgTexViewObjAllocator, "Texture view allocator does not match allocator provided during texture initialization");
 
@@ -701,6 +715,7 @@ void TextureBaseGL::TextureMemoryBarrier(Uint32 RequiredBarriers, GLContextState
 void TextureBaseGL::SetDefaultGLParameters()
 {
 #ifdef DILIGENT_DEBUG
+    if (!m_UseDSA)
     {
         GLint BoundTex;
         GLint TextureBinding = 0;
@@ -735,12 +750,23 @@ void TextureBaseGL::SetDefaultGLParameters()
 
         // The default value of GL_TEXTURE_MIN_FILTER is GL_NEAREST_MIPMAP_LINEAR
         // Reset it to GL_NEAREST to avoid incompletness issues with integer textures
-        glTexParameteri(m_BindTarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        CHECK_GL_ERROR("Failed to set GL_TEXTURE_MIN_FILTER texture parameter");
-
         // The default value of GL_TEXTURE_MAG_FILTER is GL_LINEAR
-        glTexParameteri(m_BindTarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        CHECK_GL_ERROR("Failed to set GL_TEXTURE_MAG_FILTER texture parameter");
+#if GL_ARB_direct_state_access
+        if (m_UseDSA)
+        {
+            glTextureParameteri(m_GlTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            CHECK_GL_ERROR("Failed to set GL_TEXTURE_MIN_FILTER texture parameter");
+            glTextureParameteri(m_GlTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            CHECK_GL_ERROR("Failed to set GL_TEXTURE_MAG_FILTER texture parameter");
+        }
+        else
+#endif
+        {
+            glTexParameteri(m_BindTarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            CHECK_GL_ERROR("Failed to set GL_TEXTURE_MIN_FILTER texture parameter");
+            glTexParameteri(m_BindTarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            CHECK_GL_ERROR("Failed to set GL_TEXTURE_MAG_FILTER texture parameter");
+        }
     }
 }
 
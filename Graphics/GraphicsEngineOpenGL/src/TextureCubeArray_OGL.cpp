@@ -65,14 +65,20 @@ TextureCubeArray_OGL::TextureCubeArray_OGL(IReferenceCounters*        pRefCounte
 
     VERIFY(m_Desc.SampleCount == 1, "Multisampled texture cube arrays are not supported");
 
-    GLState.BindTexture(-1, m_BindTarget, m_GlTexture);
+    if (!m_UseDSA)
+        GLState.BindTexture(-1, m_BindTarget, m_GlTexture);
 
     // Every OpenGL API call that operates on cubemap array textures takes layer-faces, not array layers.
     // For example, when you allocate storage for the texture, you would use glTexStorage3D? or glTexImage3D? or similar.
     // The depth? parameter will be the number of layer-faces, not layers. So it must be divisible by 6.
     VERIFY((m_Desc.ArraySize % 6) == 0, "Array size must be multiple of 6");
-    //                             levels             format          width         height          depth
-    glTexStorage3D(m_BindTarget, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.Height, m_Desc.ArraySize);
+#if GL_ARB_direct_state_access
+    if (m_UseDSA)
+        glTextureStorage3D(m_GlTexture, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.Height, m_Desc.ArraySize);
+    else
+#endif
+        //                             levels             format          width         height          depth
+        glTexStorage3D(m_BindTarget, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.Height, m_Desc.ArraySize);
     CHECK_GL_ERROR_AND_THROW("Failed to allocate storage for the Cubemap texture array");
     //When target is GL_TEXTURE_CUBE_MAP_ARRAY glTexStorage3D is equivalent to:
     //
@@ -109,7 +115,8 @@ TextureCubeArray_OGL::TextureCubeArray_OGL(IReferenceCounters*        pRefCounte
         }
     }
 
-    GLState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
+    if (!m_UseDSA)
+        GLState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
 }
 
 TextureCubeArray_OGL::TextureCubeArray_OGL(IReferenceCounters*        pRefCounters,
@@ -148,7 +155,8 @@ void TextureCubeArray_OGL::UpdateData(GLContextState&          ContextState,
 {
     TextureBaseGL::UpdateData(ContextState, MipLevel, Slice, DstBox, SubresData);
 
-    ContextState.BindTexture(-1, m_BindTarget, m_GlTexture);
+    if (!m_UseDSA)
+        ContextState.BindTexture(-1, m_BindTarget, m_GlTexture);
 
     // Bind buffer if it is provided; copy from CPU memory otherwise
     GLuint UnpackBuffer = 0;
@@ -194,26 +202,44 @@ void TextureCubeArray_OGL::UpdateData(GLContextState&          ContextState,
         auto UpdateRegionHeight = DstBox.MaxY - DstBox.MinY;
         UpdateRegionWidth       = std::min(UpdateRegionWidth, MipWidth - DstBox.MinX);
         UpdateRegionHeight      = std::min(UpdateRegionHeight, MipHeight - DstBox.MinY);
-        glCompressedTexSubImage3D(m_BindTarget, MipLevel,
-                                  DstBox.MinX,
-                                  DstBox.MinY,
-                                  Slice,
-                                  UpdateRegionWidth,
-                                  UpdateRegionHeight,
-                                  1,
-                                  // The format must be the same compressed-texture format previously
-                                  // specified by glTexStorage2D() (thank you OpenGL for another useless
-                                  // parameter that is nothing but the source of confusion), otherwise
-                                  // INVALID_OPERATION error is generated.
-                                  m_GLTexFormat,
-                                  // An INVALID_VALUE error is generated if imageSize is not consistent with
-                                  // the format, dimensions, and contents of the compressed image( too little or
-                                  // too much data ),
-                                  ((DstBox.MaxY - DstBox.MinY + 3) / 4) * SubresData.Stride,
-                                  // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
-                                  // as a byte offset into the buffer object's data store.
-                                  // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glCompressedTexSubImage3D.xhtml
-                                  SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+#if GL_ARB_direct_state_access
+        if (m_UseDSA)
+        {
+            glCompressedTextureSubImage3D(m_GlTexture, MipLevel,
+                                          DstBox.MinX,
+                                          DstBox.MinY,
+                                          Slice,
+                                          UpdateRegionWidth,
+                                          UpdateRegionHeight,
+                                          1,
+                                          m_GLTexFormat,
+                                          ((DstBox.MaxY - DstBox.MinY + 3) / 4) * SubresData.Stride,
+                                          SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
+        else
+#endif
+        {
+            glCompressedTexSubImage3D(m_BindTarget, MipLevel,
+                                      DstBox.MinX,
+                                      DstBox.MinY,
+                                      Slice,
+                                      UpdateRegionWidth,
+                                      UpdateRegionHeight,
+                                      1,
+                                      // The format must be the same compressed-texture format previously
+                                      // specified by glTexStorage2D() (thank you OpenGL for another useless
+                                      // parameter that is nothing but the source of confusion), otherwise
+                                      // INVALID_OPERATION error is generated.
+                                      m_GLTexFormat,
+                                      // An INVALID_VALUE error is generated if imageSize is not consistent with
+                                      // the format, dimensions, and contents of the compressed image( too little or
+                                      // too much data ),
+                                      ((DstBox.MaxY - DstBox.MinY + 3) / 4) * SubresData.Stride,
+                                      // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
+                                      // as a byte offset into the buffer object's data store.
+                                      // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glCompressedTexSubImage3D.xhtml
+                                      SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
     }
     else
     {
@@ -232,25 +258,43 @@ void TextureCubeArray_OGL::UpdateData(GLContextState&          ContextState,
 
         // Target must be GL_TEXTURE_3D, GL_TEXTURE_2D_ARRAY, or GL_TEXTURE_CUBE_MAP_ARRAY.
         // (NO individual cubemap faces GL_TEXTURE_CUBE_MAP_POSITIVE_X .. GL_TEXTURE_CUBE_MAP_NEGATIVE_Z!!!)
-        glTexSubImage3D(m_BindTarget, MipLevel,
-                        DstBox.MinX,
-                        DstBox.MinY,
-                        Slice,
-                        DstBox.MaxX - DstBox.MinX,
-                        DstBox.MaxY - DstBox.MinY,
-                        1,
-                        TransferAttribs.PixelFormat, TransferAttribs.DataType,
-                        // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
-                        // as a byte offset into the buffer object's data store.
-                        // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexSubImage3D.xhtml
-                        SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+#if GL_ARB_direct_state_access
+        if (m_UseDSA)
+        {
+            glTextureSubImage3D(m_GlTexture, MipLevel,
+                                DstBox.MinX,
+                                DstBox.MinY,
+                                Slice,
+                                DstBox.MaxX - DstBox.MinX,
+                                DstBox.MaxY - DstBox.MinY,
+                                1,
+                                TransferAttribs.PixelFormat, TransferAttribs.DataType,
+                                SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
+        else
+#endif
+        {
+            glTexSubImage3D(m_BindTarget, MipLevel,
+                            DstBox.MinX,
+                            DstBox.MinY,
+                            Slice,
+                            DstBox.MaxX - DstBox.MinX,
+                            DstBox.MaxY - DstBox.MinY,
+                            1,
+                            TransferAttribs.PixelFormat, TransferAttribs.DataType,
+                            // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
+                            // as a byte offset into the buffer object's data store.
+                            // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexSubImage3D.xhtml
+                            SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
     }
     CHECK_GL_ERROR("Failed to update subimage data");
 
     if (UnpackBuffer != 0)
         glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
-    ContextState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
+    if (!m_UseDSA)
+        ContextState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
 }
 
 void TextureCubeArray_OGL::AttachToFramebuffer(const TextureViewDesc& ViewDesc, GLenum AttachmentPoint)
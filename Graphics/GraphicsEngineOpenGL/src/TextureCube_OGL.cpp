@@ -65,11 +65,17 @@ TextureCube_OGL::TextureCube_OGL(IReferenceCounters*        pRefCounters,
 
     VERIFY(m_Desc.SampleCount == 1, "Multisampled cubemap textures are not supported");
 
-    GLState.BindTexture(-1, m_BindTarget, m_GlTexture);
+    if (!m_UseDSA)
+        GLState.BindTexture(-1, m_BindTarget, m_GlTexture);
 
     VERIFY(m_Desc.ArraySize == 6, "Cubemap texture is expected to have 6 slices");
-    //                             levels             format          width         height
-    glTexStorage2D(m_BindTarget, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.Height);
+#if GL_ARB_direct_state_access
+    if (m_UseDSA)
+        glTextureStorage2D(m_GlTexture, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.Height);
+    else
+#endif
+        //                             levels             format          width         height
+        glTexStorage2D(m_BindTarget, m_Desc.MipLevels, m_GLTexFormat, m_Desc.Width, m_Desc.Height);
     CHECK_GL_ERROR_AND_THROW("Failed to allocate storage for the Cubemap texture");
     //When target is GL_TEXTURE_CUBE_MAP, glTexStorage2D is equivalent to:
     //
@@ -108,7 +114,8 @@ TextureCube_OGL::TextureCube_OGL(IReferenceCounters*        pRefCounters,
         }
     }
 
-    GLState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
+    if (!m_UseDSA)
+        GLState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
 }
 
 TextureCube_OGL::TextureCube_OGL(IReferenceCounters*        pRefCounters,
@@ -163,7 +170,8 @@ void TextureCube_OGL::UpdateData(GLContextState&          ContextState,
 
     // Texture must be bound as GL_TEXTURE_CUBE_MAP, but glTexSubImage2D()
     // then takes one of GL_TEXTURE_CUBE_MAP_POSITIVE_X ... GL_TEXTURE_CUBE_MAP_NEGATIVE_Z
-    ContextState.BindTexture(-1, m_BindTarget, m_GlTexture);
+    if (!m_UseDSA)
+        ContextState.BindTexture(-1, m_BindTarget, m_GlTexture);
 
     auto CubeMapFaceBindTarget = CubeMapFaces[Slice];
 
@@ -212,24 +220,43 @@ void TextureCube_OGL::UpdateData(GLContextState&          ContextState,
         auto UpdateRegionHeight = DstBox.MaxY - DstBox.MinY;
         UpdateRegionWidth       = std::min(UpdateRegionWidth, MipWidth - DstBox.MinX);
         UpdateRegionHeight      = std::min(UpdateRegionHeight, MipHeight - DstBox.MinY);
-        glCompressedTexSubImage2D(CubeMapFaceBindTarget, MipLevel,
-                                  DstBox.MinX,
-                                  DstBox.MinY,
-                                  UpdateRegionWidth,
-                                  UpdateRegionHeight,
-                                  // The format must be the same compressed-texture format previously
-                                  // specified by glTexStorage2D() (thank you OpenGL for another useless
-                                  // parameter that is nothing but the source of confusion), otherwise
-                                  // INVALID_OPERATION error is generated.
-                                  m_GLTexFormat,
-                                  // An INVALID_VALUE error is generated if imageSize is not consistent with
-                                  // the format, dimensions, and contents of the compressed image( too little or
-                                  // too much data ),
-                                  ((DstBox.MaxY - DstBox.MinY + 3) / 4) * SubresData.Stride,
-                                  // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
-                                  // as a byte offset into the buffer object's data store.
-                                  // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glCompressedTexSubImage2D.xhtml
-                                  SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+#if GL_ARB_direct_state_access
+        if (m_UseDSA)
+        {
+            // With direct state access, cube map faces are addressed as layers of the texture
+            glCompressedTextureSubImage3D(m_GlTexture, MipLevel,
+                                          DstBox.MinX,
+                                          DstBox.MinY,
+                                          Slice,
+                                          UpdateRegionWidth,
+                                          UpdateRegionHeight,
+                                          1,
+                                          m_GLTexFormat,
+                                          ((DstBox.MaxY - DstBox.MinY + 3) / 4) * SubresData.Stride,
+                                          SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
+        else
+#endif
+        {
+            glCompressedTexSubImage2D(CubeMapFaceBindTarget, MipLevel,
+                                      DstBox.MinX,
+                                      DstBox.MinY,
+                                      UpdateRegionWidth,
+                                      UpdateRegionHeight,
+                                      // The format must be the same compressed-texture format previously
+                                      // specified by glTexStorage2D() (thank you OpenGL for another useless
+                                      // parameter that is nothing but the source of confusion), otherwise
+                                      // INVALID_OPERATION error is generated.
+                                      m_GLTexFormat,
+                                      // An INVALID_VALUE error is generated if imageSize is not consistent with
+                                      // the format, dimensions, and contents of the compressed image( too little or
+                                      // too much data ),
+                                      ((DstBox.MaxY - DstBox.MinY + 3) / 4) * SubresData.Stride,
+                                      // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
+                                      // as a byte offset into the buffer object's data store.
+                                      // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glCompressedTexSubImage2D.xhtml
+                                      SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
     }
     else
     {
@@ -242,23 +269,42 @@ void TextureCube_OGL::UpdateData(GLContextState&          ContextState,
 
         // Texture must be bound as GL_TEXTURE_CUBE_MAP, but glTexSubImage2D()
         // takes one of GL_TEXTURE_CUBE_MAP_POSITIVE_X ... GL_TEXTURE_CUBE_MAP_NEGATIVE_Z
-        glTexSubImage2D(CubeMapFaceBindTarget, MipLevel,
-                        DstBox.MinX,
-                        DstBox.MinY,
-                        DstBox.MaxX - DstBox.MinX,
-                        DstBox.MaxY - DstBox.MinY,
-                        TransferAttribs.PixelFormat, TransferAttribs.DataType,
-                        // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
-                        // as a byte offset into the buffer object's data store.
-                        // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexSubImage2D.xhtml
-                        SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+#if GL_ARB_direct_state_access
+        if (m_UseDSA)
+        {
+            // With direct state access, cube map faces are addressed as layers of the texture
+            glTextureSubImage3D(m_GlTexture, MipLevel,
+                                DstBox.MinX,
+                                DstBox.MinY,
+                                Slice,
+                                DstBox.MaxX - DstBox.MinX,
+                                DstBox.MaxY - DstBox.MinY,
+                                1,
+                                TransferAttribs.PixelFormat, TransferAttribs.DataType,
+                                SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
+        else
+#endif
+        {
+            glTexSubImage2D(CubeMapFaceBindTarget, MipLevel,
+                            DstBox.MinX,
+                            DstBox.MinY,
+                            DstBox.MaxX - DstBox.MinX,
+                            DstBox.MaxY - DstBox.MinY,
+                            TransferAttribs.PixelFormat, TransferAttribs.DataType,
+                            // If a non-zero named buffer object is bound to the GL_PIXEL_UNPACK_BUFFER target, 'data' is treated
+                            // as a byte offset into the buffer object's data store.
+                            // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexSubImage2D.xhtml
+                            SubresData.pSrcBuffer != nullptr ? reinterpret_cast<void*>(static_cast<size_t>(SubresData.SrcOffset)) : SubresData.pData);
+        }
     }
     CHECK_GL_ERROR("Failed to update subimage data");
 
     if (UnpackBuffer != 0)
         glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
-    ContextState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
+    if (!m_UseDSA)
+        ContextState.BindTexture(-1, m_BindTarget, GLObjectWrappers::GLTextureObj::Null());
 }
 
 void TextureCube_OGL::AttachToFramebuffer(const TextureViewDesc& ViewDesc, GLenum AttachmentPoint)
@@ -58,6 +58,7 @@ TextureViewGLImpl::TextureViewGLImpl(IReferenceCounters*    pRefCounters,
 
 TextureViewGLImpl::~TextureViewGLImpl()
 {
+    GetDevice()->ReleaseGLObject(m_ViewTexGLHandle);
 }
 
 IMPLEMENT_QUERY_INTERFACE(TextureViewGLImpl, IID_TextureViewGL, TTextureViewBase)
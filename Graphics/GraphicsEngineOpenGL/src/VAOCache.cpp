@@ -44,6 +44,9 @@ VAOCache::VAOCache() :
     m_Cache.max_load_factor(0.5f);
     m_PSOToKey.max_load_factor(0.5f);
     m_BuffToKey.max_load_factor(0.5f);
+    m_LayoutVAOs.max_load_factor(0.5f);
+    m_BuffToLayoutVAO.max_load_factor(0.5f);
+    m_PSOToLayoutVAO.max_load_factor(0.5f);
 }
 
 VAOCache::~VAOCache()
@@ -51,30 +54,129 @@ VAOCache::~VAOCache()
     VERIFY(m_Cache.empty(), "VAO cache is not empty. Are there any unreleased objects?");
     VERIFY(m_PSOToKey.empty(), "PSOToKey hash is not empty");
     VERIFY(m_BuffToKey.empty(), "BuffToKey hash is not empty");
+    VERIFY(m_PSOToLayoutVAO.empty(), "PSOToLayoutVAO hash is not empty");
+    VERIFY(m_LayoutVAOs.empty(), "Layout VAO cache is not empty. Are there any unreleased objects?");
+    VERIFY(m_BuffToLayoutVAO.empty(), "BuffToLayoutVAO hash is not empty");
 }
 
-void VAOCache::OnDestroyBuffer(IBuffer* pBuffer)
+void VAOCache::OnLayoutVAOBindingChanged(LayoutVAO& VAO, UniqueIdentifier OldBufferUId, UniqueIdentifier NewBufferUId)
+{
+    if (OldBufferUId == NewBufferUId)
+        return;
+
+    // The same buffer may be bound to several slots, so the reference is only removed
+    // when the buffer is no longer bound to the VAO, and only added once.
+    if (OldBufferUId != 0 && !VAO.IsBufferBound(OldBufferUId))
+    {
+        auto EqualRange = m_BuffToLayoutVAO.equal_range(OldBufferUId);
+        for (auto It = EqualRange.first; It != EqualRange.second; ++It)
+        {
+            if (It->second == &VAO)
+            {
+                m_BuffToLayoutVAO.erase(It);
+                break;
+            }
+        }
+    }
+
+    if (NewBufferUId != 0)
+    {
+        auto EqualRange = m_BuffToLayoutVAO.equal_range(NewBufferUId);
+        for (auto It = EqualRange.first; It != EqualRange.second; ++It)
+        {
+            if (It->second == &VAO)
+                return;
+        }
+        m_BuffToLayoutVAO.emplace(NewBufferUId, &VAO);
+    }
+}
+
+void VAOCache::EraseLayoutVAO(LayoutVAO& VAO)
+{
+    for (auto PSOUId : VAO.PSOUIds)
+        m_PSOToLayoutVAO.erase(PSOUId);
+
+    // Unbind all buffers to remove the references from m_BuffToLayoutVAO
+    for (Uint32 Slot = 0; Slot < VAO.NumUsedSlots; ++Slot)
+    {
+        const auto BufferUId = VAO.BoundBuffers[Slot].BufferUId;
+
+        VAO.BoundBuffers[Slot].BufferUId = 0;
+        OnLayoutVAOBindingChanged(VAO, BufferUId, 0);
+    }
+    {
+        const auto BufferUId = VAO.BoundIndexBufferUId;
+
+        VAO.BoundIndexBufferUId = 0;
+        OnLayoutVAOBindingChanged(VAO, BufferUId, 0);
+    }
+
+    VERIFY_EXPR(VAO.pKey != nullptr);
+    m_LayoutVAOs.erase(*VAO.pKey);
+}
+
+void VAOCache::OnDestroyBuffer(UniqueIdentifier BufferUId)
 {
     ThreadingTools::LockHelper CacheLock(m_CacheLockFlag);
 
-    auto EqualRange = m_BuffToKey.equal_range(pBuffer);
+    auto EqualRange = m_BuffToKey.equal_range(BufferUId);
     for (auto It = EqualRange.first; It != EqualRange.second; ++It)
     {
         m_Cache.erase(It->second);
     }
     m_BuffToKey.erase(EqualRange.first, EqualRange.second);
+
+    // A buffer attached to a VAO is not deleted by GL until the VAO releases it, so destroy every layout VAO
+    // that still references the buffer. PSOs that use these VAOs will create new ones on the next draw call.
+    for (auto It = m_BuffToLayoutVAO.find(BufferUId); It != m_BuffToLayoutVAO.end(); It = m_BuffToLayoutVAO.find(BufferUId))
+    {
+        EraseLayoutVAO(*It->second);
+    }
 }
 
-void VAOCache::OnDestroyPSO(IPipelineState* pPSO)
+void VAOCache::OnDestroyPSO(UniqueIdentifier PSOUId)
 {
     ThreadingTools::LockHelper CacheLock(m_CacheLockFlag);
 
-    auto EqualRange = m_PSOToKey.equal_range(pPSO);
+    auto EqualRange = m_PSOToKey.equal_range(PSOUId);
     for (auto It = EqualRange.first; It != EqualRange.second; ++It)
     {
         m_Cache.erase(It->second);
     }
     m_PSOToKey.erase(EqualRange.first, EqualRange.second);
+
+    // Layout VAOs are shared between all PSOs with the same input layout and are
+    // destroyed when the last PSO that uses the VAO is released.
+    auto PSOIt = m_PSOToLayoutVAO.find(PSOUId);
+    if (PSOIt != m_PSOToLayoutVAO.end())
+    {
+        auto* pLayoutVAO = PSOIt->second;
+        m_PSOToLayoutVAO.erase(PSOIt);
+        if (pLayoutVAO != nullptr)
+        {
+            auto& PSOUIds  = pLayoutVAO->PSOUIds;
+            auto  VAOPSOIt = std::find(PSOUIds.begin(), PSOUIds.end(), PSOUId);
+            VERIFY_EXPR(VAOPSOIt != PSOUIds.end());
+            if (VAOPSOIt != PSOUIds.end())
+            {
+                *VAOPSOIt = PSOUIds.back();
+                PSOUIds.pop_back();
+            }
+            if (PSOUIds.empty())
+                EraseLayoutVAO(*pLayoutVAO);
+        }
+    }
+}
+
+static bool IsIntegerVertexAttrib(const LayoutElement& Elem)
+{
+    return !Elem.IsNormalized &&
+        (Elem.ValueType == VT_INT8 ||
+         Elem.ValueType == VT_INT16 ||
+         Elem.ValueType == VT_INT32 ||
+         Elem.ValueType == VT_UINT8 ||
+         Elem.ValueType == VT_UINT16 ||
+         Elem.ValueType == VT_UINT32);
 }
 
 const GLObjectWrappers::GLVertexArrayObj& VAOCache::GetVAO(IPipelineState*                pPSO,
@@ -192,13 +294,7 @@ const GLObjectWrappers::GLVertexArrayObj& VAOCache::GetVAO(IPipelineState*
             GLState.BindBuffer(GL_ARRAY_BUFFER, pBufferOGL->m_GlBuffer, ResetVAO);
             GLvoid* DataStartOffset = reinterpret_cast<GLvoid*>(static_cast<size_t>(CurrStream.Offset) + static_cast<size_t>(LayoutIt->RelativeOffset));
             auto    GlType          = TypeToGLType(LayoutIt->ValueType);
-            if (!LayoutIt->IsNormalized &&
-                (LayoutIt->ValueType == VT_INT8 ||
-                 LayoutIt->ValueType == VT_INT16 ||
-                 LayoutIt->ValueType == VT_INT32 ||
-                 LayoutIt->ValueType == VT_UINT8 ||
-                 LayoutIt->ValueType == VT_UINT16 ||
-                 LayoutIt->ValueType == VT_UINT32))
+            if (IsIntegerVertexAttrib(*LayoutIt))
                 glVertexAttribIPointer(LayoutIt->InputIndex, LayoutIt->NumComponents, GlType, Stride, DataStartOffset);
             else
                 glVertexAttribPointer(LayoutIt->InputIndex, LayoutIt->NumComponents, GlType, LayoutIt->IsNormalized, Stride, DataStartOffset);
@@ -222,18 +318,198 @@ const GLObjectWrappers::GLVertexArrayObj& VAOCache::GetVAO(IPipelineState*
         auto NewElems = m_Cache.emplace(std::make_pair(Key, std::move(NewVAO)));
         // New element must be actually inserted
         VERIFY(NewElems.second, "New element was not inserted into the cache");
-        m_PSOToKey.insert(std::make_pair(pPSO, Key));
+        m_PSOToKey.insert(std::make_pair(Key.PSOUId, Key));
         for (Uint32 Slot = 0; Slot < Key.NumUsedSlots; ++Slot)
         {
             auto* pCurrBuff = VertexBuffers[Slot];
             if (pCurrBuff)
-                m_BuffToKey.insert(std::make_pair(pCurrBuff, Key));
+                m_BuffToKey.insert(std::make_pair(pCurrBuff->GetUniqueID(), Key));
         }
 
         return NewElems.first->second;
     }
 }
 
+const GLObjectWrappers::GLVertexArrayObj* VAOCache::GetLayoutVAO(IPipelineState*                pPSO,
+                                                                 IBuffer*                       pIndexBuffer,
+                                                                 VertexStreamInfo<BufferGLImpl> VertexStreams[],
+                                                                 Uint32                         NumVertexStreams,
+                                                                 Uint32                         MaxRelativeOffset,
+                                                                 GLContextState&                GLState)
+{
+#if GL_ARB_vertex_attrib_binding
+    // Lock the cache
+    ThreadingTools::LockHelper CacheLock{m_CacheLockFlag};
+
+    auto*       pPSOGL      = ValidatedCast<PipelineStateGLImpl>(pPSO);
+    const auto& InputLayout = pPSOGL->GetDesc().GraphicsPipeline.InputLayout;
+
+    LayoutVAO* pLayoutVAO = nullptr;
+
+    auto PSOIt = m_PSOToLayoutVAO.find(pPSOGL->GetUniqueID());
+    if (PSOIt != m_PSOToLayoutVAO.end())
+    {
+        pLayoutVAO = PSOIt->second;
+    }
+    else
+    {
+        LayoutVAOKey Key;
+        Key.Elements.reserve(InputLayout.NumElements);
+
+        // In separate format/binding model, the instance divisor is the property of the binding
+        // rather than of the attribute, so all attributes in the same slot must use the same divisor.
+        Uint32 SlotDivisors[MAX_BUFFER_SLOTS];
+        bool   SlotUsed[MAX_BUFFER_SLOTS] = {};
+
+        bool IsCompatible = true;
+        for (Uint32 Elem = 0; Elem < InputLayout.NumElements; ++Elem)
+        {
+            const auto& LayoutElem = InputLayout.LayoutElements[Elem];
+            if (LayoutElem.BufferSlot >= MAX_BUFFER_SLOTS)
+            {
+                UNEXPECTED("Incorrect input buffer slot");
+                continue;
+            }
+
+            Uint32 Divisor = LayoutElem.Frequency == INPUT_ELEMENT_FREQUENCY_PER_INSTANCE ? LayoutElem.InstanceDataStepRate : 0;
+            if (SlotUsed[LayoutElem.BufferSlot] && SlotDivisors[LayoutElem.BufferSlot] != Divisor)
+            {
+                IsCompatible = false;
+                break;
+            }
+            if (LayoutElem.RelativeOffset > MaxRelativeOffset)
+            {
+                // The attribute can only be addressed through the buffer offset in glVertexAttribPointer
+                IsCompatible = false;
+                break;
+            }
+            SlotUsed[LayoutElem.BufferSlot]     = true;
+            SlotDivisors[LayoutElem.BufferSlot] = Divisor;
+
+            LayoutVAOKey::ElementAttribs ElemAttribs;
+            ElemAttribs.InputIndex     = LayoutElem.InputIndex;
+            ElemAttribs.BufferSlot     = LayoutElem.BufferSlot;
+            ElemAttribs.NumComponents  = LayoutElem.NumComponents;
+            ElemAttribs.ValueType      = LayoutElem.ValueType;
+            ElemAttribs.IsNormalized   = LayoutElem.IsNormalized ? 1 : 0;
+            ElemAttribs.RelativeOffset = LayoutElem.RelativeOffset;
+            ElemAttribs.Divisor        = Divisor;
+            Key.Elements.push_back(ElemAttribs);
+        }
+
+        if (IsCompatible)
+        {
+            auto LayoutIt = m_LayoutVAOs.find(Key);
+            if (LayoutIt == m_LayoutVAOs.end())
+            {
+                LayoutIt = m_LayoutVAOs.emplace(std::move(Key), LayoutVAO{}).first;
+
+                // Initialize vertex format. Note that the format does not reference any buffers.
+                auto& NewVAO = LayoutIt->second;
+                NewVAO.pKey  = &LayoutIt->first;
+                GLState.BindVAO(NewVAO.VAO);
+                for (Uint32 Elem = 0; Elem < InputLayout.NumElements; ++Elem)
+                {
+                    const auto& LayoutElem = InputLayout.LayoutElements[Elem];
+                    if (LayoutElem.BufferSlot >= MAX_BUFFER_SLOTS)
+                        continue;
+
+                    auto GlType = TypeToGLType(LayoutElem.ValueType);
+                    if (IsIntegerVertexAttrib(LayoutElem))
+                        glVertexAttribIFormat(LayoutElem.InputIndex, LayoutElem.NumComponents, GlType, LayoutElem.RelativeOffset);
+                    else
+                        glVertexAttribFormat(LayoutElem.InputIndex, LayoutElem.NumComponents, GlType, LayoutElem.IsNormalized, LayoutElem.RelativeOffset);
+                    glVertexAttribBinding(LayoutElem.InputIndex, LayoutElem.BufferSlot);
+                    glEnableVertexAttribArray(LayoutElem.InputIndex);
+
+                    NewVAO.NumUsedSlots = std::max(NewVAO.NumUsedSlots, LayoutElem.BufferSlot + 1);
+                    NewVAO.UsedSlotsMask |= 1u << LayoutElem.BufferSlot;
+                }
+                for (Uint32 Slot = 0; Slot < NewVAO.NumUsedSlots; ++Slot)
+                {
+                    if (SlotUsed[Slot])
+                        glVertexBindingDivisor(Slot, SlotDivisors[Slot]);
+                }
+                CHECK_GL_ERROR("Failed to initialize vertex format");
+            }
+            pLayoutVAO = &LayoutIt->second;
+            pLayoutVAO->PSOUIds.push_back(pPSOGL->GetUniqueID());
+        }
+
+        m_PSOToLayoutVAO.emplace(pPSOGL->GetUniqueID(), pLayoutVAO);
+    }
+
+    if (pLayoutVAO == nullptr)
+        return nullptr;
+
+    GLState.BindVAO(pLayoutVAO->VAO);
+
+    // Only update the bindings that have changed
+    for (Uint32 Slot = 0; Slot < pLayoutVAO->NumUsedSlots; ++Slot)
+    {
+        if (Slot >= NumVertexStreams)
+        {
+            UNEXPECTED("Input layout requires more buffers than bound to the pipeline");
+            break;
+        }
+
+        if ((pLayoutVAO->UsedSlotsMask & (1u << Slot)) == 0)
+            continue;
+
+        auto& CurrStream = VertexStreams[Slot];
+        auto* pBufferGL  = CurrStream.pBuffer.RawPtr();
+        if (pBufferGL == nullptr)
+        {
+            UNEXPECTED("No buffer bound to slot ", Slot);
+            continue;
+        }
+
+        pBufferGL->BufferMemoryBarrier(
+            GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT, // Vertex data sourced from buffer objects after the barrier
+                                                // will reflect data written by shaders prior to the barrier.
+            GLState);
+
+        auto  Stride      = pPSOGL->GetBufferStride(Slot);
+        auto& BoundBuffer = pLayoutVAO->BoundBuffers[Slot];
+        if (BoundBuffer.BufferUId != pBufferGL->GetUniqueID() ||
+            BoundBuffer.Offset != CurrStream.Offset ||
+            BoundBuffer.Stride != Stride)
+        {
+            glBindVertexBuffer(Slot, pBufferGL->m_GlBuffer, CurrStream.Offset, Stride);
+            CHECK_GL_ERROR("Failed to bind vertex buffer");
+            const auto OldBufferUId = BoundBuffer.BufferUId;
+            BoundBuffer.BufferUId   = pBufferGL->GetUniqueID();
+            BoundBuffer.Offset      = CurrStream.Offset;
+            BoundBuffer.Stride      = Stride;
+            OnLayoutVAOBindingChanged(*pLayoutVAO, OldBufferUId, BoundBuffer.BufferUId);
+        }
+    }
+
+    if (pIndexBuffer != nullptr)
+    {
+        auto* pIndexBufferGL = ValidatedCast<BufferGLImpl>(pIndexBuffer);
+        pIndexBufferGL->BufferMemoryBarrier(
+            GL_ELEMENT_ARRAY_BARRIER_BIT, // Vertex array indices sourced from buffer objects after the barrier
+                                          // will reflect data written by shaders prior to the barrier.
+            GLState);
+
+        if (pLayoutVAO->BoundIndexBufferUId != pIndexBufferGL->GetUniqueID())
+        {
+            // Element array buffer binding is part of the VAO state
+            constexpr bool ResetVAO = false;
+            GLState.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, pIndexBufferGL->m_GlBuffer, ResetVAO);
+            const auto OldBufferUId         = pLayoutVAO->BoundIndexBufferUId;
+            pLayoutVAO->BoundIndexBufferUId = pIndexBufferGL->GetUniqueID();
+            OnLayoutVAOBindingChanged(*pLayoutVAO, OldBufferUId, pLayoutVAO->BoundIndexBufferUId);
+        }
+    }
+
+    return &pLayoutVAO->VAO;
+#else
+    return nullptr;
+#endif
+}
+
 const GLObjectWrappers::GLVertexArrayObj& VAOCache::GetEmptyVAO()
 {
     return m_EmptyVAO;
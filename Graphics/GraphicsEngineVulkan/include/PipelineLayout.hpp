@@ -70,7 +70,7 @@ public:
                               Uint32&                           DescriptorSet,
                               Uint32&                           Binding,
                               Uint32&                           OffsetInCache,
-                              std::vector<uint32_t>&            SPIRV);
+                              std::vector<uint32_t>*            pSPIRV); // If not null, the byte code is patched to use the allocated slot
 
     Uint32 GetTotalDescriptors(SHADER_RESOURCE_VARIABLE_TYPE VarType) const
     {
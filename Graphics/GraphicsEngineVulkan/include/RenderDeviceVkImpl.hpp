@@ -48,6 +48,8 @@
 #include "FramebufferCache.hpp"
 #include "RenderPassCache.hpp"
 #include "CommandPoolManager.hpp"
+#include "SPIRVCache.hpp"
+#include "ResourceLayoutCacheVk.hpp"
 
 namespace Diligent
 {
@@ -156,6 +158,13 @@ public:
 
     void FlushStaleResources(Uint32 CmdQueueIndex);
 
+    /// Returns the cache of SPIR-V byte code compiled from shader sources.
+    SPIRVCache& GetSPIRVCache() { return m_SPIRVCache; }
+
+    /// Returns the cache of shader resource layouts resolved by pipeline states,
+    /// or null if the cache is disabled (see EngineVkCreateInfo::ResourceLayoutCacheSize).
+    ResourceLayoutCacheVk* GetResourceLayoutCache() { return m_pResourceLayoutCache.get(); }
+
 private:
     virtual void TestTextureFormat(TEXTURE_FORMAT TexFormat) override final;
 
@@ -185,6 +194,10 @@ private:
     VulkanUtilities::VulkanMemoryManager m_MemoryMgr;
 
     VulkanDynamicMemoryManager m_DynamicMemoryManager;
+
+    SPIRVCache m_SPIRVCache;
+
+    std::unique_ptr<ResourceLayoutCacheVk> m_pResourceLayoutCache;
 };
 
 } // namespace Diligent
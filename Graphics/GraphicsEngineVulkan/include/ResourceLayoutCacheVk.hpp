@@ -0,0 +1,141 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of Diligent::ResourceLayoutCacheVk class
+
+#include <vector>
+#include <memory>
+
+#include "PipelineState.h"
+#include "PersistentCache.hpp"
+
+namespace Diligent
+{
+
+class ShaderVkImpl;
+
+/// Key of the resolved resource layout, see ResourceLayoutCacheVk::MakeKey().
+struct ResourceLayoutCacheVkKey
+{
+    Uint64 Hash0      = 0;
+    Uint64 Hash1      = 0;
+    Uint32 NumShaders = 0;
+    Uint32 Padding    = 0; // The key is written to the cache file as is and must not contain uninitialized bytes
+
+    bool operator==(const ResourceLayoutCacheVkKey& rhs) const
+    {
+        return Hash0 == rhs.Hash0 &&
+            Hash1 == rhs.Hash1 &&
+            NumShaders == rhs.NumShaders;
+    }
+
+    struct Hasher
+    {
+        size_t operator()(const ResourceLayoutCacheVkKey& K) const
+        {
+            return static_cast<size_t>(K.Hash0 ^ (K.Hash1 * 0x9e3779b97f4a7c15ull));
+        }
+    };
+};
+
+/// Resolved resource layout of every shader in the pipeline, see ResourceLayoutCacheVk.
+struct ResourceLayoutCacheVkEntry
+{
+    /// Variable type and immutable sampler resolved from the pipeline resource layout for a single
+    /// shader resource (see ShaderResourceLayoutVk::ResolveResources()).
+    struct ResolvedResourceAttribs
+    {
+        Uint8 VarType             = SHADER_RESOURCE_VARIABLE_TYPE_STATIC;
+        Uint8 Padding             = 0;
+        Int16 ImmutableSamplerInd = -1; // Index into PipelineResourceLayoutDesc::StaticSamplers or -1
+    };
+    static_assert(sizeof(ResolvedResourceAttribs) == 4, "Resolved attributes are written to the cache file as is");
+
+    struct ShaderData
+    {
+        /// Resolved attributes of every shader resource, indexed by SPIRVShaderResources::GetResourceIndex()
+        std::vector<ResolvedResourceAttribs> Resources;
+
+        /// Byte code with patched bindings and stripped reflection
+        std::vector<uint32_t> SPIRV;
+    };
+
+    using Type = std::vector<ShaderData>;
+
+    // Value traits of the persistent cache, see PersistentCacheContainerTraits
+    static size_t GetSize(const std::shared_ptr<const Type>& pEntry);
+    static bool   Serialize(const std::shared_ptr<const Type>& pEntry, std::vector<Uint8>& Data);
+    static bool   Deserialize(const std::vector<Uint8>& Data, std::shared_ptr<const Type>& pEntry);
+};
+
+/// Cache of shader resource layouts resolved at pipeline state creation.
+
+/// Resolving the layout requires matching every shader resource against the variables and static
+/// samplers of the pipeline resource layout, patching binding and descriptor set decorations in the
+/// SPIR-V byte code and stripping reflection instructions from it. The cache stores the result of
+/// these steps: the variable type and the immutable sampler of every resource and the final byte
+/// code of every shader. Descriptor set layouts are rebuilt from the resolved resources, which is
+/// deterministic and does not require name matching or byte code processing.
+/// The entry is identified by the hash of the original byte code of all shaders in the pipeline and
+/// of the resource layout description. See PersistentCache for the details of the memory and on-disk stores.
+/// All methods are thread-safe.
+class ResourceLayoutCacheVk : public PersistentCache<ResourceLayoutCacheVkKey, std::shared_ptr<const ResourceLayoutCacheVkEntry::Type>, ResourceLayoutCacheVkEntry>
+{
+public:
+    using TBase = PersistentCache<ResourceLayoutCacheVkKey,
+                                  std::shared_ptr<const ResourceLayoutCacheVkEntry::Type>,
+                                  ResourceLayoutCacheVkEntry>;
+
+    using Key                     = ResourceLayoutCacheVkKey;
+    using ResolvedResourceAttribs = ResourceLayoutCacheVkEntry::ResolvedResourceAttribs;
+    using ShaderData              = ResourceLayoutCacheVkEntry::ShaderData;
+    using EntryType               = ResourceLayoutCacheVkEntry::Type;
+
+    /// Creates the key of the resource layout of the pipeline that uses the given shaders.
+    static Key MakeKey(Uint32                            NumShaders,
+                       const ShaderVkImpl* const         ppShaders[],
+                       const PipelineResourceLayoutDesc& ResourceLayoutDesc);
+
+    /// \param [in] MaxMemorySize - Maximum total size, in bytes, of the entries kept in memory.
+    explicit ResourceLayoutCacheVk(size_t MaxMemorySize = 16 << 20);
+
+    /// Looks up the entry in memory and then on disk. Returns null if the entry was not found
+    /// or if it is not consistent with the shaders and the resource layout description.
+    std::shared_ptr<const EntryType> Find(const Key&                        K,
+                                          const ShaderVkImpl* const         ppShaders[],
+                                          const PipelineResourceLayoutDesc& ResourceLayoutDesc);
+
+private:
+    static bool IsConsistent(const EntryType&                  Entry,
+                             const ShaderVkImpl* const         ppShaders[],
+                             const PipelineResourceLayoutDesc& ResourceLayoutDesc);
+};
+
+} // namespace Diligent
@@ -105,6 +105,7 @@
 #include "HashUtils.hpp"
 #include "ShaderResourceCacheVk.hpp"
 #include "SPIRVShaderResources.hpp"
+#include "ResourceLayoutCacheVk.hpp"
 #include "VulkanUtilities/VulkanLogicalDevice.hpp"
 
 namespace Diligent
@@ -129,21 +130,35 @@ public:
 
     ~ShaderResourceLayoutVk();
 
+    using ResolvedResourceAttribs = ResourceLayoutCacheVk::ResolvedResourceAttribs;
+
+    // Matches every resource of the shader against the variables and static samplers of the layout
+    // description. Resolved[] must contain Resources.GetTotalResources() elements and is indexed by
+    // SPIRVShaderResources::GetResourceIndex().
+    static void ResolveResources(const SPIRVShaderResources&       Resources,
+                                 const PipelineResourceLayoutDesc& ResourceLayoutDesc,
+                                 ResolvedResourceAttribs           Resolved[]);
+
     // This method is called by PipelineStateVkImpl class instance to initialize static
     // shader resource layout and the cache
     void InitializeStaticResourceLayout(std::shared_ptr<const SPIRVShaderResources> pSrcResources,
                                         IMemoryAllocator&                           LayoutDataAllocator,
                                         const PipelineResourceLayoutDesc&           ResourceLayoutDesc,
+                                        const ResolvedResourceAttribs               ResolvedResources[],
                                         ShaderResourceCacheVk&                      StaticResourceCache);
 
     // This method is called by PipelineStateVkImpl class instance to initialize resource
     // layouts for all shader stages in the pipeline.
+    // If SPIRVs is not null, binding and descriptor set decorations in the byte code are
+    // patched to match the layout. The byte code restored from the resource layout cache
+    // has already been patched, so null is passed in this case.
     static void Initialize(IRenderDevice*                              pRenderDevice,
                            Uint32                                      NumShaders,
                            ShaderResourceLayoutVk                      Layouts[],
                            std::shared_ptr<const SPIRVShaderResources> pShaderResources[],
                            IMemoryAllocator&                           LayoutDataAllocator,
                            const PipelineResourceLayoutDesc&           ResourceLayoutDesc,
+                           const ResolvedResourceAttribs* const        ResolvedResources[],
                            std::vector<uint32_t>                       SPIRVs[],
                            class PipelineLayout&                       PipelineLayout,
                            bool                                        VerifyVariables,
@@ -344,6 +359,7 @@ private:
     void AllocateMemory(std::shared_ptr<const SPIRVShaderResources> pSrcResources,
                         IMemoryAllocator&                           Allocator,
                         const PipelineResourceLayoutDesc&           ResourceLayoutDesc,
+                        const ResolvedResourceAttribs               ResolvedResources[],
                         const SHADER_RESOURCE_VARIABLE_TYPE*        AllowedVarTypes,
                         Uint32                                      NumAllowedTypes,
                         bool                                        AllocateImmutableSamplers);
@@ -388,15 +388,20 @@ void PipelineLayout::AllocateResourceSlot(const SPIRVShaderResourceAttribs& ResA
                                           Uint32&                           DescriptorSet, // Output parameter
                                           Uint32&                           Binding,       // Output parameter
                                           Uint32&                           OffsetInCache,
-                                          std::vector<uint32_t>&            SPIRV)
+                                          std::vector<uint32_t>*            pSPIRV)
 {
     VERIFY((ResAttribs.Type == SPIRVShaderResourceAttribs::ResourceType::SampledImage ||
             ResAttribs.Type == SPIRVShaderResourceAttribs::ResourceType::SeparateSampler) ||
                vkImmutableSampler == VK_NULL_HANDLE,
            "Immutable sampler should only be specified for combined image samplers or separate samplers");
     m_LayoutMgr.AllocateResourceSlot(ResAttribs, VariableType, vkImmutableSampler, ShaderType, DescriptorSet, Binding, OffsetInCache);
-    SPIRV[ResAttribs.BindingDecorationOffset]       = Binding;
-    SPIRV[ResAttribs.DescriptorSetDecorationOffset] = DescriptorSet;
+    if (pSPIRV != nullptr)
+    {
+        auto& SPIRV = *pSPIRV;
+
+        SPIRV[ResAttribs.BindingDecorationOffset]       = Binding;
+        SPIRV[ResAttribs.DescriptorSetDecorationOffset] = DescriptorSet;
+    }
 }
 
 void PipelineLayout::Finalize(const VulkanUtilities::VulkanLogicalDevice& LogicalDevice)
@@ -35,6 +35,7 @@
 #include "ShaderResourceBindingVkImpl.hpp"
 #include "EngineMemory.h"
 #include "StringTools.hpp"
+#include "ResourceLayoutCacheVk.hpp"
 
 #if !DILIGENT_NO_HLSL
 #    include "spirv-tools/optimizer.hpp"
@@ -167,8 +168,41 @@ PipelineStateVkImpl::PipelineStateVkImpl(IReferenceCounters*            pRefCoun
     // Initialize shader resource layouts
     auto& ShaderResLayoutAllocator = GetRawAllocator();
 
+    std::array<const ShaderVkImpl*, MAX_SHADERS_IN_PIPELINE>                         Shaders = {};
     std::array<std::shared_ptr<const SPIRVShaderResources>, MAX_SHADERS_IN_PIPELINE> ShaderResources;
     std::array<std::vector<uint32_t>, MAX_SHADERS_IN_PIPELINE>                       ShaderSPIRVs;
+    for (Uint32 s = 0; s < m_NumShaders; ++s)
+    {
+        Shaders[s]         = GetShader<const ShaderVkImpl>(s);
+        ShaderResources[s] = Shaders[s]->GetShaderResources();
+    }
+
+    // If the layout has been resolved before, restore the variable types, immutable samplers and
+    // the final byte code from the cache. Otherwise resolve the layout and patch the byte code.
+    auto*                                                   pLayoutCache = pDeviceVk->GetResourceLayoutCache();
+    ResourceLayoutCacheVk::Key                              LayoutKey;
+    std::shared_ptr<const ResourceLayoutCacheVk::EntryType> pCachedLayout;
+    if (pLayoutCache != nullptr)
+    {
+        LayoutKey     = ResourceLayoutCacheVk::MakeKey(m_NumShaders, Shaders.data(), m_Desc.ResourceLayout);
+        pCachedLayout = pLayoutCache->Find(LayoutKey, Shaders.data(), m_Desc.ResourceLayout);
+    }
+
+    std::shared_ptr<ResourceLayoutCacheVk::EntryType> pNewLayout;
+    if (!pCachedLayout)
+    {
+        pNewLayout = std::make_shared<ResourceLayoutCacheVk::EntryType>(m_NumShaders);
+        for (Uint32 s = 0; s < m_NumShaders; ++s)
+        {
+            auto& Resolved = (*pNewLayout)[s].Resources;
+            Resolved.resize(ShaderResources[s]->GetTotalResources());
+            ShaderResourceLayoutVk::ResolveResources(*ShaderResources[s], m_Desc.ResourceLayout, Resolved.data());
+            ShaderSPIRVs[s] = Shaders[s]->GetSPIRV();
+        }
+    }
+    const auto& ResolvedLayout = pCachedLayout ? *pCachedLayout : *pNewLayout;
+
+    std::array<const ShaderResourceLayoutVk::ResolvedResourceAttribs*, MAX_SHADERS_IN_PIPELINE> ResolvedResources = {};
 
     m_ShaderResourceLayouts = ALLOCATE(ShaderResLayoutAllocator, "Raw memory for ShaderResourceLayoutVk", ShaderResourceLayoutVk, m_NumShaders * 2);
     m_StaticResCaches       = ALLOCATE(GetRawAllocator(), "Raw memory for ShaderResourceCacheVk", ShaderResourceCacheVk, m_NumShaders);
@@ -176,22 +210,21 @@ PipelineStateVkImpl::PipelineStateVkImpl(IReferenceCounters*            pRefCoun
     for (Uint32 s = 0; s < m_NumShaders; ++s)
     {
         new (m_ShaderResourceLayouts + s) ShaderResourceLayoutVk(LogicalDevice);
-        auto* pShaderVk    = GetShader<const ShaderVkImpl>(s);
-        ShaderResources[s] = pShaderVk->GetShaderResources();
-        ShaderSPIRVs[s]    = pShaderVk->GetSPIRV();
+        ResolvedResources[s] = ResolvedLayout[s].Resources.data();
 
-        const auto ShaderType                = pShaderVk->GetDesc().ShaderType;
+        const auto ShaderType                = Shaders[s]->GetDesc().ShaderType;
         const auto ShaderTypeInd             = GetShaderTypeIndex(ShaderType);
         m_ResourceLayoutIndex[ShaderTypeInd] = static_cast<Int8>(s);
 
         auto* pStaticResLayout = new (m_ShaderResourceLayouts + m_NumShaders + s) ShaderResourceLayoutVk(LogicalDevice);
         auto* pStaticResCache  = new (m_StaticResCaches + s) ShaderResourceCacheVk(ShaderResourceCacheVk::DbgCacheContentType::StaticShaderResources);
-        pStaticResLayout->InitializeStaticResourceLayout(ShaderResources[s], ShaderResLayoutAllocator, m_Desc.ResourceLayout, m_StaticResCaches[s]);
+        pStaticResLayout->InitializeStaticResourceLayout(ShaderResources[s], ShaderResLayoutAllocator, m_Desc.ResourceLayout, ResolvedResources[s], m_StaticResCaches[s]);
 
         new (m_StaticVarsMgrs + s) ShaderVariableManagerVk(*this, *pStaticResLayout, GetRawAllocator(), nullptr, 0, *pStaticResCache);
     }
+    // Byte code restored from the cache has already been patched
     ShaderResourceLayoutVk::Initialize(pDeviceVk, m_NumShaders, m_ShaderResourceLayouts, ShaderResources.data(), GetRawAllocator(),
-                                       m_Desc.ResourceLayout, ShaderSPIRVs.data(), m_PipelineLayout,
+                                       m_Desc.ResourceLayout, ResolvedResources.data(), pCachedLayout ? nullptr : ShaderSPIRVs.data(), m_PipelineLayout,
                                        (CreateInfo.Flags & PSO_CREATE_FLAG_IGNORE_MISSING_VARIABLES) == 0,
                                        (CreateInfo.Flags & PSO_CREATE_FLAG_IGNORE_MISSING_STATIC_SAMPLERS) == 0);
     m_PipelineLayout.Finalize(LogicalDevice);
@@ -216,9 +249,11 @@ PipelineStateVkImpl::PipelineStateVkImpl(IReferenceCounters*            pRefCoun
 
     // Create shader modules and initialize shader stages
     std::array<VkPipelineShaderStageCreateInfo, MAX_SHADERS_IN_PIPELINE> ShaderStages = {};
+
+    bool AllShadersStripped = true;
     for (Uint32 s = 0; s < m_NumShaders; ++s)
     {
-        auto* pShaderVk  = GetShader<const ShaderVkImpl>(s);
+        auto* pShaderVk  = Shaders[s];
         auto  ShaderType = pShaderVk->GetDesc().ShaderType;
 
         auto& StageCI = ShaderStages[s];
@@ -243,22 +278,34 @@ PipelineStateVkImpl::PipelineStateVkImpl(IReferenceCounters*            pRefCoun
         ShaderModuleCI.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
         ShaderModuleCI.pNext = nullptr;
         ShaderModuleCI.flags = 0;
-        const auto& SPIRV    = ShaderSPIRVs[s];
-
-        // We have to strip reflection instructions to fix the follownig validation error:
-        //     SPIR-V module not valid: DecorateStringGOOGLE requires one of the following extensions: SPV_GOOGLE_decorate_string
-        // Optimizer also performs validation and may catch problems with the byte code.
-        auto StrippedSPIRV = StripReflection(SPIRV);
-        if (!StrippedSPIRV.empty())
+        if (pCachedLayout)
         {
-            ShaderModuleCI.codeSize = StrippedSPIRV.size() * sizeof(uint32_t);
-            ShaderModuleCI.pCode    = StrippedSPIRV.data();
+            // Reflection instructions have already been stripped from the cached byte code
+            const auto& SPIRV       = (*pCachedLayout)[s].SPIRV;
+            ShaderModuleCI.codeSize = SPIRV.size() * sizeof(uint32_t);
+            ShaderModuleCI.pCode    = SPIRV.data();
         }
         else
         {
-            LOG_ERROR("Failed to strip reflection information from shader '", pShaderVk->GetDesc().Name, "'. This may indicate a problem with the byte code.");
-            ShaderModuleCI.codeSize = SPIRV.size() * sizeof(uint32_t);
-            ShaderModuleCI.pCode    = SPIRV.data();
+            const auto& SPIRV = ShaderSPIRVs[s];
+
+            // We have to strip reflection instructions to fix the follownig validation error:
+            //     SPIR-V module not valid: DecorateStringGOOGLE requires one of the following extensions: SPV_GOOGLE_decorate_string
+            // Optimizer also performs validation and may catch problems with the byte code.
+            auto& StrippedSPIRV = (*pNewLayout)[s].SPIRV;
+            StrippedSPIRV       = StripReflection(SPIRV);
+            if (!StrippedSPIRV.empty())
+            {
+                ShaderModuleCI.codeSize = StrippedSPIRV.size() * sizeof(uint32_t);
+                ShaderModuleCI.pCode    = StrippedSPIRV.data();
+            }
+            else
+            {
+                LOG_ERROR("Failed to strip reflection information from shader '", pShaderVk->GetDesc().Name, "'. This may indicate a problem with the byte code.");
+                ShaderModuleCI.codeSize = SPIRV.size() * sizeof(uint32_t);
+                ShaderModuleCI.pCode    = SPIRV.data();
+                AllShadersStripped      = false;
+            }
         }
 
         m_ShaderModules[s] = LogicalDevice.CreateShaderModule(ShaderModuleCI, pShaderVk->GetDesc().Name);
@@ -268,6 +315,10 @@ PipelineStateVkImpl::PipelineStateVkImpl(IReferenceCounters*            pRefCoun
         StageCI.pSpecializationInfo = nullptr;
     }
 
+    // Byte code that failed to be stripped is not cached so that the error is reported every time
+    if (pLayoutCache != nullptr && pNewLayout && AllShadersStripped)
+        pLayoutCache->Add(LayoutKey, std::move(pNewLayout));
+
     // Create pipeline
     if (m_Desc.IsComputePipeline)
     {
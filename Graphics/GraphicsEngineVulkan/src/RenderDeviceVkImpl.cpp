@@ -199,10 +199,31 @@ RenderDeviceVkImpl::RenderDeviceVkImpl(IReferenceCounters*
     SamCaps.BorderSamplingModeSupported   = True;
     SamCaps.AnisotropicFilteringSupported = vkDeviceFeatures.samplerAnisotropy;
     SamCaps.LODBiasSupported              = True;
+
+    m_SPIRVCache.SetDirectory(EngineCI.SPIRVCacheDirectory);
+    if (EngineCI.ResourceLayoutCacheSize != 0)
+    {
+        m_pResourceLayoutCache.reset(new ResourceLayoutCacheVk{EngineCI.ResourceLayoutCacheSize});
+        m_pResourceLayoutCache->SetDirectory(EngineCI.SPIRVCacheDirectory);
+    }
 }
 
 RenderDeviceVkImpl::~RenderDeviceVkImpl()
 {
+    const auto SPIRVCacheStats = m_SPIRVCache.GetStatistics();
+    if (SPIRVCacheStats.GetNumLookups() > 0)
+    {
+        LOG_INFO_MESSAGE("SPIRV cache: ", SPIRVCacheStats.NumMemoryHits, " memory hits, ", SPIRVCacheStats.NumDiskHits, " disk hits, ",
+                         SPIRVCacheStats.NumMisses, " misses (", static_cast<int>(SPIRVCacheStats.GetHitRate() * 100.0 + 0.5), "% hit rate)");
+    }
+
+    const auto LayoutCacheStats = m_pResourceLayoutCache ? m_pResourceLayoutCache->GetStatistics() : ResourceLayoutCacheVk::Statistics{};
+    if (LayoutCacheStats.GetNumLookups() > 0)
+    {
+        LOG_INFO_MESSAGE("Resource layout cache: ", LayoutCacheStats.NumMemoryHits, " memory hits, ", LayoutCacheStats.NumDiskHits, " disk hits, ",
+                         LayoutCacheStats.NumMisses, " misses (", static_cast<int>(LayoutCacheStats.GetHitRate() * 100.0 + 0.5), "% hit rate)");
+    }
+
     // Explicitly destroy dynamic heap. This will move resources owned by
     // the heap into release queues
     m_DynamicMemoryManager.Destroy();
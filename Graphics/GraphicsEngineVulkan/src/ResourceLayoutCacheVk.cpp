@@ -0,0 +1,261 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+
+#include "pch.h"
+
+#include <cstring>
+#include <type_traits>
+
+#include "ResourceLayoutCacheVk.hpp"
+#include "ShaderVkImpl.hpp"
+#include "HashUtils.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Serialized entry starts with the number of shaders. Every shader is described by
+// ShaderDataHeader followed by the resolved resources and the byte code.
+struct ShaderDataHeader
+{
+    Uint32 NumResources = 0;
+    Uint32 NumWords     = 0;
+};
+
+constexpr Uint64 SecondHashSeed = 0x9ae16a3b2f90404full;
+
+template <typename T>
+void HashValue(Uint64 (&Hashes)[2], const T& Value)
+{
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "Only arithmetic types can be hashed");
+    for (auto& Hash : Hashes)
+        Hash = ComputeFNVHash(&Value, sizeof(Value), Hash);
+}
+
+void HashString(Uint64 (&Hashes)[2], const Char* Str)
+{
+    if (Str == nullptr)
+        Str = "";
+
+    // Terminating null symbols are hashed so that, for instance, "ab" + "c" and "a" + "bc" produce different hashes
+    const auto Len = strlen(Str) + 1;
+    for (auto& Hash : Hashes)
+        Hash = ComputeFNVHash(Str, Len, Hash);
+}
+
+template <typename T>
+void AppendData(std::vector<Uint8>& Data, const T* pSrc, size_t Count)
+{
+    const auto* pBytes = reinterpret_cast<const Uint8*>(pSrc);
+    Data.insert(Data.end(), pBytes, pBytes + Count * sizeof(T));
+}
+
+template <typename T>
+bool ReadData(const std::vector<Uint8>& Data, size_t& Offset, T* pDst, size_t Count)
+{
+    const auto Size = Count * sizeof(T);
+    if (Data.size() - Offset < Size)
+        return false;
+    if (Size != 0)
+        memcpy(pDst, Data.data() + Offset, Size);
+    Offset += Size;
+    return true;
+}
+
+} // namespace
+
+size_t ResourceLayoutCacheVkEntry::GetSize(const std::shared_ptr<const Type>& pEntry)
+{
+    size_t Size = sizeof(Type);
+    for (const auto& Shader : *pEntry)
+        Size += sizeof(Shader) + Shader.Resources.size() * sizeof(Shader.Resources[0]) + Shader.SPIRV.size() * sizeof(Shader.SPIRV[0]);
+    return Size;
+}
+
+bool ResourceLayoutCacheVkEntry::Serialize(const std::shared_ptr<const Type>& pEntry, std::vector<Uint8>& Data)
+{
+    const auto NumShaders = static_cast<Uint32>(pEntry->size());
+    AppendData(Data, &NumShaders, 1);
+    for (const auto& Shader : *pEntry)
+    {
+        ShaderDataHeader DataHeader;
+        DataHeader.NumResources = static_cast<Uint32>(Shader.Resources.size());
+        DataHeader.NumWords     = static_cast<Uint32>(Shader.SPIRV.size());
+        AppendData(Data, &DataHeader, 1);
+        AppendData(Data, Shader.Resources.data(), Shader.Resources.size());
+        AppendData(Data, Shader.SPIRV.data(), Shader.SPIRV.size());
+    }
+    return true;
+}
+
+bool ResourceLayoutCacheVkEntry::Deserialize(const std::vector<Uint8>& Data, std::shared_ptr<const Type>& pEntry)
+{
+    size_t Offset     = 0;
+    Uint32 NumShaders = 0;
+    if (!ReadData(Data, Offset, &NumShaders, 1))
+        return false;
+
+    // Every shader occupies at least the size of its header
+    if (NumShaders > (Data.size() - Offset) / sizeof(ShaderDataHeader))
+        return false;
+
+    auto pNewEntry = std::make_shared<Type>(NumShaders);
+    for (auto& Shader : *pNewEntry)
+    {
+        ShaderDataHeader DataHeader;
+        if (!ReadData(Data, Offset, &DataHeader, 1))
+            return false;
+
+        // Check the size before allocating the arrays
+        const auto RemainingSize = Data.size() - Offset;
+        if (DataHeader.NumWords == 0 ||
+            size_t{DataHeader.NumResources} * sizeof(ResolvedResourceAttribs) + size_t{DataHeader.NumWords} * sizeof(uint32_t) > RemainingSize)
+            return false;
+
+        Shader.Resources.resize(DataHeader.NumResources);
+        Shader.SPIRV.resize(DataHeader.NumWords);
+        if (!ReadData(Data, Offset, Shader.Resources.data(), Shader.Resources.size()) ||
+            !ReadData(Data, Offset, Shader.SPIRV.data(), Shader.SPIRV.size()))
+            return false;
+    }
+
+    if (Offset != Data.size())
+        return false;
+
+    pEntry = std::move(pNewEntry);
+    return true;
+}
+
+ResourceLayoutCacheVk::Key ResourceLayoutCacheVk::MakeKey(Uint32                            NumShaders,
+                                                          const ShaderVkImpl* const         ppShaders[],
+                                                          const PipelineResourceLayoutDesc& ResourceLayoutDesc)
+{
+    Uint64 Hashes[2] = {FNVHashSeed, SecondHashSeed};
+
+    for (Uint32 s = 0; s < NumShaders; ++s)
+    {
+        const auto* pShaderVk = ppShaders[s];
+        const auto& SPIRV     = pShaderVk->GetSPIRV();
+        HashValue(Hashes, pShaderVk->GetDesc().ShaderType);
+        HashValue(Hashes, static_cast<Uint64>(SPIRV.size()));
+        for (auto& Hash : Hashes)
+            Hash = ComputeFNVHash(SPIRV.data(), SPIRV.size() * sizeof(uint32_t), Hash);
+        HashString(Hashes, pShaderVk->GetShaderResources()->GetCombinedSamplerSuffix());
+    }
+
+    HashValue(Hashes, ResourceLayoutDesc.DefaultVariableType);
+
+    HashValue(Hashes, ResourceLayoutDesc.NumVariables);
+    for (Uint32 v = 0; v < ResourceLayoutDesc.NumVariables; ++v)
+    {
+        const auto& Var = ResourceLayoutDesc.Variables[v];
+        HashValue(Hashes, Var.ShaderStages);
+        HashValue(Hashes, Var.Type);
+        HashString(Hashes, Var.Name);
+    }
+
+    // Only the stages and names affect the layout. Sampler objects are created
+    // from the descriptions every time the pipeline state is initialized.
+    HashValue(Hashes, ResourceLayoutDesc.NumStaticSamplers);
+    for (Uint32 s = 0; s < ResourceLayoutDesc.NumStaticSamplers; ++s)
+    {
+        const auto& StSam = ResourceLayoutDesc.StaticSamplers[s];
+        HashValue(Hashes, StSam.ShaderStages);
+        HashString(Hashes, StSam.SamplerOrTextureName);
+    }
+
+    Key K;
+    K.Hash0      = Hashes[0];
+    K.Hash1      = Hashes[1];
+    K.NumShaders = NumShaders;
+    return K;
+}
+
+bool ResourceLayoutCacheVk::IsConsistent(const EntryType&                  Entry,
+                                         const ShaderVkImpl* const         ppShaders[],
+                                         const PipelineResourceLayoutDesc& ResourceLayoutDesc)
+{
+    for (size_t s = 0; s < Entry.size(); ++s)
+    {
+        const auto& Data       = Entry[s];
+        const auto& Resources  = *ppShaders[s]->GetShaderResources();
+        const auto  ShaderType = Resources.GetShaderType();
+        if (Data.SPIRV.empty() || Data.Resources.size() != Resources.GetTotalResources())
+            return false;
+
+        for (Uint32 r = 0; r < Resources.GetTotalResources(); ++r)
+        {
+            const auto& Resolved = Data.Resources[r];
+            if (Resolved.VarType >= SHADER_RESOURCE_VARIABLE_TYPE_NUM_TYPES)
+                return false;
+
+            if (Resolved.ImmutableSamplerInd >= 0)
+            {
+                const auto& Attribs = Resources.GetResource(r);
+                if (Attribs.Type != SPIRVShaderResourceAttribs::ResourceType::SampledImage &&
+                    Attribs.Type != SPIRVShaderResourceAttribs::ResourceType::SeparateSampler)
+                    return false;
+
+                if (static_cast<Uint32>(Resolved.ImmutableSamplerInd) >= ResourceLayoutDesc.NumStaticSamplers ||
+                    (ResourceLayoutDesc.StaticSamplers[Resolved.ImmutableSamplerInd].ShaderStages & ShaderType) == 0)
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+ResourceLayoutCacheVk::ResourceLayoutCacheVk(size_t MaxMemorySize) :
+    // The file version must be incremented whenever the serialized entry layout
+    // or the way the resource layout is resolved changes.
+    TBase{0x4C524B56 /*'VKRL'*/, 2, "vkrl", "resource layout cache", MaxMemorySize}
+{
+}
+
+std::shared_ptr<const ResourceLayoutCacheVk::EntryType> ResourceLayoutCacheVk::Find(const Key&                        K,
+                                                                                    const ShaderVkImpl* const         ppShaders[],
+                                                                                    const PipelineResourceLayoutDesc& ResourceLayoutDesc)
+{
+    std::shared_ptr<const EntryType> pEntry;
+    if (!TBase::Find(K, pEntry))
+        return nullptr;
+
+    if (pEntry->size() != K.NumShaders || !IsConsistent(*pEntry, ppShaders, ResourceLayoutDesc))
+    {
+        LOG_WARNING_MESSAGE("Resource layout cache entry is not consistent with the pipeline. This may indicate a hash collision or a damaged cache file.");
+        return nullptr;
+    }
+
+    return pEntry;
+}
+
+} // namespace Diligent
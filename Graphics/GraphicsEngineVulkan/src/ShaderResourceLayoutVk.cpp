@@ -93,6 +93,30 @@ static SHADER_RESOURCE_VARIABLE_TYPE FindShaderVariableType(SHADER_TYPE
     }
 }
 
+void ShaderResourceLayoutVk::ResolveResources(const SPIRVShaderResources&       Resources,
+                                              const PipelineResourceLayoutDesc& ResourceLayoutDesc,
+                                              ResolvedResourceAttribs           Resolved[])
+{
+    VERIFY(ResourceLayoutDesc.NumStaticSamplers <= Uint32{std::numeric_limits<Int16>::max()}, "The number of static samplers exceeds Int16 maximum representable value");
+
+    const auto  ShaderType            = Resources.GetShaderType();
+    const auto* CombinedSamplerSuffix = Resources.GetCombinedSamplerSuffix();
+    Resources.ProcessResources(
+        [&](const SPIRVShaderResourceAttribs& Attribs, Uint32 n) //
+        {
+            auto& Res   = Resolved[n];
+            Res.VarType = static_cast<Uint8>(FindShaderVariableType(ShaderType, Attribs, ResourceLayoutDesc, CombinedSamplerSuffix));
+
+            Res.ImmutableSamplerInd = -1;
+            if (Attribs.Type == SPIRVShaderResourceAttribs::ResourceType::SampledImage ||
+                Attribs.Type == SPIRVShaderResourceAttribs::ResourceType::SeparateSampler)
+            {
+                // Only search for the immutable sampler for combined image samplers and separate samplers
+                Res.ImmutableSamplerInd = static_cast<Int16>(FindImmutableSampler(ShaderType, ResourceLayoutDesc, Attribs, CombinedSamplerSuffix));
+            }
+        } //
+    );
+}
 
 ShaderResourceLayoutVk::~ShaderResourceLayoutVk()
 {
@@ -106,6 +130,7 @@ ShaderResourceLayoutVk::~ShaderResourceLayoutVk()
 void ShaderResourceLayoutVk::AllocateMemory(std::shared_ptr<const SPIRVShaderResources> pSrcResources,
                                             IMemoryAllocator&                           Allocator,
                                             const PipelineResourceLayoutDesc&           ResourceLayoutDesc,
+                                            const ResolvedResourceAttribs               ResolvedResources[],
                                             const SHADER_RESOURCE_VARIABLE_TYPE*        AllowedVarTypes,
                                             Uint32                                      NumAllowedTypes,
                                             bool                                        AllocateImmutableSamplers)
@@ -116,14 +141,13 @@ void ShaderResourceLayoutVk::AllocateMemory(std::shared_ptr<const SPIRVShaderRes
 
     m_pResources = std::move(pSrcResources);
 
-    const Uint32 AllowedTypeBits       = GetAllowedTypeBits(AllowedVarTypes, NumAllowedTypes);
-    const auto   ShaderType            = m_pResources->GetShaderType();
-    const auto*  CombinedSamplerSuffix = m_pResources->GetCombinedSamplerSuffix();
+    const Uint32 AllowedTypeBits = GetAllowedTypeBits(AllowedVarTypes, NumAllowedTypes);
+    const auto   ShaderType      = m_pResources->GetShaderType();
     // Count the number of resources to allocate all needed memory
     m_pResources->ProcessResources(
-        [&](const SPIRVShaderResourceAttribs& ResAttribs, Uint32) //
+        [&](const SPIRVShaderResourceAttribs&, Uint32 n) //
         {
-            auto VarType = FindShaderVariableType(ShaderType, ResAttribs, ResourceLayoutDesc, CombinedSamplerSuffix);
+            auto VarType = static_cast<SHADER_RESOURCE_VARIABLE_TYPE>(ResolvedResources[n].VarType);
             if (IsAllowedType(VarType, AllowedTypeBits))
             {
                 // For immutable separate samplers we still allocate VkResource instances, but they are never exposed to the app
@@ -172,37 +196,31 @@ void ShaderResourceLayoutVk::AllocateMemory(std::shared_ptr<const SPIRVShaderRes
 void ShaderResourceLayoutVk::InitializeStaticResourceLayout(std::shared_ptr<const SPIRVShaderResources> pSrcResources,
                                                             IMemoryAllocator&                           LayoutDataAllocator,
                                                             const PipelineResourceLayoutDesc&           ResourceLayoutDesc,
+                                                            const ResolvedResourceAttribs               ResolvedResources[],
                                                             ShaderResourceCacheVk&                      StaticResourceCache)
 {
     const auto AllowedVarType = SHADER_RESOURCE_VARIABLE_TYPE_STATIC;
     // We do not need immutable samplers in static shader resource layout as they
     // are relevant only when the main layout is initialized
     constexpr bool AllocateImmutableSamplers = false;
-    AllocateMemory(std::move(pSrcResources), LayoutDataAllocator, ResourceLayoutDesc, &AllowedVarType, 1, AllocateImmutableSamplers);
+    AllocateMemory(std::move(pSrcResources), LayoutDataAllocator, ResourceLayoutDesc, ResolvedResources, &AllowedVarType, 1, AllocateImmutableSamplers);
 
     std::array<Uint32, SHADER_RESOURCE_VARIABLE_TYPE_NUM_TYPES> CurrResInd = {};
 
     Uint32 StaticResCacheSize = 0;
 
-    const Uint32 AllowedTypeBits       = GetAllowedTypeBits(&AllowedVarType, 1);
-    const auto   ShaderType            = m_pResources->GetShaderType();
-    const auto*  CombinedSamplerSuffix = m_pResources->GetCombinedSamplerSuffix();
+    const Uint32 AllowedTypeBits = GetAllowedTypeBits(&AllowedVarType, 1);
 
     m_pResources->ProcessResources(
-        [&](const SPIRVShaderResourceAttribs& Attribs, Uint32) //
+        [&](const SPIRVShaderResourceAttribs& Attribs, Uint32 n) //
         {
-            auto VarType = FindShaderVariableType(ShaderType, Attribs, ResourceLayoutDesc, CombinedSamplerSuffix);
+            const auto& Resolved = ResolvedResources[n];
+            auto        VarType  = static_cast<SHADER_RESOURCE_VARIABLE_TYPE>(Resolved.VarType);
             if (!IsAllowedType(VarType, AllowedTypeBits))
                 return;
 
-            Int32 SrcImmutableSamplerInd = -1;
-            if (Attribs.Type == SPIRVShaderResourceAttribs::ResourceType::SampledImage ||
-                Attribs.Type == SPIRVShaderResourceAttribs::ResourceType::SeparateSampler)
-            {
-                // Only search for the immutable sampler for combined image samplers and separate samplers
-                SrcImmutableSamplerInd = FindImmutableSampler(ShaderType, ResourceLayoutDesc, Attribs, CombinedSamplerSuffix);
-                // For immutable separate samplers we allocate VkResource instances, but they are never exposed to the app
-            }
+            // For immutable separate samplers we allocate VkResource instances, but they are never exposed to the app
+            const Int32 SrcImmutableSamplerInd = Resolved.ImmutableSamplerInd;
 
             Uint32 Binding       = Attribs.Type;
             Uint32 DescriptorSet = 0;
@@ -369,6 +387,7 @@ void ShaderResourceLayoutVk::Initialize(IRenderDevice*
                                         std::shared_ptr<const SPIRVShaderResources> pShaderResources[],
                                         IMemoryAllocator&                           LayoutDataAllocator,
                                         const PipelineResourceLayoutDesc&           ResourceLayoutDesc,
+                                        const ResolvedResourceAttribs* const        ResolvedResources[],
                                         std::vector<uint32_t>                       SPIRVs[],
                                         class PipelineLayout&                       PipelineLayout,
                                         bool                                        VerifyVariables,
@@ -385,7 +404,7 @@ void ShaderResourceLayoutVk::Initialize(IRenderDevice*
     for (Uint32 s = 0; s < NumShaders; ++s)
     {
         constexpr bool AllocateImmutableSamplers = true;
-        Layouts[s].AllocateMemory(std::move(pShaderResources[s]), LayoutDataAllocator, ResourceLayoutDesc, AllowedVarTypes, NumAllowedTypes, AllocateImmutableSamplers);
+        Layouts[s].AllocateMemory(std::move(pShaderResources[s]), LayoutDataAllocator, ResourceLayoutDesc, ResolvedResources[s], AllowedVarTypes, NumAllowedTypes, AllocateImmutableSamplers);
     }
 
     VERIFY_EXPR(NumShaders <= MAX_SHADERS_IN_PIPELINE);
@@ -400,8 +419,8 @@ void ShaderResourceLayoutVk::Initialize(IRenderDevice*
                            const SPIRVShaderResources&       Resources,
                            const SPIRVShaderResourceAttribs& Attribs) //
     {
-        const auto                          ShaderType = Resources.GetShaderType();
-        const SHADER_RESOURCE_VARIABLE_TYPE VarType    = FindShaderVariableType(ShaderType, Attribs, ResourceLayoutDesc, Resources.GetCombinedSamplerSuffix());
+        const auto&                         Resolved = ResolvedResources[ShaderInd][Resources.GetResourceIndex(Attribs)];
+        const SHADER_RESOURCE_VARIABLE_TYPE VarType  = static_cast<SHADER_RESOURCE_VARIABLE_TYPE>(Resolved.VarType);
         if (!IsAllowedType(VarType, AllowedTypeBits))
             return;
 
@@ -418,23 +437,19 @@ void ShaderResourceLayoutVk::Initialize(IRenderDevice*
         }
 
         VkSampler vkImmutableSampler = VK_NULL_HANDLE;
-        if (Attribs.Type == SPIRVShaderResourceAttribs::ResourceType::SampledImage ||
-            Attribs.Type == SPIRVShaderResourceAttribs::ResourceType::SeparateSampler)
+        if (Resolved.ImmutableSamplerInd >= 0)
         {
-            // Only search for the immutable sampler for combined image samplers and separate samplers
-            Int32 SrcImmutableSamplerInd = FindImmutableSampler(ShaderType, ResourceLayoutDesc, Attribs, Resources.GetCombinedSamplerSuffix());
-            if (SrcImmutableSamplerInd >= 0)
-            {
-                auto& ImmutableSampler = ResLayout.GetImmutableSampler(CurrImmutableSamplerInd[ShaderInd]++);
-                VERIFY(!ImmutableSampler, "Immutable sampler has already been initialized!");
-                const auto& ImmutableSamplerDesc = ResourceLayoutDesc.StaticSamplers[SrcImmutableSamplerInd].Desc;
-                pRenderDevice->CreateSampler(ImmutableSamplerDesc, &ImmutableSampler);
-                vkImmutableSampler = ImmutableSampler.RawPtr<SamplerVkImpl>()->GetVkSampler();
-            }
+            VERIFY_EXPR(Attribs.Type == SPIRVShaderResourceAttribs::ResourceType::SampledImage ||
+                        Attribs.Type == SPIRVShaderResourceAttribs::ResourceType::SeparateSampler);
+            auto& ImmutableSampler = ResLayout.GetImmutableSampler(CurrImmutableSamplerInd[ShaderInd]++);
+            VERIFY(!ImmutableSampler, "Immutable sampler has already been initialized!");
+            const auto& ImmutableSamplerDesc = ResourceLayoutDesc.StaticSamplers[Resolved.ImmutableSamplerInd].Desc;
+            pRenderDevice->CreateSampler(ImmutableSamplerDesc, &ImmutableSampler);
+            vkImmutableSampler = ImmutableSampler.RawPtr<SamplerVkImpl>()->GetVkSampler();
         }
 
-        auto& ShaderSPIRV = SPIRVs[ShaderInd];
-        PipelineLayout.AllocateResourceSlot(Attribs, VarType, vkImmutableSampler, Resources.GetShaderType(), DescriptorSet, Binding, CacheOffset, ShaderSPIRV);
+        auto* pShaderSPIRV = SPIRVs != nullptr ? &SPIRVs[ShaderInd] : nullptr;
+        PipelineLayout.AllocateResourceSlot(Attribs, VarType, vkImmutableSampler, Resources.GetShaderType(), DescriptorSet, Binding, CacheOffset, pShaderSPIRV);
         VERIFY(DescriptorSet <= std::numeric_limits<decltype(VkResource::DescriptorSet)>::max(), "Descriptor set (", DescriptorSet, ") excceeds maximum representable value");
         VERIFY(Binding <= std::numeric_limits<decltype(VkResource::Binding)>::max(), "Binding (", Binding, ") excceeds maximum representable value");
 
@@ -460,12 +475,7 @@ void ShaderResourceLayoutVk::Initialize(IRenderDevice*
         const auto& Resources = *Layout.m_pResources;
         for (Uint32 n = 0; n < Resources.GetNumUBs(); ++n)
         {
-            const auto& UB      = Resources.GetUB(n);
-            auto        VarType = GetShaderVariableType(Resources.GetShaderType(), UB.Name, ResourceLayoutDesc);
-            if (IsAllowedType(VarType, AllowedTypeBits))
-            {
-                AddResource(s, Layout, Resources, UB);
-            }
+            AddResource(s, Layout, Resources, Resources.GetUB(n));
         }
     }
 
@@ -476,12 +486,7 @@ void ShaderResourceLayoutVk::Initialize(IRenderDevice*
         const auto& Resources = *Layout.m_pResources;
         for (Uint32 n = 0; n < Resources.GetNumSBs(); ++n)
         {
-            const auto& SB      = Resources.GetSB(n);
-            auto        VarType = GetShaderVariableType(Resources.GetShaderType(), SB.Name, ResourceLayoutDesc);
-            if (IsAllowedType(VarType, AllowedTypeBits))
-            {
-                AddResource(s, Layout, Resources, SB);
-            }
+            AddResource(s, Layout, Resources, Resources.GetSB(n));
         }
     }
 
@@ -33,6 +33,7 @@
 #include "RenderDeviceVkImpl.hpp"
 #include "DataBlobImpl.hpp"
 #include "GLSLSourceBuilder.hpp"
+#include "ShaderArchive.hpp"
 
 #if !DILIGENT_NO_GLSLANG
 #    include "SPIRVUtils.hpp"
@@ -53,7 +54,22 @@ ShaderVkImpl::ShaderVkImpl(IReferenceCounters*     pRefCounters,
     }
 // clang-format on
 {
-    if (CreationAttribs.Source != nullptr || CreationAttribs.FilePath != nullptr)
+    if (CreationAttribs.pShaderArchive != nullptr)
+    {
+        DEV_CHECK_ERR(CreationAttribs.Source == nullptr, "'Source' must be null when shader is loaded from an archive");
+        DEV_CHECK_ERR(CreationAttribs.ByteCode == nullptr, "'ByteCode' must be null when shader is loaded from an archive");
+
+        ShaderArchiveReader             Archive{CreationAttribs.pShaderArchive->GetDataPtr(), CreationAttribs.pShaderArchive->GetSize()};
+        ShaderArchiveReader::ShaderData ShaderData;
+        if (!Archive.FindShader(CreationAttribs, ShaderData) || ShaderData.pSPIRV == nullptr)
+        {
+            LOG_ERROR_AND_THROW("Shader archive does not contain SPIRV byte code for shader '", (m_Desc.Name != nullptr ? m_Desc.Name : ""), "'");
+        }
+        VERIFY(ShaderData.SPIRVSize % 4 == 0, "Byte code size (", ShaderData.SPIRVSize, ") is not multiple of 4");
+        m_SPIRV.resize(ShaderData.SPIRVSize / 4);
+        memcpy(m_SPIRV.data(), ShaderData.pSPIRV, ShaderData.SPIRVSize);
+    }
+    else if (CreationAttribs.Source != nullptr || CreationAttribs.FilePath != nullptr)
     {
 #if DILIGENT_NO_GLSLANG
         LOG_ERROR_AND_THROW("Diligent engine was not linked with glslang and can only consume compiled SPIRV bytecode.");
@@ -67,7 +83,7 @@ ShaderVkImpl::ShaderVkImpl(IReferenceCounters*     pRefCounters,
             "#endif\n";
         if (CreationAttribs.SourceLanguage == SHADER_SOURCE_LANGUAGE_HLSL)
         {
-            m_SPIRV = HLSLtoSPIRV(CreationAttribs, VulkanDefine, CreationAttribs.ppCompilerOutput);
+            m_SPIRV = HLSLtoSPIRV(CreationAttribs, VulkanDefine, CreationAttribs.ppCompilerOutput, &pRenderDeviceVk->GetSPIRVCache());
         }
         else
         {
@@ -77,7 +93,8 @@ ShaderVkImpl::ShaderVkImpl(IReferenceCounters*     pRefCounters,
 
             m_SPIRV = GLSLtoSPIRV(m_Desc.ShaderType, GLSLSource.c_str(),
                                   static_cast<int>(GLSLSource.length()),
-                                  CreationAttribs.ppCompilerOutput);
+                                  CreationAttribs.ppCompilerOutput,
+                                  &pRenderDeviceVk->GetSPIRVCache());
         }
 
         if (m_SPIRV.empty())
@@ -101,7 +118,9 @@ ShaderVkImpl::ShaderVkImpl(IReferenceCounters*     pRefCounters,
     // We cannot create shader module here because resource bindings are assigned when
     // pipeline state is created
 
-    // Load shader resources
+    // Load shader resources. Reflection is required even if the resource layout of every pipeline
+    // that uses the shader is found in ResourceLayoutCacheVk: shader resource layouts reference the
+    // resource attributes, and vertex shader inputs are mapped here.
     auto& Allocator        = GetRawAllocator();
     auto* pRawMem          = ALLOCATE(Allocator, "Allocator for ShaderResources", SPIRVShaderResources, 1);
     auto  LoadShaderInputs = m_Desc.ShaderType == SHADER_TYPE_VERTEX;
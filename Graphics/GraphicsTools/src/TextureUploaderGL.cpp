@@ -30,6 +30,7 @@
 #include <deque>
 #include <unordered_map>
 #include <vector>
+#include <atomic>
 #include <algorithm>
 
 #include "TextureUploaderGL.hpp"
@@ -37,6 +38,30 @@
 #include "GraphicsAccessories.hpp"
 #include "Align.hpp"
 
+#if PLATFORM_WIN32 || PLATFORM_LINUX || PLATFORM_MACOS
+
+#    ifndef GLEW_STATIC
+#        define GLEW_STATIC // Must be defined to use static version of glew
+#    endif
+#    ifndef GLEW_NO_GLU
+#        define GLEW_NO_GLU
+#    endif
+#    include "GL/glew.h"
+
+#elif PLATFORM_ANDROID
+
+#    include <GLES3/gl3.h>
+
+#elif PLATFORM_IOS
+
+#    include <OpenGLES/ES3/gl.h>
+
+#else
+#    error Unsupported platform
+#endif
+
+#include "BufferGL.h"
+
 namespace Diligent
 {
 
@@ -88,8 +113,9 @@ public:
         m_BufferMappedSignal.Trigger();
     }
 
-    void SignalCopyScheduled()
+    void SignalCopyScheduled(Uint64 FenceValue)
     {
+        m_CopyScheduledFenceValue = FenceValue;
         m_CopyScheduledSignal.Trigger();
     }
 
@@ -121,6 +147,7 @@ public:
     {
         m_BufferMappedSignal.Reset();
         m_CopyScheduledSignal.Reset();
+        m_CopyScheduledFenceValue = 0;
         UploadBufferBase::Reset();
     }
 
@@ -129,6 +156,19 @@ public:
         return m_SubresourceOffsets.back();
     }
 
+    Uint64 GetCopyScheduledFenceValue() const
+    {
+        VERIFY(m_CopyScheduledFenceValue != 0, "Fence value has not been initialized");
+        return m_CopyScheduledFenceValue;
+    }
+
+    // Returns the pointer to the persistently mapped staging buffer memory, or null
+    // if the staging buffer has not been created yet or is not persistently mapped.
+    Uint8* GetPersistentMappedData() const
+    {
+        return m_pPersistentMappedData;
+    }
+
 private:
     Uint32 GetStride(Uint32 Mip, Uint32 Slice)
     {
@@ -140,8 +180,10 @@ private:
     ThreadingTools::Signal m_BufferMappedSignal;
     ThreadingTools::Signal m_CopyScheduledSignal;
     RefCntAutoPtr<IBuffer> m_pStagingBuffer;
+    Uint8*                 m_pPersistentMappedData = nullptr;
     std::vector<Uint32>    m_SubresourceOffsets;
     std::vector<Uint32>    m_SubresourceStrides;
+    Uint64                 m_CopyScheduledFenceValue = 0;
 };
 
 } // namespace
@@ -149,6 +191,13 @@ private:
 
 struct TextureUploaderGL::InternalData
 {
+    InternalData(IRenderDevice* pDevice)
+    {
+        FenceDesc fenceDesc;
+        fenceDesc.Name = "Texture uploader sync fence";
+        pDevice->CreateFence(fenceDesc, &m_pFence);
+    }
+
     void SwapMapQueues()
     {
         std::lock_guard<std::mutex> QueueLock(m_PendingOperationsMtx);
@@ -167,6 +216,53 @@ struct TextureUploaderGL::InternalData
         m_PendingOperations.emplace_back(PendingBufferOperation::Operation::Map, pUploadBuffer);
     }
 
+    Uint64 SignalFence(IDeviceContext* pContext)
+    {
+        // Fences can't be accessed from multiple threads simultaneously even
+        // when protected by mutex
+        auto FenceValue = m_NextFenceValue++;
+        pContext->SignalFence(m_pFence, FenceValue);
+        return FenceValue;
+    }
+
+    void UpdatedCompletedFenceValue()
+    {
+        // Fences can't be accessed from multiple threads simultaneously even
+        // when protected by mutex
+        m_CompletedFenceValue.store(m_pFence->GetCompletedValue());
+    }
+
+    // Upload buffers are recycled in FIFO order, so that the staging buffers form a ring per
+    // buffer description. A buffer is only reused after the GPU has finished reading from it.
+    RefCntAutoPtr<UploadBufferGL> FindCachedUploadBuffer(const UploadBufferDesc& Desc)
+    {
+        RefCntAutoPtr<UploadBufferGL> pUploadBuffer;
+        std::lock_guard<std::mutex>   CacheLock(m_UploadBuffCacheMtx);
+        auto                          DequeIt = m_UploadBufferCache.find(Desc);
+        if (DequeIt != m_UploadBufferCache.end())
+        {
+            auto& Deque = DequeIt->second;
+            if (!Deque.empty())
+            {
+                auto& FrontBuff = Deque.front();
+                if (FrontBuff->GetCopyScheduledFenceValue() <= m_CompletedFenceValue.load())
+                {
+                    pUploadBuffer = std::move(FrontBuff);
+                    Deque.pop_front();
+                    pUploadBuffer->Reset();
+                }
+            }
+        }
+
+        return pUploadBuffer;
+    }
+
+    void RecycleUploadBuffer(UploadBufferGL* pUploadBuffer)
+    {
+        std::lock_guard<std::mutex> CacheLock(m_UploadBuffCacheMtx);
+        auto&                       Deque = m_UploadBufferCache[pUploadBuffer->GetDesc()];
+        Deque.emplace_back(pUploadBuffer);
+    }
 
     struct PendingBufferOperation
     {
@@ -205,11 +301,15 @@ struct TextureUploaderGL::InternalData
 
     std::mutex                                                                      m_UploadBuffCacheMtx;
     std::unordered_map<UploadBufferDesc, std::deque<RefCntAutoPtr<UploadBufferGL>>> m_UploadBufferCache;
+
+    RefCntAutoPtr<IFence> m_pFence;
+    Uint64                m_NextFenceValue = 1;
+    std::atomic<Uint64>   m_CompletedFenceValue{0};
 };
 
 TextureUploaderGL::TextureUploaderGL(IReferenceCounters* pRefCounters, IRenderDevice* pDevice, const TextureUploaderDesc Desc) :
     TextureUploaderBase{pRefCounters, pDevice, Desc},
-    m_pInternalData{new InternalData{}}
+    m_pInternalData{new InternalData{pDevice}}
 {
 }
 
@@ -239,14 +339,35 @@ TextureUploaderGL::~TextureUploaderGL()
 void TextureUploaderGL::RenderThreadUpdate(IDeviceContext* pContext)
 {
     m_pInternalData->SwapMapQueues();
-    if (!m_pInternalData->m_InWorkOperations.empty())
+    auto& InWorkOperations = m_pInternalData->m_InWorkOperations;
+    if (!InWorkOperations.empty())
     {
-        for (auto& OperationInfo : m_pInternalData->m_InWorkOperations)
+        Uint32 NumCopyOperations = 0;
+        for (auto& OperationInfo : InWorkOperations)
         {
             m_pInternalData->Execute(m_pDevice, pContext, OperationInfo);
+            if (OperationInfo.operation == InternalData::PendingBufferOperation::Copy)
+                ++NumCopyOperations;
+        }
+
+        if (NumCopyOperations > 0)
+        {
+            // The buffer may be recycled immediately after the copy scheduled is signaled,
+            // so we must signal the fence first.
+            auto SignaledFenceValue = m_pInternalData->SignalFence(pContext);
+
+            for (auto& OperationInfo : InWorkOperations)
+            {
+                if (OperationInfo.operation == InternalData::PendingBufferOperation::Copy)
+                    OperationInfo.pUploadBuffer->SignalCopyScheduled(SignaledFenceValue);
+            }
         }
-        m_pInternalData->m_InWorkOperations.clear();
+
+        InWorkOperations.clear();
     }
+
+    // This must be called by the same thread that signals the fence
+    m_pInternalData->UpdatedCompletedFenceValue();
 }
 
 void TextureUploaderGL::InternalData::Execute(IRenderDevice*          pDevice,
@@ -267,13 +388,25 @@ void TextureUploaderGL::InternalData::Execute(IRenderDevice*          pDevice,
                 BuffDesc.CPUAccessFlags = CPU_ACCESS_WRITE;
                 BuffDesc.Usage          = USAGE_STAGING;
                 BuffDesc.uiSizeInBytes  = pBuffer->GetTotalSize();
-                RefCntAutoPtr<IBuffer> pStagingBuffer;
                 pDevice->CreateBuffer(BuffDesc, nullptr, &pBuffer->m_pStagingBuffer);
+
+                // When immutable buffer storage is supported, staging buffers are persistently
+                // mapped, and the buffer never needs to be mapped or unmapped again.
+                RefCntAutoPtr<IBufferGL> pStagingBufferGL{pBuffer->m_pStagingBuffer, IID_BufferGL};
+                if (pStagingBufferGL)
+                    pBuffer->m_pPersistentMappedData = reinterpret_cast<Uint8*>(pStagingBufferGL->GetPersistentMappedData());
             }
 
-            PVoid CpuAddress = nullptr;
-            pContext->MapBuffer(pBuffer->m_pStagingBuffer, MAP_WRITE, MAP_FLAG_DISCARD, CpuAddress);
-            pBuffer->SetDataPtr(reinterpret_cast<Uint8*>(CpuAddress));
+            if (pBuffer->m_pPersistentMappedData != nullptr)
+            {
+                pBuffer->SetDataPtr(pBuffer->m_pPersistentMappedData);
+            }
+            else
+            {
+                PVoid CpuAddress = nullptr;
+                pContext->MapBuffer(pBuffer->m_pStagingBuffer, MAP_WRITE, MAP_FLAG_DISCARD, CpuAddress);
+                pBuffer->SetDataPtr(reinterpret_cast<Uint8*>(CpuAddress));
+            }
 
             pBuffer->SignalMapped();
         }
@@ -282,13 +415,16 @@ void TextureUploaderGL::InternalData::Execute(IRenderDevice*          pDevice,
         case InternalData::PendingBufferOperation::Copy:
         {
             const auto& TexDesc = OperationInfo.pDstTexture->GetDesc();
-            pContext->UnmapBuffer(pBuffer->m_pStagingBuffer, MAP_WRITE);
+            if (pBuffer->m_pPersistentMappedData == nullptr)
+                pContext->UnmapBuffer(pBuffer->m_pStagingBuffer, MAP_WRITE);
             for (Uint32 Slice = 0; Slice < UploadBuffDesc.ArraySize; ++Slice)
             {
                 for (Uint32 Mip = 0; Mip < UploadBuffDesc.MipLevels; ++Mip)
                 {
+                    // The row pitch of the staging data is the 4-byte aligned row size rather than the tightly
+                    // packed one. UpdateTexture() converts the stride to GL_UNPACK_ROW_LENGTH.
                     auto SrcOffset = pBuffer->GetOffset(Mip, Slice);
-                    auto SrcStride = pBuffer->GetMappedData(Mip, Slice).Stride;
+                    auto SrcStride = pBuffer->GetStride(Mip, Slice);
 
                     TextureSubResData SubResData(pBuffer->m_pStagingBuffer, SrcOffset, SrcStride);
 
@@ -300,7 +436,6 @@ void TextureUploaderGL::InternalData::Execute(IRenderDevice*          pDevice,
                                             SubResData, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
                 }
             }
-            pBuffer->SignalCopyScheduled();
         }
         break;
     }
@@ -311,25 +446,8 @@ void TextureUploaderGL::AllocateUploadBuffer(IDeviceContext*         pContext,
                                              IUploadBuffer**         ppBuffer)
 {
     *ppBuffer = nullptr;
-    RefCntAutoPtr<UploadBufferGL> pUploadBuffer;
 
-    {
-        std::lock_guard<std::mutex> CacheLock(m_pInternalData->m_UploadBuffCacheMtx);
-        auto&                       Cache = m_pInternalData->m_UploadBufferCache;
-        if (!Cache.empty())
-        {
-            auto DequeIt = Cache.find(Desc);
-            if (DequeIt != Cache.end())
-            {
-                auto& Deque = DequeIt->second;
-                if (!Deque.empty())
-                {
-                    pUploadBuffer.Attach(Deque.front().Detach());
-                    Deque.pop_front();
-                }
-            }
-        }
-    }
+    RefCntAutoPtr<UploadBufferGL> pUploadBuffer = m_pInternalData->FindCachedUploadBuffer(Desc);
 
     if (!pUploadBuffer)
     {
@@ -339,7 +457,14 @@ void TextureUploaderGL::AllocateUploadBuffer(IDeviceContext*         pContext,
                          m_pDevice->GetTextureFormatInfo(Desc.Format).Name, " texture");
     }
 
-    if (pContext != nullptr)
+    if (auto* pPersistentData = pUploadBuffer->GetPersistentMappedData())
+    {
+        // The staging buffer is persistently mapped and the GPU has finished reading from it,
+        // so any thread can write to it directly without a round trip to the render thread.
+        pUploadBuffer->SetDataPtr(pPersistentData);
+        pUploadBuffer->SignalMapped();
+    }
+    else if (pContext != nullptr)
     {
         // Render thread
         InternalData::PendingBufferOperation MapOp{InternalData::PendingBufferOperation::Operation::Map, pUploadBuffer};
@@ -373,6 +498,13 @@ void TextureUploaderGL::ScheduleGPUCopy(IDeviceContext* pContext,
                 MipLevel //
             };
         m_pInternalData->Execute(m_pDevice, pContext, CopyOp);
+
+        // The buffer may be recycled immediately after the copy scheduled is signaled,
+        // so we must signal the fence first.
+        auto SignaledFenceValue = m_pInternalData->SignalFence(pContext);
+        pUploadBufferGL->SignalCopyScheduled(SignaledFenceValue);
+        // This must be called by the same thread that signals the fence
+        m_pInternalData->UpdatedCompletedFenceValue();
     }
     else
     {
@@ -385,13 +517,8 @@ void TextureUploaderGL::RecycleBuffer(IUploadBuffer* pUploadBuffer)
 {
     auto* pUploadBufferGL = ValidatedCast<UploadBufferGL>(pUploadBuffer);
     VERIFY(pUploadBufferGL->DbgIsCopyScheduled(), "Upload buffer must be recycled only after copy operation has been scheduled on the GPU");
-    pUploadBufferGL->Reset();
-
-    std::lock_guard<std::mutex> CacheLock(m_pInternalData->m_UploadBuffCacheMtx);
 
-    auto& Cache = m_pInternalData->m_UploadBufferCache;
-    auto& Deque = Cache[pUploadBufferGL->GetDesc()];
-    Deque.emplace_back(pUploadBufferGL);
+    m_pInternalData->RecycleUploadBuffer(pUploadBufferGL);
 }
 
 TextureUploaderStats TextureUploaderGL::GetStats()
@@ -0,0 +1,103 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <initializer_list>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Selects the GLSL definitions that are referenced by a shader.
+
+/// The definitions (see GLSLDefinitions.h) are split into top-level items: macros, functions,
+/// declarations and conditional directives. Every macro and function item records the items it
+/// references. When the definitions for a shader are requested, the items referenced by the
+/// shader source are selected together with all items they depend on, and only the selected items
+/// are emitted in their original order. Conditional directives are preserved; conditional blocks
+/// that contain no selected items are removed. Declarations that are not macros or functions
+/// (such as gl_PerVertex redeclarations) are always emitted.
+class GLSLDefinitionsFilter
+{
+public:
+    explicit GLSLDefinitionsFilter(const Char* Definitions);
+
+    // clang-format off
+    GLSLDefinitionsFilter             (const GLSLDefinitionsFilter&)  = delete;
+    GLSLDefinitionsFilter             (      GLSLDefinitionsFilter&&) = delete;
+    GLSLDefinitionsFilter& operator = (const GLSLDefinitionsFilter&)  = delete;
+    GLSLDefinitionsFilter& operator = (      GLSLDefinitionsFilter&&) = delete;
+    // clang-format on
+
+    /// Returns the definitions referenced by the sources.
+
+    /// If any of the sources uses the token-pasting operator (##), names referenced by the source
+    /// can't be determined reliably, and all definitions are returned.
+    String Filter(std::initializer_list<const String*> Sources) const;
+
+    size_t GetNumItems() const { return m_Items.size(); }
+
+private:
+    enum class ItemType
+    {
+        Declaration, // Always emitted
+        Definition,  // Macro or function definition, emitted when referenced
+        If,          // #if, #ifdef, #ifndef
+        Else,        // #else, #elif
+        EndIf        // #endif
+    };
+
+    struct Item
+    {
+        ItemType Type = ItemType::Declaration;
+        String   Text;
+
+        // Name defined by the macro or the function
+        String Name;
+
+        // Indices of the definitions referenced by this item
+        std::vector<size_t> Dependencies;
+    };
+
+    // Prefix is the function definition text preceding the opening parenthesis
+    void AddItem(ItemType Type, String Text, const String& Prefix = "");
+    void SelectReferencedDefinitions(const String& Source, std::vector<bool>& Selected, std::vector<size_t>& Worklist) const;
+
+    const String m_AllDefinitions;
+
+    std::vector<Item> m_Items;
+
+    // Name -> indices of all items that define the name (e.g. function overloads
+    // or macros defined in different branches of a conditional block)
+    std::unordered_map<String, std::vector<size_t>> m_NameToItems;
+};
+
+} // namespace Diligent
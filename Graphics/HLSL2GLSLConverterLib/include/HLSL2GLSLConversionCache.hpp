@@ -0,0 +1,78 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include "BasicTypes.h"
+#include "Shader.h"
+#include "PersistentCache.hpp"
+
+namespace Diligent
+{
+
+/// Key of the HLSL->GLSL conversion result, see HLSL2GLSLConversionCache::MakeKey().
+using HLSL2GLSLConversionCacheKey = ContentHashKey;
+
+/// Content-addressed cache of HLSL->GLSL conversion results.
+
+/// A conversion result is identified by the hash of the HLSL source with all includes
+/// resolved, the shader entry point, the shader type and the conversion options that
+/// affect the output. Keys are also seeded with the hash of the converter (see the constructor),
+/// so results produced by a different version of the converter are never used.
+/// See PersistentCache for the details of the memory and on-disk stores.
+/// All methods are thread-safe.
+class HLSL2GLSLConversionCache : public PersistentCache<HLSL2GLSLConversionCacheKey, String>
+{
+public:
+    using TBase = PersistentCache<HLSL2GLSLConversionCacheKey, String>;
+    using Key   = HLSL2GLSLConversionCacheKey;
+
+    /// Creates the key of the conversion result.
+
+    /// \param [in] SourceHash    - Hash of the HLSL source with all includes resolved, see ComputeFNVHash().
+    /// \param [in] SourceLength  - Length of the resolved HLSL source.
+    /// \param [in] EntryPoint    - Shader entry point.
+    /// \param [in] ShaderType    - Shader type.
+    /// \param [in] SamplerSuffix - Combined texture sampler suffix.
+    /// \param [in] UseInOutLocationQualifiers - Whether in-out location qualifiers are used.
+    Key MakeKey(Uint64      SourceHash,
+                size_t      SourceLength,
+                const Char* EntryPoint,
+                SHADER_TYPE ShaderType,
+                const Char* SamplerSuffix,
+                bool        UseInOutLocationQualifiers) const;
+
+    /// \param [in] ConverterHash - Hash that identifies the version of the converter that produces
+    ///                             the results, including the GLSL definitions it uses.
+    /// \param [in] MaxMemorySize - Maximum total size, in bytes, of the results kept in memory.
+    explicit HLSL2GLSLConversionCache(Uint64 ConverterHash, size_t MaxMemorySize = 8 << 20);
+
+private:
+    const Uint64 m_ConverterHash;
+};
+
+} // namespace Diligent
@@ -31,6 +31,10 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
+#include <memory>
+#include <cstring>
+#include <cstddef>
+#include <ostream>
 
 #include "HLSL2GLSLConverter.h"
 #include "ObjectBase.hpp"
@@ -38,6 +42,8 @@
 #include "Shader.h"
 #include "HashUtils.hpp"
 #include "HLSLKeywords.h"
+#include "HLSL2GLSLConversionCache.hpp"
+#include "GLSLDefinitionsFilter.hpp"
 
 namespace Diligent
 {
@@ -143,6 +149,22 @@ public:
     /// \return     Converted GLSL source code.
     String Convert(ConversionAttribs& Attribs) const;
 
+    /// Converts a batch of HLSL shaders to GLSL in parallel
+
+    /// \param [in] pAttribs   - Array of NumShaders conversion attributes. Conversion streams
+    ///                          are not thread-safe, so ppConversionStream members are ignored.
+    ///                          Input stream factories must be thread-safe.
+    /// \param [in] NumShaders - Number of shaders to convert.
+    /// \param [in] NumThreads - Maximum number of threads to use, including the calling thread.
+    ///                          If zero, the number of hardware threads is used.
+    /// \return     Converted GLSL source code for every shader, in the order of pAttribs.
+    ///             The string is empty if the shader failed to convert.
+    ///
+    /// \remarks    Keyword and function stub tables are immutable after the converter has been
+    ///             created and are shared by all threads. Every thread tokenizes and converts
+    ///             its own shaders and shares the conversion cache with other threads.
+    std::vector<String> ConvertBatch(const ConversionAttribs* pAttribs, size_t NumShaders, Uint32 NumThreads = 0) const;
+
     /// Creates a conversion stream
 
     /// \param [in] InputFileName - Input file name. If HLSLSource is null, this name will be
@@ -161,6 +183,21 @@ public:
                       size_t                           NumSymbols,
                       IHLSL2GLSLConversionStream**     ppStream) const;
 
+    /// Returns the GLSL definitions required by the shader.
+
+    /// \param [in] Sources - Shader source code that will follow the definitions (e.g. converted GLSL
+    ///                       produced with IncludeDefinitions set to false) as well as any code that
+    ///                       precedes the definitions and may reference them (e.g. macros).
+    /// \return     Macros and functions from GLSLDefinitions.h that are referenced, directly or
+    ///             through other definitions, by the sources.
+    String GetGLSLDefinitions(std::initializer_list<const String*> Sources) const
+    {
+        return m_DefinitionsFilter.Filter(Sources);
+    }
+
+    /// Returns the cache of conversion results shared by all conversion streams
+    HLSL2GLSLConversionCache& GetConversionCache() const { return m_ConversionCache; }
+
 private:
     HLSL2GLSLConverterImpl();
 
@@ -239,11 +276,220 @@ private:
     };
     // clang-format on
 
+    /// Token literal or delimiter.
+
+    /// Strings produced by the tokenizer reference null-terminated slices of the conversion
+    /// stream token arena, so tokenization does not allocate memory for every token.
+    /// The string is copied to its own storage only when it is modified by the converter.
+    /// The storage is a member of the string, so short modified strings that fit into the
+    /// small-string buffer do not allocate memory either.
+    class TokenString
+    {
+    public:
+        TokenString() noexcept {}
+
+        TokenString(const Char* Str)
+        {
+            // Empty strings reference the terminator of the string literal and need no storage
+            if (*Str != 0)
+                Assign(String{Str});
+        }
+
+        TokenString(String Str)
+        {
+            Assign(std::move(Str));
+        }
+
+        TokenString(const TokenString& Str) :
+            // clang-format off
+            m_Str    {Str.m_Str    },
+            m_Len    {Str.m_Len    },
+            m_Storage{Str.m_Storage},
+            m_IsOwned{Str.m_IsOwned}
+        // clang-format on
+        {
+            if (m_IsOwned)
+                m_Str = m_Storage.c_str();
+        }
+
+        TokenString(TokenString&& Str) noexcept :
+            // clang-format off
+            m_Str    {Str.m_Str             },
+            m_Len    {Str.m_Len             },
+            m_Storage{std::move(Str.m_Storage)},
+            m_IsOwned{Str.m_IsOwned         }
+        // clang-format on
+        {
+            // Short strings are stored in the small-string buffer that is not moved with the string
+            if (m_IsOwned)
+                m_Str = m_Storage.c_str();
+            Str.Reset();
+        }
+
+        TokenString& operator=(const TokenString& Str)
+        {
+            if (this != &Str)
+                *this = TokenString{Str};
+            return *this;
+        }
+
+        TokenString& operator=(TokenString&& Str) noexcept
+        {
+            if (this != &Str)
+            {
+                m_Storage = std::move(Str.m_Storage);
+                m_IsOwned = Str.m_IsOwned;
+                m_Str     = m_IsOwned ? m_Storage.c_str() : Str.m_Str;
+                m_Len     = Str.m_Len;
+                Str.Reset();
+            }
+            return *this;
+        }
+
+        /// Creates a string that references Len symbols starting at Str.
+        /// The slice must be null-terminated and must outlive the string.
+        static TokenString Slice(const Char* Str, size_t Len)
+        {
+            VERIFY(Str[Len] == 0, "Slice must be null-terminated");
+            TokenString Slice;
+            Slice.m_Str = Str;
+            Slice.m_Len = Len;
+            return Slice;
+        }
+
+        bool IsSlice() const { return !m_IsOwned && m_Len != 0; }
+
+        const Char* c_str() const { return m_Str; }
+        size_t      length() const { return m_Len; }
+        size_t      size() const { return m_Len; }
+        bool        empty() const { return m_Len == 0; }
+        String      str() const { return String{m_Str, m_Len}; }
+
+        const Char* begin() const { return m_Str; }
+        const Char* end() const { return m_Str + m_Len; }
+
+        Char operator[](size_t Pos) const
+        {
+            VERIFY_EXPR(Pos < m_Len);
+            return m_Str[Pos];
+        }
+
+        Char back() const
+        {
+            VERIFY_EXPR(m_Len > 0);
+            return m_Str[m_Len - 1];
+        }
+
+        // clang-format off
+        void push_back(Char Sym)     { Modify([Sym] (String& Str){ Str.push_back(Sym); }); }
+        void pop_back()              { Modify([]    (String& Str){ Str.pop_back();     }); }
+        void reserve  (size_t Size)  { Modify([Size](String& Str){ Str.reserve(Size);  }); }
+        // clang-format on
+
+        void clear()
+        {
+            *this = TokenString{};
+        }
+
+        TokenString& append(const Char* Str)
+        {
+            Modify([Str](String& Storage) { Storage.append(Str); });
+            return *this;
+        }
+        TokenString& append(const String& Str)
+        {
+            Modify([&Str](String& Storage) { Storage.append(Str); });
+            return *this;
+        }
+        TokenString& append(const TokenString& Str)
+        {
+            // Str may reference this string's storage that is reallocated by append,
+            // so the appended string must be copied first.
+            return append(Str.str());
+        }
+
+        // clang-format off
+        TokenString& operator+=(Char               Sym) { push_back(Sym); return *this; }
+        TokenString& operator+=(const Char*        Str) { return append(Str); }
+        TokenString& operator+=(const String&      Str) { return append(Str); }
+        TokenString& operator+=(const TokenString& Str) { return append(Str); }
+
+        bool operator==(const Char*        Str) const { return IsEqual(Str, strlen(Str));           }
+        bool operator==(const String&      Str) const { return IsEqual(Str.c_str(), Str.length()); }
+        bool operator==(const TokenString& Str) const { return IsEqual(Str.c_str(), Str.length()); }
+
+        bool operator!=(const Char*        Str) const { return !(*this == Str); }
+        bool operator!=(const String&      Str) const { return !(*this == Str); }
+        bool operator!=(const TokenString& Str) const { return !(*this == Str); }
+        // clang-format on
+
+        friend std::ostream& operator<<(std::ostream& os, const TokenString& Str)
+        {
+            return os.write(Str.c_str(), Str.length());
+        }
+
+        friend String& operator+=(String& Lhs, const TokenString& Rhs)
+        {
+            return Lhs.append(Rhs.c_str(), Rhs.length());
+        }
+
+        friend String operator+(const String& Lhs, const TokenString& Rhs)
+        {
+            String Res{Lhs};
+            Res += Rhs;
+            return Res;
+        }
+
+        friend String operator+(const TokenString& Lhs, Char Rhs)
+        {
+            auto Res = Lhs.str();
+            Res.push_back(Rhs);
+            return Res;
+        }
+
+    private:
+        bool IsEqual(const Char* Str, size_t Len) const
+        {
+            return m_Len == Len && memcmp(m_Str, Str, Len) == 0;
+        }
+
+        void Assign(String&& Str)
+        {
+            m_Storage = std::move(Str);
+            m_IsOwned = true;
+            m_Str     = m_Storage.c_str();
+            m_Len     = m_Storage.length();
+        }
+
+        void Reset()
+        {
+            m_Storage.clear();
+            m_IsOwned = false;
+            m_Str     = "";
+            m_Len     = 0;
+        }
+
+        template <typename ModifierType>
+        void Modify(ModifierType Modifier)
+        {
+            if (!m_IsOwned)
+                Assign(str());
+            Modifier(m_Storage);
+            m_Str = m_Storage.c_str();
+            m_Len = m_Storage.length();
+        }
+
+        const Char* m_Str = "";
+        size_t      m_Len = 0;
+        String      m_Storage;         // Only used when the string is modified
+        bool        m_IsOwned = false; // Whether m_Str points to m_Storage
+    };
+
     struct TokenInfo
     {
-        TokenType Type;
-        String    Literal;
-        String    Delimiter;
+        TokenType   Type;
+        TokenString Literal;
+        TokenString Delimiter;
 
         bool IsBuiltInType() const
         {
@@ -267,7 +513,83 @@ private:
             Delimiter{_Delimiter}
         {}
     };
-    typedef std::list<TokenInfo> TokenListType;
+
+    /// Pool that the token list nodes of a conversion stream are allocated from.
+
+    /// The source is tokenized into a list with one node per token, and conversion passes
+    /// insert and erase nodes all the time. Nodes are carved from large chunks, and released
+    /// nodes are kept in per-size free lists and reused, so building and editing the list does not
+    /// call the heap allocator for every token. The memory is released when the pool is destroyed.
+    /// The pool is not thread-safe.
+    class TokenNodePool
+    {
+    public:
+        TokenNodePool() noexcept {}
+
+        // clang-format off
+        TokenNodePool             (const TokenNodePool&)  = delete;
+        TokenNodePool             (      TokenNodePool&&) = delete;
+        TokenNodePool& operator = (const TokenNodePool&)  = delete;
+        TokenNodePool& operator = (      TokenNodePool&&) = delete;
+        // clang-format on
+
+        void* Allocate(size_t Size);
+        void  Free(void* Ptr, size_t Size);
+
+    private:
+        static constexpr size_t ChunkSize = 64 << 10;
+
+        struct FreeBlock
+        {
+            FreeBlock* pNext;
+        };
+        struct SizeClass
+        {
+            size_t     Size;
+            FreeBlock* pFreeList;
+        };
+        // There is normally one size class for the list nodes
+        std::vector<SizeClass> m_SizeClasses;
+
+        std::vector<std::unique_ptr<Uint8[]>> m_Chunks;
+
+        Uint8* m_pCurrPos       = nullptr;
+        size_t m_RemainingBytes = 0;
+    };
+
+    template <typename T>
+    struct TokenNodeAllocator
+    {
+        using value_type = T;
+
+        explicit TokenNodeAllocator(TokenNodePool& Pool) noexcept :
+            m_pPool{&Pool}
+        {}
+
+        template <typename U>
+        TokenNodeAllocator(const TokenNodeAllocator<U>& Other) noexcept :
+            m_pPool{Other.m_pPool}
+        {}
+
+        T* allocate(size_t Count)
+        {
+            return static_cast<T*>(m_pPool->Allocate(Count * sizeof(T)));
+        }
+
+        void deallocate(T* Ptr, size_t Count)
+        {
+            m_pPool->Free(Ptr, Count * sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(const TokenNodeAllocator<U>& Other) const { return m_pPool == Other.m_pPool; }
+        template <typename U>
+        bool operator!=(const TokenNodeAllocator<U>& Other) const { return m_pPool != Other.m_pPool; }
+
+        TokenNodePool* m_pPool;
+    };
+
+    typedef std::list<TokenInfo, TokenNodeAllocator<TokenInfo>> TokenListType;
 
 
     class ConversionStream : public ObjectBase<IHLSL2GLSLConversionStream>
@@ -319,9 +641,15 @@ private:
         void InsertIncludes(String& GLSLSource, IShaderSourceInputStreamFactory* pSourceStreamFactory);
         void Tokenize(const String& Source);
 
+        // Converts the tokens to GLSL source without definitions
+        String ConvertTokens(const Char* EntryPoint,
+                             SHADER_TYPE ShaderType,
+                             const char* SamplerSuffix,
+                             bool        UseInOutLocationQualifiers);
+
         typedef std::unordered_map<String, bool> SamplerHashType;
 
-        const HLSLObjectInfo* FindHLSLObject(const String& Name);
+        const HLSLObjectInfo* FindHLSLObject(const Char* Name);
 
         void ProcessShaderDeclaration(TokenListType::iterator EntryPointToken, SHADER_TYPE ShaderType);
 
@@ -501,6 +829,20 @@ private:
 
         String BuildGLSLSource();
 
+        // HLSL source with all includes resolved. The source is tokenized
+        // when the first conversion result is not found in the cache.
+        String m_Source;
+        size_t m_SourceLength = 0;
+        Uint64 m_SourceHash   = 0;
+        bool   m_bTokenized   = false;
+
+        // Storage for the null-terminated token literals and delimiters
+        // produced by the tokenizer (see TokenString)
+        std::unique_ptr<Char[]> m_TokenArena;
+
+        // Must be declared before all token lists
+        TokenNodePool m_TokenNodePool;
+
         // Tokenized source code
         TokenListType m_Tokens;
 
@@ -541,6 +883,12 @@ private:
     static constexpr int                                                   InVar  = 0;
     static constexpr int                                                   OutVar = 1;
     std::unordered_map<HashMapStringKey, String, HashMapStringKey::Hasher> m_HLSLSemanticToGLSLVar[6][2];
+
+    // Selects definitions referenced by the shaders, see GetGLSLDefinitions()
+    const GLSLDefinitionsFilter m_DefinitionsFilter;
+
+    // Conversion results, see HLSL2GLSLConversionCache
+    mutable HLSL2GLSLConversionCache m_ConversionCache;
 };
 
 } // namespace Diligent
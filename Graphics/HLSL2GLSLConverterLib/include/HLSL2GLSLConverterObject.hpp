@@ -50,6 +50,11 @@ public:
                                                  const Char*                      HLSLSource,
                                                  size_t                           NumSymbols,
                                                  IHLSL2GLSLConversionStream**     ppStream) const override;
+
+    virtual void DILIGENT_CALL_TYPE ConvertBatch(const HLSL2GLSLBatchShaderDesc* pShaders,
+                                                 Uint32                          NumShaders,
+                                                 Uint32                          NumThreads,
+                                                 IDataBlob**                     ppGLSLSources) const override;
 };
 
 } // namespace Diligent
@@ -74,6 +74,44 @@ DILIGENT_END_INTERFACE
 #endif
 
 
+/// Describes a shader converted by IHLSL2GLSLConverter::ConvertBatch()
+struct HLSL2GLSLBatchShaderDesc
+{
+    /// Input file name. If HLSLSource is null, this name is used to load the shader
+    /// source code from the input stream factory. Otherwise the name is only used
+    /// for information purposes.
+    const Char* InputFileName DEFAULT_INITIALIZER(nullptr);
+
+    /// Input stream factory that is used to load shader includes as well as to load
+    /// the shader source code if HLSLSource is null. The factory must be thread-safe.
+    IShaderSourceInputStreamFactory* pSourceStreamFactory DEFAULT_INITIALIZER(nullptr);
+
+    /// HLSL source code. If this member is null, the source is loaded from
+    /// the input stream factory using InputFileName.
+    const Char* HLSLSource DEFAULT_INITIALIZER(nullptr);
+
+    /// Number of symbols in the HLSLSource string. Ignored if HLSLSource is null.
+    size_t NumSymbols DEFAULT_INITIALIZER(0);
+
+    /// Shader entry point.
+    const Char* EntryPoint DEFAULT_INITIALIZER("main");
+
+    /// Shader type.
+    SHADER_TYPE ShaderType DEFAULT_INITIALIZER(SHADER_TYPE_UNKNOWN);
+
+    /// Whether to include GLSL definitions supporting HLSL->GLSL conversion.
+    bool IncludeDefinitions DEFAULT_INITIALIZER(false);
+
+    /// Combined texture sampler suffix.
+    const Char* SamplerSuffix DEFAULT_INITIALIZER("_sampler");
+
+    /// Whether to use in-out location qualifiers. This requires separate shader objects extension:
+    /// https://www.khronos.org/registry/OpenGL/extensions/ARB/ARB_separate_shader_objects.txt
+    bool UseInOutLocationQualifiers DEFAULT_INITIALIZER(true);
+};
+typedef struct HLSL2GLSLBatchShaderDesc HLSL2GLSLBatchShaderDesc;
+
+
 // {44A21160-77E0-4DDC-A57E-B8B8B65B5342}
 static const INTERFACE_ID IID_HLSL2GLSLConverter =
     {0x44a21160, 0x77e0, 0x4ddc, {0xa5, 0x7e, 0xb8, 0xb8, 0xb6, 0x5b, 0x53, 0x42}};
@@ -96,6 +134,21 @@ DILIGENT_BEGIN_INTERFACE(IHLSL2GLSLConverter, IObject)
                                       const Char*                      HLSLSource,
                                       size_t                           NumSymbols,
                                       IHLSL2GLSLConversionStream**     ppStream) CONST PURE;
+
+    /// Converts a batch of HLSL shaders to GLSL in parallel.
+
+    /// \param [in]  pShaders      - Array of NumShaders shader descriptions.
+    /// \param [in]  NumShaders    - Number of shaders to convert.
+    /// \param [in]  NumThreads    - Maximum number of threads to use, including the calling thread.
+    ///                              If zero, the number of hardware threads is used.
+    /// \param [out] ppGLSLSources - Array of NumShaders pointers where the converted GLSL source of
+    ///                              every shader will be written, in the order of pShaders.
+    ///                              Null is written if the shader failed to convert.
+    VIRTUAL void METHOD(ConvertBatch)(THIS_
+                                      const HLSL2GLSLBatchShaderDesc* pShaders,
+                                      Uint32                          NumShaders,
+                                      Uint32                          NumThreads,
+                                      IDataBlob**                     ppGLSLSources) CONST PURE;
 };
 DILIGENT_END_INTERFACE
 
@@ -106,6 +159,7 @@ DILIGENT_END_INTERFACE
 // clang-format off
 
 #    define IHLSL2GLSLConverter_CreateStream(This, ...) CALL_IFACE_METHOD(HLSL2GLSLConverter, CreateStream, This, __VA_ARGS__)
+#    define IHLSL2GLSLConverter_ConvertBatch(This, ...) CALL_IFACE_METHOD(HLSL2GLSLConverter, ConvertBatch, This, __VA_ARGS__)
 
 // clang-format on
 
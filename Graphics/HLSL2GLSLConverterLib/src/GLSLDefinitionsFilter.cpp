@@ -0,0 +1,432 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+
+#include <cctype>
+#include <algorithm>
+#include <unordered_set>
+
+#include "GLSLDefinitionsFilter.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+inline bool IsIdentifierStart(Char c)
+{
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+inline bool IsIdentifierChar(Char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Calls Handler(Start, Length) for every identifier in the range.
+// Identifiers in comments and string literals are skipped.
+template <typename HandlerType>
+void ForEachIdentifier(const Char* Pos, const Char* End, HandlerType&& Handler)
+{
+    while (Pos != End)
+    {
+        if (*Pos == '/' && Pos + 1 != End && Pos[1] == '/')
+        {
+            while (Pos != End && *Pos != '\n')
+                ++Pos;
+        }
+        else if (*Pos == '/' && Pos + 1 != End && Pos[1] == '*')
+        {
+            Pos += 2;
+            while (Pos != End && !(*Pos == '*' && Pos + 1 != End && Pos[1] == '/'))
+                ++Pos;
+            if (Pos != End)
+                Pos += 2;
+        }
+        else if (*Pos == '"')
+        {
+            ++Pos;
+            while (Pos != End && *Pos != '"' && *Pos != '\n')
+                ++Pos;
+            if (Pos != End)
+                ++Pos;
+        }
+        else if (IsIdentifierStart(*Pos))
+        {
+            const auto* Start = Pos;
+            while (Pos != End && IsIdentifierChar(*Pos))
+                ++Pos;
+            Handler(Start, static_cast<size_t>(Pos - Start));
+        }
+        else if (std::isdigit(static_cast<unsigned char>(*Pos)))
+        {
+            // Skip numeric constants such as 0x0ffffu or 1.0f
+            while (Pos != End && (IsIdentifierChar(*Pos) || *Pos == '.'))
+                ++Pos;
+        }
+        else
+        {
+            ++Pos;
+        }
+    }
+}
+
+template <typename HandlerType>
+void ForEachIdentifier(const String& Str, HandlerType&& Handler)
+{
+    ForEachIdentifier(Str.data(), Str.data() + Str.length(), std::forward<HandlerType>(Handler));
+}
+
+// Removes comments from the line. InBlockComment indicates whether the line starts
+// inside a block comment and is updated to tell if the next line does.
+String StripComments(const String& Line, bool& InBlockComment)
+{
+    String Code;
+    for (size_t Pos = 0; Pos < Line.length();)
+    {
+        if (InBlockComment)
+        {
+            auto CommentEnd = Line.find("*/", Pos);
+            if (CommentEnd == String::npos)
+                break;
+            InBlockComment = false;
+            Pos            = CommentEnd + 2;
+        }
+        else if (Line.compare(Pos, 2, "//") == 0)
+        {
+            break;
+        }
+        else if (Line.compare(Pos, 2, "/*") == 0)
+        {
+            InBlockComment = true;
+            Pos += 2;
+        }
+        else
+        {
+            Code.push_back(Line[Pos++]);
+        }
+    }
+    return Code;
+}
+
+} // namespace
+
+GLSLDefinitionsFilter::GLSLDefinitionsFilter(const Char* Definitions) :
+    m_AllDefinitions{Definitions}
+{
+    std::vector<String> Lines;
+    for (size_t LineStart = 0; LineStart < m_AllDefinitions.length();)
+    {
+        auto LineEnd = m_AllDefinitions.find('\n', LineStart);
+        if (LineEnd == String::npos)
+            LineEnd = m_AllDefinitions.length();
+        Lines.emplace_back(m_AllDefinitions, LineStart, LineEnd - LineStart);
+        if (!Lines.back().empty() && Lines.back().back() == '\r')
+            Lines.back().pop_back();
+        LineStart = LineEnd + 1;
+    }
+
+    size_t Line = 0;
+    while (Line < Lines.size())
+    {
+        const auto FirstChar = Lines[Line].find_first_not_of(" \t");
+        if (FirstChar == String::npos || Lines[Line].compare(FirstChar, 2, "//") == 0)
+        {
+            // Skip empty lines and comments between the items
+            ++Line;
+            continue;
+        }
+
+        if (Lines[Line].compare(FirstChar, 2, "/*") == 0)
+        {
+            // Skip block comment (e.g. the license)
+            while (Line < Lines.size() && Lines[Line].find("*/") == String::npos)
+                ++Line;
+            ++Line;
+            continue;
+        }
+
+        String Text;
+        if (Lines[Line][FirstChar] == '#')
+        {
+            // Preprocessor directive, possibly continued on the next lines
+            bool Continued = true;
+            while (Line < Lines.size() && Continued)
+            {
+                const auto& CurrLine = Lines[Line++];
+                Continued            = !CurrLine.empty() && CurrLine.back() == '\\';
+                Text += CurrLine;
+                Text += '\n';
+            }
+
+            auto DirectiveStart = Text.find_first_not_of(" \t", FirstChar + 1);
+            auto DirectiveEnd   = DirectiveStart;
+            while (DirectiveEnd < Text.length() && IsIdentifierChar(Text[DirectiveEnd]))
+                ++DirectiveEnd;
+            const auto Directive = Text.substr(DirectiveStart, DirectiveEnd - DirectiveStart);
+
+            if (Directive == "if" || Directive == "ifdef" || Directive == "ifndef")
+                AddItem(ItemType::If, std::move(Text));
+            else if (Directive == "else" || Directive == "elif")
+                AddItem(ItemType::Else, std::move(Text));
+            else if (Directive == "endif")
+                AddItem(ItemType::EndIf, std::move(Text));
+            else if (Directive == "define")
+                AddItem(ItemType::Definition, std::move(Text));
+            else
+                AddItem(ItemType::Declaration, std::move(Text));
+        }
+        else
+        {
+            // Function definition or declaration that ends with the closing brace or
+            // with the semicolon if it has no braces
+            String Code;
+            int    BraceDepth = 0;
+            int    ParenDepth = 0;
+            bool   HasBraces  = false;
+            bool   Complete   = false;
+            bool   InComment  = false;
+            while (Line < Lines.size() && !Complete)
+            {
+                const auto& CurrLine = Lines[Line++];
+                Text += CurrLine;
+                Text += '\n';
+
+                const auto CodeLine = StripComments(CurrLine, InComment);
+                for (auto c : CodeLine)
+                {
+                    switch (c)
+                    {
+                        // clang-format off
+                        case '{': ++BraceDepth; HasBraces = true; break;
+                        case '}': --BraceDepth; break;
+                        case '(': ++ParenDepth; break;
+                        case ')': --ParenDepth; break;
+                        // clang-format on
+                        case ';':
+                            if (!HasBraces && BraceDepth == 0 && ParenDepth == 0)
+                                Complete = true;
+                            break;
+                    }
+                }
+                Code += CodeLine;
+                Code += '\n';
+
+                if (HasBraces && BraceDepth == 0)
+                    Complete = true;
+            }
+
+            const auto ParenPos = Code.find('(');
+            const auto BracePos = Code.find('{');
+            if (HasBraces && ParenPos != String::npos && ParenPos < BracePos)
+                AddItem(ItemType::Definition, std::move(Text), Code.substr(0, ParenPos));
+            else
+                AddItem(ItemType::Declaration, std::move(Text));
+        }
+    }
+
+    // Names tested by conditional directives (e.g. the include guard) must always be defined
+    std::unordered_set<String> ConditionNames;
+    for (const auto& Item : m_Items)
+    {
+        if (Item.Type == ItemType::If || Item.Type == ItemType::Else)
+            ForEachIdentifier(Item.Text, [&](const Char* Name, size_t Len) { ConditionNames.emplace(Name, Len); });
+    }
+
+    String Name;
+    for (size_t i = 0; i < m_Items.size(); ++i)
+    {
+        auto& Item = m_Items[i];
+        if (Item.Type == ItemType::Definition && ConditionNames.find(Item.Name) != ConditionNames.end())
+            Item.Type = ItemType::Declaration;
+
+        if (Item.Type != ItemType::Definition && Item.Type != ItemType::Declaration)
+            continue;
+
+        ForEachIdentifier(Item.Text, [&](const Char* Start, size_t Len) {
+            Name.assign(Start, Len);
+            auto it = m_NameToItems.find(Name);
+            if (it == m_NameToItems.end())
+                return;
+            for (auto Dependency : it->second)
+            {
+                if (Dependency != i)
+                    Item.Dependencies.push_back(Dependency);
+            }
+        });
+        std::sort(Item.Dependencies.begin(), Item.Dependencies.end());
+        Item.Dependencies.erase(std::unique(Item.Dependencies.begin(), Item.Dependencies.end()), Item.Dependencies.end());
+    }
+}
+
+void GLSLDefinitionsFilter::AddItem(ItemType Type, String Text, const String& Prefix)
+{
+    Item NewItem;
+    NewItem.Type = Type;
+    NewItem.Text = std::move(Text);
+    if (Type == ItemType::Definition)
+    {
+        // The defined name is the first identifier after '#define' for macros,
+        // and the last identifier before '(' for functions
+        if (Prefix.empty())
+        {
+            auto DefinePos = NewItem.Text.find("define");
+            VERIFY_EXPR(DefinePos != String::npos);
+            auto NameStart = NewItem.Text.find_first_not_of(" \t", DefinePos + 6);
+            auto NameEnd   = NameStart;
+            while (NameEnd < NewItem.Text.length() && IsIdentifierChar(NewItem.Text[NameEnd]))
+                ++NameEnd;
+            NewItem.Name = NewItem.Text.substr(NameStart, NameEnd - NameStart);
+        }
+        else
+        {
+            auto NameEnd = Prefix.find_last_not_of(" \t\n");
+            if (NameEnd != String::npos)
+            {
+                ++NameEnd;
+                auto NameStart = NameEnd;
+                while (NameStart > 0 && IsIdentifierChar(Prefix[NameStart - 1]))
+                    --NameStart;
+                NewItem.Name = Prefix.substr(NameStart, NameEnd - NameStart);
+            }
+        }
+
+        if (NewItem.Name.empty())
+            NewItem.Type = ItemType::Declaration;
+        else
+            m_NameToItems[NewItem.Name].push_back(m_Items.size());
+    }
+    m_Items.emplace_back(std::move(NewItem));
+}
+
+void GLSLDefinitionsFilter::SelectReferencedDefinitions(const String& Source, std::vector<bool>& Selected, std::vector<size_t>& Worklist) const
+{
+    String Name;
+    ForEachIdentifier(Source, [&](const Char* Start, size_t Len) {
+        Name.assign(Start, Len);
+        auto it = m_NameToItems.find(Name);
+        if (it == m_NameToItems.end())
+            return;
+        for (auto ItemIdx : it->second)
+        {
+            if (!Selected[ItemIdx])
+            {
+                Selected[ItemIdx] = true;
+                Worklist.push_back(ItemIdx);
+            }
+        }
+    });
+}
+
+String GLSLDefinitionsFilter::Filter(std::initializer_list<const String*> Sources) const
+{
+    for (const auto* pSource : Sources)
+    {
+        if (pSource->find("##") != String::npos)
+            return m_AllDefinitions;
+    }
+
+    std::vector<bool>   Selected(m_Items.size(), false);
+    std::vector<size_t> Worklist;
+    for (size_t i = 0; i < m_Items.size(); ++i)
+    {
+        if (m_Items[i].Type == ItemType::Declaration)
+        {
+            Selected[i] = true;
+            Worklist.push_back(i);
+        }
+    }
+
+    for (const auto* pSource : Sources)
+        SelectReferencedDefinitions(*pSource, Selected, Worklist);
+
+    while (!Worklist.empty())
+    {
+        const auto ItemIdx = Worklist.back();
+        Worklist.pop_back();
+        for (auto Dependency : m_Items[ItemIdx].Dependencies)
+        {
+            if (!Selected[Dependency])
+            {
+                Selected[Dependency] = true;
+                Worklist.push_back(Dependency);
+            }
+        }
+    }
+
+    String Output;
+    // Output positions where the open conditional blocks start, and whether the blocks contain any items
+    std::vector<std::pair<size_t, bool>> OpenBlocks;
+    for (size_t i = 0; i < m_Items.size(); ++i)
+    {
+        const auto& Item = m_Items[i];
+        switch (Item.Type)
+        {
+            case ItemType::If:
+                OpenBlocks.emplace_back(Output.length(), false);
+                Output += Item.Text;
+                break;
+
+            case ItemType::Else:
+                Output += Item.Text;
+                break;
+
+            case ItemType::EndIf:
+                if (!OpenBlocks.empty())
+                {
+                    if (OpenBlocks.back().second)
+                        Output += Item.Text;
+                    else
+                        Output.resize(OpenBlocks.back().first); // Remove the empty block
+                    OpenBlocks.pop_back();
+                }
+                else
+                {
+                    UNEXPECTED("Unbalanced #endif");
+                    Output += Item.Text;
+                }
+                break;
+
+            case ItemType::Declaration:
+            case ItemType::Definition:
+                if (Selected[i])
+                {
+                    Output += Item.Text;
+                    for (auto& Block : OpenBlocks)
+                        Block.second = true;
+                }
+                break;
+        }
+    }
+    VERIFY(OpenBlocks.empty(), "Unbalanced conditional directives");
+
+    return Output;
+}
+
+} // namespace Diligent
@@ -356,12 +356,15 @@
 #include "pch.h"
 #include <unordered_set>
 #include <string>
+#include <thread>
+#include <atomic>
 
 #include "HLSL2GLSLConverterImpl.hpp"
 #include "ShaderBase.hpp"
 #include "DataBlobImpl.hpp"
 #include "StringDataBlobImpl.hpp"
 #include "StringTools.hpp"
+#include "Align.hpp"
 
 using namespace std;
 
@@ -516,7 +519,22 @@ const HLSL2GLSLConverterImpl& HLSL2GLSLConverterImpl::GetInstance()
     return Converter;
 }
 
-HLSL2GLSLConverterImpl::HLSL2GLSLConverterImpl()
+// Version of the converter. Conversion results are cached by the hash of the version and the
+// GLSL definitions, so the version must be incremented whenever a change to the converter changes
+// its output. Changes to GLSLDefinitions.h invalidate the cached results automatically.
+static constexpr Uint32 ConverterVersion = 1;
+
+static Uint64 ComputeConverterHash()
+{
+    auto Hash = ComputeFNVHash(&ConverterVersion, sizeof(ConverterVersion));
+    return ComputeFNVHash(g_GLSLDefinitions, strlen(g_GLSLDefinitions), Hash);
+}
+
+HLSL2GLSLConverterImpl::HLSL2GLSLConverterImpl() :
+    // clang-format off
+    m_DefinitionsFilter{g_GLSLDefinitions     },
+    m_ConversionCache  {ComputeConverterHash()}
+// clang-format on
 {
     // Populate HLSL keywords hash map
 #define DEFINE_KEYWORD(keyword) m_HLSLKeywords.insert(std::make_pair(#keyword, TokenInfo(TokenType::kw_##keyword, #keyword)));
@@ -847,7 +865,7 @@ String HLSL2GLSLConverterImpl::ConversionStream::PrintTokenContext(IteratorType&
     Int32 NumLinesAbove      = 0;
     while (CurrLineStartToken != m_Tokens.begin())
     {
-        NumLinesAbove += CountNewLines(CurrLineStartToken->Delimiter);
+        NumLinesAbove += CountNewLines(CurrLineStartToken->Delimiter.str());
         if (NumLinesAbove > 0)
             break;
         --CurrLineStartToken;
@@ -860,7 +878,7 @@ String HLSL2GLSLConverterImpl::ConversionStream::PrintTokenContext(IteratorType&
     while (TopLineStart != m_Tokens.begin() && NumLinesAbove <= NumAdjacentLines)
     {
         --TopLineStart;
-        NumLinesAbove += CountNewLines(TopLineStart->Delimiter);
+        NumLinesAbove += CountNewLines(TopLineStart->Delimiter.str());
     }
     //\n  ++ x ;
     //    ^
@@ -871,8 +889,8 @@ String HLSL2GLSLConverterImpl::ConversionStream::PrintTokenContext(IteratorType&
     auto Token = TopLineStart;
     for (; Token != CurrLineStartToken; ++Token)
     {
-        Ctx.append(CompressNewLines(Token->Delimiter));
-        Ctx.append(Token->Literal);
+        Ctx.append(CompressNewLines(Token->Delimiter.str()));
+        Ctx += Token->Literal;
     }
 
     //\n  if ( x != 0 )
@@ -903,14 +921,14 @@ String HLSL2GLSLConverterImpl::ConversionStream::PrintTokenContext(IteratorType&
         if (AccumWhiteSpaces)
             Spaces.append(Token->Literal.length(), ' ');
 
-        Ctx.append(CompressNewLines(Token->Delimiter));
-        Ctx.append(Token->Literal);
+        Ctx.append(CompressNewLines(Token->Delimiter.str()));
+        Ctx += Token->Literal;
         ++Token;
 
         if (Token == m_Tokens.end())
             break;
 
-        NumLinesBelow += CountNewLines(Token->Delimiter);
+        NumLinesBelow += CountNewLines(Token->Delimiter.str());
     }
 
     // Write ^ on the line below
@@ -921,14 +939,14 @@ String HLSL2GLSLConverterImpl::ConversionStream::PrintTokenContext(IteratorType&
     // Write NumAdjacentLines lines below current line
     while (Token != m_Tokens.end() && NumLinesBelow <= NumAdjacentLines)
     {
-        Ctx.append(CompressNewLines(Token->Delimiter));
-        Ctx.append(Token->Literal);
+        Ctx.append(CompressNewLines(Token->Delimiter.str()));
+        Ctx += Token->Literal;
         ++Token;
 
         if (Token == m_Tokens.end())
             break;
 
-        NumLinesBelow += CountNewLines(Token->Delimiter);
+        NumLinesBelow += CountNewLines(Token->Delimiter.str());
     }
 
     Ctx.append("\n<");
@@ -1071,11 +1089,11 @@ void HLSL2GLSLConverterImpl::ConversionStream::InsertIncludes(String& GLSLSource
 }
 
 
-void ReadNumericConstant(const String& Source, String::const_iterator& Pos, String& Output)
+void SkipNumericConstant(const String& Source, String::const_iterator& Pos)
 {
 #define COPY_SYMBOL()                    \
     {                                    \
-        Output.push_back(*(Pos++));      \
+        ++Pos;                           \
         if (Pos == Source.end()) return; \
     }
 
@@ -1110,6 +1128,56 @@ void ReadNumericConstant(const String& Source, String::const_iterator& Pos, Stri
 }
 
 
+void* HLSL2GLSLConverterImpl::TokenNodePool::Allocate(size_t Size)
+{
+    Size = Align(Size, alignof(std::max_align_t));
+
+    for (auto& Class : m_SizeClasses)
+    {
+        if (Class.Size == Size && Class.pFreeList != nullptr)
+        {
+            auto* pBlock    = Class.pFreeList;
+            Class.pFreeList = pBlock->pNext;
+            return pBlock;
+        }
+    }
+
+    if (m_RemainingBytes < Size)
+    {
+        const auto NewChunkSize = std::max(Size, size_t{ChunkSize});
+        m_Chunks.emplace_back(new Uint8[NewChunkSize]);
+        m_pCurrPos       = m_Chunks.back().get();
+        m_RemainingBytes = NewChunkSize;
+    }
+
+    auto* Ptr = m_pCurrPos;
+    m_pCurrPos += Size;
+    m_RemainingBytes -= Size;
+    return Ptr;
+}
+
+void HLSL2GLSLConverterImpl::TokenNodePool::Free(void* Ptr, size_t Size)
+{
+    if (Ptr == nullptr)
+        return;
+
+    Size = Align(Size, alignof(std::max_align_t));
+
+    auto* pBlock = static_cast<FreeBlock*>(Ptr);
+    for (auto& Class : m_SizeClasses)
+    {
+        if (Class.Size == Size)
+        {
+            pBlock->pNext   = Class.pFreeList;
+            Class.pFreeList = pBlock;
+            return;
+        }
+    }
+    pBlock->pNext = nullptr;
+    m_SizeClasses.push_back(SizeClass{Size, pBlock});
+}
+
+
 // The function convertes source code into a token list
 void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
 {
@@ -1131,6 +1199,40 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
     // backwards searching
     m_Tokens.push_back(TokenInfo());
 
+    // Every literal and delimiter is copied to the arena followed by the null terminator.
+    // Empty delimiters are not stored, and every literal except for an empty string constant
+    // takes at least one source symbol, so the arena never needs more than twice the source size.
+    m_TokenArena.reset(new Char[Source.length() * 2 + 1]);
+    auto* ArenaPos = m_TokenArena.get();
+
+    auto MakeSlice = [&ArenaPos](String::const_iterator Start, String::const_iterator End) //
+    {
+        const auto* Str = ArenaPos;
+        const auto  Len = static_cast<size_t>(End - Start);
+        std::copy(Start, End, ArenaPos);
+        ArenaPos += Len;
+        *(ArenaPos++) = '\0';
+        return TokenString::Slice(Str, Len);
+    };
+
+    // Appends the symbol to the literal of the last token. When the literal is the last slice
+    // in the arena, which is always the case when there is no delimiter between the tokens,
+    // the slice is extended in place.
+    auto AppendToLastLiteral = [&ArenaPos](TokenString& Literal, Char Sym) //
+    {
+        if (Literal.IsSlice() && Literal.c_str() + Literal.length() + 1 == ArenaPos)
+        {
+            const auto* Str = Literal.c_str();
+            ArenaPos[-1]    = Sym;
+            *(ArenaPos++)   = '\0';
+            Literal         = TokenString::Slice(Str, Literal.length() + 1);
+        }
+        else
+        {
+            Literal.push_back(Sym);
+        }
+    };
+
     // https://msdn.microsoft.com/en-us/library/windows/desktop/bb509638(v=vs.85).aspx
 
     // Notes:
@@ -1144,11 +1246,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
         auto      DelimStart = SrcPos;
         SkipDelimetersAndComments(Source, SrcPos);
         if (DelimStart != SrcPos)
-        {
-            auto DelimSize = SrcPos - DelimStart;
-            NewToken.Delimiter.reserve(DelimSize);
-            NewToken.Delimiter.append(DelimStart, SrcPos);
-        }
+            NewToken.Delimiter = MakeSlice(DelimStart, SrcPos);
         if (SrcPos == Source.end())
             break;
 
@@ -1162,19 +1260,18 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
                 SkipDelimetersAndComments(Source, SrcPos);
                 CHECK_END("Missing preprocessor directive");
                 SkipIdentifier(Source, SrcPos);
-                auto DirectiveSize = SrcPos - DirectiveStart;
-                NewToken.Literal.reserve(DirectiveSize);
-                NewToken.Literal.append(DirectiveStart, SrcPos);
+                NewToken.Literal = MakeSlice(DirectiveStart, SrcPos);
             }
             break;
 
             case ';':
-                NewToken.Type = TokenType::Semicolon;
-                NewToken.Literal.push_back(*(SrcPos++));
+                NewToken.Type    = TokenType::Semicolon;
+                NewToken.Literal = MakeSlice(SrcPos, SrcPos + 1);
+                ++SrcPos;
                 break;
 
             case '=':
-                if (m_Tokens.size() > 0 && NewToken.Delimiter == "")
+                if (m_Tokens.size() > 0 && NewToken.Delimiter.empty())
                 {
                     auto& LastToken = m_Tokens.back();
                     // +=, -=, *=, /=, %=, <<=, >>=, &=, |=, ^=
@@ -1190,7 +1287,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
                         LastToken.Literal == "^")
                     {
                         LastToken.Type = TokenType::Assignment;
-                        LastToken.Literal.push_back(*(SrcPos++));
+                        AppendToLastLiteral(LastToken.Literal, *(SrcPos++));
                         continue;
                     }
                     else if (LastToken.Literal == "<" ||
@@ -1199,13 +1296,14 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
                              LastToken.Literal == "!")
                     {
                         LastToken.Type = TokenType::ComparisonOp;
-                        LastToken.Literal.push_back(*(SrcPos++));
+                        AppendToLastLiteral(LastToken.Literal, *(SrcPos++));
                         continue;
                     }
                 }
 
-                NewToken.Type = TokenType::Assignment;
-                NewToken.Literal.push_back(*(SrcPos++));
+                NewToken.Type    = TokenType::Assignment;
+                NewToken.Literal = MakeSlice(SrcPos, SrcPos + 1);
+                ++SrcPos;
                 break;
 
             case '|':
@@ -1214,13 +1312,14 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
                     m_Tokens.back().Literal.length() == 1 && m_Tokens.back().Literal[0] == *SrcPos)
                 {
                     m_Tokens.back().Type = TokenType::BooleanOp;
-                    m_Tokens.back().Literal.push_back(*(SrcPos++));
+                    AppendToLastLiteral(m_Tokens.back().Literal, *(SrcPos++));
                     continue;
                 }
                 else
                 {
-                    NewToken.Type = TokenType::BitwiseOp;
-                    NewToken.Literal.push_back(*(SrcPos++));
+                    NewToken.Type    = TokenType::BitwiseOp;
+                    NewToken.Literal = MakeSlice(SrcPos, SrcPos + 1);
+                    ++SrcPos;
                 }
                 break;
 
@@ -1230,7 +1329,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
                     m_Tokens.back().Literal.length() == 1 && m_Tokens.back().Literal[0] == *SrcPos)
                 {
                     m_Tokens.back().Type = TokenType::BitwiseOp;
-                    m_Tokens.back().Literal.push_back(*(SrcPos++));
+                    AppendToLastLiteral(m_Tokens.back().Literal, *(SrcPos++));
                     continue;
                 }
                 else
@@ -1238,8 +1337,9 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
                     // Note: we do not distinguish between comparison operators
                     // and template arguments like in Texture2D<float> at this
                     // point. This will be clarified when textures are processed.
-                    NewToken.Type = TokenType::ComparisonOp;
-                    NewToken.Literal.push_back(*(SrcPos++));
+                    NewToken.Type    = TokenType::ComparisonOp;
+                    NewToken.Literal = MakeSlice(SrcPos, SrcPos + 1);
+                    ++SrcPos;
                 }
                 break;
 
@@ -1249,38 +1349,43 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
                     m_Tokens.back().Literal.length() == 1 && m_Tokens.back().Literal[0] == *SrcPos)
                 {
                     m_Tokens.back().Type = TokenType::IncDecOp;
-                    m_Tokens.back().Literal.push_back(*(SrcPos++));
+                    AppendToLastLiteral(m_Tokens.back().Literal, *(SrcPos++));
                     continue;
                 }
                 else
                 {
                     // We do not currently distinguish between math operator a + b,
                     // unary operator -a and numerical constant -1:
-                    NewToken.Literal.push_back(*(SrcPos++));
+                    NewToken.Literal = MakeSlice(SrcPos, SrcPos + 1);
+                    ++SrcPos;
                 }
                 break;
 
             case '~':
             case '^':
-                NewToken.Type = TokenType::BitwiseOp;
-                NewToken.Literal.push_back(*(SrcPos++));
+                NewToken.Type    = TokenType::BitwiseOp;
+                NewToken.Literal = MakeSlice(SrcPos, SrcPos + 1);
+                ++SrcPos;
                 break;
 
             case '*':
             case '/':
             case '%':
-                NewToken.Type = TokenType::MathOp;
-                NewToken.Literal.push_back(*(SrcPos++));
+                NewToken.Type    = TokenType::MathOp;
+                NewToken.Literal = MakeSlice(SrcPos, SrcPos + 1);
+                ++SrcPos;
                 break;
 
             case '!':
-                NewToken.Type = TokenType::BooleanOp;
-                NewToken.Literal.push_back(*(SrcPos++));
+                NewToken.Type    = TokenType::BooleanOp;
+                NewToken.Literal = MakeSlice(SrcPos, SrcPos + 1);
+                ++SrcPos;
                 break;
 
             case ',':
-                NewToken.Type = TokenType::Comma;
-                NewToken.Literal.push_back(*(SrcPos++));
+                NewToken.Type    = TokenType::Comma;
+                NewToken.Literal = MakeSlice(SrcPos, SrcPos + 1);
+                ++SrcPos;
                 break;
 
             case '"':
@@ -1290,8 +1395,12 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
                 ++SrcPos;
                 //[domain("quad")]
                 //         ^
-                while (SrcPos != Source.end() && *SrcPos != '"')
-                    NewToken.Literal.push_back(*(SrcPos++));
+                {
+                    auto StringStart = SrcPos;
+                    while (SrcPos != Source.end() && *SrcPos != '"')
+                        ++SrcPos;
+                    NewToken.Literal = MakeSlice(StringStart, SrcPos);
+                }
                 //[domain("quad")]
                 //             ^
                 if (SrcPos != Source.end())
@@ -1300,11 +1409,12 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
                 //              ^
                 break;
 
-#define BRACKET_CASE(Symbol, TokenType, Action)  \
-    case Symbol:                                 \
-        NewToken.Type = TokenType;               \
-        NewToken.Literal.push_back(*(SrcPos++)); \
-        Action;                                  \
+#define BRACKET_CASE(Symbol, TokenType, Action)           \
+    case Symbol:                                          \
+        NewToken.Type    = TokenType;                     \
+        NewToken.Literal = MakeSlice(SrcPos, SrcPos + 1); \
+        ++SrcPos;                                         \
+        Action;                                           \
         break;
 
                 BRACKET_CASE('(', TokenType::OpenBracket, ++OpenBracketCount);
@@ -1323,9 +1433,8 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
                 SkipIdentifier(Source, SrcPos);
                 if (IdentifierStartPos != SrcPos)
                 {
-                    auto IDSize = SrcPos - IdentifierStartPos;
-                    NewToken.Literal.reserve(IDSize);
-                    NewToken.Literal.append(IdentifierStartPos, SrcPos);
+                    NewToken.Literal = MakeSlice(IdentifierStartPos, SrcPos);
+                    // The slice is null-terminated, so it can be used to search the hash map directly
                     auto KeywordIt = m_Converter.m_HLSLKeywords.find(NewToken.Literal.c_str());
                     if (KeywordIt != m_Converter.m_HLSLKeywords.end())
                     {
@@ -1348,22 +1457,26 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
                     }
                     if (bIsNumericalCostant)
                     {
-                        ReadNumericConstant(Source, SrcPos, NewToken.Literal);
-                        NewToken.Type = TokenType::NumericConstant;
+                        auto NumberStart = SrcPos;
+                        SkipNumericConstant(Source, SrcPos);
+                        NewToken.Literal = MakeSlice(NumberStart, SrcPos);
+                        NewToken.Type    = TokenType::NumericConstant;
                     }
                 }
 
                 if (NewToken.Type == TokenType::Undefined)
                 {
-                    NewToken.Literal.push_back(*(SrcPos++));
+                    NewToken.Literal = MakeSlice(SrcPos, SrcPos + 1);
+                    ++SrcPos;
                 }
                 // Operators
                 // https://msdn.microsoft.com/en-us/library/windows/desktop/bb509631(v=vs.85).aspx
             }
         }
 
-        m_Tokens.push_back(NewToken);
+        m_Tokens.push_back(std::move(NewToken));
     }
+    VERIFY_EXPR(ArenaPos <= m_TokenArena.get() + Source.length() * 2 + 1);
 #undef CHECK_END
 }
 
@@ -1672,7 +1785,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ParseSamplers(TokenListType::iter
                 const auto& SamplerName = Token->Literal;
 
                 // Add sampler state into the hash map
-                SamplersHash.insert(std::make_pair(SamplerName, bIsComparison));
+                SamplersHash.insert(std::make_pair(SamplerName.str(), bIsComparison));
 
                 ++Token;
                 // SamplerState LinearClamp ;
@@ -1901,13 +2014,13 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessTextureDeclaration(TokenLi
         {
             // RWTexture2D<float /* format = r32f */ >
             //                                       ^
-            ParseImageFormat(Token->Delimiter, ImgFormat);
+            ParseImageFormat(Token->Delimiter.str(), ImgFormat);
             if (ImgFormat.length() == 0)
             {
                 // RWTexture2D</* format = r32f */ float >
                 //                                 ^
                 //                            TexFmtToken
-                ParseImageFormat(TexFmtToken->Delimiter, ImgFormat);
+                ParseImageFormat(TexFmtToken->Delimiter.str(), ImgFormat);
             }
 
             if (ImgFormat.length() != 0)
@@ -1992,7 +2105,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessTextureDeclaration(TokenLi
         if (!IsRWTexture)
         {
             // Try to find matching sampler
-            auto SamplerName = TextureName + SamplerSuffix;
+            auto SamplerName = TextureName.str() + SamplerSuffix;
             // Search all scopes starting with the innermost
             for (auto ScopeIt = Samplers.rbegin(); ScopeIt != Samplers.rend(); ++ScopeIt)
             {
@@ -2026,7 +2139,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessTextureDeclaration(TokenLi
                 TexDeclToken->Literal.append("IMAGE_WRITEONLY "); // defined as 'writeonly' on GLES and as '' on desktop in GLSLDefinitions.h
         }
         TexDeclToken->Literal.append(CompleteGLSLSampler);
-        Objects.m.insert(std::make_pair(HashMapStringKey(TextureName), HLSLObjectInfo(CompleteGLSLSampler, NumComponents)));
+        Objects.m.insert(std::make_pair(HashMapStringKey(TextureName.c_str(), true), HLSLObjectInfo(CompleteGLSLSampler, NumComponents)));
 
         // In global scope, multiple variables can be declared in the same statement
         if (IsGlobalScope)
@@ -2099,11 +2212,11 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessTextureDeclaration(TokenLi
 
 
 // Finds an HLSL object with the given name in object stack
-const HLSL2GLSLConverterImpl::HLSLObjectInfo* HLSL2GLSLConverterImpl::ConversionStream::FindHLSLObject(const String& Name)
+const HLSL2GLSLConverterImpl::HLSLObjectInfo* HLSL2GLSLConverterImpl::ConversionStream::FindHLSLObject(const Char* Name)
 {
     for (auto ScopeIt = m_Objects.rbegin(); ScopeIt != m_Objects.rend(); ++ScopeIt)
     {
-        auto It = ScopeIt->m.find(Name.c_str());
+        auto It = ScopeIt->m.find(Name);
         if (It != ScopeIt->m.end())
             return &It->second;
     }
@@ -2177,7 +2290,7 @@ bool HLSL2GLSLConverterImpl::ConversionStream::ProcessObjectMethod(TokenListType
     // IdentifierToken
 
     // Try to find identifier
-    const auto* pObjectInfo = FindHLSLObject(IdentifierToken->Literal);
+    const auto* pObjectInfo = FindHLSLObject(IdentifierToken->Literal.c_str());
     if (pObjectInfo == nullptr)
     {
         return false;
@@ -2499,7 +2612,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessRWTextures(const TokenList
         if (Token->Type == TokenType::Identifier)
         {
             // Try to find the object in all scopes
-            const auto* pObjectInfo = FindHLSLObject(Token->Literal);
+            const auto* pObjectInfo = FindHLSLObject(Token->Literal.c_str());
             if (pObjectInfo == nullptr)
             {
                 ++Token;
@@ -2563,7 +2676,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessAtomics(const TokenListTyp
             ++Token;
             VERIFY_PARSER_STATE(Token, Token != ScopeEnd, "Unexpected EOF");
 
-            const auto* pObjectInfo = FindHLSLObject(Token->Literal);
+            const auto* pObjectInfo = FindHLSLObject(Token->Literal.c_str());
             if (pObjectInfo != nullptr)
             {
                 // InterlockedAdd(Tex2D[GTid.xy], 1, iOldVal);
@@ -2637,14 +2750,14 @@ void HLSL2GLSLConverterImpl::ConversionStream::ParseShaderParameter(TokenListTyp
     VERIFY_PARSER_STATE(Token, Token->IsBuiltInType() || Token->Type == TokenType::Identifier,
                         "Missing argument type");
     auto TypeToken = Token;
-    ParamInfo.Type = Token->Literal;
+    ParamInfo.Type = Token->Literal.str();
 
     ++Token;
     //          out float4 Color : SV_Target,
     //                     ^
     VERIFY_PARSER_STATE(Token, Token != m_Tokens.end(), "Unexpected EOF while parsing argument list");
     VERIFY_PARSER_STATE(Token, Token->Type == TokenType::Identifier, "Missing argument name after ", ParamInfo.Type);
-    ParamInfo.Name = Token->Literal;
+    ParamInfo.Name = Token->Literal.str();
 
     ++Token;
     VERIFY_PARSER_STATE(Token, Token != m_Tokens.end(), "Unexpected EOF");
@@ -2656,8 +2769,8 @@ void HLSL2GLSLConverterImpl::ConversionStream::ParseShaderParameter(TokenListTyp
         ProcessScope(
             Token, m_Tokens.end(), TokenType::OpenStaple, TokenType::ClosingStaple,
             [&](TokenListType::iterator& tkn, int) {
-                ParamInfo.ArraySize.append(tkn->Delimiter);
-                ParamInfo.ArraySize.append(tkn->Literal);
+                ParamInfo.ArraySize += tkn->Delimiter;
+                ParamInfo.ArraySize += tkn->Literal;
                 ++tkn;
             } //
         );
@@ -2685,7 +2798,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ParseShaderParameter(TokenListTyp
             VERIFY_PARSER_STATE(Token, Token != m_Tokens.end(), "Unexpected end of file while looking for semantic for argument \"", ParamInfo.Name, '\"');
             VERIFY_PARSER_STATE(Token, Token->Type == TokenType::Identifier, "Missing semantic for argument \"", ParamInfo.Name, '\"');
             // Transform to lower case -  semantics are case-insensitive
-            ParamInfo.Semantic = StrToLower(Token->Literal);
+            ParamInfo.Semantic = StrToLower(Token->Literal.str());
 
             ++Token;
             //          out float4 Color : SV_Target,
@@ -2749,8 +2862,8 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessFunctionParameters(TokenLi
     if (!bIsVoid)
     {
         ShaderParameterInfo RetParam;
-        RetParam.Type             = TypeToken->Literal;
-        RetParam.Name             = FuncNameToken->Literal;
+        RetParam.Type             = TypeToken->Literal.str();
+        RetParam.Name             = FuncNameToken->Literal.str();
         RetParam.storageQualifier = ShaderParameterInfo::StorageQualifier::Ret;
         Params.push_back(RetParam);
     }
@@ -2924,7 +3037,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessFunctionParameters(TokenLi
                     //                                   ^
                     VERIFY_PARSER_STATE(TmpToken, TmpToken != m_Tokens.end() && TmpToken->Type == TokenType::NumericConstant, "Numeric constant expected");
 
-                    ParamInfo.ArraySize     = TmpToken->Literal;
+                    ParamInfo.ArraySize     = TmpToken->Literal.str();
                     auto NumCtrlPointsToken = TmpToken;
                     ++TmpToken;
                     VERIFY_PARSER_STATE(TmpToken, TmpToken != m_Tokens.end() && TmpToken->Literal == ">", "Angle bracket expected");
@@ -2974,7 +3087,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessFunctionParameters(TokenLi
             VERIFY_PARSER_STATE(SemanticToken, SemanticToken != m_Tokens.end(), "Unexpected EOF");
             VERIFY_PARSER_STATE(SemanticToken, SemanticToken->Type == TokenType::Identifier, "Exepcted semantic for the return argument ");
             // Transform to lower case -  semantics are case-insensitive
-            RetParam.Semantic = StrToLower(SemanticToken->Literal);
+            RetParam.Semantic = StrToLower(SemanticToken->Literal.str());
             ++SemanticToken;
             // float4 TestPS  ( in VSOutput In ) : SV_Target
             // {
@@ -3687,8 +3800,9 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessShaderAttributes(TokenList
         VERIFY_PARSER_STATE(TmpToken, TmpToken != m_Tokens.end() && TmpToken->Type == TokenType::Identifier, "Identifier expected");
         // [domain("quad")]
         //  ^
-        auto& Attrib = TmpToken->Literal;
+        auto Attrib = TmpToken->Literal.str();
         StrToLowerInPlace(Attrib);
+        TmpToken->Literal = Attrib;
 
         ++TmpToken;
         VERIFY_PARSER_STATE(TmpToken, TmpToken != m_Tokens.end() && TmpToken->Type == TokenType::OpenBracket, "\'(\' expected");
@@ -3697,8 +3811,8 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessShaderAttributes(TokenList
             TmpToken, m_Tokens.end(), TokenType::OpenBracket, TokenType::ClosingBracket,
             [&](TokenListType::iterator& tkn, int) //
             {
-                AttribValue.append(tkn->Delimiter);
-                AttribValue.append(tkn->Literal);
+                AttribValue += tkn->Delimiter;
+                AttribValue += tkn->Literal;
                 ++tkn;
             } //
         );
@@ -4004,7 +4118,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessDomainShaderArguments(Toke
     // ^
 
     std::unordered_map<HashMapStringKey, String, HashMapStringKey::Hasher> Attributes;
-    ParseAttributesInComment(TypeToken->Delimiter, Attributes);
+    ParseAttributesInComment(TypeToken->Delimiter.str(), Attributes);
     ProcessShaderAttributes(Token, Attributes);
 
     stringstream GlobalsSS;
@@ -4544,7 +4658,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::RemoveSpecialShaderAttributes()
                 // void CS(uint3 ThreadId  : SV_DispatchThreadID)
                 // ^
                 if (Token != m_Tokens.end())
-                    Token->Delimiter = OpenStaple->Delimiter + Token->Delimiter;
+                    Token->Delimiter = OpenStaple->Delimiter.str() + Token->Delimiter;
                 m_Tokens.erase(OpenStaple, Token);
             }
             else
@@ -4555,11 +4669,16 @@ void HLSL2GLSLConverterImpl::ConversionStream::RemoveSpecialShaderAttributes()
 
 String HLSL2GLSLConverterImpl::ConversionStream::BuildGLSLSource()
 {
+    size_t OutputSize = 0;
+    for (const auto& Token : m_Tokens)
+        OutputSize += Token.Delimiter.length() + Token.Literal.length();
+
     String Output;
+    Output.reserve(OutputSize);
     for (const auto& Token : m_Tokens)
     {
-        Output.append(Token.Delimiter);
-        Output.append(Token.Literal);
+        Output += Token.Delimiter;
+        Output += Token.Literal;
     }
     return Output;
 }
@@ -4573,6 +4692,7 @@ HLSL2GLSLConverterImpl::ConversionStream::ConversionStream(IReferenceCounters*
                                                            bool                             bPreserveTokens) :
     // clang-format off
     TBase            {pRefCounters   },
+    m_Tokens         {TokenNodeAllocator<TokenInfo>{m_TokenNodePool}},
     m_bPreserveTokens{bPreserveTokens},
     m_Converter      {Converter      },
     m_InputFileName  {InputFileName != nullptr ? InputFileName : "<Unknown>"}
@@ -4598,11 +4718,12 @@ HLSL2GLSLConverterImpl::ConversionStream::ConversionStream(IReferenceCounters*
         NumSymbols = pFileData->GetSize();
     }
 
-    String Source(HLSLSource, NumSymbols);
+    m_Source.assign(HLSLSource, NumSymbols);
 
-    InsertIncludes(Source, pInputStreamFactory);
+    InsertIncludes(m_Source, pInputStreamFactory);
 
-    Tokenize(Source);
+    m_SourceLength = m_Source.length();
+    m_SourceHash   = ComputeFNVHash(m_Source.c_str(), m_SourceLength);
 }
 
 
@@ -4646,6 +4767,57 @@ String HLSL2GLSLConverterImpl::Convert(ConversionAttribs& Attribs) const
     }
 }
 
+std::vector<String> HLSL2GLSLConverterImpl::ConvertBatch(const ConversionAttribs* pAttribs, size_t NumShaders, Uint32 NumThreads) const
+{
+    std::vector<String> GLSLSources(NumShaders);
+    if (NumShaders == 0)
+        return GLSLSources;
+
+    VERIFY_EXPR(pAttribs != nullptr);
+
+    if (NumThreads == 0)
+        NumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    NumThreads = static_cast<Uint32>(std::min(size_t{NumThreads}, NumShaders));
+
+    // Shaders are distributed between the threads dynamically, as conversion time
+    // varies substantially between shaders
+    std::atomic<size_t> NextShader{0};
+
+    auto ConvertShaders = [&]() {
+        for (auto i = NextShader.fetch_add(1); i < NumShaders; i = NextShader.fetch_add(1))
+        {
+            auto Attribs = pAttribs[i];
+            DEV_CHECK_ERR(Attribs.ppConversionStream == nullptr, "Conversion streams are not thread-safe and can't be used by ConvertBatch()");
+            Attribs.ppConversionStream = nullptr;
+
+            // Exceptions must not leave the worker threads. A shader that fails
+            // to convert produces an empty result and does not affect other shaders.
+            try
+            {
+                GLSLSources[i] = Convert(Attribs);
+            }
+            catch (...)
+            {
+                LOG_ERROR_MESSAGE("Failed to convert shader '", (Attribs.InputFileName != nullptr ? Attribs.InputFileName : "<Unknown>"), "'");
+                GLSLSources[i].clear();
+            }
+        }
+    };
+
+    std::vector<std::thread> WorkerThreads;
+    WorkerThreads.reserve(NumThreads - 1);
+    for (Uint32 t = 1; t < NumThreads; ++t)
+        WorkerThreads.emplace_back(ConvertShaders);
+
+    // The calling thread converts shaders too
+    ConvertShaders();
+
+    for (auto& Thread : WorkerThreads)
+        Thread.join();
+
+    return GLSLSources;
+}
+
 void HLSL2GLSLConverterImpl::CreateStream(const Char*                      InputFileName,
                                           IShaderSourceInputStreamFactory* pSourceStreamFactory,
                                           const Char*                      HLSLSource,
@@ -4687,9 +4859,39 @@ String HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
                                                          bool        IncludeDefintions,
                                                          const char* SamplerSuffix,
                                                          bool        UseInOutLocationQualifiers)
+{
+    auto& Cache    = m_Converter.GetConversionCache();
+    auto  CacheKey = Cache.MakeKey(m_SourceHash, m_SourceLength, EntryPoint, ShaderType, SamplerSuffix, UseInOutLocationQualifiers);
+
+    String GLSLSource;
+    if (!Cache.Find(CacheKey, GLSLSource))
+    {
+        if (!m_bTokenized)
+        {
+            Tokenize(m_Source);
+            m_bTokenized = true;
+            // Tokens do not reference the source
+            String{}.swap(m_Source);
+        }
+
+        GLSLSource = ConvertTokens(EntryPoint, ShaderType, SamplerSuffix, UseInOutLocationQualifiers);
+        // Definitions are not part of the key and are not stored in the cache
+        Cache.Add(CacheKey, GLSLSource);
+    }
+
+    if (IncludeDefintions)
+        GLSLSource.insert(0, g_GLSLDefinitions);
+
+    return GLSLSource;
+}
+
+String HLSL2GLSLConverterImpl::ConversionStream::ConvertTokens(const Char* EntryPoint,
+                                                               SHADER_TYPE ShaderType,
+                                                               const char* SamplerSuffix,
+                                                               bool        UseInOutLocationQualifiers)
 {
     m_bUseInOutLocationQualifiers = UseInOutLocationQualifiers;
-    TokenListType TokensCopy(m_bPreserveTokens ? m_Tokens : TokenListType());
+    TokenListType TokensCopy(m_bPreserveTokens ? m_Tokens : TokenListType{m_Tokens.get_allocator()});
 
     Uint32 ShaderStorageBlockBinding = 0;
     Uint32 ImageBinding              = 0;
@@ -4922,9 +5124,6 @@ String HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
         m_Objects.clear();
     }
 
-    if (IncludeDefintions)
-        GLSLSource.insert(0, g_GLSLDefinitions);
-
     return GLSLSource;
 }
 
@@ -43,4 +43,41 @@ void HLSL2GLSLConverterObject::CreateStream(const Char*                      Inp
     Converter.CreateStream(InputFileName, pSourceStreamFactory, HLSLSource, NumSymbols, ppStream);
 }
 
+void HLSL2GLSLConverterObject::ConvertBatch(const HLSL2GLSLBatchShaderDesc* pShaders,
+                                            Uint32                          NumShaders,
+                                            Uint32                          NumThreads,
+                                            IDataBlob**                     ppGLSLSources) const
+{
+    DEV_CHECK_ERR(NumShaders == 0 || (pShaders != nullptr && ppGLSLSources != nullptr), "pShaders and ppGLSLSources must not be null");
+
+    std::vector<HLSL2GLSLConverterImpl::ConversionAttribs> Attribs(NumShaders);
+    for (Uint32 i = 0; i < NumShaders; ++i)
+    {
+        const auto& Shader = pShaders[i];
+        auto&       Attr   = Attribs[i];
+
+        Attr.pSourceStreamFactory       = Shader.pSourceStreamFactory;
+        Attr.HLSLSource                 = Shader.HLSLSource;
+        Attr.NumSymbols                 = Shader.NumSymbols;
+        Attr.EntryPoint                 = Shader.EntryPoint;
+        Attr.ShaderType                 = Shader.ShaderType;
+        Attr.IncludeDefinitions         = Shader.IncludeDefinitions;
+        Attr.InputFileName              = Shader.InputFileName;
+        Attr.SamplerSuffix              = Shader.SamplerSuffix;
+        Attr.UseInOutLocationQualifiers = Shader.UseInOutLocationQualifiers;
+    }
+
+    const auto& Converter   = HLSL2GLSLConverterImpl::GetInstance();
+    auto        GLSLSources = Converter.ConvertBatch(Attribs.data(), Attribs.size(), NumThreads);
+    for (Uint32 i = 0; i < NumShaders; ++i)
+    {
+        ppGLSLSources[i] = nullptr;
+        if (GLSLSources[i].empty())
+            continue;
+
+        auto* pDataBlob = MakeNewRCObj<StringDataBlobImpl>()(std::move(GLSLSources[i]));
+        pDataBlob->QueryInterface(IID_DataBlob, reinterpret_cast<IObject**>(&ppGLSLSources[i]));
+    }
+}
+
 } // namespace Diligent
@@ -0,0 +1,472 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+// ShaderArchiver compiles shader permutations and packs them into the shader archive
+// that is loaded through ShaderCreateInfo::pShaderArchive. See readme.md for details.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include "ShaderArchive.hpp"
+#include "CachingShaderSourceStreamFactory.hpp"
+#include "GLSLSourceBuilder.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "FileWrapper.hpp"
+#include "DataBlob.h"
+#include "DeviceCaps.h"
+#include "GraphicsAccessories.hpp"
+
+#if SPIRV_SUPPORTED
+#    include "SPIRVUtils.hpp"
+#endif
+
+using namespace Diligent;
+
+namespace
+{
+
+struct CompileJob
+{
+    std::string            FilePath;
+    SHADER_TYPE            ShaderType     = SHADER_TYPE_UNKNOWN;
+    SHADER_SOURCE_LANGUAGE SourceLanguage = SHADER_SOURCE_LANGUAGE_HLSL;
+    std::string            EntryPoint;
+
+    std::vector<std::pair<std::string, std::string>> Macros;
+};
+
+struct CompileResult
+{
+    bool                Succeeded = false;
+    std::vector<Uint32> SPIRV;
+    std::string         GLSL;
+    std::string         Errors;
+};
+
+struct ArchiverSettings
+{
+    std::string OutputPath;
+    std::string SearchDirectories;
+    Uint32      NumThreads   = 0;
+    bool        CompileSPIRV = true;
+    bool        BuildGLSL    = true;
+
+    // GL version the GLSL source is built for
+    Uint32 GLMajorVersion = 4;
+    Uint32 GLMinorVersion = 3;
+};
+
+// Must be the same definitions as the ones ShaderVkImpl adds
+static constexpr char VulkanDefine[] =
+    "#ifndef VULKAN\n"
+    "#   define VULKAN 1\n"
+    "#endif\n";
+
+void PrintUsage()
+{
+    printf("Usage: ShaderArchiver -o <archive> [options] <permutation file> [<permutation file> ...]\n"
+           "Options:\n"
+           "  -o <archive>  Output archive file\n"
+           "  -I <dirs>     Shader search directories separated by ';'\n"
+           "  -j <N>        Number of compilation threads (default: number of hardware threads)\n"
+           "  --no-spirv    Do not compile SPIRV byte code\n"
+           "  --no-glsl     Do not build GLSL source\n"
+           "  --gl <M.m>    GL version to build GLSL source for (default: 4.3)\n");
+}
+
+// GLSL source is built for desktop GL on the host platform. Features are the ones
+// RenderDeviceGLImpl reports for the core profile of the given version.
+DeviceCaps GetGLSLTargetCaps(const ArchiverSettings& Settings)
+{
+    DeviceCaps GLCaps;
+    GLCaps.DevType      = RENDER_DEVICE_TYPE_GL;
+    GLCaps.MajorVersion = static_cast<Int32>(Settings.GLMajorVersion);
+    GLCaps.MinorVersion = static_cast<Int32>(Settings.GLMinorVersion);
+
+    const bool IsGL43OrAbove = Settings.GLMajorVersion > 4 || (Settings.GLMajorVersion == 4 && Settings.GLMinorVersion >= 3);
+
+    GLCaps.Features.SeparablePrograms     = True;
+    GLCaps.Features.ComputeShaders        = IsGL43OrAbove;
+    GLCaps.TexCaps.CubemapArraysSupported = IsGL43OrAbove;
+    GLCaps.TexCaps.Texture2DMSSupported   = IsGL43OrAbove;
+    return GLCaps;
+}
+
+SHADER_TYPE ParseShaderType(const std::string& Type)
+{
+    // clang-format off
+    if (Type == "vs") return SHADER_TYPE_VERTEX;
+    if (Type == "ps") return SHADER_TYPE_PIXEL;
+    if (Type == "gs") return SHADER_TYPE_GEOMETRY;
+    if (Type == "hs") return SHADER_TYPE_HULL;
+    if (Type == "ds") return SHADER_TYPE_DOMAIN;
+    if (Type == "cs") return SHADER_TYPE_COMPUTE;
+    // clang-format on
+    return SHADER_TYPE_UNKNOWN;
+}
+
+SHADER_SOURCE_LANGUAGE GetSourceLanguage(const std::string& FilePath)
+{
+    auto DotPos = FilePath.rfind('.');
+    if (DotPos == std::string::npos)
+        return SHADER_SOURCE_LANGUAGE_HLSL;
+
+    const auto Ext = FilePath.substr(DotPos + 1);
+    for (const auto* GLSLExt : {"glsl", "vert", "frag", "geom", "tesc", "tese", "comp"})
+    {
+        if (Ext == GLSLExt)
+            return SHADER_SOURCE_LANGUAGE_GLSL;
+    }
+    return SHADER_SOURCE_LANGUAGE_HLSL;
+}
+
+// Every line of the permutation file describes a shader and its permutation matrix:
+//
+//   <file> <vs|ps|gs|hs|ds|cs> <entry point> [MACRO=value1,value2,...] ...
+//
+// A job is generated for every combination of macro values.
+bool ParsePermutationFile(const char* Path, std::vector<CompileJob>& Jobs)
+{
+    std::ifstream File{Path};
+    if (!File)
+    {
+        printf("Failed to open permutation file '%s'\n", Path);
+        return false;
+    }
+
+    std::string Line;
+    int         LineNum = 0;
+    while (std::getline(File, Line))
+    {
+        ++LineNum;
+        const auto CommentPos = Line.find('#');
+        if (CommentPos != std::string::npos)
+            Line.erase(CommentPos);
+
+        std::istringstream       LineSS{Line};
+        std::vector<std::string> Tokens;
+        for (std::string Token; LineSS >> Token;)
+            Tokens.push_back(Token);
+        if (Tokens.empty())
+            continue;
+
+        if (Tokens.size() < 3)
+        {
+            printf("%s(%d): expected '<file> <shader type> <entry point> [MACRO=values]...'\n", Path, LineNum);
+            return false;
+        }
+
+        CompileJob Job;
+        Job.FilePath       = Tokens[0];
+        Job.ShaderType     = ParseShaderType(Tokens[1]);
+        Job.SourceLanguage = GetSourceLanguage(Job.FilePath);
+        Job.EntryPoint     = Tokens[2];
+        if (Job.ShaderType == SHADER_TYPE_UNKNOWN)
+        {
+            printf("%s(%d): unknown shader type '%s'\n", Path, LineNum, Tokens[1].c_str());
+            return false;
+        }
+
+        // Macro names and lists of their values
+        std::vector<std::pair<std::string, std::vector<std::string>>> Matrix;
+        for (size_t i = 3; i < Tokens.size(); ++i)
+        {
+            const auto EqPos = Tokens[i].find('=');
+            if (EqPos == std::string::npos || EqPos == 0)
+            {
+                printf("%s(%d): invalid macro definition '%s'\n", Path, LineNum, Tokens[i].c_str());
+                return false;
+            }
+
+            std::vector<std::string> Values;
+            std::istringstream       ValuesSS{Tokens[i].substr(EqPos + 1)};
+            for (std::string Value; std::getline(ValuesSS, Value, ',');)
+                Values.push_back(Value);
+            if (Values.empty())
+                Values.emplace_back();
+            Matrix.emplace_back(Tokens[i].substr(0, EqPos), std::move(Values));
+        }
+
+        // Enumerate all combinations
+        std::vector<size_t> Indices(Matrix.size(), 0);
+        while (true)
+        {
+            Job.Macros.clear();
+            for (size_t m = 0; m < Matrix.size(); ++m)
+                Job.Macros.emplace_back(Matrix[m].first, Matrix[m].second[Indices[m]]);
+            Jobs.push_back(Job);
+
+            size_t m = 0;
+            for (; m < Matrix.size(); ++m)
+            {
+                if (++Indices[m] < Matrix[m].second.size())
+                    break;
+                Indices[m] = 0;
+            }
+            if (m == Matrix.size())
+                break;
+        }
+    }
+
+    return true;
+}
+
+std::string GetCompilerMessages(IDataBlob* pOutput)
+{
+    // The first null-terminated string in the blob is the compiler output
+    return pOutput != nullptr ? std::string{static_cast<const char*>(pOutput->GetDataPtr())} : std::string{};
+}
+
+void CompilePermutation(const CompileJob&                Job,
+                        IShaderSourceInputStreamFactory* pStreamFactory,
+                        const ArchiverSettings&          Settings,
+                        CompileResult&                   Result)
+{
+    std::vector<ShaderMacro> Macros;
+    for (const auto& Macro : Job.Macros)
+        Macros.emplace_back(Macro.first.c_str(), Macro.second.c_str());
+    Macros.emplace_back(nullptr, nullptr);
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.FilePath                   = Job.FilePath.c_str();
+    ShaderCI.pShaderSourceStreamFactory = pStreamFactory;
+    ShaderCI.EntryPoint                 = Job.EntryPoint.c_str();
+    ShaderCI.Macros                     = Macros.data();
+    ShaderCI.SourceLanguage             = Job.SourceLanguage;
+    ShaderCI.UseCombinedTextureSamplers = true;
+    ShaderCI.Desc.Name                  = Job.FilePath.c_str();
+    ShaderCI.Desc.ShaderType            = Job.ShaderType;
+
+    try
+    {
+        if (Settings.BuildGLSL)
+        {
+            Result.GLSL = BuildGLSLSourceString(ShaderCI, GetGLSLTargetCaps(Settings), TargetGLSLCompiler::driver);
+        }
+
+#if SPIRV_SUPPORTED
+        if (Settings.CompileSPIRV)
+        {
+            RefCntAutoPtr<IDataBlob> pOutput;
+            if (Job.SourceLanguage == SHADER_SOURCE_LANGUAGE_HLSL)
+            {
+                Result.SPIRV = HLSLtoSPIRV(ShaderCI, VulkanDefine, &pOutput);
+            }
+            else
+            {
+                DeviceCaps VkCaps;
+                VkCaps.DevType = RENDER_DEVICE_TYPE_VULKAN;
+
+                const auto GLSLSource = BuildGLSLSourceString(ShaderCI, VkCaps, TargetGLSLCompiler::glslang, VulkanDefine);
+                Result.SPIRV          = GLSLtoSPIRV(Job.ShaderType, GLSLSource.c_str(), static_cast<int>(GLSLSource.length()), &pOutput);
+            }
+
+            if (Result.SPIRV.empty())
+            {
+                Result.Errors = GetCompilerMessages(pOutput);
+                return;
+            }
+        }
+#endif
+        Result.Succeeded = true;
+    }
+    catch (const std::runtime_error& err)
+    {
+        Result.Errors = err.what();
+    }
+}
+
+std::string GetPermutationName(const CompileJob& Job)
+{
+    std::string Name = Job.FilePath + " (" + GetShaderTypeLiteralName(Job.ShaderType) + ", " + Job.EntryPoint;
+    for (const auto& Macro : Job.Macros)
+        Name += ", " + Macro.first + '=' + Macro.second;
+    return Name + ')';
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    ArchiverSettings         Settings;
+    std::vector<const char*> PermutationFiles;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* Arg = argv[i];
+        if (strcmp(Arg, "-o") == 0 && i + 1 < argc)
+            Settings.OutputPath = argv[++i];
+        else if (strcmp(Arg, "-I") == 0 && i + 1 < argc)
+            Settings.SearchDirectories = argv[++i];
+        else if (strcmp(Arg, "-j") == 0 && i + 1 < argc)
+            Settings.NumThreads = static_cast<Uint32>(atoi(argv[++i]));
+        else if (strcmp(Arg, "--no-spirv") == 0)
+            Settings.CompileSPIRV = false;
+        else if (strcmp(Arg, "--no-glsl") == 0)
+            Settings.BuildGLSL = false;
+        else if (strcmp(Arg, "--gl") == 0 && i + 1 < argc)
+        {
+            unsigned int Major = 0, Minor = 0;
+            if (sscanf(argv[++i], "%u.%u", &Major, &Minor) != 2 || Major < 3)
+            {
+                printf("Invalid GL version '%s'\n", argv[i]);
+                PrintUsage();
+                return -1;
+            }
+            Settings.GLMajorVersion = Major;
+            Settings.GLMinorVersion = Minor;
+        }
+        else if (Arg[0] == '-')
+        {
+            printf("Unknown option '%s'\n", Arg);
+            PrintUsage();
+            return -1;
+        }
+        else
+            PermutationFiles.push_back(Arg);
+    }
+
+    if (Settings.OutputPath.empty() || PermutationFiles.empty())
+    {
+        PrintUsage();
+        return -1;
+    }
+
+#if !SPIRV_SUPPORTED
+    if (Settings.CompileSPIRV)
+    {
+        printf("ShaderArchiver was built without glslang: SPIRV byte code will not be compiled\n");
+        Settings.CompileSPIRV = false;
+    }
+#endif
+
+    std::vector<CompileJob> Jobs;
+    for (const auto* File : PermutationFiles)
+    {
+        if (!ParsePermutationFile(File, Jobs))
+            return -1;
+    }
+
+    if (Settings.NumThreads == 0)
+        Settings.NumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    Settings.NumThreads = std::min(Settings.NumThreads, static_cast<Uint32>(std::max(Jobs.size(), size_t{1})));
+
+#if SPIRV_SUPPORTED
+    if (Settings.CompileSPIRV)
+        InitializeGlslang();
+#endif
+
+    {
+        // The factory caches every source file, so that it is only read once for all permutations
+        RefCntAutoPtr<IShaderSourceInputStreamFactory> pStreamFactory{
+            MakeNewRCObj<CachingShaderSourceStreamFactory>()(Settings.SearchDirectories.c_str())};
+
+        std::vector<CompileResult> Results(Jobs.size());
+        std::atomic<size_t>        NextJob{0};
+
+        std::vector<std::thread> Threads;
+        for (Uint32 t = 0; t < Settings.NumThreads; ++t)
+        {
+            Threads.emplace_back([&]() {
+                for (size_t JobIdx = NextJob.fetch_add(1); JobIdx < Jobs.size(); JobIdx = NextJob.fetch_add(1))
+                    CompilePermutation(Jobs[JobIdx], pStreamFactory, Settings, Results[JobIdx]);
+            });
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        // Results are added in the order of the jobs, so that the archive does not depend on thread scheduling
+        ShaderArchiveWriter Writer;
+        size_t              NumFailed = 0;
+        if (Settings.BuildGLSL)
+            Writer.SetGLSLTarget(GetShaderArchiveGLSLTarget(GetGLSLTargetCaps(Settings)));
+        for (size_t i = 0; i < Jobs.size(); ++i)
+        {
+            const auto& Job    = Jobs[i];
+            const auto& Result = Results[i];
+            if (!Result.Succeeded)
+            {
+                printf("Failed to compile %s:\n%s\n", GetPermutationName(Job).c_str(), Result.Errors.c_str());
+                ++NumFailed;
+                continue;
+            }
+
+            std::vector<ShaderMacro> Macros;
+            for (const auto& Macro : Job.Macros)
+                Macros.emplace_back(Macro.first.c_str(), Macro.second.c_str());
+            Macros.emplace_back(nullptr, nullptr);
+
+            ShaderCreateInfo ShaderCI;
+            ShaderCI.FilePath        = Job.FilePath.c_str();
+            ShaderCI.EntryPoint      = Job.EntryPoint.c_str();
+            ShaderCI.Macros          = Macros.data();
+            ShaderCI.Desc.ShaderType = Job.ShaderType;
+
+            if (!Writer.AddShader(ShaderCI, Result.SPIRV, Result.GLSL))
+                printf("Permutation %s is listed more than once\n", GetPermutationName(Job).c_str());
+        }
+
+        if (NumFailed != 0)
+        {
+            printf("%u of %u permutations failed to compile\n", static_cast<Uint32>(NumFailed), static_cast<Uint32>(Jobs.size()));
+#if SPIRV_SUPPORTED
+            if (Settings.CompileSPIRV)
+                FinalizeGlslang();
+#endif
+            return -1;
+        }
+
+        std::vector<Uint8> ArchiveData;
+        Writer.Serialize(ArchiveData);
+
+        FileWrapper File{Settings.OutputPath.c_str(), EFileAccessMode::Overwrite};
+        if (!File || !File->Write(ArchiveData.data(), ArchiveData.size()))
+        {
+            printf("Failed to write archive '%s'\n", Settings.OutputPath.c_str());
+            return -1;
+        }
+
+        const auto& Stats = Writer.GetStatistics();
+        printf("ShaderArchiver: %u permutations, %u unique blobs (%u duplicates removed, %u of %u bytes stored). Archive size: %u bytes\n",
+               Stats.NumShaders, Stats.NumBlobs, Stats.NumDuplicateBlobs,
+               static_cast<Uint32>(Stats.UniqueBlobSize), static_cast<Uint32>(Stats.TotalBlobSize),
+               static_cast<Uint32>(ArchiveData.size()));
+    }
+
+#if SPIRV_SUPPORTED
+    if (Settings.CompileSPIRV)
+        FinalizeGlslang();
+#endif
+
+    return 0;
+}
@@ -87,9 +87,15 @@ public:
     static bool FileExists(const Diligent::Char* strFilePath);
     static bool PathExists(const Diligent::Char* strPath);
 
+    static bool GetFileTimestamp(const Diligent::Char* strFilePath, Diligent::Uint64& Timestamp);
+
     static bool CreateDirectory(const Diligent::Char* strPath);
     static void ClearDirectory(const Diligent::Char* strPath);
     static void DeleteFile(const Diligent::Char* strPath);
 
     static std::vector<std::unique_ptr<FindFileData>> Search(const Diligent::Char* SearchPattern);
+
+    /// Reads the entire file. Files are looked up the same way as OpenFile() does, including
+    /// the assets in the APK, which can't be mapped with mmap.
+    static std::unique_ptr<BasicMappedFile> MapFile(const Diligent::Char* strFilePath);
 };
@@ -22,6 +22,7 @@
  */
 
 #include <string>
+#include <sys/stat.h>
 #include <android/native_activity.h>
 
 #include "AndroidFileSystem.hpp"
@@ -332,6 +333,17 @@ bool AndroidFileSystem::PathExists(const Diligent::Char* strPath)
     return false;
 }
 
+bool AndroidFileSystem::GetFileTimestamp(const Diligent::Char* strFilePath, Diligent::Uint64& Timestamp)
+{
+    // Files packaged as assets can't be modified and have no timestamps
+    struct stat StatBuff;
+    if (stat(strFilePath, &StatBuff) != 0)
+        return false;
+
+    Timestamp = static_cast<Diligent::Uint64>(StatBuff.st_mtime);
+    return true;
+}
+
 bool AndroidFileSystem::CreateDirectory(const Diligent::Char* strPath)
 {
     UNSUPPORTED("Not implemented");
@@ -353,3 +365,22 @@ std::vector<std::unique_ptr<FindFileData>> AndroidFileSystem::Search(const Dilig
     UNSUPPORTED("Not implemented");
     return std::vector<std::unique_ptr<FindFileData>>();
 }
+
+std::unique_ptr<BasicMappedFile> AndroidFileSystem::MapFile(const Diligent::Char* strFilePath)
+{
+    FileOpenAttribs OpenAttribs;
+    OpenAttribs.strFilePath = strFilePath;
+
+    std::unique_ptr<AndroidFile> pFile{OpenFile(OpenAttribs)};
+    if (!pFile)
+        return nullptr;
+
+    std::vector<Diligent::Uint8> Data(pFile->GetSize());
+    if (!Data.empty() && !pFile->Read(Data.data(), Data.size()))
+    {
+        LOG_ERROR_MESSAGE("Failed to read file '", strFilePath, "'");
+        return nullptr;
+    }
+
+    return std::unique_ptr<BasicMappedFile>{new BasicMappedFileCopy{std::move(Data)}};
+}
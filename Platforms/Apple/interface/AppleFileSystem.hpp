@@ -41,6 +41,8 @@ public:
     static bool FileExists(const Diligent::Char* strFilePath);
     static bool PathExists(const Diligent::Char* strPath);
 
+    static bool GetFileTimestamp(const Diligent::Char* strFilePath, Diligent::Uint64& Timestamp);
+
     static bool CreateDirectory(const Diligent::Char* strPath);
     static void ClearDirectory(const Diligent::Char* strPath);
     static void DeleteFile(const Diligent::Char* strPath);
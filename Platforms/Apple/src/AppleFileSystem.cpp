@@ -23,6 +23,8 @@
 
 #include <stdio.h>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <cerrno>
 #include <cstdio>
 #include <CoreFoundation/CoreFoundation.h>
 
@@ -119,14 +121,34 @@ bool AppleFileSystem::FileExists(const Diligent::Char* strFilePath)
 
 bool AppleFileSystem::PathExists(const Diligent::Char* strPath)
 {
-    UNSUPPORTED("Not implemented");
-    return false;
+    struct stat StatBuff;
+    return stat(strPath, &StatBuff) == 0;
+}
+
+bool AppleFileSystem::GetFileTimestamp(const Diligent::Char* strFilePath, Diligent::Uint64& Timestamp)
+{
+    struct stat StatBuff;
+    if (stat(strFilePath, &StatBuff) != 0)
+        return false;
+
+    Timestamp = static_cast<Diligent::Uint64>(StatBuff.st_mtimespec.tv_sec) * 1000000000ull + static_cast<Diligent::Uint64>(StatBuff.st_mtimespec.tv_nsec);
+    return true;
 }
 
 bool AppleFileSystem::CreateDirectory(const Diligent::Char* strPath)
 {
-    UNSUPPORTED("Not implemented");
-    return false;
+    // Create all intermediate directories
+    const Diligent::String Path{strPath};
+    for (size_t Pos = 1; Pos <= Path.length(); ++Pos)
+    {
+        if (Pos == Path.length() || Path[Pos] == '/')
+        {
+            const auto Dir = Path.substr(0, Pos);
+            if (mkdir(Dir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH) != 0 && errno != EEXIST)
+                return false;
+        }
+    }
+    return PathExists(strPath);
 }
 
 void AppleFileSystem::ClearDirectory(const Diligent::Char* strPath)
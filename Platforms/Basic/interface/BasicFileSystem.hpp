@@ -28,6 +28,7 @@
 #pragma once
 
 #include <vector>
+#include <memory>
 #include "../../../Primitives/interface/BasicTypes.h"
 
 enum class EFileAccessMode
@@ -79,6 +80,37 @@ struct FindFileData
     virtual ~FindFileData() {}
 };
 
+/// View of the entire file contents. The data may be modified, but the
+/// modifications are private to the view and are never written to the file.
+class BasicMappedFile
+{
+public:
+    virtual ~BasicMappedFile() {}
+
+    void*       GetData() { return m_pData; }
+    const void* GetData() const { return m_pData; }
+    size_t      GetSize() const { return m_Size; }
+
+protected:
+    void*  m_pData = nullptr;
+    size_t m_Size  = 0;
+};
+
+/// Mapped file that holds a copy of the file contents. Used by platforms that can't map files into memory.
+class BasicMappedFileCopy final : public BasicMappedFile
+{
+public:
+    explicit BasicMappedFileCopy(std::vector<Diligent::Uint8>&& Data) :
+        m_Data{std::move(Data)}
+    {
+        m_pData = m_Data.data();
+        m_Size  = m_Data.size();
+    }
+
+private:
+    std::vector<Diligent::Uint8> m_Data;
+};
+
 struct BasicFileSystem
 {
 public:
@@ -103,6 +135,11 @@ public:
 
     static bool IsPathAbsolute(const Diligent::Char* strPath);
 
+    /// Makes the contents of the file available in memory. Platforms that support memory mapping
+    /// map the file into the address space, so that the pages are only loaded when they are accessed.
+    /// The default implementation reads the entire file. Returns null if the file can't be opened.
+    static std::unique_ptr<BasicMappedFile> MapFile(const Diligent::Char* strFilePath);
+
 protected:
     static Diligent::String m_strWorkingDirectory;
 };
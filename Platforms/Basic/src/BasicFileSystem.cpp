@@ -28,6 +28,7 @@
 #include "BasicFileSystem.hpp"
 #include "DebugUtilities.hpp"
 #include <algorithm>
+#include <cstdio>
 
 Diligent::String BasicFileSystem::m_strWorkingDirectory;
 
@@ -141,3 +142,24 @@ bool BasicFileSystem::IsPathAbsolute(const Diligent::Char* strPath)
 #    error Unknown platform.
 #endif
 }
+
+std::unique_ptr<BasicMappedFile> BasicFileSystem::MapFile(const Diligent::Char* strFilePath)
+{
+    FILE* pFile = fopen(strFilePath, "rb");
+    if (pFile == nullptr)
+        return nullptr;
+
+    std::vector<Diligent::Uint8> Data;
+    if (fseek(pFile, 0, SEEK_END) == 0)
+    {
+        const auto Size = ftell(pFile);
+        if (Size > 0 && fseek(pFile, 0, SEEK_SET) == 0)
+        {
+            Data.resize(static_cast<size_t>(Size));
+            Data.resize(fread(Data.data(), 1, Data.size(), pFile));
+        }
+    }
+    fclose(pFile);
+
+    return std::unique_ptr<BasicMappedFile>{new BasicMappedFileCopy{std::move(Data)}};
+}
@@ -41,9 +41,15 @@ public:
     static bool FileExists(const Diligent::Char* strFilePath);
     static bool PathExists(const Diligent::Char* strPath);
 
+    static bool GetFileTimestamp(const Diligent::Char* strFilePath, Diligent::Uint64& Timestamp);
+
     static bool CreateDirectory(const Diligent::Char* strPath);
     static void ClearDirectory(const Diligent::Char* strPath);
     static void DeleteFile(const Diligent::Char* strPath);
 
     static std::vector<std::unique_ptr<FindFileData>> Search(const Diligent::Char* SearchPattern);
+
+    /// Maps the file into the address space with mmap. The pages are loaded by the kernel
+    /// on first access and are shared with the page cache until they are modified.
+    static std::unique_ptr<BasicMappedFile> MapFile(const Diligent::Char* strFilePath);
 };
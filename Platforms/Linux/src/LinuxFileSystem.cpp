@@ -23,7 +23,12 @@
 
 #include <stdio.h>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <cerrno>
 #include <cstdio>
+#include <cstring>
 
 #include "LinuxFileSystem.hpp"
 #include "Errors.hpp"
@@ -58,14 +63,34 @@ bool LinuxFileSystem::FileExists(const Diligent::Char* strFilePath)
 
 bool LinuxFileSystem::PathExists(const Diligent::Char* strPath)
 {
-    UNSUPPORTED("Not implemented");
-    return false;
+    struct stat StatBuff;
+    return stat(strPath, &StatBuff) == 0;
+}
+
+bool LinuxFileSystem::GetFileTimestamp(const Diligent::Char* strFilePath, Diligent::Uint64& Timestamp)
+{
+    struct stat StatBuff;
+    if (stat(strFilePath, &StatBuff) != 0)
+        return false;
+
+    Timestamp = static_cast<Diligent::Uint64>(StatBuff.st_mtim.tv_sec) * 1000000000ull + static_cast<Diligent::Uint64>(StatBuff.st_mtim.tv_nsec);
+    return true;
 }
 
 bool LinuxFileSystem::CreateDirectory(const Diligent::Char* strPath)
 {
-    UNSUPPORTED("Not implemented");
-    return false;
+    // Create all intermediate directories
+    const Diligent::String Path{strPath};
+    for (size_t Pos = 1; Pos <= Path.length(); ++Pos)
+    {
+        if (Pos == Path.length() || Path[Pos] == '/')
+        {
+            const auto Dir = Path.substr(0, Pos);
+            if (mkdir(Dir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH) != 0 && errno != EEXIST)
+                return false;
+        }
+    }
+    return PathExists(strPath);
 }
 
 void LinuxFileSystem::ClearDirectory(const Diligent::Char* strPath)
@@ -83,3 +108,62 @@ std::vector<std::unique_ptr<FindFileData>> LinuxFileSystem::Search(const Diligen
     UNSUPPORTED("Not implemented");
     return std::vector<std::unique_ptr<FindFileData>>();
 }
+
+namespace
+{
+
+class LinuxMappedFile final : public BasicMappedFile
+{
+public:
+    LinuxMappedFile(void* pData, size_t Size)
+    {
+        m_pData = pData;
+        m_Size  = Size;
+    }
+
+    ~LinuxMappedFile()
+    {
+        if (m_pData != nullptr)
+            munmap(m_pData, m_Size);
+    }
+};
+
+} // namespace
+
+std::unique_ptr<BasicMappedFile> LinuxFileSystem::MapFile(const Diligent::Char* strFilePath)
+{
+    FileOpenAttribs OpenAttribs;
+    OpenAttribs.strFilePath = strFilePath;
+    BasicFile   DummyFile(OpenAttribs, LinuxFileSystem::GetSlashSymbol());
+    const auto& Path = DummyFile.GetPath(); // This is necessary to correct slashes
+
+    int fd = open(Path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat StatBuff;
+    if (fstat(fd, &StatBuff) != 0)
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    const auto Size  = static_cast<size_t>(StatBuff.st_size);
+    void*      pData = nullptr;
+    if (Size > 0)
+    {
+        // Private writable mapping is copy-on-write: pages that are modified through
+        // the mapping are copied, and the changes are never written to the file
+        pData = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (pData == MAP_FAILED)
+        {
+            LOG_ERROR_MESSAGE("Failed to map file '", Path, "': ", strerror(errno));
+            close(fd);
+            return nullptr;
+        }
+    }
+    // The mapping remains valid after the descriptor is closed
+    close(fd);
+
+    return std::unique_ptr<BasicMappedFile>{new LinuxMappedFile{pData, Size}};
+}
@@ -249,6 +249,17 @@ bool WindowsStoreFileSystem::PathExists(const Diligent::Char* strPath)
     return false;
 }
 
+bool WindowsStoreFileSystem::GetFileTimestamp(const Diligent::Char* strFilePath, Diligent::Uint64& Timestamp)
+{
+    auto                      wstrPath    = Diligent::WidenString(strFilePath);
+    WIN32_FILE_ATTRIBUTE_DATA FileAttribs = {};
+    if (GetFileAttributesExW(wstrPath.c_str(), GetFileExInfoStandard, &FileAttribs) == FALSE)
+        return false;
+
+    Timestamp = (Diligent::Uint64{FileAttribs.ftLastWriteTime.dwHighDateTime} << 32u) | Diligent::Uint64{FileAttribs.ftLastWriteTime.dwLowDateTime};
+    return true;
+}
+
 void WindowsStoreFileSystem::ClearDirectory(const Diligent::Char* strPath)
 {
     UNSUPPORTED("Not implemented");
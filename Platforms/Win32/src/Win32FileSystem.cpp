@@ -236,6 +236,17 @@ bool WindowsFileSystem::PathExists(const Char* strPath)
     return PathFileExistsA(strPath) != FALSE;
 }
 
+bool WindowsFileSystem::GetFileTimestamp(const Char* strFilePath, Uint64& Timestamp)
+{
+    auto                      UTF16FilePath = UTF8ToUTF16(strFilePath);
+    WIN32_FILE_ATTRIBUTE_DATA FileAttribs   = {};
+    if (GetFileAttributesExW(UTF16FilePath.data(), GetFileExInfoStandard, &FileAttribs) == FALSE)
+        return false;
+
+    Timestamp = (Uint64{FileAttribs.ftLastWriteTime.dwHighDateTime} << 32u) | Uint64{FileAttribs.ftLastWriteTime.dwLowDateTime};
+    return true;
+}
+
 struct WndFindFileData : public FindFileData
 {
     virtual const Char* Name() const override { return ffd.cFileName; }
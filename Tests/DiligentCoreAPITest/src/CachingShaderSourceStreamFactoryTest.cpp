@@ -0,0 +1,226 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <thread>
+#include <chrono>
+
+#include "CachingShaderSourceStreamFactory.hpp"
+#include "DefaultShaderSourceStreamFactory.h"
+#include "DataBlobImpl.hpp"
+#include "FileWrapper.hpp"
+#include "TestingEnvironment.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+String ReadSource(IShaderSourceInputStreamFactory* pFactory, const Char* Name)
+{
+    RefCntAutoPtr<IFileStream> pStream;
+    pFactory->CreateInputStream(Name, &pStream);
+    if (!pStream)
+        return "";
+
+    RefCntAutoPtr<IDataBlob> pData{MakeNewRCObj<DataBlobImpl>()(0)};
+    pStream->ReadBlob(pData);
+    return String{reinterpret_cast<const char*>(pData->GetDataPtr()), pData->GetSize()};
+}
+
+bool WriteFile(const Char* Path, const String& Source)
+{
+    FileWrapper File{Path, EFileAccessMode::Overwrite};
+    return File && File->Write(Source.data(), Source.size());
+}
+
+bool Contains(const std::vector<String>& Names, const Char* Name)
+{
+    return std::find(Names.begin(), Names.end(), Name) != Names.end();
+}
+
+TEST(CachingShaderSourceStreamFactory, DependencyGraph)
+{
+    RefCntAutoPtr<CachingShaderSourceStreamFactory> pCachingFactory;
+    CreateCachingShaderSourceStreamFactory("shaders/HLSL2GLSLConverter", &pCachingFactory);
+    ASSERT_NE(pCachingFactory, nullptr);
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pDefaultFactory;
+    CreateDefaultShaderSourceStreamFactory("shaders/HLSL2GLSLConverter", &pDefaultFactory);
+
+    const auto RefSource = ReadSource(pDefaultFactory, "VS_PS.hlsl");
+    ASSERT_FALSE(RefSource.empty());
+    EXPECT_EQ(ReadSource(pCachingFactory, "VS_PS.hlsl"), RefSource);
+    EXPECT_EQ(ReadSource(pCachingFactory, "IncludeTest.h"), ReadSource(pDefaultFactory, "IncludeTest.h"));
+    EXPECT_EQ(pCachingFactory->GetNumCachedFiles(), 2u);
+
+    // Cached copy must be identical to the file
+    EXPECT_EQ(ReadSource(pCachingFactory, "VS_PS.hlsl"), RefSource);
+
+    auto Dependencies = pCachingFactory->GetDependencies("VS_PS.hlsl");
+    EXPECT_TRUE(Contains(Dependencies, "IncludeTest.h"));
+    // Commented-out includes are not dependencies
+    EXPECT_FALSE(Contains(Dependencies, "NonExistingFile.h"));
+
+    auto Dependents = pCachingFactory->GetDependents("IncludeTest.h");
+    EXPECT_TRUE(Contains(Dependents, "VS_PS.hlsl"));
+
+    // Files have not been modified
+    EXPECT_TRUE(pCachingFactory->CheckForChanges().empty());
+    EXPECT_EQ(pCachingFactory->GetNumCachedFiles(), 2u);
+
+    auto Invalidated = pCachingFactory->Invalidate("IncludeTest.h");
+    EXPECT_TRUE(Contains(Invalidated, "IncludeTest.h"));
+    EXPECT_TRUE(Contains(Invalidated, "VS_PS.hlsl"));
+    EXPECT_EQ(pCachingFactory->GetNumCachedFiles(), 1u);
+
+    // The dependency graph is preserved when the file is evicted
+    EXPECT_TRUE(Contains(pCachingFactory->GetDependents("IncludeTest.h"), "VS_PS.hlsl"));
+
+    RefCntAutoPtr<IFileStream> pMissingStream;
+    pCachingFactory->CreateInputStream2("NonExistingFile.h", CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_SILENT, &pMissingStream);
+    EXPECT_EQ(pMissingStream, nullptr);
+}
+
+TEST(CachingShaderSourceStreamFactory, ModifiedFile)
+{
+    static constexpr char IncludeFile[]   = "CachingShaderSourceStreamFactoryTest_Include.h";
+    static constexpr char ShaderFile[]    = "CachingShaderSourceStreamFactoryTest_Shader.hlsl";
+    static constexpr char UnrelatedFile[] = "CachingShaderSourceStreamFactoryTest_Unrelated.h";
+
+    const String ShaderSource =
+        "/*\n"
+        "#include \"CachingShaderSourceStreamFactoryTest_Unrelated.h\"\n"
+        "*/\n"
+        "#include \"CachingShaderSourceStreamFactoryTest_Include.h\" /* #include \"BlockComment.h\"\n"
+        "#include \"MultiLineBlockComment.h\" */\n"
+        "// #include \"LineComment.h\"\n"
+        "static const char* Str = \"/*\";\n"
+        "#include \"AfterString.h\"\n";
+    ASSERT_TRUE(WriteFile(IncludeFile, "float4 Color = float4(1.0, 0.0, 0.0, 1.0);\n"));
+    ASSERT_TRUE(WriteFile(ShaderFile, ShaderSource));
+    ASSERT_TRUE(WriteFile(UnrelatedFile, "\n"));
+
+    RefCntAutoPtr<CachingShaderSourceStreamFactory> pFactory;
+    CreateCachingShaderSourceStreamFactory(nullptr, &pFactory);
+    ASSERT_NE(pFactory, nullptr);
+
+    EXPECT_EQ(ReadSource(pFactory, ShaderFile), ShaderSource);
+    EXPECT_FALSE(ReadSource(pFactory, IncludeFile).empty());
+    EXPECT_FALSE(ReadSource(pFactory, UnrelatedFile).empty());
+
+    const auto Dependencies = pFactory->GetDependencies(ShaderFile);
+    EXPECT_EQ(Dependencies.size(), size_t{2});
+    EXPECT_TRUE(Contains(Dependencies, IncludeFile));
+    EXPECT_TRUE(Contains(Dependencies, "AfterString.h"));
+
+    EXPECT_TRUE(pFactory->CheckForChanges().empty());
+
+    // Rewrite the file until its timestamp changes as file systems may have coarse timestamp resolution
+    Uint64 OrigTimestamp = 0;
+    ASSERT_TRUE(FileSystem::GetFileTimestamp(IncludeFile, OrigTimestamp));
+    const String ModifiedSource = "float4 Color = float4(0.0, 1.0, 0.0, 1.0);\n";
+    for (Uint64 Timestamp = OrigTimestamp; Timestamp == OrigTimestamp;)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        ASSERT_TRUE(WriteFile(IncludeFile, ModifiedSource));
+        ASSERT_TRUE(FileSystem::GetFileTimestamp(IncludeFile, Timestamp));
+    }
+
+    const auto Changed = pFactory->CheckForChanges();
+    EXPECT_EQ(Changed.size(), size_t{2});
+    EXPECT_TRUE(Contains(Changed, IncludeFile));
+    EXPECT_TRUE(Contains(Changed, ShaderFile));
+    // Only the modified file is evicted, dependents are reported so that they can be recreated
+    EXPECT_EQ(pFactory->GetNumCachedFiles(), 2u);
+
+    // The file is reloaded from disk
+    EXPECT_EQ(ReadSource(pFactory, IncludeFile), ModifiedSource);
+    EXPECT_EQ(pFactory->GetNumCachedFiles(), 3u);
+    EXPECT_TRUE(pFactory->CheckForChanges().empty());
+
+    FileSystem::DeleteFile(IncludeFile);
+    FileSystem::DeleteFile(ShaderFile);
+    FileSystem::DeleteFile(UnrelatedFile);
+
+    // Deleted files are evicted as well
+    const auto Deleted = pFactory->CheckForChanges();
+    EXPECT_TRUE(Contains(Deleted, IncludeFile));
+    EXPECT_TRUE(Contains(Deleted, ShaderFile));
+    EXPECT_TRUE(Contains(Deleted, UnrelatedFile));
+    EXPECT_EQ(pFactory->GetNumCachedFiles(), 0u);
+}
+
+void CollectName(const Char* Name, void* pUserData)
+{
+    reinterpret_cast<std::vector<String>*>(pUserData)->emplace_back(Name);
+}
+
+// Applications create the factory through the engine factory and use the public interface
+TEST(CachingShaderSourceStreamFactory, EngineFactory)
+{
+    auto* pEngineFactory = TestingEnvironment::GetInstance()->GetDevice()->GetEngineFactory();
+
+    RefCntAutoPtr<ICachingShaderSourceStreamFactory> pFactory;
+    pEngineFactory->CreateCachingShaderSourceStreamFactory("shaders/HLSL2GLSLConverter", &pFactory);
+    ASSERT_NE(pFactory, nullptr);
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pSourceFactory{pFactory, IID_IShaderSourceInputStreamFactory};
+    ASSERT_NE(pSourceFactory, nullptr);
+    RefCntAutoPtr<ICachingShaderSourceStreamFactory> pCachingFactory{pSourceFactory, IID_CachingShaderSourceStreamFactory};
+    EXPECT_EQ(pCachingFactory, pFactory);
+
+    EXPECT_FALSE(ReadSource(pSourceFactory, "VS_PS.hlsl").empty());
+    EXPECT_FALSE(ReadSource(pSourceFactory, "IncludeTest.h").empty());
+    EXPECT_EQ(pFactory->GetNumCachedFiles(), 2u);
+
+    std::vector<String> Dependencies;
+    pFactory->EnumerateDependencies("VS_PS.hlsl", CollectName, &Dependencies);
+    EXPECT_TRUE(Contains(Dependencies, "IncludeTest.h"));
+
+    std::vector<String> Dependents;
+    pFactory->EnumerateDependents("IncludeTest.h", CollectName, &Dependents);
+    EXPECT_TRUE(Contains(Dependents, "VS_PS.hlsl"));
+
+    std::vector<String> Changed;
+    pFactory->CheckForChanges(CollectName, &Changed);
+    EXPECT_TRUE(Changed.empty());
+
+    std::vector<String> Invalidated;
+    pFactory->Invalidate("IncludeTest.h", CollectName, &Invalidated);
+    EXPECT_TRUE(Contains(Invalidated, "IncludeTest.h"));
+    EXPECT_TRUE(Contains(Invalidated, "VS_PS.hlsl"));
+    EXPECT_EQ(pFactory->GetNumCachedFiles(), 1u);
+
+    pFactory->Clear();
+    EXPECT_EQ(pFactory->GetNumCachedFiles(), 0u);
+}
+
+} // namespace
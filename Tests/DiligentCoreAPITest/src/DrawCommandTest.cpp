@@ -28,6 +28,7 @@
 #include "TestingEnvironment.hpp"
 #include "TestingSwapChainBase.hpp"
 #include "BasicMath.hpp"
+#include "Timer.hpp"
 
 #include "gtest/gtest.h"
 
@@ -1466,4 +1467,38 @@ TEST_F(DrawCommandTest, DrawIndexedInstancedIndirect_FirstInstance_BaseVertex_Fi
     Present();
 }
 
+// Performance benchmark. Run with --gtest_also_run_disabled_tests
+// Redraws the reference triangles many times, rebinding the vertex buffer at a different
+// offset for every draw, and reports the CPU time spent in the draw loop.
+TEST_F(DrawCommandTest, DISABLED_Draw_StreamingVBOffsets)
+{
+    auto* pEnv     = TestingEnvironment::GetInstance();
+    auto* pContext = pEnv->GetDeviceContext();
+
+    SetRenderTargets(sm_pDrawPSO);
+
+    auto pVB = CreateVertexBuffer(Vert, sizeof(Vert));
+
+    constexpr Uint32 NumIterations = 2048;
+
+    Timer DrawTimer;
+    for (Uint32 i = 0; i < NumIterations; ++i)
+    {
+        for (Uint32 tri = 0; tri < 2; ++tri)
+        {
+            IBuffer* pVBs[]    = {pVB};
+            Uint32   Offsets[] = {tri * 3 * Uint32{sizeof(Vertex)}};
+            pContext->SetVertexBuffers(0, _countof(pVBs), pVBs, Offsets, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, SET_VERTEX_BUFFERS_FLAG_NONE);
+
+            DrawAttribs drawAttrs{3, DRAW_FLAG_VERIFY_ALL};
+            pContext->Draw(drawAttrs);
+        }
+    }
+    auto ElapsedTime = DrawTimer.GetElapsedTime();
+    LOG_INFO_MESSAGE("Draw_StreamingVBOffsets: ", NumIterations * 2, " draws took ", ElapsedTime * 1000.0, " ms (",
+                     ElapsedTime * 1e+6 / (NumIterations * 2), " us per draw)");
+
+    Present();
+}
+
 } // namespace
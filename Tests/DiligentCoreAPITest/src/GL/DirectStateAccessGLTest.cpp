@@ -0,0 +1,416 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include <vector>
+#include <cstring>
+
+#include "../../include/GL/TestingEnvironmentGL.hpp"
+
+#include "EngineFactoryOpenGL.h"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+constexpr Uint32 BufferSize   = 256;
+constexpr Uint32 TexSize      = 8;
+constexpr Uint32 NumMipLevels = 2;
+constexpr Uint32 TexelSize    = 4; // TEX_FORMAT_RGBA8_UNORM
+
+// The contents of the resources after all operations have been performed
+struct ResourceContents
+{
+    std::vector<Uint8> Buffers;
+    std::vector<Uint8> TexMips[NumMipLevels];
+};
+
+// clang-format off
+Uint8 InitBufferByte   (Uint32 i) { return static_cast<Uint8>(i * 7 + 3);     }
+Uint8 UpdateBufferByte (Uint32 i) { return static_cast<Uint8>(0xA0 ^ i);      }
+Uint8 DynamicBufferByte(Uint32 i) { return static_cast<Uint8>(i * 5 + 1);     }
+Uint8 UploadBufferByte (Uint32 i) { return static_cast<Uint8>(255 - i * 3);   }
+
+Uint8 InitTexelByte  (Uint32 Mip, Uint32 x, Uint32 y, Uint32 c) { return static_cast<Uint8>(Mip * 97 + x * 29 + y * 13 + c * 61); }
+Uint8 UpdateTexelByte(Uint32 x, Uint32 y, Uint32 c)              { return static_cast<Uint8>(200 + x * 5 + y * 11 + c);          }
+Uint8 UploadTexelByte(Uint32 x, Uint32 y, Uint32 c)              { return static_cast<Uint8>(17 + x * 41 + y * 7 + c * 3);       }
+// clang-format on
+
+Uint32 GetMipSize(Uint32 Mip)
+{
+    return TexSize >> Mip;
+}
+
+void CopyTexels(const std::vector<Uint8>& Src, Uint32 SrcWidth, const Box& SrcBox, std::vector<Uint8>& Dst, Uint32 DstWidth, Uint32 DstX, Uint32 DstY)
+{
+    for (Uint32 y = SrcBox.MinY; y < SrcBox.MaxY; ++y)
+    {
+        const auto RowSize = (SrcBox.MaxX - SrcBox.MinX) * TexelSize;
+        memcpy(&Dst[((DstY + y - SrcBox.MinY) * DstWidth + DstX) * TexelSize], &Src[(y * SrcWidth + SrcBox.MinX) * TexelSize], RowSize);
+    }
+}
+
+// Region of mip 0 updated with UpdateTexture()
+const Box UpdateBox{2, 6, 1, 5};
+// Region of mip 0 copied from the source to the destination texture
+const Box    CopyBox{0, 4, 2, 6};
+const Uint32 CopyDstX = 4;
+const Uint32 CopyDstY = 3;
+// Region of mip 1 copied from the upload texture to the destination texture
+const Box    UploadBox{0, 2, 0, 2};
+const Uint32 UploadDstX = 2;
+const Uint32 UploadDstY = 2;
+
+// Computes the contents that the operations performed by ProcessResources() must produce
+ResourceContents ComputeReferenceContents()
+{
+    ResourceContents Ref;
+
+    std::vector<Uint8> Buffer(BufferSize), DstBuffer(BufferSize);
+    for (Uint32 i = 0; i < BufferSize; ++i)
+        Buffer[i] = InitBufferByte(i);
+    for (Uint32 i = 0; i < 64; ++i)
+        Buffer[64 + i] = UpdateBufferByte(i);
+    for (Uint32 i = 0; i < 128; ++i)
+        DstBuffer[96 + i] = Buffer[32 + i];
+    for (Uint32 i = 0; i < 64; ++i)
+        DstBuffer[i] = DynamicBufferByte(i);
+    for (Uint32 i = 0; i < 32; ++i)
+        DstBuffer[224 + i] = UploadBufferByte(i);
+    Ref.Buffers = Buffer;
+    Ref.Buffers.insert(Ref.Buffers.end(), DstBuffer.begin(), DstBuffer.end());
+
+    std::vector<Uint8> SrcMips[NumMipLevels];
+    for (Uint32 Mip = 0; Mip < NumMipLevels; ++Mip)
+    {
+        const auto MipSize = GetMipSize(Mip);
+        SrcMips[Mip].resize(MipSize * MipSize * TexelSize);
+        for (Uint32 y = 0; y < MipSize; ++y)
+        {
+            for (Uint32 x = 0; x < MipSize; ++x)
+            {
+                for (Uint32 c = 0; c < TexelSize; ++c)
+                    SrcMips[Mip][(y * MipSize + x) * TexelSize + c] = InitTexelByte(Mip, x, y, c);
+            }
+        }
+        Ref.TexMips[Mip].resize(SrcMips[Mip].size());
+    }
+
+    for (Uint32 y = UpdateBox.MinY; y < UpdateBox.MaxY; ++y)
+    {
+        for (Uint32 x = UpdateBox.MinX; x < UpdateBox.MaxX; ++x)
+        {
+            for (Uint32 c = 0; c < TexelSize; ++c)
+                SrcMips[0][(y * TexSize + x) * TexelSize + c] = UpdateTexelByte(x - UpdateBox.MinX, y - UpdateBox.MinY, c);
+        }
+    }
+
+    CopyTexels(SrcMips[0], TexSize, CopyBox, Ref.TexMips[0], TexSize, CopyDstX, CopyDstY);
+    Ref.TexMips[1] = SrcMips[1];
+
+    const auto         UploadMipSize = GetMipSize(1);
+    std::vector<Uint8> UploadMip(UploadMipSize * UploadMipSize * TexelSize);
+    for (Uint32 y = 0; y < UploadMipSize; ++y)
+    {
+        for (Uint32 x = 0; x < UploadMipSize; ++x)
+        {
+            for (Uint32 c = 0; c < TexelSize; ++c)
+                UploadMip[(y * UploadMipSize + x) * TexelSize + c] = UploadTexelByte(x, y, c);
+        }
+    }
+    CopyTexels(UploadMip, UploadMipSize, UploadBox, Ref.TexMips[1], UploadMipSize, UploadDstX, UploadDstY);
+
+    return Ref;
+}
+
+RefCntAutoPtr<IBuffer> CreateBuffer(IRenderDevice* pDevice, USAGE Usage, CPU_ACCESS_FLAGS CPUAccessFlags, const std::vector<Uint8>* pData, Uint32 Size = BufferSize)
+{
+    BufferDesc BuffDesc;
+    BuffDesc.Name           = "Direct state access test buffer";
+    BuffDesc.Usage          = Usage;
+    BuffDesc.BindFlags      = Usage == USAGE_STAGING ? BIND_NONE : BIND_VERTEX_BUFFER;
+    BuffDesc.CPUAccessFlags = CPUAccessFlags;
+    BuffDesc.uiSizeInBytes  = Size;
+
+    BufferData InitData;
+    if (pData != nullptr)
+    {
+        InitData.pData    = pData->data();
+        InitData.DataSize = static_cast<Uint32>(pData->size());
+    }
+
+    RefCntAutoPtr<IBuffer> pBuffer;
+    pDevice->CreateBuffer(BuffDesc, pData != nullptr ? &InitData : nullptr, &pBuffer);
+    return pBuffer;
+}
+
+void ProcessBuffers(IRenderDevice* pDevice, IDeviceContext* pContext, std::vector<Uint8>& Contents)
+{
+    std::vector<Uint8> InitData(BufferSize);
+    for (Uint32 i = 0; i < BufferSize; ++i)
+        InitData[i] = InitBufferByte(i);
+    auto pBuffer = CreateBuffer(pDevice, USAGE_DEFAULT, CPU_ACCESS_NONE, &InitData);
+    ASSERT_NE(pBuffer, nullptr);
+
+    std::vector<Uint8> UpdateData(64);
+    for (Uint32 i = 0; i < UpdateData.size(); ++i)
+        UpdateData[i] = UpdateBufferByte(i);
+    pContext->UpdateBuffer(pBuffer, 64, static_cast<Uint32>(UpdateData.size()), UpdateData.data(), RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+    std::vector<Uint8> Zeros(BufferSize);
+    auto               pDstBuffer = CreateBuffer(pDevice, USAGE_DEFAULT, CPU_ACCESS_NONE, &Zeros);
+    ASSERT_NE(pDstBuffer, nullptr);
+    pContext->CopyBuffer(pBuffer, 32, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pDstBuffer, 96, 128, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+    auto pDynamicBuffer = CreateBuffer(pDevice, USAGE_DYNAMIC, CPU_ACCESS_WRITE, nullptr, 64);
+    ASSERT_NE(pDynamicBuffer, nullptr);
+    {
+        PVoid pMappedData = nullptr;
+        pContext->MapBuffer(pDynamicBuffer, MAP_WRITE, MAP_FLAG_DISCARD, pMappedData);
+        ASSERT_NE(pMappedData, nullptr);
+        for (Uint32 i = 0; i < 64; ++i)
+            reinterpret_cast<Uint8*>(pMappedData)[i] = DynamicBufferByte(i);
+        pContext->UnmapBuffer(pDynamicBuffer, MAP_WRITE);
+    }
+    pContext->CopyBuffer(pDynamicBuffer, 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pDstBuffer, 0, 64, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+    // Persistently mapped if buffer storage is supported
+    auto pUploadBuffer = CreateBuffer(pDevice, USAGE_STAGING, CPU_ACCESS_WRITE, nullptr, 32);
+    ASSERT_NE(pUploadBuffer, nullptr);
+    {
+        PVoid pMappedData = nullptr;
+        pContext->MapBuffer(pUploadBuffer, MAP_WRITE, MAP_FLAG_NONE, pMappedData);
+        ASSERT_NE(pMappedData, nullptr);
+        for (Uint32 i = 0; i < 32; ++i)
+            reinterpret_cast<Uint8*>(pMappedData)[i] = UploadBufferByte(i);
+        pContext->UnmapBuffer(pUploadBuffer, MAP_WRITE);
+    }
+    pContext->CopyBuffer(pUploadBuffer, 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pDstBuffer, 224, 32, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+    auto pReadbackBuffer = CreateBuffer(pDevice, USAGE_STAGING, CPU_ACCESS_READ, nullptr, BufferSize * 2);
+    ASSERT_NE(pReadbackBuffer, nullptr);
+    pContext->CopyBuffer(pBuffer, 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pReadbackBuffer, 0, BufferSize, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    pContext->CopyBuffer(pDstBuffer, 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pReadbackBuffer, BufferSize, BufferSize, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    pContext->WaitForIdle();
+
+    PVoid pMappedData = nullptr;
+    pContext->MapBuffer(pReadbackBuffer, MAP_READ, MAP_FLAG_DO_NOT_WAIT, pMappedData);
+    ASSERT_NE(pMappedData, nullptr);
+    Contents.assign(reinterpret_cast<const Uint8*>(pMappedData), reinterpret_cast<const Uint8*>(pMappedData) + BufferSize * 2);
+    pContext->UnmapBuffer(pReadbackBuffer, MAP_READ);
+}
+
+RefCntAutoPtr<ITexture> CreateTexture(IRenderDevice* pDevice, USAGE Usage, CPU_ACCESS_FLAGS CPUAccessFlags, const std::vector<Uint8>* pMipData)
+{
+    TextureDesc TexDesc;
+    TexDesc.Name           = "Direct state access test texture";
+    TexDesc.Type           = RESOURCE_DIM_TEX_2D;
+    TexDesc.Width          = TexSize;
+    TexDesc.Height         = TexSize;
+    TexDesc.MipLevels      = NumMipLevels;
+    TexDesc.Format         = TEX_FORMAT_RGBA8_UNORM;
+    TexDesc.Usage          = Usage;
+    TexDesc.BindFlags      = Usage == USAGE_STAGING ? BIND_NONE : BIND_SHADER_RESOURCE;
+    TexDesc.CPUAccessFlags = CPUAccessFlags;
+
+    TextureSubResData SubResources[NumMipLevels];
+    if (pMipData != nullptr)
+    {
+        for (Uint32 Mip = 0; Mip < NumMipLevels; ++Mip)
+            SubResources[Mip] = TextureSubResData{pMipData[Mip].data(), GetMipSize(Mip) * TexelSize};
+    }
+    TextureData InitData{SubResources, NumMipLevels};
+
+    RefCntAutoPtr<ITexture> pTexture;
+    pDevice->CreateTexture(TexDesc, pMipData != nullptr ? &InitData : nullptr, &pTexture);
+    return pTexture;
+}
+
+void ProcessTextures(IRenderDevice* pDevice, IDeviceContext* pContext, std::vector<Uint8> Contents[])
+{
+    std::vector<Uint8> InitData[NumMipLevels];
+    std::vector<Uint8> Zeros[NumMipLevels];
+    for (Uint32 Mip = 0; Mip < NumMipLevels; ++Mip)
+    {
+        const auto MipSize = GetMipSize(Mip);
+        InitData[Mip].resize(MipSize * MipSize * TexelSize);
+        Zeros[Mip].resize(InitData[Mip].size());
+        for (Uint32 y = 0; y < MipSize; ++y)
+        {
+            for (Uint32 x = 0; x < MipSize; ++x)
+            {
+                for (Uint32 c = 0; c < TexelSize; ++c)
+                    InitData[Mip][(y * MipSize + x) * TexelSize + c] = InitTexelByte(Mip, x, y, c);
+            }
+        }
+    }
+
+    auto pTexture = CreateTexture(pDevice, USAGE_DEFAULT, CPU_ACCESS_NONE, InitData);
+    ASSERT_NE(pTexture, nullptr);
+
+    const auto         UpdateWidth = UpdateBox.MaxX - UpdateBox.MinX;
+    std::vector<Uint8> UpdateData(UpdateWidth * (UpdateBox.MaxY - UpdateBox.MinY) * TexelSize);
+    for (Uint32 y = 0; y < UpdateBox.MaxY - UpdateBox.MinY; ++y)
+    {
+        for (Uint32 x = 0; x < UpdateWidth; ++x)
+        {
+            for (Uint32 c = 0; c < TexelSize; ++c)
+                UpdateData[(y * UpdateWidth + x) * TexelSize + c] = UpdateTexelByte(x, y, c);
+        }
+    }
+    TextureSubResData UpdateSubresData{UpdateData.data(), UpdateWidth * TexelSize};
+    pContext->UpdateTexture(pTexture, 0, 0, UpdateBox, UpdateSubresData, RESOURCE_STATE_TRANSITION_MODE_NONE, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+    auto pDstTexture = CreateTexture(pDevice, USAGE_DEFAULT, CPU_ACCESS_NONE, Zeros);
+    ASSERT_NE(pDstTexture, nullptr);
+    {
+        CopyTextureAttribs CopyAttribs{pTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pDstTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+        CopyAttribs.pSrcBox = &CopyBox;
+        CopyAttribs.DstX    = CopyDstX;
+        CopyAttribs.DstY    = CopyDstY;
+        pContext->CopyTexture(CopyAttribs);
+
+        CopyAttribs.pSrcBox     = nullptr;
+        CopyAttribs.SrcMipLevel = 1;
+        CopyAttribs.DstMipLevel = 1;
+        CopyAttribs.DstX        = 0;
+        CopyAttribs.DstY        = 0;
+        pContext->CopyTexture(CopyAttribs);
+    }
+
+    auto pUploadTexture = CreateTexture(pDevice, USAGE_STAGING, CPU_ACCESS_WRITE, nullptr);
+    ASSERT_NE(pUploadTexture, nullptr);
+    {
+        MappedTextureSubresource MappedData;
+        pContext->MapTextureSubresource(pUploadTexture, 1, 0, MAP_WRITE, MAP_FLAG_NONE, nullptr, MappedData);
+        ASSERT_NE(MappedData.pData, nullptr);
+        const auto MipSize = GetMipSize(1);
+        for (Uint32 y = 0; y < MipSize; ++y)
+        {
+            auto* pRow = reinterpret_cast<Uint8*>(MappedData.pData) + y * MappedData.Stride;
+            for (Uint32 x = 0; x < MipSize; ++x)
+            {
+                for (Uint32 c = 0; c < TexelSize; ++c)
+                    pRow[x * TexelSize + c] = UploadTexelByte(x, y, c);
+            }
+        }
+        pContext->UnmapTextureSubresource(pUploadTexture, 1, 0);
+
+        CopyTextureAttribs CopyAttribs{pUploadTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pDstTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+        CopyAttribs.SrcMipLevel = 1;
+        CopyAttribs.DstMipLevel = 1;
+        CopyAttribs.pSrcBox     = &UploadBox;
+        CopyAttribs.DstX        = UploadDstX;
+        CopyAttribs.DstY        = UploadDstY;
+        pContext->CopyTexture(CopyAttribs);
+    }
+
+    auto pReadbackTexture = CreateTexture(pDevice, USAGE_STAGING, CPU_ACCESS_READ, nullptr);
+    ASSERT_NE(pReadbackTexture, nullptr);
+    for (Uint32 Mip = 0; Mip < NumMipLevels; ++Mip)
+    {
+        CopyTextureAttribs CopyAttribs{pDstTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pReadbackTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+        CopyAttribs.SrcMipLevel = Mip;
+        CopyAttribs.DstMipLevel = Mip;
+        pContext->CopyTexture(CopyAttribs);
+    }
+    pContext->WaitForIdle();
+
+    for (Uint32 Mip = 0; Mip < NumMipLevels; ++Mip)
+    {
+        MappedTextureSubresource MappedData;
+        pContext->MapTextureSubresource(pReadbackTexture, Mip, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+        ASSERT_NE(MappedData.pData, nullptr);
+        const auto MipSize = GetMipSize(Mip);
+        Contents[Mip].resize(MipSize * MipSize * TexelSize);
+        for (Uint32 y = 0; y < MipSize; ++y)
+            memcpy(&Contents[Mip][y * MipSize * TexelSize], reinterpret_cast<const Uint8*>(MappedData.pData) + y * MappedData.Stride, MipSize * TexelSize);
+        pContext->UnmapTextureSubresource(pReadbackTexture, Mip, 0);
+    }
+}
+
+// Attaches a separate device to the context of the testing environment, performs the same
+// operations on buffers and textures, and reads back their contents
+void ProcessResources(bool DisableDirectStateAccess, ResourceContents& Contents)
+{
+#if EXPLICITLY_LOAD_ENGINE_GL_DLL
+    auto GetEngineFactoryOpenGL = LoadGraphicsEngineOpenGL();
+    ASSERT_NE(GetEngineFactoryOpenGL, nullptr);
+#endif
+    auto* pEnv = TestingEnvironment::GetInstance();
+    pEnv->GetDeviceContext()->Flush();
+
+    EngineGLCreateInfo CreateInfo;
+    CreateInfo.DisableDirectStateAccess = DisableDirectStateAccess;
+
+    RefCntAutoPtr<IRenderDevice>  pDevice;
+    RefCntAutoPtr<IDeviceContext> pContext;
+    GetEngineFactoryOpenGL()->AttachToActiveGLContext(CreateInfo, &pDevice, &pContext);
+    ASSERT_NE(pDevice, nullptr);
+    ASSERT_NE(pContext, nullptr);
+
+    ProcessBuffers(pDevice, pContext, Contents.Buffers);
+    ProcessTextures(pDevice, pContext, Contents.TexMips);
+
+    pContext->Flush();
+    pContext->InvalidateState();
+    pDevice->ReleaseStaleResources(true);
+
+    // The device has modified the GL state of the shared context
+    pEnv->GetDeviceContext()->InvalidateState();
+}
+
+// The objects are edited through glNamed* functions when direct state access is available,
+// and through the binding points otherwise. Both paths must produce the same contents.
+TEST(DirectStateAccessGLTest, CompareWithBindPath)
+{
+    auto* pEnv = TestingEnvironment::GetInstance();
+    if (pEnv->GetDevice()->GetDeviceCaps().DevType != RENDER_DEVICE_TYPE_GL)
+        GTEST_SKIP() << "This test requires OpenGL device";
+
+    const auto RefContents = ComputeReferenceContents();
+
+    ResourceContents DSAContents;
+    ASSERT_NO_FATAL_FAILURE(ProcessResources(false, DSAContents));
+
+    ResourceContents BindContents;
+    ASSERT_NO_FATAL_FAILURE(ProcessResources(true, BindContents));
+
+    EXPECT_EQ(DSAContents.Buffers, BindContents.Buffers);
+    EXPECT_EQ(BindContents.Buffers, RefContents.Buffers);
+    for (Uint32 Mip = 0; Mip < NumMipLevels; ++Mip)
+    {
+        EXPECT_EQ(DSAContents.TexMips[Mip], BindContents.TexMips[Mip]) << "mip " << Mip;
+        EXPECT_EQ(BindContents.TexMips[Mip], RefContents.TexMips[Mip]) << "mip " << Mip;
+    }
+}
+
+} // namespace
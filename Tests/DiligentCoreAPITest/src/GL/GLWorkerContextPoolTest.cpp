@@ -0,0 +1,219 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include <thread>
+#include <vector>
+
+#include "TestingEnvironment.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+constexpr Uint32 NumThreads           = 4;
+constexpr Uint32 NumBuffersPerThread  = 16;
+constexpr Uint32 BufferSize           = 256;
+constexpr Uint32 NumTexturesPerThread = 8;
+
+Uint32 GetTestValue(Uint32 Thread, Uint32 Buffer, Uint32 Element)
+{
+    return (Thread << 24u) ^ (Buffer << 16u) ^ Element;
+}
+
+// Runs Func(Thread) on NumThreads application threads that have no current GL context
+template <typename FuncType>
+void RunOnApplicationThreads(FuncType Func)
+{
+    std::vector<std::thread> Threads(NumThreads);
+    for (Uint32 t = 0; t < NumThreads; ++t)
+        Threads[t] = std::thread(Func, t);
+    for (auto& Thread : Threads)
+        Thread.join();
+}
+
+// Buffers are created by the application threads, read back by the immediate context
+// and then released by the application threads.
+TEST(GLWorkerContextPoolTest, CreateBuffers)
+{
+    auto* pEnv     = TestingEnvironment::GetInstance();
+    auto* pDevice  = pEnv->GetDevice();
+    auto* pContext = pEnv->GetDeviceContext();
+    if (!pDevice->GetDeviceCaps().IsGLDevice())
+    {
+        GTEST_SKIP() << "This test requires OpenGL device";
+    }
+    if (!pDevice->GetDeviceCaps().Features.MultithreadedResourceCreation)
+    {
+        GTEST_SKIP() << "Shared GL contexts are not supported";
+    }
+
+    TestingEnvironment::ScopedReleaseResources EnvironmentAutoReset;
+
+    std::vector<RefCntAutoPtr<IBuffer>> Buffers(NumThreads * NumBuffersPerThread);
+    RunOnApplicationThreads(
+        [&](Uint32 Thread) //
+        {
+            std::vector<Uint32> Data(BufferSize / sizeof(Uint32));
+            for (Uint32 b = 0; b < NumBuffersPerThread; ++b)
+            {
+                for (Uint32 i = 0; i < Data.size(); ++i)
+                    Data[i] = GetTestValue(Thread, b, i);
+
+                BufferDesc BuffDesc;
+                BuffDesc.Name          = "GL worker context pool test buffer";
+                BuffDesc.BindFlags     = BIND_VERTEX_BUFFER;
+                BuffDesc.uiSizeInBytes = BufferSize;
+
+                BufferData InitData{Data.data(), BufferSize};
+                pDevice->CreateBuffer(BuffDesc, &InitData, &Buffers[Thread * NumBuffersPerThread + b]);
+            }
+        });
+
+    BufferDesc BuffDesc;
+    BuffDesc.Name           = "GL worker context pool test staging buffer";
+    BuffDesc.Usage          = USAGE_STAGING;
+    BuffDesc.CPUAccessFlags = CPU_ACCESS_READ;
+    BuffDesc.uiSizeInBytes  = BufferSize;
+    RefCntAutoPtr<IBuffer> pStagingBuffer;
+    pDevice->CreateBuffer(BuffDesc, nullptr, &pStagingBuffer);
+    ASSERT_NE(pStagingBuffer, nullptr);
+
+    for (Uint32 t = 0; t < NumThreads; ++t)
+    {
+        for (Uint32 b = 0; b < NumBuffersPerThread; ++b)
+        {
+            auto* pBuffer = Buffers[t * NumBuffersPerThread + b].RawPtr();
+            ASSERT_NE(pBuffer, nullptr) << "thread " << t << ", buffer " << b;
+
+            pContext->CopyBuffer(pBuffer, 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                                 pStagingBuffer, 0, BufferSize, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+            pContext->WaitForIdle();
+
+            PVoid pData = nullptr;
+            pContext->MapBuffer(pStagingBuffer, MAP_READ, MAP_FLAG_NONE, pData);
+            ASSERT_NE(pData, nullptr);
+
+            Uint32 NumInvalidValues = 0;
+            for (Uint32 i = 0; i < BufferSize / sizeof(Uint32); ++i)
+                NumInvalidValues += reinterpret_cast<const Uint32*>(pData)[i] != GetTestValue(t, b, i) ? 1 : 0;
+            EXPECT_EQ(NumInvalidValues, 0u) << "thread " << t << ", buffer " << b;
+
+            pContext->UnmapBuffer(pStagingBuffer, MAP_READ);
+        }
+    }
+
+    RunOnApplicationThreads(
+        [&](Uint32 Thread) //
+        {
+            for (Uint32 b = 0; b < NumBuffersPerThread; ++b)
+                Buffers[Thread * NumBuffersPerThread + b].Release();
+        });
+}
+
+// Render targets are created by the application threads and bound by the immediate context,
+// which adds them to its FBO cache. The textures are then released by the application threads,
+// and the FBOs that reference them are deleted by the immediate context.
+TEST(GLWorkerContextPoolTest, ReleaseRenderTargets)
+{
+    auto* pEnv     = TestingEnvironment::GetInstance();
+    auto* pDevice  = pEnv->GetDevice();
+    auto* pContext = pEnv->GetDeviceContext();
+    if (!pDevice->GetDeviceCaps().IsGLDevice())
+    {
+        GTEST_SKIP() << "This test requires OpenGL device";
+    }
+    if (!pDevice->GetDeviceCaps().Features.MultithreadedResourceCreation)
+    {
+        GTEST_SKIP() << "Shared GL contexts are not supported";
+    }
+
+    TestingEnvironment::ScopedReleaseResources EnvironmentAutoReset;
+
+    std::vector<RefCntAutoPtr<ITexture>> Textures(NumThreads * NumTexturesPerThread);
+    RunOnApplicationThreads(
+        [&](Uint32 Thread) //
+        {
+            for (Uint32 t = 0; t < NumTexturesPerThread; ++t)
+            {
+                TextureDesc TexDesc;
+                TexDesc.Name      = "GL worker context pool test render target";
+                TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+                TexDesc.Width     = 64;
+                TexDesc.Height    = 64;
+                TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+                TexDesc.BindFlags = BIND_RENDER_TARGET;
+                pDevice->CreateTexture(TexDesc, nullptr, &Textures[Thread * NumTexturesPerThread + t]);
+            }
+        });
+
+    for (auto& pTexture : Textures)
+    {
+        ASSERT_NE(pTexture, nullptr);
+
+        ITextureView* pRTVs[] = {pTexture->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET)};
+        pContext->SetRenderTargets(1, pRTVs, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+        const float ClearColor[] = {0.25f, 0.5f, 0.75f, 1.0f};
+        pContext->ClearRenderTarget(pRTVs[0], ClearColor, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+    }
+    pContext->SetRenderTargets(0, nullptr, nullptr, RESOURCE_STATE_TRANSITION_MODE_NONE);
+
+    RunOnApplicationThreads(
+        [&](Uint32 Thread) //
+        {
+            for (Uint32 t = 0; t < NumTexturesPerThread; ++t)
+                Textures[Thread * NumTexturesPerThread + t].Release();
+        });
+
+    // Delete the FBOs that reference the released textures
+    pContext->FinishFrame();
+
+    // The cache must remain usable after the FBOs have been deleted
+    TextureDesc TexDesc;
+    TexDesc.Name      = "GL worker context pool test render target";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Width     = 64;
+    TexDesc.Height    = 64;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    TexDesc.BindFlags = BIND_RENDER_TARGET;
+    RefCntAutoPtr<ITexture> pTexture;
+    pDevice->CreateTexture(TexDesc, nullptr, &pTexture);
+    ASSERT_NE(pTexture, nullptr);
+
+    ITextureView* pRTVs[] = {pTexture->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET)};
+    pContext->SetRenderTargets(1, pRTVs, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    const float ClearColor[] = {1.0f, 0.0f, 0.0f, 1.0f};
+    pContext->ClearRenderTarget(pRTVs[0], ClearColor, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+    pContext->SetRenderTargets(0, nullptr, nullptr, RESOURCE_STATE_TRANSITION_MODE_NONE);
+}
+
+} // namespace
@@ -0,0 +1,133 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "../../include/GL/TestingEnvironmentGL.hpp"
+
+#include "EngineFactoryOpenGL.h"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+// Shaders converted from HLSL only include the referenced GLSL definitions when
+// EngineGLCreateInfo::FilterHLSL2GLSLDefinitions is set, so the tests attach a separate
+// device with this option to the context of the testing environment.
+class HLSL2GLSLConverterGLTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        auto* pEnv = TestingEnvironment::GetInstance();
+        if (!pEnv->GetDevice()->GetDeviceCaps().IsGLDevice())
+            return;
+
+#if EXPLICITLY_LOAD_ENGINE_GL_DLL
+        auto GetEngineFactoryOpenGL = LoadGraphicsEngineOpenGL();
+        ASSERT_NE(GetEngineFactoryOpenGL, nullptr);
+#endif
+        pEnv->GetDeviceContext()->Flush();
+
+        EngineGLCreateInfo CreateInfo;
+        CreateInfo.FilterHLSL2GLSLDefinitions = true;
+        GetEngineFactoryOpenGL()->AttachToActiveGLContext(CreateInfo, &sm_pDevice, &sm_pContext);
+        ASSERT_NE(sm_pDevice, nullptr);
+        ASSERT_NE(sm_pContext, nullptr);
+    }
+
+    static void TearDownTestSuite()
+    {
+        if (!sm_pDevice)
+            return;
+
+        sm_pContext->Flush();
+        sm_pContext->InvalidateState();
+        sm_pContext.Release();
+        sm_pDevice.Release();
+
+        // The device has modified the GL state of the shared context
+        TestingEnvironment::GetInstance()->GetDeviceContext()->InvalidateState();
+    }
+
+    virtual void SetUp() override
+    {
+        if (!sm_pDevice)
+            GTEST_SKIP() << "This test requires OpenGL device";
+    }
+
+    static RefCntAutoPtr<IShader> CreateTestShader(const char* FileName, const char* EntryPoint, SHADER_TYPE ShaderType)
+    {
+        RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
+        sm_pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders/HLSL2GLSLConverter", &pShaderSourceFactory);
+
+        ShaderCreateInfo ShaderCI;
+        ShaderCI.FilePath                   = FileName;
+        ShaderCI.EntryPoint                 = EntryPoint;
+        ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
+        ShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
+        ShaderCI.Desc.Name                  = "Test converted shader with filtered definitions";
+        ShaderCI.Desc.ShaderType            = ShaderType;
+        ShaderCI.UseCombinedTextureSamplers = true;
+
+        RefCntAutoPtr<IShader> pShader;
+        sm_pDevice->CreateShader(ShaderCI, &pShader);
+        return pShader;
+    }
+
+    static bool ComputeShadersSupported()
+    {
+        return sm_pDevice->GetDeviceCaps().Features.ComputeShaders;
+    }
+
+    static RefCntAutoPtr<IRenderDevice>  sm_pDevice;
+    static RefCntAutoPtr<IDeviceContext> sm_pContext;
+};
+
+RefCntAutoPtr<IRenderDevice>  HLSL2GLSLConverterGLTest::sm_pDevice;
+RefCntAutoPtr<IDeviceContext> HLSL2GLSLConverterGLTest::sm_pContext;
+
+TEST_F(HLSL2GLSLConverterGLTest, FilteredDefinitions_VS_PS)
+{
+    EXPECT_NE(CreateTestShader("VS_PS.hlsl", "TestVS", SHADER_TYPE_VERTEX), nullptr);
+    EXPECT_NE(CreateTestShader("VS_PS.hlsl", "TestPS", SHADER_TYPE_PIXEL), nullptr);
+}
+
+TEST_F(HLSL2GLSLConverterGLTest, FilteredDefinitions_CS)
+{
+    if (!ComputeShadersSupported())
+        GTEST_SKIP() << "This device does not support compute shaders";
+
+    EXPECT_NE(CreateTestShader("CS_RWTex1D.hlsl", "TestCS", SHADER_TYPE_COMPUTE), nullptr);
+    EXPECT_NE(CreateTestShader("CS_RWTex2D_1.hlsl", "TestCS", SHADER_TYPE_COMPUTE), nullptr);
+    EXPECT_NE(CreateTestShader("CS_RWTex2D_2.hlsl", "TestCS", SHADER_TYPE_COMPUTE), nullptr);
+    EXPECT_NE(CreateTestShader("CS_RWBuff.hlsl", "TestCS", SHADER_TYPE_COMPUTE), nullptr);
+}
+
+} // namespace
@@ -0,0 +1,160 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "../../include/GL/TestingEnvironmentGL.hpp"
+
+#include "BufferGL.h"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+constexpr Uint32 TexWidth  = 32;
+constexpr Uint32 TexHeight = 16;
+constexpr Uint32 NumSlices = 3;
+
+Uint32 GetTestTexel(Uint32 Slice, Uint32 x, Uint32 y)
+{
+    return (Slice * 0x01020304u) ^ (x * 0x00010000u + y * 0x00000100u + 0xFF000000u);
+}
+
+// Staging upload buffers are persistently mapped when immutable buffer storage is supported.
+// The CPU writes to the persistent pointer directly, and a fence guarantees that the GPU has
+// finished reading the previous data before it is overwritten.
+TEST(PersistentMappedBufferGLTest, StagingUpload)
+{
+    auto* pEnv     = TestingEnvironment::GetInstance();
+    auto* pDevice  = pEnv->GetDevice();
+    auto* pContext = pEnv->GetDeviceContext();
+
+    BufferDesc BuffDesc;
+    BuffDesc.Name           = "Persistently mapped staging buffer";
+    BuffDesc.Usage          = USAGE_STAGING;
+    BuffDesc.CPUAccessFlags = CPU_ACCESS_WRITE;
+    BuffDesc.uiSizeInBytes  = TexWidth * TexHeight * 4;
+    RefCntAutoPtr<IBuffer> pStagingBuffer;
+    pDevice->CreateBuffer(BuffDesc, nullptr, &pStagingBuffer);
+    ASSERT_NE(pStagingBuffer, nullptr);
+
+    RefCntAutoPtr<IBufferGL> pStagingBufferGL{pStagingBuffer, IID_BufferGL};
+    ASSERT_NE(pStagingBufferGL, nullptr);
+
+    auto* pPersistentData = reinterpret_cast<Uint32*>(pStagingBufferGL->GetPersistentMappedData());
+    if (pPersistentData == nullptr)
+    {
+        GTEST_SKIP() << "Immutable buffer storage is not supported by this device";
+    }
+
+    // Mapping the buffer must return the persistent pointer
+    {
+        PVoid pMappedData = nullptr;
+        pContext->MapBuffer(pStagingBuffer, MAP_WRITE, MAP_FLAG_NO_OVERWRITE, pMappedData);
+        EXPECT_EQ(pMappedData, pPersistentData);
+        pContext->UnmapBuffer(pStagingBuffer, MAP_WRITE);
+        EXPECT_EQ(pStagingBufferGL->GetPersistentMappedData(), pPersistentData);
+    }
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "Persistently mapped buffer test texture";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D_ARRAY;
+    TexDesc.Width     = TexWidth;
+    TexDesc.Height    = TexHeight;
+    TexDesc.ArraySize = NumSlices;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    TexDesc.BindFlags = BIND_SHADER_RESOURCE;
+    RefCntAutoPtr<ITexture> pTexture;
+    pDevice->CreateTexture(TexDesc, nullptr, &pTexture);
+    ASSERT_NE(pTexture, nullptr);
+
+    TexDesc.Name           = "Persistently mapped buffer test readback texture";
+    TexDesc.Usage          = USAGE_STAGING;
+    TexDesc.CPUAccessFlags = CPU_ACCESS_READ;
+    TexDesc.BindFlags      = BIND_NONE;
+    RefCntAutoPtr<ITexture> pReadbackTexture;
+    pDevice->CreateTexture(TexDesc, nullptr, &pReadbackTexture);
+    ASSERT_NE(pReadbackTexture, nullptr);
+
+    FenceDesc fenceDesc;
+    fenceDesc.Name = "Persistently mapped buffer test fence";
+    RefCntAutoPtr<IFence> pFence;
+    pDevice->CreateFence(fenceDesc, &pFence);
+    ASSERT_NE(pFence, nullptr);
+
+    // Every slice is uploaded from the same staging buffer. The buffer is only overwritten
+    // after the fence signaled after the previous upload has completed.
+    for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+    {
+        for (Uint32 y = 0; y < TexHeight; ++y)
+        {
+            for (Uint32 x = 0; x < TexWidth; ++x)
+                pPersistentData[x + y * TexWidth] = GetTestTexel(Slice, x, y);
+        }
+
+        TextureSubResData SubResData{pStagingBuffer, 0, TexWidth * 4};
+        Box               DstBox{0, TexWidth, 0, TexHeight};
+        pContext->UpdateTexture(pTexture, 0, Slice, DstBox, SubResData, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+        pContext->SignalFence(pFence, Slice + 1);
+        pContext->WaitForFence(pFence, Slice + 1, true);
+        EXPECT_GE(pFence->GetCompletedValue(), Uint64{Slice + 1});
+    }
+
+    for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+    {
+        CopyTextureAttribs CopyAttribs{pTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pReadbackTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+        CopyAttribs.SrcSlice = Slice;
+        CopyAttribs.DstSlice = Slice;
+        pContext->CopyTexture(CopyAttribs);
+    }
+    pContext->WaitForIdle();
+
+    for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+    {
+        MappedTextureSubresource MappedData;
+        pContext->MapTextureSubresource(pReadbackTexture, 0, Slice, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+        ASSERT_NE(MappedData.pData, nullptr);
+
+        Uint32 NumInvalidTexels = 0;
+        for (Uint32 y = 0; y < TexHeight; ++y)
+        {
+            const auto* pRow = reinterpret_cast<const Uint32*>(reinterpret_cast<const Uint8*>(MappedData.pData) + MappedData.Stride * y);
+            for (Uint32 x = 0; x < TexWidth; ++x)
+                NumInvalidTexels += pRow[x] != GetTestTexel(Slice, x, y) ? 1 : 0;
+        }
+        EXPECT_EQ(NumInvalidTexels, 0u) << "slice " << Slice;
+
+        pContext->UnmapTextureSubresource(pReadbackTexture, 0, Slice);
+    }
+
+    pEnv->Reset();
+}
+
+} // namespace
@@ -0,0 +1,360 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include <vector>
+#include <algorithm>
+
+#include "../../include/GL/TestingEnvironmentGL.hpp"
+
+#include "EngineFactoryOpenGL.h"
+#include "BufferGL.h"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+namespace HLSL
+{
+
+// clang-format off
+const std::string UniformBufferArenaTest_VS{
+R"(
+float4 main(in uint VertId : SV_VertexID) : SV_Position
+{
+    float2 Pos[3];
+    Pos[0] = float2(-1.0, -1.0);
+    Pos[1] = float2(-1.0, +3.0);
+    Pos[2] = float2(+3.0, -1.0);
+    return float4(Pos[VertId], 0.0, 1.0);
+}
+)"
+};
+
+const std::string UniformBufferArenaTest_PS{
+R"(
+cbuffer Constants
+{
+    float4 g_Color;
+};
+
+float4 main() : SV_Target
+{
+    return g_Color;
+}
+)"
+};
+// clang-format on
+
+} // namespace HLSL
+
+constexpr Uint32 PageSize = 4096;
+constexpr Uint32 RTSize   = 4;
+
+// Uniform buffer suballocation is disabled by default, so the tests attach a separate
+// device with a small page size to the context of the testing environment.
+class UniformBufferArenaGLTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        auto* pEnv = TestingEnvironment::GetInstance();
+        if (!pEnv->GetDevice()->GetDeviceCaps().IsGLDevice())
+            return;
+
+#if EXPLICITLY_LOAD_ENGINE_GL_DLL
+        auto GetEngineFactoryOpenGL = LoadGraphicsEngineOpenGL();
+        ASSERT_NE(GetEngineFactoryOpenGL, nullptr);
+#endif
+        pEnv->GetDeviceContext()->Flush();
+
+        EngineGLCreateInfo CreateInfo;
+        CreateInfo.UniformBufferArenaPageSize = PageSize;
+        GetEngineFactoryOpenGL()->AttachToActiveGLContext(CreateInfo, &sm_pDevice, &sm_pContext);
+        ASSERT_NE(sm_pDevice, nullptr);
+        ASSERT_NE(sm_pContext, nullptr);
+
+        GLint Alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &Alignment);
+        sm_OffsetAlignment = static_cast<Uint32>(Alignment);
+    }
+
+    static void TearDownTestSuite()
+    {
+        if (!sm_pDevice)
+            return;
+
+        sm_pContext->Flush();
+        sm_pContext->InvalidateState();
+        sm_pDevice->ReleaseStaleResources(true);
+        sm_pContext.Release();
+        sm_pDevice.Release();
+
+        // The device has modified the GL state of the shared context
+        TestingEnvironment::GetInstance()->GetDeviceContext()->InvalidateState();
+    }
+
+    virtual void SetUp() override
+    {
+        if (!sm_pDevice)
+            GTEST_SKIP() << "This test requires OpenGL device";
+    }
+
+    static RefCntAutoPtr<IBuffer> CreateUniformBuffer(Uint32 Size, const void* pData = nullptr)
+    {
+        BufferDesc BuffDesc;
+        BuffDesc.Name          = "Uniform buffer arena test buffer";
+        BuffDesc.Usage         = USAGE_DEFAULT;
+        BuffDesc.BindFlags     = BIND_UNIFORM_BUFFER;
+        BuffDesc.uiSizeInBytes = Size;
+
+        BufferData InitData{pData, pData != nullptr ? Size : 0};
+
+        RefCntAutoPtr<IBuffer> pBuffer;
+        sm_pDevice->CreateBuffer(BuffDesc, pData != nullptr ? &InitData : nullptr, &pBuffer);
+        VERIFY_EXPR(pBuffer);
+        return pBuffer;
+    }
+
+    struct BufferRange
+    {
+        GLuint GLHandle;
+        Uint32 Offset;
+    };
+    static BufferRange GetRange(IBuffer* pBuffer)
+    {
+        RefCntAutoPtr<IBufferGL> pBufferGL{pBuffer, IID_BufferGL};
+        VERIFY_EXPR(pBufferGL);
+        return BufferRange{pBufferGL->GetGLBufferHandle(), pBufferGL->GetGLBufferOffset()};
+    }
+
+    static RefCntAutoPtr<IRenderDevice>  sm_pDevice;
+    static RefCntAutoPtr<IDeviceContext> sm_pContext;
+    static Uint32                        sm_OffsetAlignment;
+};
+
+RefCntAutoPtr<IRenderDevice>  UniformBufferArenaGLTest::sm_pDevice;
+RefCntAutoPtr<IDeviceContext> UniformBufferArenaGLTest::sm_pContext;
+Uint32                        UniformBufferArenaGLTest::sm_OffsetAlignment = 0;
+
+TEST_F(UniformBufferArenaGLTest, OffsetAlignment)
+{
+    ASSERT_GT(sm_OffsetAlignment, 0u);
+
+    // Sizes that are not multiples of the alignment
+    const Uint32 Sizes[] = {16, 80, 48, 112, 16, 208};
+
+    std::vector<RefCntAutoPtr<IBuffer>> Buffers;
+    std::vector<BufferRange>            Ranges;
+    for (auto Size : Sizes)
+    {
+        Buffers.emplace_back(CreateUniformBuffer(Size));
+        Ranges.emplace_back(GetRange(Buffers.back()));
+    }
+
+    for (size_t i = 0; i < Ranges.size(); ++i)
+    {
+        EXPECT_EQ(Ranges[i].GLHandle, Ranges[0].GLHandle) << "All buffers must be suballocated from the same page";
+        EXPECT_EQ(Ranges[i].Offset % sm_OffsetAlignment, 0u) << "buffer " << i;
+        EXPECT_LE(Ranges[i].Offset + Sizes[i], PageSize) << "buffer " << i;
+        for (size_t j = 0; j < i; ++j)
+        {
+            const bool Overlap = Ranges[i].Offset < Ranges[j].Offset + Sizes[j] && Ranges[j].Offset < Ranges[i].Offset + Sizes[i];
+            EXPECT_FALSE(Overlap) << "buffers " << j << " and " << i << " overlap";
+        }
+    }
+
+    // Buffers that are larger than a quarter of the page have their own GL objects
+    auto pLargeBuffer = CreateUniformBuffer(PageSize / 2);
+    auto LargeRange   = GetRange(pLargeBuffer);
+    EXPECT_NE(LargeRange.GLHandle, Ranges[0].GLHandle);
+    EXPECT_EQ(LargeRange.Offset, 0u);
+}
+
+// Draws with several suballocated buffers bound in turn and checks that every draw reads its own range
+TEST_F(UniformBufferArenaGLTest, Binding)
+{
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
+    ShaderCI.UseCombinedTextureSamplers = true;
+    ShaderCI.EntryPoint                 = "main";
+
+    RefCntAutoPtr<IShader> pVS;
+    ShaderCI.Desc.ShaderType = SHADER_TYPE_VERTEX;
+    ShaderCI.Desc.Name       = "Uniform buffer arena test VS";
+    ShaderCI.Source          = HLSL::UniformBufferArenaTest_VS.c_str();
+    sm_pDevice->CreateShader(ShaderCI, &pVS);
+    ASSERT_NE(pVS, nullptr);
+
+    RefCntAutoPtr<IShader> pPS;
+    ShaderCI.Desc.ShaderType = SHADER_TYPE_PIXEL;
+    ShaderCI.Desc.Name       = "Uniform buffer arena test PS";
+    ShaderCI.Source          = HLSL::UniformBufferArenaTest_PS.c_str();
+    sm_pDevice->CreateShader(ShaderCI, &pPS);
+    ASSERT_NE(pPS, nullptr);
+
+    PipelineStateCreateInfo PSOCreateInfo;
+    PipelineStateDesc&      PSODesc = PSOCreateInfo.PSODesc;
+
+    PSODesc.Name                                          = "Uniform buffer arena test PSO";
+    PSODesc.GraphicsPipeline.pVS                          = pVS;
+    PSODesc.GraphicsPipeline.pPS                          = pPS;
+    PSODesc.GraphicsPipeline.PrimitiveTopology            = PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    PSODesc.GraphicsPipeline.NumRenderTargets             = 1;
+    PSODesc.GraphicsPipeline.RTVFormats[0]                = TEX_FORMAT_RGBA8_UNORM;
+    PSODesc.GraphicsPipeline.RasterizerDesc.CullMode      = CULL_MODE_NONE;
+    PSODesc.GraphicsPipeline.DepthStencilDesc.DepthEnable = False;
+    PSODesc.ResourceLayout.DefaultVariableType            = SHADER_RESOURCE_VARIABLE_TYPE_MUTABLE;
+
+    RefCntAutoPtr<IPipelineState> pPSO;
+    sm_pDevice->CreatePipelineState(PSOCreateInfo, &pPSO);
+    ASSERT_NE(pPSO, nullptr);
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "Uniform buffer arena test render target";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Width     = RTSize;
+    TexDesc.Height    = RTSize;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    TexDesc.BindFlags = BIND_RENDER_TARGET;
+    RefCntAutoPtr<ITexture> pRenderTarget;
+    sm_pDevice->CreateTexture(TexDesc, nullptr, &pRenderTarget);
+    ASSERT_NE(pRenderTarget, nullptr);
+
+    TexDesc.Name           = "Uniform buffer arena test readback texture";
+    TexDesc.Usage          = USAGE_STAGING;
+    TexDesc.CPUAccessFlags = CPU_ACCESS_READ;
+    TexDesc.BindFlags      = BIND_NONE;
+    RefCntAutoPtr<ITexture> pReadbackTexture;
+    sm_pDevice->CreateTexture(TexDesc, nullptr, &pReadbackTexture);
+    ASSERT_NE(pReadbackTexture, nullptr);
+
+    constexpr Uint32 NumBuffers = 8;
+
+    std::vector<RefCntAutoPtr<IBuffer>> Buffers;
+    std::vector<Uint32>                 ExpectedColors;
+    for (Uint32 i = 0; i < NumBuffers; ++i)
+    {
+        const Uint8 R = static_cast<Uint8>(i * 32);
+        const Uint8 G = static_cast<Uint8>(255 - i * 16);
+        const Uint8 B = static_cast<Uint8>(i * 8 + 1);
+
+        const float Color[4] = {R / 255.f, G / 255.f, B / 255.f, 1.f};
+        Buffers.emplace_back(CreateUniformBuffer(sizeof(Color), Color));
+        ExpectedColors.push_back(Uint32{R} | (Uint32{G} << 8u) | (Uint32{B} << 16u) | 0xFF000000u);
+    }
+    // Make sure the buffers actually share the page
+    for (Uint32 i = 1; i < NumBuffers; ++i)
+    {
+        EXPECT_EQ(GetRange(Buffers[i]).GLHandle, GetRange(Buffers[0]).GLHandle);
+        EXPECT_NE(GetRange(Buffers[i]).Offset, GetRange(Buffers[0]).Offset);
+    }
+
+    RefCntAutoPtr<IShaderResourceBinding> pSRB;
+    pPSO->CreateShaderResourceBinding(&pSRB, true);
+    ASSERT_NE(pSRB, nullptr);
+    auto* pConstantsVar = pSRB->GetVariableByName(SHADER_TYPE_PIXEL, "Constants");
+    ASSERT_NE(pConstantsVar, nullptr);
+
+    ITextureView* pRTVs[] = {pRenderTarget->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET)};
+    for (Uint32 i = 0; i < NumBuffers; ++i)
+    {
+        sm_pContext->SetRenderTargets(1, pRTVs, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+        const float ClearColor[] = {0.f, 0.f, 0.f, 0.f};
+        sm_pContext->ClearRenderTarget(pRTVs[0], ClearColor, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+        pConstantsVar->Set(Buffers[i]);
+        sm_pContext->SetPipelineState(pPSO);
+        sm_pContext->CommitShaderResources(pSRB, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+        DrawAttribs drawAttrs{3, DRAW_FLAG_VERIFY_ALL};
+        sm_pContext->Draw(drawAttrs);
+        sm_pContext->SetRenderTargets(0, nullptr, nullptr, RESOURCE_STATE_TRANSITION_MODE_NONE);
+
+        CopyTextureAttribs CopyAttribs{pRenderTarget, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pReadbackTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+        sm_pContext->CopyTexture(CopyAttribs);
+        sm_pContext->WaitForIdle();
+
+        MappedTextureSubresource MappedData;
+        sm_pContext->MapTextureSubresource(pReadbackTexture, 0, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+        ASSERT_NE(MappedData.pData, nullptr);
+        EXPECT_EQ(*reinterpret_cast<const Uint32*>(MappedData.pData), ExpectedColors[i]) << "buffer " << i;
+        sm_pContext->UnmapTextureSubresource(pReadbackTexture, 0, 0);
+    }
+}
+
+// Released ranges must not be reused until the GPU has finished the frame
+// they were released in, and must be reused afterwards
+TEST_F(UniformBufferArenaGLTest, PageRecycling)
+{
+    constexpr Uint32 BufferSize = 256;
+    constexpr Uint32 NumFrames  = 16;
+
+    // Keep one buffer alive so that the page is not empty
+    auto pPersistentBuffer = CreateUniformBuffer(BufferSize);
+    auto PageHandle        = GetRange(pPersistentBuffer).GLHandle;
+
+    for (Uint32 frame = 0; frame < NumFrames; ++frame)
+    {
+        auto pBuffer = CreateUniformBuffer(BufferSize);
+        auto Range   = GetRange(pBuffer);
+        EXPECT_EQ(Range.GLHandle, PageHandle) << "frame " << frame << ": no new pages must be created";
+        pBuffer.Release();
+
+        // The range has not been retired yet and must not be reused
+        auto pBuffer2 = CreateUniformBuffer(BufferSize);
+        auto Range2   = GetRange(pBuffer2);
+        EXPECT_FALSE(Range2.GLHandle == Range.GLHandle && Range2.Offset == Range.Offset) << "frame " << frame;
+        pBuffer2.Release();
+
+        // End of frame: both ranges are queued for release with a fence...
+        sm_pContext->Flush();
+        sm_pDevice->ReleaseStaleResources();
+        // ...and are returned to the free list once the fence has been signaled
+        sm_pContext->WaitForIdle();
+        sm_pDevice->ReleaseStaleResources();
+    }
+
+    // All released ranges have been recycled, so the whole page except for
+    // the persistent buffer must be available
+    // Both the buffer size and the alignment are powers of two
+    const Uint32 AlignedSize = std::max(BufferSize, sm_OffsetAlignment);
+
+    std::vector<RefCntAutoPtr<IBuffer>> Buffers;
+    for (Uint32 Size = AlignedSize; Size + AlignedSize <= PageSize; Size += AlignedSize)
+    {
+        Buffers.emplace_back(CreateUniformBuffer(BufferSize));
+        EXPECT_EQ(GetRange(Buffers.back()).GLHandle, PageHandle);
+    }
+}
+
+} // namespace
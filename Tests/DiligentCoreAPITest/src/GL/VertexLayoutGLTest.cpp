@@ -0,0 +1,408 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+#include "../../include/GL/TestingEnvironmentGL.hpp"
+#include "BasicMath.hpp"
+
+#include "gtest/gtest.h"
+
+#include "InlineShaders/DrawCommandTestHLSL.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+namespace HLSL
+{
+
+// clang-format off
+const std::string VertexLayoutTest_VS{
+R"(
+struct PSInput 
+{ 
+    float4 Pos   : SV_POSITION; 
+    float3 Color : COLOR; 
+};
+
+struct VSInput
+{
+    float4 Pos   : ATTRIB0;
+    float3 Color : ATTRIB1; 
+};
+
+void main(in  VSInput VSIn,
+          out PSInput PSIn) 
+{
+    PSIn.Pos   = VSIn.Pos;
+    PSIn.Color = VSIn.Color;
+}
+)"
+};
+// clang-format on
+
+} // namespace HLSL
+
+// Same triangles as generated by DrawTest_ProceduralTriangleVS
+// clang-format off
+const float4 Pos[] = 
+{
+    float4(-1.0f,  -0.5f,  0.f,  1.f),
+    float4(-0.5f,  +0.5f,  0.f,  1.f),
+    float4( 0.0f,  -0.5f,  0.f,  1.f),
+
+    float4(+0.0f,  -0.5f,  0.f,  1.f),
+    float4(+0.5f,  +0.5f,  0.f,  1.f),
+    float4(+1.0f,  -0.5f,  0.f,  1.f)
+};
+
+const float3 Color[] =
+{
+    float3(1.f,  0.f,  0.f),
+    float3(0.f,  1.f,  0.f),
+    float3(0.f,  0.f,  1.f),
+
+    float3(1.f,  0.f,  0.f),
+    float3(0.f,  1.f,  0.f),
+    float3(0.f,  0.f,  1.f)
+};
+// clang-format on
+
+constexpr Uint32 NumVertices = _countof(Pos);
+constexpr Uint32 RTSize      = 128;
+
+// Draws the triangles with the given input layout and compares the result with the
+// triangles rendered procedurally. On devices that support separate vertex format
+// (GL4.3+), layouts whose relative offsets do not exceed GL_MAX_VERTEX_ATTRIB_RELATIVE_OFFSET
+// are drawn with one VAO per input layout, while other layouts use the VAO-per-buffer-set path.
+class VertexLayoutGLTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        auto* pEnv    = TestingEnvironment::GetInstance();
+        auto* pDevice = pEnv->GetDevice();
+
+        TextureDesc TexDesc;
+        TexDesc.Name      = "Vertex layout test render target";
+        TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+        TexDesc.Width     = RTSize;
+        TexDesc.Height    = RTSize;
+        TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+        TexDesc.BindFlags = BIND_RENDER_TARGET;
+        pDevice->CreateTexture(TexDesc, nullptr, &sm_pRenderTarget);
+        ASSERT_NE(sm_pRenderTarget, nullptr);
+
+        TexDesc.Name           = "Vertex layout test readback texture";
+        TexDesc.Usage          = USAGE_STAGING;
+        TexDesc.CPUAccessFlags = CPU_ACCESS_READ;
+        TexDesc.BindFlags      = BIND_NONE;
+        pDevice->CreateTexture(TexDesc, nullptr, &sm_pReadbackTexture);
+        ASSERT_NE(sm_pReadbackTexture, nullptr);
+
+        ShaderCreateInfo ShaderCI;
+        ShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
+        ShaderCI.UseCombinedTextureSamplers = true;
+        ShaderCI.EntryPoint                 = "main";
+
+        ShaderCI.Desc.ShaderType = SHADER_TYPE_VERTEX;
+        ShaderCI.Desc.Name       = "Vertex layout test vertex shader";
+        ShaderCI.Source          = HLSL::VertexLayoutTest_VS.c_str();
+        pDevice->CreateShader(ShaderCI, &sm_pVS);
+        ASSERT_NE(sm_pVS, nullptr);
+
+        ShaderCI.Desc.Name = "Vertex layout test procedural vertex shader";
+        ShaderCI.Source    = HLSL::DrawTest_ProceduralTriangleVS.c_str();
+        RefCntAutoPtr<IShader> pProceduralVS;
+        pDevice->CreateShader(ShaderCI, &pProceduralVS);
+        ASSERT_NE(pProceduralVS, nullptr);
+
+        ShaderCI.Desc.ShaderType = SHADER_TYPE_PIXEL;
+        ShaderCI.Desc.Name       = "Vertex layout test pixel shader";
+        ShaderCI.Source          = HLSL::DrawTest_PS.c_str();
+        pDevice->CreateShader(ShaderCI, &sm_pPS);
+        ASSERT_NE(sm_pPS, nullptr);
+
+        auto pProceduralPSO = CreatePSO(pProceduralVS, nullptr, 0);
+        ASSERT_NE(pProceduralPSO, nullptr);
+        Draw(pProceduralPSO, nullptr, nullptr, 0);
+        ReadBack(sm_ReferenceData);
+
+        GLint MaxRelativeOffset = 0;
+#ifdef GL_MAX_VERTEX_ATTRIB_RELATIVE_OFFSET
+        glGetIntegerv(GL_MAX_VERTEX_ATTRIB_RELATIVE_OFFSET, &MaxRelativeOffset);
+#endif
+        if (glGetError() != GL_NO_ERROR || MaxRelativeOffset <= 0)
+        {
+            // Separate vertex format is not supported, all layouts use glVertexAttribPointer.
+            MaxRelativeOffset = 2047;
+        }
+        // The smallest 16-byte aligned offset that exceeds the limit
+        sm_LargeRelativeOffset = (static_cast<Uint32>(MaxRelativeOffset) + 16u) & ~15u;
+
+        sm_MaxVertexAttribStride = 2048;
+#ifdef GL_MAX_VERTEX_ATTRIB_STRIDE
+        GLint MaxStride = 0;
+        glGetIntegerv(GL_MAX_VERTEX_ATTRIB_STRIDE, &MaxStride);
+        if (glGetError() == GL_NO_ERROR && MaxStride > 0)
+            sm_MaxVertexAttribStride = static_cast<Uint32>(MaxStride);
+#endif
+    }
+
+    static void TearDownTestSuite()
+    {
+        sm_pRenderTarget.Release();
+        sm_pReadbackTexture.Release();
+        sm_pVS.Release();
+        sm_pPS.Release();
+        sm_ReferenceData.clear();
+
+        TestingEnvironment::GetInstance()->Reset();
+    }
+
+    static RefCntAutoPtr<IPipelineState> CreatePSO(IShader* pVS, const LayoutElement* pElements, Uint32 NumElements)
+    {
+        PipelineStateCreateInfo PSOCreateInfo;
+        PipelineStateDesc&      PSODesc = PSOCreateInfo.PSODesc;
+
+        PSODesc.Name = "Vertex layout test PSO";
+
+        PSODesc.IsComputePipeline                             = false;
+        PSODesc.GraphicsPipeline.NumRenderTargets             = 1;
+        PSODesc.GraphicsPipeline.RTVFormats[0]                = TEX_FORMAT_RGBA8_UNORM;
+        PSODesc.GraphicsPipeline.PrimitiveTopology            = PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        PSODesc.GraphicsPipeline.RasterizerDesc.CullMode      = CULL_MODE_NONE;
+        PSODesc.GraphicsPipeline.DepthStencilDesc.DepthEnable = False;
+
+        PSODesc.GraphicsPipeline.InputLayout.LayoutElements = pElements;
+        PSODesc.GraphicsPipeline.InputLayout.NumElements    = NumElements;
+        PSODesc.GraphicsPipeline.pVS                        = pVS;
+        PSODesc.GraphicsPipeline.pPS                        = sm_pPS;
+
+        RefCntAutoPtr<IPipelineState> pPSO;
+        TestingEnvironment::GetInstance()->GetDevice()->CreatePipelineState(PSOCreateInfo, &pPSO);
+        return pPSO;
+    }
+
+    static RefCntAutoPtr<IBuffer> CreateVertexBuffer(const std::vector<Uint8>& Data)
+    {
+        BufferDesc BuffDesc;
+        BuffDesc.Name          = "Vertex layout test vertex buffer";
+        BuffDesc.BindFlags     = BIND_VERTEX_BUFFER;
+        BuffDesc.uiSizeInBytes = static_cast<Uint32>(Data.size());
+
+        BufferData InitialData;
+        InitialData.pData    = Data.data();
+        InitialData.DataSize = BuffDesc.uiSizeInBytes;
+
+        RefCntAutoPtr<IBuffer> pBuffer;
+        TestingEnvironment::GetInstance()->GetDevice()->CreateBuffer(BuffDesc, &InitialData, &pBuffer);
+        VERIFY_EXPR(pBuffer);
+        return pBuffer;
+    }
+
+    static void Draw(IPipelineState* pPSO, IBuffer** ppVBs, Uint32* Offsets, Uint32 NumVBs)
+    {
+        auto* pContext = TestingEnvironment::GetInstance()->GetDeviceContext();
+
+        ITextureView* pRTVs[] = {sm_pRenderTarget->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET)};
+        pContext->SetRenderTargets(1, pRTVs, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+        const float ClearColor[] = {0.f, 0.f, 0.f, 0.f};
+        pContext->ClearRenderTarget(pRTVs[0], ClearColor, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+        pContext->SetPipelineState(pPSO);
+        pContext->CommitShaderResources(nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        if (NumVBs > 0)
+            pContext->SetVertexBuffers(0, NumVBs, ppVBs, Offsets, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, SET_VERTEX_BUFFERS_FLAG_RESET);
+
+        DrawAttribs drawAttrs{NumVertices, DRAW_FLAG_VERIFY_ALL};
+        pContext->Draw(drawAttrs);
+
+        pContext->SetRenderTargets(0, nullptr, nullptr, RESOURCE_STATE_TRANSITION_MODE_NONE);
+    }
+
+    static void ReadBack(std::vector<Uint8>& Data)
+    {
+        auto* pContext = TestingEnvironment::GetInstance()->GetDeviceContext();
+
+        CopyTextureAttribs CopyAttribs{sm_pRenderTarget, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, sm_pReadbackTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+        pContext->CopyTexture(CopyAttribs);
+        pContext->WaitForIdle();
+
+        MappedTextureSubresource MappedData;
+        pContext->MapTextureSubresource(sm_pReadbackTexture, 0, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+        ASSERT_NE(MappedData.pData, nullptr);
+
+        Data.resize(RTSize * RTSize * 4);
+        for (Uint32 y = 0; y < RTSize; ++y)
+            memcpy(&Data[y * RTSize * 4], reinterpret_cast<const Uint8*>(MappedData.pData) + MappedData.Stride * y, RTSize * 4);
+
+        pContext->UnmapTextureSubresource(sm_pReadbackTexture, 0, 0);
+    }
+
+    // Draws the triangles twice to make sure that rebinding the same buffers to a cached VAO works
+    static void TestLayout(const LayoutElement* pElements, Uint32 NumElements, IBuffer** ppVBs, Uint32* Offsets, Uint32 NumVBs)
+    {
+        auto pPSO = CreatePSO(sm_pVS, pElements, NumElements);
+        ASSERT_NE(pPSO, nullptr);
+
+        for (Uint32 i = 0; i < 2; ++i)
+        {
+            Draw(pPSO, ppVBs, Offsets, NumVBs);
+
+            std::vector<Uint8> Pixels;
+            ReadBack(Pixels);
+            ASSERT_EQ(Pixels.size(), sm_ReferenceData.size());
+            EXPECT_TRUE(memcmp(Pixels.data(), sm_ReferenceData.data(), Pixels.size()) == 0) << "draw " << i;
+        }
+    }
+
+    // Writes vertex attribute AttribData[v] to Data at Offset + v * Stride
+    template <typename AttribType>
+    static void WriteAttrib(std::vector<Uint8>& Data, const AttribType* AttribData, Uint32 Offset, Uint32 Stride)
+    {
+        Data.resize(std::max(Data.size(), Offset + size_t{Stride} * (NumVertices - 1) + sizeof(AttribType)));
+        for (Uint32 v = 0; v < NumVertices; ++v)
+            memcpy(&Data[Offset + v * Stride], &AttribData[v], sizeof(AttribType));
+    }
+
+    static RefCntAutoPtr<ITexture> sm_pRenderTarget;
+    static RefCntAutoPtr<ITexture> sm_pReadbackTexture;
+    static RefCntAutoPtr<IShader>  sm_pVS;
+    static RefCntAutoPtr<IShader>  sm_pPS;
+    static std::vector<Uint8>      sm_ReferenceData;
+    static Uint32                  sm_LargeRelativeOffset;
+    static Uint32                  sm_MaxVertexAttribStride;
+};
+
+RefCntAutoPtr<ITexture> VertexLayoutGLTest::sm_pRenderTarget;
+RefCntAutoPtr<ITexture> VertexLayoutGLTest::sm_pReadbackTexture;
+RefCntAutoPtr<IShader>  VertexLayoutGLTest::sm_pVS;
+RefCntAutoPtr<IShader>  VertexLayoutGLTest::sm_pPS;
+std::vector<Uint8>      VertexLayoutGLTest::sm_ReferenceData;
+Uint32                  VertexLayoutGLTest::sm_LargeRelativeOffset   = 0;
+Uint32                  VertexLayoutGLTest::sm_MaxVertexAttribStride = 0;
+
+TEST_F(VertexLayoutGLTest, Interleaved)
+{
+    constexpr Uint32 Stride = sizeof(float4) + sizeof(float3);
+
+    std::vector<Uint8> Data;
+    WriteAttrib(Data, Pos, 0, Stride);
+    WriteAttrib(Data, Color, sizeof(float4), Stride);
+    auto pVB = CreateVertexBuffer(Data);
+
+    // clang-format off
+    LayoutElement Elems[] =
+    {
+        LayoutElement{0, 0, 4, VT_FLOAT32},
+        LayoutElement{1, 0, 3, VT_FLOAT32}
+    };
+    // clang-format on
+    IBuffer* pVBs[]    = {pVB};
+    Uint32   Offsets[] = {0};
+    TestLayout(Elems, _countof(Elems), pVBs, Offsets, _countof(pVBs));
+}
+
+TEST_F(VertexLayoutGLTest, Split)
+{
+    std::vector<Uint8> PosData, ColorData;
+    WriteAttrib(PosData, Pos, 0, sizeof(float4));
+    WriteAttrib(ColorData, Color, 0, sizeof(float3));
+    auto pPosVB   = CreateVertexBuffer(PosData);
+    auto pColorVB = CreateVertexBuffer(ColorData);
+
+    // clang-format off
+    LayoutElement Elems[] =
+    {
+        LayoutElement{0, 0, 4, VT_FLOAT32},
+        LayoutElement{1, 1, 3, VT_FLOAT32}
+    };
+    // clang-format on
+    IBuffer* pVBs[]    = {pPosVB, pColorVB};
+    Uint32   Offsets[] = {0, 0};
+    TestLayout(Elems, _countof(Elems), pVBs, Offsets, _countof(pVBs));
+}
+
+TEST_F(VertexLayoutGLTest, Interleaved_LargeRelativeOffset)
+{
+    // Color is placed after a gap that exceeds the maximum relative offset
+    const Uint32 ColorOffset = sm_LargeRelativeOffset;
+    const Uint32 Stride      = ColorOffset + sizeof(float4);
+    if (Stride > sm_MaxVertexAttribStride)
+    {
+        GTEST_SKIP() << "Vertex stride " << Stride << " exceeds the maximum vertex attribute stride";
+    }
+
+    std::vector<Uint8> Data;
+    WriteAttrib(Data, Pos, 0, Stride);
+    WriteAttrib(Data, Color, ColorOffset, Stride);
+    auto pVB = CreateVertexBuffer(Data);
+
+    // clang-format off
+    LayoutElement Elems[] =
+    {
+        LayoutElement{0, 0, 4, VT_FLOAT32, False, 0,           Stride},
+        LayoutElement{1, 0, 3, VT_FLOAT32, False, ColorOffset, Stride}
+    };
+    // clang-format on
+    IBuffer* pVBs[]    = {pVB};
+    Uint32   Offsets[] = {0};
+    TestLayout(Elems, _countof(Elems), pVBs, Offsets, _countof(pVBs));
+}
+
+TEST_F(VertexLayoutGLTest, Split_LargeRelativeOffset)
+{
+    // Colors are stored in a separate buffer, after a gap that exceeds the maximum relative offset
+    const Uint32 ColorOffset = sm_LargeRelativeOffset;
+
+    std::vector<Uint8> PosData, ColorData;
+    WriteAttrib(PosData, Pos, 0, sizeof(float4));
+    WriteAttrib(ColorData, Color, ColorOffset, sizeof(float3));
+    auto pPosVB   = CreateVertexBuffer(PosData);
+    auto pColorVB = CreateVertexBuffer(ColorData);
+
+    // clang-format off
+    LayoutElement Elems[] =
+    {
+        LayoutElement{0, 0, 4, VT_FLOAT32, False, 0,           sizeof(float4)},
+        LayoutElement{1, 1, 3, VT_FLOAT32, False, ColorOffset, sizeof(float3)}
+    };
+    // clang-format on
+    IBuffer* pVBs[]    = {pPosVB, pColorVB};
+    Uint32   Offsets[] = {0, 0};
+    TestLayout(Elems, _countof(Elems), pVBs, Offsets, _countof(pVBs));
+}
+
+} // namespace
@@ -27,6 +27,13 @@
 
 #include "TestingEnvironment.hpp"
 #include "HLSL2GLSLConverter.h"
+#include "EngineFactoryOpenGL.h"
+#include "DataBlobImpl.hpp"
+#include "Timer.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -132,4 +139,362 @@ TEST(HLSL2GLSLConverterTest, CS_RWBuff)
     EXPECT_NE(pCS, nullptr);
 }
 
+
+TEST(HLSL2GLSLConverterTest, ConversionCache)
+{
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    if (!pDevice->GetDeviceCaps().IsGLDevice())
+    {
+        GTEST_SKIP() << "HLSL to GLSL converter is only available in OpenGL backend";
+    }
+
+    RefCntAutoPtr<IEngineFactoryOpenGL> pFactoryGL{pDevice->GetEngineFactory(), IID_EngineFactoryOpenGL};
+    ASSERT_NE(pFactoryGL, nullptr);
+
+    RefCntAutoPtr<IHLSL2GLSLConverter> pConverter;
+    pFactoryGL->CreateHLSL2GLSLConverter(&pConverter);
+    ASSERT_NE(pConverter, nullptr);
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
+    pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders/HLSL2GLSLConverter", &pShaderSourceFactory);
+    ASSERT_NE(pShaderSourceFactory, nullptr);
+
+    auto Convert = [&](const char* EntryPoint, SHADER_TYPE ShaderType, bool IncludeDefinitions, bool UseInOutLocationQualifiers) {
+        RefCntAutoPtr<IHLSL2GLSLConversionStream> pStream;
+        pConverter->CreateStream("VS_PS.hlsl", pShaderSourceFactory, nullptr, 0, &pStream);
+        if (!pStream)
+            return String{};
+
+        RefCntAutoPtr<IDataBlob> pGLSLSource;
+        pStream->Convert(EntryPoint, ShaderType, IncludeDefinitions, "_sampler", UseInOutLocationQualifiers, &pGLSLSource);
+        if (!pGLSLSource)
+            return String{};
+
+        return String{reinterpret_cast<const char*>(pGLSLSource->GetDataPtr()), pGLSLSource->GetSize()};
+    };
+
+    const auto VS0 = Convert("TestVS", SHADER_TYPE_VERTEX, true, false);
+    ASSERT_FALSE(VS0.empty());
+
+    // The second conversion is served by the cache and must produce identical source
+    const auto VS1 = Convert("TestVS", SHADER_TYPE_VERTEX, true, false);
+    EXPECT_EQ(VS0, VS1);
+
+    // Definitions are not stored in the cache
+    const auto VS2 = Convert("TestVS", SHADER_TYPE_VERTEX, false, false);
+    ASSERT_FALSE(VS2.empty());
+    EXPECT_LT(VS2.length(), VS0.length());
+    EXPECT_EQ(VS0.compare(VS0.length() - VS2.length(), VS2.length(), VS2), 0);
+
+    // Different entry points and options must not share results
+    const auto PS0 = Convert("TestPS", SHADER_TYPE_PIXEL, true, false);
+    ASSERT_FALSE(PS0.empty());
+    EXPECT_NE(VS0, PS0);
+
+    const auto PS1 = Convert("TestPS", SHADER_TYPE_PIXEL, true, true);
+    ASSERT_FALSE(PS1.empty());
+    EXPECT_NE(PS0, PS1);
+}
+
+String ReadTestShaderSource(IShaderSourceInputStreamFactory* pShaderSourceFactory, const char* FileName)
+{
+    RefCntAutoPtr<IFileStream> pSourceStream;
+    pShaderSourceFactory->CreateInputStream(FileName, &pSourceStream);
+    if (!pSourceStream)
+        return String{};
+
+    RefCntAutoPtr<IDataBlob> pSourceBlob{MakeNewRCObj<DataBlobImpl>()(0)};
+    pSourceStream->ReadBlob(pSourceBlob);
+    return String{reinterpret_cast<const Char*>(pSourceBlob->GetDataPtr()), pSourceBlob->GetSize()};
+}
+
+String ConvertStream(IHLSL2GLSLConversionStream* pStream, const char* EntryPoint, SHADER_TYPE ShaderType)
+{
+    RefCntAutoPtr<IDataBlob> pGLSLSource;
+    pStream->Convert(EntryPoint, ShaderType, false, "_sampler", false, &pGLSLSource);
+    if (!pGLSLSource)
+        return String{};
+
+    return String{reinterpret_cast<const char*>(pGLSLSource->GetDataPtr()), pGLSLSource->GetSize()};
+}
+
+// Conversion results are cached by the source, so tests that need the conversion to actually
+// be performed give every shader a unique source by prepending a marker comment. The marker
+// is then removed from the result.
+String RemoveMarker(String GLSL, const String& Marker)
+{
+    auto Pos = GLSL.find(Marker);
+    if (Pos != String::npos)
+        GLSL.erase(Pos, Marker.length());
+    return GLSL;
+}
+
+struct TestShaderInfo
+{
+    const char* FileName;
+    const char* EntryPoint;
+    SHADER_TYPE ShaderType;
+};
+// clang-format off
+static constexpr TestShaderInfo TestShaders[] =
+{
+    {"VS_PS.hlsl",        "TestVS", SHADER_TYPE_VERTEX },
+    {"VS_PS.hlsl",        "TestPS", SHADER_TYPE_PIXEL  },
+    {"CS_RWTex1D.hlsl",   "TestCS", SHADER_TYPE_COMPUTE},
+    {"CS_RWTex2D_1.hlsl", "TestCS", SHADER_TYPE_COMPUTE},
+    {"CS_RWTex2D_2.hlsl", "TestCS", SHADER_TYPE_COMPUTE},
+    {"CS_RWBuff.hlsl",    "TestCS", SHADER_TYPE_COMPUTE}
+};
+// clang-format on
+
+// Every conversion stream keeps the tokens of the source in a list whose nodes are allocated from the pool
+// owned by the stream. Converting several entry points from one stream works on copies of the list and must
+// produce the same results as converting each entry point from a new stream.
+TEST(HLSL2GLSLConverterTest, PreservedTokens)
+{
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    if (!pDevice->GetDeviceCaps().IsGLDevice())
+    {
+        GTEST_SKIP() << "HLSL to GLSL converter is only available in OpenGL backend";
+    }
+
+    RefCntAutoPtr<IEngineFactoryOpenGL> pFactoryGL{pDevice->GetEngineFactory(), IID_EngineFactoryOpenGL};
+    ASSERT_NE(pFactoryGL, nullptr);
+
+    RefCntAutoPtr<IHLSL2GLSLConverter> pConverter;
+    pFactoryGL->CreateHLSL2GLSLConverter(&pConverter);
+    ASSERT_NE(pConverter, nullptr);
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
+    pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders/HLSL2GLSLConverter", &pShaderSourceFactory);
+    ASSERT_NE(pShaderSourceFactory, nullptr);
+
+    const auto HLSLSource = ReadTestShaderSource(pShaderSourceFactory, "VS_PS.hlsl");
+    ASSERT_FALSE(HLSLSource.empty());
+
+    auto Convert = [&](IHLSL2GLSLConversionStream* pStream, const String& Marker, const char* EntryPoint, SHADER_TYPE ShaderType) {
+        return RemoveMarker(ConvertStream(pStream, EntryPoint, ShaderType), Marker);
+    };
+    auto CreateStream = [&](const String& Marker) {
+        const auto Source = Marker + "\n" + HLSLSource;
+
+        RefCntAutoPtr<IHLSL2GLSLConversionStream> pStream;
+        pConverter->CreateStream("VS_PS.hlsl", pShaderSourceFactory, Source.c_str(), Source.length(), &pStream);
+        return pStream;
+    };
+
+    const String MarkerVS0 = "// PreservedTokens VS0";
+    const String MarkerPS0 = "// PreservedTokens PS0";
+    const String MarkerVS1 = "// PreservedTokens VS1";
+
+    auto pRefVSStream = CreateStream(MarkerVS0);
+    ASSERT_NE(pRefVSStream, nullptr);
+    const auto RefVS = Convert(pRefVSStream, MarkerVS0, "TestVS", SHADER_TYPE_VERTEX);
+    ASSERT_FALSE(RefVS.empty());
+
+    auto pRefPSStream = CreateStream(MarkerPS0);
+    ASSERT_NE(pRefPSStream, nullptr);
+    const auto RefPS = Convert(pRefPSStream, MarkerPS0, "TestPS", SHADER_TYPE_PIXEL);
+    ASSERT_FALSE(RefPS.empty());
+
+    auto pStream = CreateStream(MarkerVS1);
+    ASSERT_NE(pStream, nullptr);
+    EXPECT_EQ(Convert(pStream, MarkerVS1, "TestVS", SHADER_TYPE_VERTEX), RefVS);
+    EXPECT_EQ(Convert(pStream, MarkerVS1, "TestPS", SHADER_TYPE_PIXEL), RefPS);
+}
+
+// Performance benchmark. Run with --gtest_also_run_disabled_tests
+TEST(HLSL2GLSLConverterTest, DISABLED_ConversionThroughput)
+{
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    if (!pDevice->GetDeviceCaps().IsGLDevice())
+    {
+        GTEST_SKIP() << "HLSL to GLSL converter is only available in OpenGL backend";
+    }
+
+    RefCntAutoPtr<IEngineFactoryOpenGL> pFactoryGL{pDevice->GetEngineFactory(), IID_EngineFactoryOpenGL};
+    ASSERT_NE(pFactoryGL, nullptr);
+
+    RefCntAutoPtr<IHLSL2GLSLConverter> pConverter;
+    pFactoryGL->CreateHLSL2GLSLConverter(&pConverter);
+    ASSERT_NE(pConverter, nullptr);
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
+    pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders/HLSL2GLSLConverter", &pShaderSourceFactory);
+    ASSERT_NE(pShaderSourceFactory, nullptr);
+
+    constexpr Uint32 NumIterations = 20;
+    for (const auto& ShaderInfo : TestShaders)
+    {
+        const auto HLSLSource = ReadTestShaderSource(pShaderSourceFactory, ShaderInfo.FileName);
+        ASSERT_FALSE(HLSLSource.empty());
+
+        // Make every source unique so that the results are not served by the conversion cache
+        std::vector<String> Sources(NumIterations);
+        for (Uint32 i = 0; i < NumIterations; ++i)
+            Sources[i] = "// Iteration " + std::to_string(i) + "\n" + HLSLSource;
+
+        Timer T;
+        for (const auto& Source : Sources)
+        {
+            RefCntAutoPtr<IHLSL2GLSLConversionStream> pStream;
+            pConverter->CreateStream(ShaderInfo.FileName, pShaderSourceFactory, Source.c_str(), Source.length(), &pStream);
+            ASSERT_NE(pStream, nullptr);
+            EXPECT_FALSE(ConvertStream(pStream, ShaderInfo.EntryPoint, ShaderInfo.ShaderType).empty());
+        }
+        auto ElapsedTime = T.GetElapsedTime();
+
+        LOG_INFO_MESSAGE(ShaderInfo.FileName, " (", ShaderInfo.EntryPoint, "): ",
+                         static_cast<double>(HLSLSource.length() * NumIterations) / (ElapsedTime * 1024.0 * 1024.0), " MB/s");
+    }
+}
+
+TEST(HLSL2GLSLConverterTest, ConvertBatch)
+{
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    if (!pDevice->GetDeviceCaps().IsGLDevice())
+    {
+        GTEST_SKIP() << "HLSL to GLSL converter is only available in OpenGL backend";
+    }
+
+    RefCntAutoPtr<IEngineFactoryOpenGL> pFactoryGL{pDevice->GetEngineFactory(), IID_EngineFactoryOpenGL};
+    ASSERT_NE(pFactoryGL, nullptr);
+
+    RefCntAutoPtr<IHLSL2GLSLConverter> pConverter;
+    pFactoryGL->CreateHLSL2GLSLConverter(&pConverter);
+    ASSERT_NE(pConverter, nullptr);
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
+    pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders/HLSL2GLSLConverter", &pShaderSourceFactory);
+    ASSERT_NE(pShaderSourceFactory, nullptr);
+
+    constexpr size_t NumTestShaders = _countof(TestShaders);
+
+    std::vector<String>                   RefGLSL(NumTestShaders);
+    std::vector<String>                   Markers(NumTestShaders);
+    std::vector<String>                   Sources(NumTestShaders);
+    std::vector<HLSL2GLSLBatchShaderDesc> Shaders(NumTestShaders + 1);
+    for (size_t i = 0; i < NumTestShaders; ++i)
+    {
+        const auto& ShaderInfo = TestShaders[i];
+
+        RefCntAutoPtr<IHLSL2GLSLConversionStream> pStream;
+        pConverter->CreateStream(ShaderInfo.FileName, pShaderSourceFactory, nullptr, 0, &pStream);
+        ASSERT_NE(pStream, nullptr);
+        RefGLSL[i] = ConvertStream(pStream, ShaderInfo.EntryPoint, ShaderInfo.ShaderType);
+        ASSERT_FALSE(RefGLSL[i].empty());
+
+        Markers[i] = "// ConvertBatch " + std::to_string(i);
+        Sources[i] = Markers[i] + "\n" + ReadTestShaderSource(pShaderSourceFactory, ShaderInfo.FileName);
+
+        auto& Shader                      = Shaders[i];
+        Shader.InputFileName              = ShaderInfo.FileName;
+        Shader.pSourceStreamFactory       = pShaderSourceFactory;
+        Shader.HLSLSource                 = Sources[i].c_str();
+        Shader.NumSymbols                 = Sources[i].length();
+        Shader.EntryPoint                 = ShaderInfo.EntryPoint;
+        Shader.ShaderType                 = ShaderInfo.ShaderType;
+        Shader.UseInOutLocationQualifiers = false;
+    }
+
+    // A shader that fails to convert must not affect other shaders
+    auto& InvalidShader                = Shaders.back();
+    InvalidShader.InputFileName        = "NonExistingFile.hlsl";
+    InvalidShader.pSourceStreamFactory = pShaderSourceFactory;
+    InvalidShader.ShaderType           = SHADER_TYPE_VERTEX;
+
+    std::vector<IDataBlob*> GLSLSources(Shaders.size());
+    pConverter->ConvertBatch(Shaders.data(), static_cast<Uint32>(Shaders.size()), 4, GLSLSources.data());
+
+    for (size_t i = 0; i < NumTestShaders; ++i)
+    {
+        RefCntAutoPtr<IDataBlob> pGLSLSource;
+        pGLSLSource.Attach(GLSLSources[i]);
+        ASSERT_NE(pGLSLSource, nullptr) << TestShaders[i].FileName << " (" << TestShaders[i].EntryPoint << ")";
+
+        const String GLSL{reinterpret_cast<const char*>(pGLSLSource->GetDataPtr()), pGLSLSource->GetSize()};
+        EXPECT_EQ(RemoveMarker(GLSL, Markers[i]), RefGLSL[i]) << TestShaders[i].FileName << " (" << TestShaders[i].EntryPoint << ")";
+    }
+    EXPECT_EQ(GLSLSources.back(), nullptr);
+}
+
+// Performance benchmark. Run with --gtest_also_run_disabled_tests
+TEST(HLSL2GLSLConverterTest, DISABLED_ConvertBatchScaling)
+{
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    if (!pDevice->GetDeviceCaps().IsGLDevice())
+    {
+        GTEST_SKIP() << "HLSL to GLSL converter is only available in OpenGL backend";
+    }
+
+    RefCntAutoPtr<IEngineFactoryOpenGL> pFactoryGL{pDevice->GetEngineFactory(), IID_EngineFactoryOpenGL};
+    ASSERT_NE(pFactoryGL, nullptr);
+
+    RefCntAutoPtr<IHLSL2GLSLConverter> pConverter;
+    pFactoryGL->CreateHLSL2GLSLConverter(&pConverter);
+    ASSERT_NE(pConverter, nullptr);
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
+    pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders/HLSL2GLSLConverter", &pShaderSourceFactory);
+    ASSERT_NE(pShaderSourceFactory, nullptr);
+
+    std::vector<String> HLSLSources;
+    for (const auto& ShaderInfo : TestShaders)
+    {
+        HLSLSources.emplace_back(ReadTestShaderSource(pShaderSourceFactory, ShaderInfo.FileName));
+        ASSERT_FALSE(HLSLSources.back().empty());
+    }
+
+    constexpr Uint32 NumCopies  = 16;
+    const Uint32     MaxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    double SingleThreadTime = 0;
+    for (Uint32 NumThreads = 1; NumThreads <= MaxThreads; ++NumThreads)
+    {
+        // Make every source unique so that the results are not served by the conversion cache
+        std::vector<String>                   Sources;
+        std::vector<HLSL2GLSLBatchShaderDesc> Shaders;
+        Sources.reserve(_countof(TestShaders) * NumCopies);
+        for (Uint32 Copy = 0; Copy < NumCopies; ++Copy)
+        {
+            for (size_t i = 0; i < _countof(TestShaders); ++i)
+            {
+                Sources.emplace_back("// Threads " + std::to_string(NumThreads) + ", copy " + std::to_string(Copy) + "\n" + HLSLSources[i]);
+
+                HLSL2GLSLBatchShaderDesc Shader;
+                Shader.InputFileName        = TestShaders[i].FileName;
+                Shader.pSourceStreamFactory = pShaderSourceFactory;
+                Shader.HLSLSource           = Sources.back().c_str();
+                Shader.NumSymbols           = Sources.back().length();
+                Shader.EntryPoint           = TestShaders[i].EntryPoint;
+                Shader.ShaderType           = TestShaders[i].ShaderType;
+                Shaders.push_back(Shader);
+            }
+        }
+
+        std::vector<IDataBlob*> GLSLSources(Shaders.size());
+
+        Timer T;
+        pConverter->ConvertBatch(Shaders.data(), static_cast<Uint32>(Shaders.size()), NumThreads, GLSLSources.data());
+        auto ElapsedTime = T.GetElapsedTime();
+
+        for (auto* pGLSLSource : GLSLSources)
+        {
+            EXPECT_NE(pGLSLSource, nullptr);
+            if (pGLSLSource != nullptr)
+                pGLSLSource->Release();
+        }
+
+        if (NumThreads == 1)
+            SingleThreadTime = ElapsedTime;
+
+        LOG_INFO_MESSAGE(NumThreads, " thread(s): ", Shaders.size(), " shaders in ", ElapsedTime * 1000.0, " ms, speedup: ", SingleThreadTime / ElapsedTime);
+    }
+}
+
 } // namespace
@@ -39,6 +39,10 @@ namespace Testing
 
 NativeWindow TestingEnvironment::CreateNativeWindow()
 {
+    // GL resource creation worker threads share the display connection.
+    // This must be the first Xlib call.
+    XInitThreads();
+
     auto* display = XOpenDisplay(0);
 
     // clang-format off
@@ -279,9 +279,9 @@ TEST_F(MultithreadedResourceCreationTest, CreateResources)
 {
     auto* pEnv    = TestingEnvironment::GetInstance();
     auto* pDevice = pEnv->GetDevice();
-    if (pDevice->GetDeviceCaps().IsGLDevice())
+    if (!pDevice->GetDeviceCaps().Features.MultithreadedResourceCreation)
     {
-        GTEST_SKIP() << "Multithreading resource creation is not supported in OpenGL";
+        GTEST_SKIP() << "Multithreaded resource creation is not supported by this device";
     }
 
 #if D3D12_SUPPORTED
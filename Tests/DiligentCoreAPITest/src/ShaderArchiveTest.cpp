@@ -0,0 +1,315 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <cstring>
+
+#include "ShaderArchive.hpp"
+#include "DataBlobImpl.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "TestingEnvironment.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+ShaderCreateInfo GetShaderCI(const ShaderMacro* Macros, SHADER_TYPE ShaderType = SHADER_TYPE_PIXEL)
+{
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.FilePath        = "shaders\\Test.psh";
+    ShaderCI.EntryPoint      = "main";
+    ShaderCI.Macros          = Macros;
+    ShaderCI.Desc.ShaderType = ShaderType;
+    return ShaderCI;
+}
+
+DeviceCaps GetGL43Caps()
+{
+    DeviceCaps Caps;
+    Caps.DevType                        = RENDER_DEVICE_TYPE_GL;
+    Caps.MajorVersion                   = 4;
+    Caps.MinorVersion                   = 3;
+    Caps.Features.SeparablePrograms     = True;
+    Caps.Features.ComputeShaders        = True;
+    Caps.TexCaps.CubemapArraysSupported = True;
+    Caps.TexCaps.Texture2DMSSupported   = True;
+    return Caps;
+}
+
+TEST(ShaderArchive, WriteRead)
+{
+    const ShaderMacro Macros0[] = {{"A", "0"}, {"B", "1"}, {}};
+    const ShaderMacro Macros1[] = {{"A", "1"}, {"B", "1"}, {}};
+    const ShaderMacro Macros2[] = {{"A", "2"}, {"B", "1"}, {}};
+
+    const std::vector<Uint32> SPIRV0 = {0x07230203, 1, 2, 3};
+    const std::vector<Uint32> SPIRV1 = {0x07230203, 4, 5, 6, 7};
+
+    ShaderArchiveWriter Writer;
+    Writer.SetGLSLTarget(GetShaderArchiveGLSLTarget(GetGL43Caps()));
+    EXPECT_TRUE(Writer.AddShader(GetShaderCI(Macros0), SPIRV0, "GLSL0"));
+    EXPECT_TRUE(Writer.AddShader(GetShaderCI(Macros1), SPIRV1, "GLSL1"));
+    // Same byte code as the first permutation
+    EXPECT_TRUE(Writer.AddShader(GetShaderCI(Macros2), SPIRV0, "GLSL0"));
+    // Same permutation for a different shader stage
+    EXPECT_TRUE(Writer.AddShader(GetShaderCI(Macros0, SHADER_TYPE_VERTEX), {}, "GLSL0"));
+    // Duplicate permutation
+    EXPECT_FALSE(Writer.AddShader(GetShaderCI(Macros1), SPIRV1, "GLSL1"));
+
+    const auto& Stats = Writer.GetStatistics();
+    EXPECT_EQ(Stats.NumShaders, 4u);
+    EXPECT_EQ(Stats.NumBlobs, 4u);
+    EXPECT_EQ(Stats.NumDuplicateBlobs, 3u);
+
+    std::vector<Uint8> Data;
+    Writer.Serialize(Data);
+
+    ShaderArchiveReader Reader{Data.data(), Data.size()};
+    EXPECT_EQ(Reader.GetNumShaders(), 4u);
+    EXPECT_TRUE(IsShaderArchiveGLSLTargetCompatible(Reader.GetGLSLTarget(), GetGL43Caps()));
+
+    // The order of macros and the path separators must not matter
+    const ShaderMacro Macros1Reordered[] = {{"B", "1"}, {"A", "1"}, {}};
+
+    auto ShaderCI     = GetShaderCI(Macros1Reordered);
+    ShaderCI.FilePath = "shaders/Test.psh";
+
+    ShaderArchiveReader::ShaderData ShaderData;
+    ASSERT_TRUE(Reader.FindShader(ShaderCI, ShaderData));
+    ASSERT_EQ(ShaderData.SPIRVSize, SPIRV1.size() * sizeof(Uint32));
+    EXPECT_EQ(memcmp(ShaderData.pSPIRV, SPIRV1.data(), ShaderData.SPIRVSize), 0);
+    EXPECT_EQ(std::string(ShaderData.GLSL, ShaderData.GLSLLength), "GLSL1");
+
+    ShaderArchiveReader::ShaderData ShaderData0, ShaderData2;
+    ASSERT_TRUE(Reader.FindShader(GetShaderCI(Macros0), ShaderData0));
+    ASSERT_TRUE(Reader.FindShader(GetShaderCI(Macros2), ShaderData2));
+    // Identical blobs are stored once
+    EXPECT_EQ(ShaderData0.pSPIRV, ShaderData2.pSPIRV);
+    EXPECT_EQ(ShaderData0.GLSL, ShaderData2.GLSL);
+
+    ShaderArchiveReader::ShaderData VSData;
+    ASSERT_TRUE(Reader.FindShader(GetShaderCI(Macros0, SHADER_TYPE_VERTEX), VSData));
+    EXPECT_EQ(VSData.pSPIRV, nullptr);
+    EXPECT_EQ(VSData.GLSL, ShaderData0.GLSL);
+
+    const ShaderMacro MissingMacros[] = {{"A", "3"}, {"B", "1"}, {}};
+    EXPECT_FALSE(Reader.FindShader(GetShaderCI(MissingMacros), ShaderData));
+    EXPECT_FALSE(Reader.FindShader(GetShaderCI(Macros0, SHADER_TYPE_COMPUTE), ShaderData));
+
+    // Source language and combined sampler options are part of the key
+    ShaderCI                = GetShaderCI(Macros0);
+    ShaderCI.SourceLanguage = SHADER_SOURCE_LANGUAGE_GLSL;
+    EXPECT_FALSE(Reader.FindShader(ShaderCI, ShaderData));
+
+    ShaderCI                            = GetShaderCI(Macros0);
+    ShaderCI.UseCombinedTextureSamplers = true;
+    EXPECT_FALSE(Reader.FindShader(ShaderCI, ShaderData));
+}
+
+TEST(ShaderArchive, CombinedSamplerSuffix)
+{
+    auto ShaderCI                       = GetShaderCI(nullptr);
+    ShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
+    ShaderCI.UseCombinedTextureSamplers = true;
+
+    ShaderArchiveWriter Writer;
+    Writer.SetGLSLTarget(GetShaderArchiveGLSLTarget(GetGL43Caps()));
+    EXPECT_TRUE(Writer.AddShader(ShaderCI, {}, "GLSL"));
+
+    std::vector<Uint8> Data;
+    Writer.Serialize(Data);
+    ShaderArchiveReader Reader{Data.data(), Data.size()};
+
+    ShaderArchiveReader::ShaderData ShaderData;
+    EXPECT_TRUE(Reader.FindShader(ShaderCI, ShaderData));
+
+    ShaderCI.CombinedSamplerSuffix = "_smplr";
+    EXPECT_FALSE(Reader.FindShader(ShaderCI, ShaderData));
+
+    // The suffix is ignored when samplers are not combined
+    auto SeparateCI                       = ShaderCI;
+    SeparateCI.UseCombinedTextureSamplers = false;
+    auto SeparateCI2                      = SeparateCI;
+    SeparateCI2.CombinedSamplerSuffix     = "_sampler";
+    EXPECT_EQ(GetShaderArchiveKeyString(SeparateCI), GetShaderArchiveKeyString(SeparateCI2));
+}
+
+TEST(ShaderArchive, ManyPermutations)
+{
+    constexpr Uint32 NumPermutations = 1000;
+
+    std::vector<std::string> Values(NumPermutations);
+    ShaderArchiveWriter      Writer;
+    Writer.SetGLSLTarget(GetShaderArchiveGLSLTarget(GetGL43Caps()));
+    for (Uint32 i = 0; i < NumPermutations; ++i)
+    {
+        Values[i] = std::to_string(i);
+
+        const ShaderMacro Macros[] = {{"VALUE", Values[i].c_str()}, {}};
+        EXPECT_TRUE(Writer.AddShader(GetShaderCI(Macros), {}, "GLSL" + Values[i]));
+    }
+
+    std::vector<Uint8> Data;
+    Writer.Serialize(Data);
+
+    ShaderArchiveReader Reader{Data.data(), Data.size()};
+    for (Uint32 i = 0; i < NumPermutations; ++i)
+    {
+        const ShaderMacro Macros[] = {{"VALUE", Values[i].c_str()}, {}};
+
+        ShaderArchiveReader::ShaderData ShaderData;
+        ASSERT_TRUE(Reader.FindShader(GetShaderCI(Macros), ShaderData));
+        EXPECT_EQ(std::string(ShaderData.GLSL, ShaderData.GLSLLength), "GLSL" + Values[i]);
+    }
+
+    const ShaderMacro MissingMacros[] = {{"VALUE", "-1"}, {}};
+
+    ShaderArchiveReader::ShaderData ShaderData;
+    EXPECT_FALSE(Reader.FindShader(GetShaderCI(MissingMacros), ShaderData));
+}
+
+TEST(ShaderArchive, InvalidData)
+{
+    ShaderArchiveWriter Writer;
+    Writer.SetGLSLTarget(GetShaderArchiveGLSLTarget(GetGL43Caps()));
+    Writer.AddShader(GetShaderCI(nullptr), {}, "GLSL");
+
+    std::vector<Uint8> Data;
+    Writer.Serialize(Data);
+
+    TestingEnvironment::SetErrorAllowance(2, "\n\nNo worries, testing invalid shader archives...\n\n");
+
+    EXPECT_THROW(ShaderArchiveReader(Data.data(), sizeof(ShaderArchiveHeader) / 2), std::runtime_error);
+
+    Data[0] ^= 0xFF;
+    EXPECT_THROW(ShaderArchiveReader(Data.data(), Data.size()), std::runtime_error);
+}
+
+TEST(ShaderArchive, GLSLTarget)
+{
+    const auto GL43Caps = GetGL43Caps();
+    const auto Target   = GetShaderArchiveGLSLTarget(GL43Caps);
+    EXPECT_TRUE(IsShaderArchiveGLSLTargetCompatible(Target, GL43Caps));
+
+    // Desktop GLSL may be used on a later GL version, but not on an earlier one
+    auto Caps         = GL43Caps;
+    Caps.MinorVersion = 6;
+    EXPECT_TRUE(IsShaderArchiveGLSLTargetCompatible(Target, Caps));
+    Caps.MinorVersion = 2;
+    EXPECT_FALSE(IsShaderArchiveGLSLTargetCompatible(Target, Caps));
+
+    // GLES source must match the version exactly
+    Caps              = GL43Caps;
+    Caps.DevType      = RENDER_DEVICE_TYPE_GLES;
+    Caps.MajorVersion = 3;
+    Caps.MinorVersion = 1;
+    EXPECT_FALSE(IsShaderArchiveGLSLTargetCompatible(Target, Caps));
+    auto GLESTarget = GetShaderArchiveGLSLTarget(Caps);
+    EXPECT_TRUE(IsShaderArchiveGLSLTargetCompatible(GLESTarget, Caps));
+    Caps.MinorVersion = 2;
+    EXPECT_FALSE(IsShaderArchiveGLSLTargetCompatible(GLESTarget, Caps));
+
+    // All features the source was built with must be supported
+    Caps                         = GL43Caps;
+    Caps.Features.ComputeShaders = False;
+    EXPECT_FALSE(IsShaderArchiveGLSLTargetCompatible(Target, Caps));
+    EXPECT_TRUE(IsShaderArchiveGLSLTargetCompatible(GetShaderArchiveGLSLTarget(Caps), GL43Caps));
+
+    // Separable programs change the shader interface and must match exactly
+    Caps                            = GL43Caps;
+    Caps.Features.SeparablePrograms = False;
+    EXPECT_FALSE(IsShaderArchiveGLSLTargetCompatible(Target, Caps));
+    EXPECT_FALSE(IsShaderArchiveGLSLTargetCompatible(GetShaderArchiveGLSLTarget(Caps), GL43Caps));
+
+    // Archive without GLSL source
+    EXPECT_FALSE(IsShaderArchiveGLSLTargetCompatible(ShaderArchiveGLSLTarget{}, GL43Caps));
+}
+
+TEST(ShaderArchive, CreateShaderGL)
+{
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    if (!pDevice->GetDeviceCaps().IsGLDevice())
+    {
+        GTEST_SKIP() << "GLSL source from shader archives is only used by OpenGL backend";
+    }
+
+    static constexpr char GLSLSource[] = R"(
+#version 430 core
+layout(local_size_x = 4, local_size_y = 4, local_size_z = 1) in;
+void main()
+{
+}
+)";
+
+    const ShaderMacro Macros[] = {{"VALUE", "1"}, {}};
+
+    auto ShaderCI = GetShaderCI(Macros, SHADER_TYPE_COMPUTE);
+
+    auto CreateArchive = [&](const ShaderArchiveGLSLTarget& Target) -> RefCntAutoPtr<DataBlobImpl> {
+        ShaderArchiveWriter Writer;
+        Writer.SetGLSLTarget(Target);
+        Writer.AddShader(ShaderCI, {}, GLSLSource);
+
+        std::vector<Uint8> Data;
+        Writer.Serialize(Data);
+
+        RefCntAutoPtr<DataBlobImpl> pArchive{MakeNewRCObj<DataBlobImpl>()(Data.size())};
+        memcpy(pArchive->GetDataPtr(), Data.data(), Data.size());
+        return pArchive;
+    };
+
+    const auto& DevCaps  = pDevice->GetDeviceCaps();
+    auto        pArchive = CreateArchive(GetShaderArchiveGLSLTarget(DevCaps));
+
+    ShaderCI.Desc.Name      = "Shader archive test";
+    ShaderCI.pShaderArchive = pArchive;
+
+    {
+        RefCntAutoPtr<IShader> pShader;
+        pDevice->CreateShader(ShaderCI, &pShader);
+        EXPECT_NE(pShader, nullptr);
+    }
+
+    // The archive built for a later version must be rejected
+    auto Target = GetShaderArchiveGLSLTarget(DevCaps);
+    Target.MajorVersion += 1;
+    auto pIncompatibleArchive = CreateArchive(Target);
+    ShaderCI.pShaderArchive   = pIncompatibleArchive;
+
+    TestingEnvironment::SetErrorAllowance(2, "\n\nNo worries, testing incompatible shader archive...\n\n");
+    {
+        RefCntAutoPtr<IShader> pShader;
+        pDevice->CreateShader(ShaderCI, &pShader);
+        EXPECT_EQ(pShader, nullptr);
+    }
+}
+
+} // namespace
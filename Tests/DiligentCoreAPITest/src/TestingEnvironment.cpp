@@ -275,6 +275,8 @@ TestingEnvironment::TestingEnvironment(RENDER_DEVICE_TYPE deviceType, ADAPTER_TY
             CreateInfo.Window               = Window;
             CreateInfo.CreateDebugContext   = true;
 
+            CreateInfo.NumResourceCreationThreads = 2;
+
             if (NumDeferredCtx != 0)
             {
                 LOG_ERROR_MESSAGE("Deferred contexts are not supported in OpenGL mode");
@@ -306,6 +308,7 @@ TestingEnvironment::TestingEnvironment(RENDER_DEVICE_TYPE deviceType, ADAPTER_TY
             CreateInfo.MainDescriptorPoolSize    = VulkanDescriptorPoolSize{64, 64, 256, 256, 64, 32, 32, 32, 32};
             CreateInfo.DynamicDescriptorPoolSize = VulkanDescriptorPoolSize{64, 64, 256, 256, 64, 32, 32, 32, 32};
             CreateInfo.UploadHeapPageSize        = 32 * 1024;
+            CreateInfo.ResourceLayoutCacheSize   = 16 << 20;
             //CreateInfo.DeviceLocalMemoryReserveSize = 32 << 20;
             //CreateInfo.HostVisibleMemoryReserveSize = 48 << 20;
 
@@ -213,4 +213,142 @@ TEST(TextureUploaderTest, WorkerThread)
     TextureUploaderTest(false);
 }
 
+
+Uint8 GetTestTexelByte(Uint32 Slice, Uint32 x, Uint32 y, Uint32 Byte)
+{
+    return static_cast<Uint8>((Slice * 31 + x * 7 + y * 13 + Byte * 5) & 0xFF);
+}
+
+// Uploads every slice of the texture through a recycled upload buffer without waiting for the GPU
+// in between. The uploader must not reuse a buffer until the GPU has finished the copy from it,
+// otherwise data of earlier slices gets overwritten. The texture width is odd, so that the row
+// pitch of the upload buffer is larger than the tightly packed row size.
+void TextureUploaderRecycleTest(bool IsRenderThread)
+{
+    auto* pEnv     = TestingEnvironment::GetInstance();
+    auto* pDevice  = pEnv->GetDevice();
+    auto* pContext = pEnv->GetDeviceContext();
+
+    TextureUploaderDesc             UploaderDesc;
+    RefCntAutoPtr<ITextureUploader> pTexUploader;
+    CreateTextureUploader(pDevice, UploaderDesc, &pTexUploader);
+    ASSERT_TRUE(pTexUploader);
+
+    constexpr Uint32 TexelSize = 2;
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "Texture uploader recycle test dst texture";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D_ARRAY;
+    TexDesc.Width     = 67;
+    TexDesc.Height    = 33;
+    TexDesc.MipLevels = 1;
+    TexDesc.ArraySize = 16;
+    TexDesc.BindFlags = BIND_SHADER_RESOURCE;
+    TexDesc.Format    = TEX_FORMAT_RG8_UNORM;
+    RefCntAutoPtr<ITexture> pDstTexture;
+    pDevice->CreateTexture(TexDesc, nullptr, &pDstTexture);
+    ASSERT_TRUE(pDstTexture);
+
+    TexDesc.Name           = "Texture uploader recycle test staging texture";
+    TexDesc.Usage          = USAGE_STAGING;
+    TexDesc.CPUAccessFlags = CPU_ACCESS_READ;
+    TexDesc.BindFlags      = BIND_NONE;
+    RefCntAutoPtr<ITexture> pStagingTexture;
+    pDevice->CreateTexture(TexDesc, nullptr, &pStagingTexture);
+    ASSERT_TRUE(pStagingTexture);
+
+    UploadBufferDesc UploadBuffDesc;
+    UploadBuffDesc.Width  = TexDesc.Width;
+    UploadBuffDesc.Height = TexDesc.Height;
+    UploadBuffDesc.Format = TexDesc.Format;
+
+    std::atomic_bool AllSlicesUploaded{false};
+
+    auto UploadSlices = [&](IDeviceContext* pCtx) //
+    {
+        for (Uint32 Slice = 0; Slice < TexDesc.ArraySize; ++Slice)
+        {
+            RefCntAutoPtr<IUploadBuffer> pUploadBuffer;
+            pTexUploader->AllocateUploadBuffer(pCtx, UploadBuffDesc, &pUploadBuffer);
+
+            const auto& MappedData = pUploadBuffer->GetMappedData(0, 0);
+            EXPECT_GE(MappedData.Stride, TexDesc.Width * TexelSize);
+            for (Uint32 y = 0; y < TexDesc.Height; ++y)
+            {
+                auto* pRow = reinterpret_cast<Uint8*>(MappedData.pData) + MappedData.Stride * y;
+                for (Uint32 x = 0; x < TexDesc.Width; ++x)
+                {
+                    for (Uint32 b = 0; b < TexelSize; ++b)
+                        pRow[x * TexelSize + b] = GetTestTexelByte(Slice, x, y, b);
+                }
+            }
+
+            pTexUploader->ScheduleGPUCopy(pCtx, pDstTexture, Slice, 0, pUploadBuffer);
+            if (pCtx == nullptr)
+                pUploadBuffer->WaitForCopyScheduled();
+            pTexUploader->RecycleBuffer(pUploadBuffer);
+        }
+        AllSlicesUploaded.store(true);
+    };
+
+    if (IsRenderThread)
+    {
+        UploadSlices(pContext);
+    }
+    else
+    {
+        std::thread WokerThread{UploadSlices, nullptr};
+        while (!AllSlicesUploaded)
+        {
+            pTexUploader->RenderThreadUpdate(pContext);
+        }
+        WokerThread.join();
+    }
+
+    for (Uint32 Slice = 0; Slice < TexDesc.ArraySize; ++Slice)
+    {
+        CopyTextureAttribs CopyAttribs{pDstTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pStagingTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+        CopyAttribs.SrcSlice = Slice;
+        CopyAttribs.DstSlice = Slice;
+        pContext->CopyTexture(CopyAttribs);
+    }
+    pContext->WaitForIdle();
+
+    for (Uint32 Slice = 0; Slice < TexDesc.ArraySize; ++Slice)
+    {
+        MappedTextureSubresource MappedData;
+        pContext->MapTextureSubresource(pStagingTexture, 0, Slice, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+
+        Uint32 NumInvalidTexels = 0;
+        for (Uint32 y = 0; y < TexDesc.Height; ++y)
+        {
+            const auto* pRow = reinterpret_cast<const Uint8*>(MappedData.pData) + MappedData.Stride * y;
+            for (Uint32 x = 0; x < TexDesc.Width; ++x)
+            {
+                for (Uint32 b = 0; b < TexelSize; ++b)
+                {
+                    if (pRow[x * TexelSize + b] != GetTestTexelByte(Slice, x, y, b))
+                    {
+                        ++NumInvalidTexels;
+                        break;
+                    }
+                }
+            }
+        }
+        EXPECT_EQ(NumInvalidTexels, 0u) << "slice " << Slice;
+
+        pContext->UnmapTextureSubresource(pStagingTexture, 0, Slice);
+    }
+}
+
+TEST(TextureUploaderTest, RecycleBuffersRenderThread)
+{
+    TextureUploaderRecycleTest(true);
+}
+
+TEST(TextureUploaderTest, RecycleBuffersWorkerThread)
+{
+    TextureUploaderRecycleTest(false);
+}
+
 } // namespace
@@ -0,0 +1,155 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "TestingEnvironment.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+// clang-format off
+const std::string SampleTextureCS{
+R"(
+cbuffer Constants
+{
+    float4 g_Scale;
+};
+
+Texture2D    g_Tex;
+SamplerState g_Tex_sampler;
+
+RWTexture2D</*format=rgba8*/ float4> g_Output;
+
+[numthreads(8, 8, 1)]
+void main(uint3 DTid : SV_DispatchThreadID)
+{
+    g_Output[DTid.xy] = g_Tex.SampleLevel(g_Tex_sampler, float2(DTid.xy) * g_Scale.xy, 0.0);
+}
+)"
+};
+// clang-format on
+
+RefCntAutoPtr<IPipelineState> CreateComputePSO(IShader* pCS, SHADER_RESOURCE_VARIABLE_TYPE TexVarType)
+{
+    auto* pDevice = TestingEnvironment::GetInstance()->GetDevice();
+
+    PipelineStateCreateInfo PSOCreateInfo;
+
+    auto& PSODesc = PSOCreateInfo.PSODesc;
+
+    PSODesc.Name                = "Resource layout cache test";
+    PSODesc.IsComputePipeline   = true;
+    PSODesc.ComputePipeline.pCS = pCS;
+
+    // clang-format off
+    ShaderResourceVariableDesc Vars[] =
+    {
+        {SHADER_TYPE_COMPUTE, "g_Tex",    TexVarType},
+        {SHADER_TYPE_COMPUTE, "g_Output", SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC}
+    };
+    StaticSamplerDesc StaticSamplers[] =
+    {
+        {SHADER_TYPE_COMPUTE, "g_Tex", SamplerDesc{}}
+    };
+    // clang-format on
+    PSODesc.ResourceLayout.Variables         = Vars;
+    PSODesc.ResourceLayout.NumVariables      = _countof(Vars);
+    PSODesc.ResourceLayout.StaticSamplers    = StaticSamplers;
+    PSODesc.ResourceLayout.NumStaticSamplers = _countof(StaticSamplers);
+
+    RefCntAutoPtr<IPipelineState> pPSO;
+    pDevice->CreatePipelineState(PSOCreateInfo, &pPSO);
+    return pPSO;
+}
+
+// The second pipeline with the same shaders and resource layout is initialized from
+// the resource layout cache and must be indistinguishable from the first one.
+TEST(ResourceLayoutCacheTest, IdenticalPipelines)
+{
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    if (!pDevice->GetDeviceCaps().IsVulkanDevice())
+    {
+        GTEST_SKIP() << "Resource layout cache is only used by Vulkan backend";
+    }
+
+    TestingEnvironment::ScopedReleaseResources EnvironmentAutoReset;
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
+    ShaderCI.UseCombinedTextureSamplers = true;
+    ShaderCI.Desc.ShaderType            = SHADER_TYPE_COMPUTE;
+    ShaderCI.EntryPoint                 = "main";
+    ShaderCI.Desc.Name                  = "Resource layout cache test";
+    ShaderCI.Source                     = SampleTextureCS.c_str();
+    RefCntAutoPtr<IShader> pCS;
+    pDevice->CreateShader(ShaderCI, &pCS);
+    ASSERT_NE(pCS, nullptr);
+
+    auto pPSO0 = CreateComputePSO(pCS, SHADER_RESOURCE_VARIABLE_TYPE_MUTABLE);
+    auto pPSO1 = CreateComputePSO(pCS, SHADER_RESOURCE_VARIABLE_TYPE_MUTABLE);
+    ASSERT_NE(pPSO0, nullptr);
+    ASSERT_NE(pPSO1, nullptr);
+    EXPECT_TRUE(pPSO0->IsCompatibleWith(pPSO1));
+    EXPECT_TRUE(pPSO1->IsCompatibleWith(pPSO0));
+
+    for (auto* pPSO : {pPSO0.RawPtr(), pPSO1.RawPtr()})
+    {
+        // Only the constant buffer uses the default static type
+        EXPECT_EQ(pPSO->GetStaticVariableCount(SHADER_TYPE_COMPUTE), 1u);
+        EXPECT_NE(pPSO->GetStaticVariableByName(SHADER_TYPE_COMPUTE, "Constants"), nullptr);
+
+        RefCntAutoPtr<IShaderResourceBinding> pSRB;
+        pPSO->CreateShaderResourceBinding(&pSRB, false);
+        ASSERT_NE(pSRB, nullptr);
+
+        // The immutable sampler is not exposed as a variable
+        EXPECT_EQ(pSRB->GetVariableCount(SHADER_TYPE_COMPUTE), 2u);
+        auto* pTexVar = pSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_Tex");
+        ASSERT_NE(pTexVar, nullptr);
+        EXPECT_EQ(pTexVar->GetType(), SHADER_RESOURCE_VARIABLE_TYPE_MUTABLE);
+        auto* pOutputVar = pSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_Output");
+        ASSERT_NE(pOutputVar, nullptr);
+        EXPECT_EQ(pOutputVar->GetType(), SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC);
+        EXPECT_EQ(pSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_Tex_sampler"), nullptr);
+    }
+
+    // The resource layout description is a part of the key, so a different
+    // variable type must not be restored from the entry added above
+    auto pPSO2 = CreateComputePSO(pCS, SHADER_RESOURCE_VARIABLE_TYPE_STATIC);
+    ASSERT_NE(pPSO2, nullptr);
+    EXPECT_EQ(pPSO2->GetStaticVariableCount(SHADER_TYPE_COMPUTE), 2u);
+    auto* pTexVar = pPSO2->GetStaticVariableByName(SHADER_TYPE_COMPUTE, "g_Tex");
+    ASSERT_NE(pTexVar, nullptr);
+    EXPECT_EQ(pTexVar->GetType(), SHADER_RESOURCE_VARIABLE_TYPE_STATIC);
+}
+
+} // namespace
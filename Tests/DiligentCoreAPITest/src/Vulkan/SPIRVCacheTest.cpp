@@ -0,0 +1,105 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "TestingEnvironment.hpp"
+#include "SPIRVUtils.hpp"
+#include "SPIRVCache.hpp"
+
+#include "InlineShaders/ComputeShaderTestHLSL.h"
+#include "InlineShaders/ComputeShaderTestGLSL.h"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+std::vector<unsigned int> CompileHLSL(const std::string& Source, const ShaderMacro* Macros, SPIRVCache& Cache)
+{
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.Source          = Source.c_str();
+    ShaderCI.EntryPoint      = "main";
+    ShaderCI.Macros          = Macros;
+    ShaderCI.SourceLanguage  = SHADER_SOURCE_LANGUAGE_HLSL;
+    ShaderCI.Desc.ShaderType = SHADER_TYPE_COMPUTE;
+    return HLSLtoSPIRV(ShaderCI, nullptr, nullptr, &Cache);
+}
+
+TEST(SPIRVCacheTest, HLSL)
+{
+    auto* pEnv = TestingEnvironment::GetInstance();
+    if (!pEnv->GetDevice()->GetDeviceCaps().IsVulkanDevice())
+    {
+        GTEST_SKIP() << "SPIRV compilation is only available in Vulkan backend";
+    }
+
+    SPIRVCache Cache;
+
+    const auto SPIRV0 = CompileHLSL(HLSL::FillTextureCS, nullptr, Cache);
+    ASSERT_FALSE(SPIRV0.empty());
+    EXPECT_EQ(Cache.GetStatistics().NumMisses, Uint64{1});
+    EXPECT_EQ(Cache.GetNumEntries(), size_t{1});
+
+    const auto SPIRV1 = CompileHLSL(HLSL::FillTextureCS, nullptr, Cache);
+    EXPECT_EQ(SPIRV0, SPIRV1);
+    EXPECT_EQ(Cache.GetStatistics().NumMemoryHits, Uint64{1});
+
+    // Macros are a part of the key
+    ShaderMacro Macros[] = {{"UNUSED_MACRO", "1"}, {}};
+    const auto  SPIRV3   = CompileHLSL(HLSL::FillTextureCS, Macros, Cache);
+    EXPECT_FALSE(SPIRV3.empty());
+    EXPECT_EQ(Cache.GetStatistics().NumMisses, Uint64{2});
+    EXPECT_EQ(Cache.GetNumEntries(), size_t{2});
+
+    EXPECT_DOUBLE_EQ(Cache.GetStatistics().GetHitRate(), 1.0 / 3.0);
+}
+
+TEST(SPIRVCacheTest, GLSL)
+{
+    auto* pEnv = TestingEnvironment::GetInstance();
+    if (!pEnv->GetDevice()->GetDeviceCaps().IsVulkanDevice())
+    {
+        GTEST_SKIP() << "SPIRV compilation is only available in Vulkan backend";
+    }
+
+    SPIRVCache Cache;
+
+    const auto& Source = GLSL::FillTextureCS;
+    const auto  SPIRV0 = GLSLtoSPIRV(SHADER_TYPE_COMPUTE, Source.c_str(), static_cast<int>(Source.length()), nullptr, &Cache);
+    ASSERT_FALSE(SPIRV0.empty());
+
+    const auto SPIRV1 = GLSLtoSPIRV(SHADER_TYPE_COMPUTE, Source.c_str(), static_cast<int>(Source.length()), nullptr, &Cache);
+    EXPECT_EQ(SPIRV0, SPIRV1);
+
+    const auto Stats = Cache.GetStatistics();
+    EXPECT_EQ(Stats.NumMisses, Uint64{1});
+    EXPECT_EQ(Stats.NumMemoryHits, Uint64{1});
+}
+
+} // namespace
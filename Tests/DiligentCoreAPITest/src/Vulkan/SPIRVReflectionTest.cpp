@@ -0,0 +1,250 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <chrono>
+
+#include "TestingEnvironment.hpp"
+#include "SPIRVUtils.hpp"
+#include "SPIRVReflection.hpp"
+#include "SPIRVShaderResources.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+
+#include "SPIRV-Cross/spirv_parser.hpp"
+#include "SPIRV-Cross/spirv_cross.hpp"
+
+#include "InlineShaders/ComputeShaderTestGLSL.h"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+const std::string ReflectionTestVS = R"(
+cbuffer Constants
+{
+    float4 g_Scale;
+};
+
+Texture2D    g_Tex2D[2];
+SamplerState g_Tex2D_sampler;
+
+StructuredBuffer<float4>   g_ROBuffer;
+RWStructuredBuffer<float4> g_RWBuffer;
+RWTexture2D<float4>        g_RWTex;
+Buffer<float4>             g_UniformTexelBuff;
+RWBuffer<float4>           g_StorageTexelBuff;
+
+struct VSInput
+{
+    float3 Pos : ATTRIB0;
+    float2 UV  : ATTRIB1;
+};
+
+float4 main(VSInput In) : SV_Position
+{
+    float4 Color = g_Tex2D[0].SampleLevel(g_Tex2D_sampler, In.UV, 0.0) + g_Tex2D[1].SampleLevel(g_Tex2D_sampler, In.UV, 0.0);
+    Color += g_ROBuffer[0] + g_UniformTexelBuff.Load(0) + g_RWTex[int2(0, 0)];
+    g_RWBuffer[0]         = Color;
+    g_StorageTexelBuff[0] = Color;
+    return float4(In.Pos, 1.0) * g_Scale + Color;
+}
+)";
+
+template <typename SPIRVCrossResources>
+void CompareResources(const diligent_spirv_cross::Compiler&         Compiler,
+                      const SPIRVCrossResources&                    RefResources,
+                      const std::vector<SPIRVReflection::Resource>& Resources,
+                      bool                                          IsStageInput = false)
+{
+    ASSERT_EQ(RefResources.size(), Resources.size());
+    for (size_t i = 0; i < Resources.size(); ++i)
+    {
+        const auto& RefRes = RefResources[i];
+        const auto& Res    = Resources[i];
+
+        EXPECT_EQ(RefRes.id, Res.Id);
+        EXPECT_STREQ(RefRes.name.c_str(), Res.Name);
+        EXPECT_STREQ(Compiler.get_name(RefRes.id).c_str(), Res.VariableName);
+
+        const auto& Type = Compiler.get_type(RefRes.type_id);
+        EXPECT_EQ(Type.array.size(), size_t{Res.NumArrayDims}) << Res.Name;
+        EXPECT_EQ(Type.array.empty() ? 1u : Type.array[0], Res.ArraySize) << Res.Name;
+
+        if (IsStageInput)
+        {
+            uint32_t LocationOffset = 0;
+            EXPECT_TRUE(Compiler.get_binary_offset_for_decoration(RefRes.id, spv::DecorationLocation, LocationOffset));
+            EXPECT_EQ(LocationOffset, Res.LocationDecorationOffset) << Res.Name;
+            ASSERT_NE(Res.HLSLSemantic, nullptr);
+            EXPECT_STREQ(Compiler.get_decoration_string(RefRes.id, spv::DecorationHlslSemanticGOOGLE).c_str(), Res.HLSLSemantic);
+        }
+        else
+        {
+            uint32_t BindingOffset = 0, DescriptorSetOffset = 0;
+            EXPECT_TRUE(Compiler.get_binary_offset_for_decoration(RefRes.id, spv::DecorationBinding, BindingOffset));
+            EXPECT_TRUE(Compiler.get_binary_offset_for_decoration(RefRes.id, spv::DecorationDescriptorSet, DescriptorSetOffset));
+            EXPECT_EQ(BindingOffset, Res.BindingDecorationOffset) << Res.Name;
+            EXPECT_EQ(DescriptorSetOffset, Res.DescriptorSetDecorationOffset) << Res.Name;
+            EXPECT_EQ(Type.image.dim == spv::DimBuffer, Res.IsTexelBuffer) << Res.Name;
+        }
+    }
+}
+
+// Validates native reflection against SPIRV-Cross and measures the time it takes to reflect the shader
+void TestReflection(const std::vector<unsigned int>& SPIRV, SHADER_TYPE ShaderType, const char* Name)
+{
+    ASSERT_FALSE(SPIRV.empty());
+
+    diligent_spirv_cross::Parser Parser{SPIRV};
+    Parser.parse();
+    const bool                     IsHLSLSource = Parser.get_parsed_ir().source.hlsl;
+    diligent_spirv_cross::Compiler Compiler{std::move(Parser.get_parsed_ir())};
+
+    const auto RefResources   = Compiler.get_shader_resources();
+    const auto RefEntryPoints = Compiler.get_entry_points_and_stages();
+
+    SPIRVReflection Reflection{SPIRV};
+    const auto&     EntryPoints = Reflection.GetEntryPoints();
+    ASSERT_EQ(RefEntryPoints.size(), EntryPoints.size());
+    for (size_t i = 0; i < EntryPoints.size(); ++i)
+    {
+        EXPECT_STREQ(RefEntryPoints[i].name.c_str(), EntryPoints[i].Name);
+        EXPECT_EQ(static_cast<Uint32>(RefEntryPoints[i].execution_model), EntryPoints[i].ExecutionModel);
+    }
+    EXPECT_EQ(IsHLSLSource, Reflection.IsHLSLSource());
+
+    SPIRVReflection::ShaderResources Resources;
+    Reflection.GetShaderResources(EntryPoints[0], Resources);
+
+    CompareResources(Compiler, RefResources.uniform_buffers, Resources.UniformBuffers);
+    CompareResources(Compiler, RefResources.storage_buffers, Resources.StorageBuffers);
+    CompareResources(Compiler, RefResources.storage_images, Resources.StorageImages);
+    CompareResources(Compiler, RefResources.sampled_images, Resources.SampledImages);
+    CompareResources(Compiler, RefResources.atomic_counters, Resources.AtomicCounters);
+    CompareResources(Compiler, RefResources.separate_images, Resources.SeparateImages);
+    CompareResources(Compiler, RefResources.separate_samplers, Resources.SeparateSamplers);
+    if (Reflection.IsHLSLSource())
+        CompareResources(Compiler, RefResources.stage_inputs, Resources.StageInputs, true);
+
+    for (size_t i = 0; i < Resources.StorageBuffers.size(); ++i)
+    {
+        const auto Flags = Compiler.get_buffer_block_flags(RefResources.storage_buffers[i].id);
+        EXPECT_EQ(Flags.get(spv::DecorationNonWritable), Resources.StorageBuffers[i].IsReadOnly) << Resources.StorageBuffers[i].Name;
+    }
+
+    constexpr int NumIterations = 100;
+
+    auto StartTime = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < NumIterations; ++i)
+    {
+        diligent_spirv_cross::Parser RefParser{SPIRV};
+        RefParser.parse();
+        diligent_spirv_cross::Compiler RefCompiler{std::move(RefParser.get_parsed_ir())};
+        RefCompiler.get_shader_resources();
+    }
+    const auto SPIRVCrossTime = std::chrono::high_resolution_clock::now() - StartTime;
+
+    StartTime = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < NumIterations; ++i)
+    {
+        ShaderDesc Desc;
+        Desc.Name       = Name;
+        Desc.ShaderType = ShaderType;
+
+        std::string          EntryPoint;
+        SPIRVShaderResources ShaderResources{DefaultRawMemoryAllocator::GetAllocator(), nullptr, SPIRV, Desc, "_sampler", true, EntryPoint};
+    }
+    const auto NativeTime = std::chrono::high_resolution_clock::now() - StartTime;
+
+    using MicroSeconds = std::chrono::duration<double, std::micro>;
+    LOG_INFO_MESSAGE("Reflection time per shader for '", Name, "' (", SPIRV.size(), " words): SPIRV-Cross: ",
+                     MicroSeconds{SPIRVCrossTime}.count() / NumIterations, " us, SPIRVShaderResources: ",
+                     MicroSeconds{NativeTime}.count() / NumIterations, " us");
+}
+
+TEST(SPIRVReflectionTest, HLSL)
+{
+    auto* pEnv = TestingEnvironment::GetInstance();
+    if (!pEnv->GetDevice()->GetDeviceCaps().IsVulkanDevice())
+    {
+        GTEST_SKIP() << "SPIRV compilation is only available in Vulkan backend";
+    }
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.Source          = ReflectionTestVS.c_str();
+    ShaderCI.EntryPoint      = "main";
+    ShaderCI.SourceLanguage  = SHADER_SOURCE_LANGUAGE_HLSL;
+    ShaderCI.Desc.ShaderType = SHADER_TYPE_VERTEX;
+    const auto SPIRV         = HLSLtoSPIRV(ShaderCI, nullptr, nullptr);
+
+    TestReflection(SPIRV, SHADER_TYPE_VERTEX, "Reflection test VS");
+
+    ShaderDesc Desc;
+    Desc.Name       = "Reflection test VS";
+    Desc.ShaderType = SHADER_TYPE_VERTEX;
+
+    std::string          EntryPoint;
+    SPIRVShaderResources Resources{DefaultRawMemoryAllocator::GetAllocator(), nullptr, SPIRV, Desc, "_sampler", true, EntryPoint};
+    EXPECT_EQ(EntryPoint, "main");
+    EXPECT_TRUE(Resources.IsHLSLSource());
+    EXPECT_EQ(Resources.GetNumUBs(), Uint32{1});
+    EXPECT_EQ(Resources.GetNumSBs(), Uint32{2});
+    EXPECT_EQ(Resources.GetNumImgs(), Uint32{2});
+    EXPECT_EQ(Resources.GetNumSepImgs(), Uint32{2});
+    EXPECT_EQ(Resources.GetNumSepSmplrs(), Uint32{1});
+    EXPECT_EQ(Resources.GetNumShaderStageInputs(), Uint32{2});
+    ASSERT_EQ(Resources.GetNumUBs(), Uint32{1});
+    EXPECT_STREQ(Resources.GetUB(0).Name, "Constants");
+    for (Uint32 i = 0; i < Resources.GetNumSepImgs(); ++i)
+    {
+        const auto& SepImg = Resources.GetSepImg(i);
+        if (strcmp(SepImg.Name, "g_Tex2D") == 0)
+        {
+            EXPECT_EQ(SepImg.ArraySize, 2);
+            ASSERT_TRUE(SepImg.IsValidSepSamplerAssigned());
+            EXPECT_STREQ(Resources.GetAssignedSepSampler(SepImg).Name, "g_Tex2D_sampler");
+        }
+    }
+}
+
+TEST(SPIRVReflectionTest, GLSL)
+{
+    auto* pEnv = TestingEnvironment::GetInstance();
+    if (!pEnv->GetDevice()->GetDeviceCaps().IsVulkanDevice())
+    {
+        GTEST_SKIP() << "SPIRV compilation is only available in Vulkan backend";
+    }
+
+    const auto& Source = GLSL::FillTextureCS;
+    const auto  SPIRV  = GLSLtoSPIRV(SHADER_TYPE_COMPUTE, Source.c_str(), static_cast<int>(Source.length()), nullptr);
+    TestReflection(SPIRV, SHADER_TYPE_COMPUTE, "Fill texture CS");
+}
+
+} // namespace
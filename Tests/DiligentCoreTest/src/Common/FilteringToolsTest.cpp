@@ -25,7 +25,12 @@
  *  of the possibility of such damages.
  */
 
+#include <limits>
+#include <random>
+#include <vector>
+
 #include "FilteringTools.hpp"
+#include "Timer.hpp"
 
 #include "gtest/gtest.h"
 
@@ -292,4 +297,174 @@ TEST(Common_FilteringTools, FilterTexture2DBilinear)
     }
 }
 
+// When FMA instructions are available, the compiler may contract the scalar code into fused multiply-adds.
+// This changes the rounding of the texel-space coordinates and of the blending, so the batch results only
+// match the scalar ones within the rounding error.
+#if DILIGENT_MATH_SIMD == DILIGENT_MATH_SIMD_AVX2 || defined(__FMA__) || defined(__ARM_FEATURE_FMA) || defined(__aarch64__) || defined(_M_ARM64)
+constexpr bool FMAContractionPossible = true;
+#else
+constexpr bool FMAContractionPossible = false;
+#endif
+
+// Returns the tolerance for texel values in [0, 255] sampled at unnormalized coordinates up to MaxAbsCoord
+float GetBatchTolerance(float MaxAbsCoord)
+{
+    return FMAContractionPossible ? 255.f * 4.f * std::numeric_limits<float>::epsilon() * (MaxAbsCoord + 1.f) : 0.f;
+}
+
+template <typename SrcType, TEXTURE_ADDRESS_MODE AddressModeU, TEXTURE_ADDRESS_MODE AddressModeV, bool IsNormalizedCoord>
+void TestFilterTexture2DBilinearBatch(float MinCoord, float MaxCoord)
+{
+    constexpr Uint32 Width  = 37;
+    constexpr Uint32 Height = 19;
+    constexpr size_t Stride = 41;
+
+    std::mt19937 gen{0};
+
+    std::vector<SrcType> Data(Stride * Height);
+    for (auto& Val : Data)
+        Val = static_cast<SrcType>(std::uniform_int_distribution<int>{0, 255}(gen));
+
+    const float UScale = IsNormalizedCoord ? 1.f / static_cast<float>(Width) : 1.f;
+    const float VScale = IsNormalizedCoord ? 1.f / static_cast<float>(Height) : 1.f;
+
+    const float BatchTolerance = GetBatchTolerance(std::max(std::abs(MinCoord), std::abs(MaxCoord)));
+
+    // Use the number of samples that is not a multiple of 4 to test the tail
+    constexpr size_t   NumSamples = 1023;
+    std::vector<float> U(NumSamples), V(NumSamples);
+
+    std::uniform_real_distribution<float> CoordDist{MinCoord, MaxCoord};
+    for (size_t i = 0; i < NumSamples; ++i)
+    {
+        U[i] = CoordDist(gen) * UScale;
+        V[i] = CoordDist(gen) * VScale;
+    }
+    // Integer and half-integer coordinates
+    for (size_t i = 0; i < 64; ++i)
+    {
+        U[i] = (MinCoord + static_cast<float>(i / 8) * 0.5f) * UScale;
+        V[i] = (MinCoord + static_cast<float>(i % 8) * 0.5f) * VScale;
+    }
+
+    std::vector<float> Samples(NumSamples);
+    FilterTexture2DBilinearBatch<SrcType, float, AddressModeU, AddressModeV, IsNormalizedCoord>(Width, Height, Data.data(), Stride, U.data(), V.data(), NumSamples, Samples.data());
+    for (size_t i = 0; i < NumSamples; ++i)
+    {
+        auto Ref = FilterTexture2DBilinear<SrcType, float, AddressModeU, AddressModeV, IsNormalizedCoord>(Width, Height, Data.data(), Stride, U[i], V[i]);
+        EXPECT_NEAR(Samples[i], Ref, BatchTolerance) << "u=" << U[i] << " v=" << V[i];
+    }
+
+    std::vector<double> DoubleSamples(NumSamples);
+    FilterTexture2DBilinearBatch<SrcType, double, AddressModeU, AddressModeV, IsNormalizedCoord>(Width, Height, Data.data(), Stride, U.data(), V.data(), NumSamples, DoubleSamples.data());
+    for (size_t i = 0; i < NumSamples; ++i)
+    {
+        auto Ref = FilterTexture2DBilinear<SrcType, double, AddressModeU, AddressModeV, IsNormalizedCoord>(Width, Height, Data.data(), Stride, U[i], V[i]);
+        EXPECT_EQ(DoubleSamples[i], Ref) << "u=" << U[i] << " v=" << V[i];
+    }
+
+    // Region resampling
+    constexpr Uint32 DstWidth  = 61;
+    constexpr Uint32 DstHeight = 23;
+    constexpr size_t DstStride = 64;
+
+    const float UStart = MinCoord * UScale;
+    const float VStart = MinCoord * VScale;
+    const float UStep  = (MaxCoord - MinCoord) / static_cast<float>(DstWidth) * UScale;
+    const float VStep  = (MaxCoord - MinCoord) / static_cast<float>(DstHeight) * VScale;
+
+    std::vector<float> Region(DstStride * DstHeight);
+    ResampleTexture2DBilinear<SrcType, float, AddressModeU, AddressModeV, IsNormalizedCoord>(Width, Height, Data.data(), Stride, DstWidth, DstHeight, Region.data(), DstStride, UStart, VStart, UStep, VStep);
+    for (Uint32 y = 0; y < DstHeight; ++y)
+    {
+        for (Uint32 x = 0; x < DstWidth; ++x)
+        {
+            const auto u   = UStart + static_cast<float>(x) * UStep;
+            const auto v   = VStart + static_cast<float>(y) * VStep;
+            auto       Ref = FilterTexture2DBilinear<SrcType, float, AddressModeU, AddressModeV, IsNormalizedCoord>(Width, Height, Data.data(), Stride, u, v);
+            EXPECT_NEAR(Region[x + y * DstStride], Ref, BatchTolerance) << "x=" << x << " y=" << y;
+        }
+    }
+}
+
+template <typename SrcType, bool IsNormalizedCoord>
+void TestFilterTexture2DBilinearBatch()
+{
+    TestFilterTexture2DBilinearBatch<SrcType, TEXTURE_ADDRESS_CLAMP, TEXTURE_ADDRESS_CLAMP, IsNormalizedCoord>(-100.f, 100.f);
+    TestFilterTexture2DBilinearBatch<SrcType, TEXTURE_ADDRESS_WRAP, TEXTURE_ADDRESS_WRAP, IsNormalizedCoord>(-100.f, 100.f);
+    TestFilterTexture2DBilinearBatch<SrcType, TEXTURE_ADDRESS_MIRROR, TEXTURE_ADDRESS_MIRROR, IsNormalizedCoord>(-100.f, 100.f);
+    TestFilterTexture2DBilinearBatch<SrcType, TEXTURE_ADDRESS_WRAP, TEXTURE_ADDRESS_MIRROR, IsNormalizedCoord>(-100.f, 100.f);
+    TestFilterTexture2DBilinearBatch<SrcType, TEXTURE_ADDRESS_MIRROR, TEXTURE_ADDRESS_CLAMP, IsNormalizedCoord>(-100.f, 100.f);
+    // Sample indices must be in range for TEXTURE_ADDRESS_UNKNOWN
+    TestFilterTexture2DBilinearBatch<SrcType, TEXTURE_ADDRESS_UNKNOWN, TEXTURE_ADDRESS_UNKNOWN, IsNormalizedCoord>(0.5f, 18.5f);
+}
+
+TEST(Common_FilteringTools, FilterTexture2DBilinearBatch)
+{
+    TestFilterTexture2DBilinearBatch<float, false>();
+    TestFilterTexture2DBilinearBatch<float, true>();
+    TestFilterTexture2DBilinearBatch<Uint8, false>();
+    TestFilterTexture2DBilinearBatch<Uint8, true>();
+}
+
+// Performance benchmark. Run with --gtest_also_run_disabled_tests
+TEST(Common_FilteringTools, DISABLED_ResampleTexture2DBilinearBenchmark)
+{
+    constexpr Uint32 SrcWidth  = 1024;
+    constexpr Uint32 SrcHeight = 1024;
+    constexpr Uint32 DstWidth  = 1536;
+    constexpr Uint32 DstHeight = 1536;
+
+    std::vector<Uint8> Src(SrcWidth * SrcHeight);
+    for (size_t i = 0; i < Src.size(); ++i)
+        Src[i] = static_cast<Uint8>(i * 7 + i / SrcWidth * 13);
+
+    std::vector<float> Dst(DstWidth * DstHeight), RefDst(DstWidth * DstHeight);
+
+    const float UStep = 1.f / static_cast<float>(DstWidth);
+    const float VStep = 1.f / static_cast<float>(DstHeight);
+
+    const float BatchTolerance = GetBatchTolerance(static_cast<float>(std::max(SrcWidth, SrcHeight)));
+
+    Timer T;
+
+    auto StartTime = T.GetElapsedTime();
+    for (Uint32 y = 0; y < DstHeight; ++y)
+    {
+        for (Uint32 x = 0; x < DstWidth; ++x)
+        {
+            RefDst[x + y * DstWidth] = FilterTexture2DBilinear<Uint8, float, TEXTURE_ADDRESS_WRAP, TEXTURE_ADDRESS_WRAP, true>(
+                SrcWidth, SrcHeight, Src.data(), SrcWidth, static_cast<float>(x) * UStep, static_cast<float>(y) * VStep);
+        }
+    }
+    const auto ScalarTime = T.GetElapsedTime() - StartTime;
+
+    std::vector<float> U(DstWidth * DstHeight), V(DstWidth * DstHeight);
+    for (Uint32 y = 0; y < DstHeight; ++y)
+    {
+        for (Uint32 x = 0; x < DstWidth; ++x)
+        {
+            U[x + y * DstWidth] = static_cast<float>(x) * UStep;
+            V[x + y * DstWidth] = static_cast<float>(y) * VStep;
+        }
+    }
+
+    StartTime = T.GetElapsedTime();
+    FilterTexture2DBilinearBatch<Uint8, float, TEXTURE_ADDRESS_WRAP, TEXTURE_ADDRESS_WRAP, true>(
+        SrcWidth, SrcHeight, Src.data(), SrcWidth, U.data(), V.data(), U.size(), Dst.data());
+    const auto BatchTime = T.GetElapsedTime() - StartTime;
+    for (size_t i = 0; i < Dst.size(); ++i)
+        ASSERT_NEAR(Dst[i], RefDst[i], BatchTolerance);
+
+    StartTime = T.GetElapsedTime();
+    ResampleTexture2DBilinear<Uint8, float, TEXTURE_ADDRESS_WRAP, TEXTURE_ADDRESS_WRAP, true>(
+        SrcWidth, SrcHeight, Src.data(), SrcWidth, DstWidth, DstHeight, Dst.data(), DstWidth, 0.f, 0.f, UStep, VStep);
+    const auto ResampleTime = T.GetElapsedTime() - StartTime;
+    for (size_t i = 0; i < Dst.size(); ++i)
+        ASSERT_NEAR(Dst[i], RefDst[i], BatchTolerance);
+
+    LOG_INFO_MESSAGE("Bilinear resampling of ", SrcWidth, "x", SrcHeight, " texture to ", DstWidth, "x", DstHeight,
+                     ": scalar ", ScalarTime * 1000.0, " ms, batch ", BatchTime * 1000.0, " ms, region ", ResampleTime * 1000.0, " ms");
+}
+
 } // namespace
@@ -0,0 +1,90 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "MappedFileDataBlob.hpp"
+#include "FileWrapper.hpp"
+#include "RefCntAutoPtr.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+TEST(Common_MappedFileDataBlob, MapFile)
+{
+    static constexpr char FileName[] = "MappedFileDataBlobTest.bin";
+
+    std::vector<Uint8> RefData(100000);
+    for (size_t i = 0; i < RefData.size(); ++i)
+        RefData[i] = static_cast<Uint8>(i * 31 + 7);
+
+    {
+        FileWrapper File{FileName, EFileAccessMode::Overwrite};
+        ASSERT_TRUE(File != nullptr);
+        ASSERT_TRUE(File->Write(RefData.data(), RefData.size()));
+    }
+
+    {
+        RefCntAutoPtr<IDataBlob> pBlob{MakeNewRCObj<MappedFileDataBlob>()(FileName)};
+        ASSERT_EQ(pBlob->GetSize(), RefData.size());
+        EXPECT_EQ(memcmp(pBlob->GetConstDataPtr(), RefData.data(), RefData.size()), 0);
+        EXPECT_EQ(pBlob->GetDataPtr(), pBlob->GetConstDataPtr());
+
+        // Modifications are private to the blob and are not written to the file
+        auto* pData = static_cast<Uint8*>(pBlob->GetDataPtr());
+        pData[0] ^= 0xFF;
+        pData[RefData.size() - 1] ^= 0xFF;
+    }
+
+    {
+        RefCntAutoPtr<IDataBlob> pBlob{MakeNewRCObj<MappedFileDataBlob>()(FileName)};
+        ASSERT_EQ(pBlob->GetSize(), RefData.size());
+        EXPECT_EQ(memcmp(pBlob->GetConstDataPtr(), RefData.data(), RefData.size()), 0);
+    }
+
+    {
+        // Empty file
+        FileWrapper File{FileName, EFileAccessMode::Overwrite};
+        ASSERT_TRUE(File != nullptr);
+    }
+
+    {
+        RefCntAutoPtr<IDataBlob> pBlob{MakeNewRCObj<MappedFileDataBlob>()(FileName)};
+        EXPECT_EQ(pBlob->GetSize(), size_t{0});
+    }
+
+    FileSystem::DeleteFile(FileName);
+
+    EXPECT_EQ(FileSystem::MapFile("NonExistentFile.bin"), nullptr);
+}
+
+} // namespace
@@ -26,9 +26,15 @@
  */
 
 #include <climits>
+#include <limits>
+#include <vector>
+#include <thread>
 
 #include "BasicMath.hpp"
 #include "AdvancedMath.hpp"
+#include "FastRand.hpp"
+#include "Timer.hpp"
+#include "PlatformMisc.hpp"
 
 #include "gtest/gtest.h"
 
@@ -1166,6 +1172,238 @@ TEST(Common_BasicMath, HighPrecisionCross)
     }
 }
 
+// Scalar reference implementations of the operations that have SIMD specializations for float
+
+float4x4 ScalarMul(const float4x4& m1, const float4x4& m2)
+{
+    float4x4 mOut;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            for (int k = 0; k < 4; k++)
+                mOut[i][j] += m1[i][k] * m2[k][j];
+        }
+    }
+    return mOut;
+}
+
+float4 ScalarMul(const float4& v, const float4x4& m)
+{
+    float4 out;
+    for (int j = 0; j < 4; ++j)
+        out[j] = v.x * m[0][j] + v.y * m[1][j] + v.z * m[2][j] + v.w * m[3][j];
+    return out;
+}
+
+float4 ScalarMul(const float4x4& m, const float4& v)
+{
+    float4 out;
+    for (int i = 0; i < 4; ++i)
+        out[i] = m[i][0] * v.x + m[i][1] * v.y + m[i][2] * v.z + m[i][3] * v.w;
+    return out;
+}
+
+float ScalarCofactor(const float4x4& m, int row, int col)
+{
+    float Minor[9];
+    int   n = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            if (i != row && j != col)
+                Minor[n++] = m[i][j];
+        }
+    }
+    const auto det = float3x3{Minor[0], Minor[1], Minor[2], Minor[3], Minor[4], Minor[5], Minor[6], Minor[7], Minor[8]}.Determinant();
+    return ((row + col) % 2 == 0) ? det : -det;
+}
+
+float4x4 ScalarInverse(const float4x4& m)
+{
+    float4x4 inv;
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+            inv[j][i] = ScalarCofactor(m, i, j);
+    }
+    const auto det = m[0][0] * inv[0][0] + m[0][1] * inv[1][0] + m[0][2] * inv[2][0] + m[0][3] * inv[3][0];
+    inv *= 1.f / det;
+    return inv;
+}
+
+float ScalarDeterminant(const float4x4& m)
+{
+    float det = 0;
+    for (int j = 0; j < 4; ++j)
+        det += m[0][j] * ScalarCofactor(m, 0, j);
+    return det;
+}
+
+float4x4 RandomMatrix(FastRandFloat& Rnd)
+{
+    float4x4 m;
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+            m[i][j] = Rnd();
+    }
+    // Make the matrix diagonally dominant so that it is well-conditioned
+    for (int i = 0; i < 4; ++i)
+        m[i][i] += 4.f;
+    return m;
+}
+
+float4x4 AbsMatrix(const float4x4& m)
+{
+    float4x4 Abs;
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+            Abs[i][j] = std::abs(m[i][j]);
+    }
+    return Abs;
+}
+
+// Fused multiply-add rounds once instead of twice. AVX2 code uses it explicitly, and the compiler may
+// contract a * b + c in the scalar reference or in NEON code when FMA instructions are available
+// (GCC and Clang do this by default, e.g. with -mfma or on AArch64).
+#if DILIGENT_MATH_SIMD == DILIGENT_MATH_SIMD_AVX2 || defined(__FMA__) || defined(__ARM_FEATURE_FMA) || defined(__aarch64__) || defined(_M_ARM64)
+constexpr bool FMAContractionPossible = true;
+#else
+constexpr bool FMAContractionPossible = false;
+#endif
+
+// Error bound of a dot product that is computed with or without FMA, where SumAbs is the sum of
+// absolute values of the products.
+float DotProductTolerance(float SumAbs)
+{
+    return FMAContractionPossible ? 4.f * std::numeric_limits<float>::epsilon() * SumAbs : 0.f;
+}
+
+// Results of the SIMD code must match the scalar code. Multiplication uses the same order of operations and
+// is exact unless FMA contraction is possible, in which case the error is bounded by the magnitude of the
+// products. Inverse and determinant use a different factorization, so they are compared with relative tolerance.
+TEST(Common_BasicMath, SIMDConsistency)
+{
+    FastRandFloat Rnd{0, -1.f, 1.f};
+    for (int iter = 0; iter < 1000; ++iter)
+    {
+        const auto m1 = RandomMatrix(Rnd);
+        const auto m2 = RandomMatrix(Rnd);
+        const auto v  = float4{Rnd(), Rnd(), Rnd(), Rnd()};
+
+        const auto AbsM1 = AbsMatrix(m1);
+        const auto AbsV  = float4{std::abs(v.x), std::abs(v.y), std::abs(v.z), std::abs(v.w)};
+
+        const auto Prod      = m1 * m2;
+        const auto RefProd   = ScalarMul(m1, m2);
+        const auto ProdBound = ScalarMul(AbsM1, AbsMatrix(m2));
+        const auto vm        = v * m1;
+        const auto RefVM     = ScalarMul(v, m1);
+        const auto VMBound   = ScalarMul(AbsV, AbsM1);
+        const auto mv        = m1 * v;
+        const auto RefMV     = ScalarMul(m1, v);
+        const auto MVBound   = ScalarMul(AbsM1, AbsV);
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int j = 0; j < 4; ++j)
+                EXPECT_NEAR(Prod[i][j], RefProd[i][j], DotProductTolerance(ProdBound[i][j]));
+            EXPECT_NEAR(vm[i], RefVM[i], DotProductTolerance(VMBound[i]));
+            EXPECT_NEAR(mv[i], RefMV[i], DotProductTolerance(MVBound[i]));
+        }
+
+        const auto Inv    = m1.Inverse();
+        const auto RefInv = ScalarInverse(m1);
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int j = 0; j < 4; ++j)
+                EXPECT_NEAR(Inv[i][j], RefInv[i][j], 1e-5f);
+        }
+
+        const auto Det    = m1.Determinant();
+        const auto RefDet = ScalarDeterminant(m1);
+        EXPECT_NEAR(Det, RefDet, 1e-5f * std::abs(RefDet));
+
+        // Vector3 * Matrix4x4 uses Vector4 * Matrix4x4
+        const auto v3    = float3{v.x, v.y, v.z};
+        const auto v3m   = v3 * m1;
+        const auto RefV3 = ScalarMul(float4{v3, 1}, m1);
+        EXPECT_NEAR(v3m.x, RefV3.x / RefV3.w, 1e-5f * std::abs(RefV3.x / RefV3.w));
+        EXPECT_NEAR(v3m.y, RefV3.y / RefV3.w, 1e-5f * std::abs(RefV3.y / RefV3.w));
+        EXPECT_NEAR(v3m.z, RefV3.z / RefV3.w, 1e-5f * std::abs(RefV3.z / RefV3.w));
+    }
+
+    // Singular matrix
+    {
+        float4x4 m{
+            1, 2, 3, 4,
+            2, 4, 6, 8,
+            0, 1, 0, 1,
+            3, 0, 2, 5 //
+        };
+        EXPECT_EQ(m.Determinant(), 0.f);
+    }
+}
+
+// Runs SIMDOp and ScalarOp on pairs of adjacent matrices and logs the timings.
+// The checksum prevents the compiler from eliminating the computations.
+template <typename SIMDOpType, typename ScalarOpType>
+void MeasureSIMD(const char* Name, const std::vector<float4x4>& Matrices, int NumIterations, SIMDOpType SIMDOp, ScalarOpType ScalarOp)
+{
+    const auto NumMatrices = Matrices.size();
+    float      Checksum[2] = {};
+
+    Timer T;
+    for (int iter = 0; iter < NumIterations; ++iter)
+    {
+        for (size_t i = 0; i + 1 < NumMatrices; ++i)
+            Checksum[0] += SIMDOp(Matrices[i], Matrices[i + 1]);
+    }
+    const auto SIMDTime = T.GetElapsedTime();
+
+    T.Restart();
+    for (int iter = 0; iter < NumIterations; ++iter)
+    {
+        for (size_t i = 0; i + 1 < NumMatrices; ++i)
+            Checksum[1] += ScalarOp(Matrices[i], Matrices[i + 1]);
+    }
+    const auto ScalarTime = T.GetElapsedTime();
+
+    EXPECT_NEAR(Checksum[0], Checksum[1], 1e-3f * std::abs(Checksum[1]));
+    LOG_INFO_MESSAGE(Name, ": SIMD ", SIMDTime * 1000.0, " ms, scalar ", ScalarTime * 1000.0, " ms (x", ScalarTime / std::max(SIMDTime, 1e-9), ")");
+}
+
+// Performance benchmark. Run with --gtest_also_run_disabled_tests
+// Compares the performance of the SIMD code with the scalar code. The timings are only logged
+// as they depend on the hardware and the build configuration.
+TEST(Common_BasicMath, DISABLED_SIMDBenchmark)
+{
+    constexpr int NumMatrices   = 256;
+    constexpr int NumIterations = 200;
+
+    FastRandFloat         Rnd{0, -1.f, 1.f};
+    std::vector<float4x4> Matrices(NumMatrices);
+    for (auto& m : Matrices)
+        m = RandomMatrix(Rnd);
+
+    // clang-format off
+    MeasureSIMD("float4x4 * float4x4", Matrices, NumIterations,
+                [](const float4x4& m1, const float4x4& m2) { return (m1 * m2)[1][2]; },
+                [](const float4x4& m1, const float4x4& m2) { return ScalarMul(m1, m2)[1][2]; });
+    MeasureSIMD("float4 * float4x4", Matrices, NumIterations,
+                [](const float4x4& m1, const float4x4& m2) { return (float4{m1[0][0], m1[1][1], m1[2][2], 1} * m2).y; },
+                [](const float4x4& m1, const float4x4& m2) { return ScalarMul(float4{m1[0][0], m1[1][1], m1[2][2], 1}, m2).y; });
+    MeasureSIMD("float4x4 * float4", Matrices, NumIterations,
+                [](const float4x4& m1, const float4x4& m2) { return (m2 * float4{m1[0][0], m1[1][1], m1[2][2], 1}).z; },
+                [](const float4x4& m1, const float4x4& m2) { return ScalarMul(m2, float4{m1[0][0], m1[1][1], m1[2][2], 1}).z; });
+    MeasureSIMD("float4x4::Inverse", Matrices, NumIterations,
+                [](const float4x4& m1, const float4x4&) { return m1.Inverse()[2][1]; },
+                [](const float4x4& m1, const float4x4&) { return ScalarInverse(m1)[2][1]; });
+    // clang-format on
+}
+
 TEST(Common_AdvancedMath, Planes)
 {
     Plane3D plane = {};
@@ -1483,6 +1721,10 @@ TEST(Common_AdvancedMath, TraceLineThroughGrid)
     TestLineTrace(float2{0.25f - 5.f, 9.75f - 6.f}, float2{0.25f + 5.f, 9.75f + 6.f}, {int2{0, 9}});
     TestLineTrace(float2{9.75f + 5.f, 9.85f - 6.f}, float2{9.75f - 5.f, 9.85f + 6.f}, {int2{9, 9}});
 
+    // Lines parallel to the grid side outside of the grid
+    TestLineTrace(float2{-0.5f, 0.5f}, float2{-0.5f, 3.5f}, {});
+    TestLineTrace(float2{0.5f, 10.5f}, float2{3.5f, 10.5f}, {});
+
     // Degenerate line
     TestLineTrace(float2{0.5f, 0.5f}, float2{0.5f, 0.5f}, {int2{0, 0}});
     TestLineTrace(float2{-0.5f, 0.5f}, float2{-0.5f, 0.5f}, {});
@@ -1516,6 +1758,101 @@ TEST(Common_AdvancedMath, TraceLineThroughGrid)
     TestLineTrace(float2{3, 1}, float2{1, 3}, {int2{3, 1}, int2{2, 1}, int2{2, 2}, int2{1, 2}, int2{1, 3}});
 }
 
+static void TestLineTrace3D(float3 Start, float3 End, const std::vector<int3>& Reference, int3 GridSize = {10, 10, 10})
+{
+    std::vector<int3> Trace;
+    TraceLineThroughGrid(Start, End, GridSize,
+                         [&](int3 pos) //
+                         {
+                             Trace.emplace_back(pos);
+                             return true;
+                         } //
+    );
+
+    if (Trace != Reference)
+    {
+        std::stringstream ss;
+        ss << "Expected: ";
+        for (const auto& pos : Reference)
+            ss << "(" << pos.x << ", " << pos.y << ", " << pos.z << ") ";
+        ss << "\n";
+
+        ss << "Actual:   ";
+        for (const auto& pos : Trace)
+            ss << "(" << pos.x << ", " << pos.y << ", " << pos.z << ") ";
+
+        ADD_FAILURE() << "Failed to trace line (" << std::setprecision(3) << Start.x << ", " << Start.y << ", " << Start.z << ") - ("
+                      << End.x << ", " << End.y << ", " << End.z << ") "
+                      << "through " << GridSize.x << "x" << GridSize.y << "x" << GridSize.z << " grid:\n"
+                      << ss.str();
+    }
+}
+
+TEST(Common_AdvancedMath, TraceLineThroughGrid3D)
+{
+    // Axis-aligned directions
+    TestLineTrace3D(float3{0.f, 0.5f, 0.5f}, float3{2.f, 0.5f, 0.5f}, {int3{0, 0, 0}, int3{1, 0, 0}, int3{2, 0, 0}});
+    TestLineTrace3D(float3{2.f, 0.5f, 0.5f}, float3{-10.f, 0.5f, 0.5f}, {int3{2, 0, 0}, int3{1, 0, 0}, int3{0, 0, 0}});
+    TestLineTrace3D(float3{0.5f, -10.f, 0.5f}, float3{0.5f, 2.f, 0.5f}, {int3{0, 0, 0}, int3{0, 1, 0}, int3{0, 2, 0}});
+    TestLineTrace3D(float3{0.5f, 0.5f, 8.f}, float3{0.5f, 0.5f, 20.f}, {int3{0, 0, 8}, int3{0, 0, 9}});
+    TestLineTrace3D(float3{0.5f, 0.5f, 20.f}, float3{0.5f, 0.5f, 8.f}, {int3{0, 0, 9}, int3{0, 0, 8}});
+
+    // Sub-cell
+    TestLineTrace3D(float3{5.85f, 5.5f, 5.1f}, float3{5.9f, 5.6f, 5.2f}, {int3{5, 5, 5}});
+    TestLineTrace3D(float3{5.9f, 5.6f, 5.2f}, float3{5.85f, 5.5f, 5.1f}, {int3{5, 5, 5}});
+
+    // Plane diagonals
+    TestLineTrace3D(float3{0.5f, 5.5f, 0.9f}, float3{1.5f, 5.5f, 1.2f}, {int3{0, 5, 0}, int3{0, 5, 1}, int3{1, 5, 1}});
+    TestLineTrace3D(float3{1.5f, 5.5f, 1.2f}, float3{0.5f, 5.5f, 0.9f}, {int3{1, 5, 1}, int3{0, 5, 1}, int3{0, 5, 0}});
+
+    // When boundaries along several axes are crossed at the same distance, x is stepped first, then y, then z
+    TestLineTrace3D(float3{0.5f, 0.5f, 0.5f}, float3{2.5f, 1.5f, 1.5f}, {int3{0, 0, 0}, int3{1, 0, 0}, int3{1, 1, 0}, int3{1, 1, 1}, int3{2, 1, 1}});
+    TestLineTrace3D(float3{0.5f, 0.5f, 0.5f}, float3{1.5f, 1.5f, 1.5f}, {int3{0, 0, 0}, int3{1, 0, 0}, int3{1, 1, 0}, int3{1, 1, 1}});
+
+    // Test intersections
+    TestLineTrace3D(float3{-0.5f, 0.5f, 0.9f}, float3{1.5f, 0.5f, -1.1f}, {int3{0, 0, 0}});
+    TestLineTrace3D(float3{9.5f, 9.5f, 12.f}, float3{9.5f, 12.f, 9.5f}, {});
+    TestLineTrace3D(float3{-1.f, -1.f, -1.f}, float3{-1.f, 5.f, 5.f}, {});
+
+    // Degenerate line
+    TestLineTrace3D(float3{0.5f, 0.5f, 0.5f}, float3{0.5f, 0.5f, 0.5f}, {int3{0, 0, 0}});
+    TestLineTrace3D(float3{0.5f, 0.5f, -0.5f}, float3{0.5f, 0.5f, -0.5f}, {});
+    TestLineTrace3D(float3{0.5f, 0.5f, 10.5f}, float3{0.5f, 0.5f, 10.5f}, {});
+
+    // Random lines must visit face-adjacent cells inside the grid
+    FastRandFloat Rnd{0, -5.f, 15.f};
+    for (int i = 0; i < 1000; ++i)
+    {
+        const float3 Start{Rnd(), Rnd(), Rnd()};
+        const float3 End{Rnd(), Rnd(), Rnd()};
+
+        std::vector<int3> Trace;
+        TraceLineThroughGrid(Start, End, int3{10, 10, 10},
+                             [&](int3 pos) //
+                             {
+                                 EXPECT_TRUE(pos.x >= 0 && pos.y >= 0 && pos.z >= 0 && pos.x < 10 && pos.y < 10 && pos.z < 10);
+                                 if (!Trace.empty())
+                                 {
+                                     const auto Diff = pos - Trace.back();
+                                     EXPECT_EQ(std::abs(Diff.x) + std::abs(Diff.y) + std::abs(Diff.z), 1);
+                                 }
+                                 Trace.emplace_back(pos);
+                                 return true;
+                             });
+    }
+
+    // Early termination
+    {
+        int NumCells = 0;
+        TraceLineThroughGrid(float3{0.5f, 0.5f, 0.5f}, float3{9.5f, 0.5f, 0.5f}, int3{10, 10, 10},
+                             [&](int3 pos) //
+                             {
+                                 return ++NumCells < 3;
+                             });
+        EXPECT_EQ(NumCells, 3);
+    }
+}
+
 TEST(Common_BasicMath, FastFloor)
 {
     // float
@@ -1946,4 +2283,338 @@ TEST(Common_AdvancedMath, TransformBoundBox)
     }
 }
 
+struct BoundBoxBatchData
+{
+    std::vector<float>    Coords[6];
+    std::vector<BoundBox> Boxes;
+
+    BoundBoxBatchData(Uint32 NumBoxes, FastRandFloat& Rnd)
+    {
+        for (auto& c : Coords)
+            c.resize(NumBoxes);
+        Boxes.resize(NumBoxes);
+        for (Uint32 i = 0; i < NumBoxes; ++i)
+        {
+            auto& BB = Boxes[i];
+            BB.Min   = float3{Rnd() * 100.f, Rnd() * 100.f, Rnd() * 100.f};
+            BB.Max   = BB.Min + float3{std::abs(Rnd()), std::abs(Rnd()), std::abs(Rnd())} * 5.f;
+            for (int c = 0; c < 3; ++c)
+            {
+                Coords[c][i]     = BB.Min[c];
+                Coords[c + 3][i] = BB.Max[c];
+            }
+        }
+    }
+
+    BoundBoxBatch GetBatch() const
+    {
+        BoundBoxBatch Batch;
+        Batch.MinX     = Coords[0].data();
+        Batch.MinY     = Coords[1].data();
+        Batch.MinZ     = Coords[2].data();
+        Batch.MaxX     = Coords[3].data();
+        Batch.MaxY     = Coords[4].data();
+        Batch.MaxZ     = Coords[5].data();
+        Batch.NumBoxes = static_cast<Uint32>(Boxes.size());
+        return Batch;
+    }
+};
+
+ViewFrustum GetTestFrustum()
+{
+    auto ViewProj = float4x4::RotationY(0.5f) * float4x4::Translation(0, 0, 50) * float4x4::Projection(PI_F / 3.f, 1.5f, 1.f, 80.f, false);
+
+    ViewFrustum Frustum;
+    ExtractViewFrustumPlanesFromMatrix(ViewProj, Frustum, false);
+    return Frustum;
+}
+
+TEST(Common_AdvancedMath, GetBoxVisibilityBatch)
+{
+    constexpr Uint32 NumBoxes = 1000;
+
+    FastRandFloat     Rnd{0, -1.f, 1.f};
+    BoundBoxBatchData Data{NumBoxes, Rnd};
+    const auto        Batch   = Data.GetBatch();
+    const auto        Frustum = GetTestFrustum();
+
+    // clang-format off
+    const FRUSTUM_PLANE_FLAGS TestFlags[] =
+    {
+        FRUSTUM_PLANE_FLAG_FULL_FRUSTUM,
+        FRUSTUM_PLANE_FLAG_OPEN_NEAR,
+        FRUSTUM_PLANE_FLAG_LEFT_PLANE | FRUSTUM_PLANE_FLAG_TOP_PLANE,
+        FRUSTUM_PLANE_FLAG_NONE
+    };
+    // clang-format on
+    for (auto Flags : TestFlags)
+    {
+        std::vector<Uint32> Mask((NumBoxes + 31) / 32, 0xFFFFFFFFu);
+        GetBoxVisibilityBatch(Frustum, Batch, 0, NumBoxes, Mask.data(), Flags);
+
+        Uint32 NumVisible = 0;
+        for (Uint32 i = 0; i < NumBoxes; ++i)
+        {
+            const bool IsVisible = GetBoxVisibility(Frustum, Data.Boxes[i], Flags) != BoxVisibility::Invisible;
+            EXPECT_EQ((Mask[i / 32] & (1u << (i % 32))) != 0, IsVisible) << "Box " << i << ", flags " << Flags;
+            NumVisible += IsVisible ? 1 : 0;
+        }
+        // Bits past the last box must be cleared
+        EXPECT_EQ(Mask.back() >> (NumBoxes % 32), 0u);
+
+        if (Flags == FRUSTUM_PLANE_FLAG_NONE)
+            EXPECT_EQ(NumVisible, NumBoxes);
+        else if (Flags == FRUSTUM_PLANE_FLAG_FULL_FRUSTUM)
+            EXPECT_TRUE(NumVisible > 0 && NumVisible < NumBoxes);
+    }
+
+    // Ranges processed by different threads must produce the same mask
+    {
+        std::vector<Uint32> RefMask((NumBoxes + 31) / 32);
+        GetBoxVisibilityBatch(Frustum, Batch, 0, NumBoxes, RefMask.data());
+
+        constexpr Uint32         BoxesPerThread = 32 * 8;
+        std::vector<Uint32>      Mask(RefMask.size());
+        std::vector<std::thread> Threads;
+        for (Uint32 First = 0; First < NumBoxes; First += BoxesPerThread)
+        {
+            Threads.emplace_back([&, First]() {
+                GetBoxVisibilityBatch(Frustum, Batch, First, std::min(BoxesPerThread, NumBoxes - First), Mask.data());
+            });
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        EXPECT_EQ(Mask, RefMask);
+    }
+}
+
+// Performance benchmark. Run with --gtest_also_run_disabled_tests
+TEST(Common_AdvancedMath, DISABLED_GetBoxVisibilityBatchBenchmark)
+{
+    constexpr Uint32 NumBoxes      = 1 << 16;
+    constexpr int    NumIterations = 20;
+
+    FastRandFloat     Rnd{1, -1.f, 1.f};
+    BoundBoxBatchData Data{NumBoxes, Rnd};
+    const auto        Batch   = Data.GetBatch();
+    const auto        Frustum = GetTestFrustum();
+
+    std::vector<Uint32> Mask(NumBoxes / 32);
+
+    Timer  T;
+    Uint32 NumVisible[2] = {};
+    for (int iter = 0; iter < NumIterations; ++iter)
+    {
+        GetBoxVisibilityBatch(Frustum, Batch, 0, NumBoxes, Mask.data());
+        for (auto Word : Mask)
+            NumVisible[0] += PlatformMisc::CountOneBits(Word);
+    }
+    const auto BatchTime = T.GetElapsedTime();
+
+    T.Restart();
+    for (int iter = 0; iter < NumIterations; ++iter)
+    {
+        for (const auto& BB : Data.Boxes)
+            NumVisible[1] += GetBoxVisibility(Frustum, BB) != BoxVisibility::Invisible ? 1 : 0;
+    }
+    const auto ScalarTime = T.GetElapsedTime();
+
+    EXPECT_EQ(NumVisible[0], NumVisible[1]);
+
+    const auto TotalBoxes = static_cast<double>(NumBoxes) * NumIterations;
+    LOG_INFO_MESSAGE("GetBoxVisibilityBatch: ", TotalBoxes / std::max(BatchTime, 1e-9) * 1e-6, " Mboxes/s, GetBoxVisibility: ",
+                     TotalBoxes / std::max(ScalarTime, 1e-9) * 1e-6, " Mboxes/s (x", ScalarTime / std::max(BatchTime, 1e-9), ")");
+}
+
+template <typename VectorType>
+struct LineBatchData
+{
+    static constexpr size_t NumComponents = sizeof(VectorType) / sizeof(float);
+
+    std::vector<float> Coords[NumComponents * 2];
+
+    LineBatchData(Uint32 NumLines, float GridSize, float MaxLength, FastRandFloat& Rnd)
+    {
+        for (auto& c : Coords)
+            c.resize(NumLines);
+        for (Uint32 i = 0; i < NumLines; ++i)
+        {
+            for (size_t c = 0; c < NumComponents; ++c)
+            {
+                // Integer coordinates make ties in the step selection more likely
+                const float Start = (i % 8) == 0 ? FastFloor((Rnd() * 0.5f + 0.5f) * GridSize) : Rnd() * GridSize * 0.6f + GridSize * 0.5f;
+                const float Delta = (i % 16) == 1 ? 0.f : Rnd() * MaxLength;
+
+                Coords[c][i]                 = Start;
+                Coords[c + NumComponents][i] = (i % 8) == 0 ? FastFloor(Start + Delta) : Start + Delta;
+            }
+        }
+    }
+
+    VectorType GetStart(Uint32 i) const
+    {
+        VectorType v;
+        for (size_t c = 0; c < NumComponents; ++c)
+            v[c] = Coords[c][i];
+        return v;
+    }
+
+    VectorType GetEnd(Uint32 i) const
+    {
+        VectorType v;
+        for (size_t c = 0; c < NumComponents; ++c)
+            v[c] = Coords[c + NumComponents][i];
+        return v;
+    }
+
+    LineBatch2D GetBatch2D() const
+    {
+        LineBatch2D Batch;
+        Batch.StartX   = Coords[0].data();
+        Batch.StartY   = Coords[1].data();
+        Batch.EndX     = Coords[NumComponents + 0].data();
+        Batch.EndY     = Coords[NumComponents + 1].data();
+        Batch.NumLines = static_cast<Uint32>(Coords[0].size());
+        return Batch;
+    }
+
+    LineBatch3D GetBatch3D() const
+    {
+        LineBatch3D Batch;
+        Batch.StartX   = Coords[0].data();
+        Batch.StartY   = Coords[1].data();
+        Batch.StartZ   = Coords[2].data();
+        Batch.EndX     = Coords[NumComponents + 0].data();
+        Batch.EndY     = Coords[NumComponents + 1].data();
+        Batch.EndZ     = Coords[NumComponents + 2].data();
+        Batch.NumLines = static_cast<Uint32>(Coords[0].size());
+        return Batch;
+    }
+};
+
+template <typename CellType, typename VectorType, typename BatchType>
+void TestTraceLinesThroughGrid(const LineBatchData<VectorType>& Data, const BatchType& Batch, CellType GridSize)
+{
+    const Uint32 NumLines = Batch.NumLines;
+
+    // Line i is stopped after (i % 8) cells; 0 means no limit
+    auto GetMaxCells = [](Uint32 i) {
+        return i % 8;
+    };
+
+    std::vector<std::vector<CellType>> RefTraces(NumLines);
+    for (Uint32 i = 0; i < NumLines; ++i)
+    {
+        auto& Trace = RefTraces[i];
+        TraceLineThroughGrid(Data.GetStart(i), Data.GetEnd(i), GridSize,
+                             [&](CellType Cell) //
+                             {
+                                 Trace.emplace_back(Cell);
+                                 return Trace.size() != GetMaxCells(i);
+                             });
+    }
+
+    // Test a range that does not start or end on the group boundary
+    const Uint32 FirstLine = 3;
+    const Uint32 EndLine   = NumLines - 2;
+
+    std::vector<std::vector<CellType>> Traces(NumLines);
+    TraceLinesThroughGrid(Batch, FirstLine, EndLine - FirstLine, GridSize,
+                          [&](Uint32 LineIdx, CellType Cell) //
+                          {
+                              EXPECT_TRUE(LineIdx >= FirstLine && LineIdx < EndLine);
+                              auto& Trace = Traces[LineIdx];
+                              Trace.emplace_back(Cell);
+                              return Trace.size() != GetMaxCells(LineIdx);
+                          });
+
+    Uint32 NumEmpty = 0;
+    for (Uint32 i = 0; i < NumLines; ++i)
+    {
+        if (i < FirstLine || i >= EndLine)
+        {
+            EXPECT_TRUE(Traces[i].empty()) << "Line " << i;
+            continue;
+        }
+        EXPECT_EQ(Traces[i], RefTraces[i]) << "Line " << i;
+        NumEmpty += RefTraces[i].empty() ? 1 : 0;
+    }
+    EXPECT_GT(NumEmpty, Uint32{0});
+    EXPECT_LT(NumEmpty, NumLines / 2);
+}
+
+TEST(Common_AdvancedMath, TraceLinesThroughGrid)
+{
+    constexpr Uint32 NumLines = 1000;
+
+    FastRandFloat Rnd{0, -1.f, 1.f};
+    {
+        LineBatchData<float2> Data{NumLines, 32, 20, Rnd};
+        TestTraceLinesThroughGrid(Data, Data.GetBatch2D(), int2{32, 24});
+    }
+    {
+        LineBatchData<float3> Data{NumLines, 16, 10, Rnd};
+        TestTraceLinesThroughGrid(Data, Data.GetBatch3D(), int3{16, 12, 20});
+    }
+}
+
+template <typename CellType, typename VectorType, typename BatchType>
+void BenchmarkTraceLinesThroughGrid(const char* Name, const LineBatchData<VectorType>& Data, const BatchType& Batch, CellType GridSize)
+{
+    constexpr int NumIterations = 10;
+
+    const Uint32 NumLines = Batch.NumLines;
+
+    Timer  T;
+    Uint32 NumCells[2] = {};
+    for (int iter = 0; iter < NumIterations; ++iter)
+    {
+        TraceLinesThroughGrid(Batch, 0, NumLines, GridSize,
+                              [&](Uint32, CellType) //
+                              {
+                                  ++NumCells[0];
+                                  return true;
+                              });
+    }
+    const auto BatchTime = T.GetElapsedTime();
+
+    T.Restart();
+    for (int iter = 0; iter < NumIterations; ++iter)
+    {
+        for (Uint32 i = 0; i < NumLines; ++i)
+        {
+            TraceLineThroughGrid(Data.GetStart(i), Data.GetEnd(i), GridSize,
+                                 [&](CellType) //
+                                 {
+                                     ++NumCells[1];
+                                     return true;
+                                 });
+        }
+    }
+    const auto ScalarTime = T.GetElapsedTime();
+
+    EXPECT_EQ(NumCells[0], NumCells[1]);
+
+    const auto TotalCells = static_cast<double>(NumCells[0]);
+    LOG_INFO_MESSAGE(Name, ": ", TotalCells / std::max(BatchTime, 1e-9) * 1e-6, " Mcells/s, TraceLineThroughGrid loop: ",
+                     TotalCells / std::max(ScalarTime, 1e-9) * 1e-6, " Mcells/s (x", ScalarTime / std::max(BatchTime, 1e-9), ")");
+}
+
+// Performance benchmark. Run with --gtest_also_run_disabled_tests
+TEST(Common_AdvancedMath, DISABLED_TraceLinesThroughGridBenchmark)
+{
+    constexpr Uint32 NumLines = 1 << 14;
+
+    FastRandFloat Rnd{1, -1.f, 1.f};
+    {
+        LineBatchData<float2> Data{NumLines, 256, 64, Rnd};
+        BenchmarkTraceLinesThroughGrid("TraceLinesThroughGrid 2D", Data, Data.GetBatch2D(), int2{256, 256});
+    }
+    {
+        LineBatchData<float3> Data{NumLines, 64, 32, Rnd};
+        BenchmarkTraceLinesThroughGrid("TraceLinesThroughGrid 3D", Data, Data.GetBatch3D(), int3{64, 64, 64});
+    }
+}
+
 } // namespace
@@ -0,0 +1,359 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+#include <thread>
+#include <set>
+#include <utility>
+
+#include "OcclusionRasterizer.hpp"
+#include "FastRand.hpp"
+#include "Timer.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Random triangle with vertices on the quarter-sample grid, for which both rasterizers produce exact results
+void GetRandomTriangle(FastRandFloat& Rnd, Uint32 Width, Uint32 Height, float3 V[3])
+{
+    const float3 Center{
+        (Rnd() * 0.5f + 0.5f) * static_cast<float>(Width),
+        (Rnd() * 0.5f + 0.5f) * static_cast<float>(Height),
+        0};
+    const float Size = std::abs(Rnd()) * 40.f + 1.f;
+    for (int v = 0; v < 3; ++v)
+    {
+        V[v].x = std::round((Center.x + Rnd() * Size) * 4.f) / 4.f;
+        V[v].y = std::round((Center.y + Rnd() * Size) * 4.f) / 4.f;
+        V[v].z = Rnd() * 0.4f + 0.5f;
+    }
+}
+
+TEST(Common_OcclusionRasterizer, CompareWithRasterizeTriangle)
+{
+    OcclusionRasterizer::CreateInfo CI;
+    CI.Width  = 100;
+    CI.Height = 70;
+    OcclusionRasterizer Rasterizer{CI};
+
+    FastRandFloat Rnd{0, -1.f, 1.f};
+
+    Uint32 NumTested = 0;
+    for (Uint32 i = 0; i < 500; ++i)
+    {
+        float3 V[3];
+        GetRandomTriangle(Rnd, CI.Width, CI.Height, V);
+
+        const auto Area = (V[1].x - V[0].x) * (V[2].y - V[0].y) - (V[2].x - V[0].x) * (V[1].y - V[0].y);
+        if (Area == 0)
+            continue;
+
+        // RasterizeTriangle() enumerates the whole x range of the triangle when it covers a single
+        // row of samples, so such triangles are skipped.
+        const auto MinY = min3(V[0].y, V[1].y, V[2].y);
+        const auto MaxY = max3(V[0].y, V[1].y, V[2].y);
+        if (FastCeil(MinY) >= FastFloor(MaxY))
+            continue;
+
+        std::set<std::pair<int, int>> RefSamples;
+        RasterizeTriangle(float2{V[0].x, V[0].y}, float2{V[1].x, V[1].y}, float2{V[2].x, V[2].y},
+                          [&](const int2& Sample) {
+                              if (Sample.x >= 0 && Sample.y >= 0 && Sample.x < static_cast<int>(CI.Width) && Sample.y < static_cast<int>(CI.Height))
+                                  RefSamples.emplace(Sample.x, Sample.y);
+                          });
+
+        Rasterizer.Clear();
+        Rasterizer.AddScreenSpaceTriangle(V[0], V[1], V[2]);
+        Rasterizer.Rasterize();
+
+        // Depth plane in double precision
+        const double dx1 = V[1].x - V[0].x, dy1 = V[1].y - V[0].y, dz1 = V[1].z - V[0].z;
+        const double dx2 = V[2].x - V[0].x, dy2 = V[2].y - V[0].y, dz2 = V[2].z - V[0].z;
+        const double dzdx = (dz1 * dy2 - dz2 * dy1) / (dx1 * dy2 - dx2 * dy1);
+        const double dzdy = (dz2 * dx1 - dz1 * dx2) / (dx1 * dy2 - dx2 * dy1);
+
+        for (Uint32 y = 0; y < CI.Height; ++y)
+        {
+            for (Uint32 x = 0; x < CI.Width; ++x)
+            {
+                const auto Depth   = Rasterizer.GetDepth(x, y);
+                const bool Covered = RefSamples.find({static_cast<int>(x), static_cast<int>(y)}) != RefSamples.end();
+                ASSERT_EQ(Depth < 1.f, Covered) << "Triangle " << i << ", sample (" << x << ", " << y << ")";
+                if (Covered)
+                {
+                    const auto RefDepth = V[0].z + (x - V[0].x) * dzdx + (y - V[0].y) * dzdy;
+                    EXPECT_NEAR(Depth, RefDepth, 1e-4);
+                }
+            }
+        }
+        ++NumTested;
+    }
+    EXPECT_GT(NumTested, 100u);
+}
+
+TEST(Common_OcclusionRasterizer, Multithreaded)
+{
+    OcclusionRasterizer::CreateInfo CI;
+    CI.Width  = 250;
+    CI.Height = 130;
+    OcclusionRasterizer Rasterizer{CI};
+    OcclusionRasterizer MTRasterizer{CI};
+
+    FastRandFloat Rnd{1, -1.f, 1.f};
+    for (Uint32 i = 0; i < 1000; ++i)
+    {
+        float3 V[3];
+        GetRandomTriangle(Rnd, CI.Width, CI.Height, V);
+        Rasterizer.AddScreenSpaceTriangle(V[0], V[1], V[2]);
+        MTRasterizer.AddScreenSpaceTriangle(V[0], V[1], V[2]);
+    }
+    Rasterizer.Rasterize();
+
+    // Tile ranges rasterized by different threads must produce the same depth and HiZ
+    {
+        constexpr Uint32 NumThreads = 4;
+
+        const auto               NumTiles = MTRasterizer.GetNumTiles();
+        std::vector<std::thread> Threads;
+        for (Uint32 t = 0; t < NumThreads; ++t)
+        {
+            const auto FirstTile = NumTiles * t / NumThreads;
+            const auto EndTile   = NumTiles * (t + 1) / NumThreads;
+            Threads.emplace_back([&MTRasterizer, FirstTile, EndTile]() {
+                MTRasterizer.RasterizeTiles(FirstTile, EndTile - FirstTile);
+            });
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+        MTRasterizer.BuildHiZ();
+    }
+
+    for (Uint32 y = 0; y < CI.Height; ++y)
+    {
+        for (Uint32 x = 0; x < CI.Width; ++x)
+            ASSERT_EQ(Rasterizer.GetDepth(x, y), MTRasterizer.GetDepth(x, y)) << "Sample (" << x << ", " << y << ")";
+    }
+    for (Uint32 y = 0; y < CI.Height; ++y)
+    {
+        for (Uint32 x = 0; x < CI.Width; ++x)
+        {
+            for (Uint32 l = 0, TexelSize = OcclusionRasterizer::HiZBlockSize; l < Rasterizer.GetNumHiZLevels(); ++l, TexelSize *= 2)
+                ASSERT_EQ(Rasterizer.GetHiZ(l, x / TexelSize, y / TexelSize), MTRasterizer.GetHiZ(l, x / TexelSize, y / TexelSize)) << "Level " << l;
+        }
+    }
+
+    // Every HiZ texel must not be less than any sample it covers
+    for (Uint32 y = 0; y < CI.Height; ++y)
+    {
+        for (Uint32 x = 0; x < CI.Width; ++x)
+        {
+            const auto Depth = Rasterizer.GetDepth(x, y);
+            for (Uint32 l = 0, TexelSize = OcclusionRasterizer::HiZBlockSize; l < Rasterizer.GetNumHiZLevels(); ++l, TexelSize *= 2)
+                ASSERT_GE(Rasterizer.GetHiZ(l, x / TexelSize, y / TexelSize), Depth);
+        }
+    }
+}
+
+// Appends a box made of 12 triangles with clockwise front faces
+void AddBoxMesh(const BoundBox& Box, std::vector<float3>& Vertices, std::vector<Uint32>& Indices)
+{
+    const auto BaseVertex = static_cast<Uint32>(Vertices.size());
+    for (Uint32 i = 0; i < 8; ++i)
+    {
+        Vertices.emplace_back((i & 0x01) ? Box.Max.x : Box.Min.x,
+                              (i & 0x02) ? Box.Max.y : Box.Min.y,
+                              (i & 0x04) ? Box.Max.z : Box.Min.z);
+    }
+
+    // clang-format off
+    static constexpr Uint32 BoxIndices[] =
+    {
+        0,2,1, 1,2,3, // -Z
+        4,5,6, 5,7,6, // +Z
+        0,1,4, 1,5,4, // -Y
+        2,6,3, 3,6,7, // +Y
+        0,4,2, 2,4,6, // -X
+        1,3,5, 3,7,5  // +X
+    };
+    // clang-format on
+    for (auto Idx : BoxIndices)
+        Indices.push_back(BaseVertex + Idx);
+}
+
+float4x4 GetTestViewProj(bool IsGL)
+{
+    // Camera at the origin looking along +Z
+    return float4x4::Projection(PI_F / 3.f, 2.f, 1.f, 1000.f, IsGL);
+}
+
+TEST(Common_OcclusionRasterizer, Occlusion)
+{
+    for (bool IsGL : {false, true})
+    {
+        OcclusionRasterizer::CreateInfo CI;
+        CI.Width  = 256;
+        CI.Height = 128;
+        CI.IsGL   = IsGL;
+        OcclusionRasterizer Rasterizer{CI};
+
+        const auto ViewProj = GetTestViewProj(IsGL);
+
+        // Wall that covers the center of the screen
+        std::vector<float3> Vertices;
+        std::vector<Uint32> Indices;
+        AddBoxMesh(BoundBox{float3{-5, -3, 20}, float3{5, 3, 21}}, Vertices, Indices);
+
+        Rasterizer.Clear();
+        Rasterizer.AddOccluder(Vertices.data(), static_cast<Uint32>(Vertices.size()), Indices.data(),
+                               static_cast<Uint32>(Indices.size() / 3), ViewProj);
+        Rasterizer.Rasterize();
+
+        OcclusionRasterizer BackFaceCulled{CI};
+        BackFaceCulled.AddOccluder(Vertices.data(), static_cast<Uint32>(Vertices.size()), Indices.data(),
+                                   static_cast<Uint32>(Indices.size() / 3), ViewProj, true);
+        BackFaceCulled.Rasterize();
+
+        // Back faces of the closed mesh are hidden by the front faces
+        for (Uint32 y = 0; y < CI.Height; ++y)
+        {
+            for (Uint32 x = 0; x < CI.Width; ++x)
+                ASSERT_EQ(Rasterizer.GetDepth(x, y), BackFaceCulled.GetDepth(x, y)) << "Sample (" << x << ", " << y << ")";
+        }
+
+        // Behind the wall
+        EXPECT_FALSE(Rasterizer.IsVisible(BoundBox{float3{-1, -1, 30}, float3{1, 1, 32}}, ViewProj));
+        EXPECT_FALSE(Rasterizer.IsVisible(BoundBox{float3{-6, -4, 100}, float3{6, 4, 110}}, ViewProj));
+        // In front of the wall
+        EXPECT_TRUE(Rasterizer.IsVisible(BoundBox{float3{-1, -1, 10}, float3{1, 1, 12}}, ViewProj));
+        // Intersects the wall
+        EXPECT_TRUE(Rasterizer.IsVisible(BoundBox{float3{-1, -1, 15}, float3{1, 1, 25}}, ViewProj));
+        // Behind the wall, but sticks out of it
+        EXPECT_TRUE(Rasterizer.IsVisible(BoundBox{float3{3, -1, 30}, float3{8, 1, 32}}, ViewProj));
+        // Crosses the near plane
+        EXPECT_TRUE(Rasterizer.IsVisible(BoundBox{float3{-1, -1, -5}, float3{1, 1, 40}}, ViewProj));
+        // Outside of the screen
+        EXPECT_FALSE(Rasterizer.IsVisible(BoundBox{float3{200, -1, 30}, float3{201, 1, 32}}, ViewProj));
+
+        // Occluder triangles that cross the near plane are not rendered
+        Vertices = {float3{-5, -3, -1}, float3{5, -3, -1}, float3{-5, 3, 25}, float3{5, 3, 25}};
+        Indices  = {0, 2, 1, 1, 2, 3};
+        Rasterizer.Clear();
+        Rasterizer.AddOccluder(Vertices.data(), static_cast<Uint32>(Vertices.size()), Indices.data(),
+                               static_cast<Uint32>(Indices.size() / 3), ViewProj);
+        Rasterizer.Rasterize();
+        EXPECT_TRUE(Rasterizer.IsVisible(BoundBox{float3{-1, -1, 30}, float3{1, 1, 32}}, ViewProj));
+    }
+}
+
+// Performance benchmark. Run with --gtest_also_run_disabled_tests
+TEST(Common_OcclusionRasterizer, DISABLED_Benchmark)
+{
+    constexpr Uint32 NumOccluders = 500;
+    constexpr Uint32 NumOccludees = 20000;
+    constexpr Uint32 NumFrames    = 10;
+
+    FastRandFloat Rnd{2, -1.f, 1.f};
+
+    // Random boxes in front of the camera
+    auto GetRandomBox = [&](float MaxSize) {
+        const float  z = std::abs(Rnd()) * 150.f + 10.f;
+        const float3 Center{Rnd() * z, Rnd() * z * 0.5f, z};
+        const float3 HalfSize{std::abs(Rnd()) * MaxSize + 0.1f, std::abs(Rnd()) * MaxSize + 0.1f, std::abs(Rnd()) * MaxSize + 0.1f};
+        return BoundBox{Center - HalfSize, Center + HalfSize};
+    };
+
+    std::vector<float3> Vertices;
+    std::vector<Uint32> Indices;
+    for (Uint32 i = 0; i < NumOccluders; ++i)
+        AddBoxMesh(GetRandomBox(5.f), Vertices, Indices);
+
+    std::vector<BoundBox> Occludees(NumOccludees);
+    for (auto& Box : Occludees)
+        Box = GetRandomBox(1.f);
+
+    const auto ViewProj = GetTestViewProj(false);
+
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (Uint32 Threads : {1u, NumThreads})
+    {
+        OcclusionRasterizer::CreateInfo CI;
+        CI.Width  = 512;
+        CI.Height = 256;
+        OcclusionRasterizer Rasterizer{CI};
+
+        double RenderTime = 0;
+        double TestTime   = 0;
+        Uint32 NumVisible = 0;
+        for (Uint32 frame = 0; frame < NumFrames; ++frame)
+        {
+            Timer T;
+            Rasterizer.Clear();
+            Rasterizer.AddOccluder(Vertices.data(), static_cast<Uint32>(Vertices.size()), Indices.data(),
+                                   static_cast<Uint32>(Indices.size() / 3), ViewProj, true);
+            if (Threads > 1)
+            {
+                // Tile ranges are rasterized by the application threads
+                const auto               NumTiles = Rasterizer.GetNumTiles();
+                std::vector<std::thread> Workers;
+                for (Uint32 t = 0; t < Threads; ++t)
+                {
+                    const auto FirstTile = NumTiles * t / Threads;
+                    const auto EndTile   = NumTiles * (t + 1) / Threads;
+                    Workers.emplace_back([&Rasterizer, FirstTile, EndTile]() {
+                        Rasterizer.RasterizeTiles(FirstTile, EndTile - FirstTile);
+                    });
+                }
+                for (auto& Worker : Workers)
+                    Worker.join();
+                Rasterizer.BuildHiZ();
+            }
+            else
+            {
+                Rasterizer.Rasterize();
+            }
+            RenderTime += T.GetElapsedTime();
+
+            T.Restart();
+            NumVisible = 0;
+            for (const auto& Box : Occludees)
+                NumVisible += Rasterizer.IsVisible(Box, ViewProj) ? 1 : 0;
+            TestTime += T.GetElapsedTime();
+        }
+        EXPECT_GT(NumVisible, 0u);
+        EXPECT_LT(NumVisible, NumOccludees);
+
+        LOG_INFO_MESSAGE("Occlusion culling (", CI.Width, "x", CI.Height, ", ", Threads, " threads): ", NumOccluders * 12,
+                         " occluder triangles ", RenderTime / NumFrames * 1000.0, " ms/frame, ", NumOccludees, " occludees ",
+                         TestTime / NumFrames * 1000.0, " ms/frame, ", NumVisible, " visible");
+    }
+}
+
+} // namespace
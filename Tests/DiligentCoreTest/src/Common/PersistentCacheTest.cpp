@@ -0,0 +1,206 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+
+#include "PersistentCache.hpp"
+#include "HashUtils.hpp"
+#include "FileWrapper.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+struct TestKey
+{
+    Uint64 Hash0 = 0;
+    Uint64 Hash1 = 0;
+
+    bool operator==(const TestKey& rhs) const
+    {
+        return Hash0 == rhs.Hash0 && Hash1 == rhs.Hash1;
+    }
+
+    struct Hasher
+    {
+        size_t operator()(const TestKey& K) const
+        {
+            return static_cast<size_t>(K.Hash0 ^ K.Hash1);
+        }
+    };
+};
+
+TestKey MakeTestKey(const Char* Str)
+{
+    TestKey K;
+    K.Hash0 = ComputeFNVHash(Str, strlen(Str));
+    K.Hash1 = ComputeFNVHash(Str, strlen(Str), K.Hash0);
+    return K;
+}
+
+using TestCache = PersistentCache<TestKey, std::vector<Uint32>>;
+
+constexpr Uint32 TestMagic = 0x54534554;
+
+TEST(Common_HashUtils, ComputeFNVHash)
+{
+    // Reference values of the 64-bit FNV-1a hash
+    EXPECT_EQ(ComputeFNVHash(nullptr, 0), Uint64{0xcbf29ce484222325ull});
+    EXPECT_EQ(ComputeFNVHash("a", 1), Uint64{0xaf63dc4c8601ec8cull});
+    EXPECT_EQ(ComputeFNVHash("foobar", 6), Uint64{0x85944171f73967e8ull});
+
+    // Hashing the data in pieces produces the same value
+    EXPECT_EQ(ComputeFNVHash("bar", 3, ComputeFNVHash("foo", 3)), ComputeFNVHash("foobar", 6));
+}
+
+TEST(Common_PersistentCache, MemoryStore)
+{
+    TestCache Cache{TestMagic, 1, "test", "test cache", 32};
+
+    const auto Key0 = MakeTestKey("Key0");
+    const auto Key1 = MakeTestKey("Key1");
+
+    const std::vector<Uint32> Value0 = {1, 2, 3, 4};
+    const std::vector<Uint32> Value1 = {5, 6, 7, 8};
+
+    std::vector<Uint32> Value;
+    EXPECT_FALSE(Cache.Find(Key0, Value));
+
+    Cache.Add(Key0, Value0);
+    Cache.Add(Key1, Value1);
+    EXPECT_EQ(Cache.GetNumEntries(), size_t{2});
+    EXPECT_EQ(Cache.GetMemorySize(), size_t{32});
+
+    // Key1 becomes the least recently used entry
+    ASSERT_TRUE(Cache.Find(Key0, Value));
+    EXPECT_EQ(Value, Value0);
+
+    // Adding the third entry evicts Key1
+    const auto Key2 = MakeTestKey("Key2");
+    Cache.Add(Key2, {9});
+    EXPECT_EQ(Cache.GetNumEntries(), size_t{2});
+    EXPECT_EQ(Cache.GetMemorySize(), size_t{20});
+    EXPECT_FALSE(Cache.Find(Key1, Value));
+    EXPECT_TRUE(Cache.Find(Key0, Value));
+    EXPECT_TRUE(Cache.Find(Key2, Value));
+
+    // Values that exceed the limit are not kept in memory
+    Cache.Add(Key1, std::vector<Uint32>(16));
+    EXPECT_FALSE(Cache.Find(Key1, Value));
+
+    auto Stats = Cache.GetStatistics();
+    EXPECT_EQ(Stats.NumMemoryHits, Uint64{3});
+    EXPECT_EQ(Stats.NumDiskHits, Uint64{0});
+    EXPECT_EQ(Stats.NumMisses, Uint64{3});
+    EXPECT_DOUBLE_EQ(Stats.GetHitRate(), 0.5);
+
+    Cache.SetMaxMemorySize(4);
+    EXPECT_EQ(Cache.GetNumEntries(), size_t{1});
+    EXPECT_TRUE(Cache.Find(Key2, Value));
+
+    Cache.Clear();
+    EXPECT_EQ(Cache.GetNumEntries(), size_t{0});
+    EXPECT_EQ(Cache.GetMemorySize(), size_t{0});
+
+    Cache.ResetStatistics();
+    EXPECT_EQ(Cache.GetStatistics().GetNumLookups(), Uint64{0});
+}
+
+TEST(Common_PersistentCache, DiskStore)
+{
+    // Use the working directory as there is no portable way to remove a directory
+    const Char* Directory = ".";
+
+    const auto                Key   = MakeTestKey("DiskStoreTestKey");
+    const std::vector<Uint32> Value = {0x07230203, 0x00010000, 0, 1, 0};
+
+    String FilePath;
+    {
+        TestCache Cache{TestMagic, 1, "test", "test cache", 1024};
+        EXPECT_TRUE(Cache.SetDirectory(Directory));
+        FilePath = Cache.GetFilePath(Key);
+        Cache.Add(Key, Value);
+    }
+    ASSERT_TRUE(FileSystem::FileExists(FilePath.c_str()));
+    // The temporary file has been renamed
+    EXPECT_FALSE(FileSystem::FileExists((FilePath + ".tmp").c_str()));
+
+    {
+        // New cache instance, the value must be loaded from disk
+        TestCache Cache{TestMagic, 1, "test", "test cache", 1024};
+        Cache.SetDirectory(Directory);
+        EXPECT_EQ(Cache.GetFilePath(Key), FilePath);
+
+        std::vector<Uint32> LoadedValue;
+        ASSERT_TRUE(Cache.Find(Key, LoadedValue));
+        EXPECT_EQ(LoadedValue, Value);
+        EXPECT_EQ(Cache.GetStatistics().NumDiskHits, Uint64{1});
+
+        // The value is now in memory
+        LoadedValue.clear();
+        ASSERT_TRUE(Cache.Find(Key, LoadedValue));
+        EXPECT_EQ(LoadedValue, Value);
+        EXPECT_EQ(Cache.GetStatistics().NumMemoryHits, Uint64{1});
+
+        std::vector<Uint32> OtherValue;
+        EXPECT_FALSE(Cache.Find(MakeTestKey("OtherKey"), OtherValue));
+    }
+
+    {
+        // Files written by a different version of the cache must be ignored
+        TestCache Cache{TestMagic, 2, "test", "test cache", 1024};
+        Cache.SetDirectory(Directory);
+
+        std::vector<Uint32> LoadedValue;
+        EXPECT_FALSE(Cache.Find(Key, LoadedValue));
+        EXPECT_EQ(Cache.GetStatistics().NumMisses, Uint64{1});
+    }
+
+    {
+        // Truncate the file
+        FileWrapper File{FilePath.c_str(), EFileAccessMode::Overwrite};
+        ASSERT_TRUE(File != nullptr);
+        ASSERT_TRUE(File->Write(Value.data(), Value.size() * sizeof(Value[0])));
+    }
+
+    {
+        // Damaged files must be ignored
+        TestCache Cache{TestMagic, 1, "test", "test cache", 1024};
+        Cache.SetDirectory(Directory);
+
+        std::vector<Uint32> LoadedValue;
+        EXPECT_FALSE(Cache.Find(Key, LoadedValue));
+        EXPECT_EQ(Cache.GetStatistics().NumMisses, Uint64{1});
+    }
+
+    FileSystem::DeleteFile(FilePath.c_str());
+}
+
+} // namespace
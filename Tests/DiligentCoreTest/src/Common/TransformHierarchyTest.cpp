@@ -0,0 +1,372 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "TransformHierarchy.hpp"
+#include "FastRand.hpp"
+#include "Timer.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+struct TransformBatchData
+{
+    std::vector<float> Components[10];
+
+    std::vector<float3>     Translations;
+    std::vector<Quaternion> Rotations;
+    std::vector<float3>     Scales;
+
+    TransformBatchData(Uint32 NumTransforms, FastRandFloat& Rnd)
+    {
+        for (Uint32 i = 0; i < NumTransforms; ++i)
+        {
+            Translations.emplace_back(Rnd() * 10.f, Rnd() * 10.f, Rnd() * 10.f);
+            Rotations.emplace_back(Quaternion::RotationFromAxisAngle(float3{Rnd(), Rnd(), Rnd()}, Rnd() * PI_F));
+            Scales.emplace_back(std::abs(Rnd()) + 0.5f, std::abs(Rnd()) + 0.5f, std::abs(Rnd()) + 0.5f);
+
+            const float Values[] = {
+                Translations[i].x, Translations[i].y, Translations[i].z,
+                Rotations[i].q.x, Rotations[i].q.y, Rotations[i].q.z, Rotations[i].q.w,
+                Scales[i].x, Scales[i].y, Scales[i].z //
+            };
+            static_assert(sizeof(Values) == sizeof(Components) / sizeof(Components[0]) * sizeof(float), "Unexpected number of components");
+            auto* pComponent = Components;
+            for (auto Value : Values)
+                (pComponent++)->push_back(Value);
+        }
+    }
+
+    TransformBatch GetBatch() const
+    {
+        TransformBatch Batch;
+        Batch.TranslationX  = Components[0].data();
+        Batch.TranslationY  = Components[1].data();
+        Batch.TranslationZ  = Components[2].data();
+        Batch.RotationX     = Components[3].data();
+        Batch.RotationY     = Components[4].data();
+        Batch.RotationZ     = Components[5].data();
+        Batch.RotationW     = Components[6].data();
+        Batch.ScaleX        = Components[7].data();
+        Batch.ScaleY        = Components[8].data();
+        Batch.ScaleZ        = Components[9].data();
+        Batch.NumTransforms = static_cast<Uint32>(Translations.size());
+        return Batch;
+    }
+
+    float4x4 GetReferenceMatrix(Uint32 i) const
+    {
+        return float4x4::Scale(Scales[i]) * Rotations[i].ToMatrix() * float4x4::Translation(Translations[i]);
+    }
+};
+
+void CheckMatrix(const float4x4& Actual, const float4x4& Expected, float Tolerance, Uint32 Idx)
+{
+    for (int r = 0; r < 4; ++r)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            EXPECT_NEAR(Actual[r][c], Expected[r][c], Tolerance) << "Matrix " << Idx << ", element (" << r << ", " << c << ")";
+        }
+    }
+}
+
+TEST(Common_TransformHierarchy, ComposeTransforms)
+{
+    constexpr Uint32 NumTransforms = 103;
+
+    FastRandFloat      Rnd{0, -1.f, 1.f};
+    TransformBatchData Data{NumTransforms, Rnd};
+    const auto         Batch = Data.GetBatch();
+
+    // Ranges that do not start or end on the multiple of 4
+    for (Uint32 First : {0u, 1u, 6u})
+    {
+        const Uint32          Count = NumTransforms - First * 2;
+        std::vector<float4x4> Matrices(Count);
+        ComposeTransforms(Batch, First, Count, Matrices.data());
+        for (Uint32 i = 0; i < Count; ++i)
+            CheckMatrix(Matrices[i], Data.GetReferenceMatrix(First + i), 1e-5f, First + i);
+    }
+
+    // The transform is applied to a vector in scale-rotation-translation order
+    const float3 v{1, 2, 3};
+    float4x4     Matrix;
+    ComposeTransforms(Batch, 5, 1, &Matrix);
+    const auto Expected = Data.Rotations[5].RotateVector(v * Data.Scales[5]) + Data.Translations[5];
+    const auto Actual   = v * Matrix;
+    EXPECT_NEAR(Actual.x, Expected.x, 1e-5f);
+    EXPECT_NEAR(Actual.y, Expected.y, 1e-5f);
+    EXPECT_NEAR(Actual.z, Expected.z, 1e-5f);
+}
+
+TEST(Common_TransformHierarchy, MultiplyTransforms)
+{
+    constexpr Uint32 NumTransforms = 37;
+
+    FastRandFloat      Rnd{1, -1.f, 1.f};
+    TransformBatchData Data{NumTransforms * 2, Rnd};
+
+    std::vector<float4x4> A(NumTransforms), B(NumTransforms);
+    ComposeTransforms(Data.GetBatch(), 0, NumTransforms, A.data());
+    ComposeTransforms(Data.GetBatch(), NumTransforms, NumTransforms, B.data());
+
+    std::vector<float4x4> Out(NumTransforms);
+    MultiplyTransforms(A.data(), B.data(), Out.data(), NumTransforms);
+    for (Uint32 i = 0; i < NumTransforms; ++i)
+        EXPECT_EQ(Out[i], A[i] * B[i]) << "Matrix " << i;
+
+    MultiplyTransforms(A.data(), B[3], Out.data(), NumTransforms);
+    for (Uint32 i = 0; i < NumTransforms; ++i)
+        CheckMatrix(Out[i], A[i] * B[3], 1e-5f, i);
+
+    // In-place multiplication
+    auto InPlace = A;
+    MultiplyTransforms(InPlace.data(), B.data(), InPlace.data(), NumTransforms);
+    for (Uint32 i = 0; i < NumTransforms; ++i)
+        EXPECT_EQ(InPlace[i], A[i] * B[i]) << "Matrix " << i;
+}
+
+TEST(Common_TransformHierarchy, InvertAffineTransforms)
+{
+    constexpr Uint32 NumTransforms = 42;
+
+    FastRandFloat      Rnd{2, -1.f, 1.f};
+    TransformBatchData Data{NumTransforms, Rnd};
+
+    std::vector<float4x4> Matrices(NumTransforms);
+    ComposeTransforms(Data.GetBatch(), 0, NumTransforms, Matrices.data());
+    // Add shear
+    for (Uint32 i = 0; i < NumTransforms; i += 3)
+        Matrices[i][1][0] += 0.5f;
+
+    std::vector<float4x4> Inverse(NumTransforms);
+    InvertAffineTransforms(Matrices.data(), Inverse.data(), NumTransforms);
+    for (Uint32 i = 0; i < NumTransforms; ++i)
+    {
+        CheckMatrix(Inverse[i], Matrices[i].Inverse(), 1e-4f, i);
+        CheckMatrix(Matrices[i] * Inverse[i], float4x4::Identity(), 1e-5f, i);
+    }
+
+    // In-place inversion
+    auto InPlace = Matrices;
+    InvertAffineTransforms(InPlace.data(), InPlace.data(), NumTransforms);
+    for (Uint32 i = 0; i < NumTransforms; ++i)
+        EXPECT_EQ(InPlace[i], Inverse[i]) << "Matrix " << i;
+}
+
+// Creates a random hierarchy with NumRoots roots
+void CreateTestHierarchy(TransformHierarchy& Hierarchy, Uint32 NumNodes, Uint32 NumRoots, FastRandFloat& Rnd)
+{
+    Hierarchy.Clear();
+    Hierarchy.Reserve(NumNodes);
+    TransformBatchData Data{NumNodes, Rnd};
+    for (Uint32 i = 0; i < NumNodes; ++i)
+    {
+        // Parent of node i is one of the previous nodes, so the hierarchy gets deeper as it grows
+        const auto Parent = i < NumRoots ? TransformHierarchy::InvalidNode : static_cast<Uint32>((std::abs(Rnd()) * 0.25f + 0.5f) * static_cast<float>(i));
+        Hierarchy.AddNode(Parent, Data.Translations[i], Data.Rotations[i], Data.Scales[i] * 0.5f + float3{0.5f, 0.5f, 0.5f});
+    }
+}
+
+// Updates the hierarchy by distributing the node ranges between NumThreads threads.
+// The threads wait for each other after the local matrices and after every level.
+void UpdateMultithreaded(TransformHierarchy& Hierarchy, Uint32 NumThreads)
+{
+    Hierarchy.BeginUpdate();
+
+    std::mutex              Mtx;
+    std::condition_variable CondVar;
+    Uint32                  NumWaiting = 0;
+    Uint32                  Generation = 0;
+
+    auto Barrier = [&]() {
+        std::unique_lock<std::mutex> Lock{Mtx};
+        const auto                   CurrGeneration = Generation;
+        if (++NumWaiting == NumThreads)
+        {
+            NumWaiting = 0;
+            ++Generation;
+            CondVar.notify_all();
+        }
+        else
+        {
+            CondVar.wait(Lock, [&]() { return Generation != CurrGeneration; });
+        }
+    };
+
+    auto UpdateNodes = [&](Uint32 Thread) {
+        const auto NumNodes  = Hierarchy.GetNumNodes();
+        const auto FirstNode = NumNodes * Thread / NumThreads;
+        Hierarchy.ComposeLocalMatrices(FirstNode, NumNodes * (Thread + 1) / NumThreads - FirstNode);
+
+        for (Uint32 Level = 0; Level < Hierarchy.GetNumLevels(); ++Level)
+        {
+            Barrier();
+            const auto LevelSize  = Hierarchy.GetLevelSize(Level);
+            const auto FirstLevel = LevelSize * Thread / NumThreads;
+            Hierarchy.UpdateWorldMatrices(Level, FirstLevel, LevelSize * (Thread + 1) / NumThreads - FirstLevel);
+        }
+    };
+
+    std::vector<std::thread> Threads;
+    for (Uint32 t = 1; t < NumThreads; ++t)
+        Threads.emplace_back(UpdateNodes, t);
+    UpdateNodes(0);
+    for (auto& Thread : Threads)
+        Thread.join();
+}
+
+TEST(Common_TransformHierarchy, Update)
+{
+    constexpr Uint32 NumNodes = 5000;
+
+    FastRandFloat      Rnd{3, -1.f, 1.f};
+    TransformHierarchy Hierarchy;
+    CreateTestHierarchy(Hierarchy, NumNodes, 3, Rnd);
+    EXPECT_GT(Hierarchy.GetNumLevels(), 5u);
+
+    Hierarchy.Update();
+    const std::vector<float4x4> WorldMatrices{Hierarchy.GetWorldMatrices(), Hierarchy.GetWorldMatrices() + NumNodes};
+
+    for (Uint32 Node = 0; Node < NumNodes; ++Node)
+    {
+        // Reference world matrix is computed by walking up the hierarchy
+        auto RefWorld = float4x4::Identity();
+        for (auto n = Node; n != TransformHierarchy::InvalidNode; n = Hierarchy.GetParent(n))
+            RefWorld = RefWorld * float4x4::Scale(Hierarchy.GetScale(n)) * Hierarchy.GetRotation(n).ToMatrix() * float4x4::Translation(Hierarchy.GetTranslation(n));
+
+        // Translations grow with the depth, so the tolerance is relative
+        float Tolerance = 0;
+        for (int r = 0; r < 4; ++r)
+            Tolerance = std::max(Tolerance, max3(std::abs(RefWorld[r][0]), std::abs(RefWorld[r][1]), std::abs(RefWorld[r][2])));
+        CheckMatrix(Hierarchy.GetWorldMatrix(Node), RefWorld, Tolerance * 1e-4f, Node);
+    }
+
+    // Node ranges updated by different threads must produce exactly the same results
+    for (Uint32 NumThreads : {1u, 2u, 4u, 7u})
+    {
+        UpdateMultithreaded(Hierarchy, NumThreads);
+        for (Uint32 Node = 0; Node < NumNodes; ++Node)
+            ASSERT_EQ(Hierarchy.GetWorldMatrix(Node), WorldMatrices[Node]) << "Node " << Node << ", " << NumThreads << " threads";
+    }
+
+    // Changed transforms are picked up by the next update
+    Hierarchy.SetTranslation(0, float3{100, 200, 300});
+    UpdateMultithreaded(Hierarchy, 4);
+    EXPECT_EQ(Hierarchy.GetLocalMatrix(0)[3][0], 100.f);
+    EXPECT_EQ(Hierarchy.GetWorldMatrix(0)[3][1], 200.f);
+    for (Uint32 Node = 0; Node < NumNodes; ++Node)
+    {
+        const auto Parent = Hierarchy.GetParent(Node);
+        if (Parent == TransformHierarchy::InvalidNode)
+            continue;
+        ASSERT_EQ(Hierarchy.GetWorldMatrix(Node), Hierarchy.GetLocalMatrix(Node) * Hierarchy.GetWorldMatrix(Parent)) << "Node " << Node;
+    }
+}
+
+TEST(Common_TransformHierarchy, Chain)
+{
+    // Every level has a single node
+    TransformHierarchy Hierarchy;
+    auto               Node = TransformHierarchy::InvalidNode;
+    for (Uint32 i = 0; i < 100; ++i)
+        Node = Hierarchy.AddNode(Node, float3{1, 0, 0});
+    EXPECT_EQ(Hierarchy.GetNumLevels(), 100u);
+
+    UpdateMultithreaded(Hierarchy, 3);
+    for (Uint32 i = 0; i < 100; ++i)
+        EXPECT_EQ(Hierarchy.GetWorldMatrix(i), float4x4::Translation(static_cast<float>(i + 1), 0, 0));
+
+    Hierarchy.Clear();
+    EXPECT_EQ(Hierarchy.GetNumNodes(), 0u);
+    EXPECT_EQ(Hierarchy.GetNumLevels(), 0u);
+    UpdateMultithreaded(Hierarchy, 3);
+}
+
+// Performance benchmark. Run with --gtest_also_run_disabled_tests
+TEST(Common_TransformHierarchy, DISABLED_Benchmark)
+{
+    constexpr Uint32 NumNodes      = 100000;
+    constexpr int    NumIterations = 10;
+
+    FastRandFloat      Rnd{4, -1.f, 1.f};
+    TransformHierarchy Hierarchy;
+    CreateTestHierarchy(Hierarchy, NumNodes, 16, Rnd);
+
+    // Node-by-node update with BasicMath types
+    std::vector<float4x4> WorldMatrices(NumNodes);
+
+    Timer T;
+    for (int iter = 0; iter < NumIterations; ++iter)
+    {
+        for (Uint32 Node = 0; Node < NumNodes; ++Node)
+        {
+            const auto Local  = float4x4::Scale(Hierarchy.GetScale(Node)) * Hierarchy.GetRotation(Node).ToMatrix() * float4x4::Translation(Hierarchy.GetTranslation(Node));
+            const auto Parent = Hierarchy.GetParent(Node);
+
+            WorldMatrices[Node] = Parent != TransformHierarchy::InvalidNode ? Local * WorldMatrices[Parent] : Local;
+        }
+    }
+    const auto NodeByNodeTime = T.GetElapsedTime() / NumIterations;
+
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 2u);
+    for (Uint32 Threads : {1u, NumThreads})
+    {
+        auto Update = [&]() {
+            if (Threads > 1)
+                UpdateMultithreaded(Hierarchy, Threads);
+            else
+                Hierarchy.Update();
+        };
+        Update();
+
+        T.Restart();
+        for (int iter = 0; iter < NumIterations; ++iter)
+            Update();
+        const auto UpdateTime = T.GetElapsedTime() / NumIterations;
+
+        for (Uint32 Node = 0; Node < NumNodes; Node += 97)
+        {
+            const auto& Ref = WorldMatrices[Node];
+            CheckMatrix(Hierarchy.GetWorldMatrix(Node), Ref, std::max(std::abs(Ref[3][0]), 1.f) * 1e-4f, Node);
+        }
+
+        LOG_INFO_MESSAGE("TransformHierarchy::Update (", NumNodes, " nodes, ", Hierarchy.GetNumLevels(), " levels, ", Threads, " threads): ",
+                         UpdateTime * 1000, " ms, node-by-node update: ", NodeByNodeTime * 1000, " ms (x", NodeByNodeTime / std::max(UpdateTime, 1e-9), ")");
+    }
+}
+
+} // namespace
@@ -0,0 +1,379 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+#include <thread>
+
+#include "TriangleBVH.hpp"
+#include "FastRand.hpp"
+#include "Timer.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+struct TestMesh
+{
+    std::vector<float3> Vertices;
+    std::vector<Uint32> Indices;
+
+    Uint32 GetNumTriangles() const { return static_cast<Uint32>(Indices.size() / 3); }
+
+    TriangleBVH::CreateInfo GetBVHCreateInfo() const
+    {
+        TriangleBVH::CreateInfo CI;
+        CI.pVertices    = Vertices.data();
+        CI.NumVertices  = static_cast<Uint32>(Vertices.size());
+        CI.pIndices     = Indices.data();
+        CI.NumTriangles = GetNumTriangles();
+        return CI;
+    }
+};
+
+// Random triangles in the [-10, 10]^3 cube
+TestMesh CreateTriangleSoup(Uint32 NumTriangles, FastRandFloat& Rnd)
+{
+    TestMesh Mesh;
+    for (Uint32 i = 0; i < NumTriangles; ++i)
+    {
+        const float3 Center{Rnd() * 10.f, Rnd() * 10.f, Rnd() * 10.f};
+        for (Uint32 v = 0; v < 3; ++v)
+        {
+            Mesh.Indices.push_back(static_cast<Uint32>(Mesh.Vertices.size()));
+            Mesh.Vertices.push_back(Center + float3{Rnd(), Rnd(), Rnd()});
+        }
+    }
+    return Mesh;
+}
+
+// Height field in the XZ plane that covers [-10, 10] x [-10, 10] and contains approximately NumTriangles triangles
+TestMesh CreateTerrain(Uint32 NumTriangles)
+{
+    const auto GridSize = std::max(static_cast<Uint32>(std::sqrt(static_cast<float>(NumTriangles) / 2.f)), 1u);
+
+    TestMesh Mesh;
+    Mesh.Vertices.reserve((GridSize + 1) * (GridSize + 1));
+    for (Uint32 j = 0; j <= GridSize; ++j)
+    {
+        for (Uint32 i = 0; i <= GridSize; ++i)
+        {
+            const auto x = static_cast<float>(i) / static_cast<float>(GridSize) * 20.f - 10.f;
+            const auto z = static_cast<float>(j) / static_cast<float>(GridSize) * 20.f - 10.f;
+            Mesh.Vertices.emplace_back(x, std::sin(x * 0.7f) * std::cos(z * 0.4f) * 2.f, z);
+        }
+    }
+
+    Mesh.Indices.reserve(GridSize * GridSize * 6);
+    for (Uint32 j = 0; j < GridSize; ++j)
+    {
+        for (Uint32 i = 0; i < GridSize; ++i)
+        {
+            const Uint32 v00 = j * (GridSize + 1) + i;
+            const Uint32 v10 = v00 + 1;
+            const Uint32 v01 = v00 + GridSize + 1;
+            const Uint32 v11 = v01 + 1;
+            for (auto Idx : {v00, v01, v10, v10, v01, v11})
+                Mesh.Indices.push_back(Idx);
+        }
+    }
+    return Mesh;
+}
+
+TriangleBVH::HitInfo BruteForceClosestHit(const TestMesh& Mesh, const float3& Origin, const float3& Dir, float MaxDistance)
+{
+    TriangleBVH::HitInfo Hit;
+    Hit.Distance = MaxDistance;
+    for (Uint32 tri = 0; tri < Mesh.GetNumTriangles(); ++tri)
+    {
+        const auto t = IntersectRayTriangle(Mesh.Vertices[Mesh.Indices[tri * 3 + 0]],
+                                            Mesh.Vertices[Mesh.Indices[tri * 3 + 1]],
+                                            Mesh.Vertices[Mesh.Indices[tri * 3 + 2]],
+                                            Origin, Dir);
+        if (t >= 0 && t != FLT_MAX && (t < Hit.Distance || (t == Hit.Distance && tri < Hit.TriangleIndex)))
+        {
+            Hit.Distance      = t;
+            Hit.TriangleIndex = tri;
+        }
+    }
+    return Hit.IsHit() ? Hit : TriangleBVH::HitInfo{};
+}
+
+struct TestRays
+{
+    std::vector<float3> Origins;
+    std::vector<float3> Directions;
+};
+
+// Rays from random points outside of the cube towards random points inside it
+TestRays CreateRandomRays(Uint32 NumRays, FastRandFloat& Rnd)
+{
+    TestRays Rays;
+    for (Uint32 i = 0; i < NumRays; ++i)
+    {
+        const float3 Origin{Rnd() * 30.f, Rnd() * 30.f, Rnd() * 30.f};
+        const float3 Target{Rnd() * 10.f, Rnd() * 10.f, Rnd() * 10.f};
+        Rays.Origins.push_back(Origin);
+        Rays.Directions.push_back(normalize(Target - Origin));
+    }
+    return Rays;
+}
+
+// Coherent rays from a pinhole camera looking down at the terrain
+TestRays CreateCameraRays(Uint32 Width, Uint32 Height)
+{
+    TestRays Rays;
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            const float u = (static_cast<float>(x) + 0.5f) / static_cast<float>(Width) * 2.f - 1.f;
+            const float v = (static_cast<float>(y) + 0.5f) / static_cast<float>(Height) * 2.f - 1.f;
+            Rays.Origins.emplace_back(0.f, 15.f, -15.f);
+            Rays.Directions.push_back(normalize(float3{u, -1.f + v * 0.5f, 1.f}));
+        }
+    }
+    return Rays;
+}
+
+void ExpectSameNodes(const TriangleBVH& BVH, const TriangleBVH& RefBVH)
+{
+    const auto& Nodes    = BVH.GetNodes();
+    const auto& RefNodes = RefBVH.GetNodes();
+    ASSERT_EQ(Nodes.size(), RefNodes.size());
+    for (size_t i = 0; i < Nodes.size(); ++i)
+    {
+        EXPECT_EQ(Nodes[i].Min, RefNodes[i].Min) << "Node " << i;
+        EXPECT_EQ(Nodes[i].Max, RefNodes[i].Max) << "Node " << i;
+        EXPECT_EQ(Nodes[i].RightChildOrFirstTriangle, RefNodes[i].RightChildOrFirstTriangle) << "Node " << i;
+        EXPECT_EQ(Nodes[i].NumTriangles, RefNodes[i].NumTriangles) << "Node " << i;
+    }
+}
+
+TEST(Common_TriangleBVH, Queries)
+{
+    FastRandFloat Rnd{0, -1.f, 1.f};
+
+    const auto Mesh = CreateTriangleSoup(2000, Rnd);
+    const auto Rays = CreateRandomRays(1000, Rnd);
+
+    auto CI = Mesh.GetBVHCreateInfo();
+
+    TriangleBVH BVH{CI};
+    EXPECT_EQ(BVH.GetNumTriangles(), Mesh.GetNumTriangles());
+    EXPECT_GT(BVH.GetDepth(), 0u);
+
+    // Every triangle must be referenced by exactly one leaf that contains it
+    {
+        const auto&         Nodes = BVH.GetNodes();
+        std::vector<Uint32> RefCount(Mesh.GetNumTriangles());
+        for (const auto& Node : Nodes)
+        {
+            if (!Node.IsLeaf())
+            {
+                EXPECT_LT(Node.RightChildOrFirstTriangle, Nodes.size());
+                continue;
+            }
+            EXPECT_LE(Node.NumTriangles, CI.MaxTrianglesPerLeaf);
+            for (Uint32 i = 0; i < Node.NumTriangles; ++i)
+                ++RefCount[Node.RightChildOrFirstTriangle + i];
+        }
+        for (auto Count : RefCount)
+            EXPECT_EQ(Count, 1u);
+    }
+
+    Uint32 NumHits = 0;
+    for (size_t r = 0; r < Rays.Origins.size(); ++r)
+    {
+        const auto& Origin = Rays.Origins[r];
+        const auto& Dir    = Rays.Directions[r];
+
+        const auto RefHit = BruteForceClosestHit(Mesh, Origin, Dir, FLT_MAX);
+
+        TriangleBVH::HitInfo Hit;
+        EXPECT_EQ(BVH.ClosestHit(Origin, Dir, Hit), RefHit.IsHit());
+        EXPECT_EQ(Hit.TriangleIndex, RefHit.TriangleIndex) << "Ray " << r;
+        EXPECT_EQ(Hit.Distance, RefHit.Distance) << "Ray " << r;
+
+        EXPECT_EQ(BVH.AnyHit(Origin, Dir), RefHit.IsHit()) << "Ray " << r;
+        if (RefHit.IsHit())
+        {
+            ++NumHits;
+
+            // The closest hit is beyond the max distance
+            EXPECT_FALSE(BVH.ClosestHit(Origin, Dir, Hit, RefHit.Distance * 0.99f));
+            EXPECT_FALSE(Hit.IsHit());
+            EXPECT_FALSE(BVH.AnyHit(Origin, Dir, RefHit.Distance * 0.99f)) << "Ray " << r;
+            EXPECT_TRUE(BVH.AnyHit(Origin, Dir, RefHit.Distance)) << "Ray " << r;
+        }
+    }
+    EXPECT_GT(NumHits, 0u);
+    EXPECT_LT(NumHits, Rays.Origins.size());
+
+    // Packet traversal must produce the same results as single-ray traversal
+    {
+        const auto NumRays = static_cast<Uint32>(Rays.Origins.size());
+
+        std::vector<TriangleBVH::HitInfo> PacketHits(NumRays);
+        BVH.ClosestHitPacket(Rays.Origins.data(), Rays.Directions.data(), NumRays, PacketHits.data());
+        for (Uint32 r = 0; r < NumRays; ++r)
+        {
+            TriangleBVH::HitInfo Hit;
+            BVH.ClosestHit(Rays.Origins[r], Rays.Directions[r], Hit);
+            EXPECT_EQ(PacketHits[r].TriangleIndex, Hit.TriangleIndex) << "Ray " << r;
+            EXPECT_EQ(PacketHits[r].Distance, Hit.Distance) << "Ray " << r;
+        }
+    }
+
+    // Parallel build must produce the same hierarchy
+    {
+        CI.NumThreads = 4;
+        TriangleBVH ParallelBVH{CI};
+        ExpectSameNodes(ParallelBVH, BVH);
+    }
+}
+
+TEST(Common_TriangleBVH, EmptyAndNonIndexed)
+{
+    {
+        TriangleBVH BVH{TriangleBVH::CreateInfo{}};
+
+        TriangleBVH::HitInfo Hit;
+        EXPECT_FALSE(BVH.ClosestHit(float3{0, 0, 0}, float3{0, 0, 1}, Hit));
+        EXPECT_FALSE(BVH.AnyHit(float3{0, 0, 0}, float3{0, 0, 1}));
+    }
+
+    {
+        // clang-format off
+        const float3 Vertices[] =
+        {
+            {-1, -1, 2}, {-1, 1, 2}, {1, -1, 2},
+            {-1, -1, 5}, {-1, 1, 5}, {1, -1, 5}
+        };
+        // clang-format on
+        TriangleBVH::CreateInfo CI;
+        CI.pVertices    = Vertices;
+        CI.NumVertices  = _countof(Vertices);
+        CI.NumTriangles = 2;
+        TriangleBVH BVH{CI};
+
+        TriangleBVH::HitInfo Hit;
+        EXPECT_TRUE(BVH.ClosestHit(float3{-0.5f, -0.5f, 0}, float3{0, 0, 1}, Hit));
+        EXPECT_EQ(Hit.TriangleIndex, 0u);
+        EXPECT_EQ(Hit.Distance, 2.f);
+
+        EXPECT_TRUE(BVH.ClosestHit(float3{-0.5f, -0.5f, 3}, float3{0, 0, 1}, Hit));
+        EXPECT_EQ(Hit.TriangleIndex, 1u);
+        EXPECT_EQ(Hit.Distance, 2.f);
+
+        EXPECT_FALSE(BVH.ClosestHit(float3{0.5f, 0.5f, 0}, float3{0, 0, 1}, Hit));
+    }
+}
+
+// Performance benchmark. Run with --gtest_also_run_disabled_tests
+TEST(Common_TriangleBVH, DISABLED_Benchmark)
+{
+    // Larger meshes (up to 10M triangles) may be benchmarked by extending the list.
+    // They are not included by default to keep the test run time and memory usage reasonable.
+    const Uint32 MeshSizes[] = {10000, 100000, 1000000};
+
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    const auto Rays       = CreateCameraRays(256, 256);
+    const auto NumRays    = static_cast<Uint32>(Rays.Origins.size());
+
+    for (auto NumTriangles : MeshSizes)
+    {
+        const auto Mesh = CreateTerrain(NumTriangles);
+        auto       CI   = Mesh.GetBVHCreateInfo();
+
+        Timer T;
+
+        TriangleBVH BVH{CI};
+        const auto  BuildTime = T.GetElapsedTime();
+
+        CI.NumThreads = NumThreads;
+        T.Restart();
+        TriangleBVH ParallelBVH{CI};
+        const auto  ParallelBuildTime = T.GetElapsedTime();
+        ExpectSameNodes(ParallelBVH, BVH);
+
+        std::vector<TriangleBVH::HitInfo> Hits(NumRays);
+
+        T.Restart();
+        for (Uint32 r = 0; r < NumRays; ++r)
+            BVH.ClosestHit(Rays.Origins[r], Rays.Directions[r], Hits[r]);
+        const auto ClosestHitTime = T.GetElapsedTime();
+
+        Uint32 NumHits = 0;
+        for (const auto& Hit : Hits)
+            NumHits += Hit.IsHit() ? 1 : 0;
+        EXPECT_GT(NumHits, 0u);
+
+        T.Restart();
+        Uint32 NumAnyHits = 0;
+        for (Uint32 r = 0; r < NumRays; ++r)
+            NumAnyHits += BVH.AnyHit(Rays.Origins[r], Rays.Directions[r]) ? 1 : 0;
+        const auto AnyHitTime = T.GetElapsedTime();
+        EXPECT_EQ(NumAnyHits, NumHits);
+
+        std::vector<TriangleBVH::HitInfo> PacketHits(NumRays);
+        T.Restart();
+        // Process the image in 8x8 tiles to make packets coherent
+        for (Uint32 y = 0; y < 256; y += 8)
+        {
+            for (Uint32 x = 0; x < 256; x += 8)
+            {
+                float3 TileOrigins[64], TileDirs[64];
+                for (Uint32 i = 0; i < 64; ++i)
+                {
+                    const auto RayIdx = (y + i / 8) * 256 + x + i % 8;
+                    TileOrigins[i]    = Rays.Origins[RayIdx];
+                    TileDirs[i]       = Rays.Directions[RayIdx];
+                }
+                TriangleBVH::HitInfo TileHits[64];
+                BVH.ClosestHitPacket(TileOrigins, TileDirs, 64, TileHits);
+                for (Uint32 i = 0; i < 64; ++i)
+                    PacketHits[(y + i / 8) * 256 + x + i % 8] = TileHits[i];
+            }
+        }
+        const auto PacketTime = T.GetElapsedTime();
+        for (Uint32 r = 0; r < NumRays; ++r)
+            EXPECT_EQ(PacketHits[r].TriangleIndex, Hits[r].TriangleIndex);
+
+        auto MRaysPerSec = [NumRays](double Time) {
+            return NumRays / std::max(Time, 1e-9) * 1e-6;
+        };
+        LOG_INFO_MESSAGE(Mesh.GetNumTriangles(), " triangles: build ", BuildTime * 1000.0, " ms, parallel build (", NumThreads,
+                         " threads) ", ParallelBuildTime * 1000.0, " ms, depth ", BVH.GetDepth(),
+                         "; closest hit ", MRaysPerSec(ClosestHitTime), " Mrays/s, any hit ", MRaysPerSec(AnyHitTime),
+                         " Mrays/s, packet closest hit ", MRaysPerSec(PacketTime), " Mrays/s");
+    }
+}
+
+} // namespace
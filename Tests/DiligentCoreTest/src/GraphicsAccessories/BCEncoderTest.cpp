@@ -0,0 +1,584 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <cmath>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include "BCEncoder.hpp"
+#include "GraphicsAccessories.hpp"
+#include "BasicMath.hpp"
+#include "Timer.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Reference decoders for the block modes emitted by the encoder
+
+class BitReader
+{
+public:
+    explicit BitReader(const Uint8* pData) :
+        m_pData{pData}
+    {}
+
+    Uint32 Read(Uint32 NumBits)
+    {
+        Uint32 Value = 0;
+        for (Uint32 i = 0; i < NumBits; ++i, ++m_Pos)
+            Value |= ((m_pData[m_Pos >> 3u] >> (m_Pos & 7u)) & 1u) << i;
+        return Value;
+    }
+
+private:
+    const Uint8* const m_pData;
+    Uint32             m_Pos = 0;
+};
+
+void DecodeBC1Block(const Uint8* pBlock, bool IsBC1, Uint8 (*Texels)[4])
+{
+    BitReader  Reader{pBlock};
+    const auto Color0 = Reader.Read(16);
+    const auto Color1 = Reader.Read(16);
+
+    int Colors[4][4] = {};
+    for (Uint32 e = 0; e < 2; ++e)
+    {
+        const auto Color = e == 0 ? Color0 : Color1;
+        const auto r     = (Color >> 11u) & 0x1Fu;
+        const auto g     = (Color >> 5u) & 0x3Fu;
+        const auto b     = Color & 0x1Fu;
+
+        Colors[e][0] = static_cast<int>((r << 3u) | (r >> 2u));
+        Colors[e][1] = static_cast<int>((g << 2u) | (g >> 4u));
+        Colors[e][2] = static_cast<int>((b << 3u) | (b >> 2u));
+        Colors[e][3] = 255;
+    }
+    for (Uint32 c = 0; c < 3; ++c)
+    {
+        if (Color0 > Color1 || !IsBC1)
+        {
+            Colors[2][c] = (2 * Colors[0][c] + Colors[1][c] + 1) / 3;
+            Colors[3][c] = (Colors[0][c] + 2 * Colors[1][c] + 1) / 3;
+        }
+        else
+        {
+            Colors[2][c] = (Colors[0][c] + Colors[1][c]) / 2;
+            Colors[3][c] = 0;
+        }
+    }
+    Colors[2][3] = 255;
+    Colors[3][3] = (Color0 > Color1 || !IsBC1) ? 255 : 0;
+
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        const auto Idx = Reader.Read(2);
+        for (Uint32 c = 0; c < 4; ++c)
+            Texels[i][c] = static_cast<Uint8>(Colors[Idx][c]);
+    }
+}
+
+void DecodeBC4Block(const Uint8* pBlock, bool IsSigned, Uint8 (*Texels)[4], Uint32 Ch)
+{
+    BitReader Reader{pBlock};
+
+    const auto Raw0 = Reader.Read(8);
+    const auto Raw1 = Reader.Read(8);
+    const auto v0   = IsSigned ? static_cast<int>(static_cast<Int8>(Raw0)) : static_cast<int>(Raw0);
+    const auto v1   = IsSigned ? static_cast<int>(static_cast<Int8>(Raw1)) : static_cast<int>(Raw1);
+
+    float Values[8] = {static_cast<float>(v0), static_cast<float>(v1)};
+    if (v0 > v1)
+    {
+        for (int k = 2; k < 8; ++k)
+            Values[k] = static_cast<float>((8 - k) * v0 + (k - 1) * v1) / 7.f;
+    }
+    else
+    {
+        for (int k = 2; k < 6; ++k)
+            Values[k] = static_cast<float>((6 - k) * v0 + (k - 1) * v1) / 5.f;
+        Values[6] = IsSigned ? -127.f : 0.f;
+        Values[7] = IsSigned ? 127.f : 255.f;
+    }
+
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        const auto Value = static_cast<int>(std::floor(Values[Reader.Read(3)] + 0.5f));
+        Texels[i][Ch]    = static_cast<Uint8>(IsSigned ? static_cast<Int8>(Value) : Value);
+    }
+}
+
+// clang-format off
+static constexpr Uint16 BC7Partitions2[64] =
+{
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+    0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+    0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+    0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+    0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+};
+static constexpr Uint8 BC7AnchorIndices2[64] =
+{
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+     6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15
+};
+static constexpr Uint32 BC7Weights3[8]  = {0, 9, 18, 27, 37, 46, 55, 64};
+static constexpr Uint32 BC7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+// clang-format on
+
+// Decodes mode 1 and mode 6 blocks
+void DecodeBC7Block(const Uint8* pBlock, Uint8 (*Texels)[4])
+{
+    BitReader Reader{pBlock};
+
+    Uint32 Mode = 0;
+    while (Mode < 8 && Reader.Read(1) == 0)
+        ++Mode;
+
+    if (Mode == 6)
+    {
+        Uint32 Endpoints[2][4];
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            Endpoints[0][c] = Reader.Read(7);
+            Endpoints[1][c] = Reader.Read(7);
+        }
+        for (Uint32 e = 0; e < 2; ++e)
+        {
+            const auto PBit = Reader.Read(1);
+            for (Uint32 c = 0; c < 4; ++c)
+                Endpoints[e][c] = (Endpoints[e][c] << 1u) | PBit;
+        }
+        for (Uint32 i = 0; i < 16; ++i)
+        {
+            const auto w = BC7Weights4[Reader.Read(i == 0 ? 3 : 4)];
+            for (Uint32 c = 0; c < 4; ++c)
+                Texels[i][c] = static_cast<Uint8>(((64 - w) * Endpoints[0][c] + w * Endpoints[1][c] + 32) >> 6);
+        }
+    }
+    else if (Mode == 1)
+    {
+        const auto Partition = Reader.Read(6);
+
+        Uint32 Endpoints[2][2][3];
+        for (Uint32 c = 0; c < 3; ++c)
+        {
+            for (Uint32 s = 0; s < 2; ++s)
+            {
+                Endpoints[s][0][c] = Reader.Read(6);
+                Endpoints[s][1][c] = Reader.Read(6);
+            }
+        }
+        for (Uint32 s = 0; s < 2; ++s)
+        {
+            const auto PBit = Reader.Read(1);
+            for (Uint32 e = 0; e < 2; ++e)
+            {
+                for (Uint32 c = 0; c < 3; ++c)
+                {
+                    const auto v7      = (Endpoints[s][e][c] << 1u) | PBit;
+                    Endpoints[s][e][c] = (v7 << 1u) | (v7 >> 6u);
+                }
+            }
+        }
+        for (Uint32 i = 0; i < 16; ++i)
+        {
+            const auto IsAnchor = i == 0 || i == BC7AnchorIndices2[Partition];
+            const auto w        = BC7Weights3[Reader.Read(IsAnchor ? 2 : 3)];
+            const auto s        = (BC7Partitions2[Partition] >> i) & 1u;
+            for (Uint32 c = 0; c < 3; ++c)
+                Texels[i][c] = static_cast<Uint8>(((64 - w) * Endpoints[s][0][c] + w * Endpoints[s][1][c] + 32) >> 6);
+            Texels[i][3] = 255;
+        }
+    }
+    else
+    {
+        ADD_FAILURE() << "Unexpected BC7 mode " << Mode;
+    }
+}
+
+bool IsSNormFormat(TEXTURE_FORMAT Format)
+{
+    return Format == TEX_FORMAT_BC4_SNORM || Format == TEX_FORMAT_BC5_SNORM;
+}
+
+// Decodes the compressed data into RGBA8 texels
+std::vector<Uint8> DecodeTexture(TEXTURE_FORMAT Format, Uint32 Width, Uint32 Height, const std::vector<Uint8>& CompressedData)
+{
+    const auto& FmtAttribs = GetTextureFormatAttribs(Format);
+    const auto  BlockSize  = Uint32{FmtAttribs.ComponentSize};
+    const auto  NumBlocksX = (Width + 3) / 4;
+    const auto  NumBlocksY = (Height + 3) / 4;
+    const auto  IsSigned   = IsSNormFormat(Format);
+
+    std::vector<Uint8> Texels(size_t{Width} * Height * 4);
+    for (Uint32 by = 0; by < NumBlocksY; ++by)
+    {
+        for (Uint32 bx = 0; bx < NumBlocksX; ++bx)
+        {
+            const auto* pBlock = &CompressedData[(by * NumBlocksX + bx) * BlockSize];
+
+            Uint8 Block[16][4] = {};
+            switch (Format)
+            {
+                case TEX_FORMAT_BC1_UNORM:
+                    DecodeBC1Block(pBlock, true, Block);
+                    break;
+
+                case TEX_FORMAT_BC3_UNORM:
+                    DecodeBC1Block(pBlock + 8, false, Block);
+                    DecodeBC4Block(pBlock, false, Block, 3);
+                    break;
+
+                case TEX_FORMAT_BC4_UNORM:
+                case TEX_FORMAT_BC4_SNORM:
+                    DecodeBC4Block(pBlock, IsSigned, Block, 0);
+                    break;
+
+                case TEX_FORMAT_BC5_UNORM:
+                case TEX_FORMAT_BC5_SNORM:
+                    DecodeBC4Block(pBlock, IsSigned, Block, 0);
+                    DecodeBC4Block(pBlock + 8, IsSigned, Block, 1);
+                    break;
+
+                case TEX_FORMAT_BC7_UNORM:
+                    DecodeBC7Block(pBlock, Block);
+                    break;
+
+                default:
+                    ADD_FAILURE() << "Unexpected format";
+            }
+
+            for (Uint32 i = 0; i < 16; ++i)
+            {
+                const auto x = bx * 4 + i % 4;
+                const auto y = by * 4 + i / 4;
+                if (x < Width && y < Height)
+                {
+                    for (Uint32 c = 0; c < 4; ++c)
+                        Texels[(size_t{y} * Width + x) * 4 + c] = Block[i][c];
+                }
+            }
+        }
+    }
+    return Texels;
+}
+
+std::vector<Uint8> Compress(TEXTURE_FORMAT            SrcFormat,
+                            TEXTURE_FORMAT            DstFormat,
+                            Uint32                    Width,
+                            Uint32                    Height,
+                            const std::vector<Uint8>& SrcData,
+                            BC_COMPRESSION_QUALITY    Quality,
+                            Uint32                    NumThreads = 1)
+{
+    const auto& DstFmtAttribs = GetTextureFormatAttribs(DstFormat);
+    const auto  NumBlocksX    = (Width + 3) / 4;
+    const auto  NumBlocksY    = (Height + 3) / 4;
+
+    std::vector<Uint8> CompressedData(size_t{NumBlocksX} * NumBlocksY * DstFmtAttribs.ComponentSize);
+
+    BCCompressAttribs Attribs;
+    Attribs.SrcFormat  = SrcFormat;
+    Attribs.DstFormat  = DstFormat;
+    Attribs.Width      = Width;
+    Attribs.Height     = Height;
+    Attribs.pSrcData   = SrcData.data();
+    Attribs.SrcStride  = size_t{Width} * GetTextureFormatAttribs(SrcFormat).NumComponents;
+    Attribs.pDstData   = CompressedData.data();
+    Attribs.DstStride  = size_t{NumBlocksX} * DstFmtAttribs.ComponentSize;
+    Attribs.Quality    = Quality;
+    Attribs.NumThreads = NumThreads;
+    EXPECT_TRUE(CompressTextureBC(Attribs));
+
+    return CompressedData;
+}
+
+// Smooth gradients with sharp edges and some noise
+std::vector<Uint8> GenerateTestImage(Uint32 Width, Uint32 Height)
+{
+    std::vector<Uint8> Data(size_t{Width} * Height * 4);
+
+    Uint32 Seed = 12345;
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            Seed = Seed * 1664525u + 1013904223u;
+
+            const auto Noise  = static_cast<int>((Seed >> 24u) % 9u) - 4;
+            const auto IsEdge = ((x / 13) + (y / 11)) % 2 == 0;
+
+            auto* pTexel = &Data[(size_t{y} * Width + x) * 4];
+            pTexel[0]    = static_cast<Uint8>(clamp(static_cast<int>(x * 255 / Width) + Noise, 0, 255));
+            pTexel[1]    = static_cast<Uint8>(clamp(static_cast<int>(y * 255 / Height) + (IsEdge ? 60 : 0) + Noise, 0, 255));
+            pTexel[2]    = static_cast<Uint8>(clamp(static_cast<int>(128 + 100 * std::sin(static_cast<float>(x + y) * 0.05f)), 0, 255));
+            pTexel[3]    = static_cast<Uint8>(clamp(static_cast<int>((x + 2 * y) * 255 / (Width + 2 * Height)) + Noise, 0, 255));
+        }
+    }
+    return Data;
+}
+
+// Computes PSNR of the first NumComponents components of RGBA8 texels
+double ComputePSNR(const std::vector<Uint8>& Ref, const std::vector<Uint8>& Data, Uint32 NumComponents, bool IsSigned = false)
+{
+    double SqError    = 0;
+    size_t NumSamples = 0;
+    for (size_t i = 0; i < Ref.size(); i += 4)
+    {
+        for (Uint32 c = 0; c < NumComponents; ++c)
+        {
+            const auto RefVal = IsSigned ? std::max(static_cast<int>(static_cast<Int8>(Ref[i + c])), -127) : static_cast<int>(Ref[i + c]);
+            const auto Val    = IsSigned ? static_cast<int>(static_cast<Int8>(Data[i + c])) : static_cast<int>(Data[i + c]);
+            SqError += static_cast<double>((RefVal - Val) * (RefVal - Val));
+            ++NumSamples;
+        }
+    }
+    const auto MSE = SqError / static_cast<double>(NumSamples);
+    return MSE > 0 ? 10.0 * std::log10(255.0 * 255.0 / MSE) : 100.0;
+}
+
+// Extracts the first NumComponents components of RGBA8 texels
+std::vector<Uint8> ExtractComponents(const std::vector<Uint8>& RGBA, Uint32 NumComponents)
+{
+    std::vector<Uint8> Data(RGBA.size() / 4 * NumComponents);
+    for (size_t i = 0; i < RGBA.size() / 4; ++i)
+    {
+        for (Uint32 c = 0; c < NumComponents; ++c)
+            Data[i * NumComponents + c] = RGBA[i * 4 + c];
+    }
+    return Data;
+}
+
+void TestPSNR(TEXTURE_FORMAT SrcFormat, TEXTURE_FORMAT DstFormat, Uint32 NumComponents, const double MinPSNR[3], bool IsOpaque = false)
+{
+    constexpr Uint32 Width  = 123;
+    constexpr Uint32 Height = 67;
+
+    const auto IsSigned = IsSNormFormat(DstFormat);
+
+    auto RGBA = GenerateTestImage(Width, Height);
+    for (size_t i = 0; i < RGBA.size(); i += 4)
+    {
+        if (IsSigned)
+        {
+            // Map [0, 255] to [-128, 127]
+            for (Uint32 c = 0; c < 4; ++c)
+                RGBA[i + c] ^= 0x80u;
+        }
+        if (IsOpaque)
+            RGBA[i + 3] = 255;
+    }
+    const auto SrcData = ExtractComponents(RGBA, GetTextureFormatAttribs(SrcFormat).NumComponents);
+
+    double PSNR[3] = {};
+    for (Uint32 q = 0; q < 3; ++q)
+    {
+        const auto Quality = static_cast<BC_COMPRESSION_QUALITY>(q);
+
+        const auto CompressedData = Compress(SrcFormat, DstFormat, Width, Height, SrcData, Quality);
+        const auto DecodedData    = DecodeTexture(DstFormat, Width, Height, CompressedData);
+
+        PSNR[q] = ComputePSNR(RGBA, DecodedData, NumComponents, IsSigned);
+        EXPECT_GE(PSNR[q], MinPSNR[q]) << GetTextureFormatAttribs(DstFormat).Name << ", quality " << q;
+    }
+    EXPECT_GE(PSNR[BC_COMPRESSION_QUALITY_HIGH], PSNR[BC_COMPRESSION_QUALITY_FAST]) << GetTextureFormatAttribs(DstFormat).Name;
+
+    // Multithreaded compression must produce the same result
+    EXPECT_EQ(Compress(SrcFormat, DstFormat, Width, Height, SrcData, BC_COMPRESSION_QUALITY_NORMAL, 1),
+              Compress(SrcFormat, DstFormat, Width, Height, SrcData, BC_COMPRESSION_QUALITY_NORMAL, 4));
+}
+
+TEST(GraphicsAccessories_BCEncoder, BC1)
+{
+    const double MinPSNR[] = {35, 35.5, 35.5};
+    TestPSNR(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BC1_UNORM, 3, MinPSNR, true);
+}
+
+TEST(GraphicsAccessories_BCEncoder, BC1Transparency)
+{
+    constexpr Uint32 Width  = 16;
+    constexpr Uint32 Height = 16;
+
+    auto SrcData = GenerateTestImage(Width, Height);
+    for (Uint32 i = 0; i < Width * Height; ++i)
+        SrcData[i * 4 + 3] = (i % 3 == 0 || i >= 128) ? 0 : 255;
+
+    for (Uint32 q = 0; q < 3; ++q)
+    {
+        const auto CompressedData = Compress(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BC1_UNORM, Width, Height, SrcData, static_cast<BC_COMPRESSION_QUALITY>(q));
+        const auto DecodedData    = DecodeTexture(TEX_FORMAT_BC1_UNORM, Width, Height, CompressedData);
+        for (Uint32 i = 0; i < Width * Height; ++i)
+            EXPECT_EQ(DecodedData[i * 4 + 3], SrcData[i * 4 + 3]) << "Texel " << i;
+    }
+}
+
+TEST(GraphicsAccessories_BCEncoder, BC3)
+{
+    const double MinPSNR[] = {36.5, 37, 37};
+    TestPSNR(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BC3_UNORM, 4, MinPSNR);
+}
+
+TEST(GraphicsAccessories_BCEncoder, BC4)
+{
+    const double MinPSNR[] = {51, 52, 52};
+    TestPSNR(TEX_FORMAT_R8_UNORM, TEX_FORMAT_BC4_UNORM, 1, MinPSNR);
+    TestPSNR(TEX_FORMAT_R8_SNORM, TEX_FORMAT_BC4_SNORM, 1, MinPSNR);
+}
+
+TEST(GraphicsAccessories_BCEncoder, BC5)
+{
+    const double MinPSNR[] = {45, 45.5, 46};
+    TestPSNR(TEX_FORMAT_RG8_UNORM, TEX_FORMAT_BC5_UNORM, 2, MinPSNR);
+    TestPSNR(TEX_FORMAT_RG8_SNORM, TEX_FORMAT_BC5_SNORM, 2, MinPSNR);
+}
+
+TEST(GraphicsAccessories_BCEncoder, BC7)
+{
+    const double MinPSNR[] = {38.5, 38.5, 38.5};
+    TestPSNR(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BC7_UNORM, 4, MinPSNR);
+
+    // Opaque blocks use mode 1 when quality is not fast
+    const double MinOpaquePSNR[] = {39.5, 43, 43};
+    TestPSNR(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BC7_UNORM, 4, MinOpaquePSNR, true);
+}
+
+TEST(GraphicsAccessories_BCEncoder, SolidColor)
+{
+    constexpr Uint32 Width  = 8;
+    constexpr Uint32 Height = 8;
+
+    for (Uint32 Value = 0; Value < 256; Value += 17)
+    {
+        std::vector<Uint8> SrcData(Width * Height * 4);
+        for (Uint32 i = 0; i < Width * Height; ++i)
+        {
+            SrcData[i * 4 + 0] = static_cast<Uint8>(Value);
+            SrcData[i * 4 + 1] = static_cast<Uint8>(255 - Value);
+            SrcData[i * 4 + 2] = static_cast<Uint8>(Value / 2);
+            SrcData[i * 4 + 3] = static_cast<Uint8>(Value ^ 0x5A);
+        }
+
+        // BC4 and BC5 represent any solid value exactly
+        {
+            const auto CompressedData = Compress(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BC5_UNORM, Width, Height, SrcData, BC_COMPRESSION_QUALITY_FAST);
+            const auto DecodedData    = DecodeTexture(TEX_FORMAT_BC5_UNORM, Width, Height, CompressedData);
+            for (size_t i = 0; i < SrcData.size(); i += 4)
+            {
+                EXPECT_EQ(DecodedData[i + 0], SrcData[i + 0]);
+                EXPECT_EQ(DecodedData[i + 1], SrcData[i + 1]);
+            }
+        }
+
+        // Components of BC7 mode 6 endpoints share the p-bit, so only the values of the same
+        // parity are exact
+        for (Uint32 q = 0; q < 3; ++q)
+        {
+            const auto CompressedData = Compress(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BC7_UNORM, Width, Height, SrcData, static_cast<BC_COMPRESSION_QUALITY>(q));
+            const auto DecodedData    = DecodeTexture(TEX_FORMAT_BC7_UNORM, Width, Height, CompressedData);
+            for (size_t i = 0; i < SrcData.size(); ++i)
+                EXPECT_NEAR(DecodedData[i], SrcData[i], 1) << "Value " << Value;
+        }
+    }
+}
+
+TEST(GraphicsAccessories_BCEncoder, BGRA)
+{
+    constexpr Uint32 Width  = 32;
+    constexpr Uint32 Height = 32;
+
+    const auto RGBA = GenerateTestImage(Width, Height);
+
+    auto BGRA = RGBA;
+    for (size_t i = 0; i < BGRA.size(); i += 4)
+        std::swap(BGRA[i], BGRA[i + 2]);
+
+    EXPECT_EQ(Compress(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BC7_UNORM, Width, Height, RGBA, BC_COMPRESSION_QUALITY_NORMAL),
+              Compress(TEX_FORMAT_BGRA8_UNORM, TEX_FORMAT_BC7_UNORM, Width, Height, BGRA, BC_COMPRESSION_QUALITY_NORMAL));
+}
+
+TEST(GraphicsAccessories_BCEncoder, InvalidFormats)
+{
+    std::vector<Uint8> SrcData(16 * 4), DstData(16);
+
+    BCCompressAttribs Attribs;
+    Attribs.Width     = 4;
+    Attribs.Height    = 4;
+    Attribs.pSrcData  = SrcData.data();
+    Attribs.SrcStride = 16;
+    Attribs.pDstData  = DstData.data();
+    Attribs.DstStride = 16;
+
+    Attribs.SrcFormat = TEX_FORMAT_RGBA8_UNORM;
+    Attribs.DstFormat = TEX_FORMAT_BC2_UNORM;
+    EXPECT_FALSE(CompressTextureBC(Attribs));
+
+    Attribs.SrcFormat = TEX_FORMAT_RGBA16_FLOAT;
+    Attribs.DstFormat = TEX_FORMAT_BC7_UNORM;
+    EXPECT_FALSE(CompressTextureBC(Attribs));
+
+    Attribs.SrcFormat = TEX_FORMAT_RG8_SNORM;
+    Attribs.DstFormat = TEX_FORMAT_BC5_UNORM;
+    EXPECT_FALSE(CompressTextureBC(Attribs));
+}
+
+// Performance benchmark. Run with --gtest_also_run_disabled_tests
+TEST(GraphicsAccessories_BCEncoder, DISABLED_Benchmark)
+{
+    constexpr Uint32 Width  = 1024;
+    constexpr Uint32 Height = 1024;
+
+    const auto SrcData    = GenerateTestImage(Width, Height);
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    const auto SizeMB     = static_cast<double>(SrcData.size()) / (1024.0 * 1024.0);
+
+    for (auto Format : {TEX_FORMAT_BC1_UNORM, TEX_FORMAT_BC3_UNORM, TEX_FORMAT_BC5_UNORM, TEX_FORMAT_BC7_UNORM})
+    {
+        for (Uint32 q = 0; q < 3; ++q)
+        {
+            Timer      T;
+            const auto StartTime = T.GetElapsedTime();
+            Compress(TEX_FORMAT_RGBA8_UNORM, Format, Width, Height, SrcData, static_cast<BC_COMPRESSION_QUALITY>(q), NumThreads);
+            const auto Time = T.GetElapsedTime() - StartTime;
+
+            LOG_INFO_MESSAGE("Compressing ", Width, "x", Height, " texture to ", GetTextureFormatAttribs(Format).Name, ", quality ", q, ": ",
+                             Time * 1000.0, " ms, ", SizeMB / Time, " MB/s (", NumThreads, " threads)");
+        }
+    }
+}
+
+} // namespace
@@ -0,0 +1,346 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include "MipGenerator.hpp"
+#include "GraphicsAccessories.hpp"
+#include "ColorConversion.h"
+#include "Timer.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+template <typename T>
+std::vector<T> ComputeMip(TEXTURE_FORMAT Format, Uint32 Width, Uint32 Height, Uint32 NumComponents, const std::vector<T>& FineData, Uint32 Depth = 1)
+{
+    const auto CoarseWidth  = std::max(Width / 2, 1u);
+    const auto CoarseHeight = std::max(Height / 2, 1u);
+    const auto CoarseDepth  = std::max(Depth / 2, 1u);
+
+    std::vector<T> CoarseData(CoarseWidth * CoarseHeight * CoarseDepth * NumComponents);
+
+    ComputeMipLevelAttribs Attribs;
+    Attribs.Format               = Format;
+    Attribs.FineMipWidth         = Width;
+    Attribs.FineMipHeight        = Height;
+    Attribs.FineMipDepth         = Depth;
+    Attribs.pFineMipData         = FineData.data();
+    Attribs.FineMipStride        = Width * NumComponents * sizeof(T);
+    Attribs.FineMipDepthStride   = Attribs.FineMipStride * Height;
+    Attribs.pCoarseMipData       = CoarseData.data();
+    Attribs.CoarseMipStride      = CoarseWidth * NumComponents * sizeof(T);
+    Attribs.CoarseMipDepthStride = Attribs.CoarseMipStride * CoarseHeight;
+    EXPECT_TRUE(ComputeMipLevel(Attribs));
+
+    return CoarseData;
+}
+
+TEST(GraphicsAccessories_MipGenerator, UNorm8)
+{
+    // clang-format off
+    const std::vector<Uint8> FineData =
+    {
+        0,   4,  10,  20,  255, 255,
+        8,  12,  30,  40,  255,   0,
+        1,   1,   2,   2,    7,   9,
+        1,   2,   2,   3,    7,   9
+    };
+    // clang-format on
+    const auto CoarseData = ComputeMip(TEX_FORMAT_R8_UNORM, 6, 4, 1, FineData);
+    EXPECT_EQ(CoarseData, (std::vector<Uint8>{6, 25, 191, 1, 2, 8}));
+}
+
+TEST(GraphicsAccessories_MipGenerator, SRGB8)
+{
+    // Three white texels and one black texel: linear average is 0.75
+    const std::vector<Uint8> FineData = {
+        255, 255, 255, 255, /**/ 255, 255, 255, 255, //
+        255, 255, 255, 255, /**/ 0, 0, 0, 0          //
+    };
+
+    // Color components are averaged in linear space, alpha is averaged as is
+    const auto ExpectedColor = static_cast<Uint8>(LinearToSRGB(0.75f) * 255.f + 0.5f);
+    EXPECT_EQ(ExpectedColor, 225);
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_RGBA8_UNORM_SRGB, 2, 2, 4, FineData), (std::vector<Uint8>{225, 225, 225, 191}));
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_BGRA8_UNORM_SRGB, 2, 2, 4, FineData), (std::vector<Uint8>{225, 225, 225, 191}));
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_RGBA8_UNORM, 2, 2, 4, FineData), (std::vector<Uint8>{191, 191, 191, 191}));
+
+    // Uniform sRGB color must be preserved
+    for (Uint32 i = 0; i < 256; ++i)
+    {
+        const std::vector<Uint8> UniformData(4 * 4 * 4, static_cast<Uint8>(i));
+        const auto               CoarseData = ComputeMip(TEX_FORMAT_RGBA8_UNORM_SRGB, 4, 4, 4, UniformData);
+        EXPECT_EQ(CoarseData, std::vector<Uint8>(2 * 2 * 4, static_cast<Uint8>(i)));
+    }
+}
+
+TEST(GraphicsAccessories_MipGenerator, Norm16)
+{
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R16_UNORM, 2, 2, 1, std::vector<Uint16>{0, 65535, 65535, 65535}), (std::vector<Uint16>{49151}));
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_D16_UNORM, 2, 2, 1, std::vector<Uint16>{100, 200, 300, 400}), (std::vector<Uint16>{250}));
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R16_SNORM, 2, 2, 1, std::vector<Int16>{-32767, -32767, 32767, -32767}), (std::vector<Int16>{-16384}));
+    // -128 and -127 both map to -1
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R8_SNORM, 2, 2, 1, std::vector<Int8>{-128, -127, 127, 127}), (std::vector<Int8>{0}));
+}
+
+TEST(GraphicsAccessories_MipGenerator, Float)
+{
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_RG32_FLOAT, 2, 2, 2, std::vector<float>{1, -1, 2, -2, 3, -3, 4, -4}), (std::vector<float>{2.5f, -2.5f}));
+
+    // 1.0, 2.0, 3.0, 4.0 -> 2.5
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R16_FLOAT, 2, 2, 1, std::vector<Uint16>{0x3C00, 0x4000, 0x4200, 0x4400}), (std::vector<Uint16>{0x4100}));
+    // -0.5, -0.5, -0.5, -0.5 -> -0.5
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R16_FLOAT, 2, 2, 1, std::vector<Uint16>{0xB800, 0xB800, 0xB800, 0xB800}), (std::vector<Uint16>{0xB800}));
+    // 65504 (max half), 65504, 65504, 65504 -> 65504
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R16_FLOAT, 2, 2, 1, std::vector<Uint16>{0x7BFF, 0x7BFF, 0x7BFF, 0x7BFF}), (std::vector<Uint16>{0x7BFF}));
+    // Smallest denormal, 0, 0, smallest denormal -> rounds to even (0)
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R16_FLOAT, 2, 2, 1, std::vector<Uint16>{0x0001, 0x0000, 0x0000, 0x0001}), (std::vector<Uint16>{0x0000}));
+    // Denormals are preserved
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R16_FLOAT, 2, 2, 1, std::vector<Uint16>{0x0203, 0x0203, 0x0203, 0x0203}), (std::vector<Uint16>{0x0203}));
+    // +Inf
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R16_FLOAT, 2, 2, 1, std::vector<Uint16>{0x7C00, 0x3C00, 0x3C00, 0x3C00}), (std::vector<Uint16>{0x7C00}));
+}
+
+TEST(GraphicsAccessories_MipGenerator, Integer)
+{
+    // Integer averages are rounded to the nearest integer
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R8_UINT, 2, 2, 1, std::vector<Uint8>{255, 255, 255, 254}), (std::vector<Uint8>{255}));
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R8_UINT, 2, 2, 1, std::vector<Uint8>{0, 0, 1, 1}), (std::vector<Uint8>{1}));
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R8_SINT, 2, 2, 1, std::vector<Int8>{-128, -128, -128, -127}), (std::vector<Int8>{-128}));
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R8_SINT, 2, 2, 1, std::vector<Int8>{-1, -1, -2, -2}), (std::vector<Int8>{-1}));
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R8_SINT, 2, 2, 1, std::vector<Int8>{-1, -2, -2, -2}), (std::vector<Int8>{-2}));
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R32_UINT, 2, 2, 1, std::vector<Uint32>{0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFEu}), (std::vector<Uint32>{0xFFFFFFFFu}));
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_RG32_SINT, 2, 2, 2, std::vector<Int32>{INT32_MIN, 1, INT32_MIN, 2, INT32_MIN, 3, INT32_MIN, 4}), (std::vector<Int32>{INT32_MIN, 3}));
+}
+
+TEST(GraphicsAccessories_MipGenerator, PackedFormats)
+{
+    {
+        // R=1023, G=0, B=512, A=3 and R=1, G=1023, B=512, A=1
+        const Uint32 t0       = 1023u | (0u << 10u) | (512u << 20u) | (3u << 30u);
+        const Uint32 t1       = 1u | (1023u << 10u) | (512u << 20u) | (1u << 30u);
+        const Uint32 Expected = 512u | (512u << 10u) | (512u << 20u) | (2u << 30u);
+        EXPECT_EQ(ComputeMip(TEX_FORMAT_RGB10A2_UNORM, 2, 2, 1, std::vector<Uint32>{t0, t1, t1, t0}), (std::vector<Uint32>{Expected}));
+        EXPECT_EQ(ComputeMip(TEX_FORMAT_RGB10A2_UINT, 2, 2, 1, std::vector<Uint32>{t0, t1, t1, t0}), (std::vector<Uint32>{Expected}));
+    }
+
+    {
+        // R=1.0, G=2.0, B=0.5 (11-bit: exp 15 -> 0x3C0, exp 16 -> 0x400; 10-bit: exp 14 -> 0x1C0)
+        const Uint32 t = 0x3C0u | (0x400u << 11u) | (0x1C0u << 22u);
+        EXPECT_EQ(ComputeMip(TEX_FORMAT_R11G11B10_FLOAT, 2, 2, 1, std::vector<Uint32>{t, t, t, t}), (std::vector<Uint32>{t}));
+
+        // R=0, G=0, B=0 and the t: average is R=0.5, G=1.0, B=0.25
+        const Uint32 Expected = 0x380u | (0x3C0u << 11u) | (0x1A0u << 22u);
+        EXPECT_EQ(ComputeMip(TEX_FORMAT_R11G11B10_FLOAT, 2, 2, 1, std::vector<Uint32>{t, 0, t, 0}), (std::vector<Uint32>{Expected}));
+    }
+
+    {
+        // R=1.0, G=0.5, B=0.25: shared exponent 16, R = 256, G = 128, B = 64
+        const Uint32 t = 256u | (128u << 9u) | (64u << 18u) | (16u << 27u);
+        EXPECT_EQ(ComputeMip(TEX_FORMAT_RGB9E5_SHAREDEXP, 2, 2, 1, std::vector<Uint32>{t, t, t, t}), (std::vector<Uint32>{t}));
+        const Uint32 Expected = 256u | (128u << 9u) | (64u << 18u) | (15u << 27u);
+        EXPECT_EQ(ComputeMip(TEX_FORMAT_RGB9E5_SHAREDEXP, 2, 2, 1, std::vector<Uint32>{t, 0, 0, t}), (std::vector<Uint32>{Expected}));
+    }
+
+    {
+        const Uint16 t0       = static_cast<Uint16>((31u << 11u) | (63u << 5u) | 0u);
+        const Uint16 t1       = static_cast<Uint16>((1u << 11u) | (1u << 5u) | 30u);
+        const Uint16 Expected = static_cast<Uint16>((16u << 11u) | (32u << 5u) | 15u);
+        EXPECT_EQ(ComputeMip(TEX_FORMAT_B5G6R5_UNORM, 2, 2, 1, std::vector<Uint16>{t0, t1, t0, t1}), (std::vector<Uint16>{Expected}));
+    }
+
+    {
+        const Uint16 t0       = static_cast<Uint16>((31u << 10u) | (31u << 5u) | 0u | (1u << 15u));
+        const Uint16 t1       = static_cast<Uint16>((1u << 10u) | (1u << 5u) | 30u | (1u << 15u));
+        const Uint16 Expected = static_cast<Uint16>((16u << 10u) | (16u << 5u) | 15u | (1u << 15u));
+        EXPECT_EQ(ComputeMip(TEX_FORMAT_B5G5R5A1_UNORM, 2, 2, 1, std::vector<Uint16>{t0, t1, t0, t1}), (std::vector<Uint16>{Expected}));
+    }
+
+    {
+        const Uint32 t = 384u | (894u << 10u) | (1023u << 20u) | (3u << 30u);
+        EXPECT_EQ(ComputeMip(TEX_FORMAT_R10G10B10_XR_BIAS_A2_UNORM, 2, 2, 1, std::vector<Uint32>{t, t, t, t}), (std::vector<Uint32>{t}));
+    }
+}
+
+TEST(GraphicsAccessories_MipGenerator, Dimensions)
+{
+    // Odd width: the last column is not used
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R8_UINT, 3, 2, 1, std::vector<Uint8>{10, 20, 100, 30, 40, 100}), (std::vector<Uint8>{25}));
+
+    // 1D
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R8_UINT, 4, 1, 1, std::vector<Uint8>{10, 20, 30, 40}), (std::vector<Uint8>{15, 35}));
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R32_FLOAT, 4, 1, 1, std::vector<float>{10, 20, 30, 40}), (std::vector<float>{15, 35}));
+
+    // Width is 1
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R8_UINT, 1, 4, 1, std::vector<Uint8>{10, 20, 30, 40}), (std::vector<Uint8>{15, 35}));
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R32_FLOAT, 1, 4, 1, std::vector<float>{10, 20, 30, 40}), (std::vector<float>{15, 35}));
+
+    // 3D
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R8_UINT, 2, 2, 1, std::vector<Uint8>{1, 2, 3, 4, 5, 6, 7, 8}, 2), (std::vector<Uint8>{5}));
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R32_FLOAT, 2, 2, 1, std::vector<float>{1, 2, 3, 4, 5, 6, 7, 8}, 2), (std::vector<float>{4.5f}));
+    EXPECT_EQ(ComputeMip(TEX_FORMAT_R32_FLOAT, 2, 1, 1, std::vector<float>{1, 2, 3, 4, 5, 6, 7, 8}, 4), (std::vector<float>{2.5f, 6.5f}));
+}
+
+TEST(GraphicsAccessories_MipGenerator, UnsupportedFormats)
+{
+    EXPECT_FALSE(IsCPUMipGenerationSupported(TEX_FORMAT_RGBA8_TYPELESS));
+    EXPECT_FALSE(IsCPUMipGenerationSupported(TEX_FORMAT_D24_UNORM_S8_UINT));
+    EXPECT_FALSE(IsCPUMipGenerationSupported(TEX_FORMAT_BC1_UNORM));
+    EXPECT_FALSE(IsCPUMipGenerationSupported(TEX_FORMAT_R1_UNORM));
+    EXPECT_TRUE(IsCPUMipGenerationSupported(TEX_FORMAT_RGBA8_UNORM_SRGB));
+    EXPECT_TRUE(IsCPUMipGenerationSupported(TEX_FORMAT_D32_FLOAT));
+    EXPECT_TRUE(IsCPUMipGenerationSupported(TEX_FORMAT_RGBA32_UINT));
+}
+
+void GenerateTestMipChain(const TextureDesc& TexDesc, std::vector<std::vector<Uint8>>& TopMips, std::vector<TextureSubResData>& TopMipData)
+{
+    const auto MipProps  = GetMipLevelProperties(TexDesc, 0);
+    const auto NumSlices = TexDesc.Type == RESOURCE_DIM_TEX_3D ? 1 : TexDesc.ArraySize;
+
+    TopMips.resize(NumSlices);
+    TopMipData.resize(NumSlices);
+    for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+    {
+        TopMips[Slice].resize(MipProps.MipSize);
+        for (size_t i = 0; i < TopMips[Slice].size(); ++i)
+            TopMips[Slice][i] = static_cast<Uint8>((i * 31 + i / MipProps.RowSize * 17 + Slice * 101) & 0xFF);
+        TopMipData[Slice] = TextureSubResData{TopMips[Slice].data(), MipProps.RowSize, MipProps.DepthSliceSize};
+    }
+}
+
+TEST(GraphicsAccessories_MipGenerator, GenerateMipChain)
+{
+    TextureDesc TexDesc;
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D_ARRAY;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM_SRGB;
+    TexDesc.Width     = 300;
+    TexDesc.Height    = 200;
+    TexDesc.ArraySize = 3;
+    TexDesc.MipLevels = 0;
+
+    std::vector<std::vector<Uint8>> TopMips;
+    std::vector<TextureSubResData>  TopMipData;
+    GenerateTestMipChain(TexDesc, TopMips, TopMipData);
+
+    std::vector<Uint8>             MipData;
+    std::vector<TextureSubResData> SubResources;
+    ASSERT_TRUE(GenerateMipChain(TexDesc, TopMipData.data(), MipData, SubResources));
+
+    const auto MipLevels = ComputeMipLevelsCount(TexDesc.Width, TexDesc.Height);
+    ASSERT_EQ(SubResources.size(), size_t{TexDesc.ArraySize} * MipLevels);
+    for (Uint32 Slice = 0; Slice < TexDesc.ArraySize; ++Slice)
+    {
+        EXPECT_EQ(SubResources[Slice * MipLevels].pData, TopMips[Slice].data());
+        for (Uint32 Mip = 1; Mip < MipLevels; ++Mip)
+        {
+            const auto& FineSubRes   = SubResources[Slice * MipLevels + Mip - 1];
+            const auto& CoarseSubRes = SubResources[Slice * MipLevels + Mip];
+            const auto  FineProps    = GetMipLevelProperties(TexDesc, Mip - 1);
+            const auto  CoarseProps  = GetMipLevelProperties(TexDesc, Mip);
+            ASSERT_EQ(CoarseSubRes.Stride, CoarseProps.RowSize);
+
+            // Every mip level is computed from the previous one
+            std::vector<Uint8> FineMip{static_cast<const Uint8*>(FineSubRes.pData), static_cast<const Uint8*>(FineSubRes.pData) + FineProps.MipSize};
+            std::vector<Uint8> CoarseMip{static_cast<const Uint8*>(CoarseSubRes.pData), static_cast<const Uint8*>(CoarseSubRes.pData) + CoarseProps.MipSize};
+            EXPECT_EQ(CoarseMip, ComputeMip(TexDesc.Format, FineProps.LogicalWidth, FineProps.LogicalHeight, 4, FineMip)) << "Slice " << Slice << " mip " << Mip;
+        }
+    }
+
+    // Multithreaded generation must produce the same result
+    std::vector<Uint8>             MipDataMT;
+    std::vector<TextureSubResData> SubResourcesMT;
+    ASSERT_TRUE(GenerateMipChain(TexDesc, TopMipData.data(), MipDataMT, SubResourcesMT, 4));
+    EXPECT_EQ(MipData, MipDataMT);
+}
+
+TEST(GraphicsAccessories_MipGenerator, GenerateMipChain3D)
+{
+    TextureDesc TexDesc;
+    TexDesc.Type      = RESOURCE_DIM_TEX_3D;
+    TexDesc.Format    = TEX_FORMAT_RG16_FLOAT;
+    TexDesc.Width     = 16;
+    TexDesc.Height    = 8;
+    TexDesc.Depth     = 32;
+    TexDesc.MipLevels = 4;
+
+    std::vector<std::vector<Uint8>> TopMips;
+    std::vector<TextureSubResData>  TopMipData;
+    GenerateTestMipChain(TexDesc, TopMips, TopMipData);
+
+    std::vector<Uint8>             MipData;
+    std::vector<TextureSubResData> SubResources;
+    ASSERT_TRUE(GenerateMipChain(TexDesc, TopMipData.data(), MipData, SubResources));
+    ASSERT_EQ(SubResources.size(), size_t{4});
+    for (Uint32 Mip = 1; Mip < TexDesc.MipLevels; ++Mip)
+    {
+        const auto MipProps = GetMipLevelProperties(TexDesc, Mip);
+        EXPECT_EQ(SubResources[Mip].Stride, MipProps.RowSize);
+        EXPECT_EQ(SubResources[Mip].DepthStride, MipProps.DepthSliceSize);
+    }
+}
+
+// Performance benchmark. Run with --gtest_also_run_disabled_tests
+TEST(GraphicsAccessories_MipGenerator, DISABLED_Benchmark)
+{
+    TextureDesc TexDesc;
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM_SRGB;
+    TexDesc.Width     = 2048;
+    TexDesc.Height    = 2048;
+    TexDesc.MipLevels = 0;
+
+    std::vector<std::vector<Uint8>> TopMips;
+    std::vector<TextureSubResData>  TopMipData;
+    GenerateTestMipChain(TexDesc, TopMips, TopMipData);
+
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::vector<Uint8>             MipData;
+    std::vector<TextureSubResData> SubResources;
+
+    Timer T;
+    auto  StartTime = T.GetElapsedTime();
+    GenerateMipChain(TexDesc, TopMipData.data(), MipData, SubResources, 1);
+    const auto SingleThreadTime = T.GetElapsedTime() - StartTime;
+
+    StartTime = T.GetElapsedTime();
+    GenerateMipChain(TexDesc, TopMipData.data(), MipData, SubResources, NumThreads);
+    const auto MultiThreadTime = T.GetElapsedTime() - StartTime;
+
+    LOG_INFO_MESSAGE("Generating mip chain of ", TexDesc.Width, "x", TexDesc.Height, " ", GetTextureFormatAttribs(TexDesc.Format).Name,
+                     " texture: ", SingleThreadTime * 1000.0, " ms (1 thread), ", MultiThreadTime * 1000.0, " ms (", NumThreads, " threads)");
+}
+
+} // namespace
@@ -0,0 +1,384 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "PixelFormatConversion.hpp"
+#include "GraphicsAccessories.hpp"
+#include "ColorConversion.h"
+#include "Timer.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Reference decoder of floats with 5-bit exponent
+float SmallFloatToFloatRef(Uint32 Value, Uint32 MantissaBits, bool HasSign)
+{
+    const auto Sign     = HasSign && ((Value >> (MantissaBits + 5)) & 1u) != 0 ? -1.f : 1.f;
+    const auto Exp      = static_cast<int>((Value >> MantissaBits) & 0x1Fu);
+    const auto Mantissa = static_cast<float>(Value & ((1u << MantissaBits) - 1u));
+    const auto Scale    = static_cast<float>(1u << MantissaBits);
+    if (Exp == 0)
+        return Sign * std::ldexp(Mantissa / Scale, -14);
+    if (Exp == 31)
+        return Mantissa == 0 ? Sign * std::numeric_limits<float>::infinity() : std::numeric_limits<float>::quiet_NaN();
+    return Sign * std::ldexp(1.f + Mantissa / Scale, Exp - 15);
+}
+
+template <typename DstType, typename SrcType>
+std::vector<DstType> Convert(TEXTURE_FORMAT SrcFormat, TEXTURE_FORMAT DstFormat, const std::vector<SrcType>& SrcData, Uint32 NumPixels)
+{
+    const auto SrcSize = GetTextureFormatAttribs(SrcFormat).GetElementSize();
+    const auto DstSize = GetTextureFormatAttribs(DstFormat).GetElementSize();
+    EXPECT_EQ(SrcData.size() * sizeof(SrcType), size_t{NumPixels} * SrcSize);
+
+    std::vector<DstType> DstData(size_t{NumPixels} * DstSize / sizeof(DstType));
+    EXPECT_TRUE(ConvertPixels(SrcFormat, DstFormat, NumPixels, 1, SrcData.data(), NumPixels * SrcSize, DstData.data(), NumPixels * DstSize));
+    return DstData;
+}
+
+TEST(GraphicsAccessories_PixelFormatConversion, HalfFloat)
+{
+    std::vector<Uint16> HalfValues(65536);
+    for (Uint32 i = 0; i < HalfValues.size(); ++i)
+        HalfValues[i] = static_cast<Uint16>(i);
+
+    // Every half float value is decoded exactly
+    const auto FloatValues = Convert<float>(TEX_FORMAT_R16_FLOAT, TEX_FORMAT_R32_FLOAT, HalfValues, 65536);
+    for (Uint32 i = 0; i < HalfValues.size(); ++i)
+    {
+        const auto Ref = SmallFloatToFloatRef(i, 10, true);
+        if (std::isnan(Ref))
+        {
+            EXPECT_TRUE(std::isnan(FloatValues[i])) << i;
+            continue;
+        }
+        EXPECT_EQ(std::memcmp(&FloatValues[i], &Ref, sizeof(float)), 0) << i << ": " << FloatValues[i] << " vs " << Ref;
+    }
+
+    // Every half float value is encoded back to itself
+    const auto EncodedValues = Convert<Uint16>(TEX_FORMAT_R32_FLOAT, TEX_FORMAT_R16_FLOAT, FloatValues, 65536);
+    for (Uint32 i = 0; i < HalfValues.size(); ++i)
+    {
+        if (std::isnan(FloatValues[i]))
+            EXPECT_TRUE((EncodedValues[i] & 0x7C00u) == 0x7C00u && (EncodedValues[i] & 0x3FFu) != 0) << i;
+        else
+            EXPECT_EQ(EncodedValues[i], HalfValues[i]) << i;
+    }
+}
+
+TEST(GraphicsAccessories_PixelFormatConversion, HalfFloatRounding)
+{
+    // clang-format off
+    const std::vector<float> FloatValues =
+    {
+        1.f,
+        1.f + std::ldexp(1.f, -11),     // Tie, rounds to even
+        1.f + 3.f * std::ldexp(1.f, -11), // Tie, rounds to even
+        1.f + std::ldexp(1.f, -11) + std::ldexp(1.f, -20),
+        65504.f,                        // Max half
+        65519.f,
+        65520.f,                        // Rounds to infinity
+        1e10f,
+        -2.f,
+        std::ldexp(1.f, -24),           // Min denormal
+        std::ldexp(1.f, -25),           // Tie, rounds to zero
+        3.f * std::ldexp(1.f, -25),     // Tie, rounds to even
+        std::ldexp(1.f, -14) - std::ldexp(1.f, -26), // Rounds to min normal
+        -0.f,
+        std::numeric_limits<float>::infinity(),
+        -std::numeric_limits<float>::infinity()
+    };
+    const std::vector<Uint16> RefValues =
+    {
+        0x3C00,
+        0x3C00,
+        0x3C02,
+        0x3C01,
+        0x7BFF,
+        0x7BFF,
+        0x7C00,
+        0x7C00,
+        0xC000,
+        0x0001,
+        0x0000,
+        0x0002,
+        0x0400,
+        0x8000,
+        0x7C00,
+        0xFC00
+    };
+    // clang-format on
+
+    const auto HalfValues = Convert<Uint16>(TEX_FORMAT_R32_FLOAT, TEX_FORMAT_R16_FLOAT, FloatValues, static_cast<Uint32>(FloatValues.size()));
+    for (size_t i = 0; i < FloatValues.size(); ++i)
+        EXPECT_EQ(HalfValues[i], RefValues[i]) << FloatValues[i];
+}
+
+TEST(GraphicsAccessories_PixelFormatConversion, R11G11B10)
+{
+    // Every 11-bit and 10-bit value is decoded exactly and encoded back to itself
+    std::vector<Uint32> PackedValues(2048);
+    for (Uint32 i = 0; i < PackedValues.size(); ++i)
+        PackedValues[i] = i | (((i + 1000) & 0x7FFu) << 11u) | ((i & 0x3FFu) << 22u);
+
+    const auto FloatValues = Convert<float4>(TEX_FORMAT_R11G11B10_FLOAT, TEX_FORMAT_RGBA32_FLOAT, PackedValues, 2048);
+    for (Uint32 i = 0; i < PackedValues.size(); ++i)
+    {
+        const float Ref[] = {
+            SmallFloatToFloatRef(i, 6, false),
+            SmallFloatToFloatRef((i + 1000) & 0x7FFu, 6, false),
+            SmallFloatToFloatRef(i & 0x3FFu, 5, false),
+            1 //
+        };
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            if (std::isnan(Ref[c]))
+                EXPECT_TRUE(std::isnan(FloatValues[i][c])) << i;
+            else
+                EXPECT_EQ(FloatValues[i][c], Ref[c]) << i << ", component " << c;
+        }
+    }
+
+    const auto EncodedValues = Convert<Uint32>(TEX_FORMAT_RGBA32_FLOAT, TEX_FORMAT_R11G11B10_FLOAT, FloatValues, 2048);
+    for (Uint32 i = 0; i < PackedValues.size(); ++i)
+    {
+        if (std::isnan(FloatValues[i].x) || std::isnan(FloatValues[i].y) || std::isnan(FloatValues[i].z))
+            continue;
+        EXPECT_EQ(EncodedValues[i], PackedValues[i]) << i;
+    }
+
+    // Negative values are clamped to zero
+    const std::vector<float4> NegativeValues = {float4{-1, -0.f, -1e10f, 1}};
+    EXPECT_EQ(Convert<Uint32>(TEX_FORMAT_RGBA32_FLOAT, TEX_FORMAT_R11G11B10_FLOAT, NegativeValues, 1)[0], 0u);
+}
+
+TEST(GraphicsAccessories_PixelFormatConversion, SRGB)
+{
+    // All 8-bit sRGB values are decoded to the reference linear values and encoded back to themselves
+    std::vector<Uint8> SRGBValues(256 * 4);
+    for (Uint32 i = 0; i < SRGBValues.size(); ++i)
+        SRGBValues[i] = static_cast<Uint8>(i / 4);
+
+    const auto LinearValues = Convert<float4>(TEX_FORMAT_RGBA8_UNORM_SRGB, TEX_FORMAT_RGBA32_FLOAT, SRGBValues, 256);
+    for (Uint32 i = 0; i < 256; ++i)
+    {
+        EXPECT_EQ(LinearValues[i].x, SRGBToLinear(static_cast<Uint8>(i)));
+        // Alpha is linear
+        EXPECT_EQ(LinearValues[i].w, static_cast<float>(i) / 255.f);
+    }
+    EXPECT_EQ(Convert<Uint8>(TEX_FORMAT_RGBA32_FLOAT, TEX_FORMAT_RGBA8_UNORM_SRGB, LinearValues, 256), SRGBValues);
+
+    // Linear values are encoded to the sRGB value whose interval between the midpoints contains them
+    std::vector<float> Thresholds(255);
+    for (Uint32 i = 0; i < Thresholds.size(); ++i)
+        Thresholds[i] = SRGBToLinear((static_cast<float>(i) + 0.5f) / 255.f);
+
+    std::mt19937                          Gen{123};
+    std::uniform_real_distribution<float> Distr{-0.1f, 1.1f};
+
+    std::vector<float4> RandomValues(65536);
+    for (auto& Value : RandomValues)
+    {
+        Value = float4{Distr(Gen), std::ldexp(Distr(Gen), -8), std::ldexp(Distr(Gen), -12), Distr(Gen)};
+    }
+    const auto EncodedValues = Convert<Uint8>(TEX_FORMAT_RGBA32_FLOAT, TEX_FORMAT_RGBA8_UNORM_SRGB, RandomValues, 65536);
+    for (size_t i = 0; i < RandomValues.size(); ++i)
+    {
+        for (Uint32 c = 0; c < 3; ++c)
+        {
+            const auto Ref = std::upper_bound(Thresholds.begin(), Thresholds.end(), RandomValues[i][c]) - Thresholds.begin();
+            EXPECT_EQ(EncodedValues[i * 4 + c], Ref) << RandomValues[i][c];
+        }
+    }
+}
+
+TEST(GraphicsAccessories_PixelFormatConversion, UNorm8)
+{
+    std::vector<Uint8> UNormValues(256 * 4);
+    for (Uint32 i = 0; i < UNormValues.size(); ++i)
+        UNormValues[i] = static_cast<Uint8>(i / 4 + i % 4);
+
+    const auto FloatValues = Convert<float4>(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_RGBA32_FLOAT, UNormValues, 256);
+    for (Uint32 i = 0; i < UNormValues.size(); ++i)
+        EXPECT_EQ(FloatValues[i / 4][i % 4], static_cast<float>(UNormValues[i]) / 255.f);
+    EXPECT_EQ(Convert<Uint8>(TEX_FORMAT_RGBA32_FLOAT, TEX_FORMAT_RGBA8_UNORM, FloatValues, 256), UNormValues);
+
+    // Values are clamped and rounded to nearest
+    const std::vector<float4> Values = {float4{-1.f, 2.f, 0.5f / 255.f + 1e-6f, 10.5f / 255.f - 1e-6f}};
+    const std::vector<Uint8>  Ref    = {0, 255, 1, 10};
+    EXPECT_EQ(Convert<Uint8>(TEX_FORMAT_RGBA32_FLOAT, TEX_FORMAT_RGBA8_UNORM, Values, 1), Ref);
+}
+
+TEST(GraphicsAccessories_PixelFormatConversion, MissingComponents)
+{
+    // Missing color components are set to 0 and missing alpha is set to 1
+    const std::vector<Uint8> RG8Values = {51, 102};
+    const auto               RGBA8     = Convert<Uint8>(TEX_FORMAT_RG8_UNORM, TEX_FORMAT_RGBA8_UNORM, RG8Values, 1);
+    EXPECT_EQ(RGBA8, (std::vector<Uint8>{51, 102, 0, 255}));
+
+    const auto R11G11B10 = Convert<Uint32>(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_R11G11B10_FLOAT, RGBA8, 1);
+    const auto RGBA16F   = Convert<Uint16>(TEX_FORMAT_R11G11B10_FLOAT, TEX_FORMAT_RGBA16_FLOAT, R11G11B10, 1);
+    EXPECT_EQ(RGBA16F[2], 0u);
+    EXPECT_EQ(RGBA16F[3], 0x3C00u);
+}
+
+TEST(GraphicsAccessories_PixelFormatConversion, BGRA)
+{
+    const std::vector<Uint8> RGBA8 = {1, 2, 3, 4, 5, 6, 7, 8};
+
+    const auto BGRA8 = Convert<Uint8>(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BGRA8_UNORM, RGBA8, 2);
+    EXPECT_EQ(BGRA8, (std::vector<Uint8>{3, 2, 1, 4, 7, 6, 5, 8}));
+    EXPECT_EQ(Convert<Uint8>(TEX_FORMAT_BGRA8_UNORM, TEX_FORMAT_RGBA8_UNORM, BGRA8, 2), RGBA8);
+
+    // Alpha of BGRX formats is ignored
+    const auto BGRX8 = Convert<Uint8>(TEX_FORMAT_RGBA8_UNORM_SRGB, TEX_FORMAT_BGRX8_UNORM_SRGB, RGBA8, 2);
+    EXPECT_EQ(BGRX8, (std::vector<Uint8>{3, 2, 1, 255, 7, 6, 5, 255}));
+    EXPECT_EQ(Convert<Uint8>(TEX_FORMAT_BGRX8_UNORM, TEX_FORMAT_RGBA8_UNORM, BGRA8, 2), (std::vector<Uint8>{1, 2, 3, 255, 5, 6, 7, 255}));
+
+    // Conversion through float
+    const auto BGRA16F = Convert<Uint16>(TEX_FORMAT_BGRA8_UNORM, TEX_FORMAT_RGBA16_FLOAT, BGRA8, 2);
+    EXPECT_EQ(Convert<Uint8>(TEX_FORMAT_RGBA16_FLOAT, TEX_FORMAT_RGBA8_UNORM, BGRA16F, 2), RGBA8);
+    EXPECT_EQ(Convert<Uint8>(TEX_FORMAT_RGBA16_FLOAT, TEX_FORMAT_BGRA8_UNORM, BGRA16F, 2), BGRA8);
+
+    // Color space conversion
+    const auto SRGB8 = Convert<Uint8>(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BGRA8_UNORM_SRGB, RGBA8, 2);
+    for (Uint32 i = 0; i < 2; ++i)
+    {
+        for (Uint32 c = 0; c < 3; ++c)
+        {
+            const auto SRGB = LinearToSRGB(static_cast<float>(RGBA8[i * 4 + c]) / 255.f);
+            EXPECT_EQ(SRGB8[i * 4 + 2 - c], static_cast<Uint8>(SRGB * 255.f + 0.5f));
+        }
+        EXPECT_EQ(SRGB8[i * 4 + 3], RGBA8[i * 4 + 3]);
+    }
+}
+
+TEST(GraphicsAccessories_PixelFormatConversion, Strides)
+{
+    constexpr Uint32 Width     = 5;
+    constexpr Uint32 Height    = 3;
+    constexpr Uint32 SrcStride = Width * 4 + 7;
+    constexpr Uint32 DstStride = Width * 8 + 5;
+
+    std::vector<Uint8> SrcData(SrcStride * Height);
+    for (size_t i = 0; i < SrcData.size(); ++i)
+        SrcData[i] = static_cast<Uint8>(i * 7);
+
+    // Padding bytes must not be touched
+    std::vector<Uint8> DstData(DstStride * Height, 0xCD);
+    EXPECT_TRUE(ConvertPixels(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_RGBA16_FLOAT, Width, Height, SrcData.data(), SrcStride, DstData.data(), DstStride));
+
+    std::vector<Uint8> RoundTripData(SrcStride * Height, 0xAB);
+    EXPECT_TRUE(ConvertPixels(TEX_FORMAT_RGBA16_FLOAT, TEX_FORMAT_RGBA8_UNORM, Width, Height, DstData.data(), DstStride, RoundTripData.data(), SrcStride));
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (Uint32 x = Width * 8; x < DstStride; ++x)
+            EXPECT_EQ(DstData[y * DstStride + x], 0xCD);
+        for (Uint32 x = 0; x < SrcStride; ++x)
+            EXPECT_EQ(RoundTripData[y * SrcStride + x], x < Width * 4 ? SrcData[y * SrcStride + x] : 0xAB);
+    }
+}
+
+TEST(GraphicsAccessories_PixelFormatConversion, UnsupportedFormats)
+{
+    std::vector<Uint8> SrcData(64), DstData(64);
+
+    // Identical formats are copied
+    EXPECT_TRUE(ConvertPixels(TEX_FORMAT_RGBA32_UINT, TEX_FORMAT_RGBA32_UINT, 4, 1, SrcData.data(), 64, DstData.data(), 64));
+
+    EXPECT_FALSE(IsPixelFormatConversionSupported(TEX_FORMAT_RGBA32_UINT));
+    EXPECT_FALSE(IsPixelFormatConversionSupported(TEX_FORMAT_BC1_UNORM));
+    EXPECT_FALSE(IsPixelFormatConversionSupported(TEX_FORMAT_D24_UNORM_S8_UINT));
+    EXPECT_TRUE(IsPixelFormatConversionSupported(TEX_FORMAT_RGB10A2_UINT));
+
+    EXPECT_FALSE(ConvertPixels(TEX_FORMAT_RGBA32_UINT, TEX_FORMAT_RGBA32_FLOAT, 4, 1, SrcData.data(), 64, DstData.data(), 64));
+    EXPECT_FALSE(ConvertPixels(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BC1_UNORM, 4, 1, SrcData.data(), 64, DstData.data(), 64));
+    EXPECT_FALSE(ConvertPixels(TEX_FORMAT_BC1_UNORM, TEX_FORMAT_BC1_UNORM, 4, 1, SrcData.data(), 64, DstData.data(), 64));
+}
+
+// Performance benchmark. Run with --gtest_also_run_disabled_tests
+TEST(GraphicsAccessories_PixelFormatConversion, DISABLED_Benchmark)
+{
+    constexpr Uint32 Width  = 2048;
+    constexpr Uint32 Height = 1024;
+
+    // clang-format off
+    const std::pair<TEXTURE_FORMAT, TEXTURE_FORMAT> Conversions[] =
+    {
+        {TEX_FORMAT_RGBA8_UNORM,      TEX_FORMAT_BGRA8_UNORM},
+        {TEX_FORMAT_RGBA8_UNORM,      TEX_FORMAT_RGBA32_FLOAT},
+        {TEX_FORMAT_RGBA32_FLOAT,     TEX_FORMAT_RGBA8_UNORM},
+        {TEX_FORMAT_RGBA8_UNORM_SRGB, TEX_FORMAT_RGBA32_FLOAT},
+        {TEX_FORMAT_RGBA32_FLOAT,     TEX_FORMAT_RGBA8_UNORM_SRGB},
+        {TEX_FORMAT_RGBA16_FLOAT,     TEX_FORMAT_RGBA32_FLOAT},
+        {TEX_FORMAT_RGBA32_FLOAT,     TEX_FORMAT_RGBA16_FLOAT},
+        {TEX_FORMAT_RGBA16_FLOAT,     TEX_FORMAT_BGRA8_UNORM_SRGB},
+        {TEX_FORMAT_R11G11B10_FLOAT,  TEX_FORMAT_RGBA16_FLOAT},
+        {TEX_FORMAT_RGBA32_FLOAT,     TEX_FORMAT_R11G11B10_FLOAT},
+    };
+    // clang-format on
+
+    // Source data is a valid float image of the largest format
+    std::vector<float4> ImageData(size_t{Width} * Height);
+    for (size_t i = 0; i < ImageData.size(); ++i)
+    {
+        const auto v = static_cast<float>(i % 4096) / 4096.f;
+        ImageData[i] = float4{v, 1.f - v, v * v, 1.f};
+    }
+
+    for (const auto& Conversion : Conversions)
+    {
+        const auto& SrcFmtAttribs = GetTextureFormatAttribs(Conversion.first);
+        const auto& DstFmtAttribs = GetTextureFormatAttribs(Conversion.second);
+        const auto  SrcStride     = size_t{Width} * SrcFmtAttribs.GetElementSize();
+        const auto  DstStride     = size_t{Width} * DstFmtAttribs.GetElementSize();
+
+        std::vector<Uint8> SrcData(SrcStride * Height);
+        EXPECT_TRUE(ConvertPixels(TEX_FORMAT_RGBA32_FLOAT, Conversion.first, Width, Height, ImageData.data(), Width * sizeof(float4), SrcData.data(), SrcStride));
+
+        std::vector<Uint8> DstData(DstStride * Height);
+
+        Timer      T;
+        const auto StartTime = T.GetElapsedTime();
+        EXPECT_TRUE(ConvertPixels(Conversion.first, Conversion.second, Width, Height, SrcData.data(), SrcStride, DstData.data(), DstStride));
+        const auto Time = T.GetElapsedTime() - StartTime;
+
+        LOG_INFO_MESSAGE("Converting ", Width, "x", Height, " pixels from ", SrcFmtAttribs.Name, " to ", DstFmtAttribs.Name, ": ",
+                         Time * 1000.0, " ms, ", static_cast<double>(Width * Height) / (Time * 1e6), " MPix/s");
+    }
+}
+
+} // namespace
@@ -0,0 +1,261 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <string>
+
+#include "GLSLDefinitionsFilter.hpp"
+#include "HLSL2GLSLConverterImpl.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+bool Contains(const String& Str, const char* SubStr)
+{
+    return Str.find(SubStr) != String::npos;
+}
+
+TEST(HLSL2GLSLConverterLib_GLSLDefinitionsFilter, TransitiveDependencies)
+{
+    // clang-format off
+    const GLSLDefinitionsFilter Filter{
+        "#define MACRO_A(x) FuncB(x)\n"
+        "float FuncB(float x)\n"
+        "{\n"
+        "    return FuncC(x) * 2.0;\n"
+        "}\n"
+        "float FuncC(float x)\n"
+        "{\n"
+        "    return x + float(MACRO_D);\n"
+        "}\n"
+        "#define MACRO_D 1\n"
+        "float Unused(float x)\n"
+        "{\n"
+        "    return FuncC(x);\n"
+        "}\n"
+    };
+    // clang-format on
+
+    const String Source{"void main() { float x = MACRO_A(1.0); }"};
+
+    const auto Defs = Filter.Filter({&Source});
+    EXPECT_TRUE(Contains(Defs, "#define MACRO_A"));
+    EXPECT_TRUE(Contains(Defs, "float FuncB"));
+    EXPECT_TRUE(Contains(Defs, "float FuncC"));
+    // Defined after the function that references it
+    EXPECT_TRUE(Contains(Defs, "#define MACRO_D"));
+    EXPECT_FALSE(Contains(Defs, "Unused"));
+
+    // The original order is preserved
+    EXPECT_LT(Defs.find("FuncB(float"), Defs.find("FuncC(float"));
+
+    const String EmptySource;
+    EXPECT_TRUE(Filter.Filter({&EmptySource}).empty());
+}
+
+TEST(HLSL2GLSLConverterLib_GLSLDefinitionsFilter, ConditionalBlocks)
+{
+    // clang-format off
+    const GLSLDefinitionsFilter Filter{
+        "#ifndef GLSL_DEFINITIONS\n"
+        "#define GLSL_DEFINITIONS\n"
+        "#ifdef GL_ES\n"
+        "#   define PRECISION_A highp\n"
+        "#else\n"
+        "#   define PRECISION_A\n"
+        "#endif\n"
+        "#if defined(FEATURE_X)\n"
+        "float FeatureFunc()\n"
+        "{\n"
+        "    return 1.0;\n"
+        "}\n"
+        "#endif\n"
+        "#endif\n"
+    };
+    // clang-format on
+
+    {
+        const String Source{"PRECISION_A float x;"};
+        const auto   Defs = Filter.Filter({&Source});
+        // All conditional variants of the macro are kept
+        EXPECT_TRUE(Contains(Defs, "#ifdef GL_ES"));
+        EXPECT_TRUE(Contains(Defs, "#   define PRECISION_A highp"));
+        EXPECT_TRUE(Contains(Defs, "#else"));
+        EXPECT_TRUE(Contains(Defs, "#   define PRECISION_A\n"));
+        // The block that contains no referenced definitions is removed
+        EXPECT_FALSE(Contains(Defs, "FEATURE_X"));
+        EXPECT_FALSE(Contains(Defs, "FeatureFunc"));
+        // Names tested by the conditional directives are always defined
+        EXPECT_TRUE(Contains(Defs, "#ifndef GLSL_DEFINITIONS\n#define GLSL_DEFINITIONS\n"));
+    }
+
+    {
+        const String Source{"float x = FeatureFunc();"};
+        const auto   Defs = Filter.Filter({&Source});
+        EXPECT_TRUE(Contains(Defs, "#if defined(FEATURE_X)\nfloat FeatureFunc()"));
+        EXPECT_FALSE(Contains(Defs, "PRECISION_A"));
+        EXPECT_FALSE(Contains(Defs, "GL_ES"));
+    }
+
+    {
+        const String Source{"void main() {}"};
+        EXPECT_EQ(Filter.Filter({&Source}), "#ifndef GLSL_DEFINITIONS\n#define GLSL_DEFINITIONS\n#endif\n");
+    }
+}
+
+TEST(HLSL2GLSLConverterLib_GLSLDefinitionsFilter, MacrosInMacros)
+{
+    // clang-format off
+    const GLSLDefinitionsFilter Filter{
+        "#define INNER_MACRO(x) (x + 1)\n"
+        "#define OUTER_MACRO(x) INNER_MACRO(x) * \\\n"
+        "    HelperFunc(x)\n"
+        "float HelperFunc(float x)\n"
+        "{\n"
+        "    return x;\n"
+        "}\n"
+        "#define OTHER_MACRO 2\n"
+    };
+    // clang-format on
+
+    // OUTER_MACRO is used by a macro the shader defines, but not by the shader code itself
+    const String Header{"#define SHADER_MACRO OUTER_MACRO(1.0)\n"};
+    const String Source{"void main() {}"};
+
+    const auto Defs = Filter.Filter({&Header, &Source});
+    EXPECT_TRUE(Contains(Defs, "#define INNER_MACRO"));
+    EXPECT_TRUE(Contains(Defs, "#define OUTER_MACRO(x) INNER_MACRO(x) * \\\n    HelperFunc(x)\n"));
+    EXPECT_TRUE(Contains(Defs, "float HelperFunc"));
+    EXPECT_FALSE(Contains(Defs, "OTHER_MACRO"));
+}
+
+TEST(HLSL2GLSLConverterLib_GLSLDefinitionsFilter, CommentsAndStrings)
+{
+    // clang-format off
+    const GLSLDefinitionsFilter Filter{
+        "/* License\n"
+        " * FuncA FuncB\n"
+        " */\n"
+        "// FuncA\n"
+        "float FuncA(float x)\n"
+        "{\n"
+        "    /* } FuncB */\n"
+        "    return x; // }\n"
+        "}\n"
+        "float FuncB(float x)\n"
+        "{\n"
+        "    return x; // FuncC(x)\n"
+        "}\n"
+        "float FuncC(float x)\n"
+        "{\n"
+        "    return x;\n"
+        "}\n"
+    };
+    // clang-format on
+
+    {
+        // Names in comments and strings are not references
+        const String Source{"// FuncA\n/* FuncB\n */ #error \"FuncC\"\n"};
+        EXPECT_TRUE(Filter.Filter({&Source}).empty());
+    }
+
+    {
+        // Braces in comments do not end the function
+        const String Source{"float x = FuncA(1.0);"};
+        const auto   Defs = Filter.Filter({&Source});
+        EXPECT_TRUE(Contains(Defs, "float FuncA"));
+        EXPECT_TRUE(Contains(Defs, "    return x; // }\n}\n"));
+        EXPECT_FALSE(Contains(Defs, "float FuncB"));
+        EXPECT_FALSE(Contains(Defs, "float FuncC"));
+    }
+
+    {
+        const String Source{"float x = FuncB(1.0);"};
+        const auto   Defs = Filter.Filter({&Source});
+        EXPECT_TRUE(Contains(Defs, "float FuncB"));
+        EXPECT_FALSE(Contains(Defs, "float FuncA"));
+        EXPECT_FALSE(Contains(Defs, "float FuncC"));
+    }
+}
+
+TEST(HLSL2GLSLConverterLib_GLSLDefinitionsFilter, TokenPasting)
+{
+    const char* Definitions = "#define MACRO_A 1\n#define MACRO_B 2\n";
+
+    const GLSLDefinitionsFilter Filter{Definitions};
+
+    // References can't be determined if the source uses token pasting
+    const String Source{"#define CONCAT(a, b) a##b\nint x = CONCAT(MACRO_, A);"};
+    EXPECT_EQ(Filter.Filter({&Source}), Definitions);
+}
+
+// Compilation of the shaders converted from the HLSL2GLSLConverter test set with the filtered
+// definitions is tested by HLSL2GLSLConverterGLTest in DiligentCoreAPITest.
+TEST(HLSL2GLSLConverterLib_GLSLDefinitionsFilter, ConvertedShader)
+{
+    // clang-format off
+    static constexpr char HLSLSource[] =
+        "Texture2D    g_Tex;\n"
+        "SamplerState g_Tex_sampler;\n"
+        "float4 main(in float4 Pos : SV_Position) : SV_Target\n"
+        "{\n"
+        "    return saturate(g_Tex.Sample(g_Tex_sampler, frac(Pos.xy)));\n"
+        "}\n";
+    // clang-format on
+
+    const auto& Converter = HLSL2GLSLConverterImpl::GetInstance();
+
+    HLSL2GLSLConverterImpl::ConversionAttribs Attribs;
+    Attribs.HLSLSource                 = HLSLSource;
+    Attribs.NumSymbols                 = sizeof(HLSLSource) - 1;
+    Attribs.EntryPoint                 = "main";
+    Attribs.ShaderType                 = SHADER_TYPE_PIXEL;
+    Attribs.InputFileName              = "ConvertedShader";
+    Attribs.UseInOutLocationQualifiers = false;
+
+    Attribs.IncludeDefinitions = true;
+    const auto FullSource      = Converter.Convert(Attribs);
+    Attribs.IncludeDefinitions = false;
+    const auto Source          = Converter.Convert(Attribs);
+    ASSERT_FALSE(Source.empty());
+    ASSERT_GT(FullSource.length(), Source.length());
+
+    const auto Defs = Converter.GetGLSLDefinitions({&Source});
+    EXPECT_LT(Defs.length(), FullSource.length() - Source.length());
+
+    EXPECT_TRUE(Contains(Defs, "vec4  saturate( vec4  x )"));
+    EXPECT_TRUE(Contains(Defs, "#define frac"));
+    EXPECT_TRUE(Contains(Defs, "#define float4"));
+    EXPECT_TRUE(Contains(Defs, "#define SamplerState"));
+    // Not used by the shader
+    EXPECT_FALSE(Contains(Defs, "#define InterlockedAdd"));
+}
+
+} // namespace
@@ -0,0 +1,169 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <string>
+
+#include "HLSL2GLSLConversionCache.hpp"
+#include "HashUtils.hpp"
+#include "FileWrapper.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+HLSL2GLSLConversionCache::Key MakeTestKey(const HLSL2GLSLConversionCache& Cache, const String& Source, const Char* EntryPoint = "main")
+{
+    const auto SourceHash = ComputeFNVHash(Source.c_str(), Source.length());
+    return Cache.MakeKey(SourceHash, Source.length(), EntryPoint, SHADER_TYPE_VERTEX, "_sampler", false);
+}
+
+TEST(HLSL2GLSLConverterLib_ConversionCache, MemoryStore)
+{
+    HLSL2GLSLConversionCache Cache{1};
+
+    const auto Key0 = MakeTestKey(Cache, "Source0");
+    const auto Key1 = MakeTestKey(Cache, "Source1");
+    EXPECT_FALSE(Key0 == Key1);
+    EXPECT_FALSE(Key0 == MakeTestKey(Cache, "Source0", "main2"));
+    EXPECT_TRUE(Key0 == MakeTestKey(Cache, "Source0"));
+
+    String GLSL;
+    EXPECT_FALSE(Cache.Find(Key0, GLSL));
+    EXPECT_EQ(Cache.GetStatistics().NumMisses, Uint64{1});
+
+    Cache.Add(Key0, "GLSL0");
+    Cache.Add(Key1, "GLSL1");
+    EXPECT_EQ(Cache.GetNumEntries(), size_t{2});
+    EXPECT_EQ(Cache.GetMemorySize(), size_t{10});
+
+    ASSERT_TRUE(Cache.Find(Key0, GLSL));
+    EXPECT_EQ(GLSL, "GLSL0");
+    ASSERT_TRUE(Cache.Find(Key1, GLSL));
+    EXPECT_EQ(GLSL, "GLSL1");
+
+    auto Stats = Cache.GetStatistics();
+    EXPECT_EQ(Stats.NumMemoryHits, Uint64{2});
+    EXPECT_EQ(Stats.NumDiskHits, Uint64{0});
+    EXPECT_EQ(Stats.NumMisses, Uint64{1});
+
+    // Key0 is the least recently used entry and must be evicted first
+    Cache.SetMaxMemorySize(5);
+    EXPECT_EQ(Cache.GetNumEntries(), size_t{1});
+    EXPECT_FALSE(Cache.Find(Key0, GLSL));
+    EXPECT_TRUE(Cache.Find(Key1, GLSL));
+
+    Cache.Clear();
+    EXPECT_EQ(Cache.GetNumEntries(), size_t{0});
+    EXPECT_EQ(Cache.GetMemorySize(), size_t{0});
+    EXPECT_FALSE(Cache.Find(Key1, GLSL));
+
+    Stats = Cache.GetStatistics();
+    EXPECT_EQ(Stats.NumMemoryHits, Uint64{3});
+    EXPECT_EQ(Stats.NumMisses, Uint64{3});
+}
+
+TEST(HLSL2GLSLConverterLib_ConversionCache, ConverterHash)
+{
+    HLSL2GLSLConversionCache Cache0{1};
+    HLSL2GLSLConversionCache Cache1{2};
+
+    // Results produced by different versions of the converter must not share keys
+    EXPECT_FALSE(MakeTestKey(Cache0, "Source") == MakeTestKey(Cache1, "Source"));
+    EXPECT_NE(Cache0.GetFilePath(MakeTestKey(Cache0, "Source")), Cache1.GetFilePath(MakeTestKey(Cache1, "Source")));
+}
+
+TEST(HLSL2GLSLConverterLib_ConversionCache, DiskStore)
+{
+    // Use the working directory as there is no portable way to remove a directory
+    const Char* Directory = ".";
+
+    const String Source{"DiskStoreTestSource"};
+    const String RefGLSL{"DiskStoreTestGLSL"};
+
+    String FilePath;
+    {
+        HLSL2GLSLConversionCache Cache{1};
+        Cache.SetDirectory(Directory);
+        const auto Key = MakeTestKey(Cache, Source);
+        FilePath       = Cache.GetFilePath(Key);
+        Cache.Add(Key, RefGLSL);
+    }
+    ASSERT_TRUE(FileSystem::FileExists(FilePath.c_str()));
+
+    {
+        // New cache instance, the result must be loaded from disk
+        HLSL2GLSLConversionCache Cache{1};
+        Cache.SetDirectory(Directory);
+        const auto Key = MakeTestKey(Cache, Source);
+        EXPECT_EQ(Cache.GetFilePath(Key), FilePath);
+
+        String GLSL;
+        ASSERT_TRUE(Cache.Find(Key, GLSL));
+        EXPECT_EQ(GLSL, RefGLSL);
+        EXPECT_EQ(Cache.GetStatistics().NumDiskHits, Uint64{1});
+
+        // The result is now in memory
+        ASSERT_TRUE(Cache.Find(Key, GLSL));
+        EXPECT_EQ(GLSL, RefGLSL);
+        EXPECT_EQ(Cache.GetStatistics().NumMemoryHits, Uint64{1});
+        EXPECT_EQ(Cache.GetStatistics().NumDiskHits, Uint64{1});
+    }
+
+    {
+        // Results produced by a different converter must not be used
+        HLSL2GLSLConversionCache Cache{2};
+        Cache.SetDirectory(Directory);
+
+        String GLSL;
+        EXPECT_FALSE(Cache.Find(MakeTestKey(Cache, Source), GLSL));
+        EXPECT_EQ(Cache.GetStatistics().NumMisses, Uint64{1});
+    }
+
+    {
+        // Truncate the file
+        FileWrapper File{FilePath.c_str(), EFileAccessMode::Overwrite};
+        ASSERT_TRUE(File != nullptr);
+        ASSERT_TRUE(File->Write(RefGLSL.data(), RefGLSL.size()));
+    }
+
+    {
+        // Damaged files must be ignored
+        HLSL2GLSLConversionCache Cache{1};
+        Cache.SetDirectory(Directory);
+
+        String GLSL;
+        EXPECT_FALSE(Cache.Find(MakeTestKey(Cache, Source), GLSL));
+        EXPECT_EQ(Cache.GetStatistics().NumMisses, Uint64{1});
+    }
+
+    FileSystem::DeleteFile(FilePath.c_str());
+}
+
+} // namespace
@@ -34,4 +34,7 @@ void TestEngineFactortCInterface(struct IEngineFactory* pFactory)
     struct IShaderSourceInputStreamFactory* pShaderFactory = NULL;
 
     IEngineFactory_CreateDefaultShaderSourceStreamFactory(pFactory, "directories", &pShaderFactory);
+
+    struct ICachingShaderSourceStreamFactory* pCachingShaderFactory = NULL;
+    IEngineFactory_CreateCachingShaderSourceStreamFactory(pFactory, "directories", &pCachingShaderFactory);
 }